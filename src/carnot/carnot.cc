@@ -32,6 +32,16 @@
 #include "src/shared/types/type_utils.h"
 #include "src/table_store/table_store.h"
 
+DEFINE_int64(carnot_agent_memory_limit_bytes,
+             gflags::Int64FromEnv("PL_CARNOT_AGENT_MEMORY_LIMIT_BYTES", 0),
+             "The limit on the memory used by all of the queries executed by this agent, in bytes. "
+             "0 disables the limit.");
+DEFINE_int64(carnot_query_memory_limit_bytes,
+             gflags::Int64FromEnv("PL_CARNOT_QUERY_MEMORY_LIMIT_BYTES", 0),
+             "The limit on the memory used by a single query on this agent, in bytes. A query that "
+             "exceeds it fails, unless its joins and aggregates can spill to "
+             "--carnot_spill_dir. 0 disables the limit.");
+
 namespace px {
 namespace carnot {
 
@@ -69,6 +79,10 @@ class CarnotImpl final : public Carnot {
 
   const udf::Registry* FuncRegistry() const override { return engine_state_->func_registry(); }
 
+  const MemoryTracker& memory_tracker() const override {
+    return engine_state_->agent_memory_tracker();
+  }
+
  private:
   Status RegisterUDFs(exec::ExecState* exec_state, plan::Plan* plan);
 
@@ -118,9 +132,15 @@ Status CarnotImpl::Init(const sole::uuid& agent_id, std::unique_ptr<udf::Registr
     grpc_server_thread_ = std::make_unique<std::thread>(&CarnotImpl::GRPCServerFunc, this);
   }
 
-  PL_ASSIGN_OR_RETURN(engine_state_, EngineState::CreateDefault(
-                                         std::move(func_registry), table_store, stub_generator,
-                                         add_auth_to_grpc_context_func, grpc_router_.get()));
+  auto memory_limit_bytes = [](int64_t flag_value) {
+    return flag_value > 0 ? flag_value : MemoryTracker::kNoLimit;
+  };
+  PL_ASSIGN_OR_RETURN(engine_state_,
+                      EngineState::CreateDefault(
+                          std::move(func_registry), table_store, stub_generator,
+                          add_auth_to_grpc_context_func, grpc_router_.get(),
+                          memory_limit_bytes(FLAGS_carnot_agent_memory_limit_bytes),
+                          memory_limit_bytes(FLAGS_carnot_query_memory_limit_bytes)));
   return Status::OK();
 }
 
@@ -376,6 +396,8 @@ Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uui
   agent_operator_exec_stats.set_execution_time_ns(exec_time_ns);
   agent_operator_exec_stats.set_bytes_processed(bytes_processed);
   agent_operator_exec_stats.set_records_processed(rows_processed);
+  agent_operator_exec_stats.set_peak_memory_bytes(
+      exec_state->memory_tracker()->peak_consumed_bytes());
 
   std::vector<queryresultspb::AgentExecutionStats> all_agent_stats;
   if (analyze) {
@@ -31,6 +31,9 @@
 #include "src/shared/metadata/metadata_state.h"
 #include "src/table_store/table_store.h"
 
+DECLARE_int64(carnot_agent_memory_limit_bytes);
+DECLARE_int64(carnot_query_memory_limit_bytes);
+
 namespace px {
 namespace carnot {
 
@@ -81,6 +84,11 @@ class Carnot : public NotCopyable {
    * Returns a const pointer to carnot's function registry.
    */
   virtual const udf::Registry* FuncRegistry() const = 0;
+
+  /**
+   * Returns the tracker that the memory used by all of the queries of this Carnot is charged to.
+   */
+  virtual const MemoryTracker& memory_tracker() const = 0;
 };
 
 }  // namespace carnot
@@ -590,6 +590,11 @@ TEST_F(CarnotTest, group_by_col_agg_test) {
       "\n");
   ASSERT_OK(carnot_->ExecuteQuery(query, sole::uuid4(), 0));
 
+  // The hash table of the aggregate is charged to the query.
+  auto exec_stats = result_server_->exec_stats().ConsumeValueOrDie();
+  ASSERT_EQ(1, exec_stats.agent_execution_stats_size());
+  EXPECT_LT(0, exec_stats.agent_execution_stats(0).peak_memory_bytes());
+
   EXPECT_THAT(result_server_->output_tables(), UnorderedElementsAre("test_output"));
   auto output_batches = result_server_->query_results("test_output");
   EXPECT_EQ(1, output_batches.size());
@@ -613,6 +618,26 @@ TEST_F(CarnotTest, group_by_col_agg_test) {
   EXPECT_EQ(expected, actual);
 }
 
+TEST_F(CarnotTest, query_memory_limit_test) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_carnot_query_memory_limit_bytes = 1;
+  auto carnot = Carnot::Create(sole::uuid4(), table_store_,
+                               std::bind(&exec::LocalGRPCResultSinkServer::StubGenerator,
+                                         result_server_.get(), std::placeholders::_1))
+                    .ConsumeValueOrDie();
+
+  auto query = absl::StrJoin(
+      {
+          "import px",
+          "queryDF = px.DataFrame(table='big_test_table', select=['time_', 'col3', 'num_groups'])",
+          "aggDF = queryDF.groupby('num_groups').agg(sum=('col3', px.sum))",
+          "px.display(aggDF, 'test_output')",
+      },
+      "\n");
+  auto s = carnot->ExecuteQuery(query, sole::uuid4(), 0);
+  EXPECT_NOT_OK(s);
+}
+
 TEST_F(CarnotTest, multiple_group_by_test) {
   auto query = absl::StrJoin(
       {
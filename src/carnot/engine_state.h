@@ -48,21 +48,27 @@ class EngineState : public NotCopyable {
               std::unique_ptr<planner::RegistryInfo> registry_info,
               const exec::ResultSinkStubGenerator& stub_generator,
               std::function<void(grpc::ClientContext*)> add_auth_to_grpc_context_func,
-              exec::GRPCRouter* grpc_router, std::unique_ptr<exec::ml::ModelPool> model_pool)
+              exec::GRPCRouter* grpc_router, std::unique_ptr<exec::ml::ModelPool> model_pool,
+              int64_t agent_memory_limit_bytes = MemoryTracker::kNoLimit,
+              int64_t query_memory_limit_bytes = MemoryTracker::kNoLimit)
       : func_registry_(std::move(func_registry)),
         table_store_(std::move(table_store)),
         registry_info_(std::move(registry_info)),
         stub_generator_(stub_generator),
         add_auth_to_grpc_context_func_(add_auth_to_grpc_context_func),
         grpc_router_(grpc_router),
-        model_pool_(std::move(model_pool)) {}
+        model_pool_(std::move(model_pool)),
+        agent_memory_tracker_(
+            std::make_shared<MemoryTracker>("agent", agent_memory_limit_bytes)),
+        query_memory_limit_bytes_(query_memory_limit_bytes) {}
 
   static StatusOr<std::unique_ptr<EngineState>> CreateDefault(
       std::unique_ptr<udf::Registry> func_registry,
       std::shared_ptr<table_store::TableStore> table_store,
       const exec::ResultSinkStubGenerator& stub_generator,
       std::function<void(grpc::ClientContext*)> add_auth_to_grpc_context_func,
-      exec::GRPCRouter* grpc_router) {
+      exec::GRPCRouter* grpc_router, int64_t agent_memory_limit_bytes = MemoryTracker::kNoLimit,
+      int64_t query_memory_limit_bytes = MemoryTracker::kNoLimit) {
     auto registry_info = std::make_unique<planner::RegistryInfo>();
     auto udf_info = func_registry->ToProto();
     PL_RETURN_IF_ERROR(registry_info->Init(udf_info));
@@ -70,14 +76,17 @@ class EngineState : public NotCopyable {
 
     return std::make_unique<EngineState>(
         std::move(func_registry), table_store, std::move(registry_info), stub_generator,
-        add_auth_to_grpc_context_func, grpc_router, std::move(model_pool));
+        add_auth_to_grpc_context_func, grpc_router, std::move(model_pool),
+        agent_memory_limit_bytes, query_memory_limit_bytes);
   }
 
   table_store::TableStore* table_store() { return table_store_.get(); }
   std::unique_ptr<exec::ExecState> CreateExecState(const sole::uuid& query_id) {
-    return std::make_unique<exec::ExecState>(func_registry_.get(), table_store_, stub_generator_,
-                                             query_id, model_pool_.get(), grpc_router_,
-                                             add_auth_to_grpc_context_func_);
+    auto exec_mem_pool = exec::QueryMemoryPool::Create(query_id.str(), query_memory_limit_bytes_,
+                                                       agent_memory_tracker_);
+    return std::make_unique<exec::ExecState>(
+        func_registry_.get(), table_store_, stub_generator_, query_id, model_pool_.get(),
+        grpc_router_, add_auth_to_grpc_context_func_, std::move(exec_mem_pool));
   }
 
   std::unique_ptr<plan::PlanState> CreatePlanState() {
@@ -101,6 +110,9 @@ class EngineState : public NotCopyable {
 
   exec::ml::ModelPool* model_pool() const { return model_pool_.get(); }
 
+  // Tracks the memory used by all of the queries of this engine.
+  const MemoryTracker& agent_memory_tracker() const { return *agent_memory_tracker_; }
+
  private:
   std::unique_ptr<udf::Registry> func_registry_;
   std::shared_ptr<table_store::TableStore> table_store_;
@@ -109,6 +121,9 @@ class EngineState : public NotCopyable {
   std::function<void(grpc::ClientContext*)> add_auth_to_grpc_context_func_;
   exec::GRPCRouter* grpc_router_ = nullptr;
   std::unique_ptr<exec::ml::ModelPool> model_pool_;
+  // Shared with the query memory pools, which can outlive the engine state.
+  std::shared_ptr<MemoryTracker> agent_memory_tracker_;
+  const int64_t query_memory_limit_bytes_;
 };
 
 }  // namespace carnot
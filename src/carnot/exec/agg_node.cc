@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <cstdint>
 
+#include <absl/strings/substitute.h>
 #include <magic_enum.hpp>
 
 #include "src/carnot/exec/expression_evaluator.h"
@@ -71,7 +72,10 @@ void ExtractToColumnWrapper(const std::vector<GroupArgs>& group_args,
   size_t num_rows = rb.num_rows();
   DCHECK(num_rows <= group_args.size());
   for (size_t row_idx = 0; row_idx < num_rows; ++row_idx) {
-    DCHECK(group_args[row_idx].av != nullptr);
+    // Rows without a hash value belong to spilled groups.
+    if (group_args[row_idx].av == nullptr) {
+      continue;
+    }
     auto col_wrapper = group_args[row_idx].av->agg_cols[col_idx].get();
     auto arr = rb.ColumnAt(rb_col_idx).get();
     types::ExtractValueToColumnWrapper<DT>(col_wrapper, arr, row_idx);
@@ -111,6 +115,14 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
     return error::InvalidArgument("Output size mismatch in aggregate");
   }
 
+  if (plan_node_->sliding_window()) {
+    auto time_idx = plan_node_->window_time_column_index();
+    if (time_idx < 0 || static_cast<size_t>(time_idx) >= input_descriptor_->size() ||
+        input_descriptor_->type(time_idx) != types::TIME64NS) {
+      return error::InvalidArgument("Sliding window needs a time column, got column $0", time_idx);
+    }
+  }
+
   if (HasNoGroups()) {
     return Status::OK();
   }
@@ -140,6 +152,10 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
 
 Status AggNode::PrepareImpl(ExecState* exec_state) {
   function_ctx_ = exec_state->CreateFunctionContext();
+  group_args_pool_.set_memory_tracker(exec_state->memory_tracker());
+  udas_pool_.set_memory_tracker(exec_state->memory_tracker());
+  agg_hash_map_reservation_.set_tracker(exec_state->memory_tracker());
+  panes_reservation_.set_tracker(exec_state->memory_tracker());
   return Status::OK();
 }
 
@@ -151,6 +167,9 @@ Status AggNode::OpenImpl(ExecState* exec_state) {
 }
 
 Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  if (plan_node_->sliding_window()) {
+    return AggregateSlidingWindow(exec_state, rb);
+  }
   if (HasNoGroups()) {
     return AggregateGroupByNone(exec_state, rb);
   }
@@ -160,8 +179,13 @@ Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_
 Status AggNode::CloseImpl(ExecState*) {
   udas_no_groups_.clear();
   group_args_chunk_.clear();
+  agg_hash_map_.clear();
+  agg_hash_map_reservation_.Reset();
   group_args_pool_.Clear();
   udas_pool_.Clear();
+  spill_partitions_.reset();
+  panes_.clear();
+  panes_reservation_.Reset();
 
   return Status::OK();
 }
@@ -176,9 +200,243 @@ Status AggNode::ClearAggState(ExecState* exec_state) {
     PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
   }
   agg_hash_map_.clear();
+  agg_hash_map_reservation_.Reset();
+  // The groups of the hash map are owned by the pools, so free them along with it.
+  group_args_chunk_.clear();
+  group_args_pool_.Clear();
+  udas_pool_.Clear();
+  return Status::OK();
+}
+
+Status AggNode::EmitAggHashMap(ExecState* exec_state, bool eow, bool eos) {
+  RowBatch output_rb(*output_descriptor_, agg_hash_map_.size());
+  PL_RETURN_IF_ERROR(ConvertAggHashMapToRowBatch(exec_state, &output_rb));
+  output_rb.set_eow(eow);
+  output_rb.set_eos(eos);
+  PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, output_rb));
+  return ClearAggState(exec_state);
+}
+
+Status AggNode::StartSpilling(ExecState* exec_state) {
+  auto label = absl::Substitute("agg_$0_$1", exec_state->query_id().str(), plan_node_->id());
+  PL_ASSIGN_OR_RETURN(spill_partitions_,
+                      SpillPartitions::Create(label, *input_descriptor_,
+                                              exec_state->exec_mem_pool(),
+                                              FLAGS_carnot_spill_partitions));
+  LOG(INFO) << absl::Substitute(
+      "Aggregate $0 is spilling new groups to $1, $2 groups ($3 bytes) stay in memory.",
+      plan_node_->id(), FLAGS_carnot_spill_dir, agg_hash_map_.size(),
+      agg_hash_map_reservation_.bytes());
   return Status::OK();
 }
 
+Status AggNode::AggregateSpilledPartitions(ExecState* exec_state, bool eow, bool eos) {
+  // The partitions are aggregated in memory, without spilling any further.
+  std::unique_ptr<SpillPartitions> partitions = std::move(spill_partitions_);
+  PL_RETURN_IF_ERROR(partitions->FinishWriting());
+
+  for (size_t partition = 0; partition < partitions->num_partitions(); ++partition) {
+    bool last_partition = partition + 1 == partitions->num_partitions();
+    if (partitions->num_rows(partition) == 0 && !last_partition) {
+      continue;
+    }
+    PL_RETURN_IF_ERROR(partitions->ReadPartition(partition, [&](const RowBatch& rb) {
+      PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
+      PL_RETURN_IF_ERROR(HashRowBatch(exec_state, rb));
+      // A partition that does not fit in memory either is not split any further.
+      PL_RETURN_IF_ERROR(agg_hash_map_reservation_.CheckLimit());
+      if (plan_node_->values().size() > 0) {
+        PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, rb.num_rows()));
+      }
+      return ResetGroupArgs();
+    }));
+    PL_RETURN_IF_ERROR(EmitAggHashMap(exec_state, last_partition && eow, last_partition && eos));
+  }
+  return Status::OK();
+}
+
+int64_t AggNode::PaneOf(int64_t time_ns) const {
+  int64_t pane_ns = plan_node_->window_pane_ns();
+  // Round towards negative infinity so that every pane has the same size.
+  int64_t idx = time_ns / pane_ns;
+  return (time_ns % pane_ns < 0) ? idx - 1 : idx;
+}
+
+Status AggNode::AggregateSlidingWindow(ExecState* exec_state, const RowBatch& rb) {
+  const arrow::Array* time_col = rb.ColumnAt(plan_node_->window_time_column_index()).get();
+  auto time_at = [time_col](int64_t row_idx) {
+    return types::GetValueFromArrowArray<types::TIME64NS>(time_col, row_idx);
+  };
+
+  // Split the batch into runs of rows that belong to the same pane.
+  int64_t num_rows = rb.num_rows();
+  int64_t run_start = 0;
+  while (run_start < num_rows) {
+    int64_t run_pane = std::max(PaneOf(time_at(run_start)), open_pane_idx_);
+    int64_t run_end = run_start + 1;
+    while (run_end < num_rows && PaneOf(time_at(run_end)) <= run_pane) {
+      ++run_end;
+    }
+    if (run_pane > open_pane_idx_) {
+      PL_RETURN_IF_ERROR(CloseOpenPane(exec_state));
+      open_pane_idx_ = run_pane;
+    }
+    for (int64_t row_idx = run_start; row_idx < run_end; ++row_idx) {
+      max_time_ns_ = std::max(max_time_ns_, time_at(row_idx));
+    }
+
+    if (run_start == 0 && run_end == num_rows) {
+      PL_RETURN_IF_ERROR(AggregateIntoOpenPane(exec_state, rb));
+    } else {
+      PL_ASSIGN_OR_RETURN(auto run, rb.Slice(run_start, run_end - run_start));
+      PL_RETURN_IF_ERROR(AggregateIntoOpenPane(exec_state, *run));
+    }
+    open_pane_rows_ += run_end - run_start;
+    run_start = run_end;
+  }
+
+  if (ReadyToEmitBatches(rb)) {
+    return EmitSlidingWindow(exec_state, rb.eow(), rb.eos());
+  }
+  return Status::OK();
+}
+
+Status AggNode::AggregateIntoOpenPane(ExecState* exec_state, const RowBatch& rb) {
+  if (HasNoGroups()) {
+    auto values = plan_node_->values();
+    for (size_t i = 0; i < values.size(); ++i) {
+      PL_RETURN_IF_ERROR(
+          EvaluateSingleExpressionNoGroups(exec_state, udas_no_groups_[i], values[i].get(), rb));
+    }
+    return Status::OK();
+  }
+  PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
+  PL_RETURN_IF_ERROR(HashRowBatch(exec_state, rb));
+  PL_RETURN_IF_ERROR(agg_hash_map_reservation_.CheckLimit());
+  if (plan_node_->values().size() > 0) {
+    PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, rb.num_rows()));
+  }
+  return ResetGroupArgs();
+}
+
+Status AggNode::CloseOpenPane(ExecState* exec_state) {
+  if (open_pane_rows_ == 0) {
+    return Status::OK();
+  }
+  AggPane pane;
+  pane.idx = open_pane_idx_;
+  if (HasNoGroups()) {
+    pane.groups.push_back(std::make_unique<RowTuple>(&group_data_types_));
+    pane.udas.push_back(std::move(udas_no_groups_));
+    udas_no_groups_.clear();
+  } else {
+    // The group keys are copied out of the pools, which are cleared along with the hash map.
+    for (const auto& [rt, val] : agg_hash_map_) {
+      PL_RETURN_IF_ERROR(EvaluateAggHashValue(exec_state, val));
+      auto group = std::make_unique<RowTuple>(&group_data_types_);
+      memcpy(reinterpret_cast<uint8_t*>(group->fixed_values.data()),
+             reinterpret_cast<const uint8_t*>(rt->fixed_values.data()),
+             sizeof(types::FixedSizeValueUnion) * rt->fixed_values.size());
+      group->variable_values = rt->variable_values;
+      pane.groups.push_back(std::move(group));
+      pane.udas.push_back(std::move(val->udas));
+    }
+  }
+  pane.bytes = static_cast<int64_t>(pane.groups.size() *
+                                    (sizeof(RowTuple) + kAggHashMapEntryBytes +
+                                     plan_node_->values().size() * sizeof(UDAInfo)));
+  panes_reservation_.Add(pane.bytes);
+  panes_.push_back(std::move(pane));
+  open_pane_rows_ = 0;
+  return ClearAggState(exec_state);
+}
+
+void AggNode::EvictPanes() {
+  if (max_time_ns_ == std::numeric_limits<int64_t>::min()) {
+    return;
+  }
+  // A pane is dropped once all of its rows are older than the window.
+  int64_t first_pane = PaneOf(max_time_ns_ - plan_node_->window_size_ns());
+  while (!panes_.empty() && panes_.front().idx < first_pane) {
+    panes_reservation_.Subtract(panes_.front().bytes);
+    panes_.pop_front();
+  }
+}
+
+Status AggNode::EmitSlidingWindow(ExecState* exec_state, bool eow, bool eos) {
+  PL_RETURN_IF_ERROR(CloseOpenPane(exec_state));
+  EvictPanes();
+
+  // Merge the partial aggregates of each group across the panes of the window.
+  AbslRowTupleHashMap<std::vector<UDAInfo>*> merged_groups;
+  std::deque<std::vector<UDAInfo>> merged_udas;
+  for (const auto& pane : panes_) {
+    for (size_t group_idx = 0; group_idx < pane.groups.size(); ++group_idx) {
+      auto it = merged_groups.find(pane.groups[group_idx].get());
+      std::vector<UDAInfo>* udas = nullptr;
+      if (it == merged_groups.end()) {
+        udas = &merged_udas.emplace_back();
+        PL_RETURN_IF_ERROR(CreateUDAInfoValues(udas, exec_state));
+        merged_groups[pane.groups[group_idx].get()] = udas;
+      } else {
+        udas = it->second;
+      }
+      const auto& pane_udas = pane.udas[group_idx];
+      for (size_t i = 0; i < udas->size(); ++i) {
+        PL_RETURN_IF_ERROR((*udas)[i].def->Merge((*udas)[i].uda.get(), pane_udas[i].uda.get(),
+                                                 function_ctx_.get()));
+      }
+    }
+  }
+
+  // Like the blocking aggregate, an aggregate without groups always outputs a row.
+  std::unique_ptr<RowTuple> empty_group;
+  if (HasNoGroups() && merged_groups.empty()) {
+    empty_group = std::make_unique<RowTuple>(&group_data_types_);
+    auto udas = &merged_udas.emplace_back();
+    PL_RETURN_IF_ERROR(CreateUDAInfoValues(udas, exec_state));
+    merged_groups[empty_group.get()] = udas;
+  }
+
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> group_builders;
+  for (const auto& group_dt : group_data_types_) {
+    group_builders.push_back(types::MakeArrowBuilder(group_dt, exec_state->exec_mem_pool()));
+  }
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> value_builders;
+  for (const auto& value : plan_node_->values()) {
+    auto def = exec_state->GetUDADefinition(value->uda_id());
+    value_builders.push_back(
+        types::MakeArrowBuilder(def->finalize_return_type(), exec_state->exec_mem_pool()));
+  }
+  for (const auto& [group, udas] : merged_groups) {
+    for (size_t i = 0; i < group_data_types_.size(); ++i) {
+#define TYPE_CASE(_dt_) AppendToBuilder<_dt_>(group_builders[i].get(), group, i);
+      PL_SWITCH_FOREACH_DATATYPE(group_data_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    for (size_t i = 0; i < udas->size(); ++i) {
+      const auto& uda_info = (*udas)[i];
+      PL_RETURN_IF_ERROR(uda_info.def->FinalizeArrow(uda_info.uda.get(), function_ctx_.get(),
+                                                     value_builders[i].get()));
+    }
+  }
+
+  RowBatch output_rb(*output_descriptor_, merged_groups.size());
+  for (const auto& builder : group_builders) {
+    std::shared_ptr<arrow::Array> arr;
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(arr));
+  }
+  for (const auto& builder : value_builders) {
+    std::shared_ptr<arrow::Array> arr;
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(arr));
+  }
+  output_rb.set_eow(eow);
+  output_rb.set_eos(eos);
+  return SendRowBatchToChildren(exec_state, output_rb);
+}
+
 Status AggNode::AggregateGroupByNone(ExecState* exec_state, const RowBatch& rb) {
   auto values = plan_node_->values();
   for (size_t i = 0; i < values.size(); ++i) {
@@ -234,19 +492,30 @@ Status AggNode::ExtractRowTupleForBatch(const RowBatch& rb) {
 
 Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
   PL_UNUSED(exec_state);
+  if (spilling()) {
+    row_partitions_.assign(rb.num_rows(), SpillPartitions::kNotSpilled);
+  }
   // Loop through all the row and basically store the values into column chunk based on which
-  // group they belong to.
-  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+  // group they belong to. Rows outside the selection vector keep a null hash value, so the value
+  // extraction below skips them like it skips spilled rows.
+  for (auto sel_idx = 0; sel_idx < rb.num_selected_rows(); ++sel_idx) {
+    auto row_idx = rb.has_selection() ? rb.selection()[sel_idx] : sel_idx;
     auto& ga = group_args_chunk_[row_idx];
     AggHashValue* val = nullptr;
     // Check to see if in hash
     // TODO(zasgar): Change this to upsert.
     auto it = agg_hash_map_.find(ga.rt);
+    if (it == agg_hash_map_.end() && spilling()) {
+      // New groups go to disk, and the row is left without a hash value.
+      row_partitions_[row_idx] = spill_partitions_->PartitionOf(*ga.rt);
+      continue;
+    }
     // If not in hash then insert
     if (it == agg_hash_map_.end()) {
       // Create a val array.
       val = CreateAggHashValue(exec_state);
       agg_hash_map_[ga.rt] = val;
+      agg_hash_map_reservation_.Add(kAggHashMapEntryBytes);
       // We have inserted this, so the stored RowTuple is now in the table.
       ga.rt = nullptr;
     } else {
@@ -267,6 +536,9 @@ Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
 #undef TYPE_CASE
   }
 
+  if (spilling()) {
+    PL_RETURN_IF_ERROR(spill_partitions_->Append(rb, row_partitions_));
+  }
   return Status::OK();
 }
 
@@ -277,7 +549,10 @@ Status AggNode::EvaluatePartialAggregates(ExecState* exec_state, size_t num_reco
   for (size_t i = 0; i < num_records; ++i) {
     DCHECK(i < group_args_chunk_.size());
     auto& ga = group_args_chunk_[i];
-    DCHECK(ga.av != nullptr);
+    // Rows without a hash value belong to spilled groups.
+    if (ga.av == nullptr) {
+      continue;
+    }
     if (ga.av->agg_cols[0]->Size() > kAggCompactionThreshold) {
       PL_RETURN_IF_ERROR(EvaluateAggHashValue(exec_state, ga.av));
     }
@@ -359,17 +634,21 @@ Status AggNode::AggregateGroupByClause(ExecState* exec_state, const RowBatch& rb
   // 5. If it's the last batch then emit the values.
   PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
   PL_RETURN_IF_ERROR(HashRowBatch(exec_state, rb));
+  if (!spilling() && ShouldSpill(agg_hash_map_reservation_)) {
+    PL_RETURN_IF_ERROR(StartSpilling(exec_state));
+  }
+  // The groups are charged to the query as they are added, so fail once it is over its limit.
+  PL_RETURN_IF_ERROR(agg_hash_map_reservation_.CheckLimit());
   if (plan_node_->values().size() > 0) {
     PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, rb.num_rows()));
   }
   PL_RETURN_IF_ERROR(ResetGroupArgs());
   if (ReadyToEmitBatches(rb)) {
-    RowBatch output_rb(*output_descriptor_, agg_hash_map_.size());
-    PL_RETURN_IF_ERROR(ConvertAggHashMapToRowBatch(exec_state, &output_rb));
-    output_rb.set_eow(rb.eow());
-    output_rb.set_eos(rb.eos());
-    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, output_rb));
-    PL_RETURN_IF_ERROR(ClearAggState(exec_state));
+    if (spilling()) {
+      PL_RETURN_IF_ERROR(EmitAggHashMap(exec_state, /* eow */ false, /* eos */ false));
+      return AggregateSpilledPartitions(exec_state, rb.eow(), rb.eos());
+    }
+    return EmitAggHashMap(exec_state, rb.eow(), rb.eos());
   }
   return Status::OK();
 }
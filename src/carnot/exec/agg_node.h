@@ -18,6 +18,8 @@
 
 #pragma once
 #include <cstddef>
+#include <deque>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -28,6 +30,7 @@
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/expression_evaluator.h"
 #include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/exec/spill_file.h"
 #include "src/carnot/plan/operators.h"
 #include "src/carnot/plan/scalar_expression.h"
 #include "src/carnot/udf/base.h"
@@ -57,6 +60,21 @@ struct AggHashValue {
   std::vector<types::SharedColumnWrapper> agg_cols;
 };
 
+// Estimate of the bytes held by the hash map for each group, beyond the RowTuple and the
+// AggHashValue, which are charged by their object pools.
+constexpr int64_t kAggHashMapEntryBytes = sizeof(RowTuple*) + sizeof(AggHashValue*);
+
+// The partial aggregates of the rows in one pane of a sliding window.
+struct AggPane {
+  // Panes are numbered by the time of their rows divided by the pane size.
+  int64_t idx = 0;
+  // The groups of the pane and the UDAs with their partial aggregates, in the same order.
+  std::vector<std::unique_ptr<RowTuple>> groups;
+  std::vector<std::vector<UDAInfo>> udas;
+  // The bytes charged to the query for the pane.
+  int64_t bytes = 0;
+};
+
 struct GroupArgs {
   explicit GroupArgs(RowTuple* rt) : rt(rt), av(nullptr) {}
   RowTuple* rt;
@@ -70,6 +88,12 @@ class AggNode : public ProcessingNode {
   AggNode() = default;
   virtual ~AggNode() = default;
 
+  // Grouped aggregates skip the rows outside of a selection vector while hashing. The other
+  // aggregation paths get compacted batches.
+  bool ConsumesSelectionVectors() const override {
+    return plan_node_ != nullptr && !HasNoGroups() && !plan_node_->sliding_window();
+  }
+
  protected:
   Status AggregateGroupByNone(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status AggregateGroupByClause(ExecState* exec_state, const table_store::schema::RowBatch& rb);
@@ -84,6 +108,8 @@ class AggNode : public ProcessingNode {
 
  private:
   AggHashMap agg_hash_map_;
+  // The bytes of the agg_hash_map_ entries, charged to the query.
+  MemoryReservation agg_hash_map_reservation_;
   bool HasNoGroups() const { return plan_node_->groups().empty(); }
   // ReadyToEmitBatches returns true when the input stream has reached a point where output batches
   // can be emitted. In the windowed aggregate case, this happens whenever end of window (eow) is
@@ -91,6 +117,29 @@ class AggNode : public ProcessingNode {
   bool ReadyToEmitBatches(const table_store::schema::RowBatch& rb) const;
   // When we see a new window, we need to be able to clear the aggregate state.
   Status ClearAggState(ExecState* exec_state);
+  // Sends the groups in agg_hash_map_ to the children and clears them.
+  Status EmitAggHashMap(ExecState* exec_state, bool eow, bool eos);
+
+  // Spilling (hybrid hash aggregation): once the groups do not fit in memory, the groups that are
+  // already in agg_hash_map_ keep being aggregated in memory, while the rows of any new group are
+  // written to disk, split into partitions by group. Since no group is in more than one place,
+  // the partitions are aggregated and emitted one at a time after the groups in memory.
+  bool spilling() const { return spill_partitions_ != nullptr; }
+  Status StartSpilling(ExecState* exec_state);
+  Status AggregateSpilledPartitions(ExecState* exec_state, bool eow, bool eos);
+
+  // Sliding windows: the rows of the newest pane are aggregated into agg_hash_map_ (or
+  // udas_no_groups_) as usual. That open pane is moved into panes_ when rows of a later pane
+  // arrive or the window is emitted. Emitting merges the partial aggregates of the panes, after
+  // dropping the panes that slid out of the window, so the rows are never aggregated twice.
+  // Rows that arrive after their pane was closed are added to the open pane. Sliding windows
+  // don't spill.
+  Status AggregateSlidingWindow(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  Status AggregateIntoOpenPane(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  Status CloseOpenPane(ExecState* exec_state);
+  void EvictPanes();
+  Status EmitSlidingWindow(ExecState* exec_state, bool eow, bool eos);
+  int64_t PaneOf(int64_t time_ns) const;
 
   Status EvaluateSingleExpressionNoGroups(ExecState* exec_state, const UDAInfo& uda_info,
                                           plan::AggregateExpression* expr,
@@ -131,8 +180,23 @@ class AggNode : public ProcessingNode {
   // This vector holds pointers to the row_tuples which are managed by the group_args_pool_.
 
   std::vector<GroupArgs> group_args_chunk_;
+
+  // The rows of the new groups, set once the aggregate starts spilling.
+  std::unique_ptr<SpillPartitions> spill_partitions_;
+  // The partition of each row of the current row batch, or kNotSpilled for the rows of the
+  // groups in memory.
+  std::vector<int64_t> row_partitions_;
   // END: Variables specific to GroupBy Agg.
 
+  // Variables specific to sliding windows.
+  std::deque<AggPane> panes_;
+  int64_t open_pane_idx_ = std::numeric_limits<int64_t>::min();
+  int64_t open_pane_rows_ = 0;
+  // The latest time seen, which the window ends at.
+  int64_t max_time_ns_ = std::numeric_limits<int64_t>::min();
+  MemoryReservation panes_reservation_;
+  // END: Variables specific to sliding windows.
+
   // Creates a mapping between plan cols and stored cols (see above comment).
   Status CreateColumnMapping();
 
@@ -27,6 +27,7 @@
 #include "src/carnot/exec/test_utils.h"
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/carnot/udf/registry.h"
+#include "src/common/testing/temp_dir.h"
 #include "src/common/testing/testing.h"
 #include "src/shared/types/typespb/wrapper/types_pb_wrapper.h"
 
@@ -201,6 +202,36 @@ agg_op {
   value_names: "value1"
 })";
 
+constexpr char kSlidingWindowSingleGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  windowed: true
+  window_size_ns: 20
+  window_pane_ns: 10
+  window_time_column_index: 3
+  values {
+    name: "minsum"
+    args {
+      column {
+        node:0
+        index: 1
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 2
+      }
+    }
+  }
+  groups {
+     node: 0
+     index: 0
+  }
+  group_names: "g1"
+  value_names: "value1"
+})";
+
 constexpr char kSingleGroupNoValues[] = R"(
 op_type: AGGREGATE_OPERATOR
 agg_op {
@@ -382,6 +413,34 @@ TEST_F(AggNodeTest, single_group_blocking) {
       .Close();
 }
 
+TEST_F(AggNodeTest, single_group_selection_vector) {
+  auto plan_node = PlanNodeFromPbtxt(kBlockingSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+  EXPECT_TRUE(tester.node()->ConsumesSelectionVectors());
+
+  // Rows outside of the selection vectors are not aggregated.
+  RowBatchBuilder rb1(input_rd, 4, /*eow*/ false, /*eos*/ false);
+  rb1.AddColumn<types::Int64Value>({1, 1, 2, 2}).AddColumn<types::Int64Value>({2, 3, 3, 1});
+  rb1.get().set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{0, 3}));
+  RowBatchBuilder rb2(input_rd, 4, /*eow*/ true, /*eos*/ true);
+  rb2.AddColumn<types::Int64Value>({5, 6, 3, 4}).AddColumn<types::Int64Value>({1, 5, 3, 8});
+  rb2.get().set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1, 2}));
+
+  tester.ConsumeNext(rb1.get(), 0, 0)
+      .ConsumeNext(rb2.get(), 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 4, true, true)
+                          .AddColumn<types::Int64Value>({1, 2, 3, 6})
+                          .AddColumn<types::Int64Value>({1, 1, 3, 5})
+                          .get(),
+                      false)
+      .Close();
+}
+
 TEST_F(AggNodeTest, multiple_groups_blocking) {
   auto plan_node = PlanNodeFromPbtxt(kBlockingMultipleGroupAgg);
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64});
@@ -529,6 +588,58 @@ TEST_F(AggNodeTest, single_group_windowed) {
       .Close();
 }
 
+TEST_F(AggNodeTest, single_group_sliding_window) {
+  auto plan_node = PlanNodeFromPbtxt(kSlidingWindowSingleGroupAgg);
+  RowDescriptor input_rd(
+      {types::DataType::INT64, types::DataType::INT64, types::DataType::INT64, types::TIME64NS});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // Panes 0 and 1 are both in the window that ends at 15.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ true, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 1, 2, 1})
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Int64Value>({10, 10, 10, 10})
+                       .AddColumn<types::Time64NSValue>({1, 5, 12, 15})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, false)
+                          .AddColumn<types::Int64Value>({1, 2})
+                          .AddColumn<types::Int64Value>({7, 3})
+                          .get(),
+                      false)
+      // The window slides to end at 31, dropping pane 0 but keeping the rest of the panes.
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, /*eow*/ true, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({2, 1})
+                       .AddColumn<types::Int64Value>({5, 6})
+                       .AddColumn<types::Int64Value>({10, 10})
+                       .AddColumn<types::Time64NSValue>({25, 31})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, false)
+                          .AddColumn<types::Int64Value>({1, 2})
+                          .AddColumn<types::Int64Value>({10, 8})
+                          .get(),
+                      false)
+      // A late row is added to the newest pane.
+      .ConsumeNext(RowBatchBuilder(input_rd, 1, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1})
+                       .AddColumn<types::Int64Value>({7})
+                       .AddColumn<types::Int64Value>({10})
+                       .AddColumn<types::Time64NSValue>({28})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, true)
+                          .AddColumn<types::Int64Value>({1, 2})
+                          .AddColumn<types::Int64Value>({17, 8})
+                          .get(),
+                      false)
+      .Close();
+}
+
 TEST_F(AggNodeTest, no_aggregate_expressions) {
   auto plan_node = PlanNodeFromPbtxt(kSingleGroupNoValues);
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
@@ -610,6 +721,50 @@ TEST_F(AggNodeTest, single_group_blocking_init_args) {
       .Close();
 }
 
+TEST_F(AggNodeTest, single_group_blocking_spilled) {
+  // The groups of the first batch stay in memory, the new groups of the second batch are spilled.
+  gflags::FlagSaver flag_saver;
+  px::testing::TempDir spill_dir;
+  FLAGS_carnot_spill_dir = spill_dir.path().string();
+  FLAGS_carnot_spill_memory_fraction = 0;
+  FLAGS_carnot_spill_partitions = 1;
+  exec_state_ = std::make_unique<ExecState>(
+      func_registry_.get(), std::make_shared<table_store::TableStore>(),
+      MockResultSinkStubGenerator, sole::uuid4(), nullptr, nullptr, [](grpc::ClientContext*) {},
+      QueryMemoryPool::Create("test", 1024 * 1024));
+  EXPECT_OK(exec_state_->AddUDA(0, "minsum",
+                                std::vector<types::DataType>({types::INT64, types::INT64})));
+
+  auto plan_node = PlanNodeFromPbtxt(kBlockingSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 1, 2, 2})
+                       .AddColumn<types::Int64Value>({2, 3, 3, 1})
+                       .get(),
+                   0, 0)
+      // The groups in memory and then the spilled partition are emitted.
+      .ConsumeNext(RowBatchBuilder(input_rd, 5, true, true)
+                       .AddColumn<types::Int64Value>({5, 1, 3, 2, 5})
+                       .AddColumn<types::Int64Value>({1, 5, 3, 8, 7})
+                       .get(),
+                   0, 2)
+      .ExpectRowBatchesData(RowBatchBuilder(output_rd, 4, true, true)
+                                .AddColumn<types::Int64Value>({1, 2, 3, 5})
+                                .AddColumn<types::Int64Value>({3, 5, 3, 6})
+                                .get(),
+                            2)
+      .Close();
+
+  EXPECT_TRUE(std::filesystem::is_empty(spill_dir.path()));
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
@@ -115,29 +115,44 @@ Status EquijoinNode::InitImpl(const plan::Operator& plan_node) {
   return Status::OK();
 }
 
-Status EquijoinNode::InitializeColumnBuilders() {
+Status EquijoinNode::InitializeColumnBuilders(ExecState* exec_state) {
   for (size_t i = 0; i < output_descriptor_->size(); ++i) {
     column_builders_[i] =
-        MakeArrowBuilder(output_descriptor_->type(i), arrow::default_memory_pool());
+        MakeArrowBuilder(output_descriptor_->type(i), exec_state->exec_mem_pool());
     PL_RETURN_IF_ERROR(column_builders_[i]->Reserve(output_rows_per_batch_));
   }
   return Status::OK();
 }
 
-Status EquijoinNode::PrepareImpl(ExecState* /*exec_state*/) {
+Status EquijoinNode::PrepareImpl(ExecState* exec_state) {
+  key_values_pool_.set_memory_tracker(exec_state->memory_tracker());
+  column_values_pool_.set_memory_tracker(exec_state->memory_tracker());
+  build_reservation_.set_tracker(exec_state->memory_tracker());
+
   column_builders_.resize(output_descriptor_->size());
-  PL_RETURN_IF_ERROR(InitializeColumnBuilders());
+  PL_RETURN_IF_ERROR(InitializeColumnBuilders(exec_state));
 
   return Status::OK();
 }
 
 Status EquijoinNode::OpenImpl(ExecState* /*exec_state*/) { return Status::OK(); }
 
-Status EquijoinNode::CloseImpl(ExecState* /*exec_state*/) {
+void EquijoinNode::ClearBuildBuffer() {
   join_keys_chunk_.clear();
+  build_wrappers_chunk_.clear();
+  probe_wrappers_chunk_.clear();
   build_buffer_.clear();
+  build_buffer_rows_.clear();
   probed_keys_.clear();
   key_values_pool_.Clear();
+  column_values_pool_.Clear();
+  build_reservation_.Reset();
+}
+
+Status EquijoinNode::CloseImpl(ExecState* /*exec_state*/) {
+  ClearBuildBuffer();
+  build_partitions_.reset();
+  probe_partitions_.reset();
   return Status::OK();
 }
 
@@ -208,6 +223,15 @@ Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
     }
   }
 
+  // The build side is copied into the column wrappers, so charge its values to the query.
+  int64_t num_new_keys = 0;
+  for (size_t i = 0; i < build_spec_.input_col_indices.size(); ++i) {
+    auto arr = rb.ColumnAt(build_spec_.input_col_indices[i]).get();
+#define TYPE_CASE(_dt_) build_reservation_.Add(types::GetArrowArrayBytes<_dt_>(arr));
+    PL_SWITCH_FOREACH_DATATYPE(build_spec_.input_col_types[i], TYPE_CASE);
+#undef TYPE_CASE
+  }
+
   // Make sure the map has constructed the necessary column wrappers for all of the tuples.
   for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
     auto& rt = join_keys_chunk_[row_idx];
@@ -232,8 +256,10 @@ Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
       std::swap(build_wrappers_chunk_[row_idx], current);
       // Reset the new tuples that we added
       join_keys_chunk_[row_idx] = nullptr;
+      ++num_new_keys;
     }
   }
+  build_reservation_.Add(num_new_keys * kBuildBufferEntryBytes);
 
   return Status::OK();
 }
@@ -260,6 +286,14 @@ Status AppendColumnDefaultValue(arrow::ArrayBuilder* output_builder, size_t num_
   return Status::OK();
 }
 
+template <types::DataType DT>
+Status AppendKeyValue(arrow::ArrayBuilder* output_builder, const RowTuple& key, size_t key_idx,
+                      size_t num_times) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  return table_store::schema::CopyValueRepeated<DT>(
+      output_builder, udf::UnWrap(key.GetValue<ValueType>(key_idx)), num_times);
+}
+
 // Create a new output row batch from the column builders, and flush the pending row batch.
 // We hold on to a pending row batch because it is difficult to know a priori whether a given
 // output batch will be eos/eow.
@@ -272,10 +306,11 @@ Status EquijoinNode::NextOutputBatch(ExecState* exec_state) {
   }
   pending_output_batch_.swap(output_batch);
 
-  return InitializeColumnBuilders();
+  return InitializeColumnBuilders(exec_state);
 }
 
-Status EquijoinNode::FlushChunkedRows(ExecState* exec_state) {
+// Writes the queued output rows to the column builders.
+Status EquijoinNode::AppendChunkedRows() {
   for (size_t col = 0; col < build_spec_.output_col_indices.size(); ++col) {
     for (const auto& chunk : chunks_) {
       auto output_idx = build_spec_.output_col_indices[col];
@@ -321,6 +356,11 @@ Status EquijoinNode::FlushChunkedRows(ExecState* exec_state) {
   std::vector<EquijoinNode::OutputChunk> new_chunks(0);
   std::swap(chunks_, new_chunks);
   queued_rows_ = 0;
+  return Status::OK();
+}
+
+Status EquijoinNode::FlushChunkedRows(ExecState* exec_state) {
+  PL_RETURN_IF_ERROR(AppendChunkedRows());
   return NextOutputBatch(exec_state);
 }
 
@@ -331,6 +371,11 @@ Status EquijoinNode::MatchBuildValuesAndFlush(ExecState* exec_state,
   int64_t bb_rows_left = matching_bb_rows;
 
   while (bb_rows_left > 0) {
+    // The builders may already be full when rows were appended to them without being flushed,
+    // e.g. between the partitions of a spilled join.
+    if (queued_rows_ + column_builders_[0]->length() == output_rows_per_batch_) {
+      PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
+    }
     auto available = output_rows_per_batch_ - (column_builders_[0]->length() + queued_rows_);
     auto chunk_rows = std::min(bb_rows_left, available);
     OutputChunk c{probe_rb, wrapper, chunk_rows, matching_bb_rows - bb_rows_left, probe_rb_row};
@@ -338,7 +383,7 @@ Status EquijoinNode::MatchBuildValuesAndFlush(ExecState* exec_state,
     queued_rows_ += chunk_rows;
     bb_rows_left -= chunk_rows;
 
-    if (queued_rows_ == output_rows_per_batch_) {
+    if (queued_rows_ + column_builders_[0]->length() == output_rows_per_batch_) {
       PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
     }
   }
@@ -388,7 +433,7 @@ Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::R
                                                 build_buffer_rows_[join_keys_chunk_[row_idx]]));
   }
 
-  if (probe_eos_ && queued_rows_ > 0) {
+  if (rb.eos() && queued_rows_ > 0) {
     PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
   }
 
@@ -403,22 +448,146 @@ Status EquijoinNode::EmitUnmatchedBuildRows(ExecState* exec_state) {
     PL_RETURN_IF_ERROR(MatchBuildValuesAndFlush(exec_state, it->second, nullptr, 0,
                                                 build_buffer_rows_[it->first]));
   }
+  return AppendChunkedRows();
+}
 
-  if (queued_rows_ > 0) {
-    PL_RETURN_IF_ERROR(FlushChunkedRows(exec_state));
+Status EquijoinNode::SpillRowBatch(const table_store::schema::RowBatch& rb, bool is_probe) {
+  PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, is_probe));
+  SpillPartitions* partitions = is_probe ? probe_partitions_.get() : build_partitions_.get();
+  row_partitions_.resize(rb.num_rows());
+  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+    row_partitions_[row_idx] = partitions->PartitionOf(*join_keys_chunk_[row_idx]);
+  }
+  return partitions->Append(rb, row_partitions_);
+}
+
+Status EquijoinNode::SpillBuildBuffer(ExecState* exec_state) {
+  const RowDescriptor& build_desc =
+      input_descriptors_[probe_table_ == EquijoinNode::JoinInputTable::kLeftTable ? 1 : 0];
+  const RowDescriptor& probe_desc =
+      input_descriptors_[probe_table_ == EquijoinNode::JoinInputTable::kLeftTable ? 0 : 1];
+  auto label = absl::Substitute("join_$0_$1", exec_state->query_id().str(), plan_node_->id());
+  PL_ASSIGN_OR_RETURN(build_partitions_,
+                      SpillPartitions::Create(label + "_build", build_desc,
+                                              exec_state->exec_mem_pool(),
+                                              FLAGS_carnot_spill_partitions));
+  PL_ASSIGN_OR_RETURN(probe_partitions_,
+                      SpillPartitions::Create(label + "_probe", probe_desc,
+                                              exec_state->exec_mem_pool(),
+                                              FLAGS_carnot_spill_partitions));
+  LOG(INFO) << absl::Substitute("$0 is spilling $1 build keys ($2 bytes) to $3.",
+                                DebugString(), build_buffer_.size(), build_reservation_.bytes(),
+                                FLAGS_carnot_spill_dir);
+
+  // The build buffer only keeps the build columns that are part of the output, plus the keys.
+  // The spilled rows have all of the build columns, with default values for the others.
+  std::vector<int64_t> wrapper_cols(build_desc.size(), -1);
+  for (size_t i = 0; i < build_spec_.input_col_indices.size(); ++i) {
+    wrapper_cols[build_spec_.input_col_indices[i]] = i;
+  }
+  std::vector<int64_t> key_cols(build_desc.size(), -1);
+  for (size_t i = 0; i < build_spec_.key_indices.size(); ++i) {
+    key_cols[build_spec_.key_indices[i]] = i;
+  }
+
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders(build_desc.size());
+  for (size_t col = 0; col < build_desc.size(); ++col) {
+    builders[col] = MakeArrowBuilder(build_desc.type(col), exec_state->exec_mem_pool());
+  }
+  auto write_build_rows = [&]() -> Status {
+    PL_ASSIGN_OR_RETURN(auto rb, RowBatch::FromColumnBuilders(build_desc, false, false, &builders));
+    PL_RETURN_IF_ERROR(build_partitions_->Append(*rb, row_partitions_));
+    row_partitions_.clear();
+    return Status::OK();
+  };
+
+  row_partitions_.clear();
+  for (const auto& [key, wrappers] : build_buffer_) {
+    int64_t num_rows = build_buffer_rows_[key];
+    for (size_t col = 0; col < build_desc.size(); ++col) {
+      auto builder = builders[col].get();
+      PL_RETURN_IF_ERROR(builder->Reserve(num_rows));
+      if (wrapper_cols[col] >= 0) {
+#define TYPE_CASE(_dt_)                                                                      \
+  PL_RETURN_IF_ERROR(AppendValuesFromWrapper<_dt_>(builder, wrappers->at(wrapper_cols[col]), \
+                                                   0, num_rows))
+        PL_SWITCH_FOREACH_DATATYPE(build_desc.type(col), TYPE_CASE);
+#undef TYPE_CASE
+      } else if (key_cols[col] >= 0) {
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(AppendKeyValue<_dt_>(builder, *key, key_cols[col], num_rows))
+        PL_SWITCH_FOREACH_DATATYPE(build_desc.type(col), TYPE_CASE);
+#undef TYPE_CASE
+      } else {
+#define TYPE_CASE(_dt_) PL_RETURN_IF_ERROR(AppendColumnDefaultValue<_dt_>(builder, num_rows))
+        PL_SWITCH_FOREACH_DATATYPE(build_desc.type(col), TYPE_CASE);
+#undef TYPE_CASE
+      }
+    }
+    row_partitions_.insert(row_partitions_.end(), num_rows, build_partitions_->PartitionOf(*key));
+    if (builders[0]->length() >= output_rows_per_batch_) {
+      PL_RETURN_IF_ERROR(write_build_rows());
+    }
+  }
+  if (builders[0]->length() > 0) {
+    PL_RETURN_IF_ERROR(write_build_rows());
+  }
+  ClearBuildBuffer();
+
+  // The probe batches that arrived so far can't be probed until the partitions are joined either.
+  while (probe_batches_.size()) {
+    probe_eos_ = probe_eos_ || probe_batches_.front().eos();
+    PL_RETURN_IF_ERROR(SpillRowBatch(probe_batches_.front(), /* is_probe */ true));
+    probe_batches_.pop();
   }
   return Status::OK();
 }
 
+Status EquijoinNode::JoinSpilledPartitions(ExecState* exec_state) {
+  PL_RETURN_IF_ERROR(build_partitions_->FinishWriting());
+  PL_RETURN_IF_ERROR(probe_partitions_->FinishWriting());
+
+  for (size_t partition = 0; partition < build_partitions_->num_partitions(); ++partition) {
+    PL_RETURN_IF_ERROR(build_partitions_->ReadPartition(partition, [&](const RowBatch& rb) {
+      PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, /* is_probe */ false));
+      PL_RETURN_IF_ERROR(HashRowBatch(rb));
+      // A partition that does not fit in memory either is not split any further.
+      return build_reservation_.CheckLimit();
+    }));
+    PL_RETURN_IF_ERROR(probe_partitions_->ReadPartition(
+        partition, [&](const RowBatch& rb) { return DoProbe(exec_state, rb); }));
+    if (build_spec_.emit_unmatched_rows) {
+      PL_RETURN_IF_ERROR(EmitUnmatchedBuildRows(exec_state));
+    }
+    // The queued output rows point into the build buffer, so write them out before clearing it.
+    PL_RETURN_IF_ERROR(AppendChunkedRows());
+    ClearBuildBuffer();
+  }
+
+  build_partitions_.reset();
+  probe_partitions_.reset();
+  return Status::OK();
+}
+
 Status EquijoinNode::ConsumeBuildBatch(ExecState* exec_state,
                                        const table_store::schema::RowBatch& rb) {
   if (rb.eos()) {
     build_eos_ = true;
   }
 
+  if (spilling()) {
+    return SpillRowBatch(rb, /* is_probe */ false);
+  }
+
   PL_RETURN_IF_ERROR(ExtractJoinKeysForBatch(rb, false));
   PL_RETURN_IF_ERROR(HashRowBatch(rb));
 
+  // Joins ordered by time can't spill, since the partitions would not be joined in order.
+  if (!plan_node_->order_by_time() && ShouldSpill(build_reservation_)) {
+    return SpillBuildBuffer(exec_state);
+  }
+  PL_RETURN_IF_ERROR(build_reservation_.CheckLimit());
+
   if (build_eos_) {
     while (probe_batches_.size()) {
       PL_RETURN_IF_ERROR(DoProbe(exec_state, probe_batches_.front()));
@@ -430,6 +599,10 @@ Status EquijoinNode::ConsumeBuildBatch(ExecState* exec_state,
 
 Status EquijoinNode::ConsumeProbeBatch(ExecState* exec_state,
                                        const table_store::schema::RowBatch& rb) {
+  if (spilling()) {
+    probe_eos_ = rb.eos();
+    return SpillRowBatch(rb, /* is_probe */ true);
+  }
   if (!build_eos_) {
     probe_batches_.push(rb);
     return Status::OK();
@@ -448,7 +621,9 @@ Status EquijoinNode::ConsumeNextImpl(ExecState* exec_state, const table_store::s
   }
 
   if (build_eos_ && probe_eos_) {
-    if (build_spec_.emit_unmatched_rows) {
+    if (spilling()) {
+      PL_RETURN_IF_ERROR(JoinSpilledPartitions(exec_state));
+    } else if (build_spec_.emit_unmatched_rows) {
       PL_RETURN_IF_ERROR(EmitUnmatchedBuildRows(exec_state));
     }
 
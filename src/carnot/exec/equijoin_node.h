@@ -31,6 +31,7 @@
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/exec/spill_file.h"
 #include "src/carnot/plan/operators.h"
 #include "src/common/base/base.h"
 #include "src/common/base/status.h"
@@ -45,6 +46,11 @@ namespace exec {
 
 constexpr size_t kDefaultJoinRowBatchSize = 1024;
 
+// Estimate of the bytes held by the build buffer maps for each distinct key, beyond the key
+// RowTuple and the column wrappers, which are charged by their object pools.
+constexpr int64_t kBuildBufferEntryBytes =
+    2 * sizeof(RowTuple*) + sizeof(std::vector<types::SharedColumnWrapper>*) + sizeof(int64_t);
+
 class EquijoinNode : public ProcessingNode {
   enum class JoinInputTable { kLeftTable, kRightTable };
 
@@ -74,8 +80,9 @@ class EquijoinNode : public ProcessingNode {
                          size_t parent_index) override;
 
  private:
-  Status InitializeColumnBuilders();
+  Status InitializeColumnBuilders(ExecState* exec_state);
   bool IsProbeTable(size_t parent_index);
+  Status AppendChunkedRows();
   Status FlushChunkedRows(ExecState* exec_state);
   Status ExtractJoinKeysForBatch(const table_store::schema::RowBatch& rb, bool is_probe);
   Status HashRowBatch(const table_store::schema::RowBatch& rb);
@@ -90,6 +97,15 @@ class EquijoinNode : public ProcessingNode {
   Status ConsumeBuildBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status ConsumeProbeBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
 
+  // Spilling (grace hash join): once the build side does not fit in memory, the build buffer is
+  // written to disk, split into partitions by key. All of the following build and probe rows go to
+  // the same partitions, which are then joined one at a time.
+  bool spilling() const { return build_partitions_ != nullptr; }
+  Status SpillBuildBuffer(ExecState* exec_state);
+  Status SpillRowBatch(const table_store::schema::RowBatch& rb, bool is_probe);
+  Status JoinSpilledPartitions(ExecState* exec_state);
+  void ClearBuildBuffer();
+
   bool build_eos_ = false;
   bool probe_eos_ = false;
   // Note whether the left or the right table is the probe table.
@@ -151,6 +167,15 @@ class EquijoinNode : public ProcessingNode {
   // keep track of which ones they were.
   AbslRowTupleHashSet probed_keys_;
 
+  // The bytes of the build side values and of the build buffer entries, charged to the query.
+  MemoryReservation build_reservation_;
+
+  // The spilled build and probe rows, set once the join starts spilling.
+  std::unique_ptr<SpillPartitions> build_partitions_;
+  std::unique_ptr<SpillPartitions> probe_partitions_;
+  // The partition of each row of the row batch that is being spilled.
+  std::vector<int64_t> row_partitions_;
+
   // Handle on the most recent RowBatch (in case it's the final one).
   std::unique_ptr<table_store::schema::RowBatch> pending_output_batch_;
 
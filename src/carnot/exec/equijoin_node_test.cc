@@ -29,6 +29,7 @@
 #include "src/carnot/planpb/test_proto.h"
 #include "src/carnot/udf/base.h"
 #include "src/carnot/udf/registry.h"
+#include "src/common/testing/temp_dir.h"
 
 namespace px {
 namespace carnot {
@@ -46,6 +47,7 @@ using udf::FunctionContext;
 // 3) non-time ordered full outer join (all batches from build first)
 // 4) non-time ordered no matches inner join
 // 5) non-time ordered many matches per key inner join
+// 6) non-time ordered full outer join that spills to disk
 
 class JoinNodeTest : public ::testing::Test {
  public:
@@ -685,6 +687,91 @@ TEST_F(JoinNodeTest, unordered_many_matches) {
       .Close();
 }
 
+TEST_F(JoinNodeTest, unordered_full_outer_join_spilled) {
+  // Same as unordered_full_outer_join, but the build side is spilled after its first batch.
+  gflags::FlagSaver flag_saver;
+  px::testing::TempDir spill_dir;
+  FLAGS_carnot_spill_dir = spill_dir.path().string();
+  FLAGS_carnot_spill_memory_fraction = 0;
+  FLAGS_carnot_spill_partitions = 4;
+  auto table_store = std::make_shared<table_store::TableStore>();
+  exec_state_ = std::make_unique<ExecState>(
+      func_registry_.get(), table_store, MockResultSinkStubGenerator, sole::uuid4(), nullptr,
+      nullptr, [](grpc::ClientContext*) {}, QueryMemoryPool::Create("test", 1024 * 1024));
+
+  const char* proto = R"(
+  type: FULL_OUTER
+  equality_conditions {
+    left_column_index: 0
+    right_column_index: 1
+  }
+  output_columns: {
+    parent_index: 0
+    column_index: 1
+  }
+  output_columns: {
+    parent_index: 1
+    column_index: 1
+  }
+  output_columns: {
+    parent_index: 1
+    column_index: 0
+  }
+  column_names: "left_1"
+  column_names: "right_1"
+  column_names: "right_0"
+  rows_per_batch: 5
+)";
+
+  // Left
+  RowDescriptor input_rd_0({types::DataType::TIME64NS, types::DataType::INT64});
+  // Right
+  RowDescriptor input_rd_1({types::DataType::INT64, types::DataType::TIME64NS});
+  // Left[1], Right[1], Right[0]
+  RowDescriptor output_rd(
+      {types::DataType::INT64, types::DataType::TIME64NS, types::DataType::INT64});
+
+  auto plan_node = PlanNodeFromPbtxt(proto);
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+
+  tester
+      // Build table
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 5, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({101, 200, 101, 200, 101})
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4, 5})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 5, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({200, 200, 200, 300, 300})
+                       .AddColumn<types::Int64Value>({6, 8, 10, 12, 14})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Time64NSValue>({400, 500})
+                       .AddColumn<types::Int64Value>({16, 18})
+                       .get(),
+                   0, 0)
+      // Probe table. The partitions are joined once it is done.
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 3, true, true)
+                       .AddColumn<types::Int64Value>({-10, -20, -30})
+                       .AddColumn<types::Time64NSValue>({110, 120, 101})
+                       .get(),
+                   1, 3)
+      .ExpectRowBatchesData(
+          RowBatchBuilder(output_rd, 14, true, true)
+              .AddColumn<types::Int64Value>({0, 0, 1, 3, 5, 2, 4, 6, 8, 10, 12, 14, 16, 18})
+              .AddColumn<types::Time64NSValue>(
+                  {110, 120, 101, 101, 101, 0, 0, 0, 0, 0, 0, 0, 0, 0})
+              .AddColumn<types::Int64Value>({-10, -20, -30, -30, -30, 0, 0, 0, 0, 0, 0, 0, 0, 0})
+              .get(),
+          3)
+      .Close();
+
+  // The spill files are removed once the join is done.
+  EXPECT_TRUE(std::filesystem::is_empty(spill_dir.path()));
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
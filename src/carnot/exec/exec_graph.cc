@@ -35,6 +35,8 @@
 #include "src/carnot/exec/map_node.h"
 #include "src/carnot/exec/memory_sink_node.h"
 #include "src/carnot/exec/memory_source_node.h"
+#include "src/carnot/exec/merge_join_node.h"
+#include "src/carnot/exec/pipeline_node.h"
 #include "src/carnot/exec/udtf_source_node.h"
 #include "src/carnot/exec/union_node.h"
 #include "src/carnot/plan/operators.h"
@@ -61,9 +63,12 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
 
   std::unordered_map<int64_t, ExecNode*> nodes;
   std::unordered_map<int64_t, RowDescriptor> descriptors;
+  if (FLAGS_carnot_fuse_map_filter) {
+    FindPipelines();
+  }
   return plan::PlanFragmentWalker()
       .OnMap([&](auto& node) {
-        return OnOperatorImpl<plan::MapOperator, MapNode>(node, &descriptors);
+        return OnPipelineOperatorImpl<plan::MapOperator, MapNode>(node, &descriptors);
       })
       .OnMemorySink([&](auto& node) {
         sinks_.push_back(node.id());
@@ -76,7 +81,7 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
         return OnOperatorImpl<plan::MemorySourceOperator, MemorySourceNode>(node, &descriptors);
       })
       .OnFilter([&](auto& node) {
-        return OnOperatorImpl<plan::FilterOperator, FilterNode>(node, &descriptors);
+        return OnPipelineOperatorImpl<plan::FilterOperator, FilterNode>(node, &descriptors);
       })
       .OnLimit([&](auto& node) {
         return OnOperatorImpl<plan::LimitOperator, LimitNode>(node, &descriptors);
@@ -85,6 +90,9 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
         return OnOperatorImpl<plan::UnionOperator, UnionNode>(node, &descriptors);
       })
       .OnJoin([&](auto& node) {
+        if (node.sort_merge()) {
+          return OnOperatorImpl<plan::JoinOperator, MergeJoinNode>(node, &descriptors);
+        }
         return OnOperatorImpl<plan::JoinOperator, EquijoinNode>(node, &descriptors);
       })
       .OnGRPCSource([&](auto& node) {
@@ -108,6 +116,34 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
       .Walk(pf_);
 }
 
+namespace {
+bool IsPipelineOperator(const plan::Operator& op) {
+  return op.op_type() == planpb::OperatorType::MAP_OPERATOR ||
+         op.op_type() == planpb::OperatorType::FILTER_OPERATOR;
+}
+}  // namespace
+
+void ExecutionGraph::FindPipelines() {
+  auto& plan_nodes = pf_->nodes();
+  // An operator is fused into its parent when both are Maps or Filters and neither the parent nor
+  // the operator branches. Walking in topological order resolves each parent before its children.
+  for (int64_t id : pf_->dag().TopologicalSort()) {
+    if (!IsPipelineOperator(*plan_nodes.at(id))) {
+      continue;
+    }
+    auto parents = pf_->dag().ParentsOf(id);
+    if (parents.size() != 1 || !IsPipelineOperator(*plan_nodes.at(parents[0])) ||
+        pf_->dag().DependenciesOf(parents[0]).size() != 1) {
+      continue;
+    }
+    int64_t parent = parents[0];
+    auto parent_head = pipeline_head_of_.find(parent);
+    int64_t head = parent_head == pipeline_head_of_.end() ? parent : parent_head->second;
+    pipeline_head_of_[id] = head;
+    pipeline_heads_.insert(head);
+  }
+}
+
 bool ExecutionGraph::YieldWithTimeout() {
   std::unique_lock<std::mutex> lock(execution_mutex_);
   if (continue_) {
@@ -292,9 +328,13 @@ Status ExecutionGraph::ExecuteSources() {
 Status ExecutionGraph::Execute() {
   query_start_time_ = std::chrono::system_clock::now();
 
-  // Get vector of nodes.
-  std::vector<ExecNode*> nodes(nodes_.size());
-  transform(nodes_.begin(), nodes_.end(), nodes.begin(), [](auto pair) { return pair.second; });
+  // Get vector of nodes. Operators fused into a pipeline share its node, so skip their aliases.
+  std::vector<ExecNode*> nodes;
+  for (const auto& [id, node] : nodes_) {
+    if (!pipeline_head_of_.contains(id)) {
+      nodes.push_back(node);
+    }
+  }
 
   for (auto node : nodes) {
     PL_RETURN_IF_ERROR(node->Prepare(exec_state_));
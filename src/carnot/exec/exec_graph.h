@@ -32,6 +32,7 @@
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/memory_source_node.h"
+#include "src/carnot/exec/pipeline_node.h"
 #include "src/carnot/plan/plan_fragment.h"
 #include "src/carnot/plan/plan_state.h"
 #include "src/common/base/base.h"
@@ -208,6 +209,43 @@ class ExecutionGraph {
     return Status::OK();
   }
 
+  /**
+   * Creates the execution node for a Map or Filter operator. Operators that FindPipelines fused
+   * into a chain are appended to the PipelineNode of the chain's head instead of getting a node of
+   * their own.
+   */
+  template <typename TOp, typename TNode>
+  Status OnPipelineOperatorImpl(
+      TOp node, std::unordered_map<int64_t, table_store::schema::RowDescriptor>* descriptors) {
+    auto head = pipeline_head_of_.find(node.id());
+    if (head == pipeline_head_of_.end()) {
+      if (pipeline_heads_.contains(node.id())) {
+        return OnOperatorImpl<TOp, PipelineNode>(node, descriptors);
+      }
+      return OnOperatorImpl<TOp, TNode>(node, descriptors);
+    }
+
+    auto parents = pf_->dag().ParentsOf(node.id());
+    PL_ASSIGN_OR_RETURN(auto output_rel, node.OutputRelation(*schema_, *plan_state_, parents));
+    table_store::schema::RowDescriptor output_descriptor(output_rel.col_types());
+    schema_->AddRelation(node.id(), output_rel);
+    descriptors->insert({node.id(), output_descriptor});
+
+    auto pipeline = nodes_.find(head->second);
+    if (pipeline == nodes_.end()) {
+      return error::NotFound("Could not find PipelineNode $0.", head->second);
+    }
+    auto pipeline_node = static_cast<PipelineNode*>(pipeline->second);
+    PL_RETURN_IF_ERROR(pipeline_node->AppendStage(node, output_descriptor));
+    // The fused operator's id resolves to the pipeline, so that its children attach to the end of
+    // the chain.
+    nodes_[node.id()] = pipeline_node;
+    return Status::OK();
+  }
+
+  // Computes pipeline_head_of_ and pipeline_heads_ for the plan fragment.
+  void FindPipelines();
+
   Status ExecuteSources();
 
   ExecState* exec_state_;
@@ -220,6 +258,9 @@ class ExecutionGraph {
   absl::flat_hash_set<int64_t> grpc_sources_;
   absl::flat_hash_set<int64_t> grpc_sinks_;
   std::unordered_map<int64_t, ExecNode*> nodes_;
+  // Maps each Map/Filter operator fused into a pipeline to the id of the operator heading it.
+  absl::flat_hash_map<int64_t, int64_t> pipeline_head_of_;
+  absl::flat_hash_set<int64_t> pipeline_heads_;
 
   SystemTimePoint query_start_time_;
 
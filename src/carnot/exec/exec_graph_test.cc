@@ -30,6 +30,7 @@
 #include <sole.hpp>
 
 #include "src/carnot/exec/grpc_source_node.h"
+#include "src/carnot/exec/pipeline_node.h"
 #include "src/carnot/exec/test_utils.h"
 #include "src/carnot/plan/plan_fragment.h"
 #include "src/carnot/plan/plan_state.h"
@@ -213,6 +214,42 @@ std::vector<std::tuple<int32_t>> calls_to_execute = {
 INSTANTIATE_TEST_SUITE_P(ExecGraphExecuteTestSuite, ExecGraphExecuteTest,
                          ::testing::ValuesIn(calls_to_execute));
 
+TEST_F(ExecGraphTest, fuses_map_chains) {
+  planpb::PlanFragment pf_pb;
+  ASSERT_TRUE(TextFormat::MergeFromString(planpb::testutils::kLinearPlanFragment, &pf_pb));
+  auto plan_state = std::make_unique<plan::PlanState>(func_registry_.get());
+  table_store::schema::Relation relation(
+      std::vector<types::DataType>(
+          {types::DataType::INT64, types::DataType::BOOLEAN, types::DataType::FLOAT64}),
+      std::vector<std::string>({"a", "b", "c"}));
+
+  for (bool fuse : {true, false}) {
+    FLAGS_carnot_fuse_map_filter = fuse;
+    auto plan_fragment = std::make_shared<plan::PlanFragment>(1);
+    ASSERT_OK(plan_fragment->Init(pf_pb));
+    auto schema = std::make_shared<table_store::schema::Schema>();
+    schema->AddRelation(1, relation);
+
+    ExecutionGraph e;
+    ASSERT_OK(e.Init(schema.get(), plan_state.get(), exec_state_.get(), plan_fragment.get(),
+                     /* collect_exec_node_stats */ false));
+    auto first_map = e.node(2).ConsumeValueOrDie();
+    auto second_map = e.node(3).ConsumeValueOrDie();
+    auto sink = e.node(4).ConsumeValueOrDie();
+    if (fuse) {
+      EXPECT_EQ(first_map, second_map);
+      EXPECT_EQ(2, static_cast<PipelineNode*>(first_map)->num_stages());
+      ASSERT_EQ(1, first_map->children().size());
+      EXPECT_EQ(sink, first_map->children()[0]);
+    } else {
+      EXPECT_NE(first_map, second_map);
+      ASSERT_EQ(1, first_map->children().size());
+      EXPECT_EQ(second_map, first_map->children()[0]);
+    }
+  }
+  FLAGS_carnot_fuse_map_filter = true;
+}
+
 TEST_F(ExecGraphTest, execute_time) {
   planpb::PlanFragment pf_pb;
   ASSERT_TRUE(TextFormat::MergeFromString(planpb::testutils::kLinearPlanFragment, &pf_pb));
@@ -46,7 +46,7 @@ struct ExecNodeStats {
     }
     ++batches_output;
     bytes_output += rb.NumBytes();
-    rows_output += rb.num_rows();
+    rows_output += rb.num_selected_rows();
   }
 
   void AddInputStats(const table_store::schema::RowBatch& rb) {
@@ -55,7 +55,7 @@ struct ExecNodeStats {
     }
     ++batches_input;
     bytes_input += rb.NumBytes();
-    rows_input += rb.num_rows();
+    rows_input += rb.num_selected_rows();
   }
 
   void ResumeChildTimer() {
@@ -275,6 +275,37 @@ class ExecNode {
 
   ExecNodeStats* stats() const { return stats_.get(); }
 
+  /**
+   * Whether ConsumeNext accepts row batches with a selection vector. Other nodes get a compacted
+   * copy from their parent.
+   */
+  virtual bool ConsumesSelectionVectors() const { return false; }
+
+  /**
+   * Whether ConsumeNext accepts row batches where the input column at the given index is deferred
+   * (see RowBatch::AddDeferredColumn). Other nodes get a compacted copy from their parent, which
+   * materializes the deferred columns for the selected rows.
+   */
+  virtual bool AcceptsDeferredColumn(int64_t /*col_idx*/) const { return false; }
+
+  /**
+   * Whether ConsumeNext accepts the row batch as is, rather than a compacted copy.
+   */
+  bool AcceptsRowBatch(const table_store::schema::RowBatch& rb) const {
+    if (rb.has_selection() && !ConsumesSelectionVectors()) {
+      return false;
+    }
+    if (!rb.has_deferred_columns()) {
+      return true;
+    }
+    for (int64_t i = 0; i < rb.num_columns(); ++i) {
+      if (rb.IsDeferred(i) && !AcceptsDeferredColumn(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
  protected:
   /**
    * Send data to children row batches.
@@ -284,7 +315,17 @@ class ExecNode {
    */
   Status SendRowBatchToChildren(ExecState* exec_state, const table_store::schema::RowBatch& rb) {
     stats_->ResumeChildTimer();
+    // Compaction is deferred until a child needs dense columns, and done at most once.
+    std::unique_ptr<table_store::schema::RowBatch> compacted;
     for (size_t i = 0; i < children_.size(); ++i) {
+      if (!children_[i]->AcceptsRowBatch(rb)) {
+        if (compacted == nullptr) {
+          PL_ASSIGN_OR_RETURN(compacted, rb.Compact(exec_state->exec_mem_pool()));
+        }
+        PL_RETURN_IF_ERROR(
+            children_[i]->ConsumeNext(exec_state, *compacted, parent_ids_for_children_[i]));
+        continue;
+      }
       PL_RETURN_IF_ERROR(children_[i]->ConsumeNext(exec_state, rb, parent_ids_for_children_[i]));
     }
     stats_->StopChildTimer();
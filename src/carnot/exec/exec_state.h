@@ -31,6 +31,7 @@
 #include "src/carnot/carnotpb/carnot.pb.h"
 #include "src/carnot/exec/grpc_router.h"
 #include "src/carnot/exec/ml/model_pool.h"
+#include "src/carnot/exec/query_memory_pool.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/base.h"
 #include "src/shared/metadata/metadata_state.h"
@@ -60,24 +61,31 @@ class ExecState {
       udf::Registry* func_registry, std::shared_ptr<table_store::TableStore> table_store,
       const ResultSinkStubGenerator& stub_generator, const sole::uuid& query_id,
       ml::ModelPool* model_pool, GRPCRouter* grpc_router = nullptr,
-      std::function<void(grpc::ClientContext*)> add_auth_func = [](grpc::ClientContext*) {})
+      std::function<void(grpc::ClientContext*)> add_auth_func = [](grpc::ClientContext*) {},
+      QueryMemoryPoolPtr exec_mem_pool = nullptr)
       : func_registry_(func_registry),
         table_store_(std::move(table_store)),
         stub_generator_(stub_generator),
         query_id_(query_id),
         model_pool_(model_pool),
         grpc_router_(grpc_router),
-        add_auth_to_grpc_client_context_func_(add_auth_func) {}
+        add_auth_to_grpc_client_context_func_(add_auth_func),
+        exec_mem_pool_(std::move(exec_mem_pool)) {
+    if (exec_mem_pool_ == nullptr) {
+      exec_mem_pool_ = QueryMemoryPool::Create(query_id_.str(), MemoryTracker::kNoLimit);
+    }
+  }
 
   ~ExecState() {
     if (grpc_router_ != nullptr) {
       grpc_router_->DeleteQuery(query_id_);
     }
   }
-  arrow::MemoryPool* exec_mem_pool() {
-    // TOOD(zasgar): Make this the correct pool.
-    return arrow::default_memory_pool();
-  }
+  arrow::MemoryPool* exec_mem_pool() { return exec_mem_pool_.get(); }
+
+  // Tracks the memory used by this query. Operators charge the state they keep across row batches
+  // (e.g. hash tables) to it, in addition to the arrays allocated from exec_mem_pool().
+  MemoryTracker* memory_tracker() { return exec_mem_pool_->tracker(); }
 
   udf::Registry* func_registry() { return func_registry_; }
 
@@ -174,6 +182,7 @@ class ExecState {
   ml::ModelPool* model_pool_;
   GRPCRouter* grpc_router_ = nullptr;
   std::function<void(grpc::ClientContext*)> add_auth_to_grpc_client_context_func_;
+  QueryMemoryPoolPtr exec_mem_pool_;
 
   int64_t current_source_ = 0;
   bool current_source_set_ = false;
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -41,6 +42,13 @@ class FilterNode : public ProcessingNode {
   FilterNode() = default;
   virtual ~FilterNode() = default;
 
+  bool ConsumesSelectionVectors() const override { return true; }
+  // Deferred columns pass through the filter unless the predicate reads them.
+  bool AcceptsDeferredColumn(int64_t col_idx) const override {
+    return std::find(predicate_cols_.begin(), predicate_cols_.end(), col_idx) ==
+           predicate_cols_.end();
+  }
+
  protected:
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -54,6 +62,8 @@ class FilterNode : public ProcessingNode {
   std::unique_ptr<VectorNativeScalarExpressionEvaluator> evaluator_;
   std::unique_ptr<plan::FilterOperator> plan_node_;
   std::unique_ptr<udf::FunctionContext> function_ctx_;
+  // The input columns that the predicate reads.
+  std::vector<int64_t> predicate_cols_;
 };
 
 }  // namespace exec
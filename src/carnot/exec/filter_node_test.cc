@@ -18,6 +18,7 @@
 
 #include "src/carnot/exec/filter_node.h"
 
+#include <google/protobuf/text_format.h>
 #include <sole.hpp>
 
 #include "src/carnot/exec/test_utils.h"
@@ -52,12 +53,55 @@ class StrEqUDF : public udf::ScalarUDF {
   }
 };
 
+class ModUDF : public udf::ScalarUDF {
+ public:
+  types::Int64Value Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    return v1.val % v2.val;
+  }
+};
+
+// The predicate mod(col1, col0) == 0, which can't be evaluated on the rows where col0 == 0.
+constexpr char kModIsZeroPredicate[] = R"(
+func {
+  name: "eq"
+  id: 0
+  args {
+    func {
+      name: "mod"
+      id: 2
+      args {
+        column {
+          node: 0
+          index: 1
+        }
+      }
+      args {
+        column {
+          node: 0
+          index: 0
+        }
+      }
+      args_data_types: INT64
+      args_data_types: INT64
+    }
+  }
+  args {
+    constant {
+      data_type: INT64,
+      int64_value: 0
+    }
+  }
+  args_data_types: INT64
+  args_data_types: INT64
+})";
+
 class FilterNodeTest : public ::testing::Test {
  public:
   FilterNodeTest() {
     func_registry_ = std::make_unique<udf::Registry>("test_registry");
     EXPECT_OK(func_registry_->Register<EqUDF>("eq"));
     EXPECT_OK(func_registry_->Register<StrEqUDF>("eq"));
+    EXPECT_OK(func_registry_->Register<ModUDF>("mod"));
     auto table_store = std::make_shared<table_store::TableStore>();
 
     exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
@@ -66,6 +110,8 @@ class FilterNodeTest : public ::testing::Test {
         0, "eq", std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
     EXPECT_OK(exec_state_->AddScalarUDF(
         1, "eq", std::vector<types::DataType>({types::DataType::STRING, types::DataType::STRING})));
+    EXPECT_OK(exec_state_->AddScalarUDF(
+        2, "mod", std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
   }
 
  protected:
@@ -186,6 +232,81 @@ TEST_F(FilterNodeTest, zero_row_row_batch) {
       .Close();
 }
 
+TEST_F(FilterNodeTest, deferred_column) {
+  auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
+  plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+  RowDescriptor output_rd(
+      {types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+
+  auto strings = RowBatchBuilder(RowDescriptor({types::DataType::STRING}), 4, false, false)
+                     .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"})
+                     .get()
+                     .ColumnAt(0);
+  std::vector<std::vector<int64_t>> fetched;
+  auto fetcher = std::make_shared<const RowBatch::ColumnFetcher>(
+      [&](const std::vector<int64_t>& rows,
+          arrow::MemoryPool* mem_pool) -> StatusOr<std::shared_ptr<arrow::Array>> {
+        fetched.push_back(rows);
+        return table_store::schema::GatherRows(types::DataType::STRING, strings.get(), rows,
+                                               mem_pool);
+      });
+  RowBatch input_rb(input_rd, 4);
+  EXPECT_OK(input_rb.AddColumn(types::ToArrow(std::vector<types::Int64Value>{1, 1, 3, 4},
+                                              arrow::default_memory_pool())));
+  EXPECT_OK(input_rb.AddColumn(types::ToArrow(std::vector<types::Int64Value>{1, 3, 6, 9},
+                                              arrow::default_memory_pool())));
+  EXPECT_OK(input_rb.AddDeferredColumn(fetcher));
+  input_rb.set_eow(true);
+  input_rb.set_eos(true);
+
+  auto tester = exec::ExecNodeTester<FilterNode, plan::FilterOperator>(
+      *plan_node_, output_rd, {input_rd}, exec_state_.get());
+  // The predicate reads the first two columns.
+  EXPECT_FALSE(tester.node()->AcceptsDeferredColumn(0));
+  EXPECT_TRUE(tester.node()->AcceptsDeferredColumn(2));
+
+  // The child needs dense columns, so only the strings of the rows that pass get fetched.
+  tester.ConsumeNext(input_rb, 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, true)
+                          .AddColumn<types::Int64Value>({1, 1})
+                          .AddColumn<types::Int64Value>({1, 3})
+                          .AddColumn<types::StringValue>({"ABC", "DEF"})
+                          .get())
+      .Close();
+  EXPECT_THAT(fetched, ::testing::ElementsAre(std::vector<int64_t>{0, 1}));
+}
+
+TEST_F(FilterNodeTest, skips_rows_dropped_by_earlier_filter) {
+  // The input comes from filter(col0 != 0), so mod(col1, col0) must not run on the dropped rows.
+  auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
+  op_proto.mutable_filter_op()->clear_expression();
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(
+      kModIsZeroPredicate, op_proto.mutable_filter_op()->mutable_expression()));
+  plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+  RowDescriptor output_rd(
+      {types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+
+  RowBatchBuilder input(input_rd, 4, /*eow*/ true, /*eos*/ true);
+  input.AddColumn<types::Int64Value>({1, 0, 2, 0})
+      .AddColumn<types::Int64Value>({5, 7, 4, 9})
+      .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"});
+  input.get().set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{0, 2}));
+
+  auto tester = exec::ExecNodeTester<FilterNode, plan::FilterOperator>(
+      *plan_node_, output_rd, {input_rd}, exec_state_.get());
+  tester.ConsumeNext(input.get(), 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, true)
+                          .AddColumn<types::Int64Value>({1, 2})
+                          .AddColumn<types::Int64Value>({5, 4})
+                          .AddColumn<types::StringValue>({"ABC", "HELLO"})
+                          .get())
+      .Close();
+}
+
 TEST_F(FilterNodeTest, string_pred) {
   auto op_proto = planpb::testutils::CreateTestFilterTwoColsString();
   plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
@@ -310,7 +310,17 @@ Status GRPCSinkNode::SplitAndSendBatch(ExecState* exec_state, const RowBatch& rb
 }
 
 Status GRPCSinkNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t parent_idx) {
-  if (rb.NumBytes() > (max_batch_size_ * batch_size_factor_)) {
+  // ToProto only serializes the selected rows, so a batch with a selection vector is estimated by
+  // its selected share of the bytes and only compacted if it has to be split.
+  int64_t num_bytes = rb.NumBytes();
+  if (rb.has_selection() && rb.num_rows() > 0) {
+    num_bytes = num_bytes * rb.num_selected_rows() / rb.num_rows();
+  }
+  if (num_bytes > (max_batch_size_ * batch_size_factor_)) {
+    if (rb.has_selection()) {
+      PL_ASSIGN_OR_RETURN(auto compacted, rb.Compact(exec_state->exec_mem_pool()));
+      return SplitAndSendBatch(exec_state, *compacted, parent_idx);
+    }
     return SplitAndSendBatch(exec_state, rb, parent_idx);
   }
   return ConsumeNextImplNoSplit(exec_state, rb, parent_idx);
@@ -19,7 +19,9 @@
 #include "src/carnot/exec/limit_node.h"
 
 #include <arrow/array.h>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <absl/strings/substitute.h>
@@ -62,24 +64,37 @@ Status LimitNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, siz
   }
 
   // Check if the entire row batch will fit.
-  if (remainder_records > rb.num_rows()) {
+  if (remainder_records > rb.num_selected_rows()) {
     RowBatch output_rb(*output_descriptor_, rb.num_rows());
     DCHECK_EQ(output_descriptor_->size(), plan_node_->selected_cols().size());
     // If so we just need to convert to output descriptor and transfer it.
     for (int64_t input_col_idx : plan_node_->selected_cols()) {
       PL_RETURN_IF_ERROR(output_rb.AddColumn(rb.ColumnAt(input_col_idx)));
     }
-    records_processed_ += rb.num_rows();
+    output_rb.set_selection(rb.shared_selection());
+    records_processed_ += rb.num_selected_rows();
     output_rb.set_eos(rb.eos());
     output_rb.set_eow(rb.eow());
     return SendRowBatchToChildren(exec_state, output_rb);
   }
 
-  RowBatch output_rb(*output_descriptor_, remainder_records);
+  // With a selection vector, the physical rows are cut right after the last selected row that
+  // still fits in the limit.
+  int64_t num_physical_rows = remainder_records;
+  std::shared_ptr<std::vector<int64_t>> selection;
+  if (rb.has_selection()) {
+    selection = std::make_shared<std::vector<int64_t>>(
+        rb.selection().begin(), rb.selection().begin() + remainder_records);
+    num_physical_rows = selection->empty() ? 0 : selection->back() + 1;
+  }
+  RowBatch output_rb(*output_descriptor_, num_physical_rows);
   DCHECK_EQ(output_descriptor_->size(), plan_node_->selected_cols().size());
   for (int64_t input_col_idx : plan_node_->selected_cols()) {
     auto col = rb.ColumnAt(input_col_idx);
-    PL_RETURN_IF_ERROR(output_rb.AddColumn(col->Slice(0, remainder_records)));
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(col->Slice(0, num_physical_rows)));
+  }
+  if (selection != nullptr) {
+    output_rb.set_selection(std::move(selection));
   }
   output_rb.set_eow(true);
   output_rb.set_eos(true);
@@ -81,6 +81,37 @@ TEST_F(LimitNodeTest, single_batch) {
       .Close();
 }
 
+TEST_F(LimitNodeTest, selection_vector) {
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<LimitNode, plan::LimitOperator>(*plan_node_, output_rd,
+                                                                     {input_rd}, exec_state_.get());
+  // The limit counts selected rows, not physical rows.
+  RowBatchBuilder rb1(input_rd, 12, /*eow*/ false, /*eos*/ false);
+  rb1.AddColumn<types::Int64Value>({1, 2, 3, 4, 5, 6, 1, 2, 3, 4, 5, 6})
+      .AddColumn<types::Int64Value>({1, 3, 6, 9, 12, 15, 1, 3, 6, 9, 12, 15});
+  rb1.get().set_selection(
+      std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{0, 2, 4, 6, 8, 10}));
+  RowBatchBuilder rb2(input_rd, 12, /*eow*/ false, /*eos*/ false);
+  rb2.AddColumn<types::Int64Value>({1, 2, 3, 4, 5, 6, 1, 2, 3, 4, 5, 6})
+      .AddColumn<types::Int64Value>({1, 3, 6, 9, 12, 15, 1, 3, 6, 9, 12, 15});
+  rb2.get().set_selection(
+      std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1, 3, 5, 7, 9, 11}));
+
+  tester.ConsumeNext(rb1.get(), 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 6, false, false)
+                          .AddColumn<types::Int64Value>({1, 3, 5, 1, 3, 5})
+                          .AddColumn<types::Int64Value>({1, 6, 12, 1, 6, 12})
+                          .get())
+      .ConsumeNext(rb2.get(), 0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 4, true, true)
+                          .AddColumn<types::Int64Value>({2, 4, 6, 2})
+                          .AddColumn<types::Int64Value>({3, 9, 15, 3})
+                          .get())
+      .Close();
+}
+
 TEST_F(LimitNodeTest, single_empty_batch) {
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
   RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
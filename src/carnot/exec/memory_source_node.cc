@@ -18,6 +18,7 @@
 
 #include "src/carnot/exec/memory_source_node.h"
 
+#include <algorithm>
 #include <limits>
 #include <string>
 #include <vector>
@@ -27,6 +28,11 @@
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/common/base/base.h"
 
+DEFINE_bool(carnot_late_materialization,
+            gflags::BoolFromEnv("PL_CARNOT_LATE_MATERIALIZATION", true),
+            "Whether memory sources leave the string columns of hot table batches in the table "
+            "until an operator needs them, so that only the rows that pass filters get copied.");
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -52,6 +58,10 @@ Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
   DCHECK(table_ != nullptr);
 
   infinite_stream_ = plan_node_->infinite_stream();
+  if (infinite_stream_) {
+    refresh_interval_ = std::chrono::nanoseconds(plan_node_->refresh_interval_ns());
+    next_refresh_ = std::chrono::steady_clock::now() + refresh_interval_;
+  }
 
   if (table_ == nullptr) {
     return error::NotFound("Table '$0' not found", plan_node_->TableName());
@@ -73,11 +83,27 @@ Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
   }
   current_batch_ = table_->SliceIfPastStop(current_batch_, stop_);
 
+  if (FLAGS_carnot_late_materialization && !children().empty()) {
+    // String columns are the ones that are expensive to copy out of the table.
+    const auto& cols = plan_node_->Columns();
+    for (size_t i = 0; i < cols.size(); ++i) {
+      if (output_descriptor_->type(i) != types::DataType::STRING) {
+        continue;
+      }
+      auto children = this->children();
+      if (std::all_of(children.begin(), children.end(),
+                      [i](ExecNode* child) { return child->AcceptsDeferredColumn(i); })) {
+        deferred_cols_.push_back(cols[i]);
+      }
+    }
+  }
+
   return Status::OK();
 }
 
 Status MemorySourceNode::CloseImpl(ExecState*) {
   stats()->AddExtraInfo("infinite_stream", infinite_stream_ ? "true" : "false");
+  stats()->AddExtraInfo("deferred_columns", std::to_string(deferred_cols_.size()));
   return Status::OK();
 }
 
@@ -91,7 +117,11 @@ StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*
     stop_ = table_->End();
     auto next_batch = table_->NextBatch(current_batch_, stop_);
     if (!next_batch.IsValid()) {
-      return RowBatch::WithZeroRows(*output_descriptor_, /* eow */ false, /* eos */ false);
+      bool eow = RefreshDue();
+      if (eow) {
+        MarkRefreshed();
+      }
+      return RowBatch::WithZeroRows(*output_descriptor_, eow, /* eos */ false);
     }
     current_batch_ = next_batch;
     wait_for_valid_next_ = false;
@@ -102,9 +132,16 @@ StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*
                                   /* eos */ !infinite_stream_);
   }
 
-  PL_ASSIGN_OR_RETURN(
-      auto row_batch,
-      table_->GetRowBatchSlice(current_batch_, plan_node_->Columns(), exec_state->exec_mem_pool()));
+  std::unique_ptr<RowBatch> row_batch;
+  if (deferred_cols_.empty()) {
+    PL_ASSIGN_OR_RETURN(row_batch, table_->GetRowBatchSlice(current_batch_, plan_node_->Columns(),
+                                                            exec_state->exec_mem_pool()));
+  } else {
+    PL_ASSIGN_OR_RETURN(row_batch,
+                        table_->GetRowBatchSliceDeferred(current_batch_, plan_node_->Columns(),
+                                                         deferred_cols_,
+                                                         exec_state->exec_mem_pool()));
+  }
 
   rows_processed_ += row_batch->num_rows();
   bytes_processed_ += row_batch->NumBytes();
@@ -115,6 +152,11 @@ StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState*
     current_batch_ = next_batch;
   }
 
+  if (RefreshDue()) {
+    row_batch->set_eow(true);
+    MarkRefreshed();
+  }
+
   // If infinite stream is set, we don't send Eow or Eos. Infinite streams therefore never cause
   // HasBatchesRemaining to be false. Instead the outer loop that calls GenerateNext() is
   // responsible for managing whether we continue the stream or end it.
@@ -131,6 +173,21 @@ Status MemorySourceNode::GenerateNextImpl(ExecState* exec_state) {
   return Status::OK();
 }
 
+bool MemorySourceNode::RefreshDue() const {
+  if (!infinite_stream_ || refresh_interval_.count() <= 0) {
+    return false;
+  }
+  if (!caught_up_once_) {
+    return wait_for_valid_next_;
+  }
+  return std::chrono::steady_clock::now() >= next_refresh_;
+}
+
+void MemorySourceNode::MarkRefreshed() {
+  caught_up_once_ = true;
+  next_refresh_ = std::chrono::steady_clock::now() + refresh_interval_;
+}
+
 bool MemorySourceNode::InfiniteStreamNextBatchReady() {
   if (!wait_for_valid_next_) {
     return current_batch_.IsValid();
@@ -141,8 +198,9 @@ bool MemorySourceNode::InfiniteStreamNextBatchReady() {
 
 bool MemorySourceNode::NextBatchReady() {
   // Next batch is ready if we haven't seen an eow and if it's an infinite_stream that has batches
-  // to push.
-  return HasBatchesRemaining() && (!infinite_stream_ || InfiniteStreamNextBatchReady());
+  // to push or a window to end.
+  return HasBatchesRemaining() &&
+         (!infinite_stream_ || InfiniteStreamNextBatchReady() || RefreshDue());
 }
 
 }  // namespace exec
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -31,6 +32,8 @@
 #include "src/table_store/schema/row_batch.h"
 #include "src/table_store/table_store.h"
 
+DECLARE_bool(carnot_late_materialization);
+
 namespace px {
 namespace carnot {
 namespace exec {
@@ -55,15 +58,28 @@ class MemorySourceNode : public SourceNode {
  private:
   StatusOr<std::unique_ptr<RowBatch>> GetNextRowBatch(ExecState* exec_state);
   bool InfiniteStreamNextBatchReady();
+  // Whether the next batch of an infinite stream should end a window, so that windowed operators
+  // downstream push their results. This happens once the stream first catches up with the table
+  // and then every refresh interval.
+  bool RefreshDue() const;
+  void MarkRefreshed();
   // Whether this memory source will stream infinitely. Can be stopped by the
   // exec_state_->keep_running() call in exec_graph.
   bool infinite_stream_ = false;
   // An infinite stream will set this to true once its exceeded the current data in the table, and
   // then will keep checking for new data.
   bool wait_for_valid_next_ = false;
+  // Set when the plan asks an infinite stream to end a window every refresh interval.
+  std::chrono::nanoseconds refresh_interval_{0};
+  std::chrono::steady_clock::time_point next_refresh_;
+  bool caught_up_once_ = false;
   table_store::BatchSlice current_batch_;
   table_store::Table::StopPosition stop_;
 
+  // The table columns that are left deferred in the output batches, because every child accepts
+  // them that way (late materialization).
+  std::vector<int64_t> deferred_cols_;
+
   std::unique_ptr<plan::MemorySourceOperator> plan_node_;
   table_store::Table* table_ = nullptr;
 };
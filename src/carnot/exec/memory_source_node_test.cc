@@ -19,7 +19,9 @@
 #include "src/carnot/exec/memory_source_node.h"
 
 #include <arrow/memory_pool.h>
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -383,6 +385,36 @@ TEST_F(MemorySourceNodeTest, infinite_stream) {
   tester.Close();
 }
 
+TEST_F(MemorySourceNodeTest, infinite_stream_refresh) {
+  auto op_proto = planpb::testutils::CreateTestStreamingSource1PB();
+  op_proto.mutable_mem_source_op()->set_refresh_interval_ns(
+      std::chrono::nanoseconds(std::chrono::milliseconds(1)).count());
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 3, /*eow*/ false, /*eos*/ false)
+          .AddColumn<types::Time64NSValue>({1, 2, 3})
+          .get());
+  // The window ends as soon as the stream catches up with the table.
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 2, /*eow*/ true, /*eos*/ false)
+          .AddColumn<types::Time64NSValue>({5, 6})
+          .get());
+
+  // After that, a window ends every refresh interval, even without new data.
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  EXPECT_TRUE(tester.node()->NextBatchReady());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 0, /*eow*/ true, /*eos*/ false)
+          .AddColumn<types::Time64NSValue>({})
+          .get());
+  EXPECT_TRUE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+}
+
 TEST_F(MemorySourceNodeTest, table_compact_between_open_and_exec) {
   auto op_proto = planpb::testutils::CreateTestSourceRangePB();
   std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
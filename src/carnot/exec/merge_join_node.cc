@@ -0,0 +1,371 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/merge_join_node.h"
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include <absl/strings/str_join.h>
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/carnot/udf/udf_wrapper.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+namespace {
+
+int64_t TimeAt(const RowBatch& rb, int64_t col_idx, int64_t row) {
+  return types::GetValueFromArrowArray<types::TIME64NS>(rb.ColumnAt(col_idx).get(), row);
+}
+
+template <types::DataType DT>
+Status AppendDefaultValue(arrow::ArrayBuilder* output_builder) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  ValueType zeroval;
+  return table_store::schema::CopyValue<DT>(output_builder, udf::UnWrap(zeroval));
+}
+
+}  // namespace
+
+std::string MergeJoinNode::DebugStringImpl() {
+  return absl::Substitute("Exec::MergeJoinNode<$0>",
+                          absl::StrJoin(plan_node_->column_names(), ","));
+}
+
+int64_t MergeJoinNode::num_buffered_rows() const {
+  int64_t num_rows = 0;
+  for (const auto& input : inputs_) {
+    for (const auto& batch : input.batches) {
+      num_rows += batch.rb->num_rows();
+    }
+    if (!input.batches.empty()) {
+      num_rows -= input.next_row;
+    }
+  }
+  return num_rows;
+}
+
+Status MergeJoinNode::InitImpl(const plan::Operator& plan_node) {
+  CHECK(plan_node.op_type() == planpb::OperatorType::JOIN_OPERATOR);
+  if (input_descriptors_.size() != 2) {
+    return error::InvalidArgument("Join operator expects a two input relations, got $0",
+                                  input_descriptors_.size());
+  }
+  const auto* join_plan_node = static_cast<const plan::JoinOperator*>(&plan_node);
+  plan_node_ = std::make_unique<plan::JoinOperator>(*join_plan_node);
+  output_rows_per_batch_ =
+      plan_node_->rows_per_batch() == 0 ? kDefaultJoinRowBatchSize : plan_node_->rows_per_batch();
+
+  switch (plan_node_->type()) {
+    case planpb::JoinOperator::INNER:
+      left_outer_ = false;
+      break;
+    case planpb::JoinOperator::LEFT_OUTER:
+      left_outer_ = true;
+      break;
+    default:
+      return error::InvalidArgument("MergeJoinNode does not support join type $0",
+                                    static_cast<int>(plan_node_->type()));
+  }
+
+  // The merge key is the first condition on time columns, and it goes first in the key indices.
+  const auto& eq_conditions = plan_node_->equality_conditions();
+  int64_t merge_key = -1;
+  for (size_t i = 0; i < eq_conditions.size(); ++i) {
+    auto left_type = input_descriptors_[0].type(eq_conditions[i].left_column_index());
+    CHECK_EQ(left_type, input_descriptors_[1].type(eq_conditions[i].right_column_index()));
+    if (merge_key < 0 && left_type == types::TIME64NS) {
+      merge_key = i;
+      inputs_[0].key_indices.insert(inputs_[0].key_indices.begin(),
+                                    eq_conditions[i].left_column_index());
+      inputs_[1].key_indices.insert(inputs_[1].key_indices.begin(),
+                                    eq_conditions[i].right_column_index());
+      continue;
+    }
+    other_key_types_.push_back(left_type);
+    inputs_[0].key_indices.push_back(eq_conditions[i].left_column_index());
+    inputs_[1].key_indices.push_back(eq_conditions[i].right_column_index());
+  }
+  if (merge_key < 0) {
+    return error::InvalidArgument("MergeJoinNode requires an equality condition on time columns.");
+  }
+
+  for (const auto& output_col : plan_node_->output_columns()) {
+    output_cols_.emplace_back(output_col.parent_index(), output_col.column_index());
+  }
+  return Status::OK();
+}
+
+Status MergeJoinNode::InitializeColumnBuilders(ExecState* exec_state) {
+  for (size_t i = 0; i < output_descriptor_->size(); ++i) {
+    column_builders_[i] =
+        MakeArrowBuilder(output_descriptor_->type(i), exec_state->exec_mem_pool());
+    PL_RETURN_IF_ERROR(column_builders_[i]->Reserve(output_rows_per_batch_));
+  }
+  return Status::OK();
+}
+
+Status MergeJoinNode::PrepareImpl(ExecState* exec_state) {
+  buffer_reservation_.set_tracker(exec_state->memory_tracker());
+  column_builders_.resize(output_descriptor_->size());
+  return InitializeColumnBuilders(exec_state);
+}
+
+Status MergeJoinNode::OpenImpl(ExecState* /*exec_state*/) {
+  probe_key_ = std::make_unique<RowTuple>(&other_key_types_);
+  return Status::OK();
+}
+
+Status MergeJoinNode::CloseImpl(ExecState* /*exec_state*/) {
+  for (auto& input : inputs_) {
+    input.batches.clear();
+  }
+  for (auto& rows : output_rows_) {
+    rows.clear();
+  }
+  retired_batches_.clear();
+  group_index_.clear();
+  group_keys_.clear();
+  buffer_reservation_.Reset();
+  return Status::OK();
+}
+
+Status MergeJoinNode::BufferRowBatch(const RowBatch& rb, Input* input) {
+  input->eos = rb.eos();
+  if (rb.num_rows() == 0) {
+    return Status::OK();
+  }
+  auto time_col = input->key_indices[0];
+  int64_t prev_time = input->watermark;
+  for (int64_t row = 0; row < rb.num_rows(); ++row) {
+    int64_t time = TimeAt(rb, time_col, row);
+    if (time < prev_time) {
+      return error::InvalidArgument(
+          "MergeJoinNode expects inputs sorted by the join time column, got $0 after $1.", time,
+          prev_time);
+    }
+    prev_time = time;
+  }
+  input->watermark = prev_time;
+
+  int64_t bytes = rb.NumBytes();
+  input->batches.push_back({std::make_shared<RowBatch>(rb), bytes});
+  buffer_reservation_.Add(bytes);
+  return buffer_reservation_.CheckLimit();
+}
+
+bool MergeJoinNode::HasRows(const Input& input) const { return !input.batches.empty(); }
+
+int64_t MergeJoinNode::HeadTime(const Input& input) const {
+  return TimeAt(*input.batches.front().rb, input.key_indices[0], input.next_row);
+}
+
+void MergeJoinNode::TakeGroup(Input* input, int64_t time, std::vector<RowRef>* rows) {
+  rows->clear();
+  while (HasRows(*input) && HeadTime(*input) == time) {
+    auto& batch = input->batches.front();
+    rows->push_back({batch.rb.get(), input->next_row});
+    if (++input->next_row == batch.rb->num_rows()) {
+      retired_batches_.push_back(std::move(batch));
+      input->batches.pop_front();
+      input->next_row = 0;
+    }
+  }
+}
+
+void MergeJoinNode::ExtractOtherKeys(const Input& input, RowRef ref, RowTuple* rt) {
+  for (size_t i = 0; i < other_key_types_.size(); ++i) {
+    auto col = ref.rb->ColumnAt(input.key_indices[i + 1]).get();
+#define TYPE_CASE(_dt_) ExtractIntoRowTuple<_dt_>(rt, col, i, ref.row);
+    PL_SWITCH_FOREACH_DATATYPE(other_key_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+  }
+}
+
+Status MergeJoinNode::MergeBufferedRows(ExecState* exec_state) {
+  std::vector<RowRef> left;
+  std::vector<RowRef> right;
+  while (HasRows(inputs_[0]) || HasRows(inputs_[1])) {
+    int64_t time = std::numeric_limits<int64_t>::max();
+    for (const auto& input : inputs_) {
+      if (HasRows(input)) {
+        time = std::min(time, HeadTime(input));
+      }
+    }
+    // Wait until neither input can send more rows with this time.
+    if (!Complete(inputs_[0], time) || !Complete(inputs_[1], time)) {
+      break;
+    }
+    TakeGroup(&inputs_[0], time, &left);
+    TakeGroup(&inputs_[1], time, &right);
+    PL_RETURN_IF_ERROR(JoinGroups(exec_state, left, right));
+  }
+  return Status::OK();
+}
+
+Status MergeJoinNode::JoinGroups(ExecState* exec_state, const std::vector<RowRef>& left,
+                                 const std::vector<RowRef>& right) {
+  RowRef null_ref{nullptr, 0};
+  if (left.empty()) {
+    return Status::OK();
+  }
+  if (right.empty()) {
+    if (left_outer_) {
+      for (const auto& l : left) {
+        PL_RETURN_IF_ERROR(AddOutputRow(exec_state, l, null_ref));
+      }
+    }
+    return Status::OK();
+  }
+  if (other_key_types_.empty()) {
+    for (const auto& l : left) {
+      for (const auto& r : right) {
+        PL_RETURN_IF_ERROR(AddOutputRow(exec_state, l, r));
+      }
+    }
+    return Status::OK();
+  }
+
+  // Match the other keys by hashing the right rows of this time, which are few.
+  group_index_.clear();
+  while (group_keys_.size() < right.size()) {
+    group_keys_.push_back(std::make_unique<RowTuple>(&other_key_types_));
+  }
+  for (size_t i = 0; i < right.size(); ++i) {
+    auto rt = group_keys_[i].get();
+    rt->Reset();
+    ExtractOtherKeys(inputs_[1], right[i], rt);
+    group_index_[rt].push_back(i);
+  }
+  for (const auto& l : left) {
+    probe_key_->Reset();
+    ExtractOtherKeys(inputs_[0], l, probe_key_.get());
+    auto it = group_index_.find(probe_key_.get());
+    if (it == group_index_.end()) {
+      if (left_outer_) {
+        PL_RETURN_IF_ERROR(AddOutputRow(exec_state, l, null_ref));
+      }
+      continue;
+    }
+    for (auto right_idx : it->second) {
+      PL_RETURN_IF_ERROR(AddOutputRow(exec_state, l, right[right_idx]));
+    }
+  }
+  return Status::OK();
+}
+
+Status MergeJoinNode::AddOutputRow(ExecState* exec_state, RowRef left, RowRef right) {
+  output_rows_[0].push_back(left);
+  output_rows_[1].push_back(right);
+  if (static_cast<int64_t>(output_rows_[0].size()) + column_builders_[0]->length() >=
+      output_rows_per_batch_) {
+    PL_RETURN_IF_ERROR(AppendOutputRows());
+    PL_RETURN_IF_ERROR(NextOutputBatch(exec_state));
+  }
+  return Status::OK();
+}
+
+Status MergeJoinNode::AppendOutputRows() {
+  for (size_t i = 0; i < output_cols_.size(); ++i) {
+    const auto& [parent_index, input_col_idx] = output_cols_[i];
+    auto builder = column_builders_[i].get();
+    auto dt = output_descriptor_->type(i);
+    for (const auto& ref : output_rows_[parent_index]) {
+      if (ref.rb == nullptr) {
+#define TYPE_CASE(_dt_) PL_RETURN_IF_ERROR(AppendDefaultValue<_dt_>(builder))
+        PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
+#undef TYPE_CASE
+        continue;
+      }
+      auto input_col = ref.rb->ColumnAt(input_col_idx).get();
+#define TYPE_CASE(_dt_)                                    \
+  PL_RETURN_IF_ERROR(table_store::schema::CopyValue<_dt_>( \
+      builder, types::GetValueFromArrowArray<_dt_>(input_col, ref.row)))
+      PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
+#undef TYPE_CASE
+    }
+  }
+  for (auto& rows : output_rows_) {
+    rows.clear();
+  }
+  return Status::OK();
+}
+
+void MergeJoinNode::ReleaseRetiredBatches() {
+  for (const auto& batch : retired_batches_) {
+    buffer_reservation_.Subtract(batch.bytes);
+  }
+  retired_batches_.clear();
+}
+
+// Create a new output row batch from the column builders, and flush the pending row batch.
+// We hold on to a pending row batch because it is difficult to know a priori whether a given
+// output batch will be eos/eow.
+Status MergeJoinNode::NextOutputBatch(ExecState* exec_state) {
+  PL_ASSIGN_OR_RETURN(auto output_batch, RowBatch::FromColumnBuilders(*output_descriptor_, false,
+                                                                      false, &column_builders_));
+  if (pending_output_batch_ != nullptr) {
+    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, *pending_output_batch_));
+  }
+  pending_output_batch_.swap(output_batch);
+  return InitializeColumnBuilders(exec_state);
+}
+
+Status MergeJoinNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb,
+                                      size_t parent_index) {
+  DCHECK(!inputs_[parent_index].eos);
+  PL_RETURN_IF_ERROR(BufferRowBatch(rb, &inputs_[parent_index]));
+  PL_RETURN_IF_ERROR(MergeBufferedRows(exec_state));
+  PL_RETURN_IF_ERROR(AppendOutputRows());
+  // The groups being joined are done, so no row refers to the retired batches anymore.
+  ReleaseRetiredBatches();
+
+  if (!inputs_[0].eos || !inputs_[1].eos) {
+    return Status::OK();
+  }
+  if (column_builders_[0]->length()) {
+    PL_RETURN_IF_ERROR(NextOutputBatch(exec_state));
+  }
+  // Now send the last row batch and we know it is EOS/EOW.
+  if (pending_output_batch_ == nullptr) {
+    PL_ASSIGN_OR_RETURN(pending_output_batch_, RowBatch::WithZeroRows(*output_descriptor_,
+                                                                      /* eow */ true,
+                                                                      /* eos */ true));
+  } else {
+    pending_output_batch_->set_eos(true);
+    pending_output_batch_->set_eow(true);
+  }
+  return SendRowBatchToChildren(exec_state, *pending_output_batch_);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array/builder_base.h>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/carnot/exec/equijoin_node.h"
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/row_tuple.h"
+#include "src/carnot/plan/operators.h"
+#include "src/common/base/base.h"
+#include "src/common/base/status.h"
+#include "src/common/memory/memory.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * MergeJoinNode executes inner and left outer equijoins whose inputs are both sorted by a time key,
+ * such as the time_ columns of two tables read by memory sources. The merge key is the first
+ * equality condition on TIME64NS columns, and the other conditions are matched among the rows
+ * that share a merge key.
+ *
+ * Rather than building a hash table over one whole input, the node buffers the rows of both inputs
+ * until neither input can send any more rows with the smallest buffered time, and then joins and
+ * drops those rows. So the memory held is bounded by how far apart in time the two inputs are,
+ * and the output streams out sorted by the merge key.
+ */
+class MergeJoinNode : public ProcessingNode {
+ public:
+  MergeJoinNode() = default;
+  virtual ~MergeJoinNode() = default;
+
+  /**
+   * @return the number of input rows that are buffered until they can be joined.
+   */
+  int64_t num_buffered_rows() const;
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState* exec_state) override;
+  Status OpenImpl(ExecState* exec_state) override;
+  Status CloseImpl(ExecState* exec_state) override;
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  // A row of one of the inputs. Unmatched rows of a left outer join are paired with a null row.
+  struct RowRef {
+    const table_store::schema::RowBatch* rb;
+    int64_t row;
+  };
+
+  struct BufferedBatch {
+    std::shared_ptr<table_store::schema::RowBatch> rb;
+    // The bytes charged to the query for the batch.
+    int64_t bytes;
+  };
+
+  struct Input {
+    // Indices of the input columns for the keys, with the merge key first.
+    std::vector<int64_t> key_indices;
+    std::deque<BufferedBatch> batches;
+    // The next row of the front batch to join.
+    int64_t next_row = 0;
+    // Every row of the input with a time below the watermark has arrived.
+    int64_t watermark = std::numeric_limits<int64_t>::min();
+    bool eos = false;
+  };
+
+  Status BufferRowBatch(const table_store::schema::RowBatch& rb, Input* input);
+  // Joins the buffered rows of every time that both inputs are done with.
+  Status MergeBufferedRows(ExecState* exec_state);
+  bool HasRows(const Input& input) const;
+  int64_t HeadTime(const Input& input) const;
+  bool Complete(const Input& input, int64_t time) const {
+    return input.eos || time < input.watermark;
+  }
+  // Moves the rows of the input with the given time into rows.
+  void TakeGroup(Input* input, int64_t time, std::vector<RowRef>* rows);
+  Status JoinGroups(ExecState* exec_state, const std::vector<RowRef>& left,
+                    const std::vector<RowRef>& right);
+  Status AddOutputRow(ExecState* exec_state, RowRef left, RowRef right);
+  // Writes the queued output rows to the column builders.
+  Status AppendOutputRows();
+  // Frees the retired batches. The output rows can flush in the middle of a group, so this must
+  // only run once the groups that were taken are joined.
+  void ReleaseRetiredBatches();
+  Status InitializeColumnBuilders(ExecState* exec_state);
+  Status NextOutputBatch(ExecState* exec_state);
+  void ExtractOtherKeys(const Input& input, RowRef ref, RowTuple* rt);
+
+  std::unique_ptr<plan::JoinOperator> plan_node_;
+  bool left_outer_ = false;
+  int64_t output_rows_per_batch_ = 0;
+
+  Input inputs_[2];
+  // The input (0 for left, 1 for right) and the input column of each output column.
+  std::vector<std::pair<size_t, int64_t>> output_cols_;
+  // The types of the keys other than the merge key.
+  std::vector<types::DataType> other_key_types_;
+
+  // The output rows that are queued to be written to the column builders, by input.
+  std::vector<RowRef> output_rows_[2];
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> column_builders_;
+  // Handle on the most recent RowBatch (in case it's the final one).
+  std::unique_ptr<table_store::schema::RowBatch> pending_output_batch_;
+
+  // The batches whose rows were all taken, kept until the groups that refer to them are joined.
+  std::vector<BufferedBatch> retired_batches_;
+  // The keys of the right rows of the current merge key, which index into the right group.
+  std::vector<std::unique_ptr<RowTuple>> group_keys_;
+  AbslRowTupleHashMap<std::vector<int64_t>> group_index_;
+  std::unique_ptr<RowTuple> probe_key_;
+
+  // The bytes of the buffered input batches, charged to the query.
+  MemoryReservation buffer_reservation_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/strings/substitute.h>
+#include <benchmark/benchmark.h>
+#include <google/protobuf/text_format.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/equijoin_node.h"
+#include "src/carnot/exec/merge_join_node.h"
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/carnot/planpb/test_proto.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/types.h"
+
+using px::carnot::exec::EquijoinNode;
+using px::carnot::exec::MergeJoinNode;
+using px::carnot::exec::RowBatchBuilder;
+using px::table_store::schema::RowBatch;
+using px::table_store::schema::RowDescriptor;
+using px::types::DataType;
+
+namespace {
+
+// Joins [time_, upid, value] with [time_, upid, value] on time_ and upid.
+constexpr char kJoinPlan[] = R"(
+  type: INNER
+  equality_conditions {
+    left_column_index: 0
+    right_column_index: 0
+  }
+  equality_conditions {
+    left_column_index: 1
+    right_column_index: 1
+  }
+  output_columns: {
+    parent_index: 0
+    column_index: 0
+  }
+  output_columns: {
+    parent_index: 0
+    column_index: 2
+  }
+  output_columns: {
+    parent_index: 1
+    column_index: 2
+  }
+  column_names: "time_"
+  column_names: "left_value"
+  column_names: "right_value"
+  sort_merge: true
+)";
+
+// Makes batches of rows sorted by time, with num_upids rows (one per upid) at each time.
+std::vector<RowBatch> MakeSortedBatches(const RowDescriptor& rd, int64_t num_batches,
+                                        int64_t rows_per_batch, int64_t num_upids) {
+  std::vector<RowBatch> batches;
+  int64_t row = 0;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    std::vector<px::types::Time64NSValue> times;
+    std::vector<px::types::Int64Value> upids;
+    std::vector<px::types::Int64Value> values;
+    for (int64_t j = 0; j < rows_per_batch; ++j, ++row) {
+      times.emplace_back(row / num_upids);
+      upids.emplace_back(row % num_upids);
+      values.emplace_back(row);
+    }
+    bool eos = i == num_batches - 1;
+    batches.push_back(RowBatchBuilder(rd, rows_per_batch, eos, eos)
+                          .AddColumn<px::types::Time64NSValue>(times)
+                          .AddColumn<px::types::Int64Value>(upids)
+                          .AddColumn<px::types::Int64Value>(values)
+                          .get());
+  }
+  return batches;
+}
+
+}  // namespace
+
+// Joins two time-aligned inputs whose batches arrive interleaved, as from two memory sources.
+template <typename TJoinNode>
+// NOLINTNEXTLINE : runtime/references.
+void BM_TimeAlignedJoin(benchmark::State& state) {
+  int64_t num_batches = state.range(0);
+  int64_t rows_per_batch = 1024;
+  int64_t num_upids = 16;
+
+  auto func_registry = std::make_unique<px::carnot::udf::Registry>("test_registry");
+  auto table_store = std::make_shared<px::table_store::TableStore>();
+  auto exec_state = std::make_unique<px::carnot::exec::ExecState>(
+      func_registry.get(), table_store, px::carnot::exec::MockResultSinkStubGenerator,
+      sole::uuid4(), nullptr);
+
+  px::carnot::planpb::Operator op_pb;
+  CHECK(google::protobuf::TextFormat::MergeFromString(
+      absl::Substitute(px::carnot::planpb::testutils::kOperatorProtoTmpl, "JOIN_OPERATOR",
+                       "join_op", kJoinPlan),
+      &op_pb));
+  auto plan_node = px::carnot::plan::JoinOperator::FromProto(op_pb, 1);
+
+  RowDescriptor input_rd({DataType::TIME64NS, DataType::INT64, DataType::INT64});
+  RowDescriptor output_rd({DataType::TIME64NS, DataType::INT64, DataType::INT64});
+  auto left = MakeSortedBatches(input_rd, num_batches, rows_per_batch, num_upids);
+  auto right = MakeSortedBatches(input_rd, num_batches, rows_per_batch, num_upids);
+
+  for (auto _ : state) {
+    TJoinNode node;
+    PL_CHECK_OK(node.Init(*plan_node, output_rd, {input_rd, input_rd}));
+    PL_CHECK_OK(node.Prepare(exec_state.get()));
+    PL_CHECK_OK(node.Open(exec_state.get()));
+    for (int64_t i = 0; i < num_batches; ++i) {
+      PL_CHECK_OK(node.ConsumeNext(exec_state.get(), left[i], 0));
+      PL_CHECK_OK(node.ConsumeNext(exec_state.get(), right[i], 1));
+    }
+    PL_CHECK_OK(node.Close(exec_state.get()));
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * num_batches * rows_per_batch);
+}
+
+BENCHMARK_TEMPLATE(BM_TimeAlignedJoin, EquijoinNode)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TimeAlignedJoin, MergeJoinNode)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/merge_join_node.h"
+
+#include <absl/strings/substitute.h>
+#include <gmock/gmock.h>
+#include <google/protobuf/text_format.h>
+#include <gtest/gtest.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/carnot/planpb/test_proto.h"
+#include "src/carnot/udf/registry.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+class MergeJoinNodeTest : public ::testing::Test {
+ public:
+  MergeJoinNodeTest() {
+    func_registry_ = std::make_unique<udf::Registry>("test_registry");
+    auto table_store = std::make_shared<table_store::TableStore>();
+    exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
+                                              MockResultSinkStubGenerator, sole::uuid4(), nullptr);
+  }
+
+ protected:
+  std::unique_ptr<plan::Operator> PlanNode(const std::string& join_type) {
+    // Joins [time_, upid, left_value] with [time_, upid, right_value] on time_ and upid, and
+    // outputs [time_, left_value, right_value].
+    const char* proto = R"(
+      type: $0
+      equality_conditions {
+        left_column_index: 1
+        right_column_index: 1
+      }
+      equality_conditions {
+        left_column_index: 0
+        right_column_index: 0
+      }
+      output_columns: {
+        parent_index: 0
+        column_index: 0
+      }
+      output_columns: {
+        parent_index: 0
+        column_index: 2
+      }
+      output_columns: {
+        parent_index: 1
+        column_index: 2
+      }
+      column_names: "time_"
+      column_names: "left_value"
+      column_names: "right_value"
+      rows_per_batch: 10
+      sort_merge: true
+    )";
+    planpb::Operator op_pb;
+    EXPECT_TRUE(google::protobuf::TextFormat::MergeFromString(
+        absl::Substitute(planpb::testutils::kOperatorProtoTmpl, "JOIN_OPERATOR", "join_op",
+                         absl::Substitute(proto, join_type)),
+        &op_pb));
+    return plan::JoinOperator::FromProto(op_pb, 1);
+  }
+
+  RowDescriptor left_rd_{{types::TIME64NS, types::INT64, types::FLOAT64}};
+  RowDescriptor right_rd_{{types::TIME64NS, types::INT64, types::INT64}};
+  RowDescriptor output_rd_{{types::TIME64NS, types::FLOAT64, types::INT64}};
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+};
+
+TEST_F(MergeJoinNodeTest, inner_join) {
+  auto plan_node = PlanNode("INNER");
+  auto tester = exec::ExecNodeTester<MergeJoinNode, plan::JoinOperator>(
+      *plan_node, output_rd_, {left_rd_, right_rd_}, exec_state_.get());
+
+  // Nothing can be joined before the right input sends rows.
+  tester.ConsumeNext(RowBatchBuilder(left_rd_, 3, false, false)
+                         .AddColumn<types::Time64NSValue>({10, 10, 20})
+                         .AddColumn<types::Int64Value>({1, 2, 1})
+                         .AddColumn<types::Float64Value>({1.0, 2.0, 3.0})
+                         .get(),
+                     0, 0);
+  EXPECT_EQ(3, tester.node()->num_buffered_rows());
+
+  // Time 10 is complete on both sides, but the right input may still send rows at time 30.
+  tester.ConsumeNext(RowBatchBuilder(right_rd_, 3, false, false)
+                         .AddColumn<types::Time64NSValue>({10, 10, 30})
+                         .AddColumn<types::Int64Value>({2, 1, 1})
+                         .AddColumn<types::Int64Value>({100, 200, 300})
+                         .get(),
+                     1, 0);
+  EXPECT_EQ(2, tester.node()->num_buffered_rows());
+
+  tester.ConsumeNext(RowBatchBuilder(left_rd_, 2, true, true)
+                         .AddColumn<types::Time64NSValue>({30, 40})
+                         .AddColumn<types::Int64Value>({1, 1})
+                         .AddColumn<types::Float64Value>({4.0, 5.0})
+                         .get(),
+                     0, 0);
+  EXPECT_EQ(3, tester.node()->num_buffered_rows());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(right_rd_, 1, true, true)
+                       .AddColumn<types::Time64NSValue>({40})
+                       .AddColumn<types::Int64Value>({3})
+                       .AddColumn<types::Int64Value>({400})
+                       .get(),
+                   1, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 3, true, true)
+                          .AddColumn<types::Time64NSValue>({10, 10, 30})
+                          .AddColumn<types::Float64Value>({1.0, 2.0, 4.0})
+                          .AddColumn<types::Int64Value>({200, 100, 300})
+                          .get(),
+                      true)
+      .Close();
+  EXPECT_EQ(0, tester.node()->num_buffered_rows());
+}
+
+TEST_F(MergeJoinNodeTest, left_outer_join) {
+  auto plan_node = PlanNode("LEFT_OUTER");
+  auto tester = exec::ExecNodeTester<MergeJoinNode, plan::JoinOperator>(
+      *plan_node, output_rd_, {left_rd_, right_rd_}, exec_state_.get());
+
+  tester
+      .ConsumeNext(RowBatchBuilder(right_rd_, 3, false, false)
+                       .AddColumn<types::Time64NSValue>({10, 10, 30})
+                       .AddColumn<types::Int64Value>({2, 1, 1})
+                       .AddColumn<types::Int64Value>({100, 200, 300})
+                       .get(),
+                   1, 0)
+      .ConsumeNext(RowBatchBuilder(left_rd_, 3, false, false)
+                       .AddColumn<types::Time64NSValue>({10, 10, 20})
+                       .AddColumn<types::Int64Value>({1, 2, 1})
+                       .AddColumn<types::Float64Value>({1.0, 2.0, 3.0})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(right_rd_, 1, true, true)
+                       .AddColumn<types::Time64NSValue>({40})
+                       .AddColumn<types::Int64Value>({3})
+                       .AddColumn<types::Int64Value>({400})
+                       .get(),
+                   1, 0)
+      .ConsumeNext(RowBatchBuilder(left_rd_, 2, true, true)
+                       .AddColumn<types::Time64NSValue>({30, 40})
+                       .AddColumn<types::Int64Value>({1, 1})
+                       .AddColumn<types::Float64Value>({4.0, 5.0})
+                       .get(),
+                   0, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 5, true, true)
+                          .AddColumn<types::Time64NSValue>({10, 10, 20, 30, 40})
+                          .AddColumn<types::Float64Value>({1.0, 2.0, 3.0, 4.0, 5.0})
+                          .AddColumn<types::Int64Value>({200, 100, 0, 300, 0})
+                          .get(),
+                      true)
+      .Close();
+}
+
+TEST_F(MergeJoinNodeTest, group_larger_than_output_batch) {
+  auto plan_node = PlanNode("INNER");
+  auto tester = exec::ExecNodeTester<MergeJoinNode, plan::JoinOperator>(
+      *plan_node, output_rd_, {left_rd_, right_rd_}, exec_state_.get());
+
+  // The single group joins into 12 rows, which flushes an output batch of 10 rows while the
+  // rest of the group is still being joined from the input batches.
+  tester
+      .ConsumeNext(RowBatchBuilder(left_rd_, 4, true, true)
+                       .AddColumn<types::Time64NSValue>({10, 10, 10, 10})
+                       .AddColumn<types::Int64Value>({1, 1, 1, 1})
+                       .AddColumn<types::Float64Value>({1.0, 2.0, 3.0, 4.0})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(right_rd_, 3, true, true)
+                       .AddColumn<types::Time64NSValue>({10, 10, 10})
+                       .AddColumn<types::Int64Value>({1, 1, 1})
+                       .AddColumn<types::Int64Value>({100, 200, 300})
+                       .get(),
+                   1, 2)
+      .ExpectRowBatch(
+          RowBatchBuilder(output_rd_, 10, false, false)
+              .AddColumn<types::Time64NSValue>({10, 10, 10, 10, 10, 10, 10, 10, 10, 10})
+              .AddColumn<types::Float64Value>({1.0, 1.0, 1.0, 2.0, 2.0, 2.0, 3.0, 3.0, 3.0, 4.0})
+              .AddColumn<types::Int64Value>({100, 200, 300, 100, 200, 300, 100, 200, 300, 100})
+              .get(),
+          true)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 2, true, true)
+                          .AddColumn<types::Time64NSValue>({10, 10})
+                          .AddColumn<types::Float64Value>({4.0, 4.0})
+                          .AddColumn<types::Int64Value>({200, 300})
+                          .get(),
+                      true)
+      .Close();
+  EXPECT_EQ(0, tester.node()->num_buffered_rows());
+}
+
+TEST_F(MergeJoinNodeTest, unsorted_input) {
+  auto plan_node = PlanNode("INNER");
+  auto tester = exec::ExecNodeTester<MergeJoinNode, plan::JoinOperator>(
+      *plan_node, output_rd_, {left_rd_, right_rd_}, exec_state_.get());
+
+  auto rb = RowBatchBuilder(left_rd_, 2, false, false)
+                .AddColumn<types::Time64NSValue>({20, 10})
+                .AddColumn<types::Int64Value>({1, 1})
+                .AddColumn<types::Float64Value>({1.0, 2.0})
+                .get();
+  EXPECT_NOT_OK(tester.node()->ConsumeNext(exec_state_.get(), rb, 0));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
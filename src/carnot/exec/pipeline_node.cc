@@ -0,0 +1,248 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/pipeline_node.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/strings/str_join.h>
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/common/base/base.h"
+
+DEFINE_bool(carnot_fuse_map_filter, gflags::BoolFromEnv("PL_CARNOT_FUSE_MAP_FILTER", true),
+            "Whether chains of Map and Filter operators execute as a single fused exec node.");
+DEFINE_int64(carnot_pipeline_cache_budget_bytes,
+             gflags::Int64FromEnv("PL_CARNOT_PIPELINE_CACHE_BUDGET_BYTES", 512 * 1024),
+             "The number of bytes of column data that a fused Map/Filter pipeline tries to keep "
+             "resident while it processes a slice of a row batch. <= 0 disables slicing.");
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+// Slices never get smaller than this, so that per-slice overheads stay amortized.
+constexpr int64_t kMinPipelineSliceRows = 1024;
+
+std::string PipelineNode::DebugStringImpl() {
+  std::vector<std::string> stages;
+  for (const auto& stage : stages_) {
+    if (stage.map_op != nullptr) {
+      stages.push_back(absl::Substitute("Map<$0>", stage.map_evaluator != nullptr
+                                                       ? stage.map_evaluator->DebugString()
+                                                       : stage.map_op->DebugString()));
+    } else {
+      stages.push_back(absl::Substitute("Filter<$0>", stage.filter_op->DebugString()));
+    }
+  }
+  return absl::Substitute("Exec::PipelineNode<$0>", absl::StrJoin(stages, " -> "));
+}
+
+Status PipelineNode::InitImpl(const plan::Operator& plan_node) {
+  PL_RETURN_IF_ERROR(AppendStage(plan_node, *output_descriptor_));
+  for (const auto& stage : tail_) {
+    PL_RETURN_IF_ERROR(AppendStage(*stage.op, stage.output_descriptor));
+  }
+  tail_.clear();
+  return Status::OK();
+}
+
+Status PipelineNode::AppendStage(const plan::Operator& op, const RowDescriptor& output_descriptor) {
+  Stage stage{nullptr, nullptr, output_descriptor, nullptr, nullptr, {}};
+  switch (op.op_type()) {
+    case planpb::OperatorType::MAP_OPERATOR:
+      // copy the plan node to local object;
+      stage.map_op = std::make_unique<plan::MapOperator>(static_cast<const plan::MapOperator&>(op));
+      ++num_map_stages_;
+      break;
+    case planpb::OperatorType::FILTER_OPERATOR:
+      stage.filter_op =
+          std::make_unique<plan::FilterOperator>(static_cast<const plan::FilterOperator&>(op));
+      stage.predicate_cols = plan::ColumnIndices(*stage.filter_op->expression());
+      break;
+    default:
+      return error::InvalidArgument("PipelineNode only supports Map and Filter operators, got $0",
+                                    planpb::OperatorType_Name(op.op_type()));
+  }
+  stages_.push_back(std::move(stage));
+  *output_descriptor_ = output_descriptor;
+  return Status::OK();
+}
+
+Status PipelineNode::PrepareImpl(ExecState* exec_state) {
+  function_ctx_ = exec_state->CreateFunctionContext();
+  for (auto& stage : stages_) {
+    if (stage.map_op != nullptr) {
+      stage.map_evaluator =
+          ScalarExpressionEvaluator::Create(stage.map_op->expressions(),
+                                            ScalarExpressionEvaluatorType::kArrowNative,
+                                            function_ctx_.get());
+    } else {
+      stage.filter_evaluator = std::make_unique<VectorNativeScalarExpressionEvaluator>(
+          plan::ConstScalarExpressionVector{stage.filter_op->expression()}, function_ctx_.get());
+    }
+  }
+  return Status::OK();
+}
+
+Status PipelineNode::OpenImpl(ExecState* exec_state) {
+  for (auto& stage : stages_) {
+    if (stage.map_evaluator != nullptr) {
+      PL_RETURN_IF_ERROR(stage.map_evaluator->Open(exec_state));
+    } else {
+      PL_RETURN_IF_ERROR(stage.filter_evaluator->Open(exec_state));
+    }
+  }
+  return Status::OK();
+}
+
+Status PipelineNode::CloseImpl(ExecState* exec_state) {
+  stats()->AddExtraInfo("stages", DebugString());
+  for (auto& stage : stages_) {
+    if (stage.map_evaluator != nullptr) {
+      PL_RETURN_IF_ERROR(stage.map_evaluator->Close(exec_state));
+    } else if (stage.filter_evaluator != nullptr) {
+      PL_RETURN_IF_ERROR(stage.filter_evaluator->Close(exec_state));
+    }
+  }
+  return Status::OK();
+}
+
+bool PipelineNode::AcceptsDeferredColumn(int64_t col_idx) const {
+  // Follow the column through the leading filters. The first map gets a compacted batch.
+  for (const Stage& stage : stages_) {
+    if (stage.map_op != nullptr) {
+      return true;
+    }
+    const auto& predicate_cols = stage.predicate_cols;
+    if (std::find(predicate_cols.begin(), predicate_cols.end(), col_idx) != predicate_cols.end()) {
+      return false;
+    }
+    const auto& selected_cols = stage.filter_op->selected_cols();
+    auto it = std::find(selected_cols.begin(), selected_cols.end(), col_idx);
+    if (it == selected_cols.end()) {
+      return true;
+    }
+    col_idx = std::distance(selected_cols.begin(), it);
+  }
+  return true;
+}
+
+int64_t PipelineNode::SliceRows(int64_t bytes_per_row) const {
+  if (FLAGS_carnot_pipeline_cache_budget_bytes <= 0) {
+    return std::numeric_limits<int64_t>::max();
+  }
+  // Every map stage materializes its output columns for the slice, so the working set grows
+  // with the number of maps in the chain.
+  int64_t working_set_per_row = std::max<int64_t>(1, bytes_per_row * (1 + num_map_stages_));
+  return std::max(kMinPipelineSliceRows,
+                  FLAGS_carnot_pipeline_cache_budget_bytes / working_set_per_row);
+}
+
+Status PipelineNode::ProcessBatch(ExecState* exec_state, const RowBatch& input, bool eow, bool eos,
+                                  bool send_empty) {
+  // current carries the selection vector of the last filter evaluated so far.
+  RowBatch current = input;
+  for (Stage& stage : stages_) {
+    if (stage.map_op != nullptr) {
+      // Map expressions only run on the surviving rows: a filter may have dropped exactly the
+      // rows that the expression can't be evaluated on (e.g. a division by zero). Maps read dense
+      // columns, so deferred columns are fetched for the surviving rows here.
+      if (current.has_deferred_columns() || current.has_selection()) {
+        PL_ASSIGN_OR_RETURN(auto compacted, current.Compact(exec_state->exec_mem_pool()));
+        current = std::move(*compacted);
+      }
+      RowBatch output(stage.output_descriptor, current.num_rows());
+      PL_RETURN_IF_ERROR(stage.map_evaluator->Evaluate(exec_state, current, &output));
+      current = std::move(output);
+      continue;
+    }
+
+    // Like map expressions, predicates only run on the surviving rows, and read dense columns.
+    bool compact = current.has_selection();
+    for (int64_t col_idx : stage.predicate_cols) {
+      compact = compact || current.IsDeferred(col_idx);
+    }
+    if (compact) {
+      PL_ASSIGN_OR_RETURN(auto compacted, current.Compact(exec_state->exec_mem_pool()));
+      current = std::move(*compacted);
+    }
+    PL_ASSIGN_OR_RETURN(auto pred_col, stage.filter_evaluator->EvaluateSingleExpression(
+                                           exec_state, current, *stage.filter_op->expression()));
+    DCHECK_EQ(pred_col->data_type(), types::BOOLEAN) << "Predicate expression must be a boolean";
+    const auto& pred = *static_cast<types::BoolValueColumnWrapper*>(pred_col.get());
+    DCHECK_EQ(static_cast<size_t>(current.num_rows()), pred.Size());
+
+    auto selection = std::make_shared<std::vector<int64_t>>();
+    for (int64_t i = 0; i < current.num_rows(); ++i) {
+      if (pred[i].val) {
+        selection->push_back(i);
+      }
+    }
+
+    // Column selection only reorders the column pointers.
+    RowBatch projected(stage.output_descriptor, current.num_rows());
+    for (int64_t input_col_idx : stage.filter_op->selected_cols()) {
+      PL_RETURN_IF_ERROR(projected.AddColumnFrom(current, input_col_idx));
+    }
+    if (static_cast<int64_t>(selection->size()) < current.num_rows()) {
+      projected.set_selection(std::move(selection));
+    }
+    current = std::move(projected);
+  }
+
+  if (current.num_selected_rows() == 0 && !send_empty) {
+    return Status::OK();
+  }
+  current.set_eow(eow);
+  current.set_eos(eos);
+  // Children that need dense columns get a compacted copy.
+  return SendRowBatchToChildren(exec_state, current);
+}
+
+Status PipelineNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  int64_t num_rows = rb.num_rows();
+  int64_t slice_rows =
+      num_rows == 0 ? num_rows : SliceRows(rb.NumBytes() / std::max<int64_t>(1, num_rows));
+  if (num_rows <= slice_rows) {
+    return ProcessBatch(exec_state, rb, rb.eow(), rb.eos(), /*send_empty*/ true);
+  }
+
+  // Slices are zero-copy views of rb. Empty outputs are only sent for the last slice, which
+  // carries rb's eow/eos.
+  for (int64_t offset = 0; offset < num_rows; offset += slice_rows) {
+    int64_t length = std::min(slice_rows, num_rows - offset);
+    bool last = offset + length == num_rows;
+    PL_ASSIGN_OR_RETURN(auto slice, rb.Slice(offset, length));
+    PL_RETURN_IF_ERROR(ProcessBatch(exec_state, *slice, last && rb.eow(), last && rb.eos(),
+                                    /*send_empty*/ last));
+  }
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
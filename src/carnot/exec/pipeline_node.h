@@ -0,0 +1,119 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/expression_evaluator.h"
+#include "src/carnot/plan/operators.h"
+#include "src/carnot/udf/base.h"
+#include "src/common/base/base.h"
+#include "src/common/base/status.h"
+#include "src/table_store/table_store.h"
+
+DECLARE_bool(carnot_fuse_map_filter);
+DECLARE_int64(carnot_pipeline_cache_budget_bytes);
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * A Map or Filter operator that runs after the head operator of a PipelineNode.
+ */
+struct PipelineStage {
+  // Not owned; the node copies the operator during Init.
+  const plan::Operator* op;
+  table_store::schema::RowDescriptor output_descriptor;
+};
+
+/**
+ * PipelineNode executes a chain of Map and Filter operators as a single exec node.
+ *
+ * Filters do not copy their input. They set the batch's selection vector, and their column
+ * selection only reorders column pointers. The surviving rows are copied before the next map or
+ * filter, so that expressions never run on dropped rows, and when a child that needs dense
+ * columns receives the output. Deferred columns are materialized for the surviving rows before
+ * the first map, or before a filter that reads them.
+ *
+ * Large input batches are processed in slices sized so that the chain's working set stays within
+ * FLAGS_carnot_pipeline_cache_budget_bytes (roughly an L2 cache).
+ */
+class PipelineNode : public ProcessingNode {
+ public:
+  PipelineNode() = default;
+  explicit PipelineNode(std::vector<PipelineStage> tail) : tail_(std::move(tail)) {}
+  virtual ~PipelineNode() = default;
+
+  bool ConsumesSelectionVectors() const override { return true; }
+  // Deferred columns pass through the filters up to the first map, unless a filter reads them.
+  bool AcceptsDeferredColumn(int64_t col_idx) const override;
+
+  /**
+   * Appends an operator to the end of the chain. The node's output descriptor becomes the
+   * descriptor of the new stage. Must be called after Init and before Prepare.
+   */
+  Status AppendStage(const plan::Operator& op,
+                     const table_store::schema::RowDescriptor& output_descriptor);
+
+  size_t num_stages() const { return stages_.size(); }
+
+  /**
+   * Returns the number of rows processed at a time for an input batch that has the given number
+   * of bytes per row.
+   */
+  int64_t SliceRows(int64_t bytes_per_row) const;
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState* exec_state) override;
+  Status OpenImpl(ExecState* exec_state) override;
+  Status CloseImpl(ExecState* exec_state) override;
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  struct Stage {
+    std::unique_ptr<plan::MapOperator> map_op;
+    std::unique_ptr<plan::FilterOperator> filter_op;
+    table_store::schema::RowDescriptor output_descriptor;
+    std::unique_ptr<ScalarExpressionEvaluator> map_evaluator;
+    std::unique_ptr<VectorNativeScalarExpressionEvaluator> filter_evaluator;
+    // The input columns that the filter predicate reads.
+    std::vector<int64_t> predicate_cols;
+  };
+
+  Status ProcessBatch(ExecState* exec_state, const table_store::schema::RowBatch& input, bool eow,
+                      bool eos, bool send_empty);
+
+  std::vector<PipelineStage> tail_;
+  std::vector<Stage> stages_;
+  int64_t num_map_stages_ = 0;
+  std::unique_ptr<udf::FunctionContext> function_ctx_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
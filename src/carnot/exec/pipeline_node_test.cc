@@ -0,0 +1,294 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/pipeline_node.h"
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <google/protobuf/text_format.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/test_proto.h"
+#include "src/carnot/udf/registry.h"
+#include "src/carnot/udf/udf.h"
+#include "src/common/base/base.h"
+#include "src/common/base/test_utils.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+using udf::FunctionContext;
+
+class AddUDF : public udf::ScalarUDF {
+ public:
+  types::Int64Value Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    return v1.val + v2.val;
+  }
+};
+
+class EqUDF : public udf::ScalarUDF {
+ public:
+  types::BoolValue Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    return v1.val == v2.val;
+  }
+};
+
+class ModUDF : public udf::ScalarUDF {
+ public:
+  types::Int64Value Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    return v1.val % v2.val;
+  }
+};
+
+// The predicate mod(col1, col0) == 0, which can't be evaluated on the rows where col0 == 0.
+constexpr char kModIsZeroPredicate[] = R"(
+func {
+  name: "eq"
+  id: 0
+  args {
+    func {
+      name: "mod"
+      id: 2
+      args {
+        column {
+          node: 0
+          index: 1
+        }
+      }
+      args {
+        column {
+          node: 0
+          index: 0
+        }
+      }
+      args_data_types: INT64
+      args_data_types: INT64
+    }
+  }
+  args {
+    constant {
+      data_type: INT64,
+      int64_value: 0
+    }
+  }
+  args_data_types: INT64
+  args_data_types: INT64
+})";
+
+// Tests the pipeline filter(col0 == 1) -> map(col0 + col1).
+class PipelineNodeTest : public ::testing::Test {
+ public:
+  PipelineNodeTest() {
+    filter_op_ = plan::FilterOperator::FromProto(planpb::testutils::CreateTestFilterTwoCols(), 1);
+    auto map_pb = planpb::testutils::CreateTestMapAddTwoCols();
+    map_pb.mutable_map_op()->mutable_expressions(0)->mutable_func()->set_id(1);
+    map_op_ = plan::MapOperator::FromProto(map_pb, 2);
+
+    func_registry_ = std::make_unique<udf::Registry>("test_registry");
+    EXPECT_OK(func_registry_->Register<EqUDF>("eq"));
+    EXPECT_OK(func_registry_->Register<AddUDF>("add"));
+    EXPECT_OK(func_registry_->Register<ModUDF>("mod"));
+    auto table_store = std::make_shared<table_store::TableStore>();
+
+    exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
+                                              MockResultSinkStubGenerator, sole::uuid4(), nullptr);
+    EXPECT_OK(exec_state_->AddScalarUDF(
+        0, "eq", std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
+    EXPECT_OK(exec_state_->AddScalarUDF(
+        1, "add", std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
+    EXPECT_OK(exec_state_->AddScalarUDF(
+        2, "mod", std::vector<types::DataType>({types::DataType::INT64, types::DataType::INT64})));
+  }
+
+ protected:
+  RowDescriptor input_rd_{
+      {types::DataType::INT64, types::DataType::INT64, types::DataType::STRING}};
+  RowDescriptor output_rd_{{types::DataType::INT64}};
+  std::unique_ptr<plan::Operator> filter_op_;
+  std::unique_ptr<plan::Operator> map_op_;
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+};
+
+TEST_F(PipelineNodeTest, filter_then_map) {
+  auto tester = exec::ExecNodeTester<PipelineNode, plan::FilterOperator>(
+      *filter_op_, input_rd_, {input_rd_}, exec_state_.get(),
+      std::vector<PipelineStage>{{map_op_.get(), output_rd_}});
+  EXPECT_EQ(2, tester.node()->num_stages());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 1, 3, 4})
+                       .AddColumn<types::Int64Value>({1, 3, 6, 9})
+                       .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(
+          RowBatchBuilder(output_rd_, 2, false, false).AddColumn<types::Int64Value>({2, 4}).get())
+      .ConsumeNext(RowBatchBuilder(input_rd_, 3, true, true)
+                       .AddColumn<types::Int64Value>({1, 2, 3})
+                       .AddColumn<types::Int64Value>({1, 4, 6})
+                       .AddColumn<types::StringValue>({"Hello", "world", "now"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(
+          RowBatchBuilder(output_rd_, 1, true, true).AddColumn<types::Int64Value>({2}).get())
+      .Close();
+}
+
+TEST_F(PipelineNodeTest, map_skips_filtered_rows) {
+  // filter(col0 == 1) -> map(col1 % col0). The rows with col0 == 0 are dropped by the filter, so
+  // the modulo must never be evaluated on them.
+  auto map_pb = planpb::testutils::CreateTestMapAddTwoCols();
+  auto* func = map_pb.mutable_map_op()->mutable_expressions(0)->mutable_func();
+  func->set_name("mod");
+  func->set_id(2);
+  func->mutable_args(0)->mutable_column()->set_index(1);
+  func->mutable_args(1)->mutable_column()->set_index(0);
+  auto mod_op = plan::MapOperator::FromProto(map_pb, 2);
+
+  auto tester = exec::ExecNodeTester<PipelineNode, plan::FilterOperator>(
+      *filter_op_, input_rd_, {input_rd_}, exec_state_.get(),
+      std::vector<PipelineStage>{{mod_op.get(), output_rd_}});
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1, 0, 1, 0})
+                       .AddColumn<types::Int64Value>({5, 7, 9, 11})
+                       .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(
+          RowBatchBuilder(output_rd_, 2, true, true).AddColumn<types::Int64Value>({0, 0}).get())
+      .Close();
+}
+
+TEST_F(PipelineNodeTest, filter_skips_filtered_rows) {
+  // filter(col0 == 1) -> filter(col1 % col0 == 0). The second predicate must never be evaluated
+  // on the rows with col0 == 0 that the first filter dropped.
+  auto mod_filter_pb = planpb::testutils::CreateTestFilterTwoCols();
+  mod_filter_pb.mutable_filter_op()->clear_expression();
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(
+      kModIsZeroPredicate, mod_filter_pb.mutable_filter_op()->mutable_expression()));
+  auto mod_filter_op = plan::FilterOperator::FromProto(mod_filter_pb, 2);
+
+  auto tester = exec::ExecNodeTester<PipelineNode, plan::FilterOperator>(
+      *filter_op_, input_rd_, {input_rd_}, exec_state_.get(),
+      std::vector<PipelineStage>{{mod_filter_op.get(), input_rd_}});
+  EXPECT_EQ(2, tester.node()->num_stages());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 4, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({1, 0, 1, 0})
+                       .AddColumn<types::Int64Value>({5, 7, 9, 11})
+                       .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(input_rd_, 2, true, true)
+                          .AddColumn<types::Int64Value>({1, 1})
+                          .AddColumn<types::Int64Value>({5, 9})
+                          .AddColumn<types::StringValue>({"ABC", "HELLO"})
+                          .get())
+      .Close();
+}
+
+TEST_F(PipelineNodeTest, nothing_selected) {
+  auto tester = exec::ExecNodeTester<PipelineNode, plan::FilterOperator>(
+      *filter_op_, input_rd_, {input_rd_}, exec_state_.get(),
+      std::vector<PipelineStage>{{map_op_.get(), output_rd_}});
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, 2, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({2, 3})
+                       .AddColumn<types::Int64Value>({1, 3})
+                       .AddColumn<types::StringValue>({"ABC", "DEF"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(
+          RowBatchBuilder(output_rd_, 0, true, true).AddColumn<types::Int64Value>({}).get())
+      .Close();
+}
+
+TEST_F(PipelineNodeTest, slices_large_batches) {
+  // With a tiny budget every slice has the minimum number of rows (1024).
+  FLAGS_carnot_pipeline_cache_budget_bytes = 1;
+  auto tester = exec::ExecNodeTester<PipelineNode, plan::FilterOperator>(
+      *filter_op_, input_rd_, {input_rd_}, exec_state_.get(),
+      std::vector<PipelineStage>{{map_op_.get(), output_rd_}});
+
+  // Only the rows of the first slice pass the filter.
+  const int64_t num_rows = 2500;
+  std::vector<types::Int64Value> col0;
+  std::vector<types::Int64Value> col1;
+  std::vector<types::StringValue> col2;
+  std::vector<types::Int64Value> expected;
+  for (int64_t i = 0; i < num_rows; ++i) {
+    col0.emplace_back(i < 1024 ? 1 : 2);
+    col1.emplace_back(i);
+    col2.emplace_back("abc");
+    if (i < 1024) {
+      expected.emplace_back(1 + i);
+    }
+  }
+
+  // The empty middle slice is dropped; the empty last slice carries eow/eos.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_, num_rows, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>(col0)
+                       .AddColumn<types::Int64Value>(col1)
+                       .AddColumn<types::StringValue>(col2)
+                       .get(),
+                   0, /*child_called_times*/ 2)
+      .ExpectRowBatch(RowBatchBuilder(output_rd_, 1024, false, false)
+                          .AddColumn<types::Int64Value>(expected)
+                          .get())
+      .ExpectRowBatch(
+          RowBatchBuilder(output_rd_, 0, true, true).AddColumn<types::Int64Value>({}).get())
+      .Close();
+  FLAGS_carnot_pipeline_cache_budget_bytes = 512 * 1024;
+}
+
+TEST_F(PipelineNodeTest, slice_rows) {
+  PipelineNode node({{map_op_.get(), output_rd_}});
+  EXPECT_OK(node.Init(*filter_op_, input_rd_, {input_rd_}));
+
+  FLAGS_carnot_pipeline_cache_budget_bytes = 512 * 1024;
+  // One map stage doubles the per-row working set.
+  EXPECT_EQ(512 * 1024 / 32, node.SliceRows(16));
+  EXPECT_EQ(1024, node.SliceRows(1024 * 1024));
+
+  FLAGS_carnot_pipeline_cache_budget_bytes = 0;
+  EXPECT_EQ(std::numeric_limits<int64_t>::max(), node.SliceRows(16));
+  FLAGS_carnot_pipeline_cache_budget_bytes = 512 * 1024;
+}
+
+TEST_F(PipelineNodeTest, rejects_other_operators) {
+  PipelineNode node;
+  EXPECT_OK(node.Init(*filter_op_, input_rd_, {input_rd_}));
+  auto limit_op = plan::LimitOperator::FromProto(planpb::testutils::CreateTestLimit1PB(), 3);
+  EXPECT_NOT_OK(node.AppendStage(*limit_op, input_rd_));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/query_memory_pool.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+QueryMemoryPoolPtr QueryMemoryPool::Create(std::string_view label, int64_t limit_bytes,
+                                           std::shared_ptr<MemoryTracker> agent_tracker,
+                                           arrow::MemoryPool* pool) {
+  return QueryMemoryPoolPtr(
+      new QueryMemoryPool(label, limit_bytes, std::move(agent_tracker), pool));
+}
+
+void QueryMemoryPool::Unref() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+arrow::Status QueryMemoryPool::OutOfMemory(int64_t size) const {
+  return arrow::Status::OutOfMemory(absl::Substitute(
+      "Allocating $0 bytes would exceed the memory limit of query $1 or of its agent.", size,
+      tracker_.label()));
+}
+
+arrow::Status QueryMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (!tracker_.TryConsume(size)) {
+    return OutOfMemory(size);
+  }
+  arrow::Status s = pool_->Allocate(size, out);
+  if (!s.ok()) {
+    tracker_.Release(size);
+    return s;
+  }
+  refs_.fetch_add(1, std::memory_order_relaxed);
+  return s;
+}
+
+arrow::Status QueryMemoryPool::Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  int64_t delta = new_size - old_size;
+  if (!tracker_.TryConsume(delta)) {
+    return OutOfMemory(delta);
+  }
+  arrow::Status s = pool_->Reallocate(old_size, new_size, ptr);
+  if (!s.ok()) {
+    tracker_.Release(delta);
+  }
+  return s;
+}
+
+void QueryMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  pool_->Free(buffer, size);
+  tracker_.Release(size);
+  Unref();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
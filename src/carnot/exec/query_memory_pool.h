@@ -0,0 +1,92 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "src/common/base/base.h"
+#include "src/common/memory/memory.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * QueryMemoryPool is the arrow::MemoryPool of a single query. It charges every allocation to the
+ * query's MemoryTracker, which in turn charges the agent's, and fails allocations that would take
+ * either of them over their limit.
+ *
+ * Arrays allocated by a query can outlive it, for example when a memory sink writes them to a
+ * table. So the pool is not deleted by its owner, which only drops its reference with
+ * QueryMemoryPoolPtr; the pool deletes itself once the last of its allocations is freed.
+ */
+class QueryMemoryPool final : public arrow::MemoryPool {
+ public:
+  struct Deleter {
+    void operator()(QueryMemoryPool* pool) const { pool->Unref(); }
+  };
+  using QueryMemoryPoolPtr = std::unique_ptr<QueryMemoryPool, Deleter>;
+
+  /**
+   * Creates a pool whose tracker has the given limit (MemoryTracker::kNoLimit for none), and
+   * charges the agent tracker, if provided.
+   */
+  static QueryMemoryPoolPtr Create(std::string_view label, int64_t limit_bytes,
+                                   std::shared_ptr<MemoryTracker> agent_tracker = nullptr,
+                                   arrow::MemoryPool* pool = arrow::default_memory_pool());
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  int64_t bytes_allocated() const override { return tracker_.consumed_bytes(); }
+  int64_t max_memory() const override { return tracker_.peak_consumed_bytes(); }
+  std::string backend_name() const override { return pool_->backend_name(); }
+
+  MemoryTracker* tracker() { return &tracker_; }
+
+ private:
+  QueryMemoryPool(std::string_view label, int64_t limit_bytes,
+                  std::shared_ptr<MemoryTracker> agent_tracker, arrow::MemoryPool* pool)
+      : agent_tracker_(std::move(agent_tracker)),
+        tracker_(label, limit_bytes, agent_tracker_.get()),
+        pool_(pool) {}
+  ~QueryMemoryPool() override = default;
+
+  arrow::Status OutOfMemory(int64_t size) const;
+  void Unref();
+
+  // Keeps the agent tracker alive for as long as this pool charges it.
+  std::shared_ptr<MemoryTracker> agent_tracker_;
+  MemoryTracker tracker_;
+  arrow::MemoryPool* pool_;
+
+  // One reference for the owner, plus one for each live allocation.
+  std::atomic<int64_t> refs_ = 1;
+};
+
+using QueryMemoryPoolPtr = QueryMemoryPool::QueryMemoryPoolPtr;
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
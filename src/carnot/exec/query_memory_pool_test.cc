@@ -0,0 +1,88 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/query_memory_pool.h"
+
+#include <arrow/builder.h>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+TEST(QueryMemoryPoolTest, ChargesAllocationsToTrackers) {
+  auto agent_tracker = std::make_shared<MemoryTracker>("agent");
+  QueryMemoryPoolPtr pool = QueryMemoryPool::Create("query", 1024, agent_tracker);
+
+  uint8_t* buffer = nullptr;
+  ASSERT_TRUE(pool->Allocate(512, &buffer).ok());
+  EXPECT_EQ(pool->bytes_allocated(), 512);
+  EXPECT_EQ(agent_tracker->consumed_bytes(), 512);
+
+  ASSERT_TRUE(pool->Reallocate(512, 768, &buffer).ok());
+  EXPECT_EQ(pool->bytes_allocated(), 768);
+
+  // Exceeds the limit of the query.
+  uint8_t* other_buffer = nullptr;
+  EXPECT_FALSE(pool->Allocate(512, &other_buffer).ok());
+  EXPECT_FALSE(pool->Reallocate(768, 2048, &buffer).ok());
+  EXPECT_EQ(pool->bytes_allocated(), 768);
+
+  pool->Free(buffer, 768);
+  EXPECT_EQ(pool->bytes_allocated(), 0);
+  EXPECT_EQ(pool->max_memory(), 768);
+  EXPECT_EQ(agent_tracker->consumed_bytes(), 0);
+}
+
+TEST(QueryMemoryPoolTest, EnforcesAgentLimit) {
+  auto agent_tracker = std::make_shared<MemoryTracker>("agent", 1024);
+  QueryMemoryPoolPtr pool1 = QueryMemoryPool::Create("query1", 1024, agent_tracker);
+  QueryMemoryPoolPtr pool2 = QueryMemoryPool::Create("query2", 1024, agent_tracker);
+
+  uint8_t* buffer1 = nullptr;
+  uint8_t* buffer2 = nullptr;
+  ASSERT_TRUE(pool1->Allocate(768, &buffer1).ok());
+  EXPECT_FALSE(pool2->Allocate(768, &buffer2).ok());
+  ASSERT_TRUE(pool2->Allocate(256, &buffer2).ok());
+
+  pool1->Free(buffer1, 768);
+  pool2->Free(buffer2, 256);
+  EXPECT_EQ(agent_tracker->consumed_bytes(), 0);
+}
+
+// Arrays allocated by a query can outlive it, so the pool must stay alive until they are freed.
+TEST(QueryMemoryPoolTest, OutlivesOwnerWhileAllocated) {
+  auto agent_tracker = std::make_shared<MemoryTracker>("agent");
+  std::shared_ptr<arrow::Array> array;
+  {
+    QueryMemoryPoolPtr pool =
+        QueryMemoryPool::Create("query", MemoryTracker::kNoLimit, agent_tracker);
+    arrow::Int64Builder builder(pool.get());
+    ASSERT_TRUE(builder.Append(1).ok());
+    ASSERT_TRUE(builder.Finish(&array).ok());
+  }
+  EXPECT_LT(0, agent_tracker->consumed_bytes());
+
+  array.reset();
+  EXPECT_EQ(agent_tracker->consumed_bytes(), 0);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
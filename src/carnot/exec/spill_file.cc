@@ -0,0 +1,253 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/spill_file.h"
+
+#include <arrow/array.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+
+#include <absl/strings/substitute.h>
+#include <sole.hpp>
+
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+
+DEFINE_string(carnot_spill_dir, gflags::StringFromEnv("PL_CARNOT_SPILL_DIR", ""),
+              "The directory where joins and aggregates write the state that does not fit in the "
+              "memory limit of their query. Empty disables spilling.");
+DEFINE_double(carnot_spill_memory_fraction,
+              gflags::DoubleFromEnv("PL_CARNOT_SPILL_MEMORY_FRACTION", 0.75),
+              "Joins and aggregates start spilling to --carnot_spill_dir once their query, or the "
+              "agent, uses more than this fraction of its memory limit.");
+DEFINE_int32(carnot_spill_partitions, gflags::Int32FromEnv("PL_CARNOT_SPILL_PARTITIONS", 16),
+             "The number of partitions that a spilling join or aggregate splits its input into.");
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+namespace {
+
+// The IPC format does not know about the UINT128 arrays of our arrow fork, so they are stored as
+// fixed size binary arrays, which have the same layout.
+constexpr int32_t kUInt128Bytes = 16;
+
+std::shared_ptr<arrow::DataType> SpillArrowType(types::DataType type) {
+  if (type == types::DataType::UINT128) {
+    return arrow::fixed_size_binary(kUInt128Bytes);
+  }
+  return types::DataTypeToArrowType(type);
+}
+
+std::shared_ptr<arrow::Array> WithArrowType(const std::shared_ptr<arrow::Array>& arr,
+                                            std::shared_ptr<arrow::DataType> type) {
+  auto data = arr->data()->Copy();
+  data->type = std::move(type);
+  return arrow::MakeArray(data);
+}
+
+template <types::DataType DT>
+Status AppendRows(arrow::ArrayBuilder* builder, const arrow::Array* arr,
+                  const std::vector<int64_t>& rows) {
+  PL_RETURN_IF_ERROR(builder->Reserve(rows.size()));
+  for (int64_t row_idx : rows) {
+    PL_RETURN_IF_ERROR(table_store::schema::CopyValue<DT>(
+        builder, types::GetValueFromArrowArray<DT>(arr, row_idx)));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+bool ShouldSpill(const MemoryReservation& reservation) {
+  return !FLAGS_carnot_spill_dir.empty() &&
+         reservation.IsNearLimit(FLAGS_carnot_spill_memory_fraction);
+}
+
+SpillFile::SpillFile(const std::filesystem::path& path, const RowDescriptor& desc,
+                     arrow::MemoryPool* mem_pool)
+    : path_(path), desc_(desc), mem_pool_(mem_pool) {
+  std::vector<std::shared_ptr<arrow::Field>> fields;
+  for (size_t i = 0; i < desc_.size(); ++i) {
+    fields.push_back(arrow::field(absl::StrCat("col_", i), SpillArrowType(desc_.type(i))));
+  }
+  schema_ = arrow::schema(fields);
+}
+
+StatusOr<std::unique_ptr<SpillFile>> SpillFile::Create(const std::filesystem::path& path,
+                                                       const RowDescriptor& desc,
+                                                       arrow::MemoryPool* mem_pool) {
+  std::unique_ptr<SpillFile> file(new SpillFile(path, desc, mem_pool));
+  PL_RETURN_IF_ERROR(arrow::io::FileOutputStream::Open(path.string(), &file->output_));
+  PL_RETURN_IF_ERROR(arrow::ipc::RecordBatchStreamWriter::Open(file->output_.get(), file->schema_,
+                                                               &file->writer_));
+  return file;
+}
+
+SpillFile::~SpillFile() {
+  if (writer_ != nullptr) {
+    PL_UNUSED(writer_->Close());
+    PL_UNUSED(output_->Close());
+  }
+  std::error_code ec;
+  std::filesystem::remove(path_, ec);
+  LOG_IF(WARNING, ec) << absl::Substitute("Failed to remove spill file $0: $1", path_.string(),
+                                          ec.message());
+}
+
+Status SpillFile::Write(const RowBatch& rb) {
+  if (writer_ == nullptr) {
+    return error::FailedPrecondition("Spill file $0 is closed for writing.", path_.string());
+  }
+  std::vector<std::shared_ptr<arrow::Array>> columns = rb.columns();
+  for (size_t i = 0; i < columns.size(); ++i) {
+    if (desc_.type(i) == types::DataType::UINT128) {
+      columns[i] = WithArrowType(columns[i], schema_->field(i)->type());
+    }
+  }
+  auto record_batch = arrow::RecordBatch::Make(schema_, rb.num_rows(), columns);
+  PL_RETURN_IF_ERROR(writer_->WriteRecordBatch(*record_batch));
+  num_rows_ += rb.num_rows();
+  return Status::OK();
+}
+
+Status SpillFile::FinishWriting() {
+  if (writer_ == nullptr) {
+    return Status::OK();
+  }
+  PL_RETURN_IF_ERROR(writer_->Close());
+  PL_RETURN_IF_ERROR(output_->Close());
+  writer_.reset();
+  output_.reset();
+  return Status::OK();
+}
+
+Status SpillFile::Read(const std::function<Status(const RowBatch&)>& fn) {
+  if (writer_ != nullptr) {
+    return error::FailedPrecondition("Spill file $0 is still open for writing.", path_.string());
+  }
+  std::shared_ptr<arrow::io::ReadableFile> input;
+  PL_RETURN_IF_ERROR(arrow::io::ReadableFile::Open(path_.string(), mem_pool_, &input));
+  std::shared_ptr<arrow::RecordBatchReader> reader;
+  PL_RETURN_IF_ERROR(arrow::ipc::RecordBatchStreamReader::Open(input.get(), &reader));
+
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    PL_RETURN_IF_ERROR(reader->ReadNext(&record_batch));
+    if (record_batch == nullptr) {
+      break;
+    }
+    RowBatch rb(desc_, record_batch->num_rows());
+    for (int i = 0; i < record_batch->num_columns(); ++i) {
+      auto col = record_batch->column(i);
+      if (desc_.type(i) == types::DataType::UINT128) {
+        col = WithArrowType(col, types::DataTypeToArrowType(types::DataType::UINT128));
+      }
+      PL_RETURN_IF_ERROR(rb.AddColumn(col));
+    }
+    PL_RETURN_IF_ERROR(fn(rb));
+  }
+  PL_RETURN_IF_ERROR(input->Close());
+  return Status::OK();
+}
+
+StatusOr<std::unique_ptr<SpillPartitions>> SpillPartitions::Create(std::string_view label,
+                                                                   const RowDescriptor& desc,
+                                                                   arrow::MemoryPool* mem_pool,
+                                                                   size_t num_partitions) {
+  if (FLAGS_carnot_spill_dir.empty()) {
+    return error::FailedPrecondition("Spilling is disabled, --carnot_spill_dir is not set.");
+  }
+  if (num_partitions == 0) {
+    return error::InvalidArgument("Cannot spill to zero partitions.");
+  }
+  std::unique_ptr<SpillPartitions> partitions(new SpillPartitions(desc, mem_pool));
+  // The ID keeps the files of concurrent instances of the same operator apart.
+  std::string id = sole::uuid4().str();
+  for (size_t i = 0; i < num_partitions; ++i) {
+    auto path = std::filesystem::path(FLAGS_carnot_spill_dir) /
+                absl::Substitute("$0_$1_$2.arrows", label, id, i);
+    PL_ASSIGN_OR_RETURN(auto file, SpillFile::Create(path, desc, mem_pool));
+    partitions->files_.push_back(std::move(file));
+  }
+  partitions->partition_rows_.resize(num_partitions);
+  return partitions;
+}
+
+int64_t SpillPartitions::PartitionOf(const RowTuple& key) const {
+  // Take the partition from the high bits of the mixed hash, so that the rows of a partition
+  // still spread over all of the buckets of the hash table that they are loaded into.
+  constexpr uint64_t kFibonacciHashMultiplier = 0x9E3779B97F4A7C15ULL;
+  uint64_t mixed_hash = static_cast<uint64_t>(key.Hash()) * kFibonacciHashMultiplier;
+  return (mixed_hash >> 32) % files_.size();
+}
+
+Status SpillPartitions::Append(const RowBatch& rb, const std::vector<int64_t>& row_partitions) {
+  DCHECK_GE(row_partitions.size(), static_cast<size_t>(rb.num_rows()));
+  for (auto& rows : partition_rows_) {
+    rows.clear();
+  }
+  for (int64_t row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+    int64_t partition = row_partitions[row_idx];
+    if (partition != kNotSpilled) {
+      partition_rows_[partition].push_back(row_idx);
+    }
+  }
+
+  for (size_t partition = 0; partition < files_.size(); ++partition) {
+    const auto& rows = partition_rows_[partition];
+    if (rows.empty()) {
+      continue;
+    }
+    RowBatch partition_rb(desc_, rows.size());
+    for (size_t col_idx = 0; col_idx < desc_.size(); ++col_idx) {
+      auto builder = types::MakeArrowBuilder(desc_.type(col_idx), mem_pool_);
+      auto col = rb.ColumnAt(col_idx).get();
+#define TYPE_CASE(_dt_) PL_RETURN_IF_ERROR(AppendRows<_dt_>(builder.get(), col, rows))
+      PL_SWITCH_FOREACH_DATATYPE(desc_.type(col_idx), TYPE_CASE);
+#undef TYPE_CASE
+      std::shared_ptr<arrow::Array> arr;
+      PL_RETURN_IF_ERROR(builder->Finish(&arr));
+      PL_RETURN_IF_ERROR(partition_rb.AddColumn(arr));
+    }
+    PL_RETURN_IF_ERROR(files_[partition]->Write(partition_rb));
+  }
+  return Status::OK();
+}
+
+Status SpillPartitions::FinishWriting() {
+  for (const auto& file : files_) {
+    PL_RETURN_IF_ERROR(file->FinishWriting());
+  }
+  return Status::OK();
+}
+
+Status SpillPartitions::ReadPartition(size_t partition,
+                                      const std::function<Status(const RowBatch&)>& fn) {
+  DCHECK_LT(partition, files_.size());
+  return files_[partition]->Read(fn);
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/memory_pool.h>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/row_tuple.h"
+#include "src/common/base/base.h"
+#include "src/common/memory/memory.h"
+#include "src/table_store/schema/row_batch.h"
+#include "src/table_store/schema/row_descriptor.h"
+
+DECLARE_string(carnot_spill_dir);
+DECLARE_double(carnot_spill_memory_fraction);
+DECLARE_int32(carnot_spill_partitions);
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * Returns true if an operator should move the state it holds in memory to disk, because spilling
+ * is enabled and the query, or the agent, is getting close to its memory limit.
+ */
+bool ShouldSpill(const MemoryReservation& reservation);
+
+/**
+ * SpillFile stores row batches in a file, in the Arrow IPC stream format, so that operators can
+ * move state that does not fit in memory to disk and read it back later.
+ * The file is written once, then read back in full. It is removed when the SpillFile is destroyed.
+ */
+class SpillFile : public NotCopyable {
+ public:
+  static StatusOr<std::unique_ptr<SpillFile>> Create(
+      const std::filesystem::path& path, const table_store::schema::RowDescriptor& desc,
+      arrow::MemoryPool* mem_pool);
+
+  ~SpillFile();
+
+  Status Write(const table_store::schema::RowBatch& rb);
+
+  /**
+   * Closes the file for writing. Must be called before it is read.
+   */
+  Status FinishWriting();
+
+  /**
+   * Calls the function with each of the row batches in the file, in the order they were written.
+   * The arrays of the row batches are allocated from the memory pool of the file.
+   */
+  Status Read(const std::function<Status(const table_store::schema::RowBatch&)>& fn);
+
+  const std::filesystem::path& path() const { return path_; }
+  int64_t num_rows() const { return num_rows_; }
+
+ private:
+  SpillFile(const std::filesystem::path& path, const table_store::schema::RowDescriptor& desc,
+            arrow::MemoryPool* mem_pool);
+
+  const std::filesystem::path path_;
+  const table_store::schema::RowDescriptor desc_;
+  arrow::MemoryPool* mem_pool_;
+  std::shared_ptr<arrow::Schema> schema_;
+
+  std::shared_ptr<arrow::io::FileOutputStream> output_;
+  std::shared_ptr<arrow::ipc::RecordBatchWriter> writer_;
+  int64_t num_rows_ = 0;
+};
+
+/**
+ * SpillPartitions splits the rows of an operator's input between a fixed number of spill files by
+ * the hash of their key, so that all of the rows with the same key end up in the same partition.
+ * Each partition can then be processed on its own, within the memory budget of the query.
+ */
+class SpillPartitions : public NotCopyable {
+ public:
+  // Partition of the rows that are not spilled.
+  static constexpr int64_t kNotSpilled = -1;
+
+  /**
+   * Creates the spill files in --carnot_spill_dir.
+   * @param label Identifies the operator and the query in the name of the files.
+   */
+  static StatusOr<std::unique_ptr<SpillPartitions>> Create(
+      std::string_view label, const table_store::schema::RowDescriptor& desc,
+      arrow::MemoryPool* mem_pool, size_t num_partitions);
+
+  /**
+   * Returns the partition of the rows with the given key.
+   */
+  int64_t PartitionOf(const RowTuple& key) const;
+
+  /**
+   * Appends each row of the row batch to the partition given by its entry in row_partitions,
+   * unless it is kNotSpilled.
+   */
+  Status Append(const table_store::schema::RowBatch& rb,
+                const std::vector<int64_t>& row_partitions);
+
+  /**
+   * Closes all of the partitions for writing. Must be called before they are read.
+   */
+  Status FinishWriting();
+
+  Status ReadPartition(size_t partition,
+                       const std::function<Status(const table_store::schema::RowBatch&)>& fn);
+
+  size_t num_partitions() const { return files_.size(); }
+  int64_t num_rows(size_t partition) const { return files_[partition]->num_rows(); }
+
+ private:
+  SpillPartitions(const table_store::schema::RowDescriptor& desc, arrow::MemoryPool* mem_pool)
+      : desc_(desc), mem_pool_(mem_pool) {}
+
+  const table_store::schema::RowDescriptor desc_;
+  arrow::MemoryPool* mem_pool_;
+  std::vector<std::unique_ptr<SpillFile>> files_;
+  // The rows of the current row batch that go to each partition.
+  std::vector<std::vector<int64_t>> partition_rows_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
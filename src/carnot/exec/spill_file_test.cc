@@ -0,0 +1,153 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/spill_file.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <map>
+#include <vector>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/common/testing/temp_dir.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+
+class SpillFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override { FLAGS_carnot_spill_dir = temp_dir_.path().string(); }
+
+  gflags::FlagSaver flag_saver_;
+  px::testing::TempDir temp_dir_;
+};
+
+TEST_F(SpillFileTest, WriteAndRead) {
+  RowDescriptor rd({types::DataType::INT64, types::DataType::STRING, types::DataType::UINT128});
+  std::vector<RowBatch> written = {
+      RowBatchBuilder(rd, 2, false, false)
+          .AddColumn<types::Int64Value>({1, 2})
+          .AddColumn<types::StringValue>({"abc", "de"})
+          .AddColumn<types::UInt128Value>({{1, 2}, {3, 4}})
+          .get(),
+      RowBatchBuilder(rd, 1, false, false)
+          .AddColumn<types::Int64Value>({3})
+          .AddColumn<types::StringValue>({"fgh"})
+          .AddColumn<types::UInt128Value>({{5, 6}})
+          .get(),
+  };
+
+  ASSERT_OK_AND_ASSIGN(auto file, SpillFile::Create(temp_dir_.path() / "test.arrows", rd,
+                                                    arrow::default_memory_pool()));
+  for (const auto& rb : written) {
+    ASSERT_OK(file->Write(rb));
+  }
+  ASSERT_OK(file->FinishWriting());
+  EXPECT_EQ(file->num_rows(), 3);
+  EXPECT_NOT_OK(file->Write(written[0]));
+
+  std::vector<RowBatch> read;
+  ASSERT_OK(file->Read([&](const RowBatch& rb) {
+    read.push_back(rb);
+    return Status::OK();
+  }));
+  ASSERT_EQ(read.size(), written.size());
+  for (size_t i = 0; i < read.size(); ++i) {
+    ASSERT_EQ(read[i].num_rows(), written[i].num_rows());
+    for (int64_t col_idx = 0; col_idx < rd.size(); ++col_idx) {
+      EXPECT_TRUE(read[i].ColumnAt(col_idx)->Equals(written[i].ColumnAt(col_idx)));
+    }
+  }
+
+  // The file is removed along with the SpillFile.
+  std::filesystem::path path = file->path();
+  EXPECT_TRUE(std::filesystem::exists(path));
+  file.reset();
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(SpillFileTest, PartitionsByKey) {
+  RowDescriptor rd({types::DataType::INT64, types::DataType::INT64});
+  std::vector<types::DataType> key_types = {types::DataType::INT64};
+  ASSERT_OK_AND_ASSIGN(auto partitions, SpillPartitions::Create("test", rd,
+                                                                arrow::default_memory_pool(), 4));
+  ASSERT_EQ(partitions->num_partitions(), 4);
+
+  auto rb = RowBatchBuilder(rd, 6, false, false)
+                .AddColumn<types::Int64Value>({1, 2, 3, 1, 2, 3})
+                .AddColumn<types::Int64Value>({10, 20, 30, 11, 21, 31})
+                .get();
+  std::vector<int64_t> row_partitions;
+  std::map<int64_t, int64_t> key_partitions;
+  for (int64_t key : {1, 2, 3, 1, 2, 3}) {
+    RowTuple rt(&key_types);
+    rt.SetValue(0, types::Int64Value(key));
+    key_partitions[key] = partitions->PartitionOf(rt);
+    row_partitions.push_back(key_partitions[key]);
+  }
+  // Rows that are not spilled are dropped.
+  row_partitions[2] = SpillPartitions::kNotSpilled;
+
+  ASSERT_OK(partitions->Append(rb, row_partitions));
+  ASSERT_OK(partitions->FinishWriting());
+
+  std::multimap<int64_t, int64_t> read_values;
+  int64_t num_rows = 0;
+  for (size_t partition = 0; partition < partitions->num_partitions(); ++partition) {
+    num_rows += partitions->num_rows(partition);
+    ASSERT_OK(partitions->ReadPartition(partition, [&](const RowBatch& partition_rb) {
+      for (int64_t i = 0; i < partition_rb.num_rows(); ++i) {
+        auto key = types::GetValueFromArrowArray<types::DataType::INT64>(
+            partition_rb.ColumnAt(0).get(), i);
+        EXPECT_EQ(key_partitions[key], partition);
+        read_values.emplace(key, types::GetValueFromArrowArray<types::DataType::INT64>(
+                                     partition_rb.ColumnAt(1).get(), i));
+      }
+      return Status::OK();
+    }));
+  }
+  EXPECT_EQ(num_rows, 5);
+  EXPECT_THAT(read_values, ::testing::UnorderedElementsAre(
+                               std::make_pair(1, 10), std::make_pair(1, 11), std::make_pair(2, 20),
+                               std::make_pair(2, 21), std::make_pair(3, 31)));
+}
+
+TEST_F(SpillFileTest, SpillingDisabledWithoutDir) {
+  FLAGS_carnot_spill_dir = "";
+  RowDescriptor rd({types::DataType::INT64});
+  EXPECT_NOT_OK(SpillPartitions::Create("test", rd, arrow::default_memory_pool(), 4));
+
+  MemoryTracker tracker("query", 100);
+  MemoryReservation reservation;
+  reservation.set_tracker(&tracker);
+  reservation.Add(100);
+  EXPECT_FALSE(ShouldSpill(reservation));
+  FLAGS_carnot_spill_dir = temp_dir_.path().string();
+  EXPECT_TRUE(ShouldSpill(reservation));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
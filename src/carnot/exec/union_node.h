@@ -89,7 +89,7 @@ class UnionNode : public ProcessingNode {
   // The items below are all for the time-ordered case.
 
   void CacheNextRowBatch(size_t parent);
-  Status InitializeColumnBuilders();
+  Status InitializeColumnBuilders(ExecState* exec_state);
   types::Time64NSValue GetTimeAtParentCursor(size_t parent_index) const;
   Status AppendRow(size_t parent);
   Status OptionallyFlushRowBatchIfMaxRowsOrEOS(ExecState* exec_state);
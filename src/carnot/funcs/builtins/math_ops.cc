@@ -253,6 +253,9 @@ void RegisterMathOpsOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<MinUDA<types::Float64Value>>("min");
   registry->RegisterOrDie<MinUDA<types::Int64Value>>("min");
   registry->RegisterOrDie<MinUDA<types::Time64NSValue>>("min");
+  // Latest
+  registry->RegisterOrDie<LatestUDA<types::Float64Value>>("latest");
+  registry->RegisterOrDie<LatestUDA<types::Int64Value>>("latest");
   // Count
   registry->RegisterOrDie<CountUDA<types::Float64Value>>("count");
   registry->RegisterOrDie<CountUDA<types::Int64Value>>("count");
@@ -712,6 +712,71 @@ class MinUDA : public udf::UDA {
   TArg min_ = std::numeric_limits<typename types::ValueTypeTraits<TArg>::native_type>::max();
 };
 
+template <typename TArg>
+class LatestUDA : public udf::UDA {
+ public:
+  void Update(FunctionContext*, Time64NSValue time, TArg arg) {
+    if (!latest_.has_value || time.val >= latest_.time) {
+      latest_.time = time.val;
+      latest_.val = arg.val;
+      latest_.has_value = true;
+    }
+  }
+  void Merge(FunctionContext*, const LatestUDA& other) {
+    if (other.latest_.has_value && (!latest_.has_value || other.latest_.time > latest_.time)) {
+      latest_ = other.latest_;
+    }
+  }
+  TArg Finalize(FunctionContext*) { return latest_.val; }
+
+  static udf::InfRuleVec SemanticInferenceRules() {
+    return {udf::InheritTypeFromArgs<LatestUDA>::Create(
+        {types::ST_BYTES, types::ST_THROUGHPUT_PER_NS, types::ST_THROUGHPUT_BYTES_PER_NS,
+         types::ST_DURATION_NS, types::ST_PERCENT},
+        {1})};
+  }
+
+  static udf::UDADocBuilder Doc() {
+    return udf::UDADocBuilder("Returns the value with the latest timestamp in the group.")
+        .Details(
+            "Each group is aggregated on its own, so when grouping by time bins this is the "
+            "latest value within each bin. It does not forward-fill: a bin with no rows gets no "
+            "output row, and the value is not carried over from earlier bins. For tables where "
+            "rows are only recorded when the values change, such as process_stats and "
+            "network_stats with unchanged-row suppression enabled in Stirling, use bins that "
+            "are at least as long as the keyframe period so that every bin has a row.")
+        .Example(
+            "df.timestamp = px.bin(df.time_, px.DurationNanos(60 * 1000 * 1000 * 1000))\n"
+            "df = df.groupby(['upid', 'timestamp']).agg(\n"
+            "    rss_bytes=('time_', 'rss_bytes', px.latest),\n"
+            ")")
+        .Arg("time", "The timestamp of the row.")
+        .Arg("arg", "The data on which to apply the function.")
+        .Returns("The value of the row with the latest timestamp in the group.");
+  }
+
+  StringValue Serialize(FunctionContext*) {
+    return StringValue(reinterpret_cast<char*>(&latest_), sizeof(latest_));
+  }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    if (data.size() != sizeof(latest_)) {
+      return error::InvalidArgument("Unexpected size of serialized latest: $0", data.size());
+    }
+    latest_ = *reinterpret_cast<const Latest*>(data.data());
+    return Status::OK();
+  }
+
+ protected:
+  struct Latest {
+    int64_t time = 0;
+    typename types::ValueTypeTraits<TArg>::native_type val = 0;
+    // Serialized along with the value, so that a partial aggregate of no rows doesn't win a merge.
+    bool has_value = false;
+  };
+  Latest latest_;
+};
+
 template <typename TArg>
 class CountUDA : public udf::UDA {
  public:
@@ -616,6 +616,42 @@ TEST(MathOps, merge_min_test) {
   another_uda_tester.Merge(&uda_tester).Expect(1);
 }
 
+TEST(MathOps, basic_int64_latest_uda_test) {
+  auto uda_tester = udf::UDATester<LatestUDA<types::Int64Value>>();
+  uda_tester.ForInput(1, 3).Expect(3);
+  uda_tester.ForInput(5, 2).ForInput(3, 7).ForInput(4, 1).Expect(2);
+}
+
+TEST(MathOps, basic_float64_latest_uda_test) {
+  auto uda_tester = udf::UDATester<LatestUDA<types::Float64Value>>();
+  uda_tester.ForInput(10, -4.64).ForInput(20, 2.25).ForInput(15, 1.1).Expect(2.25);
+}
+
+TEST(MathOps, merge_latest_test) {
+  auto uda_tester = udf::UDATester<LatestUDA<types::Int64Value>>();
+  uda_tester.ForInput(1, 3).ForInput(2, 6).ForInput(3, 10);
+
+  auto other_uda_tester = udf::UDATester<LatestUDA<types::Int64Value>>();
+  other_uda_tester.ForInput(4, 1).ForInput(5, 11).ForInput(2, 4);
+
+  uda_tester.Merge(&other_uda_tester).Expect(11);
+
+  auto another_uda_tester = udf::UDATester<LatestUDA<types::Int64Value>>();
+  another_uda_tester.Merge(&uda_tester).Expect(11);
+}
+
+TEST(MathOps, deserialize_empty_latest_test) {
+  auto empty_uda_tester = udf::UDATester<LatestUDA<types::Int64Value>>();
+
+  auto uda_tester = udf::UDATester<LatestUDA<types::Int64Value>>();
+  EXPECT_OK(uda_tester.Deserialize(empty_uda_tester.Serialize()));
+
+  auto other_uda_tester = udf::UDATester<LatestUDA<types::Int64Value>>();
+  other_uda_tester.ForInput(0, 7);
+
+  uda_tester.Merge(&other_uda_tester).Expect(7);
+}
+
 TEST(MathOps, basic_int64_count_uda_test) {
   auto uda_tester = udf::UDATester<CountUDA<types::Int64Value>>();
   uda_tester.ForInput(5).ForInput(2).ForInput(7).ForInput(1).Expect(4);
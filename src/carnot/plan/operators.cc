@@ -201,6 +201,11 @@ Status AggregateOperator::Init(const planpb::AggregateOperator& pb) {
   if (pb_.values_size() != pb_.value_names_size()) {
     return error::InvalidArgument("values names/exp size mismatch");
   }
+  if (pb_.window_size_ns() > 0 &&
+      (pb_.window_pane_ns() <= 0 || pb_.window_pane_ns() > pb_.window_size_ns())) {
+    return error::InvalidArgument("window pane of $0ns doesn't fit in a window of $1ns",
+                                  pb_.window_pane_ns(), pb_.window_size_ns());
+  }
   values_.reserve(static_cast<size_t>(pb_.values_size()));
   for (int i = 0; i < pb_.values_size(); ++i) {
     auto ae = std::make_unique<AggregateExpression>();
@@ -588,6 +593,10 @@ Status JoinOperator::Init(const planpb::JoinOperator& pb) {
     equality_conditions_.emplace_back(pb_.equality_conditions(i));
   }
 
+  if (sort_merge() && type() == planpb::JoinOperator::FULL_OUTER) {
+    return error::InvalidArgument("Sort-merge joins do not support full outer joins.");
+  }
+
   if (order_by_time()) {
     // Only support inner joins and left joins where the time_ column comes from the left table.
     // We need a time_ value for every output row in the ordered case to preserve time ordering.
@@ -96,6 +96,7 @@ class MemorySourceOperator : public Operator {
   std::vector<int64_t> Columns() const { return column_idxs_; }
   const types::TabletID& Tablet() const { return pb_.tablet(); }
   bool infinite_stream() const { return pb_.streaming(); }
+  int64_t refresh_interval_ns() const { return pb_.refresh_interval_ns(); }
 
  private:
   planpb::MemorySourceOperator pb_;
@@ -143,6 +144,10 @@ class AggregateOperator : public Operator {
   const std::vector<GroupInfo>& groups() const { return groups_; }
   const std::vector<std::shared_ptr<AggregateExpression>>& values() const { return values_; }
   bool windowed() const { return pb_.windowed(); }
+  bool sliding_window() const { return pb_.windowed() && pb_.window_size_ns() > 0; }
+  int64_t window_size_ns() const { return pb_.window_size_ns(); }
+  int64_t window_pane_ns() const { return pb_.window_pane_ns(); }
+  int64_t window_time_column_index() const { return pb_.window_time_column_index(); }
 
  private:
   std::vector<std::shared_ptr<AggregateExpression>> values_;
@@ -312,6 +317,8 @@ class JoinOperator : public Operator {
   }
   std::vector<planpb::JoinOperator::ParentColumn> output_columns() const { return output_columns_; }
   size_t rows_per_batch() const { return pb_.rows_per_batch(); }
+  // Whether both inputs are sorted by the join's time key, so that they can be merged.
+  bool sort_merge() const { return pb_.sort_merge(); }
 
   bool order_by_time() const;
   planpb::JoinOperator::ParentColumn time_column() const;
@@ -390,6 +390,17 @@ std::string AggregateExpression::DebugString() const {
   return debug_string;
 }
 
+std::vector<int64_t> ColumnIndices(const ScalarExpression& expression) {
+  std::vector<int64_t> indices;
+  ExpressionWalker<int>()
+      .OnColumn([&](const auto& col, const auto&) {
+        indices.push_back(col.Index());
+        return 0;
+      })
+      .Walk(expression);
+  return indices;
+}
+
 }  // namespace plan
 }  // namespace carnot
 }  // namespace px
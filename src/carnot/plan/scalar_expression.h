@@ -349,6 +349,12 @@ class ExpressionWalker {
 using ScalarExpressionVector = std::vector<std::shared_ptr<ScalarExpression>>;
 using ConstScalarExpressionVector = std::vector<std::shared_ptr<const ScalarExpression>>;
 
+/**
+ * Returns the indices of the input columns that the expression reads, in walk order. Columns that
+ * are read more than once are listed more than once.
+ */
+std::vector<int64_t> ColumnIndices(const ScalarExpression& expression);
+
 }  // namespace plan
 }  // namespace carnot
 }  // namespace px
@@ -63,12 +63,21 @@ StatusOr<bool> ConvertStringTimesRule::HandleMemSrc(MemorySourceIR* mem_src) {
 }
 
 StatusOr<bool> ConvertStringTimesRule::HandleRolling(RollingIR* rolling) {
-  if (!HasStringTime(rolling->window_size())) {
+  bool window_size_has_string_time = HasStringTime(rolling->window_size());
+  bool every_has_string_time = HasStringTime(rolling->every());
+  if (!window_size_has_string_time && !every_has_string_time) {
     return false;
   }
-  PL_ASSIGN_OR_RETURN(ExpressionIR * new_window_size,
-                      ConvertStringTimes(rolling->window_size(), /* relative_time */ false));
-  PL_RETURN_IF_ERROR(rolling->ReplaceWindowSize(new_window_size));
+  if (window_size_has_string_time) {
+    PL_ASSIGN_OR_RETURN(ExpressionIR * new_window_size,
+                        ConvertStringTimes(rolling->window_size(), /* relative_time */ false));
+    PL_RETURN_IF_ERROR(rolling->ReplaceWindowSize(new_window_size));
+  }
+  if (every_has_string_time) {
+    PL_ASSIGN_OR_RETURN(ExpressionIR * new_every,
+                        ConvertStringTimes(rolling->every(), /* relative_time */ false));
+    PL_RETURN_IF_ERROR(rolling->ReplaceEvery(new_every));
+  }
   return true;
 }
 
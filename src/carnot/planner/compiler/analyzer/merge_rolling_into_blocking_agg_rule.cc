@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <vector>
+
+#include "src/carnot/planner/compiler/analyzer/merge_rolling_into_blocking_agg_rule.h"
+#include "src/carnot/planner/ir/group_by_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+StatusOr<bool> MergeRollingIntoBlockingAggRule::Apply(IRNode* ir_node) {
+  if (Match(ir_node, Rolling())) {
+    return MergeRolling(static_cast<RollingIR*>(ir_node));
+  }
+  return false;
+}
+
+StatusOr<bool> MergeRollingIntoBlockingAggRule::MergeRolling(RollingIR* rolling) {
+  if (!Match(rolling->window_size(), Int())) {
+    return rolling->window_size()->CreateIRNodeError(
+        "rolling window must be a constant duration, not a $0",
+        rolling->window_size()->type_string());
+  }
+  if (!Match(rolling->every(), Int())) {
+    return rolling->every()->CreateIRNodeError(
+        "rolling 'every' must be a constant duration, not a $0", rolling->every()->type_string());
+  }
+  int64_t window_size_ns = static_cast<IntIR*>(rolling->window_size())->val();
+  int64_t every_ns = static_cast<IntIR*>(rolling->every())->val();
+  if (window_size_ns <= 0) {
+    return rolling->CreateIRNodeError("rolling window must be positive, received $0",
+                                      window_size_ns);
+  }
+  if (every_ns < 0 || every_ns > window_size_ns) {
+    return rolling->CreateIRNodeError(
+        "rolling 'every' must be between 0 and the window size $0, received $1", window_size_ns,
+        every_ns);
+  }
+  int64_t window_pane_ns = every_ns == 0 ? window_size_ns : every_ns;
+
+  // GroupBys that follow the rolling have already been merged into their aggregates and are left
+  // without children. They are removed here so that the rolling can be removed as well.
+  auto graph = rolling->graph();
+  for (OperatorIR* child : rolling->Children()) {
+    if (Match(child, GroupBy()) && child->Children().empty()) {
+      auto groupby_children = graph->dag().DependenciesOf(child->id());
+      PL_RETURN_IF_ERROR(graph->DeleteNode(child->id()));
+      for (const auto& child_id : groupby_children) {
+        PL_RETURN_IF_ERROR(graph->DeleteOrphansInSubtree(child_id));
+      }
+      continue;
+    }
+    if (!Match(child, BlockingAgg())) {
+      return child->CreateIRNodeError("'rolling()' should be followed by an 'agg()' not a $0",
+                                      child->type_string());
+    }
+    PL_RETURN_IF_ERROR(MergeRollingIntoAgg(rolling, static_cast<BlockingAggIR*>(child),
+                                           window_size_ns, window_pane_ns));
+  }
+
+  auto rolling_id = rolling->id();
+  auto rolling_children = graph->dag().DependenciesOf(rolling_id);
+  PL_RETURN_IF_ERROR(graph->DeleteNode(rolling_id));
+  for (const auto& child_id : rolling_children) {
+    PL_RETURN_IF_ERROR(graph->DeleteOrphansInSubtree(child_id));
+  }
+  return true;
+}
+
+Status MergeRollingIntoBlockingAggRule::MergeRollingIntoAgg(RollingIR* rolling,
+                                                            BlockingAggIR* agg,
+                                                            int64_t window_size_ns,
+                                                            int64_t window_pane_ns) {
+  auto graph = rolling->graph();
+  std::vector<ColumnIR*> new_groups;
+  for (ColumnIR* g : rolling->groups()) {
+    PL_ASSIGN_OR_RETURN(ColumnIR * col, graph->CopyNode(g));
+    new_groups.push_back(col);
+  }
+  for (ColumnIR* g : agg->groups()) {
+    new_groups.push_back(g);
+  }
+  PL_RETURN_IF_ERROR(agg->SetGroups(new_groups));
+
+  PL_ASSIGN_OR_RETURN(ColumnIR * window_col, graph->CopyNode(rolling->window_col()));
+  PL_RETURN_IF_ERROR(agg->SetSlidingWindow(window_col, window_size_ns, window_pane_ns));
+
+  DCHECK_EQ(rolling->parents().size(), 1UL);
+  return agg->ReplaceParent(rolling, rolling->parents()[0]);
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
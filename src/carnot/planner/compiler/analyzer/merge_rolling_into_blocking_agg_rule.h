@@ -0,0 +1,55 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "src/carnot/planner/ir/blocking_agg_ir.h"
+#include "src/carnot/planner/ir/rolling_ir.h"
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+/**
+ * @brief This rule folds every RollingIR into the BlockingAggs that follow it. The rolling groups
+ * are copied into each aggregate, which becomes a sliding window aggregate over the rolling
+ * window, and the rolling node is removed.
+ *
+ * Must run after MergeGroupByIntoGroupAcceptorRule and ConvertStringTimesRule, so that the
+ * groups are merged into the rolling and its window sizes are integers.
+ */
+class MergeRollingIntoBlockingAggRule : public Rule {
+ public:
+  MergeRollingIntoBlockingAggRule()
+      : Rule(nullptr, /*use_topo*/ false, /*reverse_topological_execution*/ false) {}
+
+ protected:
+  StatusOr<bool> Apply(IRNode* ir_node) override;
+
+ private:
+  StatusOr<bool> MergeRolling(RollingIR* rolling);
+  Status MergeRollingIntoAgg(RollingIR* rolling, BlockingAggIR* agg, int64_t window_size_ns,
+                             int64_t window_pane_ns);
+};
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/merge_rolling_into_blocking_agg_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using ::testing::ElementsAre;
+
+TEST_F(RulesTest, MergeRollingIntoBlockingAggRule) {
+  MemorySourceIR* mem_source = MakeMemSource();
+  RollingIR* rolling = MakeRolling(mem_source, MakeColumn("time_", 0), MakeInt(60), MakeInt(10));
+  ASSERT_OK(rolling->SetGroups({MakeColumn("col1", 0)}));
+  BlockingAggIR* agg = MakeBlockingAgg(rolling, {MakeColumn("col2", 0)},
+                                       {{"outcount", MakeMeanFunc(MakeColumn("count", 0))}});
+  MakeMemSink(agg, "");
+  int64_t rolling_id = rolling->id();
+
+  MergeRollingIntoBlockingAggRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  EXPECT_FALSE(graph->HasNode(rolling_id));
+  EXPECT_THAT(agg->parents(), ElementsAre(mem_source));
+  std::vector<std::string> group_names;
+  for (ColumnIR* g : agg->groups()) {
+    group_names.push_back(g->col_name());
+  }
+  EXPECT_THAT(group_names, ElementsAre("col1", "col2"));
+
+  ASSERT_TRUE(agg->sliding_window());
+  EXPECT_EQ(agg->window_col()->col_name(), "time_");
+  EXPECT_EQ(agg->window_size_ns(), 60);
+  EXPECT_EQ(agg->window_pane_ns(), 10);
+}
+
+TEST_F(RulesTest, MergeRollingIntoBlockingAggRule_DefaultPaneIsWindow) {
+  MemorySourceIR* mem_source = MakeMemSource();
+  RollingIR* rolling = MakeRolling(mem_source, MakeColumn("time_", 0), MakeInt(60));
+  BlockingAggIR* agg =
+      MakeBlockingAgg(rolling, {}, {{"outcount", MakeMeanFunc(MakeColumn("count", 0))}});
+  MakeMemSink(agg, "");
+
+  MergeRollingIntoBlockingAggRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  ASSERT_TRUE(agg->sliding_window());
+  EXPECT_EQ(agg->window_size_ns(), 60);
+  EXPECT_EQ(agg->window_pane_ns(), 60);
+}
+
+TEST_F(RulesTest, MergeRollingIntoBlockingAggRule_EveryLargerThanWindow) {
+  MemorySourceIR* mem_source = MakeMemSource();
+  RollingIR* rolling = MakeRolling(mem_source, MakeColumn("time_", 0), MakeInt(60), MakeInt(120));
+  MakeBlockingAgg(rolling, {}, {{"outcount", MakeMeanFunc(MakeColumn("count", 0))}});
+
+  MergeRollingIntoBlockingAggRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_NOT_OK(result);
+  EXPECT_THAT(result.status(),
+              HasCompilerError("rolling 'every' must be between 0 and the window size"));
+}
+
+TEST_F(RulesTest, MergeRollingIntoBlockingAggRule_FailOnNonAggChild) {
+  MemorySourceIR* mem_source = MakeMemSource();
+  RollingIR* rolling = MakeRolling(mem_source, MakeColumn("time_", 0), MakeInt(60));
+  MakeMemSink(rolling, "");
+
+  MergeRollingIntoBlockingAggRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_NOT_OK(result);
+  EXPECT_THAT(result.status(), HasCompilerError("'rolling.*' should be followed by an 'agg.*'"));
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -17,8 +17,11 @@
  */
 
 #include <queue>
+#include <vector>
 
 #include "src/carnot/planner/compiler/analyzer/resolve_stream_rule.h"
+#include "src/carnot/planner/ir/blocking_agg_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
 #include "src/carnot/planner/ir/stream_ir.h"
 
 namespace px {
@@ -34,28 +37,40 @@ StatusOr<bool> ResolveStreamRule::Apply(IRNode* ir_node) {
   auto stream_node = static_cast<StreamIR*>(ir_node);
 
   // Check for blocking nodes in the ancestors.
-  // Currently not supported to stream on queries containing blocking operators.
+  // Sliding window aggregates are the only blocking operators that can be streamed. Their
+  // sources refresh at the finest pane of the windows downstream.
   DCHECK_EQ(stream_node->parents().size(), 1UL);
   OperatorIR* parent = stream_node->parents()[0];
   std::queue<OperatorIR*> nodes;
   nodes.push(parent);
+  std::vector<MemorySourceIR*> mem_srcs;
+  int64_t refresh_interval_ns = 0;
 
   while (nodes.size()) {
     auto node = nodes.front();
     nodes.pop();
 
-    if (node->IsBlocking()) {
+    if (Match(node, BlockingAgg()) && static_cast<BlockingAggIR*>(node)->sliding_window()) {
+      int64_t pane_ns = static_cast<BlockingAggIR*>(node)->window_pane_ns();
+      if (refresh_interval_ns == 0 || pane_ns < refresh_interval_ns) {
+        refresh_interval_ns = pane_ns;
+      }
+    } else if (node->IsBlocking()) {
       return error::Unimplemented("df.stream() not yet supported with blocking operator %s",
                                   node->DebugString());
     }
     if (Match(node, MemorySource())) {
-      static_cast<MemorySourceIR*>(node)->set_streaming(true);
+      mem_srcs.push_back(static_cast<MemorySourceIR*>(node));
     }
     auto node_parents = node->parents();
     for (OperatorIR* parent : node_parents) {
       nodes.push(parent);
     }
   }
+  for (MemorySourceIR* mem_src : mem_srcs) {
+    mem_src->set_streaming(true);
+    mem_src->set_refresh_interval_ns(refresh_interval_ns);
+  }
 
   // The only supported children right now should be MemorySinks.
   auto children = stream_node->Children();
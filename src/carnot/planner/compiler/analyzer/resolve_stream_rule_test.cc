@@ -73,6 +73,24 @@ TEST_F(RulesTest, resolve_stream_blocking_ancestor) {
   ASSERT_NOT_OK(result);
 }
 
+TEST_F(RulesTest, resolve_stream_sliding_window_ancestor) {
+  MemorySourceIR* mem_source = MakeMemSource();
+  BlockingAggIR* agg = MakeBlockingAgg(mem_source, {MakeColumn("col1", 0)},
+                                       {{"outcount", MakeMeanFunc(MakeColumn("count", 0))}});
+  ASSERT_OK(agg->SetSlidingWindow(MakeColumn("time_", 0), /* window_size_ns */ 60,
+                                  /* window_pane_ns */ 10));
+  StreamIR* stream = graph->CreateNode<StreamIR>(ast, agg).ValueOrDie();
+  MemorySinkIR* sink = MakeMemSink(stream, "");
+
+  ResolveStreamRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  EXPECT_TRUE(mem_source->streaming());
+  EXPECT_EQ(mem_source->refresh_interval_ns(), 10);
+  EXPECT_THAT(sink->parents(), ElementsAre(agg));
+}
+
 TEST_F(RulesTest, resolve_stream_non_mem_sink_child) {
   MemorySourceIR* mem_source = MakeMemSource();
   GroupByIR* group_by = MakeGroupBy(mem_source, {MakeColumn("col1", 0), MakeColumn("col2", 0)});
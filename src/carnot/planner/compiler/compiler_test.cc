@@ -2649,75 +2649,105 @@ TEST_F(CompilerTest, TestUnaryOperators) {
   ASSERT_OK(plan_status);
 }
 
-// ENABLE and modify these tests once we know where rolling is getting merged into
 constexpr char kRollingTimeStringQuery[] = R"pxl(
 import px
 t1 = px.DataFrame(table='http_events', select=['time_', 'remote_port'])
-t1 = t1.rolling('3s')
+t1 = t1.rolling('3s').agg(count=('remote_port', px.count))
 px.display(t1)
 )pxl";
-TEST_F(CompilerTest, DISABLED_RollingTimeStringQuery) {
+TEST_F(CompilerTest, RollingTimeStringQuery) {
   auto graph_or_s = compiler_.CompileToIR(kRollingTimeStringQuery, compiler_state_.get());
   ASSERT_OK(graph_or_s);
   auto graph = graph_or_s.ConsumeValueOrDie();
 
-  std::vector<IRNode*> rolling_nodes = graph->FindNodesOfType(IRNodeType::kRolling);
-  ASSERT_EQ(rolling_nodes.size(), 1);
-  auto rolling = static_cast<RollingIR*>(rolling_nodes[0]);
+  EXPECT_EQ(graph->FindNodesOfType(IRNodeType::kRolling).size(), 0);
+  std::vector<IRNode*> agg_nodes = graph->FindNodesOfType(IRNodeType::kBlockingAgg);
+  ASSERT_EQ(agg_nodes.size(), 1);
+  auto agg = static_cast<BlockingAggIR*>(agg_nodes[0]);
 
-  ASSERT_EQ(rolling->window_col()->col_name(), "time_");
-  ASSERT_MATCH(rolling->window_size(), Int());
-  IntIR* window_size_int = static_cast<IntIR*>(rolling->window_size());
-  ASSERT_EQ(window_size_int->val(),
-            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(3)).count());
-  Relation rolling_relation({types::TIME64NS, types::INT64}, {"time_", "remote_port"});
-  EXPECT_THAT(*rolling->resolved_table_type(), IsTableType(rolling_relation));
+  ASSERT_TRUE(agg->sliding_window());
+  EXPECT_EQ(agg->window_col()->col_name(), "time_");
+  int64_t window_size_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(3)).count();
+  EXPECT_EQ(agg->window_size_ns(), window_size_ns);
+  EXPECT_EQ(agg->window_pane_ns(), window_size_ns);
 }
 
 constexpr char kRollingIntQuery[] = R"pxl(
 import px
 t1 = px.DataFrame(table='http_events', select=['time_', 'remote_port'])
-t1 = t1.rolling(3000)
+t1 = t1.rolling(3000, every=1000).agg(count=('remote_port', px.count))
 px.display(t1)
 )pxl";
-TEST_F(CompilerTest, DISABLED_RollingIntQuery) {
+TEST_F(CompilerTest, RollingIntQuery) {
   auto graph_or_s = compiler_.CompileToIR(kRollingIntQuery, compiler_state_.get());
   ASSERT_OK(graph_or_s);
   auto graph = graph_or_s.ConsumeValueOrDie();
 
-  std::vector<IRNode*> rolling_nodes = graph->FindNodesOfType(IRNodeType::kRolling);
-  ASSERT_EQ(rolling_nodes.size(), 1);
-  auto rolling = static_cast<RollingIR*>(rolling_nodes[0]);
+  EXPECT_EQ(graph->FindNodesOfType(IRNodeType::kRolling).size(), 0);
+  std::vector<IRNode*> agg_nodes = graph->FindNodesOfType(IRNodeType::kBlockingAgg);
+  ASSERT_EQ(agg_nodes.size(), 1);
+  auto agg = static_cast<BlockingAggIR*>(agg_nodes[0]);
 
-  ASSERT_EQ(rolling->window_col()->col_name(), "time_");
-  ASSERT_MATCH(rolling->window_size(), Int());
-  IntIR* window_size_int = static_cast<IntIR*>(rolling->window_size());
-  ASSERT_EQ(window_size_int->val(), 3000);
-  Relation rolling_relation({types::TIME64NS, types::INT64}, {"time_", "remote_port"});
-  EXPECT_THAT(*rolling->resolved_table_type(), IsTableType(rolling_relation));
+  ASSERT_TRUE(agg->sliding_window());
+  EXPECT_EQ(agg->window_col()->col_name(), "time_");
+  EXPECT_EQ(agg->window_size_ns(), 3000);
+  EXPECT_EQ(agg->window_pane_ns(), 1000);
 }
 
-constexpr char kRollingCompileTimeExprEvalQuery[] = R"pxl(
+constexpr char kRollingEveryTooLargeQuery[] = R"pxl(
 import px
 t1 = px.DataFrame(table='http_events', select=['time_', 'remote_port'])
-t1 = t1.rolling(1 + px.now())
+t1 = t1.rolling('10s', every='1m').agg(count=('remote_port', px.count))
 px.display(t1)
 )pxl";
-TEST_F(CompilerTest, DISABLED_RollingCompileTimeExprEvalQuery) {
-  auto graph_or_s = compiler_.CompileToIR(kRollingCompileTimeExprEvalQuery, compiler_state_.get());
-  ASSERT_OK(graph_or_s);
-  auto graph = graph_or_s.ConsumeValueOrDie();
+TEST_F(CompilerTest, RollingEveryLargerThanWindow) {
+  auto graph_or_s = compiler_.CompileToIR(kRollingEveryTooLargeQuery, compiler_state_.get());
+  ASSERT_NOT_OK(graph_or_s);
+  EXPECT_THAT(graph_or_s.status(),
+              HasCompilerError("rolling 'every' must be between 0 and the window size"));
+}
 
-  std::vector<IRNode*> rolling_nodes = graph->FindNodesOfType(IRNodeType::kRolling);
-  ASSERT_EQ(rolling_nodes.size(), 1);
-  auto rolling = static_cast<RollingIR*>(rolling_nodes[0]);
+constexpr char kSlidingWindowStreamQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events', select=['time_', 'req_path', 'resp_latency_ns'])
+df = df.groupby('req_path').rolling('1m', every='10s').agg(
+    count=('resp_latency_ns', px.count),
+)
+px.display(df.stream())
+)pxl";
+TEST_F(CompilerTest, SlidingWindowStreamPlan) {
+  auto plan_or_s = compiler_.Compile(kSlidingWindowStreamQuery, compiler_state_.get());
+  ASSERT_OK(plan_or_s);
+  auto plan = plan_or_s.ConsumeValueOrDie();
 
-  ASSERT_EQ(rolling->window_col()->col_name(), "time_");
-  ASSERT_MATCH(rolling->window_size(), Int());
-  IntIR* window_size_int = static_cast<IntIR*>(rolling->window_size());
-  ASSERT_EQ(window_size_int->val(), compiler_state_->time_now().val + 1);
-  Relation rolling_relation({types::TIME64NS, types::INT64}, {"time_", "remote_port"});
-  EXPECT_THAT(*rolling->resolved_table_type(), IsTableType(rolling_relation));
+  int64_t window_size_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::minutes(1)).count();
+  int64_t window_pane_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(10)).count();
+  std::vector<planpb::MemorySourceOperator> mem_srcs;
+  std::vector<planpb::AggregateOperator> aggs;
+  for (const auto& fragment : plan.nodes()) {
+    for (const auto& node : fragment.nodes()) {
+      if (node.op().op_type() == planpb::MEMORY_SOURCE_OPERATOR) {
+        mem_srcs.push_back(node.op().mem_source_op());
+      } else if (node.op().op_type() == planpb::AGGREGATE_OPERATOR) {
+        aggs.push_back(node.op().agg_op());
+      }
+    }
+  }
+
+  ASSERT_EQ(mem_srcs.size(), 1);
+  EXPECT_TRUE(mem_srcs[0].streaming());
+  EXPECT_EQ(mem_srcs[0].refresh_interval_ns(), window_pane_ns);
+  EXPECT_THAT(mem_srcs[0].column_names(), ElementsAre("time_", "req_path", "resp_latency_ns"));
+
+  ASSERT_EQ(aggs.size(), 1);
+  EXPECT_TRUE(aggs[0].windowed());
+  EXPECT_EQ(aggs[0].window_size_ns(), window_size_ns);
+  EXPECT_EQ(aggs[0].window_pane_ns(), window_pane_ns);
+  EXPECT_EQ(aggs[0].window_time_column_index(), 0);
+  EXPECT_THAT(aggs[0].group_names(), ElementsAre("req_path"));
 }
 
 constexpr char kRollingNonTimeColumn[] = R"pxl(
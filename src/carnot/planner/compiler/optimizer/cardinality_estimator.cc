@@ -0,0 +1,200 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/compiler/optimizer/cardinality_estimator.h"
+
+#include <algorithm>
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+int64_t CardinalityEstimator::EstimateRows(OperatorIR* op) const {
+  if (Match(op, MemorySource())) {
+    auto it = table_stats_.find(static_cast<MemorySourceIR*>(op)->table_name());
+    return it == table_stats_.end() ? -1 : it->second.num_rows;
+  }
+  if (op->parents().empty()) {
+    return -1;
+  }
+  if (Match(op, Join()) || Match(op, Union())) {
+    int64_t max_rows = 0;
+    int64_t sum_rows = 0;
+    for (OperatorIR* parent : op->parents()) {
+      int64_t rows = EstimateRows(parent);
+      if (rows < 0) {
+        return -1;
+      }
+      max_rows = std::max(max_rows, rows);
+      sum_rows += rows;
+    }
+    // Joins are usually on keys, so the output is about as large as the largest input.
+    return Match(op, Join()) ? max_rows : sum_rows;
+  }
+
+  int64_t input_rows = EstimateRows(op->parents()[0]);
+  if (input_rows < 0) {
+    return -1;
+  }
+  if (Match(op, Filter())) {
+    auto filter = static_cast<FilterIR*>(op);
+    return static_cast<int64_t>(input_rows *
+                                EstimateSelectivity(op->parents()[0], filter->filter_expr()));
+  }
+  if (Match(op, Limit())) {
+    return std::min(input_rows, static_cast<LimitIR*>(op)->limit_value());
+  }
+  if (Match(op, BlockingAgg())) {
+    auto agg = static_cast<BlockingAggIR*>(op);
+    if (agg->groups().empty()) {
+      return 1;
+    }
+    // Assume the group columns are independent, so the number of groups is the product of their
+    // NDVs, which can't be more than the number of input rows.
+    double num_groups = 1;
+    for (ColumnIR* group : agg->groups()) {
+      int64_t ndv = EstimateNDV(op->parents()[0], group->col_name());
+      if (ndv < 0) {
+        return input_rows;
+      }
+      num_groups *= ndv;
+    }
+    return static_cast<int64_t>(std::min(static_cast<double>(input_rows), num_groups));
+  }
+  return input_rows;
+}
+
+int64_t CardinalityEstimator::EstimateNDV(OperatorIR* op, const std::string& column) const {
+  if (Match(op, MemorySource())) {
+    auto it = table_stats_.find(static_cast<MemorySourceIR*>(op)->table_name());
+    if (it == table_stats_.end()) {
+      return -1;
+    }
+    auto ndv_it = it->second.column_ndvs.find(column);
+    return ndv_it == it->second.column_ndvs.end() ? -1 : ndv_it->second;
+  }
+  if (op->parents().empty()) {
+    return -1;
+  }
+
+  // Find the parent and the column of the parent that the output column comes from.
+  OperatorIR* parent = op->parents()[0];
+  std::string parent_column = column;
+  if (Match(op, Map())) {
+    auto map = static_cast<MapIR*>(op);
+    auto it = std::find_if(map->col_exprs().begin(), map->col_exprs().end(),
+                           [&column](const ColumnExpression& expr) { return expr.name == column; });
+    if (it != map->col_exprs().end()) {
+      if (!Match(it->node, ColumnNode())) {
+        return -1;
+      }
+      parent_column = static_cast<ColumnIR*>(it->node)->col_name();
+    } else if (!map->keep_input_columns()) {
+      return -1;
+    }
+  } else if (Match(op, Join())) {
+    auto join = static_cast<JoinIR*>(op);
+    auto it = std::find(join->column_names().begin(), join->column_names().end(), column);
+    if (it == join->column_names().end()) {
+      return -1;
+    }
+    ColumnIR* output_col = join->output_columns()[it - join->column_names().begin()];
+    parent = op->parents()[output_col->container_op_parent_idx()];
+    parent_column = output_col->col_name();
+  } else if (Match(op, BlockingAgg())) {
+    auto groups = static_cast<BlockingAggIR*>(op)->groups();
+    if (!std::any_of(groups.begin(), groups.end(),
+                     [&column](ColumnIR* group) { return group->col_name() == column; })) {
+      return -1;
+    }
+  } else if (Match(op, Union())) {
+    return -1;
+  }
+
+  int64_t ndv = EstimateNDV(parent, parent_column);
+  int64_t rows = EstimateRows(op);
+  if (ndv < 0 || rows < 0) {
+    return ndv;
+  }
+  return std::min(ndv, rows);
+}
+
+double CardinalityEstimator::EstimateEqualitySelectivity(OperatorIR* op, FuncIR* func) const {
+  const auto& args = func->all_args();
+  if (args.size() != 2) {
+    return kDefaultEqualitySelectivity;
+  }
+  // An equality between a column and a literal matches one of the distinct values of the column.
+  ExpressionIR* column = nullptr;
+  if (Match(args[0], ColumnNode()) && Match(args[1], DataNode())) {
+    column = args[0];
+  } else if (Match(args[1], ColumnNode()) && Match(args[0], DataNode())) {
+    column = args[1];
+  }
+  if (column == nullptr) {
+    return kDefaultEqualitySelectivity;
+  }
+  int64_t ndv = EstimateNDV(op, static_cast<ColumnIR*>(column)->col_name());
+  if (ndv <= 0) {
+    return kDefaultEqualitySelectivity;
+  }
+  return 1.0 / ndv;
+}
+
+double CardinalityEstimator::EstimateSelectivity(OperatorIR* op, ExpressionIR* expr) const {
+  if (!Match(expr, Func())) {
+    return kDefaultSelectivity;
+  }
+  auto func = static_cast<FuncIR*>(expr);
+  const auto& args = func->all_args();
+  switch (func->opcode()) {
+    case FuncIR::Opcode::eq:
+      return EstimateEqualitySelectivity(op, func);
+    case FuncIR::Opcode::neq:
+      return 1 - EstimateEqualitySelectivity(op, func);
+    case FuncIR::Opcode::lt:
+    case FuncIR::Opcode::lteq:
+    case FuncIR::Opcode::gt:
+    case FuncIR::Opcode::gteq:
+      return kDefaultRangeSelectivity;
+    case FuncIR::Opcode::logand: {
+      double selectivity = 1;
+      for (ExpressionIR* arg : args) {
+        selectivity *= EstimateSelectivity(op, arg);
+      }
+      return selectivity;
+    }
+    case FuncIR::Opcode::logor: {
+      double none_selected = 1;
+      for (ExpressionIR* arg : args) {
+        none_selected *= 1 - EstimateSelectivity(op, arg);
+      }
+      return 1 - none_selected;
+    }
+    case FuncIR::Opcode::lognot:
+      return args.size() == 1 ? 1 - EstimateSelectivity(op, args[0]) : kDefaultSelectivity;
+    default:
+      return kDefaultSelectivity;
+  }
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
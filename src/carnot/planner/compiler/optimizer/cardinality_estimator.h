@@ -0,0 +1,75 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+
+#include "src/carnot/planner/compiler_state/compiler_state.h"
+#include "src/carnot/planner/ir/all_ir_nodes.h"
+#include "src/carnot/planner/ir/ir.h"
+#include "src/carnot/planner/ir/pattern_match.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+/**
+ * @brief CardinalityEstimator estimates the number of rows output by operators, and the number of
+ * distinct values of their columns, from the table stats reported by the agents.
+ *
+ * Estimates are -1 when they can't be made, e.g. when a table read by the plan has no stats. The
+ * estimates are meant for comparing alternative plans, so they only need to be roughly right.
+ */
+class CardinalityEstimator {
+ public:
+  // The selectivities used when the stats can't tell, as in the classic System R estimates.
+  static constexpr double kDefaultEqualitySelectivity = 0.1;
+  static constexpr double kDefaultRangeSelectivity = 1.0 / 3;
+  static constexpr double kDefaultSelectivity = 0.5;
+
+  explicit CardinalityEstimator(const TableStatsMap& table_stats) : table_stats_(table_stats) {}
+
+  /**
+   * @brief Returns the estimated number of rows output by the operator, or -1 if unknown.
+   */
+  int64_t EstimateRows(OperatorIR* op) const;
+
+  /**
+   * @brief Returns the estimated number of distinct values in the named output column of the
+   * operator, or -1 if unknown.
+   */
+  int64_t EstimateNDV(OperatorIR* op, const std::string& column) const;
+
+  /**
+   * @brief Returns the estimated fraction of the rows of the operator that pass the filter
+   * expression, which must reference the columns of the operator.
+   */
+  double EstimateSelectivity(OperatorIR* op, ExpressionIR* expr) const;
+
+ private:
+  double EstimateEqualitySelectivity(OperatorIR* op, FuncIR* func) const;
+
+  const TableStatsMap& table_stats_;
+};
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
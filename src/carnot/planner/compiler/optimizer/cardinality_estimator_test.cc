@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
+#include "src/carnot/planner/compiler/optimizer/cardinality_estimator.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+class CardinalityEstimatorTest : public RulesTest {
+ protected:
+  void SetUp() override {
+    RulesTest::SetUp();
+    TableStats stats;
+    stats.num_rows = 1000;
+    stats.num_bytes = 32000;
+    stats.column_ndvs["count"] = 50;
+    table_stats_["cpu"] = stats;
+  }
+
+  TableStatsMap table_stats_;
+};
+
+TEST_F(CardinalityEstimatorTest, source_and_filter) {
+  auto mem_src = MakeMemSource("cpu", cpu_relation);
+  auto eq_filter = MakeFilter(mem_src, MakeEqualsFunc(MakeColumn("count", 0), MakeInt(10)));
+  auto gt_filter = MakeFilter(
+      mem_src, graph
+                   ->CreateNode<FuncIR>(ast, FuncIR::op_map.find(">")->second,
+                                        std::vector<ExpressionIR*>{MakeColumn("cpu0", 0),
+                                                                   MakeFloat(0.5)})
+                   .ConsumeValueOrDie());
+  auto limit = MakeLimit(eq_filter, 10);
+
+  CardinalityEstimator estimator(table_stats_);
+  EXPECT_EQ(1000, estimator.EstimateRows(mem_src));
+  // count has 50 distinct values, so an equality matches 1/50 of the rows.
+  EXPECT_EQ(20, estimator.EstimateRows(eq_filter));
+  EXPECT_EQ(333, estimator.EstimateRows(gt_filter));
+  EXPECT_EQ(10, estimator.EstimateRows(limit));
+}
+
+TEST_F(CardinalityEstimatorTest, agg_groups_from_ndvs) {
+  auto mem_src = MakeMemSource("cpu", cpu_relation);
+  auto map = MakeMap(mem_src, {{"renamed", MakeColumn("count", 0)}}, /*keep_input_columns*/ false);
+  auto agg = MakeBlockingAgg(map, {MakeColumn("renamed", 0)},
+                             {{"mean", MakeMeanFunc(MakeColumn("renamed", 0))}});
+  auto no_group_agg = MakeBlockingAgg(mem_src, {}, {{"mean", MakeMeanFunc(MakeColumn("cpu0", 0))}});
+
+  CardinalityEstimator estimator(table_stats_);
+  EXPECT_EQ(50, estimator.EstimateNDV(map, "renamed"));
+  EXPECT_EQ(50, estimator.EstimateRows(agg));
+  EXPECT_EQ(1, estimator.EstimateRows(no_group_agg));
+  // The NDV of a column without stats is unknown, so the agg could keep every row.
+  auto cpu_agg = MakeBlockingAgg(mem_src, {MakeColumn("cpu0", 0)},
+                                 {{"mean", MakeMeanFunc(MakeColumn("cpu1", 0))}});
+  EXPECT_EQ(-1, estimator.EstimateNDV(mem_src, "cpu0"));
+  EXPECT_EQ(1000, estimator.EstimateRows(cpu_agg));
+}
+
+TEST_F(CardinalityEstimatorTest, unknown_table) {
+  auto mem_src = MakeMemSource("semantic_table", semantic_rel);
+  auto filter = MakeFilter(mem_src, MakeEqualsFunc(MakeColumn("bytes", 0), MakeInt(10)));
+
+  CardinalityEstimator estimator(table_stats_);
+  EXPECT_EQ(-1, estimator.EstimateRows(mem_src));
+  EXPECT_EQ(-1, estimator.EstimateRows(filter));
+  EXPECT_DOUBLE_EQ(CardinalityEstimator::kDefaultEqualitySelectivity,
+                   estimator.EstimateSelectivity(mem_src, filter->filter_expr()));
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -24,8 +24,10 @@
 #include <vector>
 
 #include "src/carnot/planner/compiler/optimizer/merge_nodes_rule.h"
+#include "src/carnot/planner/compiler/optimizer/order_filters_by_selectivity_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unconnected_operators_rule.h"
 #include "src/carnot/planner/compiler/optimizer/prune_unused_columns_rule.h"
+#include "src/carnot/planner/compiler/optimizer/select_join_build_side_rule.h"
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/compiler_state/registry_info.h"
 #include "src/carnot/planner/ir/ir.h"
@@ -57,6 +59,13 @@ class Optimizer : public RuleExecutor<IR> {
     merge_nodes_batch->AddRule<MergeNodesRule>(compiler_state_);
   }
 
+  void CreateCostBasedBatch() {
+    // Each pass moves a filter past one less selective filter, so long chains need a few passes.
+    RuleBatch* cost_based_batch = CreateRuleBatch<TryUntilMax>("CostBased", 10);
+    cost_based_batch->AddRule<SelectJoinBuildSideRule>(compiler_state_);
+    cost_based_batch->AddRule<OrderFiltersBySelectivityRule>(compiler_state_);
+  }
+
   void CreatePruneUnusedColumnsBatch() {
     RuleBatch* prune_unused_columns = CreateRuleBatch<FailOnMax>("PruneUnusedColumns", 2);
     prune_unused_columns->AddRule<PruneUnusedColumnsRule>();
@@ -65,6 +74,7 @@ class Optimizer : public RuleExecutor<IR> {
   Status Init() {
     CreatePruneUnconnectedOpsBatch();
     CreateMergeNodesBatch();
+    CreateCostBasedBatch();
     CreatePruneUnusedColumnsBatch();
     return Status::OK();
   }
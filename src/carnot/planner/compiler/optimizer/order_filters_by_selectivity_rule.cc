@@ -0,0 +1,65 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/compiler/optimizer/order_filters_by_selectivity_rule.h"
+
+#include "src/carnot/planner/compiler/optimizer/cardinality_estimator.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+StatusOr<bool> OrderFiltersBySelectivityRule::Apply(IRNode* ir_node) {
+  // Look for a filter whose parent is a filter that only feeds it.
+  if (!Match(ir_node, Filter())) {
+    return false;
+  }
+  auto filter = static_cast<FilterIR*>(ir_node);
+  OperatorIR* parent = filter->parents()[0];
+  if (!Match(parent, Filter()) || parent->Children().size() != 1) {
+    return false;
+  }
+  auto parent_filter = static_cast<FilterIR*>(parent);
+  OperatorIR* input = parent_filter->parents()[0];
+
+  // Filters don't change the columns, so both expressions can be evaluated against the input.
+  CardinalityEstimator estimator(compiler_state_->table_stats());
+  if (estimator.EstimateRows(input) < 0) {
+    return false;
+  }
+  double selectivity = estimator.EstimateSelectivity(input, filter->filter_expr());
+  double parent_selectivity = estimator.EstimateSelectivity(input, parent_filter->filter_expr());
+  if (selectivity >= parent_selectivity) {
+    return false;
+  }
+
+  // input -> parent_filter -> filter -> children becomes input -> filter -> parent_filter ->
+  // children.
+  for (OperatorIR* child : filter->Children()) {
+    PL_RETURN_IF_ERROR(child->ReplaceParent(filter, parent_filter));
+  }
+  PL_RETURN_IF_ERROR(filter->ReplaceParent(parent_filter, input));
+  PL_RETURN_IF_ERROR(parent_filter->ReplaceParent(input, filter));
+  return true;
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
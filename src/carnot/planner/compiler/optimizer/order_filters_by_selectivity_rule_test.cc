@@ -0,0 +1,113 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
+#include "src/carnot/planner/compiler/optimizer/order_filters_by_selectivity_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using ::testing::ElementsAre;
+
+class OrderFiltersBySelectivityRuleTest : public RulesTest {
+ protected:
+  void SetStats() {
+    TableStatsMap table_stats;
+    table_stats["cpu"].num_rows = 1000;
+    table_stats["cpu"].column_ndvs["count"] = 100;
+    compiler_state_->set_table_stats(std::move(table_stats));
+  }
+
+  FuncIR* MakeNotEqualsFunc(ExpressionIR* left, ExpressionIR* right) {
+    return graph
+        ->CreateNode<FuncIR>(ast, FuncIR::op_map.find("!=")->second,
+                             std::vector<ExpressionIR*>({left, right}))
+        .ConsumeValueOrDie();
+  }
+};
+
+TEST_F(OrderFiltersBySelectivityRuleTest, selective_filter_moves_first) {
+  SetStats();
+  auto mem_src = MakeMemSource("cpu", cpu_relation);
+  // Keeps almost every row.
+  auto neq_filter = MakeFilter(mem_src, MakeNotEqualsFunc(MakeColumn("count", 0), MakeInt(1)));
+  // Keeps 1% of the rows.
+  auto eq_filter = MakeFilter(neq_filter, MakeEqualsFunc(MakeColumn("count", 0), MakeInt(10)));
+  auto sink = MakeMemSink(eq_filter, "out");
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  OrderFiltersBySelectivityRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  EXPECT_THAT(eq_filter->parents(), ElementsAre(mem_src));
+  EXPECT_THAT(neq_filter->parents(), ElementsAre(eq_filter));
+  EXPECT_THAT(sink->parents(), ElementsAre(neq_filter));
+  EXPECT_THAT(mem_src->Children(), ElementsAre(eq_filter));
+
+  result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+}
+
+TEST_F(OrderFiltersBySelectivityRuleTest, parent_with_other_children_unchanged) {
+  SetStats();
+  auto mem_src = MakeMemSource("cpu", cpu_relation);
+  auto neq_filter = MakeFilter(mem_src, MakeNotEqualsFunc(MakeColumn("count", 0), MakeInt(1)));
+  auto eq_filter = MakeFilter(neq_filter, MakeEqualsFunc(MakeColumn("count", 0), MakeInt(10)));
+  MakeMemSink(eq_filter, "out");
+  // The rows of the first filter are also used elsewhere, so it must stay in place.
+  MakeMemSink(neq_filter, "out2");
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  OrderFiltersBySelectivityRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_THAT(eq_filter->parents(), ElementsAre(neq_filter));
+}
+
+TEST_F(OrderFiltersBySelectivityRuleTest, no_stats) {
+  auto mem_src = MakeMemSource("cpu", cpu_relation);
+  auto neq_filter = MakeFilter(mem_src, MakeNotEqualsFunc(MakeColumn("count", 0), MakeInt(1)));
+  auto eq_filter = MakeFilter(neq_filter, MakeEqualsFunc(MakeColumn("count", 0), MakeInt(10)));
+  MakeMemSink(eq_filter, "out");
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  OrderFiltersBySelectivityRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_THAT(eq_filter->parents(), ElementsAre(neq_filter));
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
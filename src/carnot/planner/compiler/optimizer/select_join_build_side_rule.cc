@@ -0,0 +1,53 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/compiler/optimizer/select_join_build_side_rule.h"
+
+#include "src/carnot/planner/compiler/optimizer/cardinality_estimator.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+StatusOr<bool> SelectJoinBuildSideRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Join())) {
+    return false;
+  }
+  auto join = static_cast<JoinIR*>(ir_node);
+  // Left joins must keep their parents, since they emit the unmatched rows of the left parent.
+  if (join->join_type() != JoinIR::JoinType::kInner &&
+      join->join_type() != JoinIR::JoinType::kOuter) {
+    return false;
+  }
+  DCHECK_EQ(join->parents().size(), 2UL);
+
+  CardinalityEstimator estimator(compiler_state_->table_stats());
+  int64_t left_rows = estimator.EstimateRows(join->parents()[0]);
+  int64_t right_rows = estimator.EstimateRows(join->parents()[1]);
+  if (left_rows < 0 || right_rows < 0 || left_rows <= right_rows) {
+    return false;
+  }
+  PL_RETURN_IF_ERROR(join->SwapParents());
+  return true;
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
+#include "src/carnot/planner/compiler/optimizer/select_join_build_side_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using table_store::schema::Relation;
+using ::testing::ElementsAre;
+
+class SelectJoinBuildSideRuleTest : public RulesTest {
+ protected:
+  void SetUpImpl() override {
+    RulesTest::SetUpImpl();
+    relation0 = Relation({types::INT64, types::INT64}, {"left_only", "col1"});
+    relation1 = Relation({types::INT64, types::INT64}, {"right_only", "col2"});
+    compiler_state_->relation_map()->emplace("source0", relation0);
+    compiler_state_->relation_map()->emplace("source1", relation1);
+  }
+
+  void SetRows(int64_t source0_rows, int64_t source1_rows) {
+    TableStatsMap table_stats;
+    table_stats["source0"].num_rows = source0_rows;
+    table_stats["source1"].num_rows = source1_rows;
+    compiler_state_->set_table_stats(std::move(table_stats));
+  }
+
+  JoinIR* MakeTestJoin(const std::string& join_type) {
+    mem_src0 = MakeMemSource("source0", relation0);
+    mem_src1 = MakeMemSource("source1", relation1);
+    auto join = MakeJoin({mem_src0, mem_src1}, join_type, relation0, relation1,
+                         std::vector<std::string>{"col1"}, std::vector<std::string>{"col2"},
+                         {"_x", "_y"});
+    MakeMemSink(join, "out");
+    ResolveTypesRule type_rule(compiler_state_.get());
+    EXPECT_OK(type_rule.Execute(graph.get()));
+    return join;
+  }
+
+  Relation relation0;
+  Relation relation1;
+  MemorySourceIR* mem_src0;
+  MemorySourceIR* mem_src1;
+};
+
+TEST_F(SelectJoinBuildSideRuleTest, smaller_input_becomes_build_side) {
+  SetRows(1000, 10);
+  auto join = MakeTestJoin("inner");
+  auto join_type = join->resolved_table_type();
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  EXPECT_THAT(join->parents(), ElementsAre(mem_src1, mem_src0));
+  ASSERT_EQ(1, join->left_on_columns().size());
+  EXPECT_EQ("col2", join->left_on_columns()[0]->col_name());
+  EXPECT_EQ(0, join->left_on_columns()[0]->container_op_parent_idx());
+  EXPECT_EQ("col1", join->right_on_columns()[0]->col_name());
+  EXPECT_EQ(1, join->right_on_columns()[0]->container_op_parent_idx());
+  EXPECT_THAT(join->suffix_strs(), ElementsAre("_y", "_x"));
+
+  // The output of the join is unchanged.
+  EXPECT_THAT(join->column_names(), ElementsAre("left_only", "col1", "right_only", "col2"));
+  EXPECT_EQ(1, join->output_columns()[0]->container_op_parent_idx());
+  EXPECT_EQ(0, join->output_columns()[2]->container_op_parent_idx());
+  EXPECT_EQ(join_type, join->resolved_table_type());
+
+  // Running the rule again keeps the new order.
+  result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+}
+
+TEST_F(SelectJoinBuildSideRuleTest, smaller_input_already_build_side) {
+  SetRows(10, 1000);
+  auto join = MakeTestJoin("inner");
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_THAT(join->parents(), ElementsAre(mem_src0, mem_src1));
+}
+
+TEST_F(SelectJoinBuildSideRuleTest, left_join_unchanged) {
+  SetRows(1000, 10);
+  auto join = MakeTestJoin("left");
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_THAT(join->parents(), ElementsAre(mem_src0, mem_src1));
+}
+
+TEST_F(SelectJoinBuildSideRuleTest, no_stats) {
+  auto join = MakeTestJoin("inner");
+
+  SelectJoinBuildSideRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ConsumeValueOrDie());
+  EXPECT_THAT(join->parents(), ElementsAre(mem_src0, mem_src1));
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
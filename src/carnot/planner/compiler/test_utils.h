@@ -564,9 +564,13 @@ class OperatorTests : public ::testing::Test {
     return agg;
   }
 
-  RollingIR* MakeRolling(OperatorIR* parent, ColumnIR* window_col, DataIR* window_size) {
-    RollingIR* rolling =
-        graph->CreateNode<RollingIR>(ast, parent, window_col, window_size).ConsumeValueOrDie();
+  RollingIR* MakeRolling(OperatorIR* parent, ColumnIR* window_col, DataIR* window_size,
+                         DataIR* every = nullptr) {
+    if (every == nullptr) {
+      every = MakeInt(0);
+    }
+    RollingIR* rolling = graph->CreateNode<RollingIR>(ast, parent, window_col, window_size, every)
+                             .ConsumeValueOrDie();
     return rolling;
   }
 
@@ -90,6 +90,15 @@ struct RedactionOptions {
 };
 
 using RelationMap = std::unordered_map<std::string, table_store::schema::Relation>;
+
+// TableStats holds the statistics reported by the agents for a table, summed over the agents.
+struct TableStats {
+  int64_t num_rows = 0;
+  int64_t num_bytes = 0;
+  // The approximate number of distinct values of the columns that have an estimate.
+  absl::flat_hash_map<std::string, int64_t> column_ndvs;
+};
+using TableStatsMap = absl::flat_hash_map<std::string, TableStats>;
 using SensitiveColumnMap = absl::flat_hash_map<std::string, absl::flat_hash_set<std::string>>;
 class CompilerState : public NotCopyable {
  public:
@@ -155,6 +164,10 @@ class CompilerState : public NotCopyable {
   int64_t max_output_rows_per_table() { return max_output_rows_per_table_; }
   bool has_max_output_rows_per_table() { return max_output_rows_per_table_ > 0; }
 
+  // The statistics of the tables queried, keyed by table name. Tables without stats are missing.
+  const TableStatsMap& table_stats() const { return table_stats_; }
+  void set_table_stats(TableStatsMap table_stats) { table_stats_ = std::move(table_stats); }
+
   const RedactionOptions& redaction_options() { return redaction_options_; }
   void set_redaction_options(const RedactionOptions& options) { redaction_options_ = options; }
 
@@ -170,6 +183,7 @@ class CompilerState : public NotCopyable {
   const std::string result_address_;
   const std::string result_ssl_targetname_;
   RedactionOptions redaction_options_;
+  TableStatsMap table_stats_;
 };
 
 }  // namespace planner
@@ -49,6 +49,50 @@ StatusOr<distributedpb::DistributedPlan> DistributedPlan::ToProto() const {
   return physical_plan_pb;
 }
 
+StatusOr<std::unique_ptr<DistributedPlan>> DistributedPlan::Clone() const {
+  auto new_plan = std::make_unique<DistributedPlan>();
+  absl::flat_hash_map<IR*, IR*> old_to_new_plans;
+  for (const auto& plan : plan_pool_) {
+    PL_ASSIGN_OR_RETURN(std::unique_ptr<IR> new_ir, plan->Clone());
+    old_to_new_plans[plan.get()] = new_ir.get();
+    new_plan->AddPlan(std::move(new_ir));
+  }
+
+  for (const auto& [carnot_id, carnot] : id_to_node_map_) {
+    PL_ASSIGN_OR_RETURN(auto instance,
+                        CarnotInstance::Create(carnot_id, carnot->carnot_info(), new_plan.get()));
+    if (carnot->plan() != nullptr) {
+      auto plan_it = old_to_new_plans.find(carnot->plan());
+      if (plan_it == old_to_new_plans.end()) {
+        return error::Internal("$0 has a plan that isn't owned by the distributed plan.",
+                               carnot->DebugString());
+      }
+      instance->AddPlan(plan_it->second);
+    }
+    new_plan->id_to_node_map_.emplace(carnot_id, std::move(instance));
+  }
+
+  for (const auto& [plan, agents] : plan_to_agent_map_) {
+    auto plan_it = old_to_new_plans.find(plan);
+    if (plan_it == old_to_new_plans.end()) {
+      return error::Internal("Plan to agent map references a plan that isn't in the pool.");
+    }
+    new_plan->plan_to_agent_map_[plan_it->second] = agents;
+  }
+  for (const auto& [agent, plan] : agent_to_plan_map_) {
+    new_plan->agent_to_plan_map_[agent] = old_to_new_plans[plan];
+  }
+
+  new_plan->dag_ = dag_;
+  new_plan->uuid_to_id_map_ = uuid_to_id_map_;
+  new_plan->id_counter_ = id_counter_;
+  new_plan->plan_options_.CopyFrom(plan_options_);
+  if (kelvin_ != nullptr) {
+    new_plan->kelvin_ = new_plan->Get(kelvin_->id());
+  }
+  return new_plan;
+}
+
 StatusOr<int64_t> DistributedPlan::AddCarnot(const distributedpb::CarnotInfo& carnot_info) {
   int64_t carnot_id = id_counter_;
   ++id_counter_;
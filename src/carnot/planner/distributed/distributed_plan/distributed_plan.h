@@ -126,6 +126,14 @@ class DistributedPlan {
 
   StatusOr<distributedpb::DistributedPlan> ToProto() const;
 
+  /**
+   * @brief Creates a deep copy of this plan. The Carnot instances keep their ids and each of
+   * the plans in the pool is cloned with its node ids intact.
+   *
+   * @return the copied plan or an error if one of the plans couldn't be cloned.
+   */
+  StatusOr<std::unique_ptr<DistributedPlan>> Clone() const;
+
   const plan::DAG& dag() const { return dag_; }
 
   void SetPlanOptions(planpb::PlanOptions plan_options) { plan_options_.CopyFrom(plan_options); }
@@ -229,6 +229,43 @@ TEST_F(DistributedPlanTest, construction_test) {
   EXPECT_THAT(physical_plan_proto, Partially(EqualsProto(kIRProto)));
 }
 
+TEST_F(DistributedPlanTest, clone_test) {
+  auto physical_plan = std::make_unique<DistributedPlan>();
+  distributedpb::DistributedState physical_state =
+      LoadDistributedStatePb(kOneAgentDistributedState);
+  compiler_state_->relation_map()->emplace("table", MakeRelation());
+  for (const auto& carnot_info : physical_state.carnot_info()) {
+    auto carnot_id = physical_plan->AddCarnot(carnot_info).ConsumeValueOrDie();
+    CarnotInstance* carnot_instance = physical_plan->Get(carnot_id);
+    auto new_graph = std::make_shared<IR>();
+    SwapGraphBeingBuilt(new_graph);
+    auto mem_source = MakeMemSource(MakeRelation());
+    MakeMemSink(mem_source, carnot_instance->QueryBrokerAddress());
+
+    compiler::ResolveTypesRule rule(compiler_state_.get());
+    ASSERT_OK(rule.Execute(graph.get()));
+
+    auto clone_uptr = new_graph->Clone().ConsumeValueOrDie();
+    carnot_instance->AddPlan(clone_uptr.get());
+    physical_plan->AddPlan(std::move(clone_uptr));
+  }
+  physical_plan->AddEdge(physical_plan->Get(0), physical_plan->Get(1));
+  physical_plan->SetKelvin(physical_plan->Get(1));
+
+  auto cloned_plan = physical_plan->Clone().ConsumeValueOrDie();
+  EXPECT_THAT(cloned_plan->ToProto().ConsumeValueOrDie(),
+              EqualsProto(physical_plan->ToProto().ConsumeValueOrDie().DebugString()));
+  ASSERT_NE(cloned_plan->kelvin(), nullptr);
+  EXPECT_EQ(cloned_plan->kelvin()->id(), 1);
+  EXPECT_EQ(cloned_plan->kelvin()->distributed_plan(), cloned_plan.get());
+  for (int64_t carnot_id : cloned_plan->dag().nodes()) {
+    IR* cloned_ir = cloned_plan->Get(carnot_id)->plan();
+    IR* original_ir = physical_plan->Get(carnot_id)->plan();
+    EXPECT_NE(cloned_ir, original_ir);
+    EXPECT_EQ(cloned_ir->dag().nodes(), original_ir->dag().nodes());
+  }
+}
+
 }  // namespace distributed
 
 }  // namespace planner
@@ -27,6 +27,7 @@
 #include "src/carnot/planner/distributed/distributed_rules.h"
 #include "src/carnot/planner/distributed/distributed_stitcher_rules.h"
 #include "src/carnot/planner/distributed/grpc_source_conversion.h"
+#include "src/carnot/planner/distributed/select_join_algorithm_rule.h"
 #include "src/carnot/planner/rules/rules.h"
 
 namespace px {
@@ -85,6 +86,12 @@ StatusOr<std::unique_ptr<DistributedPlan>> DistributedPlanner::Plan(
     rule.Execute(agent_plan);
   }
 
+  // Whether the inputs of a join are sorted is only known once the plan is split.
+  SelectJoinAlgorithmRule join_algorithm_rule;
+  for (IR* agent_plan : distributed_plan->UniquePlans()) {
+    PL_RETURN_IF_ERROR(join_algorithm_rule.Execute(agent_plan));
+  }
+
   return distributed_plan;
 }
 
@@ -20,6 +20,7 @@
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -111,6 +112,33 @@ class DistributedPlannerTest : public ASTVisitorTest {
     CHECK(google::protobuf::TextFormat::MergeFromString(physical_state_txt, &physical_state_pb));
     return physical_state_pb;
   }
+
+  // Plans an inner join of "table" with itself on time_, and returns the join of the kelvin plan.
+  JoinIR* PlanTimeJoin(const std::string& physical_state_txt) {
+    table_store::schema::Relation relation({types::TIME64NS, types::INT64, types::UINT128},
+                                           {"time_", "cpu_cycles", "upid"});
+    compiler_state_->relation_map()->emplace("table", relation);
+    auto join = MakeJoin({MakeMemSource("table", relation), MakeMemSource("table", relation)},
+                         "inner", relation, relation, {"time_"}, {"time_"}, {"_x", "_y"});
+    MakeMemSink(join, "out");
+
+    ResolveTypesRule rule(compiler_state_.get());
+    EXPECT_OK(rule.Execute(graph.get()));
+
+    distributedpb::DistributedState ps_pb = LoadDistributedStatePb(physical_state_txt);
+    std::unique_ptr<DistributedPlanner> physical_planner =
+        DistributedPlanner::Create().ConsumeValueOrDie();
+    physical_plan_ =
+        physical_planner->Plan(ps_pb, compiler_state_.get(), graph.get()).ConsumeValueOrDie();
+
+    std::vector<IRNode*> joins = physical_plan_->Get(0)->plan()->FindNodesOfType(IRNodeType::kJoin);
+    if (joins.size() != 1) {
+      return nullptr;
+    }
+    return static_cast<JoinIR*>(joins[0]);
+  }
+
+  std::unique_ptr<DistributedPlan> physical_plan_;
 };
 
 TEST_F(DistributedPlannerTest, one_pem_one_kelvin) {
@@ -213,6 +241,20 @@ TEST_F(DistributedPlannerTest, three_agents_one_kelvin) {
   EXPECT_THAT(grpc_sink_destinations, UnorderedElementsAreArray(grpc_source_ids));
 }
 
+// Joins on time_ run on the kelvin after the split, where the inputs are GRPC sources (and unions
+// of them) that interleave the rows of the PEMs, so they must keep hashing.
+TEST_F(DistributedPlannerTest, time_join_one_pem_keeps_hash_join) {
+  JoinIR* join = PlanTimeJoin(kOnePEMOneKelvinDistributedState);
+  ASSERT_NE(join, nullptr);
+  EXPECT_FALSE(join->sort_merge());
+}
+
+TEST_F(DistributedPlannerTest, time_join_three_pems_keeps_hash_join) {
+  JoinIR* join = PlanTimeJoin(kThreePEMsOneKelvinDistributedState);
+  ASSERT_NE(join, nullptr);
+  EXPECT_FALSE(join->sort_merge());
+}
+
 using DistributedPlannerUDTFTests = DistributedRulesTest;
 TEST_F(DistributedPlannerUDTFTests, UDTFOnlyOnPEMsDoesntRunOnKelvin) {
   uint32_t asid = 123;
@@ -0,0 +1,109 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/distributed/select_join_algorithm_rule.h"
+
+#include <memory>
+
+#include "src/carnot/planner/ir/map_ir.h"
+#include "src/carnot/planner/ir/memory_source_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+namespace {
+
+// Returns whether the time_ column of the operator is in the order of the table it was read from.
+// The rows of GRPC sources and unions come from several agents, so they are never sorted.
+bool PreservesTimeOrder(OperatorIR* op) {
+  while (true) {
+    if (Match(op, MemorySource())) {
+      return !static_cast<MemorySourceIR*>(op)->streaming();
+    }
+    if (Match(op, Map())) {
+      auto map = static_cast<MapIR*>(op);
+      bool passes_time = map->keep_input_columns();
+      for (const auto& expr : map->col_exprs()) {
+        if (expr.name == "time_") {
+          passes_time = Match(expr.node, ColumnNode()) &&
+                        static_cast<ColumnIR*>(expr.node)->col_name() == "time_";
+        }
+      }
+      if (!passes_time) {
+        return false;
+      }
+    } else if (!Match(op, Filter()) && !Match(op, Limit())) {
+      return false;
+    }
+    op = op->parents()[0];
+  }
+}
+
+// Returns the type of a join key, which is the type of the column in its parent.
+StatusOr<types::DataType> KeyType(JoinIR* join, ColumnIR* key) {
+  auto parent = join->parents()[key->container_op_parent_idx()];
+  PL_ASSIGN_OR_RETURN(auto type, parent->resolved_table_type()->GetColumnType(key->col_name()));
+  return std::static_pointer_cast<ValueType>(type)->data_type();
+}
+
+}  // namespace
+
+StatusOr<bool> SelectJoinAlgorithmRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Join())) {
+    return false;
+  }
+  auto join = static_cast<JoinIR*>(ir_node);
+  if (join->sort_merge()) {
+    return false;
+  }
+  // Outer joins would have to emit the unmatched rows of both inputs, so they still hash.
+  if (join->join_type() != JoinIR::JoinType::kInner &&
+      join->join_type() != JoinIR::JoinType::kLeft) {
+    return false;
+  }
+  DCHECK_EQ(join->parents().size(), 2UL);
+  if (!join->parents()[0]->is_type_resolved() || !join->parents()[1]->is_type_resolved()) {
+    return false;
+  }
+
+  // The join merges on the first pair of time columns, which must be the sorted time_ columns.
+  const auto& left_on = join->left_on_columns();
+  const auto& right_on = join->right_on_columns();
+  for (size_t i = 0; i < left_on.size(); ++i) {
+    PL_ASSIGN_OR_RETURN(auto type, KeyType(join, left_on[i]));
+    if (type != types::TIME64NS) {
+      continue;
+    }
+    if (left_on[i]->col_name() != "time_" || right_on[i]->col_name() != "time_") {
+      return false;
+    }
+    if (!PreservesTimeOrder(join->parents()[0]) || !PreservesTimeOrder(join->parents()[1])) {
+      return false;
+    }
+    join->set_sort_merge(true);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+/**
+ * @brief SelectJoinAlgorithmRule makes inner and left joins on the time_ columns of two tables
+ * merge their inputs instead of hashing one of them, when both inputs still come out of the
+ * tables sorted by time.
+ *
+ * The rule runs on the plans of the distributed plan, after the split, because only then is it
+ * known where the inputs come from. The inputs are sorted when the only operators between the
+ * join and its (non streaming) memory sources are filters, limits and maps that pass time_
+ * through unchanged. Inputs from GRPC sources or unions interleave the rows of several agents,
+ * so those joins keep hashing.
+ */
+class SelectJoinAlgorithmRule : public Rule {
+ public:
+  SelectJoinAlgorithmRule()
+      : Rule(nullptr, /*use_topo*/ false, /*reverse_topological_execution*/ false) {}
+
+ protected:
+  StatusOr<bool> Apply(IRNode* ir_node) override;
+};
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
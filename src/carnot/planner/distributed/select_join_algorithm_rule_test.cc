@@ -0,0 +1,138 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+#include "src/carnot/planner/distributed/select_join_algorithm_rule.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+using compiler::ResolveTypesRule;
+using table_store::schema::Relation;
+
+class SelectJoinAlgorithmRuleTest : public RulesTest {
+ protected:
+  void SetUpImpl() override {
+    RulesTest::SetUpImpl();
+    relation0 = Relation({types::TIME64NS, types::INT64, types::INT64}, {"time_", "upid", "col1"});
+    relation1 = Relation({types::TIME64NS, types::INT64, types::INT64}, {"time_", "upid", "col2"});
+    compiler_state_->relation_map()->emplace("source0", relation0);
+    compiler_state_->relation_map()->emplace("source1", relation1);
+    mem_src0 = MakeMemSource("source0", relation0);
+    mem_src1 = MakeMemSource("source1", relation1);
+  }
+
+  JoinIR* MakeTestJoin(OperatorIR* left, OperatorIR* right, const std::string& join_type,
+                       const std::vector<std::string>& on_cols) {
+    auto join =
+        MakeJoin({left, right}, join_type, relation0, relation1, on_cols, on_cols, {"_x", "_y"});
+    MakeMemSink(join, "out");
+    ResolveTypesRule type_rule(compiler_state_.get());
+    EXPECT_OK(type_rule.Execute(graph.get()));
+    return join;
+  }
+
+  bool ApplyRule() {
+    SelectJoinAlgorithmRule rule;
+    auto result = rule.Execute(graph.get());
+    EXPECT_OK(result);
+    return result.ConsumeValueOrDie();
+  }
+
+  Relation relation0;
+  Relation relation1;
+  MemorySourceIR* mem_src0;
+  MemorySourceIR* mem_src1;
+};
+
+TEST_F(SelectJoinAlgorithmRuleTest, time_aligned_tables) {
+  auto join = MakeTestJoin(mem_src0, mem_src1, "inner", {"upid", "time_"});
+
+  EXPECT_TRUE(ApplyRule());
+  EXPECT_TRUE(join->sort_merge());
+
+  planpb::Operator pb;
+  ASSERT_OK(join->ToProto(&pb));
+  EXPECT_TRUE(pb.join_op().sort_merge());
+
+  // Running the rule again leaves the join as is.
+  EXPECT_FALSE(ApplyRule());
+}
+
+TEST_F(SelectJoinAlgorithmRuleTest, order_preserving_parents) {
+  auto filter = MakeFilter(mem_src0, MakeEqualsFunc(MakeColumn("upid", 0), MakeInt(1)));
+  auto map = MakeMap(mem_src1,
+                     {{"time_", MakeColumn("time_", 0)},
+                      {"upid", MakeColumn("upid", 0)},
+                      {"col2", MakeColumn("col2", 0)}});
+  auto join = MakeTestJoin(filter, MakeLimit(map, 10), "left", {"time_", "upid"});
+
+  EXPECT_TRUE(ApplyRule());
+  EXPECT_TRUE(join->sort_merge());
+}
+
+TEST_F(SelectJoinAlgorithmRuleTest, time_rewritten) {
+  auto map = MakeMap(mem_src1, {{"time_", MakeColumn("col2", 0)}}, /* keep_input_columns */ true);
+  auto join = MakeTestJoin(mem_src0, map, "inner", {"time_"});
+
+  EXPECT_FALSE(ApplyRule());
+  EXPECT_FALSE(join->sort_merge());
+}
+
+TEST_F(SelectJoinAlgorithmRuleTest, outer_join) {
+  auto join = MakeTestJoin(mem_src0, mem_src1, "outer", {"time_"});
+
+  EXPECT_FALSE(ApplyRule());
+  EXPECT_FALSE(join->sort_merge());
+}
+
+TEST_F(SelectJoinAlgorithmRuleTest, no_time_key) {
+  auto join = MakeTestJoin(mem_src0, mem_src1, "inner", {"upid"});
+
+  EXPECT_FALSE(ApplyRule());
+  EXPECT_FALSE(join->sort_merge());
+}
+
+TEST_F(SelectJoinAlgorithmRuleTest, streaming_source) {
+  mem_src1->set_streaming(true);
+  auto join = MakeTestJoin(mem_src0, mem_src1, "inner", {"time_"});
+
+  EXPECT_FALSE(ApplyRule());
+  EXPECT_FALSE(join->sort_merge());
+}
+
+TEST_F(SelectJoinAlgorithmRuleTest, union_input) {
+  auto union_node = MakeUnion({mem_src1, MakeMemSource("source1", relation1)});
+  auto join = MakeTestJoin(mem_src0, union_node, "inner", {"time_"});
+
+  EXPECT_FALSE(ApplyRule());
+  EXPECT_FALSE(join->sort_merge());
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
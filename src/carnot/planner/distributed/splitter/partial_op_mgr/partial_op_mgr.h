@@ -98,6 +98,10 @@ class AggOperatorMgr : public PartialOperatorMgr {
       return false;
     }
     BlockingAggIR* agg = static_cast<BlockingAggIR*>(op);
+    // Sliding windows keep per-pane state that isn't serialized, so they can't be split.
+    if (agg->sliding_window()) {
+      return false;
+    }
     for (const auto& col_expr : agg->aggregate_expressions()) {
       if (!Match(col_expr.node, PartialUDA())) {
         return false;
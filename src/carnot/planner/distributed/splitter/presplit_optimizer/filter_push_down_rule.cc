@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <queue>
+#include <utility>
 
 #include "src/carnot/planner/distributed/splitter/executor_utils.h"
 #include "src/carnot/planner/distributed/splitter/presplit_optimizer/filter_push_down_rule.h"
@@ -83,15 +84,74 @@ OperatorIR* FilterPushdownRule::HandleAggPushdown(BlockingAggIR* agg,
   return agg;
 }
 
-// Currently only supports single-parent, single-child operators.
+OperatorIR* FilterPushdownRule::HandleJoinPushdown(JoinIR* join,
+                                                   ColumnNameMapping* column_name_mapping,
+                                                   int64_t* parent_idx) {
+  ColumnNameMapping reverse_column_name_mapping;
+  for (const auto& [old_name, cur_name] : *column_name_mapping) {
+    reverse_column_name_mapping[cur_name] = old_name;
+  }
+
+  // All of the filter columns must come from the same parent of the join.
+  int64_t filter_parent_idx = -1;
+  for (const auto& [idx, col_name] : Enumerate(join->column_names())) {
+    if (!reverse_column_name_mapping.contains(col_name)) {
+      continue;
+    }
+    int64_t col_parent_idx = join->output_columns()[idx]->container_op_parent_idx();
+    if (filter_parent_idx != -1 && filter_parent_idx != col_parent_idx) {
+      return nullptr;
+    }
+    filter_parent_idx = col_parent_idx;
+  }
+  if (filter_parent_idx == -1) {
+    return nullptr;
+  }
+
+  // Filtering a parent before the join only matches filtering after it for the parents whose
+  // unmatched rows are dropped. Otherwise the filter would also have to drop the rows that the
+  // join emits for the unmatched rows of the other parent.
+  switch (join->join_type()) {
+    case JoinIR::JoinType::kInner:
+      break;
+    case JoinIR::JoinType::kLeft:
+      if (filter_parent_idx != 0) {
+        return nullptr;
+      }
+      break;
+    case JoinIR::JoinType::kRight:
+      if (filter_parent_idx != 1) {
+        return nullptr;
+      }
+      break;
+    case JoinIR::JoinType::kOuter:
+      return nullptr;
+  }
+
+  // The join renames the columns that get a suffix.
+  for (const auto& [idx, col_name] : Enumerate(join->column_names())) {
+    if (!reverse_column_name_mapping.contains(col_name)) {
+      continue;
+    }
+    ColumnIR* column = join->output_columns()[idx];
+    if (col_name != column->col_name()) {
+      auto eventual_col_name = reverse_column_name_mapping.at(col_name);
+      (*column_name_mapping)[eventual_col_name] = column->col_name();
+    }
+  }
+  *parent_idx = filter_parent_idx;
+  return join;
+}
+
+// Currently supports single-child operators, and joins in addition to single-parent operators.
 StatusOr<OperatorIR*> FilterPushdownRule::NextFilterLocation(
-    OperatorIR* current_node, bool filter_has_kelvin_only_udf,
+    OperatorIR* current_node, int64_t* parent_idx, bool filter_has_kelvin_only_udf,
     ColumnNameMapping* column_name_mapping) {
-  if (current_node->parents().size() != 1) {
+  if (*parent_idx >= static_cast<int64_t>(current_node->parents().size())) {
     return nullptr;
   }
 
-  OperatorIR* parent = current_node->parents()[0];
+  OperatorIR* parent = current_node->parents()[*parent_idx];
   if (parent->Children().size() > 1) {
     return nullptr;
   }
@@ -106,6 +166,13 @@ StatusOr<OperatorIR*> FilterPushdownRule::NextFilterLocation(
   if (parent_has_pem_only_udf && filter_has_kelvin_only_udf) {
     return nullptr;
   }
+  if (Match(parent, Join())) {
+    return HandleJoinPushdown(static_cast<JoinIR*>(parent), column_name_mapping, parent_idx);
+  }
+  if (parent->parents().size() != 1) {
+    return nullptr;
+  }
+  *parent_idx = 0;
   if (Match(parent, Filter()) || Match(parent, Limit())) {
     return parent;
   }
@@ -150,14 +217,22 @@ StatusOr<bool> FilterPushdownRule::Apply(IRNode* ir_node) {
       HasFuncWithExecutor(compiler_state_, filter, udfspb::UDFSourceExecutor::UDF_KELVIN));
 
   // Iterate up from the current node, stopping when we reach the earliest allowable
-  // new location for the filter node.
+  // new location for the filter node, which is between current_node and its parent at
+  // current_parent_idx.
+  int64_t current_parent_idx = 0;
   while (true) {
+    // The mapping and parent index are only updated when the filter can move.
+    auto next_column_name_mapping = column_name_mapping;
+    int64_t next_parent_idx = current_parent_idx;
     PL_ASSIGN_OR_RETURN(OperatorIR * next_parent,
-                        NextFilterLocation(current_node, kelvin_only_filter, &column_name_mapping));
+                        NextFilterLocation(current_node, &next_parent_idx, kelvin_only_filter,
+                                           &next_column_name_mapping));
     if (next_parent == nullptr) {
       break;
     }
     current_node = next_parent;
+    current_parent_idx = next_parent_idx;
+    column_name_mapping = std::move(next_column_name_mapping);
   }
   // If the current_node is filter, that means we could not find a better filter location and will
   // not change.
@@ -176,8 +251,7 @@ StatusOr<bool> FilterPushdownRule::Apply(IRNode* ir_node) {
   }
   PL_RETURN_IF_ERROR(filter->RemoveParent(filter_parent));
 
-  DCHECK_EQ(1, current_node->parents().size());
-  auto new_filter_parent = current_node->parents()[0];
+  auto new_filter_parent = current_node->parents()[current_parent_idx];
   PL_RETURN_IF_ERROR(filter->AddParent(new_filter_parent));
   PL_RETURN_IF_ERROR(current_node->ReplaceParent(new_filter_parent, filter));
   PL_RETURN_IF_ERROR(filter->SetResolvedType(new_filter_parent->resolved_type()));
@@ -19,6 +19,7 @@
 #pragma once
 
 #include "src/carnot/planner/ir/blocking_agg_ir.h"
+#include "src/carnot/planner/ir/join_ir.h"
 #include "src/carnot/planner/ir/map_ir.h"
 #include "src/carnot/planner/rules/rules.h"
 
@@ -32,6 +33,10 @@ namespace distributed {
  * It must run after OperatorRelationRule so that it has full context on all of the column
  * names that exist in the IR.
  *
+ * Filters move above maps and aggs that don't compute the filtered columns, and above joins into
+ * the parent that all of the filtered columns come from, when the join type allows it. Since joins
+ * run on Kelvin, this moves those filters to the PEMs, before the rows are sent over the network.
+ *
  */
 class FilterPushdownRule : public Rule {
  public:
@@ -45,7 +50,13 @@ class FilterPushdownRule : public Rule {
   using ColumnNameMapping = absl::flat_hash_map<std::string, std::string>;
   OperatorIR* HandleAggPushdown(BlockingAggIR* map, ColumnNameMapping* column_name_mapping);
   OperatorIR* HandleMapPushdown(MapIR* map, ColumnNameMapping* column_name_mapping);
-  StatusOr<OperatorIR*> NextFilterLocation(OperatorIR* current_node, bool kelvin_only_filter,
+  OperatorIR* HandleJoinPushdown(JoinIR* join, ColumnNameMapping* column_name_mapping,
+                                 int64_t* parent_idx);
+  // Returns the operator that the filter can be moved above, from between current_node and its
+  // parent at parent_idx, and updates parent_idx to the parent of that operator to keep moving
+  // toward. Returns nullptr when the filter can't move any further.
+  StatusOr<OperatorIR*> NextFilterLocation(OperatorIR* current_node, int64_t* parent_idx,
+                                           bool kelvin_only_filter,
                                            ColumnNameMapping* column_name_mapping);
   Status UpdateFilter(FilterIR* expr, const ColumnNameMapping& column_name_mapping);
 };
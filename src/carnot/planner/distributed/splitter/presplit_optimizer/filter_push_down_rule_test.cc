@@ -18,6 +18,7 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
 #include <vector>
 
 #include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
@@ -446,6 +447,116 @@ TEST_F(FilterPushDownTest, kelvin_only_filter) {
   EXPECT_THAT(map2->parents()[0]->parents(), ElementsAre(map1));
 }
 
+class FilterPushDownJoinTest : public FilterPushDownTest {
+ protected:
+  // Joins source0 (left_only, col1) with source1 (right_only, col2) on col1 == col2, then filters
+  // the output of the join on the given column.
+  void MakeJoinGraph(const std::string& join_type, const std::string& filter_col) {
+    Relation relation0({types::DataType::INT64, types::DataType::INT64}, {"left_only", "col1"});
+    Relation relation1({types::DataType::INT64, types::DataType::INT64}, {"right_only", "col1"});
+    src0 = MakeMemSource("source0", relation0);
+    compiler_state_->relation_map()->emplace("source0", relation0);
+    src1 = MakeMemSource("source1", relation1);
+    compiler_state_->relation_map()->emplace("source1", relation1);
+    join = MakeJoin({src0, src1}, join_type, relation0, relation1,
+                    std::vector<std::string>{"col1"}, std::vector<std::string>{"col1"},
+                    {"", "_right"});
+    filter = MakeFilter(join, MakeEqualsFunc(MakeColumn(filter_col, 0), MakeInt(2)));
+    sink = MakeMemSink(filter, "foo", {});
+
+    ResolveTypesRule type_rule(compiler_state_.get());
+    ASSERT_OK(type_rule.Execute(graph.get()));
+  }
+
+  MemorySourceIR* src0;
+  MemorySourceIR* src1;
+  JoinIR* join;
+  FilterIR* filter;
+  MemorySinkIR* sink;
+};
+
+TEST_F(FilterPushDownJoinTest, inner_join_left_column) {
+  MakeJoinGraph("inner", "left_only");
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+
+  EXPECT_THAT(sink->parents(), ElementsAre(join));
+  EXPECT_THAT(join->parents(), ElementsAre(filter, src1));
+  EXPECT_THAT(filter->parents(), ElementsAre(src0));
+  EXPECT_MATCH(filter->filter_expr(), Equals(ColumnNode("left_only"), Int(2)));
+}
+
+TEST_F(FilterPushDownJoinTest, inner_join_renamed_right_column) {
+  MakeJoinGraph("inner", "col1_right");
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+
+  EXPECT_THAT(sink->parents(), ElementsAre(join));
+  EXPECT_THAT(join->parents(), ElementsAre(src0, filter));
+  EXPECT_THAT(filter->parents(), ElementsAre(src1));
+  // The suffix is removed, since the filter now reads the right parent directly.
+  EXPECT_MATCH(filter->filter_expr(), Equals(ColumnNode("col1"), Int(2)));
+}
+
+TEST_F(FilterPushDownJoinTest, left_join_left_column) {
+  MakeJoinGraph("left", "left_only");
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  EXPECT_THAT(join->parents(), ElementsAre(filter, src1));
+}
+
+TEST_F(FilterPushDownJoinTest, left_join_right_column_no_push) {
+  // The join emits the unmatched left rows with default right values, which the filter must see.
+  MakeJoinGraph("left", "right_only");
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_THAT(filter->parents(), ElementsAre(join));
+}
+
+TEST_F(FilterPushDownJoinTest, outer_join_no_push) {
+  MakeJoinGraph("outer", "left_only");
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_THAT(filter->parents(), ElementsAre(join));
+}
+
+TEST_F(FilterPushDownJoinTest, columns_from_both_parents_no_push) {
+  Relation relation0({types::DataType::INT64, types::DataType::INT64}, {"left_only", "col1"});
+  Relation relation1({types::DataType::INT64, types::DataType::INT64}, {"right_only", "col1"});
+  src0 = MakeMemSource("source0", relation0);
+  compiler_state_->relation_map()->emplace("source0", relation0);
+  src1 = MakeMemSource("source1", relation1);
+  compiler_state_->relation_map()->emplace("source1", relation1);
+  join = MakeJoin({src0, src1}, "inner", relation0, relation1, std::vector<std::string>{"col1"},
+                  std::vector<std::string>{"col1"}, {"", "_right"});
+  filter =
+      MakeFilter(join, MakeEqualsFunc(MakeColumn("left_only", 0), MakeColumn("right_only", 0)));
+  MakeMemSink(filter, "foo", {});
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  FilterPushdownRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_THAT(filter->parents(), ElementsAre(join));
+}
+
 }  // namespace distributed
 }  // namespace planner
 }  // namespace carnot
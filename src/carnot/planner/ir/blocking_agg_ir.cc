@@ -51,6 +51,21 @@ Status BlockingAggIR::SetAggExprs(const ColExpressionVector& agg_exprs) {
   return Status::OK();
 }
 
+Status BlockingAggIR::SetSlidingWindow(ColumnIR* window_col, int64_t window_size_ns,
+                                       int64_t window_pane_ns) {
+  ColumnIR* old_window_col = window_col_;
+  if (old_window_col != nullptr) {
+    PL_RETURN_IF_ERROR(graph()->DeleteEdge(this, old_window_col));
+  }
+  PL_ASSIGN_OR_RETURN(window_col_, graph()->OptionallyCloneWithEdge(this, window_col));
+  if (old_window_col != nullptr) {
+    PL_RETURN_IF_ERROR(graph()->DeleteOrphansInSubtree(old_window_col->id()));
+  }
+  window_size_ns_ = window_size_ns;
+  window_pane_ns_ = window_pane_ns;
+  return Status::OK();
+}
+
 StatusOr<std::vector<absl::flat_hash_set<std::string>>> BlockingAggIR::RequiredInputColumns()
     const {
   absl::flat_hash_set<std::string> required;
@@ -61,6 +76,9 @@ StatusOr<std::vector<absl::flat_hash_set<std::string>>> BlockingAggIR::RequiredI
     PL_ASSIGN_OR_RETURN(auto ret, agg_expr.node->InputColumnNames());
     required.insert(ret.begin(), ret.end());
   }
+  if (window_col_ != nullptr) {
+    required.insert(window_col_->col_name());
+  }
   return std::vector<absl::flat_hash_set<std::string>>{required};
 }
 
@@ -125,6 +143,13 @@ Status BlockingAggIR::ToProto(planpb::Operator* op) const {
   }
 
   pb->set_windowed(false);
+  if (window_col_ != nullptr) {
+    pb->set_windowed(true);
+    pb->set_window_size_ns(window_size_ns_);
+    pb->set_window_pane_ns(window_pane_ns_);
+    PL_ASSIGN_OR_RETURN(int64_t window_time_column_index, window_col_->GetColumnIndex());
+    pb->set_window_time_column_index(window_time_column_index);
+  }
   pb->set_partial_agg(partial_agg_);
   pb->set_finalize_results(finalize_results_);
 
@@ -156,6 +181,13 @@ Status BlockingAggIR::CopyFromNodeImpl(
   partial_agg_ = blocking_agg->partial_agg_;
   pre_split_proto_ = blocking_agg->pre_split_proto_;
 
+  if (blocking_agg->window_col_ != nullptr) {
+    PL_ASSIGN_OR_RETURN(ColumnIR * new_window_col,
+                        graph()->CopyNode(blocking_agg->window_col_, copied_nodes_map));
+    PL_RETURN_IF_ERROR(SetSlidingWindow(new_window_col, blocking_agg->window_size_ns_,
+                                        blocking_agg->window_pane_ns_));
+  }
+
   return Status::OK();
 }
 
@@ -170,6 +202,9 @@ Status BlockingAggIR::ResolveType(CompilerState* compiler_state) {
     PL_RETURN_IF_ERROR(ResolveExpressionType(col_expr.node, compiler_state, parent_types()));
     new_table->AddColumn(col_expr.name, col_expr.node->resolved_type());
   }
+  if (window_col_ != nullptr) {
+    PL_RETURN_IF_ERROR(ResolveExpressionType(window_col_, compiler_state, parent_types()));
+  }
   return SetResolvedType(new_table);
 }
 
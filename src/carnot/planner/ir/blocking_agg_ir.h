@@ -75,6 +75,16 @@ class BlockingAggIR : public GroupAcceptorIR {
     pre_split_proto_ = pre_split_proto;
   }
 
+  /**
+   * @brief Turns this into a sliding window aggregate that emits the aggregate of the last
+   * window_size_ns of data, as ordered by window_col, and updates it in panes of window_pane_ns.
+   */
+  Status SetSlidingWindow(ColumnIR* window_col, int64_t window_size_ns, int64_t window_pane_ns);
+  bool sliding_window() const { return window_col_ != nullptr; }
+  ColumnIR* window_col() const { return window_col_; }
+  int64_t window_size_ns() const { return window_size_ns_; }
+  int64_t window_pane_ns() const { return window_pane_ns_; }
+
  protected:
   StatusOr<absl::flat_hash_set<std::string>> PruneOutputColumnsToImpl(
       const absl::flat_hash_set<std::string>& output_colnames) override;
@@ -87,6 +97,10 @@ class BlockingAggIR : public GroupAcceptorIR {
   // Whether this finalizes the result of a partial aggregate.
   bool finalize_results_ = true;
   planpb::AggregateOperator pre_split_proto_;
+  // The time column and window of a sliding window aggregate. Unset for batch aggregates.
+  ColumnIR* window_col_ = nullptr;
+  int64_t window_size_ns_ = 0;
+  int64_t window_pane_ns_ = 0;
 };
 }  // namespace planner
 }  // namespace carnot
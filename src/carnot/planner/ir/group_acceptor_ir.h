@@ -45,11 +45,17 @@ class GroupAcceptorIR : public OperatorIR {
   bool group_by_all() const { return groups_.size() == 0; }
 
   Status SetGroups(const std::vector<ColumnIR*>& new_groups) {
-    DCHECK(groups_.empty());
+    auto old_groups = groups_;
+    for (ColumnIR* old_group : old_groups) {
+      PL_RETURN_IF_ERROR(graph()->DeleteEdge(this, old_group));
+    }
     groups_.resize(new_groups.size());
     for (size_t i = 0; i < new_groups.size(); ++i) {
       PL_ASSIGN_OR_RETURN(groups_[i], graph()->OptionallyCloneWithEdge(this, new_groups[i]));
     }
+    for (ColumnIR* old_group : old_groups) {
+      PL_RETURN_IF_ERROR(graph()->DeleteOrphansInSubtree(old_group->id()));
+    }
     return Status::OK();
   }
 
@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <map>
+#include <utility>
 
 #include "src/carnot/planner/ir/column_ir.h"
 #include "src/carnot/planner/ir/ir.h"
@@ -51,6 +52,7 @@ Status JoinIR::CopyFromNodeImpl(const IRNode* node,
 
   PL_RETURN_IF_ERROR(SetJoinColumns(new_left_columns, new_right_columns));
   suffix_strs_ = join_node->suffix_strs_;
+  sort_merge_ = join_node->sort_merge_;
   return Status::OK();
 }
 
@@ -111,6 +113,7 @@ Status JoinIR::ToProto(planpb::Operator* op) const {
   for (const auto& col_name : column_names_) {
     *(pb->add_column_names()) = col_name;
   }
+  pb->set_sort_merge(sort_merge_);
   // NOTE: not setting value as this is set in the execution engine. Keeping this here in case it
   // needs to be modified in the future.
   // pb->set_rows_per_batch(1024);
@@ -304,6 +307,38 @@ Status JoinIR::UpdateOpAfterParentTypesResolvedImpl() {
   return SetOutputColumns(output_column_names, output_columns);
 }
 
+Status JoinIR::SwapParents() {
+  DCHECK_EQ(parents().size(), 2UL);
+  DCHECK(join_type_ == JoinType::kInner || join_type_ == JoinType::kOuter);
+  std::vector<OperatorIR*> old_parents = parents();
+  for (OperatorIR* parent : old_parents) {
+    PL_RETURN_IF_ERROR(RemoveParent(parent));
+  }
+  PL_RETURN_IF_ERROR(AddParent(old_parents[1]));
+  PL_RETURN_IF_ERROR(AddParent(old_parents[0]));
+
+  for (const auto& columns : {left_on_columns_, right_on_columns_, output_columns_}) {
+    for (ColumnIR* col : columns) {
+      col->SetContainingOperatorParentIdx(1 - col->container_op_parent_idx());
+    }
+  }
+  std::swap(left_on_columns_, right_on_columns_);
+  if (suffix_strs_.size() == 2) {
+    std::swap(suffix_strs_[0], suffix_strs_[1]);
+  }
+  // The suffixes and the user facing left/right sides follow the parents.
+  specified_as_right_ = !specified_as_right_;
+
+  // The output type is unchanged, but the parent types must follow the parents.
+  if (is_type_resolved()) {
+    auto type = resolved_type();
+    ClearResolvedType();
+    PullParentTypes();
+    PL_RETURN_IF_ERROR(SetResolvedType(type));
+  }
+  return Status::OK();
+}
+
 Status JoinIR::ResolveType(CompilerState* compiler_state) {
   DCHECK_EQ(2, parent_types().size());
   auto new_table = TableType::Create();
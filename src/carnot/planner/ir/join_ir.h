@@ -89,6 +89,16 @@ class JoinIR : public OperatorIR {
   Status SetOutputColumns(const std::vector<std::string>& column_names,
                           const std::vector<ColumnIR*>& columns);
   bool specified_as_right() const { return specified_as_right_; }
+  // Whether both parents are sorted by the time join columns, so the join merges them.
+  bool sort_merge() const { return sort_merge_; }
+  void set_sort_merge(bool sort_merge) { sort_merge_ = sort_merge; }
+
+  /**
+   * @brief Swaps the two parents of the join, updating the join and output columns to match. The
+   * output of the join is unchanged, so this is only valid for the join types that treat both
+   * parents the same.
+   */
+  Status SwapParents();
 
   StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override;
 
@@ -161,6 +171,7 @@ class JoinIR : public OperatorIR {
   // Whether this join was originally specified as a right join.
   // Used because we transform left joins into right joins but need to do some back transform.
   bool specified_as_right_ = false;
+  bool sort_merge_ = false;
 };
 
 }  // namespace planner
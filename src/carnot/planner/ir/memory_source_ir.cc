@@ -61,6 +61,7 @@ Status MemorySourceIR::ToProto(planpb::Operator* op) const {
   }
 
   pb->set_streaming(streaming());
+  pb->set_refresh_interval_ns(refresh_interval_ns_);
   return Status::OK();
 }
 
@@ -135,6 +136,7 @@ Status MemorySourceIR::CopyFromNodeImpl(
   column_index_map_ = source_ir->column_index_map_;
   has_time_expressions_ = source_ir->has_time_expressions_;
   streaming_ = source_ir->streaming_;
+  refresh_interval_ns_ = source_ir->refresh_interval_ns_;
 
   if (has_time_expressions_) {
     PL_ASSIGN_OR_RETURN(ExpressionIR * new_start_expr,
@@ -61,6 +61,13 @@ class MemorySourceIR : public OperatorIR {
   bool streaming() const { return streaming_; }
   void set_streaming(bool streaming) { streaming_ = streaming; }
 
+  // For streaming sources, how often windowed operators downstream should refresh their results.
+  // 0 never refreshes.
+  int64_t refresh_interval_ns() const { return refresh_interval_ns_; }
+  void set_refresh_interval_ns(int64_t refresh_interval_ns) {
+    refresh_interval_ns_ = refresh_interval_ns;
+  }
+
   Status SetTimeExpressions(ExpressionIR* start_time_expr, ExpressionIR* end_time_expr);
 
   // Sets the time expressions that eventually get converted
@@ -128,6 +135,7 @@ class MemorySourceIR : public OperatorIR {
  private:
   std::string table_name_;
   bool streaming_ = false;
+  int64_t refresh_interval_ns_ = 0;
 
   bool has_time_expressions_ = false;
   ExpressionIR* start_time_expr_ = nullptr;
@@ -24,10 +24,12 @@ namespace px {
 namespace carnot {
 namespace planner {
 
-Status RollingIR::Init(OperatorIR* parent, ColumnIR* window_col, ExpressionIR* window_size) {
+Status RollingIR::Init(OperatorIR* parent, ColumnIR* window_col, ExpressionIR* window_size,
+                       ExpressionIR* every) {
   PL_RETURN_IF_ERROR(AddParent(parent));
   PL_RETURN_IF_ERROR(SetWindowCol(window_col));
   PL_RETURN_IF_ERROR(SetWindowSize(window_size));
+  PL_RETURN_IF_ERROR(SetEvery(every));
   return Status::OK();
 }
 
@@ -48,6 +50,19 @@ Status RollingIR::ReplaceWindowSize(ExpressionIR* new_window_size) {
   return Status::OK();
 }
 
+Status RollingIR::SetEvery(ExpressionIR* every) {
+  PL_ASSIGN_OR_RETURN(every_, graph()->OptionallyCloneWithEdge(this, every));
+  return Status::OK();
+}
+
+Status RollingIR::ReplaceEvery(ExpressionIR* new_every) {
+  if (new_every->id() == every_->id()) {
+    return Status::OK();
+  }
+  PL_RETURN_IF_ERROR(graph()->DeleteNode(every_->id()));
+  return SetEvery(new_every);
+}
+
 Status RollingIR::SetWindowCol(ColumnIR* window_col) {
   PL_ASSIGN_OR_RETURN(window_col_, graph()->OptionallyCloneWithEdge(this, window_col));
   return Status::OK();
@@ -64,6 +79,10 @@ Status RollingIR::CopyFromNodeImpl(const IRNode* source,
                       graph()->CopyNode(rolling_node->window_size(), copied_nodes_map));
   DCHECK(Match(new_window_size, DataNode()));
   PL_RETURN_IF_ERROR(SetWindowSize(static_cast<DataIR*>(new_window_size)));
+  PL_ASSIGN_OR_RETURN(IRNode * new_every,
+                      graph()->CopyNode(rolling_node->every(), copied_nodes_map));
+  DCHECK(Match(new_every, DataNode()));
+  PL_RETURN_IF_ERROR(SetEvery(static_cast<DataIR*>(new_every)));
   std::vector<ColumnIR*> new_groups;
   for (const ColumnIR* column : rolling_node->groups()) {
     PL_ASSIGN_OR_RETURN(ColumnIR * new_column, graph()->CopyNode(column, copied_nodes_map));
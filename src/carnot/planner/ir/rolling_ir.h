@@ -45,17 +45,21 @@ class RollingIR : public GroupAcceptorIR {
  public:
   RollingIR() = delete;
   explicit RollingIR(int64_t id) : GroupAcceptorIR(id, IRNodeType::kRolling) {}
-  Status Init(OperatorIR* parent, ColumnIR* window_col, ExpressionIR* window_size);
+  Status Init(OperatorIR* parent, ColumnIR* window_col, ExpressionIR* window_size,
+              ExpressionIR* every);
 
   Status ToProto(planpb::Operator*) const override;
   ColumnIR* window_col() const { return window_col_; }
   ExpressionIR* window_size() const { return window_size_; }
+  // How often the window's aggregate is emitted. A value of 0 emits once per window_size.
+  ExpressionIR* every() const { return every_; }
 
   Status CopyFromNodeImpl(const IRNode* source,
                           absl::flat_hash_map<const IRNode*, IRNode*>* copied_nodes_map) override;
 
   StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override;
   Status ReplaceWindowSize(ExpressionIR* new_window_size);
+  Status ReplaceEvery(ExpressionIR* new_every);
 
  protected:
   StatusOr<absl::flat_hash_set<std::string>> PruneOutputColumnsToImpl(
@@ -64,9 +68,11 @@ class RollingIR : public GroupAcceptorIR {
  private:
   Status SetWindowCol(ColumnIR* window_col);
   Status SetWindowSize(ExpressionIR* window_size);
+  Status SetEvery(ExpressionIR* every);
 
   ColumnIR* window_col_;
   ExpressionIR* window_size_;
+  ExpressionIR* every_;
 };
 }  // namespace planner
 }  // namespace carnot
@@ -18,10 +18,15 @@
 
 #include "src/carnot/planner/logical_planner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "src/shared/scriptspb/scripts.pb.h"
 
+DEFINE_int32(planner_plan_cache_size, gflags::Int32FromEnv("PL_PLANNER_PLAN_CACHE_SIZE", 64),
+             "The number of scripts whose distributed plans are cached by the logical planner. "
+             "Set to 0 to disable the cache.");
+
 namespace px {
 namespace carnot {
 namespace planner {
@@ -50,6 +55,35 @@ StatusOr<std::unique_ptr<RelationMap>> MakeRelationMapFromDistributedState(
   return rel_map;
 }
 
+TableStatsMap MakeTableStatsFromDistributedState(const distributedpb::DistributedState& state_pb,
+                                                 const RelationMap& rel_map) {
+  TableStatsMap table_stats;
+  for (const auto& carnot_info : state_pb.carnot_info()) {
+    for (const auto& table_info : carnot_info.table_info()) {
+      auto rel_it = rel_map.find(table_info.table());
+      if (rel_it == rel_map.end() || table_info.num_rows() == 0) {
+        continue;
+      }
+      auto& stats = table_stats[table_info.table()];
+      stats.num_rows += table_info.num_rows();
+      stats.num_bytes += table_info.num_bytes();
+      // The sketches of different agents can't be merged here, so the largest estimate is used.
+      const auto& relation = rel_it->second;
+      if (table_info.column_ndvs_size() != static_cast<int>(relation.NumColumns())) {
+        continue;
+      }
+      for (const auto& [idx, ndv] : Enumerate(table_info.column_ndvs())) {
+        if (ndv < 0) {
+          continue;
+        }
+        auto& column_ndv = stats.column_ndvs[relation.GetColumnName(idx)];
+        column_ndv = std::max(column_ndv, ndv);
+      }
+    }
+  }
+  return table_stats;
+}
+
 static inline RedactionOptions RedactionOptionsFromPb(
     const distributedpb::RedactionOptions& redaction_options) {
   RedactionOptions options;
@@ -60,7 +94,7 @@ static inline RedactionOptions RedactionOptionsFromPb(
 
 StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
     const distributedpb::LogicalPlannerState& logical_state, RegistryInfo* registry_info,
-    int64_t max_output_rows_per_table) {
+    int64_t max_output_rows_per_table, int64_t time_now) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<RelationMap> rel_map,
                       MakeRelationMapFromDistributedState(logical_state.distributed_state()));
 
@@ -72,12 +106,16 @@ StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
       {"nats_events.beta", {"body", "resp"}},
       {"pgsql_events", {"req", "resp"}},
       {"redis_events", {"req_args", "resp"}}};
-  // Create a CompilerState obj using the relation map and grabbing the current time.
-  return std::make_unique<planner::CompilerState>(
-      std::move(rel_map), sensitive_columns, registry_info, px::CurrentTimeNS(),
+  auto table_stats =
+      MakeTableStatsFromDistributedState(logical_state.distributed_state(), *rel_map);
+  // Create a CompilerState obj using the relation map and the given compile time.
+  auto compiler_state = std::make_unique<planner::CompilerState>(
+      std::move(rel_map), sensitive_columns, registry_info, time_now,
       max_output_rows_per_table, logical_state.result_address(),
       logical_state.result_ssl_targetname(),
       RedactionOptionsFromPb(logical_state.redaction_options()));
+  compiler_state->set_table_stats(std::move(table_stats));
+  return compiler_state;
 }
 
 StatusOr<std::unique_ptr<LogicalPlanner>> LogicalPlanner::Create(const udfspb::UDFInfo& udf_info) {
@@ -90,6 +128,7 @@ Status LogicalPlanner::Init(const udfspb::UDFInfo& udf_info) {
   compiler_ = compiler::Compiler();
   registry_info_ = std::make_unique<planner::RegistryInfo>();
   PL_RETURN_IF_ERROR(registry_info_->Init(udf_info));
+  plan_cache_ = std::make_unique<PlanCache>(FLAGS_planner_plan_cache_size);
 
   PL_ASSIGN_OR_RETURN(distributed_planner_, distributed::DistributedPlanner::Create());
   return Status::OK();
@@ -98,11 +137,19 @@ Status LogicalPlanner::Init(const udfspb::UDFInfo& udf_info) {
 StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::Plan(
     const distributedpb::LogicalPlannerState& logical_state,
     const plannerpb::QueryRequest& query_request) {
+  int64_t time_now = px::CurrentTimeNS();
+  std::string cache_key = PlanCache::MakeKey(logical_state, query_request);
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<distributed::DistributedPlan> cached_plan,
+                      plan_cache_->Get(cache_key, time_now));
+  if (cached_plan != nullptr) {
+    return cached_plan;
+  }
+
   // Compile into the IR.
   auto ms = logical_state.plan_options().max_output_rows_per_table();
   VLOG(1) << "Max output rows: " << ms;
   PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
-                      CreateCompilerState(logical_state, registry_info_.get(), ms));
+                      CreateCompilerState(logical_state, registry_info_.get(), ms, time_now));
 
   std::vector<plannerpb::FuncToExecute> exec_funcs(query_request.exec_funcs().begin(),
                                                    query_request.exec_funcs().end());
@@ -110,8 +157,11 @@ StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::Plan(
       std::shared_ptr<IR> single_node_plan,
       compiler_.CompileToIR(query_request.query_str(), compiler_state.get(), exec_funcs));
   // Create the distributed plan.
-  return distributed_planner_->Plan(logical_state.distributed_state(), compiler_state.get(),
-                                    single_node_plan.get());
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<distributed::DistributedPlan> plan,
+                      distributed_planner_->Plan(logical_state.distributed_state(),
+                                                 compiler_state.get(), single_node_plan.get()));
+  PL_RETURN_IF_ERROR(plan_cache_->Put(cache_key, time_now, *plan));
+  return plan;
 }
 
 StatusOr<std::unique_ptr<compiler::MutationsIR>> LogicalPlanner::CompileTrace(
@@ -121,7 +171,8 @@ StatusOr<std::unique_ptr<compiler::MutationsIR>> LogicalPlanner::CompileTrace(
   auto ms = logical_state.plan_options().max_output_rows_per_table();
   VLOG(1) << "Max output rows: " << ms;
   PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
-                      CreateCompilerState(logical_state, registry_info_.get(), ms));
+                      CreateCompilerState(logical_state, registry_info_.get(), ms,
+                                          px::CurrentTimeNS()));
 
   std::vector<plannerpb::FuncToExecute> exec_funcs(mutations_req.exec_funcs().begin(),
                                                    mutations_req.exec_funcs().end());
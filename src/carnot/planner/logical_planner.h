@@ -25,6 +25,7 @@
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 #include "src/carnot/planner/distributed/distributed_planner.h"
+#include "src/carnot/planner/plan_cache.h"
 #include "src/carnot/planner/plannerpb/func_args.pb.h"
 #include "src/carnot/planner/probes/probes.h"
 #include "src/shared/scriptspb/scripts.pb.h"
@@ -65,6 +66,8 @@ class LogicalPlanner : public NotCopyable {
   Status Init(std::unique_ptr<planner::RegistryInfo> registry_info);
   Status Init(const udfspb::UDFInfo& udf_info);
 
+  const PlanCache* plan_cache() const { return plan_cache_.get(); }
+
  protected:
   LogicalPlanner() {}
 
@@ -72,6 +75,9 @@ class LogicalPlanner : public NotCopyable {
   compiler::Compiler compiler_;
   std::unique_ptr<distributed::Planner> distributed_planner_;
   std::unique_ptr<planner::RegistryInfo> registry_info_;
+  // Plans are only valid for the registry they were compiled against, so the cache is recreated
+  // along with the registry in Init.
+  std::unique_ptr<PlanCache> plan_cache_;
 };
 
 }  // namespace planner
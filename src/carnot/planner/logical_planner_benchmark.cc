@@ -24,13 +24,18 @@
 #include "src/common/base/test_utils.h"
 #include "src/common/perf/perf.h"
 
+DECLARE_int32(planner_plan_cache_size);
+
 namespace px {
 namespace carnot {
 namespace planner {
 namespace logical_planner {
 
+// Plans the same live view over and over. The first calls compile the script, after that the
+// plan cache hands out copies of the plan unless it's disabled.
 // NOLINTNEXTLINE : runtime/references.
-void BM_Query(benchmark::State& state) {
+void PlanRepeatedly(benchmark::State& state, int32_t plan_cache_size) {
+  FLAGS_planner_plan_cache_size = plan_cache_size;
   auto info = udfexporter::ExportUDFInfo().ConsumeValueOrDie()->info_pb();
   auto planner = LogicalPlanner::Create(info).ConsumeValueOrDie();
   auto planner_state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
@@ -42,7 +47,14 @@ void BM_Query(benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_Query);
+// NOLINTNEXTLINE : runtime/references.
+void BM_QueryCold(benchmark::State& state) { PlanRepeatedly(state, /* plan_cache_size */ 0); }
+
+// NOLINTNEXTLINE : runtime/references.
+void BM_QueryWarm(benchmark::State& state) { PlanRepeatedly(state, /* plan_cache_size */ 64); }
+
+BENCHMARK(BM_QueryCold);
+BENCHMARK(BM_QueryWarm);
 
 }  // namespace logical_planner
 }  // namespace planner
@@ -95,6 +95,122 @@ TEST_F(LogicalPlannerTest, max_output_rows) {
   EXPECT_OK(plan->ToProto());
 }
 
+// Returns the time bounds of the memory sources in each Carnot instance's plan.
+std::vector<std::pair<int64_t, int64_t>> MemorySourceTimes(
+    const distributed::DistributedPlan& plan) {
+  std::vector<std::pair<int64_t, int64_t>> times;
+  for (const auto& id : plan.dag().TopologicalSort()) {
+    for (IRNode* node : plan.Get(id)->plan()->FindNodesOfType(IRNodeType::kMemorySource)) {
+      auto mem_src = static_cast<MemorySourceIR*>(node);
+      times.emplace_back(mem_src->time_start_ns(), mem_src->time_stop_ns());
+    }
+  }
+  return times;
+}
+
+TEST_F(LogicalPlannerTest, plan_cache_rebinds_relative_times) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+
+  std::vector<std::vector<std::pair<int64_t, int64_t>>> plan_times;
+  for (int i = 0; i < 3; ++i) {
+    auto plan_or_s = planner->Plan(state, MakeQueryRequest(kSimpleQueryDefaultLimit));
+    ASSERT_OK(plan_or_s);
+    auto plan = plan_or_s.ConsumeValueOrDie();
+    EXPECT_OK(plan->ToProto());
+    plan_times.push_back(MemorySourceTimes(*plan));
+  }
+  // The first two plans are compiled, the third one comes out of the cache.
+  EXPECT_EQ(1, planner->plan_cache()->hits());
+
+  ASSERT_EQ(plan_times[1].size(), plan_times[2].size());
+  ASSERT_FALSE(plan_times[2].empty());
+  for (const auto& [idx, times] : Enumerate(plan_times[2])) {
+    EXPECT_EQ(120 * 1000 * 1000 * 1000LL, times.second - times.first);
+    EXPECT_GT(times.first, plan_times[1][idx].first);
+    EXPECT_GT(times.second, plan_times[1][idx].second);
+  }
+}
+
+constexpr char kAbsoluteTimeQuery[] = R"pxl(
+import px
+t1 = px.DataFrame(table='http_events', start_time=10, end_time=20, select=['time_'])
+px.display(t1)
+)pxl";
+
+TEST_F(LogicalPlannerTest, plan_cache_keeps_absolute_times) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  for (int i = 0; i < 3; ++i) {
+    auto plan = planner->Plan(state, MakeQueryRequest(kAbsoluteTimeQuery)).ConsumeValueOrDie();
+    for (const auto& times : MemorySourceTimes(*plan)) {
+      EXPECT_EQ(10, times.first);
+      EXPECT_EQ(20, times.second);
+    }
+  }
+  EXPECT_EQ(1, planner->plan_cache()->hits());
+}
+
+constexpr char kTimeNowInMapQuery[] = R"pxl(
+import px
+t1 = px.DataFrame(table='http_events', start_time='-120s', select=['time_'])
+t1.age = px.now() - t1.time_
+px.display(t1)
+)pxl";
+
+TEST_F(LogicalPlannerTest, plan_cache_skips_plans_with_compile_time_values) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_OK(planner->Plan(state, MakeQueryRequest(kTimeNowInMapQuery)));
+  }
+  EXPECT_EQ(0, planner->plan_cache()->hits());
+
+  // A different schema is a different cache entry.
+  auto other_state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  other_state.mutable_plan_options()->set_max_output_rows_per_table(100);
+  EXPECT_NE(PlanCache::MakeKey(state, MakeQueryRequest(kSimpleQueryDefaultLimit)),
+            PlanCache::MakeKey(other_state, MakeQueryRequest(kSimpleQueryDefaultLimit)));
+}
+
+constexpr char kFilterAfterJoinQuery[] = R"pxl(
+import px
+
+requests = px.DataFrame(table='http_events', start_time='-120s')
+requests['service'] = requests.ctx['service']
+
+procs = px.DataFrame(table='process_stats', start_time='-120s')
+procs['service'] = procs.ctx['service']
+procs = procs.groupby('service').agg(cpu=('cpu_ktime_ns', px.mean))
+
+joined = requests.merge(procs, how='inner', left_on=['service'], right_on=['service'],
+                        suffixes=['', '_x'])
+joined = joined[joined['resp_status'] >= 400]
+px.display(joined[['service', 'resp_status', 'cpu']])
+)pxl";
+
+TEST_F(LogicalPlannerTest, filter_pushed_below_join_to_pems) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto plan_or_s =
+      planner->Plan(testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema),
+                    MakeQueryRequest(kFilterAfterJoinQuery));
+  ASSERT_OK(plan_or_s);
+  auto plan = plan_or_s.ConsumeValueOrDie();
+
+  // The filter only reads the http_events side of the join, so it runs on the PEMs and only the
+  // matching rows are sent to Kelvin.
+  for (const auto& id : plan->dag().TopologicalSort()) {
+    auto carnot = plan->Get(id);
+    auto filters = carnot->plan()->FindNodesOfType(IRNodeType::kFilter);
+    if (carnot->carnot_info().accepts_remote_sources()) {
+      EXPECT_EQ(0, filters.size());
+    } else {
+      EXPECT_EQ(1, filters.size());
+    }
+  }
+  EXPECT_OK(plan->ToProto());
+}
+
 constexpr char kCompileTimeQuery[] = R"pxl(
 import px
 
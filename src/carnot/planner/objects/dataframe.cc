@@ -340,6 +340,7 @@ StatusOr<QLObjectPtr> RollingHandler(IR* graph, OperatorIR* op, const pypa::AstP
                                      const ParsedArgs& args, ASTVisitor* visitor) {
   PL_ASSIGN_OR_RETURN(StringIR * window_col_name, GetArgAs<StringIR>(ast, args, "on"));
   PL_ASSIGN_OR_RETURN(ExpressionIR * window_size, GetArgAs<ExpressionIR>(ast, args, "window"));
+  PL_ASSIGN_OR_RETURN(ExpressionIR * every, GetArgAs<ExpressionIR>(ast, args, "every"));
 
   if (window_col_name->str() != "time_") {
     return window_col_name->CreateIRNodeError(
@@ -350,7 +351,7 @@ StatusOr<QLObjectPtr> RollingHandler(IR* graph, OperatorIR* op, const pypa::AstP
                       graph->CreateNode<ColumnIR>(ast, window_col_name->str(), /* parent_idx */ 0));
 
   PL_ASSIGN_OR_RETURN(RollingIR * rolling_op,
-                      graph->CreateNode<RollingIR>(ast, op, window_col, window_size));
+                      graph->CreateNode<RollingIR>(ast, op, window_col, window_size, every));
   return Dataframe::Create(rolling_op, visitor);
 }
 
@@ -515,12 +516,13 @@ Status Dataframe::Init() {
 
   /**
    * # Equivalent to the python method syntax:
-   * def rolling(self, window, on="time_"):
+   * def rolling(self, window, on="time_", every=0):
    *     ...
    */
   PL_ASSIGN_OR_RETURN(
       std::shared_ptr<FuncObject> rolling_fn,
-      FuncObject::Create(kRollingOpID, {"window", "on"}, {{"on", "'time_'"}},
+      FuncObject::Create(kRollingOpID, {"window", "on", "every"},
+                         {{"on", "'time_'"}, {"every", "0"}},
                          /* has_variable_len_args */ false,
                          /* has_variable_len_kwargs */ false,
                          std::bind(&RollingHandler, graph(), op(), std::placeholders::_1,
@@ -368,18 +368,29 @@ class Dataframe : public QLObject {
   Groups the data by rolling windows.
 
   Rolls up data into groups based on the rolling window that it belongs to. Used to define
-  window aggregates, the streaming analog of batch aggregates.
+  window aggregates, the streaming analog of batch aggregates. When streamed, the aggregate
+  of the latest window is re-emitted every `every` as new data arrives.
 
   Examples:
     df = px.DataFrame('process_stats')
     df = df.rolling('2s').agg(...)
 
+  Examples:
+    df = px.DataFrame('http_events')
+    df = df.groupby('service').rolling('1m', every='10s').agg(
+        count=('latency', px.count),
+    )
+    px.display(df.stream())
+
 
   :topic: dataframe_ops
   :opname: Rolling Window
 
   Args:
     window (px.Duration): the size of the rolling window.
+    on (string): the time column to window on. Only 'time_' is supported.
+    every (px.Duration, optional): how often to emit the aggregate of the window. Must not
+      be larger than the window. Defaults to the size of the window.
 
   Returns:
     px.DataFrame: DataFrame grouped into rolling windows. Must apply either a groupby or an aggregate on the
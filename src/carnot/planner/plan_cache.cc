@@ -0,0 +1,243 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/plan_cache.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/util/message_differencer.h>
+
+#include <absl/container/flat_hash_set.h>
+
+#include "src/carnot/planner/ir/memory_source_ir.h"
+#include "src/carnot/planner/ir/pattern_match.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+namespace {
+
+// Map fields have no fixed order on the wire, so keys are built with deterministic serialization.
+void AppendDeterministic(const google::protobuf::Message& msg, std::string* out) {
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream string_stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    msg.SerializeToCodedStream(&coded_stream);
+  }
+  absl::StrAppend(out, serialized.size(), ":", serialized);
+}
+
+// Lines up the time of a memory source in the previous and next plan. Returns false if the time
+// changed by anything other than 0 or time_delta. Relative times are reset to the previous value
+// so that the rest of the plans can be compared directly.
+bool AlignTime(const google::protobuf::Int64Value& prev_time, int64_t time_delta,
+               google::protobuf::Int64Value* next_time, bool* relative) {
+  int64_t diff = next_time->value() - prev_time.value();
+  if (diff == 0) {
+    return true;
+  }
+  if (diff != time_delta) {
+    return false;
+  }
+  *relative = true;
+  next_time->set_value(prev_time.value());
+  return true;
+}
+
+}  // namespace
+
+std::string PlanCache::MakeKey(const distributedpb::LogicalPlannerState& logical_state,
+                               const plannerpb::QueryRequest& query_request) {
+  distributedpb::LogicalPlannerState keyed_state = logical_state;
+  for (auto& carnot_info : *keyed_state.mutable_distributed_state()->mutable_carnot_info()) {
+    for (auto& table_info : *carnot_info.mutable_table_info()) {
+      table_info.clear_num_rows();
+      table_info.clear_num_bytes();
+      table_info.clear_column_ndvs();
+    }
+  }
+  std::string key;
+  AppendDeterministic(query_request, &key);
+  AppendDeterministic(keyed_state, &key);
+  return key;
+}
+
+StatusOr<std::unique_ptr<distributed::DistributedPlan>> PlanCache::Get(const std::string& key,
+                                                                       int64_t time_now) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto entry_it = entries_.find(key);
+  if (entry_it == entries_.end() || !entry_it->second.admitted) {
+    return std::unique_ptr<distributed::DistributedPlan>(nullptr);
+  }
+  Entry* entry = &entry_it->second;
+  Touch(entry);
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<distributed::DistributedPlan> plan, entry->plan->Clone());
+  PL_RETURN_IF_ERROR(
+      ShiftRelativeTimes(entry->relative_times, time_now - entry->time_now, plan.get()));
+  ++hits_;
+  return plan;
+}
+
+Status PlanCache::Put(const std::string& key, int64_t time_now,
+                      const distributed::DistributedPlan& plan) {
+  if (capacity_ <= 0) {
+    return Status::OK();
+  }
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  auto entry_it = entries_.find(key);
+  if (entry_it == entries_.end()) {
+    EvictIfFull();
+    Entry entry;
+    PL_ASSIGN_OR_RETURN(entry.plan, plan.Clone());
+    entry.time_now = time_now;
+    lru_.push_front(key);
+    entry.lru_it = lru_.begin();
+    entries_.emplace(key, std::move(entry));
+    return Status::OK();
+  }
+
+  Entry* entry = &entry_it->second;
+  Touch(entry);
+  if (entry->admitted || !entry->cacheable) {
+    return Status::OK();
+  }
+  int64_t time_delta = time_now - entry->time_now;
+  RelativeTimesMap relative_times;
+  // Relative and absolute times can't be told apart if no time passed between the compiles, so
+  // the newer plan just replaces the older one.
+  if (time_delta != 0) {
+    PL_ASSIGN_OR_RETURN(bool same_plan,
+                        FindRelativeTimes(*entry->plan, plan, time_delta, &relative_times));
+    if (!same_plan) {
+      entry->cacheable = false;
+      entry->plan.reset();
+      return Status::OK();
+    }
+    entry->admitted = true;
+  }
+  PL_ASSIGN_OR_RETURN(entry->plan, plan.Clone());
+  entry->time_now = time_now;
+  entry->relative_times = std::move(relative_times);
+  return Status::OK();
+}
+
+StatusOr<bool> PlanCache::FindRelativeTimes(const distributed::DistributedPlan& prev_plan,
+                                            const distributed::DistributedPlan& next_plan,
+                                            int64_t time_delta, RelativeTimesMap* relative_times) {
+  PL_ASSIGN_OR_RETURN(distributedpb::DistributedPlan prev_pb, prev_plan.ToProto());
+  PL_ASSIGN_OR_RETURN(distributedpb::DistributedPlan next_pb, next_plan.ToProto());
+  if (prev_pb.qb_address_to_plan_size() != next_pb.qb_address_to_plan_size()) {
+    return false;
+  }
+  for (auto& [address, next_plan_pb] : *next_pb.mutable_qb_address_to_plan()) {
+    auto prev_it = prev_pb.qb_address_to_plan().find(address);
+    auto dag_id_it = next_pb.qb_address_to_dag_id().find(address);
+    if (prev_it == prev_pb.qb_address_to_plan().end() ||
+        dag_id_it == next_pb.qb_address_to_dag_id().end()) {
+      return false;
+    }
+    const planpb::Plan& prev_plan_pb = prev_it->second;
+    if (prev_plan_pb.nodes_size() != next_plan_pb.nodes_size()) {
+      return false;
+    }
+    for (int i = 0; i < next_plan_pb.nodes_size(); ++i) {
+      const planpb::PlanFragment& prev_fragment = prev_plan_pb.nodes(i);
+      planpb::PlanFragment* next_fragment = next_plan_pb.mutable_nodes(i);
+      if (prev_fragment.nodes_size() != next_fragment->nodes_size()) {
+        return false;
+      }
+      for (int j = 0; j < next_fragment->nodes_size(); ++j) {
+        const planpb::PlanNode& prev_node = prev_fragment.nodes(j);
+        planpb::PlanNode* next_node = next_fragment->mutable_nodes(j);
+        if (!prev_node.op().has_mem_source_op() || !next_node->op().has_mem_source_op()) {
+          continue;
+        }
+        const planpb::MemorySourceOperator& prev_src = prev_node.op().mem_source_op();
+        planpb::MemorySourceOperator* next_src = next_node->mutable_op()->mutable_mem_source_op();
+        if (!prev_src.has_start_time() || !next_src->has_start_time()) {
+          continue;
+        }
+        RelativeTimes relative;
+        if (!AlignTime(prev_src.start_time(), time_delta, next_src->mutable_start_time(),
+                       &relative.start) ||
+            !AlignTime(prev_src.stop_time(), time_delta, next_src->mutable_stop_time(),
+                       &relative.stop)) {
+          return false;
+        }
+        if (relative.start || relative.stop) {
+          (*relative_times)[{dag_id_it->second, next_node->id()}] = relative;
+        }
+      }
+    }
+  }
+  return google::protobuf::util::MessageDifferencer::Equals(prev_pb, next_pb);
+}
+
+Status PlanCache::ShiftRelativeTimes(const RelativeTimesMap& relative_times, int64_t time_delta,
+                                     distributed::DistributedPlan* plan) {
+  // Agents can share a plan, so a memory source may be listed once for each of them.
+  absl::flat_hash_set<MemorySourceIR*> shifted;
+  for (const auto& [ids, relative] : relative_times) {
+    const auto& [carnot_id, node_id] = ids;
+    IR* carnot_plan = plan->Get(carnot_id)->plan();
+    if (carnot_plan == nullptr || !carnot_plan->HasNode(node_id) ||
+        !Match(carnot_plan->Get(node_id), MemorySource())) {
+      return error::Internal("Cached plan for carnot $0 is missing memory source $1.", carnot_id,
+                             node_id);
+    }
+    auto mem_src = static_cast<MemorySourceIR*>(carnot_plan->Get(node_id));
+    if (!shifted.insert(mem_src).second) {
+      continue;
+    }
+    mem_src->SetTimeValuesNS(mem_src->time_start_ns() + (relative.start ? time_delta : 0),
+                             mem_src->time_stop_ns() + (relative.stop ? time_delta : 0));
+  }
+  return Status::OK();
+}
+
+void PlanCache::Touch(Entry* entry) { lru_.splice(lru_.begin(), lru_, entry->lru_it); }
+
+void PlanCache::EvictIfFull() {
+  while (!lru_.empty() && static_cast<int64_t>(entries_.size()) >= capacity_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+}
+
+void PlanCache::Clear() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  entries_.clear();
+  lru_.clear();
+}
+
+int64_t PlanCache::size() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return entries_.size();
+}
+
+int64_t PlanCache::hits() const {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+  return hits_;
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
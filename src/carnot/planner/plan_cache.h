@@ -0,0 +1,122 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
+#include "src/carnot/planner/distributedpb/distributed_plan.pb.h"
+#include "src/carnot/planner/plannerpb/func_args.pb.h"
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+/**
+ * @brief PlanCache holds the distributed plans of scripts that are planned over and over with the
+ * same arguments and cluster state, like live views that refresh on an interval.
+ *
+ * The only part of such a plan that should change from one call to the next is the time range
+ * of memory sources that were written relative to the compile time (ie '-5m' or px.now()). A key
+ * is admitted once it has been planned twice: the two plans must be identical except for memory
+ * source times that moved by exactly the time that passed between the compiles. Those times are
+ * remembered and shifted forward whenever the cached plan is handed out. Plans that differ in any
+ * other way are never served from the cache.
+ */
+class PlanCache : public NotCopyable {
+ public:
+  explicit PlanCache(int64_t capacity) : capacity_(capacity) {}
+
+  /**
+   * @brief Builds the cache key for a request. The key covers the script, the exec func
+   * arguments, the schemas, the set of agents and the plan options. The table statistics sent
+   * with each agent are left out because they change on every heartbeat.
+   */
+  static std::string MakeKey(const distributedpb::LogicalPlannerState& logical_state,
+                             const plannerpb::QueryRequest& query_request);
+
+  /**
+   * @brief Returns a copy of the cached plan for key with its relative time bounds rebound to
+   * time_now, or nullptr if the key hasn't been admitted.
+   */
+  StatusOr<std::unique_ptr<distributed::DistributedPlan>> Get(const std::string& key,
+                                                              int64_t time_now);
+
+  /**
+   * @brief Records the plan that was compiled for key at time_now.
+   */
+  Status Put(const std::string& key, int64_t time_now, const distributed::DistributedPlan& plan);
+
+  void Clear();
+
+  int64_t size() const;
+  int64_t hits() const;
+
+ private:
+  struct RelativeTimes {
+    bool start = false;
+    bool stop = false;
+  };
+  // Memory sources with relative times, keyed by the carnot id and the node id in its plan.
+  using RelativeTimesMap = absl::flat_hash_map<std::pair<int64_t, int64_t>, RelativeTimes>;
+
+  struct Entry {
+    std::unique_ptr<distributed::DistributedPlan> plan;
+    int64_t time_now = 0;
+    RelativeTimesMap relative_times;
+    // Set once a second compile confirmed that only the relative times moved.
+    bool admitted = false;
+    // Cleared when two compiles of the key differed in more than the relative times.
+    bool cacheable = true;
+    std::list<std::string>::iterator lru_it;
+  };
+
+  /**
+   * @brief Compares the plans of two compiles that were time_delta apart. Returns false if they
+   * differ in anything but memory source times that moved by time_delta, otherwise fills
+   * relative_times with those memory sources.
+   */
+  static StatusOr<bool> FindRelativeTimes(const distributed::DistributedPlan& prev_plan,
+                                          const distributed::DistributedPlan& next_plan,
+                                          int64_t time_delta, RelativeTimesMap* relative_times);
+
+  static Status ShiftRelativeTimes(const RelativeTimesMap& relative_times, int64_t time_delta,
+                                   distributed::DistributedPlan* plan);
+
+  void Touch(Entry* entry);
+  void EvictIfFull();
+
+  const int64_t capacity_;
+  mutable std::mutex cache_mutex_;
+  absl::flat_hash_map<std::string, Entry> entries_;
+  // Most recently used keys are at the front.
+  std::list<std::string> lru_;
+  int64_t hits_ = 0;
+};
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
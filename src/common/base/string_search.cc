@@ -0,0 +1,374 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/common/base/string_search.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "src/common/base/logging.h"
+
+namespace px {
+
+namespace {
+
+SIMDLevel DetectSIMDLevel() {
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SIMDLevel::kAVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return SIMDLevel::kSSE42;
+  }
+#endif
+  return SIMDLevel::kScalar;
+}
+
+SIMDLevel& CurrentSIMDLevel() {
+  static SIMDLevel level = MaxSupportedSIMDLevel();
+  return level;
+}
+
+//-----------------------------------------------------------------------------
+// Scalar implementations.
+//-----------------------------------------------------------------------------
+
+size_t FindFirstOfScalar(const char* data, size_t size, const ByteSet& set, size_t pos) {
+  for (; pos < size; ++pos) {
+    if (set.Contains(data[pos])) {
+      return pos;
+    }
+  }
+  return std::string_view::npos;
+}
+
+size_t FindLastOfScalar(const char* data, const ByteSet& set, size_t end) {
+  while (end > 0) {
+    --end;
+    if (set.Contains(data[end])) {
+      return end;
+    }
+  }
+  return std::string_view::npos;
+}
+
+#if defined(__x86_64__)
+
+//-----------------------------------------------------------------------------
+// SSE4.2 implementations.
+//-----------------------------------------------------------------------------
+
+// The byte set membership test is the nibble lookup from
+// http://0x80.pl/articles/simd-byte-lookup.html: the low nibble of each byte selects the bitmap of
+// the high nibbles that are in the set, and the high nibble selects the bit to test.
+
+__attribute__((target("sse4.2"))) inline __m128i ByteSetMatch(__m128i v, __m128i table_0_7,
+                                                              __m128i table_8_15) {
+  const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+  const __m128i bit_table =
+      _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+  __m128i lo = _mm_and_si128(v, nibble_mask);
+  __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask);
+  __m128i bitmap =
+      _mm_blendv_epi8(_mm_shuffle_epi8(table_0_7, lo), _mm_shuffle_epi8(table_8_15, lo),
+                      _mm_cmpgt_epi8(hi, _mm_set1_epi8(7)));
+  __m128i bit = _mm_shuffle_epi8(bit_table, hi);
+  return _mm_cmpeq_epi8(_mm_and_si128(bitmap, bit), bit);
+}
+
+__attribute__((target("sse4.2"))) size_t FindFirstOfSSE42(const char* data, size_t size,
+                                                          const ByteSet& set, size_t pos) {
+  const auto& tables = set.nibble_tables();
+  const __m128i table_0_7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[0].data()));
+  const __m128i table_8_15 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[1].data()));
+
+  for (; pos + 16 <= size; pos += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+    uint32_t mask = _mm_movemask_epi8(ByteSetMatch(v, table_0_7, table_8_15));
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return FindFirstOfScalar(data, size, set, pos);
+}
+
+__attribute__((target("sse4.2"))) size_t FindLastOfSSE42(const char* data, const ByteSet& set,
+                                                         size_t end) {
+  const auto& tables = set.nibble_tables();
+  const __m128i table_0_7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[0].data()));
+  const __m128i table_8_15 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[1].data()));
+
+  for (; end >= 16; end -= 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + end - 16));
+    uint32_t mask = _mm_movemask_epi8(ByteSetMatch(v, table_0_7, table_8_15));
+    if (mask != 0) {
+      return end - 16 + (31 - __builtin_clz(mask));
+    }
+  }
+  return FindLastOfScalar(data, set, end);
+}
+
+// Compares the first and the last bytes of the pattern at 16 positions at a time, and only
+// compares the rest of the pattern at the positions where both match.
+// See http://0x80.pl/articles/simd-strfind.html.
+__attribute__((target("sse4.2"))) size_t FindPatternSSE42(std::string_view buf,
+                                                          std::string_view pattern, size_t pos) {
+  const size_t last = pattern.size() - 1;
+  const __m128i first_byte = _mm_set1_epi8(pattern.front());
+  const __m128i last_byte = _mm_set1_epi8(pattern.back());
+
+  for (; pos + last + 16 <= buf.size(); pos += 16) {
+    __m128i first_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.data() + pos));
+    __m128i last_block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.data() + pos + last));
+    uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first_block, first_byte),
+                                                    _mm_cmpeq_epi8(last_block, last_byte)));
+    while (mask != 0) {
+      size_t candidate = pos + __builtin_ctz(mask);
+      if (memcmp(buf.data() + candidate + 1, pattern.data() + 1, last) == 0) {
+        return candidate;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return buf.find(pattern, pos);
+}
+
+//-----------------------------------------------------------------------------
+// AVX2 implementations.
+//-----------------------------------------------------------------------------
+
+__attribute__((target("avx2"))) inline __m256i ByteSetMatch(__m256i v, __m256i table_0_7,
+                                                            __m256i table_8_15) {
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0f);
+  const __m256i bit_table = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64,
+                                             -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16,
+                                             32, 64, -128);
+
+  __m256i lo = _mm256_and_si256(v, nibble_mask);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask);
+  __m256i bitmap = _mm256_blendv_epi8(_mm256_shuffle_epi8(table_0_7, lo),
+                                      _mm256_shuffle_epi8(table_8_15, lo),
+                                      _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7)));
+  __m256i bit = _mm256_shuffle_epi8(bit_table, hi);
+  return _mm256_cmpeq_epi8(_mm256_and_si256(bitmap, bit), bit);
+}
+
+__attribute__((target("avx2"))) size_t FindFirstOfAVX2(const char* data, size_t size,
+                                                       const ByteSet& set, size_t pos) {
+  const auto& tables = set.nibble_tables();
+  // _mm256_shuffle_epi8 looks up within each 128-bit lane, so both lanes get the tables.
+  const __m256i table_0_7 = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[0].data())));
+  const __m256i table_8_15 = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[1].data())));
+
+  for (; pos + 32 <= size; pos += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+    uint32_t mask = _mm256_movemask_epi8(ByteSetMatch(v, table_0_7, table_8_15));
+    if (mask != 0) {
+      return pos + __builtin_ctz(mask);
+    }
+  }
+  return FindFirstOfSSE42(data, size, set, pos);
+}
+
+__attribute__((target("avx2"))) size_t FindLastOfAVX2(const char* data, const ByteSet& set,
+                                                      size_t end) {
+  const auto& tables = set.nibble_tables();
+  const __m256i table_0_7 = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[0].data())));
+  const __m256i table_8_15 = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables[1].data())));
+
+  for (; end >= 32; end -= 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + end - 32));
+    uint32_t mask = _mm256_movemask_epi8(ByteSetMatch(v, table_0_7, table_8_15));
+    if (mask != 0) {
+      return end - 32 + (31 - __builtin_clz(mask));
+    }
+  }
+  return FindLastOfSSE42(data, set, end);
+}
+
+__attribute__((target("avx2"))) size_t FindPatternAVX2(std::string_view buf,
+                                                       std::string_view pattern, size_t pos) {
+  const size_t last = pattern.size() - 1;
+  const __m256i first_byte = _mm256_set1_epi8(pattern.front());
+  const __m256i last_byte = _mm256_set1_epi8(pattern.back());
+
+  for (; pos + last + 32 <= buf.size(); pos += 32) {
+    __m256i first_block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf.data() + pos));
+    __m256i last_block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf.data() + pos + last));
+    uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(
+        _mm256_cmpeq_epi8(first_block, first_byte), _mm256_cmpeq_epi8(last_block, last_byte)));
+    while (mask != 0) {
+      size_t candidate = pos + __builtin_ctz(mask);
+      if (memcmp(buf.data() + candidate + 1, pattern.data() + 1, last) == 0) {
+        return candidate;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return FindPatternSSE42(buf, pattern, pos);
+}
+
+#endif  // defined(__x86_64__)
+
+}  // namespace
+
+SIMDLevel MaxSupportedSIMDLevel() {
+  static const SIMDLevel kLevel = DetectSIMDLevel();
+  return kLevel;
+}
+
+SIMDLevel SetSIMDLevel(SIMDLevel level) {
+  return std::exchange(CurrentSIMDLevel(), std::min(level, MaxSupportedSIMDLevel()));
+}
+
+//-----------------------------------------------------------------------------
+// ByteSet
+//-----------------------------------------------------------------------------
+
+ByteSet::ByteSet(std::initializer_list<char> bytes) {
+  for (char c : bytes) {
+    Add(c);
+  }
+}
+
+ByteSet::ByteSet(std::string_view bytes) {
+  for (char c : bytes) {
+    Add(c);
+  }
+}
+
+void ByteSet::Add(char c) {
+  const uint8_t byte = static_cast<uint8_t>(c);
+  contains_[byte] = true;
+  const uint8_t hi = byte >> 4;
+  nibble_tables_[hi >> 3][byte & 0x0f] |= 1 << (hi & 0x07);
+}
+
+//-----------------------------------------------------------------------------
+// Search functions
+//-----------------------------------------------------------------------------
+
+size_t FindFirstOf(std::string_view buf, const ByteSet& set, size_t pos) {
+  switch (CurrentSIMDLevel()) {
+#if defined(__x86_64__)
+    case SIMDLevel::kAVX2:
+      return FindFirstOfAVX2(buf.data(), buf.size(), set, pos);
+    case SIMDLevel::kSSE42:
+      return FindFirstOfSSE42(buf.data(), buf.size(), set, pos);
+#endif
+    default:
+      return FindFirstOfScalar(buf.data(), buf.size(), set, pos);
+  }
+}
+
+size_t FindLastOf(std::string_view buf, const ByteSet& set, size_t end) {
+  end = std::min(end, buf.size());
+  switch (CurrentSIMDLevel()) {
+#if defined(__x86_64__)
+    case SIMDLevel::kAVX2:
+      return FindLastOfAVX2(buf.data(), set, end);
+    case SIMDLevel::kSSE42:
+      return FindLastOfSSE42(buf.data(), set, end);
+#endif
+    default:
+      return FindLastOfScalar(buf.data(), set, end);
+  }
+}
+
+size_t FindPattern(std::string_view buf, std::string_view pattern, size_t pos) {
+  // Single bytes are best left to memchr(), and the vectorized search needs the pattern to fit.
+  if (pattern.size() < 2 || pos > buf.size() || pattern.size() > buf.size() - pos) {
+    return buf.find(pattern, pos);
+  }
+  switch (CurrentSIMDLevel()) {
+#if defined(__x86_64__)
+    case SIMDLevel::kAVX2:
+      return FindPatternAVX2(buf, pattern, pos);
+    case SIMDLevel::kSSE42:
+      return FindPatternSSE42(buf, pattern, pos);
+#endif
+    default:
+      return buf.find(pattern, pos);
+  }
+}
+
+//-----------------------------------------------------------------------------
+// MultiPatternSearcher
+//-----------------------------------------------------------------------------
+
+namespace {
+
+std::string FirstBytes(const std::vector<std::string_view>& patterns) {
+  std::string first_bytes;
+  for (std::string_view pattern : patterns) {
+    DCHECK(!pattern.empty());
+    first_bytes.push_back(pattern.front());
+  }
+  return first_bytes;
+}
+
+}  // namespace
+
+MultiPatternSearcher::MultiPatternSearcher(std::vector<std::string_view> patterns)
+    : patterns_(patterns.begin(), patterns.end()), first_bytes_(FirstBytes(patterns)) {}
+
+bool MultiPatternSearcher::MatchesAt(std::string_view buf, size_t pos) const {
+  for (const std::string& pattern : patterns_) {
+    if (buf.size() - pos >= pattern.size() &&
+        memcmp(buf.data() + pos, pattern.data(), pattern.size()) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t MultiPatternSearcher::Find(std::string_view buf, size_t pos) const {
+  while ((pos = FindFirstOf(buf, first_bytes_, pos)) != std::string_view::npos) {
+    if (MatchesAt(buf, pos)) {
+      return pos;
+    }
+    ++pos;
+  }
+  return std::string_view::npos;
+}
+
+size_t MultiPatternSearcher::RFind(std::string_view buf) const {
+  size_t end = buf.size();
+  while ((end = FindLastOf(buf, first_bytes_, end)) != std::string_view::npos) {
+    if (MatchesAt(buf, end)) {
+      return end;
+    }
+  }
+  return std::string_view::npos;
+}
+
+}  // namespace px
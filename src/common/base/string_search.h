@@ -0,0 +1,125 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace px {
+
+/**
+ * Functions to search byte buffers for sets of bytes and for (sets of) patterns, vectorized with
+ * AVX2 or SSE4.2 when the CPU supports them, and with a scalar fallback otherwise.
+ * Used where protocol parsers scan whole buffers, e.g. to find a message boundary after data loss.
+ */
+
+enum class SIMDLevel {
+  kScalar,
+  kSSE42,
+  kAVX2,
+};
+
+/**
+ * Returns the best SIMD level supported by the CPU.
+ */
+SIMDLevel MaxSupportedSIMDLevel();
+
+/**
+ * Sets the SIMD level used by the search functions below, capped at MaxSupportedSIMDLevel().
+ * Only meant for tests and benchmarks; not thread-safe.
+ *
+ * @return the previous level.
+ */
+SIMDLevel SetSIMDLevel(SIMDLevel level);
+
+/**
+ * A set of byte values, e.g. the first bytes of all the message types of a protocol.
+ */
+class ByteSet {
+ public:
+  ByteSet(std::initializer_list<char> bytes);
+  explicit ByteSet(std::string_view bytes);
+
+  bool Contains(char c) const { return contains_[static_cast<uint8_t>(c)]; }
+
+  // Lookup tables for the vectorized membership test, indexed by the low nibble of a byte:
+  // bit h of nibble_tables()[0] (resp. [1]) is set if the byte with the high nibble h (resp. h+8)
+  // is in the set.
+  const std::array<std::array<uint8_t, 16>, 2>& nibble_tables() const { return nibble_tables_; }
+
+ private:
+  void Add(char c);
+
+  std::array<bool, 256> contains_ = {};
+  std::array<std::array<uint8_t, 16>, 2> nibble_tables_ = {};
+};
+
+/**
+ * Returns the position of the first byte of buf, at or after pos, that is in the set,
+ * or std::string_view::npos if there is none.
+ */
+size_t FindFirstOf(std::string_view buf, const ByteSet& set, size_t pos = 0);
+
+/**
+ * Returns the position of the last byte of buf, before end, that is in the set,
+ * or std::string_view::npos if there is none.
+ */
+size_t FindLastOf(std::string_view buf, const ByteSet& set,
+                  size_t end = std::string_view::npos);
+
+/**
+ * Same as buf.find(pattern, pos), but vectorized. Best for patterns whose first and last bytes
+ * are rare in buf, like "\r\n\r\n".
+ */
+size_t FindPattern(std::string_view buf, std::string_view pattern, size_t pos = 0);
+
+/**
+ * Searches for any of a set of patterns in one pass over the buffer: the candidates are the
+ * positions of the first bytes of the patterns, found with FindFirstOf/FindLastOf, and are
+ * then compared with the patterns.
+ */
+class MultiPatternSearcher {
+ public:
+  explicit MultiPatternSearcher(std::vector<std::string_view> patterns);
+
+  /**
+   * Returns the first position of buf, at or after pos, at which one of the patterns occurs,
+   * or std::string_view::npos if there is none.
+   */
+  size_t Find(std::string_view buf, size_t pos = 0) const;
+
+  /**
+   * Returns the last position of buf at which one of the patterns occurs, or
+   * std::string_view::npos if there is none. The max of buf.rfind(pattern) over the patterns.
+   */
+  size_t RFind(std::string_view buf) const;
+
+ private:
+  // Returns true if one of the patterns occurs at pos of buf.
+  bool MatchesAt(std::string_view buf, size_t pos) const;
+
+  std::vector<std::string> patterns_;
+  ByteSet first_bytes_;
+};
+
+}  // namespace px
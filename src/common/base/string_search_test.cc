@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+
+#include "src/common/base/string_search.h"
+
+namespace px {
+
+constexpr size_t kNpos = std::string_view::npos;
+
+// Runs each test at every SIMD level that the CPU supports.
+class StringSearchTest : public ::testing::TestWithParam<SIMDLevel> {
+ protected:
+  void SetUp() override { prev_level_ = SetSIMDLevel(GetParam()); }
+  void TearDown() override { SetSIMDLevel(prev_level_); }
+
+ private:
+  SIMDLevel prev_level_;
+};
+
+// Returns a random string over a small alphabet, so that the searched bytes and patterns
+// occur at all offsets of the SIMD blocks.
+std::string RandomString(std::mt19937* rng, size_t size, std::string_view alphabet) {
+  std::uniform_int_distribution<size_t> dist(0, alphabet.size() - 1);
+  std::string s;
+  for (size_t i = 0; i < size; ++i) {
+    s.push_back(alphabet[dist(*rng)]);
+  }
+  return s;
+}
+
+TEST_P(StringSearchTest, FindFirstOfAndFindLastOf) {
+  const ByteSet set = {'+', '\0', '\xff', '\x80'};
+  const std::string_view set_chars("+\0\xff\x80", 4);
+
+  EXPECT_EQ(FindFirstOf("", set), kNpos);
+  EXPECT_EQ(FindLastOf("", set), kNpos);
+  EXPECT_EQ(FindFirstOf("abc+", set, 5), kNpos);
+
+  std::mt19937 rng(37);
+  for (size_t size = 0; size < 200; ++size) {
+    std::string buf = RandomString(&rng, size, std::string("abc+\0\xff\x7f\x80\x0f", 9));
+    for (size_t pos = 0; pos <= size; pos += 7) {
+      EXPECT_EQ(FindFirstOf(buf, set, pos), std::string_view(buf).find_first_of(set_chars, pos));
+      EXPECT_EQ(FindLastOf(buf, set, pos),
+                pos == 0 ? kNpos : std::string_view(buf).find_last_of(set_chars, pos - 1));
+    }
+    EXPECT_EQ(FindLastOf(buf, set), std::string_view(buf).find_last_of(set_chars));
+  }
+}
+
+TEST_P(StringSearchTest, FindPattern) {
+  EXPECT_EQ(FindPattern("", "\r\n"), kNpos);
+  EXPECT_EQ(FindPattern("abc", ""), 0);
+  EXPECT_EQ(FindPattern("abc\r\n", "\r\n", 6), kNpos);
+
+  std::mt19937 rng(37);
+  for (std::string_view pattern : {"\r", "\r\n", "\r\n\r\n", "\r\n\r\r\n\n\r\n\r\n"}) {
+    for (size_t size = 0; size < 200; ++size) {
+      std::string buf = RandomString(&rng, size, "a\r\n");
+      for (size_t pos = 0; pos <= size; pos += 5) {
+        EXPECT_EQ(FindPattern(buf, pattern, pos), std::string_view(buf).find(pattern, pos));
+      }
+    }
+  }
+}
+
+TEST_P(StringSearchTest, MultiPatternSearcher) {
+  const std::vector<std::string_view> patterns = {"GET ", "HTTP/1.1 ", "HEAD ", "PUT "};
+  const MultiPatternSearcher searcher(patterns);
+
+  EXPECT_EQ(searcher.Find(""), kNpos);
+  EXPECT_EQ(searcher.RFind(""), kNpos);
+  EXPECT_EQ(searcher.Find("xxGET xxGE"), 2);
+  EXPECT_EQ(searcher.RFind("xxGET xxGE"), 2);
+  EXPECT_EQ(searcher.RFind("HTTP/1.1 HTTP/1.1"), 0);
+
+  std::mt19937 rng(37);
+  std::uniform_int_distribution<size_t> pattern_dist(0, patterns.size() - 1);
+  for (size_t size = 0; size < 300; size += 3) {
+    std::string buf = RandomString(&rng, size, "GETHPU ");
+    // Plant a pattern in half of the buffers.
+    if (size > 10 && size % 2 == 0) {
+      std::string_view pattern = patterns[pattern_dist(rng)];
+      buf.replace(size / 3, pattern.size(), pattern);
+    }
+
+    size_t expected_find = kNpos;
+    size_t expected_rfind = kNpos;
+    for (std::string_view pattern : patterns) {
+      expected_find = std::min(expected_find, std::string_view(buf).find(pattern));
+      size_t pos = std::string_view(buf).rfind(pattern);
+      if (pos != kNpos && (expected_rfind == kNpos || pos > expected_rfind)) {
+        expected_rfind = pos;
+      }
+    }
+    EXPECT_EQ(searcher.Find(buf), expected_find);
+    EXPECT_EQ(searcher.RFind(buf), expected_rfind);
+  }
+}
+
+std::vector<SIMDLevel> SupportedSIMDLevels() {
+  std::vector<SIMDLevel> levels = {SIMDLevel::kScalar};
+  if (MaxSupportedSIMDLevel() >= SIMDLevel::kSSE42) {
+    levels.push_back(SIMDLevel::kSSE42);
+  }
+  if (MaxSupportedSIMDLevel() >= SIMDLevel::kAVX2) {
+    levels.push_back(SIMDLevel::kAVX2);
+  }
+  return levels;
+}
+
+INSTANTIATE_TEST_SUITE_P(AllSIMDLevels, StringSearchTest,
+                         ::testing::ValuesIn(SupportedSIMDLevels()));
+
+}  // namespace px
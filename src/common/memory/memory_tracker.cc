@@ -0,0 +1,94 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/common/memory/memory_tracker.h"
+
+namespace px {
+
+MemoryTracker::~MemoryTracker() {
+  LOG_IF(WARNING, consumed_bytes() != 0) << absl::Substitute(
+      "Memory tracker $0 destroyed with $1 bytes still consumed.", label_, consumed_bytes());
+  // Return whatever is left to the ancestors, so that their accounting stays correct.
+  if (parent_ != nullptr) {
+    parent_->Release(consumed_bytes());
+  }
+}
+
+void MemoryTracker::UpdatePeak(int64_t consumed_bytes) {
+  int64_t peak = peak_consumed_bytes_.load(std::memory_order_relaxed);
+  while (consumed_bytes > peak &&
+         !peak_consumed_bytes_.compare_exchange_weak(peak, consumed_bytes,
+                                                     std::memory_order_relaxed)) {
+  }
+}
+
+bool MemoryTracker::TryConsume(int64_t bytes) {
+  if (bytes <= 0) {
+    Consume(bytes);
+    return true;
+  }
+
+  int64_t consumed = consumed_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (has_limit() && consumed > limit_bytes_) {
+    consumed_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    return false;
+  }
+  if (parent_ != nullptr && !parent_->TryConsume(bytes)) {
+    consumed_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    return false;
+  }
+  UpdatePeak(consumed);
+  return true;
+}
+
+void MemoryTracker::Consume(int64_t bytes) {
+  int64_t consumed = consumed_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  UpdatePeak(consumed);
+  if (parent_ != nullptr) {
+    parent_->Consume(bytes);
+  }
+}
+
+void MemoryTracker::Release(int64_t bytes) {
+  consumed_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+  if (parent_ != nullptr) {
+    parent_->Release(bytes);
+  }
+}
+
+Status MemoryTracker::CheckLimit() const {
+  for (const MemoryTracker* tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    if (tracker->has_limit() && tracker->consumed_bytes() > tracker->limit_bytes_) {
+      return error::ResourceUnavailable("Memory limit of $0 exceeded: $1 of $2 bytes consumed.",
+                                        tracker->label_, tracker->consumed_bytes(),
+                                        tracker->limit_bytes_);
+    }
+  }
+  return Status::OK();
+}
+
+bool MemoryTracker::IsNearLimit(double fraction) const {
+  for (const MemoryTracker* tracker = this; tracker != nullptr; tracker = tracker->parent_) {
+    if (tracker->has_limit() && tracker->consumed_bytes() > fraction * tracker->limit_bytes_) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace px
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "src/common/base/base.h"
+
+namespace px {
+
+/**
+ * MemoryTracker accounts for the bytes held by a consumer, such as a query, against an optional
+ * limit. Trackers form a hierarchy: bytes consumed by a tracker are also charged to its parent,
+ * so that a per-agent tracker sees the sum of all of its per-query trackers.
+ *
+ * All methods are thread-safe. The parent must outlive its children.
+ */
+class MemoryTracker final : public NotCopyMoveable {
+ public:
+  static constexpr int64_t kNoLimit = -1;
+
+  explicit MemoryTracker(std::string_view label, int64_t limit_bytes = kNoLimit,
+                         MemoryTracker* parent = nullptr)
+      : label_(label), limit_bytes_(limit_bytes), parent_(parent) {}
+
+  ~MemoryTracker();
+
+  /**
+   * Charges the bytes to this tracker and its ancestors if none of them would exceed their limit.
+   * @return false, with nothing charged, if a limit would be exceeded.
+   */
+  bool TryConsume(int64_t bytes);
+
+  /**
+   * Charges the bytes to this tracker and its ancestors regardless of their limits.
+   * Used for allocations that cannot fail, which are checked with CheckLimit() afterwards.
+   */
+  void Consume(int64_t bytes);
+
+  /**
+   * Returns bytes previously charged with TryConsume() or Consume().
+   */
+  void Release(int64_t bytes);
+
+  /**
+   * Returns an error if this tracker or any of its ancestors is over its limit.
+   */
+  Status CheckLimit() const;
+
+  /**
+   * Returns true if this tracker or any of its ancestors has consumed more than the given fraction
+   * of its limit. Used to start shedding memory (e.g. spilling) before a limit is hit.
+   */
+  bool IsNearLimit(double fraction) const;
+
+  const std::string& label() const { return label_; }
+  int64_t limit_bytes() const { return limit_bytes_; }
+  int64_t consumed_bytes() const { return consumed_bytes_.load(std::memory_order_relaxed); }
+  int64_t peak_consumed_bytes() const {
+    return peak_consumed_bytes_.load(std::memory_order_relaxed);
+  }
+  MemoryTracker* parent() const { return parent_; }
+
+ private:
+  bool has_limit() const { return limit_bytes_ >= 0; }
+  void UpdatePeak(int64_t consumed_bytes);
+
+  const std::string label_;
+  const int64_t limit_bytes_;
+  MemoryTracker* const parent_;
+
+  std::atomic<int64_t> consumed_bytes_ = 0;
+  std::atomic<int64_t> peak_consumed_bytes_ = 0;
+};
+
+/**
+ * MemoryReservation holds the bytes charged to a MemoryTracker on behalf of a single owner, such
+ * as an operator, and releases them all when reset or destroyed.
+ */
+class MemoryReservation final : public NotCopyable {
+ public:
+  MemoryReservation() = default;
+  ~MemoryReservation() { Reset(); }
+
+  void set_tracker(MemoryTracker* tracker) {
+    Reset();
+    tracker_ = tracker;
+  }
+
+  void Add(int64_t bytes) {
+    bytes_ += bytes;
+    if (tracker_ != nullptr) {
+      tracker_->Consume(bytes);
+    }
+  }
+
+  void Subtract(int64_t bytes) {
+    bytes_ -= bytes;
+    if (tracker_ != nullptr) {
+      tracker_->Release(bytes);
+    }
+  }
+
+  void Reset() { Subtract(bytes_); }
+
+  Status CheckLimit() const { return tracker_ != nullptr ? tracker_->CheckLimit() : Status::OK(); }
+
+  bool IsNearLimit(double fraction) const {
+    return tracker_ != nullptr && tracker_->IsNearLimit(fraction);
+  }
+
+  int64_t bytes() const { return bytes_; }
+
+ private:
+  MemoryTracker* tracker_ = nullptr;
+  int64_t bytes_ = 0;
+};
+
+}  // namespace px
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/common/memory/memory_tracker.h"
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+
+TEST(MemoryTrackerTest, TracksConsumedAndPeakBytes) {
+  MemoryTracker tracker("test");
+  tracker.Consume(100);
+  EXPECT_TRUE(tracker.TryConsume(50));
+  EXPECT_EQ(tracker.consumed_bytes(), 150);
+  tracker.Release(120);
+  EXPECT_EQ(tracker.consumed_bytes(), 30);
+  EXPECT_EQ(tracker.peak_consumed_bytes(), 150);
+  tracker.Release(30);
+}
+
+TEST(MemoryTrackerTest, EnforcesLimit) {
+  MemoryTracker tracker("test", 100);
+  EXPECT_TRUE(tracker.TryConsume(80));
+  EXPECT_FALSE(tracker.TryConsume(30));
+  EXPECT_EQ(tracker.consumed_bytes(), 80);
+  EXPECT_OK(tracker.CheckLimit());
+
+  // Forced consumption goes through, but is reported by CheckLimit().
+  tracker.Consume(30);
+  EXPECT_EQ(tracker.consumed_bytes(), 110);
+  EXPECT_NOT_OK(tracker.CheckLimit());
+
+  tracker.Release(110);
+  EXPECT_OK(tracker.CheckLimit());
+}
+
+TEST(MemoryTrackerTest, ChargesParent) {
+  MemoryTracker agent_tracker("agent", 100);
+  MemoryTracker query1_tracker("query1", 80, &agent_tracker);
+  MemoryTracker query2_tracker("query2", 80, &agent_tracker);
+
+  EXPECT_TRUE(query1_tracker.TryConsume(60));
+  EXPECT_EQ(agent_tracker.consumed_bytes(), 60);
+
+  // Within the limit of query2, but not within the one of the agent.
+  EXPECT_FALSE(query2_tracker.TryConsume(60));
+  EXPECT_EQ(query2_tracker.consumed_bytes(), 0);
+  EXPECT_EQ(agent_tracker.consumed_bytes(), 60);
+
+  EXPECT_TRUE(query2_tracker.TryConsume(40));
+  EXPECT_EQ(agent_tracker.consumed_bytes(), 100);
+
+  query2_tracker.Consume(10);
+  EXPECT_NOT_OK(query2_tracker.CheckLimit());
+  EXPECT_NOT_OK(query1_tracker.CheckLimit());
+
+  query1_tracker.Release(60);
+  query2_tracker.Release(50);
+  EXPECT_EQ(agent_tracker.consumed_bytes(), 0);
+  EXPECT_EQ(agent_tracker.peak_consumed_bytes(), 110);
+}
+
+TEST(MemoryTrackerTest, IsNearLimit) {
+  MemoryTracker agent_tracker("agent", 100);
+  MemoryTracker query_tracker("query", MemoryTracker::kNoLimit, &agent_tracker);
+  MemoryTracker unlimited_tracker("unlimited");
+
+  query_tracker.Consume(70);
+  EXPECT_FALSE(query_tracker.IsNearLimit(0.8));
+  // The query has no limit of its own, but the agent is close to its limit.
+  query_tracker.Consume(20);
+  EXPECT_TRUE(query_tracker.IsNearLimit(0.8));
+  query_tracker.Release(90);
+
+  unlimited_tracker.Consume(1000);
+  EXPECT_FALSE(unlimited_tracker.IsNearLimit(0.0));
+  unlimited_tracker.Release(1000);
+}
+
+TEST(MemoryTrackerTest, ReleasesRemainderToParentOnDestruction) {
+  MemoryTracker agent_tracker("agent");
+  {
+    MemoryTracker query_tracker("query", MemoryTracker::kNoLimit, &agent_tracker);
+    query_tracker.Consume(100);
+    EXPECT_EQ(agent_tracker.consumed_bytes(), 100);
+  }
+  EXPECT_EQ(agent_tracker.consumed_bytes(), 0);
+}
+
+TEST(MemoryReservationTest, ReleasesOnReset) {
+  MemoryTracker tracker("test", 100);
+  {
+    MemoryReservation reservation;
+    reservation.set_tracker(&tracker);
+    reservation.Add(80);
+    reservation.Subtract(30);
+    EXPECT_EQ(reservation.bytes(), 50);
+    EXPECT_EQ(tracker.consumed_bytes(), 50);
+    EXPECT_OK(reservation.CheckLimit());
+
+    reservation.Add(60);
+    EXPECT_NOT_OK(reservation.CheckLimit());
+
+    reservation.Reset();
+    EXPECT_EQ(tracker.consumed_bytes(), 0);
+
+    reservation.Add(10);
+  }
+  EXPECT_EQ(tracker.consumed_bytes(), 0);
+}
+
+}  // namespace px
@@ -23,6 +23,7 @@
 
 #include <absl/base/internal/spinlock.h>
 #include "src/common/base/base.h"
+#include "src/common/memory/memory_tracker.h"
 
 namespace px {
 /**
@@ -41,6 +42,21 @@ class ObjectPool final : public px::NotCopyable {
     Clear();
     VLOG_IF(1, !name_.empty()) << "Deleting Object Pool: " << name_;
   }
+  /**
+   * Charges the size of the objects added from now on to the tracker, until they are cleared.
+   * The tracker must outlive the pool, or the pool must be cleared first.
+   */
+  void set_memory_tracker(MemoryTracker* tracker) {
+    absl::base_internal::SpinLockHolder lock(&lock_);
+    if (memory_tracker_ != nullptr) {
+      memory_tracker_->Release(tracked_bytes_);
+    }
+    memory_tracker_ = tracker;
+    if (memory_tracker_ != nullptr) {
+      memory_tracker_->Consume(tracked_bytes_);
+    }
+  }
+
   /**
    * Take ownership of passed in pointer.
    *
@@ -52,6 +68,10 @@ class ObjectPool final : public px::NotCopyable {
   T* Add(T* entity) {
     absl::base_internal::SpinLockHolder lock(&lock_);
     obj_list_.emplace_back(Entity{entity, [](void* obj) { delete reinterpret_cast<T*>(obj); }});
+    tracked_bytes_ += sizeof(T);
+    if (memory_tracker_ != nullptr) {
+      memory_tracker_->Consume(sizeof(T));
+    }
     return entity;
   }
 
@@ -61,6 +81,10 @@ class ObjectPool final : public px::NotCopyable {
       obj.delete_fn(obj.obj);
     }
     obj_list_.clear();
+    if (memory_tracker_ != nullptr) {
+      memory_tracker_->Release(tracked_bytes_);
+    }
+    tracked_bytes_ = 0;
   }
 
  private:
@@ -76,6 +100,10 @@ class ObjectPool final : public px::NotCopyable {
   const std::string name_;
   absl::base_internal::SpinLock lock_;
   std::vector<Entity> obj_list_;
+
+  MemoryTracker* memory_tracker_ = nullptr;
+  // The sum of sizeof() of the objects in obj_list_.
+  int64_t tracked_bytes_ = 0;
 };
 
 }  // namespace px
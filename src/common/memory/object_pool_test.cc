@@ -79,4 +79,18 @@ TEST(object_pool_test, test_different_objects) {
   EXPECT_EQ(1, count2);
 }
 
+TEST(object_pool_test, test_memory_tracker) {
+  int count = 0;
+  MemoryTracker tracker("test");
+  ObjectPool pool;
+  pool.Add(new TestObject(&count));
+  pool.set_memory_tracker(&tracker);
+  EXPECT_EQ(sizeof(TestObject), tracker.consumed_bytes());
+  pool.Add(new TestObject(&count));
+  pool.Add(new TestObjectTwo(&count));
+  EXPECT_EQ(2 * sizeof(TestObject) + sizeof(TestObjectTwo), tracker.consumed_bytes());
+  pool.Clear();
+  EXPECT_EQ(0, tracker.consumed_bytes());
+}
+
 }  // namespace px
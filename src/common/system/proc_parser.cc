@@ -16,6 +16,10 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
 #include <fstream>
 #include <limits>
 #include <string>
@@ -96,6 +100,90 @@ constexpr int kProcStatStartTimeField = 21;
 constexpr int kProcStatVSizeField = 22;
 constexpr int kProcStatRSSField = 23;
 
+/*************************************************
+ * Field offsets for the key-value files.
+ *************************************************/
+namespace {
+
+using ProcessStats = ProcParser::ProcessStats;
+using ProcessStatus = ProcParser::ProcessStatus;
+using ProcessSMaps = ProcParser::ProcessSMaps;
+
+const absl::flat_hash_map<std::string_view, size_t>& ProcPIDIOFieldOffsets() {
+  // Just to be safe when using offsetof, make sure object is standard layout.
+  static_assert(std::is_standard_layout<ProcessStats>::value);
+
+  static const absl::flat_hash_map<std::string_view, size_t> kFieldNameToOffsetMap{
+      {"rchar", offsetof(ProcessStats, rchar_bytes)},
+      {"wchar", offsetof(ProcessStats, wchar_bytes)},
+      {"read_bytes", offsetof(ProcessStats, read_bytes)},
+      {"write_bytes", offsetof(ProcessStats, write_bytes)},
+  };
+  return kFieldNameToOffsetMap;
+}
+
+const absl::flat_hash_map<std::string_view, size_t>& ProcPIDStatusFieldOffsets() {
+  // Just to be safe when using offsetof, make sure object is standard layout.
+  static_assert(std::is_standard_layout<ProcessStatus>::value);
+
+  // clang-format off
+  static const absl::flat_hash_map<std::string_view, size_t> kFieldNameToOffsetMap {
+      {"VmPeak", offsetof(ProcessStatus, vm_peak_bytes)},
+      {"VmSize", offsetof(ProcessStatus, vm_size_bytes)},
+      {"VmLck", offsetof(ProcessStatus, vm_lck_bytes)},
+      {"VmPin", offsetof(ProcessStatus, vm_pin_bytes)},
+      {"VmHWM", offsetof(ProcessStatus, vm_hwm_bytes)},
+      {"VmRSS", offsetof(ProcessStatus, vm_rss_bytes)},
+      {"RssAnon", offsetof(ProcessStatus, rss_anon_bytes)},
+      {"RssFile", offsetof(ProcessStatus, rss_file_bytes)},
+      {"RssShmem", offsetof(ProcessStatus, rss_shmem_bytes)},
+      {"VmData", offsetof(ProcessStatus, vm_data_bytes)},
+      {"VmStk", offsetof(ProcessStatus, vm_stk_bytes)},
+      {"VmExe", offsetof(ProcessStatus, vm_exe_bytes)},
+      {"VmLib", offsetof(ProcessStatus, vm_lib_bytes)},
+      {"VmPTE", offsetof(ProcessStatus, vm_pte_bytes)},
+      {"VmSwap", offsetof(ProcessStatus, vm_swap_bytes)},
+      {"HugetlbPages", offsetof(ProcessStatus, hugetlb_pages_bytes)},
+      {"voluntary_ctxt_switches", offsetof(ProcessStatus, voluntary_ctxt_switches)},
+      {"nonvoluntary_ctxt_switches", offsetof(ProcessStatus, nonvoluntary_ctxt_switches)},
+  };
+  // clang-format on
+  return kFieldNameToOffsetMap;
+}
+
+const absl::flat_hash_map<std::string_view, size_t>& ProcPIDSMapsFieldOffsets() {
+  // Just to be safe when using offsetof, make sure object is standard layout.
+  static_assert(std::is_standard_layout<ProcessSMaps>::value);
+
+  // clang-format off
+  static const absl::flat_hash_map<std::string_view, size_t> kFieldNameToOffsetMap {
+      {"Size", offsetof(ProcessSMaps, size_bytes)},
+      {"KernelPageSize", offsetof(ProcessSMaps, kernel_page_size_bytes)},
+      {"MMUPageSize", offsetof(ProcessSMaps, mmu_page_size_bytes)},
+      {"Rss", offsetof(ProcessSMaps, rss_bytes)},
+      {"Pss", offsetof(ProcessSMaps, pss_bytes)},
+      {"Shared_Clean", offsetof(ProcessSMaps, shared_clean_bytes)},
+      {"Shared_Dirty", offsetof(ProcessSMaps, shared_dirty_bytes)},
+      {"Private_Clean", offsetof(ProcessSMaps, private_clean_bytes)},
+      {"Private_Dirty", offsetof(ProcessSMaps, private_dirty_bytes)},
+      {"Referenced", offsetof(ProcessSMaps, referenced_bytes)},
+      {"Anonymous", offsetof(ProcessSMaps, anonymous_bytes)},
+      {"LazyFree", offsetof(ProcessSMaps, lazy_free_bytes)},
+      {"AnonHugePages", offsetof(ProcessSMaps, anon_huge_pages_bytes)},
+      {"ShmemPmdMapped", offsetof(ProcessSMaps, shmem_pmd_mapped_bytes)},
+      {"FilePmdMapped", offsetof(ProcessSMaps, file_pmd_mapped_bytes)},
+      {"Shared_Hugetlb", offsetof(ProcessSMaps, shared_hugetlb_bytes)},
+      {"Private_Hugetlb", offsetof(ProcessSMaps, private_hugetlb_bytes)},
+      {"Swap", offsetof(ProcessSMaps, swap_bytes)},
+      {"SwapPss", offsetof(ProcessSMaps, swap_pss_bytes)},
+      {"Locked", offsetof(ProcessSMaps, locked_bytes)},
+  };
+  // clang-format on
+  return kFieldNameToOffsetMap;
+}
+
+}  // namespace
+
 std::filesystem::path ProcParser::ProcPidPath(pid_t pid) const {
   return std::filesystem::path(proc_base_path_) / std::to_string(pid);
 }
@@ -283,17 +371,7 @@ Status ProcParser::ParseProcPIDStatIO(int32_t pid, ProcessStats* out) const {
   DCHECK(out != nullptr);
   std::string fpath = absl::Substitute("$0/$1/io", proc_base_path_, pid);
 
-  // Just to be safe when using offsetof, make sure object is standard layout.
-  static_assert(std::is_standard_layout<ProcessStats>::value);
-
-  static absl::flat_hash_map<std::string_view, size_t> field_name_to_offset_map{
-      {"rchar", offsetof(ProcessStats, rchar_bytes)},
-      {"wchar", offsetof(ProcessStats, wchar_bytes)},
-      {"read_bytes", offsetof(ProcessStats, read_bytes)},
-      {"write_bytes", offsetof(ProcessStats, write_bytes)},
-  };
-
-  return ParseFromKeyValueFile(fpath, field_name_to_offset_map, reinterpret_cast<uint8_t*>(out));
+  return ParseFromKeyValueFile(fpath, ProcPIDIOFieldOffsets(), reinterpret_cast<uint8_t*>(out));
 }
 
 Status ProcParser::ParseProcStat(SystemStats* out) const {
@@ -384,67 +462,14 @@ Status ProcParser::ParseProcPIDStatus(int32_t pid, ProcessStatus* out) const {
   CHECK(out != nullptr);
   std::string fpath = absl::Substitute("$0/$1/status", proc_base_path_, pid);
 
-  // Just to be safe when using offsetof, make sure object is standard layout.
-  static_assert(std::is_standard_layout<ProcessStatus>::value);
-
-  // clang-format off
-  static absl::flat_hash_map<std::string_view, size_t> field_name_to_offset_map {
-      {"VmPeak", offsetof(ProcessStatus, vm_peak_bytes)},
-      {"VmSize", offsetof(ProcessStatus, vm_size_bytes)},
-      {"VmLck", offsetof(ProcessStatus, vm_lck_bytes)},
-      {"VmPin", offsetof(ProcessStatus, vm_pin_bytes)},
-      {"VmHWM", offsetof(ProcessStatus, vm_hwm_bytes)},
-      {"VmRSS", offsetof(ProcessStatus, vm_rss_bytes)},
-      {"RssAnon", offsetof(ProcessStatus, rss_anon_bytes)},
-      {"RssFile", offsetof(ProcessStatus, rss_file_bytes)},
-      {"RssShmem", offsetof(ProcessStatus, rss_shmem_bytes)},
-      {"VmData", offsetof(ProcessStatus, vm_data_bytes)},
-      {"VmStk", offsetof(ProcessStatus, vm_stk_bytes)},
-      {"VmExe", offsetof(ProcessStatus, vm_exe_bytes)},
-      {"VmLib", offsetof(ProcessStatus, vm_lib_bytes)},
-      {"VmPTE", offsetof(ProcessStatus, vm_pte_bytes)},
-      {"VmSwap", offsetof(ProcessStatus, vm_swap_bytes)},
-      {"HugetlbPages", offsetof(ProcessStatus, hugetlb_pages_bytes)},
-      {"voluntary_ctxt_switches", offsetof(ProcessStatus, voluntary_ctxt_switches)},
-      {"nonvoluntary_ctxt_switches", offsetof(ProcessStatus, nonvoluntary_ctxt_switches)},
-  };
-  // clang-format on
-
-  return ParseFromKeyValueFile(fpath, field_name_to_offset_map, reinterpret_cast<uint8_t*>(out));
+  return ParseFromKeyValueFile(fpath, ProcPIDStatusFieldOffsets(),
+                               reinterpret_cast<uint8_t*>(out));
 }
 
 Status ProcParser::ParseProcPIDSMaps(int32_t pid, std::vector<ProcessSMaps>* out) const {
   CHECK(out != nullptr);
   std::string fpath = absl::Substitute("$0/$1/smaps", proc_base_path_, pid);
 
-  // Just to be safe when using offsetof, make sure object is standard layout.
-  static_assert(std::is_standard_layout<ProcessSMaps>::value);
-
-  // clang-format off
-  static absl::flat_hash_map<std::string_view, size_t> field_name_to_offset_map {
-      {"Size", offsetof(ProcessSMaps, size_bytes)},
-      {"KernelPageSize", offsetof(ProcessSMaps, kernel_page_size_bytes)},
-      {"MMUPageSize", offsetof(ProcessSMaps, mmu_page_size_bytes)},
-      {"Rss", offsetof(ProcessSMaps, rss_bytes)},
-      {"Pss", offsetof(ProcessSMaps, pss_bytes)},
-      {"Shared_Clean", offsetof(ProcessSMaps, shared_clean_bytes)},
-      {"Shared_Dirty", offsetof(ProcessSMaps, shared_dirty_bytes)},
-      {"Private_Clean", offsetof(ProcessSMaps, private_clean_bytes)},
-      {"Private_Dirty", offsetof(ProcessSMaps, private_dirty_bytes)},
-      {"Referenced", offsetof(ProcessSMaps, referenced_bytes)},
-      {"Anonymous", offsetof(ProcessSMaps, anonymous_bytes)},
-      {"LazyFree", offsetof(ProcessSMaps, lazy_free_bytes)},
-      {"AnonHugePages", offsetof(ProcessSMaps, anon_huge_pages_bytes)},
-      {"ShmemPmdMapped", offsetof(ProcessSMaps, shmem_pmd_mapped_bytes)},
-      {"FilePmdMapped", offsetof(ProcessSMaps, file_pmd_mapped_bytes)},
-      {"Shared_Hugetlb", offsetof(ProcessSMaps, shared_hugetlb_bytes)},
-      {"Private_Hugetlb", offsetof(ProcessSMaps, private_hugetlb_bytes)},
-      {"Swap", offsetof(ProcessSMaps, swap_bytes)},
-      {"SwapPss", offsetof(ProcessSMaps, swap_pss_bytes)},
-      {"Locked", offsetof(ProcessSMaps, locked_bytes)},
-  };
-  // clang-format on
-
   static constexpr int kProcMapNumFields = 6;
 
   std::ifstream ifs;
@@ -484,7 +509,8 @@ Status ProcParser::ParseProcPIDSMaps(int32_t pid, std::vector<ProcessSMaps>* out
       }
       continue;
     }
-    ParseFromKeyValueLine(line, field_name_to_offset_map, reinterpret_cast<uint8_t*>(&out->back()));
+    ParseFromKeyValueLine(line, ProcPIDSMapsFieldOffsets(),
+                          reinterpret_cast<uint8_t*>(&out->back()));
   }
 
   return Status::OK();
@@ -776,5 +802,379 @@ StatusOr<absl::flat_hash_set<std::string>> ProcParser::GetMapPaths(pid_t pid) co
   return map_paths;
 }
 
+/*************************************************
+ * BatchProcParser
+ *************************************************/
+
+namespace {
+
+// The scanners below are hand-rolled replacements for absl::StrSplit + absl::SimpleAtoi.
+// They operate on views into the read buffer, and never allocate.
+
+bool IsFieldSeparator(char c) { return c == ' ' || c == '\t'; }
+
+std::string_view StripFieldSeparators(std::string_view s) {
+  while (!s.empty() && IsFieldSeparator(s.front())) {
+    s.remove_prefix(1);
+  }
+  while (!s.empty() && IsFieldSeparator(s.back())) {
+    s.remove_suffix(1);
+  }
+  return s;
+}
+
+// Consumes and returns the next line (without the newline) from the front of s.
+std::string_view ConsumeLine(std::string_view* s) {
+  size_t pos = s->find('\n');
+  std::string_view line = s->substr(0, pos);
+  s->remove_prefix(pos == std::string_view::npos ? s->size() : pos + 1);
+  return line;
+}
+
+// Consumes and returns the next whitespace separated token from the front of s.
+std::string_view ConsumeToken(std::string_view* s) {
+  size_t i = 0;
+  while (i < s->size() && IsFieldSeparator((*s)[i])) {
+    ++i;
+  }
+  size_t start = i;
+  while (i < s->size() && !IsFieldSeparator((*s)[i]) && (*s)[i] != '\n') {
+    ++i;
+  }
+  std::string_view token = s->substr(start, i - start);
+  s->remove_prefix(i);
+  return token;
+}
+
+// Parses a base-10 integer that spans the entire token.
+template <typename TIntType>
+bool ParseDecimal(std::string_view token, TIntType* out) {
+  bool negative = false;
+  if (std::is_signed_v<TIntType> && !token.empty() && token.front() == '-') {
+    negative = true;
+    token.remove_prefix(1);
+  }
+  if (token.empty()) {
+    return false;
+  }
+  TIntType val = 0;
+  for (char c : token) {
+    if (c < '0' || c > '9') {
+      return false;
+    }
+    val = val * 10 + (c - '0');
+  }
+  *out = negative ? -val : val;
+  return true;
+}
+
+template <typename TIntType>
+bool ConsumeDecimal(std::string_view* s, TIntType* out) {
+  return ParseDecimal(ConsumeToken(s), out);
+}
+
+// Equivalent of ProcParser::ParseFromKeyValueLine.
+void ParseKeyValueLine(std::string_view line,
+                       const absl::flat_hash_map<std::string_view, size_t>& field_name_to_value_map,
+                       uint8_t* out_base) {
+  size_t colon_pos = line.find(':');
+  if (colon_pos == std::string_view::npos) {
+    return;
+  }
+
+  const auto it = field_name_to_value_map.find(line.substr(0, colon_pos));
+  if (it == field_name_to_value_map.end()) {
+    return;
+  }
+  auto val_ptr = reinterpret_cast<int64_t*>(out_base + it->second);
+
+  std::string_view val = StripFieldSeparators(line.substr(colon_pos + 1));
+  int64_t multiplier = 1;
+  if (absl::ConsumeSuffix(&val, " kB")) {
+    // Convert kB to bytes. proc seems to only use kB as the unit if it's present
+    // else there are no units.
+    val = StripFieldSeparators(val);
+    multiplier = 1024;
+  }
+
+  if (ParseDecimal(val, val_ptr)) {
+    *val_ptr *= multiplier;
+  } else {
+    *val_ptr = -1;
+  }
+}
+
+void ParseKeyValueContents(
+    std::string_view contents,
+    const absl::flat_hash_map<std::string_view, size_t>& field_name_to_value_map,
+    uint8_t* out_base) {
+  while (!contents.empty()) {
+    ParseKeyValueLine(ConsumeLine(&contents), field_name_to_value_map, out_base);
+  }
+}
+
+// Most /proc/<pid> files read by the parser are well under a page.
+constexpr size_t kInitialBufferSize = 4096;
+
+}  // namespace
+
+StatusOr<std::unique_ptr<BatchProcParser>> BatchProcParser::Create(const system::Config& cfg) {
+  CHECK(cfg.HasConfig()) << "System config is required for the BatchProcParser";
+  const std::string proc_path = cfg.proc_path().string();
+  int fd = open(proc_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return error::Internal("Failed to open proc directory $0 [errno=$1]", proc_path,
+                           std::strerror(errno));
+  }
+  return std::unique_ptr<BatchProcParser>(new BatchProcParser(fd, cfg));
+}
+
+BatchProcParser::BatchProcParser(int proc_dir_fd, const system::Config& cfg)
+    : proc_dir_fd_(proc_dir_fd),
+      ns_per_kernel_tick_(static_cast<int64_t>(1E9 / cfg.KernelTicksPerSecond())),
+      bytes_per_page_(cfg.PageSize()) {
+  buf_.resize(kInitialBufferSize);
+}
+
+BatchProcParser::~BatchProcParser() { close(proc_dir_fd_); }
+
+StatusOr<std::string_view> BatchProcParser::ReadFile(const char* rel_path) {
+  int fd = openat(proc_dir_fd_, rel_path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return error::Internal("Failed to open file $0 [errno=$1]", rel_path, std::strerror(errno));
+  }
+  DEFER(close(fd));
+
+  size_t size = 0;
+  while (true) {
+    if (size == buf_.size()) {
+      buf_.resize(2 * buf_.size());
+    }
+    ssize_t n = pread(fd, buf_.data() + size, buf_.size() - size, size);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return error::Internal("Failed to read file $0 [errno=$1]", rel_path, std::strerror(errno));
+    }
+    if (n == 0) {
+      break;
+    }
+    size += n;
+  }
+
+  return std::string_view(buf_.data(), size);
+}
+
+StatusOr<std::string_view> BatchProcParser::ReadPIDFile(int32_t pid, const char* file) {
+  // Large enough for any pid followed by the longest file name we read.
+  char rel_path[64];
+  snprintf(rel_path, sizeof(rel_path), "%d/%s", pid, file);
+  return ReadFile(rel_path);
+}
+
+Status BatchProcParser::ParseProcPIDStat(int32_t pid, ProcParser::ProcessStats* out) {
+  DCHECK(out != nullptr);
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadPIDFile(pid, "stat"));
+  contents = ConsumeLine(&contents);
+
+  // The process name is surrounded by (), and may itself contain spaces and parentheses,
+  // so it is delimited by the first '(' and the last ')'.
+  size_t name_start = contents.find('(');
+  size_t name_end = contents.rfind(')');
+  if (name_start == std::string_view::npos || name_end == std::string_view::npos ||
+      name_end <= name_start) {
+    return error::Internal("Failed to parse process name in stat file for pid $0.", pid);
+  }
+
+  bool ok = ParseDecimal(StripFieldSeparators(contents.substr(0, name_start)), &out->pid);
+  out->process_name.assign(contents.data() + name_start + 1, name_end - name_start - 1);
+
+  std::string_view fields = contents.substr(name_end + 1);
+  for (int field_idx = kProcStatProcessNameField + 1; field_idx <= kProcStatRSSField;
+       ++field_idx) {
+    switch (field_idx) {
+      case kProcStatMinorFaultsField:
+        ok &= ConsumeDecimal(&fields, &out->minor_faults);
+        break;
+      case kProcStatMajorFaultsField:
+        ok &= ConsumeDecimal(&fields, &out->major_faults);
+        break;
+      case kProcStatUTimeField:
+        ok &= ConsumeDecimal(&fields, &out->utime_ns);
+        break;
+      case kProcStatKTimeField:
+        ok &= ConsumeDecimal(&fields, &out->ktime_ns);
+        break;
+      case kProcStatNumThreadsField:
+        ok &= ConsumeDecimal(&fields, &out->num_threads);
+        break;
+      case kProcStatVSizeField:
+        ok &= ConsumeDecimal(&fields, &out->vsize_bytes);
+        break;
+      case kProcStatRSSField:
+        ok &= ConsumeDecimal(&fields, &out->rss_bytes);
+        break;
+      default:
+        ok &= !ConsumeToken(&fields).empty();
+        break;
+    }
+  }
+
+  if (!ok) {
+    // This should never happen since it requires the file to be ill-formed
+    // by the kernel.
+    return error::Internal("Failed to parse stat file for pid $0.", pid);
+  }
+
+  // The kernel tracks utime and ktime in kernel ticks.
+  out->utime_ns *= ns_per_kernel_tick_;
+  out->ktime_ns *= ns_per_kernel_tick_;
+  // RSS is in pages.
+  out->rss_bytes *= bytes_per_page_;
+
+  return Status::OK();
+}
+
+Status BatchProcParser::ParseProcPIDStatIO(int32_t pid, ProcParser::ProcessStats* out) {
+  DCHECK(out != nullptr);
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadPIDFile(pid, "io"));
+  ParseKeyValueContents(contents, ProcPIDIOFieldOffsets(), reinterpret_cast<uint8_t*>(out));
+  return Status::OK();
+}
+
+Status BatchProcParser::ParseProcPIDNetDev(int32_t pid, ProcParser::NetworkStats* out) {
+  DCHECK(out != nullptr);
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadPIDFile(pid, "net/dev"));
+
+  // Ignore the first two lines since they are just headers;
+  const int kHeaderLines = 2;
+  for (int i = 0; i < kHeaderLines; ++i) {
+    ConsumeLine(&contents);
+  }
+
+  // Number of values following the "<iface>:" prefix.
+  constexpr int kNumValues = kProcNetDevNumFields - 1;
+
+  while (!contents.empty()) {
+    std::string_view line = ConsumeLine(&contents);
+    if (line.empty()) {
+      continue;
+    }
+
+    // Large counters can be printed right after the colon, so split on it rather than on spaces.
+    size_t colon_pos = line.find(':');
+    if (colon_pos == std::string_view::npos) {
+      return error::Internal("Failed to parse net dev file for pid $0, missing interface.", pid);
+    }
+    std::string_view iface = StripFieldSeparators(line.substr(0, colon_pos));
+    std::string_view fields = line.substr(colon_pos + 1);
+
+    int64_t vals[kNumValues];
+    bool ok = true;
+    for (int i = 0; i < kNumValues; ++i) {
+      ok &= ConsumeDecimal(&fields, &vals[i]);
+    }
+    if (!ok) {
+      return error::Internal("Failed to parse net dev file for pid $0, incorrect fields.", pid);
+    }
+
+    if (!ShouldIncludeNetIFace(iface)) {
+      continue;
+    }
+
+    // Field indices include the interface name, which is not part of vals.
+    out->rx_bytes += vals[kProcNetDevRxBytesField - 1];
+    out->rx_packets += vals[kProcNetDevRxPacketsField - 1];
+    out->rx_errs += vals[kProcNetDevRxErrsField - 1];
+    out->rx_drops += vals[kProcNetDevRxDropField - 1];
+    out->tx_bytes += vals[kProcNetDevTxBytesField - 1];
+    out->tx_packets += vals[kProcNetDevTxPacketsField - 1];
+    out->tx_errs += vals[kProcNetDevTxErrsField - 1];
+    out->tx_drops += vals[kProcNetDevTxDropField - 1];
+  }
+
+  return Status::OK();
+}
+
+Status BatchProcParser::ParseProcPIDStatus(int32_t pid, ProcParser::ProcessStatus* out) {
+  DCHECK(out != nullptr);
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadPIDFile(pid, "status"));
+  ParseKeyValueContents(contents, ProcPIDStatusFieldOffsets(), reinterpret_cast<uint8_t*>(out));
+  return Status::OK();
+}
+
+Status BatchProcParser::ParseProcPIDSMaps(int32_t pid,
+                                          std::vector<ProcParser::ProcessSMaps>* out) {
+  DCHECK(out != nullptr);
+  PL_ASSIGN_OR_RETURN(std::string_view contents, ReadPIDFile(pid, "smaps"));
+
+  while (!contents.empty()) {
+    std::string_view line = ConsumeLine(&contents);
+    size_t colon_pos = line.find(':');
+    if (colon_pos == std::string_view::npos) {
+      continue;
+    }
+
+    // Same header detection as ProcParser::ParseProcPIDSMaps: if the character after the colon is
+    // not whitespace, the colon is part of the device (major:minor), and this is a header line:
+    // address                   perms offset   dev    inode             pathname
+    if (colon_pos + 1 < line.size() && !absl::ascii_isspace(line[colon_pos + 1])) {
+      std::string_view address = ConsumeToken(&line);
+      ConsumeToken(&line);  // perms
+      std::string_view offset = ConsumeToken(&line);
+      ConsumeToken(&line);  // dev
+      std::string_view inode = ConsumeToken(&line);
+      if (inode.empty()) {
+        return error::Internal("Failed to parse smaps file for pid $0.", pid);
+      }
+      std::string_view pathname = StripFieldSeparators(line);
+
+      auto& smap_info = out->emplace_back();
+      smap_info.address = address;
+      smap_info.offset = offset;
+      smap_info.pathname = pathname.empty() ? "[anonymous]" : pathname;
+      continue;
+    }
+
+    if (out->empty()) {
+      continue;
+    }
+    ParseKeyValueLine(line, ProcPIDSMapsFieldOffsets(), reinterpret_cast<uint8_t*>(&out->back()));
+  }
+
+  return Status::OK();
+}
+
+size_t BatchProcParser::ParseProcPIDStats(
+    const std::vector<int32_t>& pids,
+    const std::function<void(size_t idx, const ProcParser::ProcessStats& stats)>& fn) {
+  ProcParser::ProcessStats stats;
+  size_t num_parsed = 0;
+
+  for (size_t i = 0; i < pids.size(); ++i) {
+    stats.Clear();
+
+    Status s = ParseProcPIDStat(pids[i], &stats);
+    if (!s.ok()) {
+      VLOG(1) << absl::Substitute("Failed to fetch cpu stat info for PID ($0). Error=\"$1\".",
+                                  pids[i], s.msg());
+      continue;
+    }
+
+    s = ParseProcPIDStatIO(pids[i], &stats);
+    if (!s.ok()) {
+      VLOG(1) << absl::Substitute("Failed to fetch IO stat info for PID ($0). Error=\"$1\".",
+                                  pids[i], s.msg());
+      continue;
+    }
+
+    fn(i, stats);
+    ++num_parsed;
+  }
+
+  return num_parsed;
+}
+
 }  // namespace system
 }  // namespace px
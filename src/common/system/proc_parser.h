@@ -19,9 +19,12 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
 #include <istream>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -64,6 +67,13 @@ class ProcParser {
     int64_t tx_drops = 0;
 
     void Clear() { *this = NetworkStats(); }
+
+    bool operator==(const NetworkStats& other) const {
+      return rx_bytes == other.rx_bytes && rx_packets == other.rx_packets &&
+             rx_errs == other.rx_errs && rx_drops == other.rx_drops &&
+             tx_bytes == other.tx_bytes && tx_packets == other.tx_packets &&
+             tx_errs == other.tx_errs && tx_drops == other.tx_drops;
+    }
   };
 
   // ProcessStats are basic stats about the process collected from /proc.
@@ -95,6 +105,16 @@ class ProcParser {
     int64_t write_bytes = 0;
 
     void Clear() { *this = ProcessStats(); }
+
+    // Compares the sampled values only; pid and process_name are identifiers.
+    bool operator==(const ProcessStats& other) const {
+      return minor_faults == other.minor_faults && major_faults == other.major_faults &&
+             utime_ns == other.utime_ns && ktime_ns == other.ktime_ns &&
+             num_threads == other.num_threads && vsize_bytes == other.vsize_bytes &&
+             rss_bytes == other.rss_bytes && rchar_bytes == other.rchar_bytes &&
+             wchar_bytes == other.wchar_bytes && read_bytes == other.read_bytes &&
+             write_bytes == other.write_bytes;
+    }
   };
 
   /**
@@ -354,5 +374,80 @@ class ProcParser {
 
 StatusOr<int64_t> GetPIDStartTimeTicks(const std::filesystem::path& proc_pid_path);
 
+/**
+ * BatchProcParser is a faster alternative to ProcParser for the files that are read for
+ * every tracked PID on every sampling period (stat, io, net/dev, status and smaps).
+ *
+ * Instead of opening a std::ifstream and splitting lines into std::strings, it opens files
+ * with openat() relative to a cached /proc directory FD, reads them with pread() into a single
+ * reusable buffer, and extracts the fields with hand-rolled scanners.
+ *
+ * The parser holds mutable state (the buffer), so an instance must not be shared across threads.
+ */
+class BatchProcParser : public NotCopyMoveable {
+ public:
+  /**
+   * Creates a BatchProcParser for the proc filesystem configured in cfg.
+   * @param cfg a reference to the system config. Only needs to be valid for the
+   * duration of the call.
+   */
+  static StatusOr<std::unique_ptr<BatchProcParser>> Create(const system::Config& cfg);
+
+  ~BatchProcParser();
+
+  /**
+   * Parses /proc/<pid>/stat into out. Same output as ProcParser::ParseProcPIDStat.
+   */
+  Status ParseProcPIDStat(int32_t pid, ProcParser::ProcessStats* out);
+
+  /**
+   * Parses /proc/<pid>/io into out. Same output as ProcParser::ParseProcPIDStatIO.
+   */
+  Status ParseProcPIDStatIO(int32_t pid, ProcParser::ProcessStats* out);
+
+  /**
+   * Parses /proc/<pid>/net/dev into out. Same output as ProcParser::ParseProcPIDNetDev.
+   */
+  Status ParseProcPIDNetDev(int32_t pid, ProcParser::NetworkStats* out);
+
+  /**
+   * Parses /proc/<pid>/status into out. Same output as ProcParser::ParseProcPIDStatus.
+   */
+  Status ParseProcPIDStatus(int32_t pid, ProcParser::ProcessStatus* out);
+
+  /**
+   * Parses /proc/<pid>/smaps into out. Same output as ProcParser::ParseProcPIDSMaps.
+   */
+  Status ParseProcPIDSMaps(int32_t pid, std::vector<ProcParser::ProcessSMaps>* out);
+
+  /**
+   * Reads /proc/<pid>/stat and /proc/<pid>/io for each of the pids, and invokes fn with the
+   * index of the pid and its stats. PIDs whose files cannot be read or parsed (typically because
+   * the process has exited) are skipped. The stats object passed to fn is reused across calls.
+   *
+   * @return The number of PIDs for which fn was invoked.
+   */
+  size_t ParseProcPIDStats(
+      const std::vector<int32_t>& pids,
+      const std::function<void(size_t idx, const ProcParser::ProcessStats& stats)>& fn);
+
+ private:
+  BatchProcParser(int proc_dir_fd, const system::Config& cfg);
+
+  // Reads the file at the path relative to the proc directory into buf_.
+  // The returned view is valid until the next call.
+  StatusOr<std::string_view> ReadFile(const char* rel_path);
+
+  // Reads the /proc/<pid>/<file> into buf_.
+  StatusOr<std::string_view> ReadPIDFile(int32_t pid, const char* file);
+
+  const int proc_dir_fd_;
+  const int64_t ns_per_kernel_tick_;
+  const int32_t bytes_per_page_;
+
+  // Reused across all reads, so that steady-state parsing does not allocate.
+  std::string buf_;
+};
+
 }  // namespace system
 }  // namespace px
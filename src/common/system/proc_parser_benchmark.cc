@@ -0,0 +1,145 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/common/system/config_mock.h"
+#include "src/common/system/proc_parser.h"
+#include "src/common/testing/test_environment.h"
+
+using ::px::system::BatchProcParser;
+using ::px::system::MockConfig;
+using ::px::system::ProcParser;
+using ::px::testing::TestFilePath;
+using ::testing::Return;
+using ::testing::ReturnRef;
+
+// This benchmark compares ProcParser and BatchProcParser on the proc tree under testdata.
+// Each iteration reads the stats of kNumPIDs processes, which mimics what
+// ProcessStatsConnector does for every tracked UPID on every sampling period.
+
+constexpr int32_t kPID = 123;
+constexpr int kNumPIDs = 1000;
+
+const std::filesystem::path& ProcPath() {
+  static const std::filesystem::path kProcPath = TestFilePath("src/common/system/testdata/proc");
+  return kProcPath;
+}
+
+std::unique_ptr<MockConfig> MakeConfig() {
+  auto sysconfig = std::make_unique<MockConfig>();
+  EXPECT_CALL(*sysconfig, HasConfig()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*sysconfig, PageSize()).WillRepeatedly(Return(4096));
+  EXPECT_CALL(*sysconfig, KernelTicksPerSecond()).WillRepeatedly(Return(100));
+  EXPECT_CALL(*sysconfig, proc_path()).WillRepeatedly(ReturnRef(ProcPath()));
+  return sysconfig;
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ProcParser_ProcessStats(benchmark::State& state) {
+  ProcParser parser(*MakeConfig());
+
+  for (auto _ : state) {
+    for (int i = 0; i < kNumPIDs; ++i) {
+      ProcParser::ProcessStats stats;
+      PL_CHECK_OK(parser.ParseProcPIDStat(kPID, &stats));
+      PL_CHECK_OK(parser.ParseProcPIDStatIO(kPID, &stats));
+      benchmark::DoNotOptimize(stats);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPIDs);
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_BatchProcParser_ProcessStats(benchmark::State& state) {
+  std::unique_ptr<MockConfig> sysconfig = MakeConfig();
+  PL_ASSIGN_OR_EXIT(std::unique_ptr<BatchProcParser> parser, BatchProcParser::Create(*sysconfig));
+  const std::vector<int32_t> pids(kNumPIDs, kPID);
+
+  for (auto _ : state) {
+    size_t num_parsed = parser->ParseProcPIDStats(
+        pids, [](size_t /*idx*/, const ProcParser::ProcessStats& stats) {
+          benchmark::DoNotOptimize(stats);
+        });
+    CHECK_EQ(num_parsed, pids.size());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPIDs);
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ProcParser_NetDev(benchmark::State& state) {
+  ProcParser parser(*MakeConfig());
+
+  for (auto _ : state) {
+    for (int i = 0; i < kNumPIDs; ++i) {
+      ProcParser::NetworkStats stats;
+      PL_CHECK_OK(parser.ParseProcPIDNetDev(kPID, &stats));
+      benchmark::DoNotOptimize(stats);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPIDs);
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_BatchProcParser_NetDev(benchmark::State& state) {
+  std::unique_ptr<MockConfig> sysconfig = MakeConfig();
+  PL_ASSIGN_OR_EXIT(std::unique_ptr<BatchProcParser> parser, BatchProcParser::Create(*sysconfig));
+
+  for (auto _ : state) {
+    for (int i = 0; i < kNumPIDs; ++i) {
+      ProcParser::NetworkStats stats;
+      PL_CHECK_OK(parser->ParseProcPIDNetDev(kPID, &stats));
+      benchmark::DoNotOptimize(stats);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPIDs);
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_ProcParser_SMaps(benchmark::State& state) {
+  ProcParser parser(*MakeConfig());
+
+  for (auto _ : state) {
+    std::vector<ProcParser::ProcessSMaps> stats;
+    PL_CHECK_OK(parser.ParseProcPIDSMaps(789, &stats));
+    benchmark::DoNotOptimize(stats);
+  }
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_BatchProcParser_SMaps(benchmark::State& state) {
+  std::unique_ptr<MockConfig> sysconfig = MakeConfig();
+  PL_ASSIGN_OR_EXIT(std::unique_ptr<BatchProcParser> parser, BatchProcParser::Create(*sysconfig));
+
+  for (auto _ : state) {
+    std::vector<ProcParser::ProcessSMaps> stats;
+    PL_CHECK_OK(parser->ParseProcPIDSMaps(789, &stats));
+    benchmark::DoNotOptimize(stats);
+  }
+}
+
+BENCHMARK(BM_ProcParser_ProcessStats);
+BENCHMARK(BM_BatchProcParser_ProcessStats);
+BENCHMARK(BM_ProcParser_NetDev);
+BENCHMARK(BM_BatchProcParser_NetDev);
+BENCHMARK(BM_ProcParser_SMaps);
+BENCHMARK(BM_BatchProcParser_SMaps);
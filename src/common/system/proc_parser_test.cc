@@ -24,6 +24,8 @@
 #include <istream>
 #include <memory>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 #include "src/common/fs/fs_wrapper.h"
 #include "src/common/system/config_mock.h"
@@ -341,6 +343,127 @@ TEST_F(ProcParserTest, GetMapPaths) {
   }
 }
 
+class BatchProcParserTest : public ProcParserTest {
+ protected:
+  void SetUp() override {
+    ProcParserTest::SetUp();
+
+    system::MockConfig sysconfig;
+    EXPECT_CALL(sysconfig, HasConfig()).WillRepeatedly(Return(true));
+    EXPECT_CALL(sysconfig, PageSize()).WillRepeatedly(Return(4096));
+    EXPECT_CALL(sysconfig, KernelTicksPerSecond()).WillRepeatedly(Return(10000000));
+    EXPECT_CALL(sysconfig, proc_path()).WillRepeatedly(ReturnRef(proc_path_));
+    ASSERT_OK_AND_ASSIGN(batch_parser_, BatchProcParser::Create(sysconfig));
+  }
+
+  std::unique_ptr<BatchProcParser> batch_parser_;
+};
+
+TEST_F(BatchProcParserTest, ParsePidStat) {
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(batch_parser_->ParseProcPIDStat(123, &stats));
+
+  EXPECT_EQ(4602, stats.pid);
+  EXPECT_EQ("ibazel", stats.process_name);
+
+  EXPECT_EQ(800, stats.utime_ns);
+  EXPECT_EQ(2300, stats.ktime_ns);
+  EXPECT_EQ(13, stats.num_threads);
+
+  EXPECT_EQ(55, stats.major_faults);
+  EXPECT_EQ(1799, stats.minor_faults);
+
+  EXPECT_EQ(114384896, stats.vsize_bytes);
+  EXPECT_EQ(2577 * bytes_per_page_, stats.rss_bytes);
+}
+
+TEST_F(BatchProcParserTest, ParseStatIO) {
+  ProcParser::ProcessStats stats;
+  ASSERT_OK(batch_parser_->ParseProcPIDStatIO(123, &stats));
+
+  EXPECT_EQ(5405203, stats.rchar_bytes);
+  EXPECT_EQ(1239158, stats.wchar_bytes);
+  EXPECT_EQ(17838080, stats.read_bytes);
+  EXPECT_EQ(634880, stats.write_bytes);
+}
+
+TEST_F(BatchProcParserTest, ParseNetworkStat) {
+  ProcParser::NetworkStats stats;
+  ASSERT_OK(batch_parser_->ParseProcPIDNetDev(123, &stats));
+
+  EXPECT_EQ(54504114, stats.rx_bytes);
+  EXPECT_EQ(65296, stats.rx_packets);
+  EXPECT_EQ(0, stats.rx_drops);
+  EXPECT_EQ(0, stats.rx_errs);
+
+  EXPECT_EQ(4258632, stats.tx_bytes);
+  EXPECT_EQ(39739, stats.tx_packets);
+  EXPECT_EQ(0, stats.tx_drops);
+  EXPECT_EQ(0, stats.tx_errs);
+}
+
+TEST_F(BatchProcParserTest, ParsePIDStatusMatchesProcParser) {
+  for (int32_t pid : {1, 789}) {
+    ProcParser::ProcessStatus expected;
+    ASSERT_OK(parser_->ParseProcPIDStatus(pid, &expected));
+
+    ProcParser::ProcessStatus stats;
+    ASSERT_OK(batch_parser_->ParseProcPIDStatus(pid, &stats));
+
+    EXPECT_EQ(expected.vm_peak_bytes, stats.vm_peak_bytes);
+    EXPECT_EQ(expected.vm_size_bytes, stats.vm_size_bytes);
+    EXPECT_EQ(expected.vm_lck_bytes, stats.vm_lck_bytes);
+    EXPECT_EQ(expected.vm_pin_bytes, stats.vm_pin_bytes);
+    EXPECT_EQ(expected.vm_hwm_bytes, stats.vm_hwm_bytes);
+    EXPECT_EQ(expected.vm_rss_bytes, stats.vm_rss_bytes);
+    EXPECT_EQ(expected.rss_anon_bytes, stats.rss_anon_bytes);
+    EXPECT_EQ(expected.vm_data_bytes, stats.vm_data_bytes);
+    EXPECT_EQ(expected.vm_pte_bytes, stats.vm_pte_bytes);
+    EXPECT_EQ(expected.voluntary_ctxt_switches, stats.voluntary_ctxt_switches);
+    EXPECT_EQ(expected.nonvoluntary_ctxt_switches, stats.nonvoluntary_ctxt_switches);
+  }
+}
+
+TEST_F(BatchProcParserTest, ParsePIDSMapsMatchesProcParser) {
+  std::vector<ProcParser::ProcessSMaps> expected;
+  ASSERT_OK(parser_->ParseProcPIDSMaps(789, &expected));
+
+  std::vector<ProcParser::ProcessSMaps> stats;
+  ASSERT_OK(batch_parser_->ParseProcPIDSMaps(789, &stats));
+
+  ASSERT_EQ(expected.size(), stats.size());
+  for (size_t i = 0; i < stats.size(); ++i) {
+    EXPECT_EQ(expected[i].address, stats[i].address);
+    EXPECT_EQ(expected[i].offset, stats[i].offset);
+    EXPECT_EQ(expected[i].pathname, stats[i].pathname);
+    EXPECT_EQ(expected[i].size_bytes, stats[i].size_bytes);
+    EXPECT_EQ(expected[i].rss_bytes, stats[i].rss_bytes);
+    EXPECT_EQ(expected[i].pss_bytes, stats[i].pss_bytes);
+    EXPECT_EQ(expected[i].private_clean_bytes, stats[i].private_clean_bytes);
+    EXPECT_EQ(expected[i].referenced_bytes, stats[i].referenced_bytes);
+    EXPECT_EQ(expected[i].locked_bytes, stats[i].locked_bytes);
+  }
+}
+
+TEST_F(BatchProcParserTest, ParseProcPIDStats) {
+  // PID 456 has no io file, and PID 999 does not exist; both are skipped.
+  const std::vector<int32_t> pids = {123, 456, 999};
+
+  std::vector<std::pair<size_t, int64_t>> results;
+  size_t num_parsed = batch_parser_->ParseProcPIDStats(
+      pids, [&results](size_t idx, const ProcParser::ProcessStats& stats) {
+        results.emplace_back(idx, stats.rchar_bytes);
+      });
+
+  EXPECT_EQ(num_parsed, 1);
+  EXPECT_THAT(results, ElementsAre(std::pair<size_t, int64_t>{0, 5405203}));
+}
+
+TEST_F(BatchProcParserTest, MissingPID) {
+  ProcParser::ProcessStats stats;
+  EXPECT_NOT_OK(batch_parser_->ParseProcPIDStat(999, &stats));
+}
+
 // Check ProcParser can detect itself.
 TEST(ProcParserGetExePathTest, CheckTestProcess) {
   // Since bazel prepares test files as symlinks, creating testdata/proc/123/exe symlink would
@@ -52,6 +52,8 @@ class ColumnWrapper {
   virtual ~ColumnWrapper() = default;
 
   static SharedColumnWrapper Make(DataType data_type, size_t size);
+  // Makes an empty ArrowColumnWrapper, whose buffers are allocated from mem_pool.
+  static SharedColumnWrapper MakeArrowBacked(DataType data_type, arrow::MemoryPool* mem_pool);
   static SharedColumnWrapper FromArrow(const std::shared_ptr<arrow::Array>& arr);
 
   virtual BaseValueType* UnsafeRawData() = 0;
@@ -66,6 +68,10 @@ class ColumnWrapper {
   virtual void ShrinkToFit() = 0;
   virtual std::shared_ptr<arrow::Array> ConvertToArrow(arrow::MemoryPool* mem_pool) = 0;
 
+  // Whether the values are stored in arrow buffers (see ArrowColumnWrapper), in which case they
+  // can only be read through ConvertToArrow().
+  virtual bool IsArrowBacked() const { return false; }
+
   template <class TValueType>
   void Append(TValueType val);
 
@@ -182,6 +188,136 @@ inline int64_t ColumnWrapperTmpl<StringValue>::Bytes() const {
   return bytes;
 }
 
+/**
+ * A ColumnWrapper that appends its values directly into arrow buffers, with the string values
+ * contiguous in a single buffer, so that ConvertToArrow() hands over the buffers instead of copying
+ * the values. The values can't be accessed through Get() or UnsafeRawData(); they are read from
+ * the array returned by ConvertToArrow() (or by GetValue()).
+ *
+ * Reading the values finishes the builder. Appending after that copies the values back into a new
+ * builder, so the column should only be read once it is complete.
+ * @tparam T The UDFValueType.
+ */
+template <typename T>
+class ArrowColumnWrapper : public ColumnWrapper {
+  static constexpr DataType kDataType = ValueTypeTraits<T>::data_type;
+  using ArrowBuilderType = typename DataTypeTraits<kDataType>::arrow_builder_type;
+  using ArrowArrayType = typename DataTypeTraits<kDataType>::arrow_array_type;
+
+ public:
+  explicit ArrowColumnWrapper(arrow::MemoryPool* mem_pool)
+      : mem_pool_(mem_pool), builder_(mem_pool) {}
+  ArrowColumnWrapper(std::shared_ptr<arrow::Array> arr, arrow::MemoryPool* mem_pool)
+      : mem_pool_(mem_pool), builder_(mem_pool), array_(std::move(arr)) {}
+
+  ~ArrowColumnWrapper() override = default;
+
+  // There are no value types to point to.
+  T* UnsafeRawData() override { return nullptr; }
+  const T* UnsafeRawData() const override { return nullptr; }
+  DataType data_type() const override { return kDataType; }
+  bool IsArrowBacked() const override { return true; }
+
+  size_t Size() const override { return array_ != nullptr ? array_->length() : builder_.length(); }
+  bool Empty() const override { return Size() == 0; }
+
+  int64_t Bytes() const override {
+    if constexpr (std::is_same_v<T, StringValue>) {
+      if (array_ == nullptr) {
+        return builder_.value_data_length();
+      }
+      auto arr = static_cast<const ArrowArrayType*>(array_.get());
+      return arr->value_offset(arr->length()) - arr->value_offset(0);
+    } else {
+      return Size() * sizeof(T);
+    }
+  }
+
+  // The buffers are owned by mem_pool_, the pool passed in is unused.
+  std::shared_ptr<arrow::Array> ConvertToArrow(arrow::MemoryPool* /* mem_pool */) override {
+    return Finished();
+  }
+
+  auto GetValue(size_t idx) const {
+    return GetValueFromArrowArray<kDataType>(Finished().get(), idx);
+  }
+
+  void Append(const T& val) {
+    Reopen();
+    if constexpr (std::is_same_v<T, StringValue>) {
+      PL_CHECK_OK(builder_.Append(val));
+    } else {
+      PL_CHECK_OK(builder_.Append(val.val));
+    }
+  }
+
+  void Reserve(size_t size) override {
+    Reopen();
+    if (size > static_cast<size_t>(builder_.length())) {
+      PL_CHECK_OK(builder_.Reserve(size - builder_.length()));
+    }
+  }
+
+  void Clear() override {
+    builder_.Reset();
+    array_.reset();
+  }
+
+  // Finishing the builder already shrinks its buffers to fit.
+  void ShrinkToFit() override {}
+
+  SharedColumnWrapper CopyIndexes(const std::vector<size_t>& indexes) const override {
+    DCHECK_LE(indexes.size(), Size());
+    const arrow::Array* arr = Finished().get();
+    auto copy = std::make_shared<ArrowColumnWrapper<T>>(mem_pool_);
+    PL_CHECK_OK(copy->builder_.Reserve(indexes.size()));
+    for (size_t idx : indexes) {
+      PL_CHECK_OK(copy->builder_.Append(GetValueFromArrowArray<kDataType>(arr, idx)));
+    }
+    return copy;
+  }
+
+  // A contiguous ascending run of indexes (the common case of records appended in time order)
+  // is moved as a zero-copy slice of the buffers. Other indexes are copied.
+  SharedColumnWrapper MoveIndexes(const std::vector<size_t>& indexes) override {
+    DCHECK_LE(indexes.size(), Size());
+    for (size_t i = 1; i < indexes.size(); ++i) {
+      if (indexes[i] != indexes[0] + i) {
+        return CopyIndexes(indexes);
+      }
+    }
+    int64_t offset = indexes.empty() ? 0 : indexes[0];
+    return std::make_shared<ArrowColumnWrapper<T>>(Finished()->Slice(offset, indexes.size()),
+                                                   mem_pool_);
+  }
+
+ private:
+  const std::shared_ptr<arrow::Array>& Finished() const {
+    if (array_ == nullptr) {
+      PL_CHECK_OK(builder_.Finish(&array_));
+    }
+    return array_;
+  }
+
+  // Moves the values of a finished column back into the builder, so that it can be appended to.
+  void Reopen() {
+    if (array_ == nullptr) {
+      return;
+    }
+    std::shared_ptr<arrow::Array> arr = std::move(array_);
+    PL_CHECK_OK(builder_.Reserve(arr->length()));
+    for (int64_t i = 0; i < arr->length(); ++i) {
+      PL_CHECK_OK(builder_.Append(GetValueFromArrowArray<kDataType>(arr.get(), i)));
+    }
+  }
+
+  arrow::MemoryPool* mem_pool_;
+  // Only one of the two holds the values: the builder until the column is read, and the finished
+  // array after that.
+  mutable ArrowBuilderType builder_;
+  mutable std::shared_ptr<arrow::Array> array_;
+};
+
 // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
 using BoolValueColumnWrapper = ColumnWrapperTmpl<BoolValue>;
 using Int64ValueColumnWrapper = ColumnWrapperTmpl<Int64Value>;
@@ -288,11 +424,39 @@ inline SharedColumnWrapper ColumnWrapper::Make(DataType data_type, size_t size)
   }
 }
 
+/**
+ * Create an arrow backed column wrapper.
+ * @param data_type The UDFDataType
+ * @param mem_pool The MemoryPool to allocate the buffers from.
+ * @return A shared_ptr to the ColumnWrapper.
+ * PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+ */
+inline SharedColumnWrapper ColumnWrapper::MakeArrowBacked(DataType data_type,
+                                                          arrow::MemoryPool* mem_pool) {
+  switch (data_type) {
+    case DataType::BOOLEAN:
+      return std::make_shared<ArrowColumnWrapper<BoolValue>>(mem_pool);
+    case DataType::INT64:
+      return std::make_shared<ArrowColumnWrapper<Int64Value>>(mem_pool);
+    case DataType::UINT128:
+      return std::make_shared<ArrowColumnWrapper<UInt128Value>>(mem_pool);
+    case DataType::FLOAT64:
+      return std::make_shared<ArrowColumnWrapper<Float64Value>>(mem_pool);
+    case DataType::STRING:
+      return std::make_shared<ArrowColumnWrapper<StringValue>>(mem_pool);
+    case DataType::TIME64NS:
+      return std::make_shared<ArrowColumnWrapper<Time64NSValue>>(mem_pool);
+    default:
+      CHECK(0) << "Unknown data type";
+  }
+}
+
 template <class TValueType>
 inline void ColumnWrapper::Append(TValueType val) {
   CHECK_EQ(data_type(), ValueTypeTraits<TValueType>::data_type)
       << "Expect " << ToString(data_type()) << " got "
       << ToString(ValueTypeTraits<TValueType>::data_type);
+  DCHECK(!IsArrowBacked()) << "Append to an ArrowColumnWrapper directly.";
   static_cast<ColumnWrapperTmpl<TValueType>*>(this)->Append(val);
 }
 
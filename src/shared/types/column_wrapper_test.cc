@@ -283,5 +283,89 @@ TEST(ColumnWrapperTest, MoveIndexes) {
   }
 }
 
+TEST(ArrowColumnWrapperTest, ConvertToArrow) {
+  auto col = ColumnWrapper::MakeArrowBacked(DataType::STRING, arrow::default_memory_pool());
+  EXPECT_TRUE(col->IsArrowBacked());
+  EXPECT_EQ(DataType::STRING, col->data_type());
+  col->Reserve(4);
+
+  auto* string_col = static_cast<ArrowColumnWrapper<StringValue>*>(col.get());
+  string_col->Append("abc");
+  string_col->Append("de");
+  string_col->Append("fghij");
+  EXPECT_EQ(col->Size(), 3);
+  EXPECT_EQ(col->Bytes(), 10);
+
+  auto arr = col->ConvertToArrow(arrow::default_memory_pool());
+  ASSERT_EQ(arr->length(), 3);
+  EXPECT_EQ(arr->type_id(), DataTypeTraits<DataType::STRING>::arrow_type_id);
+  auto string_arr = static_cast<arrow::StringArray*>(arr.get());
+  EXPECT_EQ(string_arr->GetString(0), "abc");
+  EXPECT_EQ(string_arr->GetString(2), "fghij");
+  EXPECT_EQ(col->Bytes(), 10);
+
+  // Converting again returns the same buffers.
+  EXPECT_EQ(col->ConvertToArrow(arrow::default_memory_pool()), arr);
+}
+
+TEST(ArrowColumnWrapperTest, AppendAfterConvertToArrow) {
+  ArrowColumnWrapper<Time64NSValue> col(arrow::default_memory_pool());
+  col.Append(1);
+  col.Append(2);
+  auto arr = col.ConvertToArrow(arrow::default_memory_pool());
+  EXPECT_EQ(arr->length(), 2);
+
+  col.Append(3);
+  ASSERT_EQ(col.Size(), 3);
+  EXPECT_EQ(col.GetValue(0), 1);
+  EXPECT_EQ(col.GetValue(2), 3);
+  // The array returned before is left untouched.
+  EXPECT_EQ(arr->length(), 2);
+}
+
+TEST(ArrowColumnWrapperTest, MoveIndexes) {
+  auto make_col = []() {
+    auto col = std::make_shared<ArrowColumnWrapper<Int64Value>>(arrow::default_memory_pool());
+    for (int64_t v : {5, 8, 1, 9, 0, 6, 3, 7, 2, 4}) {
+      col->Append(v);
+    }
+    return col;
+  };
+
+  // Contiguous indexes are moved as a slice.
+  {
+    auto col = make_col();
+    auto arr = col->ConvertToArrow(arrow::default_memory_pool());
+
+    auto new_col = col->MoveIndexes({2, 3, 4});
+    ASSERT_TRUE(new_col->IsArrowBacked());
+    auto new_arr = new_col->ConvertToArrow(arrow::default_memory_pool());
+    ASSERT_EQ(new_arr->length(), 3);
+    EXPECT_EQ(new_arr->data()->buffers[1], arr->data()->buffers[1]);
+    auto int_arr = static_cast<arrow::Int64Array*>(new_arr.get());
+    EXPECT_EQ(int_arr->Value(0), 1);
+    EXPECT_EQ(int_arr->Value(1), 9);
+    EXPECT_EQ(int_arr->Value(2), 0);
+  }
+
+  // Other indexes are copied.
+  {
+    auto col = make_col();
+    auto new_col = col->MoveIndexes({4, 2, 8, 6, 9, 0, 5, 7, 1, 3});
+    auto* int_col = static_cast<ArrowColumnWrapper<Int64Value>*>(new_col.get());
+    ASSERT_EQ(int_col->Size(), 10);
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(int_col->GetValue(i), i);
+    }
+  }
+
+  // Test empty reorder index.
+  {
+    auto col = make_col();
+    auto new_col = col->MoveIndexes({});
+    ASSERT_EQ(new_col->Size(), 0);
+  }
+}
+
 }  // namespace types
 }  // namespace px
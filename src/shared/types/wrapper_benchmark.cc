@@ -19,9 +19,11 @@
 #include <benchmark/benchmark.h>
 
 #include <random>
+#include <string>
 #include <vector>
 #include "src/common/benchmark/benchmark.h"
 #include "src/common/datagen/datagen.h"
+#include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/types.h"
 
 using px::types::Int64Value;
@@ -65,3 +67,35 @@ static void BM_Int64Vector(benchmark::State& state) {  // NOLINT
 
 BENCHMARK_TEMPLATE(BM_Int64Vector, int64_t)->Arg(10000);
 BENCHMARK_TEMPLATE(BM_Int64Vector, Int64Value)->Arg(10000);
+
+// Appends state.range(0) strings of state.range(1) bytes to a string column, and converts it to
+// arrow, as a batch of records goes from Stirling to the table store.
+template <bool TArrowBacked>
+static void BM_StringColumnToArrow(benchmark::State& state) {  // NOLINT
+  const int64_t num_values = state.range(0);
+  const std::string value(state.range(1), 'x');
+
+  for (auto _ : state) {
+    px::types::SharedColumnWrapper col;
+    if constexpr (TArrowBacked) {
+      col = px::types::ColumnWrapper::MakeArrowBacked(px::types::DataType::STRING,
+                                                      arrow::default_memory_pool());
+    } else {
+      col = px::types::ColumnWrapper::Make(px::types::DataType::STRING, 0);
+    }
+    col->Reserve(num_values);
+    for (int64_t i = 0; i < num_values; ++i) {
+      if constexpr (TArrowBacked) {
+        static_cast<px::types::ArrowColumnWrapper<px::types::StringValue>*>(col.get())
+            ->Append(value);
+      } else {
+        col->Append<px::types::StringValue>(value);
+      }
+    }
+    benchmark::DoNotOptimize(col->ConvertToArrow(arrow::default_memory_pool()));
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * num_values * value.size());
+}
+
+BENCHMARK_TEMPLATE(BM_StringColumnToArrow, false)->Args({1024, 64})->Args({1024, 1024});
+BENCHMARK_TEMPLATE(BM_StringColumnToArrow, true)->Args({1024, 64})->Args({1024, 1024});
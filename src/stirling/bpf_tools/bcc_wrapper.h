@@ -358,6 +358,8 @@ class BCCWrapper {
     return bpf_.get_array_table<TValueType>(table_name);
   }
 
+  ebpf::BPFTable GetTable(const std::string& table_name) { return bpf_.get_table(table_name); }
+
   ebpf::BPFStackTable GetStackTable(const std::string& table_name) {
     return bpf_.get_stack_table(table_name);
   }
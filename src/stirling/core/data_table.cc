@@ -27,13 +27,19 @@
 #include "src/stirling/core/types.h"
 #include "src/stirling/utils/index_sorted_vector.h"
 
+DEFINE_bool(stirling_arrow_record_buffers, false,
+            "If true, records are appended directly into arrow buffers, which the table store "
+            "adopts without converting them. Consumers of the records must then read them through "
+            "ColumnWrapper::ConvertToArrow().");
+
 namespace px {
 namespace stirling {
 
 using types::ColumnWrapper;
 using types::DataType;
 
-DataTable::DataTable(uint64_t id, const DataTableSchema& schema) : id_(id), table_schema_(schema) {}
+DataTable::DataTable(uint64_t id, const DataTableSchema& schema)
+    : id_(id), arrow_buffers_(FLAGS_stirling_arrow_record_buffers), table_schema_(schema) {}
 
 void DataTable::InitBuffers(types::ColumnWrapperRecordBatch* record_batch_ptr) {
   DCHECK(record_batch_ptr != nullptr);
@@ -42,6 +48,13 @@ void DataTable::InitBuffers(types::ColumnWrapperRecordBatch* record_batch_ptr) {
   for (const auto& element : table_schema_.elements()) {
     px::types::DataType type = element.type();
 
+    if (arrow_buffers_) {
+      auto col = types::ColumnWrapper::MakeArrowBacked(type, arrow::default_memory_pool());
+      col->Reserve(kTargetCapacity);
+      record_batch_ptr->push_back(col);
+      continue;
+    }
+
 #define TYPE_CASE(_dt_)                           \
   auto col = types::ColumnWrapper::Make(_dt_, 0); \
   col->Reserve(kTargetCapacity);                  \
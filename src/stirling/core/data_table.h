@@ -30,6 +30,8 @@
 #include "src/common/base/mixins.h"
 #include "src/stirling/core/types.h"
 
+DECLARE_bool(stirling_arrow_record_buffers);
+
 namespace px {
 namespace stirling {
 
@@ -130,14 +132,14 @@ class DataTable : public NotCopyable {
   class RecordBuilder {
    public:
     RecordBuilder(DataTable* data_table, types::TabletIDView tablet_id, uint64_t time = 0)
-        : tablet_(*data_table->GetTablet(tablet_id)) {
+        : tablet_(*data_table->GetTablet(tablet_id)), arrow_buffers_(data_table->arrow_buffers_) {
       static_assert(schema->tabletized());
       tablet_id_ = tablet_id;
       Init(time);
     }
 
     explicit RecordBuilder(DataTable* data_table, uint64_t time = 0)
-        : tablet_(*data_table->GetTablet("")) {
+        : tablet_(*data_table->GetTablet("")), arrow_buffers_(data_table->arrow_buffers_) {
       static_assert(!schema->tabletized());
       Init(time);
     }
@@ -151,22 +153,31 @@ class DataTable : public NotCopyable {
     template <const size_t TIndex, const size_t TMaxStringBytes = 1024>
     inline void Append(
         typename types::DataTypeTraits<schema->elements()[TIndex].type()>::value_type val) {
+      using TValueType =
+          typename types::DataTypeTraits<schema->elements()[TIndex].type()>::value_type;
+
       if constexpr (TIndex == schema->tabletization_key()) {
         // TODO(oazizi): This will probably break if val is ever StringValue.
         DCHECK(std::to_string(val.val) == tablet_id_);
       }
 
-      if constexpr (std::is_same_v<typename types::DataTypeTraits<
-                                       schema->elements()[TIndex].type()>::value_type,
-                                   types::StringValue>) {
+      if constexpr (std::is_same_v<TValueType, types::StringValue>) {
         if (val.size() > TMaxStringBytes) {
           val.resize(TMaxStringBytes);
           val.append(kTruncatedMsg);
         }
-        val.shrink_to_fit();
+        // The arrow buffers copy the string, so only the vector of strings needs it shrunk.
+        if (!arrow_buffers_) {
+          val.shrink_to_fit();
+        }
       }
 
-      tablet_.records[TIndex]->Append(std::move(val));
+      if (arrow_buffers_) {
+        static_cast<types::ArrowColumnWrapper<TValueType>*>(tablet_.records[TIndex].get())
+            ->Append(val);
+      } else {
+        tablet_.records[TIndex]->Append(std::move(val));
+      }
       DCHECK(!signature_[TIndex]) << absl::Substitute(
           "Attempt to Append() to column $0 (name=$1) multiple times", TIndex,
           schema->ColName(TIndex));
@@ -196,6 +207,7 @@ class DataTable : public NotCopyable {
     }
 
     Tablet& tablet_;
+    const bool arrow_buffers_;
     std::bitset<schema->elements().size()> signature_;
     types::TabletIDView tablet_id_ = "";
   };
@@ -209,14 +221,18 @@ class DataTable : public NotCopyable {
   class DynamicRecordBuilder {
    public:
     DynamicRecordBuilder(DataTable* data_table, types::TabletIDView tablet_id, uint64_t time = 0)
-        : schema_(data_table->table_schema_), tablet_(*data_table->GetTablet(tablet_id)) {
+        : schema_(data_table->table_schema_),
+          tablet_(*data_table->GetTablet(tablet_id)),
+          arrow_buffers_(data_table->arrow_buffers_) {
       DCHECK(schema_.tabletized());
       tablet_id_ = tablet_id;
       Init(time);
     }
 
     explicit DynamicRecordBuilder(DataTable* data_table, uint64_t time = 0)
-        : schema_(data_table->table_schema_), tablet_(*data_table->GetTablet("")) {
+        : schema_(data_table->table_schema_),
+          tablet_(*data_table->GetTablet("")),
+          arrow_buffers_(data_table->arrow_buffers_) {
       DCHECK(!schema_.tabletized());
       Init(time);
     }
@@ -231,7 +247,14 @@ class DataTable : public NotCopyable {
         }
       }
 
-      tablet_.records[col_index]->Append(std::move(val));
+      if (arrow_buffers_) {
+        DCHECK_EQ(tablet_.records[col_index]->data_type(),
+                  types::ValueTypeTraits<TValueType>::data_type);
+        static_cast<types::ArrowColumnWrapper<TValueType>*>(tablet_.records[col_index].get())
+            ->Append(val);
+      } else {
+        tablet_.records[col_index]->Append(std::move(val));
+      }
 
       DCHECK(!signature_[col_index])
           << absl::Substitute("Attempt to Append() to column $0 (name=$1) multiple times",
@@ -257,6 +280,7 @@ class DataTable : public NotCopyable {
     const DataTableSchema& schema_;
     std::bitset<kMaxSupportedColumns> signature_ = 0;
     Tablet& tablet_;
+    const bool arrow_buffers_;
     types::TabletIDView tablet_id_ = "";
   };
 
@@ -269,6 +293,10 @@ class DataTable : public NotCopyable {
   // Unique ID set by InfoClassManager.
   const uint64_t id_;
 
+  // Whether the records are appended into arrow buffers (see types::ArrowColumnWrapper), which the
+  // table store adopts without converting them. Set from --stirling_arrow_record_buffers.
+  const bool arrow_buffers_;
+
   // Initialize a new Active record batch.
   void InitBuffers(types::ColumnWrapperRecordBatch* record_batch_ptr);
 
@@ -22,6 +22,7 @@
 
 #include "src/stirling/core/data_table.h"
 #include "src/stirling/source_connectors/seq_gen/sequence_generator.h"
+#include "src/stirling/testing/common.h"
 
 namespace px {
 namespace stirling {
@@ -69,6 +70,52 @@ TEST_F(DataTableTest, ResultIsSorted) {
   }
 }
 
+TEST_F(DataTableTest, ArrowRecordBuffers) {
+  PL_SET_FOR_SCOPE(FLAGS_stirling_arrow_record_buffers, true);
+  data_table_ = std::make_unique<DataTable>(/*id*/ 0, kSchema);
+
+  std::vector<int> time_vals = {0, 10, 20, 40, 30};
+  std::vector<std::string> s_vals = {"a", "b", "c", "e", "d"};
+
+  for (size_t i = 0; i < time_vals.size(); ++i) {
+    DataTable::RecordBuilder<&kSchema> r(data_table_.get(), time_vals[i]);
+    r.Append<r.ColIndex("time_")>(time_vals[i]);
+    r.Append<r.ColIndex("x")>(i);
+    r.Append<r.ColIndex("s")>(s_vals[i]);
+  }
+
+  // The in-order records up to the cutoff are pushed as slices of the arrow buffers.
+  data_table_->SetConsumeRecordsCutoffTime(20);
+  std::vector<TaggedRecordBatch> tablets = data_table_->ConsumeRecords();
+  ASSERT_EQ(tablets.size(), 1);
+  types::ColumnWrapperRecordBatch& rb = tablets[0].records;
+  ASSERT_EQ(rb[0]->Size(), 3);
+  ASSERT_TRUE(rb[2]->IsArrowBacked());
+  auto s_col = static_cast<types::ArrowColumnWrapper<types::StringValue>*>(rb[2].get());
+  EXPECT_EQ(s_col->GetValue(0), "a");
+  EXPECT_EQ(s_col->GetValue(2), "c");
+
+  // The carried over records are sorted, and appended to.
+  {
+    DataTable::RecordBuilder<&kSchema> r(data_table_.get(), 50);
+    r.Append<r.ColIndex("time_")>(50);
+    r.Append<r.ColIndex("x")>(5);
+    r.Append<r.ColIndex("s")>("f");
+  }
+  data_table_->SetConsumeRecordsCutoffTime(50);
+  tablets = data_table_->ConsumeRecords();
+  ASSERT_EQ(tablets.size(), 1);
+  types::ColumnWrapperRecordBatch& rb2 = tablets[0].records;
+  ASSERT_EQ(rb2[0]->Size(), 3);
+  auto time_col = static_cast<types::ArrowColumnWrapper<types::Time64NSValue>*>(rb2[0].get());
+  s_col = static_cast<types::ArrowColumnWrapper<types::StringValue>*>(rb2[2].get());
+  EXPECT_EQ(time_col->GetValue(0), 30);
+  EXPECT_EQ(time_col->GetValue(1), 40);
+  EXPECT_EQ(time_col->GetValue(2), 50);
+  EXPECT_EQ(s_col->GetValue(0), "d");
+  EXPECT_EQ(s_col->GetValue(2), "f");
+}
+
 // No time passed to RecordBuilder, so all timestamps should be zero.
 // That means there should never be any expired or carry-over records.
 // Also, nothing should be sorted in any way.
@@ -18,16 +18,27 @@
 
 #include "src/stirling/obj_tools/dwarf_reader.h"
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <cstring>
 
+#include <absl/strings/escaping.h>
+#include <farmhash.h>
 #include <llvm/DebugInfo/DIContext.h>
 #include <llvm/Object/ObjectFile.h>
 
+#include "src/common/base/file.h"
 #include "src/shared/types/typespb/wrapper/types_pb_wrapper.h"
 #include "src/stirling/obj_tools/abi_model.h"
 #include "src/stirling/obj_tools/dwarf_utils.h"
 #include "src/stirling/obj_tools/init.h"
 
+DEFINE_string(stirling_dwarf_index_cache_dir, "",
+              "If set, the DWARF name index of traced binaries is persisted to this directory, "
+              "keyed by build ID, so that redeploying a tracepoint or re-attaching Go uprobes "
+              "does not re-index the binary.");
+
 namespace px {
 namespace stirling {
 namespace obj_tools {
@@ -55,6 +66,53 @@ std::vector<DWARFDie> GetParamDIEs(const DWARFDie& function_die) {
 // https://superuser.com/questions/791506/how-to-determine-if-a-linux-binary-file-is-32-bit-or-64-bit
 uint8_t kAddressSize = sizeof(void*);
 
+namespace {
+
+// Returns the build ID held in the ELF notes of the object file, or empty if there is none.
+// Prefers the GNU build-id over the Go build ID, same as ElfReader.
+std::string ReadBuildID(const llvm::object::ObjectFile& obj_file) {
+  std::string go_build_id;
+  for (const llvm::object::SectionRef& section : obj_file.sections()) {
+    llvm::Expected<llvm::StringRef> name = section.getName();
+    if (!name) {
+      llvm::consumeError(name.takeError());
+      continue;
+    }
+    std::string_view section_name(name->data(), name->size());
+    if (section_name != kGNUBuildIDSection && section_name != kGoBuildIDSection) {
+      continue;
+    }
+    llvm::Expected<llvm::StringRef> contents = section.getContents();
+    if (!contents) {
+      llvm::consumeError(contents.takeError());
+      continue;
+    }
+    std::string_view desc = ELFNoteDesc(std::string_view(contents->data(), contents->size()));
+    if (section_name == kGNUBuildIDSection && !desc.empty()) {
+      return absl::BytesToHexString(desc);
+    }
+    go_build_id = std::string(desc);
+  }
+  return go_build_id;
+}
+
+StatusOr<std::unique_ptr<llvm::object::Binary>> CreateObjectFile(
+    const llvm::MemoryBuffer& buffer) {
+  llvm::Expected<std::unique_ptr<llvm::object::Binary>> bin_or_err =
+      llvm::object::createBinary(buffer.getMemBufferRef());
+  std::error_code ec = errorToErrorCode(bin_or_err.takeError());
+  if (ec) {
+    return error::Internal("DwarfReader $0: $1", ec.message(),
+                           buffer.getBufferIdentifier().str());
+  }
+  if (!llvm::isa<llvm::object::ObjectFile>(bin_or_err->get())) {
+    return error::Internal("Could not create DWARFContext.");
+  }
+  return std::move(bin_or_err.get());
+}
+
+}  // namespace
+
 StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateWithoutIndexing(
     const std::filesystem::path& path) {
   using llvm::MemoryBuffer;
@@ -71,20 +129,12 @@ StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateWithoutIndexing(
   }
 
   std::unique_ptr<MemoryBuffer> buffer = std::move(buff_or_err.get());
-  llvm::Expected<std::unique_ptr<llvm::object::Binary>> bin_or_err =
-      llvm::object::createBinary(*buffer);
-  ec = errorToErrorCode(bin_or_err.takeError());
-  if (ec) {
-    return error::Internal("DwarfReader $0: $1", ec.message(), obj_filename);
-  }
-
-  auto* obj_file = llvm::dyn_cast<llvm::object::ObjectFile>(bin_or_err->get());
-  if (!obj_file) {
-    return error::Internal("Could not create DWARFContext.");
-  }
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<llvm::object::Binary> bin, CreateObjectFile(*buffer));
+  auto* obj_file = llvm::cast<llvm::object::ObjectFile>(bin.get());
 
   auto dwarf_reader = std::unique_ptr<DwarfReader>(
       new DwarfReader(std::move(buffer), DWARFContext::create(*obj_file)));
+  dwarf_reader->build_id_ = ReadBuildID(*obj_file);
 
   PL_RETURN_IF_ERROR(dwarf_reader->DetectSourceLanguage());
 
@@ -94,14 +144,40 @@ StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateWithoutIndexing(
 StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateIndexingAll(
     const std::filesystem::path& path) {
   PL_ASSIGN_OR_RETURN(auto dwarf_reader, CreateWithoutIndexing(path));
-  dwarf_reader->IndexDIEs(std::nullopt);
+  IndexDIEs(dwarf_reader->dwarf_context_.get(), std::nullopt, &dwarf_reader->die_map_);
   return dwarf_reader;
 }
 
 StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateWithSelectiveIndexing(
     const std::filesystem::path& path, const std::vector<SymbolSearchPattern>& symbol_patterns) {
   PL_ASSIGN_OR_RETURN(auto dwarf_reader, CreateWithoutIndexing(path));
-  dwarf_reader->IndexDIEs(symbol_patterns);
+  IndexDIEs(dwarf_reader->dwarf_context_.get(), symbol_patterns, &dwarf_reader->die_map_);
+  return dwarf_reader;
+}
+
+StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::CreateWithLazyIndexing(
+    const std::filesystem::path& path, const std::filesystem::path& index_cache_dir) {
+  PL_ASSIGN_OR_RETURN(auto dwarf_reader, CreateWithoutIndexing(path));
+
+  std::filesystem::path index_path;
+  if (!index_cache_dir.empty() && !dwarf_reader->build_id_.empty()) {
+    index_path = index_cache_dir / absl::StrCat(dwarf_reader->build_id_, ".dwarf_index");
+    Status s = dwarf_reader->LoadNameIndex(index_path);
+    if (s.ok()) {
+      return dwarf_reader;
+    }
+    VLOG(1) << absl::Substitute("Could not load DWARF index of $0: $1", path.string(), s.msg());
+  }
+
+  PL_RETURN_IF_ERROR(dwarf_reader->BuildNameIndex());
+
+  if (!index_path.empty()) {
+    Status s = dwarf_reader->SaveNameIndex(index_path);
+    if (!s.ok()) {
+      LOG(WARNING) << absl::Substitute("Could not save DWARF index of $0: $1", path.string(),
+                                       s.msg());
+    }
+  }
   return dwarf_reader;
 }
 
@@ -173,14 +249,16 @@ Status DwarfReader::DetectSourceLanguage() {
 }
 
 void DwarfReader::IndexDIEs(
-    const std::optional<std::vector<SymbolSearchPattern>>& symbol_search_patterns_opt) {
+    llvm::DWARFContext* dwarf_context,
+    const std::optional<std::vector<SymbolSearchPattern>>& symbol_search_patterns_opt,
+    DIEMap* die_map) {
   absl::flat_hash_map<const llvm::DWARFDebugInfoEntry*, std::string> dwarf_entry_names;
 
   // Map from DW_AT_specification to DIE. Only DW_TAG_subprogram can have this attribute.
   // Also only applies to CPP binaries.
   absl::flat_hash_map<uint64_t, DWARFDie> fn_spec_offsets;
 
-  DWARFContext::unit_iterator_range units = dwarf_context_->normal_units();
+  DWARFContext::unit_iterator_range units = dwarf_context->normal_units();
   for (const std::unique_ptr<llvm::DWARFUnit>& unit : units) {
     for (const llvm::DWARFDebugInfoEntry& entry : unit->dies()) {
       DWARFDie die = {unit.get(), &entry};
@@ -231,13 +309,13 @@ void DwarfReader::IndexDIEs(
         }
 
         if (IsIndexedType(tag)) {
-          InsertToDIEMap(std::move(name), tag, die);
+          InsertToDIEMap(std::move(name), tag, die, die_map);
         }
       }
     }
   }
 
-  auto& fn_dies = die_map_[llvm::dwarf::DW_TAG_subprogram];
+  auto& fn_dies = (*die_map)[llvm::dwarf::DW_TAG_subprogram];
 
   for (auto iter = fn_dies.begin(); iter != fn_dies.end(); ++iter) {
     uint64_t offset = iter->second.getOffset();
@@ -262,6 +340,13 @@ StatusOr<std::vector<DWARFDie>> DwarfReader::GetMatchingDIEs(
     }
     return std::vector<DWARFDie>{};
   }
+  if (type_opt.has_value() && IsIndexedType(type_opt.value()) && !name_index_.empty()) {
+    auto die_opt = FindInNameIndex(name, type_opt.value());
+    if (die_opt.has_value()) {
+      return std::vector<DWARFDie>{die_opt.value()};
+    }
+    return std::vector<DWARFDie>{};
+  }
 
   // When there is no index, fall-back to manual search.
   std::vector<DWARFDie> dies;
@@ -717,8 +802,9 @@ Status DwarfReader::FlattenedStructSpec(const llvm::DWARFDie& struct_die,
   return Status::OK();
 }
 
-void DwarfReader::InsertToDIEMap(std::string name, llvm::dwarf::Tag tag, llvm::DWARFDie die) {
-  auto& die_type_map = die_map_[tag];
+void DwarfReader::InsertToDIEMap(std::string name, llvm::dwarf::Tag tag, llvm::DWARFDie die,
+                                 DIEMap* die_map) {
+  auto& die_type_map = (*die_map)[tag];
   // TODO(oazizi): What's the right way to deal with duplicate names?
   // Only appears to happen with structs like the following:
   //  ThreadStart, _IO_FILE, _IO_marker, G, in6_addr
@@ -743,6 +829,158 @@ std::optional<llvm::DWARFDie> DwarfReader::FindInDIEMap(const std::string& name,
   return die_iter->second;
 }
 
+namespace {
+
+// The fingerprint must be stable across processes, since the index is persisted.
+uint64_t NameFingerprint(std::string_view name) {
+  return ::util::Fingerprint64(name.data(), name.size());
+}
+
+// Returns the name under which IndexDIEs() indexes the DIE, which is qualified by the names of
+// the enclosing namespaces, classes, structs and functions.
+std::string IndexedName(const DWARFDie& die) {
+  std::string name(GetShortName(die));
+  for (DWARFDie parent = die.getParent(); parent.isValid(); parent = parent.getParent()) {
+    if (!IsIndexedType(parent.getTag()) && !IsNamespace(parent.getTag())) {
+      break;
+    }
+    std::string_view parent_name = GetShortName(parent);
+    if (parent_name.empty()) {
+      break;
+    }
+    name = absl::StrCat(parent_name, "::", name);
+  }
+  return name;
+}
+
+// The persisted index is a header followed by the entries. The size of the object guards against
+// an index left behind by another object with the same build ID, e.g. a rebuilt binary whose
+// build ID was set by hand.
+struct NameIndexFileHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t object_size;
+  uint64_t num_entries;
+};
+
+struct NameIndexFileEntry {
+  uint64_t fingerprint;
+  uint64_t offset;
+  uint32_t tag;
+  uint32_t reserved;
+};
+
+constexpr char kNameIndexMagic[4] = {'P', 'X', 'D', 'I'};
+constexpr uint32_t kNameIndexVersion = 2;
+
+}  // namespace
+
+Status DwarfReader::BuildNameIndex() {
+  // Walk a separate context, whose parsed DIEs are all released when it goes out of scope.
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<llvm::object::Binary> bin,
+                      CreateObjectFile(*memory_buffer_));
+  std::unique_ptr<DWARFContext> dwarf_context =
+      DWARFContext::create(*llvm::cast<llvm::object::ObjectFile>(bin.get()));
+
+  DIEMap die_map;
+  IndexDIEs(dwarf_context.get(), std::nullopt, &die_map);
+
+  name_index_.clear();
+  for (const auto& [tag, die_type_map] : die_map) {
+    for (const auto& [name, die] : die_type_map) {
+      name_index_.try_emplace({tag, NameFingerprint(name)}, die.getOffset());
+    }
+  }
+  return Status::OK();
+}
+
+Status DwarfReader::LoadNameIndex(const std::filesystem::path& index_path) {
+  PL_ASSIGN_OR_RETURN(std::string contents, ReadFileToString(index_path));
+
+  NameIndexFileHeader header;
+  if (contents.size() < sizeof(header)) {
+    return error::Internal("Truncated DWARF index $0.", index_path.string());
+  }
+  std::memcpy(&header, contents.data(), sizeof(header));
+  if (std::memcmp(header.magic, kNameIndexMagic, sizeof(kNameIndexMagic)) != 0 ||
+      header.version != kNameIndexVersion) {
+    return error::Internal("Unrecognized DWARF index $0.", index_path.string());
+  }
+  if (header.object_size != memory_buffer_->getBufferSize()) {
+    return error::Internal("Stale DWARF index $0.", index_path.string());
+  }
+  if (contents.size() != sizeof(header) + header.num_entries * sizeof(NameIndexFileEntry)) {
+    return error::Internal("Truncated DWARF index $0.", index_path.string());
+  }
+
+  name_index_.clear();
+  name_index_.reserve(header.num_entries);
+  const char* pos = contents.data() + sizeof(header);
+  for (uint64_t i = 0; i < header.num_entries; ++i, pos += sizeof(NameIndexFileEntry)) {
+    NameIndexFileEntry entry;
+    std::memcpy(&entry, pos, sizeof(entry));
+    name_index_.try_emplace({entry.tag, entry.fingerprint}, entry.offset);
+  }
+  return Status::OK();
+}
+
+Status DwarfReader::SaveNameIndex(const std::filesystem::path& index_path) const {
+  NameIndexFileHeader header = {};
+  std::memcpy(header.magic, kNameIndexMagic, sizeof(kNameIndexMagic));
+  header.version = kNameIndexVersion;
+  header.object_size = memory_buffer_->getBufferSize();
+  header.num_entries = name_index_.size();
+
+  std::string contents;
+  contents.reserve(sizeof(header) + name_index_.size() * sizeof(NameIndexFileEntry));
+  contents.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto& [key, offset] : name_index_) {
+    NameIndexFileEntry entry = {};
+    entry.tag = key.first;
+    entry.fingerprint = key.second;
+    entry.offset = offset;
+    contents.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+  }
+
+  // Write to a temporary file first, so that concurrent readers never see a partial index.
+  std::filesystem::path tmp_path = index_path;
+  tmp_path += absl::StrCat(".", getpid(), ".tmp");
+  PL_RETURN_IF_ERROR(WriteFileFromString(tmp_path, contents));
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, index_path, ec);
+  if (ec) {
+    return error::Internal("Could not write DWARF index $0: $1", index_path.string(),
+                           ec.message());
+  }
+  return Status::OK();
+}
+
+std::optional<llvm::DWARFDie> DwarfReader::FindInNameIndex(std::string_view name,
+                                                           llvm::dwarf::Tag tag) const {
+  auto iter = name_index_.find({tag, NameFingerprint(name)});
+  if (iter == name_index_.end()) {
+    return std::nullopt;
+  }
+
+  // Only parses the compile unit that holds the DIE.
+  DWARFDie die = dwarf_context_->getDIEForOffset(iter->second);
+  if (!die.isValid()) {
+    return std::nullopt;
+  }
+
+  // Guards against fingerprint collisions. Function definitions of C++ are indexed under the name
+  // of their declaration, see IndexDIEs().
+  DWARFDie named_die = die;
+  if (DWARFDie spec_die = die.getAttributeValueAsReferencedDie(llvm::dwarf::DW_AT_specification);
+      spec_die.isValid()) {
+    named_die = spec_die;
+  }
+  if (IndexedName(named_die) != name) {
+    return std::nullopt;
+  }
+  return die;
+}
+
 StatusOr<TypeInfo> DwarfReader::DereferencePointerType(std::string type_name) {
   PL_ASSIGN_OR_RETURN(const DWARFDie& die,
                       GetMatchingDIE(type_name, llvm::dwarf::DW_TAG_pointer_type));
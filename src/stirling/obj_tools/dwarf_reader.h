@@ -35,6 +35,8 @@
 #include "src/stirling/obj_tools/abi_model.h"
 #include "src/stirling/obj_tools/utils.h"
 
+DECLARE_string(stirling_dwarf_index_cache_dir);
+
 namespace px {
 namespace stirling {
 namespace obj_tools {
@@ -161,6 +163,17 @@ class DwarfReader {
   static StatusOr<std::unique_ptr<DwarfReader>> CreateWithSelectiveIndexing(
       const std::filesystem::path& path, const std::vector<SymbolSearchPattern>& symbol_patterns);
 
+  /**
+   * Creates a DwarfReader with a compact index that maps the names of indexed DIEs to their
+   * offsets. DIEs are only parsed when looked up, one compile unit at a time.
+   *
+   * Building the index walks all DIEs once, but the parsed DIEs are released afterwards. If
+   * index_cache_dir is provided and the object has a build ID, the index is persisted there and
+   * reused by later readers of the same build, which then skip the walk altogether.
+   */
+  static StatusOr<std::unique_ptr<DwarfReader>> CreateWithLazyIndexing(
+      const std::filesystem::path& path, const std::filesystem::path& index_cache_dir = {});
+
   /**
    * Searches the debug information for Debugging information entries (DIEs)
    * that match the name.
@@ -294,7 +307,19 @@ class DwarfReader {
   const llvm::dwarf::SourceLanguage& source_language() const { return source_language_; }
   const std::string& compiler() const { return compiler_; }
 
+  /**
+   * The build ID of the object (GNU build-id in hex, or the Go build ID), or empty if it has none.
+   */
+  const std::string& build_id() const { return build_id_; }
+
  private:
+  // Nested map: [tag][symbol_name] -> DWARFDie
+  using DIEMap =
+      absl::flat_hash_map<llvm::dwarf::Tag, absl::flat_hash_map<std::string, llvm::DWARFDie>>;
+
+  // Compact index: [tag, fingerprint of symbol_name] -> offset of the DIE in .debug_info.
+  using NameIndex = absl::flat_hash_map<std::pair<uint32_t, uint64_t>, uint64_t>;
+
   DwarfReader(std::unique_ptr<llvm::MemoryBuffer> buffer,
               std::unique_ptr<llvm::DWARFContext> dwarf_context);
 
@@ -306,7 +331,17 @@ class DwarfReader {
   //
   // If the search patterns are not provided, all DIEs of the matching tags are indexed.
   // Otherwise, only the ones whose names match are indexed.
-  void IndexDIEs(const std::optional<std::vector<SymbolSearchPattern>>& symbol_search_patterns_opt);
+  static void IndexDIEs(
+      llvm::DWARFContext* dwarf_context,
+      const std::optional<std::vector<SymbolSearchPattern>>& symbol_search_patterns_opt,
+      DIEMap* die_map);
+
+  // Builds name_index_ from a separate DWARFContext, so that the DIEs parsed while walking are
+  // released once done, and dwarf_context_ only parses the compile units that are looked up.
+  Status BuildNameIndex();
+  Status LoadNameIndex(const std::filesystem::path& index_path);
+  Status SaveNameIndex(const std::filesystem::path& index_path) const;
+  std::optional<llvm::DWARFDie> FindInNameIndex(std::string_view name, llvm::dwarf::Tag tag) const;
 
   // Walks the struct_die for all members, recursively visiting any members which are also structs,
   // to capture information of all base type members of the struct in a flattened form.
@@ -314,18 +349,21 @@ class DwarfReader {
   Status FlattenedStructSpec(const llvm::DWARFDie& struct_die, std::vector<StructSpecEntry>* output,
                              const std::string& path_prefix, int offset);
 
-  void InsertToDIEMap(std::string name, llvm::dwarf::Tag tag, llvm::DWARFDie die);
+  static void InsertToDIEMap(std::string name, llvm::dwarf::Tag tag, llvm::DWARFDie die,
+                             DIEMap* die_map);
   std::optional<llvm::DWARFDie> FindInDIEMap(const std::string& name, llvm::dwarf::Tag tag) const;
 
   // Records the source language of the DWARF information.
   llvm::dwarf::SourceLanguage source_language_;
   std::string compiler_;
 
+  std::string build_id_;
+
   std::unique_ptr<llvm::MemoryBuffer> memory_buffer_;
   std::unique_ptr<llvm::DWARFContext> dwarf_context_;
 
-  // Nested map: [tag][symbol_name] -> DWARFDie
-  absl::flat_hash_map<llvm::dwarf::Tag, absl::flat_hash_map<std::string, llvm::DWARFDie>> die_map_;
+  DIEMap die_map_;
+  NameIndex name_index_;
 };
 
 }  // namespace obj_tools
@@ -18,6 +18,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include <filesystem>
+
 #include "src/common/base/base.h"
 #include "src/common/testing/test_environment.h"
 #include "src/stirling/obj_tools/dwarf_reader.h"
@@ -105,5 +107,50 @@ static void BM_indexed(benchmark::State& state) {
   }
 }
 
+// Builds the name index on each iteration, as on the first time a binary is seen.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_lazy_cold(benchmark::State& state) {
+  size_t num_lookup_iterations = state.range(0);
+
+  for (auto _ : state) {
+    SymAddrs symaddrs;
+
+    PL_ASSIGN_OR_EXIT(std::unique_ptr<DwarfReader> dwarf_reader,
+                      DwarfReader::CreateWithLazyIndexing(kBinary));
+
+    for (size_t i = 0; i < num_lookup_iterations; ++i) {
+      GetSymAddrs(dwarf_reader.get(), &symaddrs);
+      benchmark::DoNotOptimize(symaddrs);
+    }
+  }
+}
+
+// Loads the name index persisted by an earlier reader of the same binary.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_lazy_warm(benchmark::State& state) {
+  size_t num_lookup_iterations = state.range(0);
+
+  const std::filesystem::path cache_dir =
+      std::filesystem::temp_directory_path() / "dwarf_reader_benchmark";
+  std::filesystem::create_directories(cache_dir);
+  PL_CHECK_OK(DwarfReader::CreateWithLazyIndexing(kBinary, cache_dir));
+
+  for (auto _ : state) {
+    SymAddrs symaddrs;
+
+    PL_ASSIGN_OR_EXIT(std::unique_ptr<DwarfReader> dwarf_reader,
+                      DwarfReader::CreateWithLazyIndexing(kBinary, cache_dir));
+
+    for (size_t i = 0; i < num_lookup_iterations; ++i) {
+      GetSymAddrs(dwarf_reader.get(), &symaddrs);
+      benchmark::DoNotOptimize(symaddrs);
+    }
+  }
+
+  std::filesystem::remove_all(cache_dir);
+}
+
 BENCHMARK(BM_noindex)->RangeMultiplier(2)->Range(1, 16);
 BENCHMARK(BM_indexed)->RangeMultiplier(2)->Range(1, 16);
+BENCHMARK(BM_lazy_cold)->RangeMultiplier(2)->Range(1, 16);
+BENCHMARK(BM_lazy_warm)->RangeMultiplier(2)->Range(1, 16);
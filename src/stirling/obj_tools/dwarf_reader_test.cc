@@ -47,13 +47,24 @@ using ::testing::UnorderedElementsAre;
 // Automatically converts ToString() to stream operator for gtest.
 using ::px::operator<<;
 
+enum class Indexing {
+  kNone,
+  kAll,
+  kLazy,
+};
+
 struct DwarfReaderTestParam {
-  bool index;
+  Indexing indexing;
 };
 
-auto CreateDwarfReader(const std::filesystem::path& path, bool indexing) {
-  if (indexing) {
-    return DwarfReader::CreateIndexingAll(path);
+auto CreateDwarfReader(const std::filesystem::path& path, Indexing indexing) {
+  switch (indexing) {
+    case Indexing::kAll:
+      return DwarfReader::CreateIndexingAll(path);
+    case Indexing::kLazy:
+      return DwarfReader::CreateWithLazyIndexing(path);
+    case Indexing::kNone:
+      break;
   }
   return DwarfReader::CreateWithoutIndexing(path);
 }
@@ -109,7 +120,7 @@ TEST_F(DwarfReaderTest, SourceLanguage) {
 TEST_P(DwarfReaderTest, GetMatchingDIEsReturnsEmptyVector) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
   ASSERT_OK_AND_THAT(
       dwarf_reader->GetMatchingDIEs("non-existent-name", llvm::dwarf::DW_TAG_structure_type),
       IsEmpty());
@@ -118,7 +129,7 @@ TEST_P(DwarfReaderTest, GetMatchingDIEsReturnsEmptyVector) {
 TEST_P(DwarfReaderTest, CppGetStructByteSize) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructByteSize("ABCStruct32"), 12);
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructByteSize("ABCStruct64"), 24);
@@ -127,7 +138,7 @@ TEST_P(DwarfReaderTest, CppGetStructByteSize) {
 TEST_P(DwarfReaderTest, Go1_16GetStructByteSize) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_16BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_16BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructByteSize("main.Vertex"), 16);
 }
@@ -135,7 +146,7 @@ TEST_P(DwarfReaderTest, Go1_16GetStructByteSize) {
 TEST_P(DwarfReaderTest, Go1_17GetStructByteSize) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_17BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_17BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructByteSize("main.Vertex"), 16);
 }
@@ -143,7 +154,7 @@ TEST_P(DwarfReaderTest, Go1_17GetStructByteSize) {
 TEST_P(DwarfReaderTest, CppGetStructMemberInfo) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(
       dwarf_reader->GetStructMemberInfo("ABCStruct32", llvm::dwarf::DW_TAG_structure_type, "b",
@@ -156,7 +167,7 @@ TEST_P(DwarfReaderTest, CppGetStructMemberInfo) {
 TEST_P(DwarfReaderTest, Go1_16GetStructMemberInfo) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_16BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_16BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(
       dwarf_reader->GetStructMemberInfo("main.Vertex", llvm::dwarf::DW_TAG_structure_type, "Y",
@@ -169,7 +180,7 @@ TEST_P(DwarfReaderTest, Go1_16GetStructMemberInfo) {
 TEST_P(DwarfReaderTest, Go1_17GetStructMemberInfo) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_17BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_17BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(
       dwarf_reader->GetStructMemberInfo("main.Vertex", llvm::dwarf::DW_TAG_structure_type, "Y",
@@ -182,7 +193,7 @@ TEST_P(DwarfReaderTest, Go1_17GetStructMemberInfo) {
 TEST_P(DwarfReaderTest, CppGetStructMemberOffset) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructMemberOffset("ABCStruct32", "a"), 0);
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructMemberOffset("ABCStruct32", "b"), 4);
@@ -192,7 +203,7 @@ TEST_P(DwarfReaderTest, CppGetStructMemberOffset) {
 TEST_P(DwarfReaderTest, Go1_16GetStructMemberOffset) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_16BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_16BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructMemberOffset("main.Vertex", "Y"), 8);
   EXPECT_NOT_OK(dwarf_reader->GetStructMemberOffset("main.Vertex", "bogus"));
@@ -201,7 +212,7 @@ TEST_P(DwarfReaderTest, Go1_16GetStructMemberOffset) {
 TEST_P(DwarfReaderTest, Go1_17GetStructMemberOffset) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_17BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_17BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructMemberOffset("main.Vertex", "Y"), 8);
   EXPECT_NOT_OK(dwarf_reader->GetStructMemberOffset("main.Vertex", "bogus"));
@@ -211,7 +222,7 @@ TEST_P(DwarfReaderTest, Go1_17GetStructMemberOffset) {
 TEST_P(DwarfReaderTest, GoUnconventionalGetStructMemberOffset) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGoBinaryUnconventionalPath, p.index));
+                       CreateDwarfReader(kGoBinaryUnconventionalPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetStructMemberOffset("runtime.g", "goid"), 192);
 }
@@ -219,7 +230,7 @@ TEST_P(DwarfReaderTest, GoUnconventionalGetStructMemberOffset) {
 TEST_P(DwarfReaderTest, CppGetStructSpec) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(
       dwarf_reader->GetStructSpec("OuterStruct"),
@@ -264,7 +275,7 @@ TEST_P(DwarfReaderTest, CppGetStructSpec) {
 TEST_P(DwarfReaderTest, GoGetStructSpec) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_17BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_17BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(
       dwarf_reader->GetStructSpec("main.OuterStruct"),
@@ -309,7 +320,7 @@ TEST_P(DwarfReaderTest, GoGetStructSpec) {
 TEST_P(DwarfReaderTest, CppArgumentTypeByteSize) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetArgumentTypeByteSize("CanYouFindThis", "a"), 4);
   EXPECT_OK_AND_EQ(dwarf_reader->GetArgumentTypeByteSize("ABCSum32", "x"), 12);
@@ -320,7 +331,7 @@ TEST_P(DwarfReaderTest, CppArgumentTypeByteSize) {
 TEST_P(DwarfReaderTest, Golang1_16ArgumentTypeByteSize) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_16BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_16BinaryPath, p.indexing));
 
   // v is of type *Vertex.
   EXPECT_OK_AND_EQ(dwarf_reader->GetArgumentTypeByteSize("main.(*Vertex).Scale", "v"), 8);
@@ -333,7 +344,7 @@ TEST_P(DwarfReaderTest, Golang1_16ArgumentTypeByteSize) {
 TEST_P(DwarfReaderTest, Golang1_17ArgumentTypeByteSize) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_17BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_17BinaryPath, p.indexing));
 
   // v is of type *Vertex.
   EXPECT_OK_AND_EQ(dwarf_reader->GetArgumentTypeByteSize("main.(*Vertex).Scale", "v"), 8);
@@ -346,7 +357,7 @@ TEST_P(DwarfReaderTest, Golang1_17ArgumentTypeByteSize) {
 TEST_P(DwarfReaderTest, CppArgumentLocation) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetArgumentLocation("ABCSum32", "x"),
                    (VarLocation{.loc_type = LocationType::kRegister, .offset = 32}));
@@ -365,7 +376,7 @@ TEST_P(DwarfReaderTest, CppArgumentLocation) {
 TEST_P(DwarfReaderTest, Golang1_16ArgumentLocation) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_16BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_16BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetArgumentLocation("main.(*Vertex).Scale", "v"),
                    (VarLocation{.loc_type = LocationType::kStack, .offset = 0}));
@@ -384,7 +395,7 @@ TEST_P(DwarfReaderTest, Golang1_16ArgumentLocation) {
 TEST_P(DwarfReaderTest, Golang1_17ArgumentLocation) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_17BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_17BinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetArgumentLocation("main.(*Vertex).Scale", "v"),
                    (VarLocation{.loc_type = LocationType::kRegister, .offset = 0}));
@@ -409,7 +420,7 @@ TEST_P(DwarfReaderTest, Golang1_17ArgumentLocation) {
 TEST_P(DwarfReaderTest, CppFunctionArgInfo) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
 
   EXPECT_OK_AND_THAT(
       dwarf_reader->GetFunctionArgInfo("CanYouFindThis"),
@@ -438,7 +449,7 @@ TEST_P(DwarfReaderTest, CppFunctionArgInfo) {
 TEST_P(DwarfReaderTest, CppFunctionRetValInfo) {
   DwarfReaderTestParam p = GetParam();
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kCppBinaryPath, p.index));
+                       CreateDwarfReader(kCppBinaryPath, p.indexing));
 
   EXPECT_OK_AND_EQ(dwarf_reader->GetFunctionRetValInfo("CanYouFindThis"),
                    (RetValInfo{TypeInfo{VarType::kBaseType, "int"}, 4}));
@@ -453,7 +464,7 @@ TEST_P(DwarfReaderTest, Go1_16FunctionArgInfo) {
 
   {
     ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                         CreateDwarfReader(kGo1_16BinaryPath, p.index));
+                         CreateDwarfReader(kGo1_16BinaryPath, p.indexing));
 
     EXPECT_OK_AND_THAT(
         dwarf_reader->GetFunctionArgInfo("main.(*Vertex).Scale"),
@@ -502,7 +513,7 @@ TEST_P(DwarfReaderTest, Go1_16FunctionArgInfo) {
 
   {
     ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                         CreateDwarfReader(kGoServerBinaryPath, p.index));
+                         CreateDwarfReader(kGoServerBinaryPath, p.indexing));
 
     // func (f *http2Framer) WriteDataPadded(streamID uint32, endStream bool, data, pad []byte)
     // error
@@ -530,7 +541,7 @@ TEST_P(DwarfReaderTest, Go1_17FunctionArgInfo) {
 
   {
     ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                         CreateDwarfReader(kGo1_17BinaryPath, p.index));
+                         CreateDwarfReader(kGo1_17BinaryPath, p.indexing));
 
     EXPECT_OK_AND_THAT(
         dwarf_reader->GetFunctionArgInfo("main.(*Vertex).Scale"),
@@ -602,7 +613,7 @@ TEST_P(DwarfReaderTest, GoFunctionVarLocationConsistency) {
   DwarfReaderTestParam p = GetParam();
 
   ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
-                       CreateDwarfReader(kGo1_16BinaryPath, p.index));
+                       CreateDwarfReader(kGo1_16BinaryPath, p.indexing));
 
   // First run GetFunctionArgInfo to automatically get all arguments.
   ASSERT_OK_AND_ASSIGN(auto function_arg_locations,
@@ -620,9 +631,87 @@ TEST_P(DwarfReaderTest, GoFunctionVarLocationConsistency) {
   }
 }
 
+// Tests that the lazy index is persisted under the build ID, and that a reader which loads it
+// resolves the same DIEs as one that indexes the binary itself.
+TEST_F(DwarfReaderTest, LazyIndexCache) {
+  const std::filesystem::path cache_dir =
+      std::filesystem::path(::testing::TempDir()) / "dwarf_index_cache";
+  std::filesystem::create_directories(cache_dir);
+
+  for (const std::string& path : {kCppBinaryPath, kGo1_16BinaryPath}) {
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> indexing_reader,
+                         DwarfReader::CreateWithLazyIndexing(path, cache_dir));
+    ASSERT_FALSE(indexing_reader->build_id().empty());
+    EXPECT_TRUE(std::filesystem::exists(
+        cache_dir / absl::StrCat(indexing_reader->build_id(), ".dwarf_index")));
+
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> loading_reader,
+                         DwarfReader::CreateWithLazyIndexing(path, cache_dir));
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> full_reader,
+                         DwarfReader::CreateIndexingAll(path));
+
+    for (const auto& [name, tag] :
+         std::vector<std::pair<std::string, llvm::dwarf::Tag>>{
+             {"OuterStruct", llvm::dwarf::DW_TAG_structure_type},
+             {"CanYouFindThis", llvm::dwarf::DW_TAG_subprogram},
+             {"main.Vertex", llvm::dwarf::DW_TAG_structure_type},
+             {"main.(*Vertex).Scale", llvm::dwarf::DW_TAG_subprogram},
+             {"bogus", llvm::dwarf::DW_TAG_subprogram}}) {
+      ASSERT_OK_AND_ASSIGN(std::vector<DWARFDie> expected,
+                           full_reader->GetMatchingDIEs(name, tag));
+      ASSERT_OK_AND_ASSIGN(std::vector<DWARFDie> loaded,
+                           loading_reader->GetMatchingDIEs(name, tag));
+      ASSERT_EQ(loaded.size(), expected.size()) << name;
+      for (size_t i = 0; i < loaded.size(); ++i) {
+        EXPECT_EQ(loaded[i].getOffset(), expected[i].getOffset()) << name;
+      }
+    }
+  }
+}
+
+// Tests that an unusable index in the cache is ignored, and replaced by a freshly built one.
+TEST_F(DwarfReaderTest, LazyIndexCacheRejectsBadIndex) {
+  const std::filesystem::path cache_dir =
+      std::filesystem::path(::testing::TempDir()) / "dwarf_index_cache_bad";
+  std::filesystem::create_directories(cache_dir);
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> go_reader,
+                       DwarfReader::CreateWithLazyIndexing(kGo1_16BinaryPath, cache_dir));
+  const std::filesystem::path go_index_path =
+      cache_dir / absl::StrCat(go_reader->build_id(), ".dwarf_index");
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> cpp_reader,
+                       DwarfReader::CreateWithLazyIndexing(kCppBinaryPath, cache_dir));
+  const std::filesystem::path cpp_index_path =
+      cache_dir / absl::StrCat(cpp_reader->build_id(), ".dwarf_index");
+  ASSERT_OK_AND_ASSIGN(const std::string go_index, ReadFileToString(go_index_path));
+  ASSERT_OK_AND_ASSIGN(const std::string cpp_index, ReadFileToString(cpp_index_path));
+
+  const std::vector<std::pair<std::string, std::string>> bad_indexes = {
+      {"corrupt", "not a DWARF index"},
+      {"truncated", cpp_index.substr(0, cpp_index.size() - 1)},
+      // The index of another binary, left under this binary's build ID.
+      {"stale", go_index},
+  };
+  for (const auto& [desc, contents] : bad_indexes) {
+    ASSERT_OK(WriteFileFromString(cpp_index_path, contents));
+
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
+                         DwarfReader::CreateWithLazyIndexing(kCppBinaryPath, cache_dir));
+    ASSERT_OK_AND_ASSIGN(std::vector<DWARFDie> dies,
+                         dwarf_reader->GetMatchingDIEs("CanYouFindThis",
+                                                       llvm::dwarf::DW_TAG_subprogram));
+    EXPECT_THAT(dies, SizeIs(1)) << desc;
+
+    // The bad index was replaced.
+    ASSERT_OK_AND_ASSIGN(std::string rewritten_index, ReadFileToString(cpp_index_path));
+    EXPECT_EQ(rewritten_index.size(), cpp_index.size()) << desc;
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(DwarfReaderParameterizedTest, DwarfReaderTest,
-                         ::testing::Values(DwarfReaderTestParam{true},
-                                           DwarfReaderTestParam{false}));
+                         ::testing::Values(DwarfReaderTestParam{Indexing::kAll},
+                                           DwarfReaderTestParam{Indexing::kLazy},
+                                           DwarfReaderTestParam{Indexing::kNone}));
 
 }  // namespace obj_tools
 }  // namespace stirling
@@ -48,6 +48,7 @@ struct LowercaseHex {
 
 Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir) {
   std::string build_id;
+  std::string go_build_id;
   std::string debug_link;
   bool found_symtab = false;
 
@@ -65,25 +66,18 @@ Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir
     // For more details: https://sourceware.org/gdb/onlinedocs/gdb/Separate-Debug-Files.html
 
     // Method 1: build-id.
-    if (psec->get_name() == ".note.gnu.build-id") {
-      // Structure of this section:
-      //    namesz :   32-bit, size of "name" field
-      //    descsz :   32-bit, size of "desc" field
-      //    type   :   32-bit, vendor specific "type"
-      //    name   :   "namesz" bytes, null-terminated string
-      //    desc   :   "descsz" bytes, binary data
-      int32_t name_size =
-          utils::LEndianBytesToInt<int32_t>(std::string_view(psec->get_data(), sizeof(int32_t)));
-      int32_t desc_size = utils::LEndianBytesToInt<int32_t>(
-          std::string_view(psec->get_data() + sizeof(int32_t), sizeof(int32_t)));
-
-      int32_t desc_pos = 3 * sizeof(int32_t) + name_size;
-      std::string_view desc = std::string_view(psec->get_data() + desc_pos, desc_size);
-
-      build_id = BytesToString<LowercaseHex>(desc);
+    if (psec->get_name() == kGNUBuildIDSection) {
+      build_id = BytesToString<LowercaseHex>(
+          ELFNoteDesc(std::string_view(psec->get_data(), psec->get_size())));
       VLOG(1) << absl::Substitute("Found build-id: $0", build_id);
     }
 
+    // Go binaries carry their own build ID, which is often the only one present.
+    if (psec->get_name() == kGoBuildIDSection) {
+      go_build_id = std::string(ELFNoteDesc(std::string_view(psec->get_data(), psec->get_size())));
+      VLOG(1) << absl::Substitute("Found Go build ID: $0", go_build_id);
+    }
+
     // Method 2: .gnu_debuglink.
     if (psec->get_name() == ".gnu_debuglink") {
       constexpr int kCRCBytes = 4;
@@ -92,6 +86,8 @@ Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir
     }
   }
 
+  build_id_ = !build_id.empty() ? build_id : go_build_id;
+
   // In priority order, we try:
   //  1) Accessing included symtab section.
   //  2) Finding debug symbols via build-id.
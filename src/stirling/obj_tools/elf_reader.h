@@ -50,6 +50,12 @@ class ElfReader {
 
   std::filesystem::path& debug_symbols_path() { return debug_symbols_path_; }
 
+  /**
+   * Returns the build ID of the binary: the GNU build-id if present, otherwise the Go build ID.
+   * Empty if the binary has neither.
+   */
+  const std::string& build_id() const { return build_id_; }
+
   struct SymbolInfo {
     std::string name;
     int type = -1;
@@ -174,6 +180,8 @@ class ElfReader {
 
   std::filesystem::path debug_symbols_path_;
 
+  std::string build_id_;
+
   // Set up an elf reader, so we can extract debug symbols.
   ELFIO::elfio elf_reader_;
 };
@@ -193,6 +193,7 @@ TEST(ElfReaderTest, ExternalDebugSymbolsBuildID) {
 
   EXPECT_OK_AND_THAT(elf_reader->ListFuncSymbols("CanYouFindThis", SymbolMatchType::kExact),
                      ElementsAre(SymbolNameIs("CanYouFindThis")));
+  EXPECT_EQ(elf_reader->build_id(), "7deb0e3f89deba61");
 }
 
 TEST(ElfReaderTest, ExternalDebugSymbolsDebugLink) {
@@ -246,6 +247,7 @@ TEST(ElfReaderTest, GolangAppRuntimeBuildVersion) {
   EXPECT_EQ(symbol.address, 0x54AF20);
   EXPECT_EQ(symbol.size, 16) << "Symbol table entry size should be 16";
   EXPECT_EQ(symbol.type, ELFIO::STT_OBJECT);
+  EXPECT_FALSE(elf_reader->build_id().empty()) << "Go binaries carry a Go build ID";
 }
 
 // Tests that the versioned symbol names always include version strings.
@@ -19,6 +19,9 @@
 #include "src/stirling/obj_tools/utils.h"
 #include <absl/strings/match.h>
 
+#include "src/common/base/byte_utils.h"
+#include "src/common/base/utils.h"
+
 namespace px {
 namespace stirling {
 namespace obj_tools {
@@ -48,6 +51,28 @@ bool MatchesSymbolAny(std::string_view symbol_name,
   return false;
 }
 
+std::string_view ELFNoteDesc(std::string_view note_section) {
+  // Structure of a note section:
+  //    namesz :   32-bit, size of "name" field
+  //    descsz :   32-bit, size of "desc" field
+  //    type   :   32-bit, vendor specific "type"
+  //    name   :   "namesz" bytes, null-terminated string, padded to 4 bytes
+  //    desc   :   "descsz" bytes, binary data
+  constexpr size_t kHeaderSize = 3 * sizeof(uint32_t);
+  if (note_section.size() < kHeaderSize) {
+    return {};
+  }
+  uint32_t name_size = utils::LEndianBytesToInt<uint32_t>(note_section.substr(0, sizeof(uint32_t)));
+  uint32_t desc_size =
+      utils::LEndianBytesToInt<uint32_t>(note_section.substr(sizeof(uint32_t), sizeof(uint32_t)));
+
+  size_t desc_pos = kHeaderSize + SnapUpToMultiple<size_t>(name_size, 4);
+  if (desc_pos > note_section.size() || desc_size > note_section.size() - desc_pos) {
+    return {};
+  }
+  return note_section.substr(desc_pos, desc_size);
+}
+
 }  // namespace obj_tools
 }  // namespace stirling
 }  // namespace px
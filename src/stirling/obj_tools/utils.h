@@ -52,6 +52,14 @@ bool MatchesSymbol(std::string_view symbol_name, const SymbolSearchPattern& sear
 bool MatchesSymbolAny(std::string_view symbol_name,
                       const std::vector<SymbolSearchPattern>& search_patterns);
 
+// Names of the ELF note sections that hold the build ID of a binary.
+inline constexpr std::string_view kGNUBuildIDSection = ".note.gnu.build-id";
+inline constexpr std::string_view kGoBuildIDSection = ".note.go.buildid";
+
+// Returns the "desc" field of the contents of an ELF note section, or an empty view if the
+// contents are malformed.
+std::string_view ELFNoteDesc(std::string_view note_section);
+
 }  // namespace obj_tools
 }  // namespace stirling
 }  // namespace px
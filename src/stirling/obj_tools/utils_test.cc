@@ -46,6 +46,24 @@ TEST(MatchesSymbolAnyTest, AsExpected) {
                                           SymbolSearchPattern{SymbolMatchType::kSubstr, "test"}}));
 }
 
+TEST(ELFNoteDescTest, AsExpected) {
+  using std::literals::string_view_literals::operator""sv;
+
+  // namesz=4, descsz=3, type=3, name="GNU\0", desc="\xab\xcd\xef".
+  constexpr std::string_view kNote =
+      "\x04\x00\x00\x00\x03\x00\x00\x00\x03\x00\x00\x00GNU\x00\xab\xcd\xef"sv;
+  EXPECT_EQ(ELFNoteDesc(kNote), "\xab\xcd\xef"sv);
+
+  // The name is padded to 4 bytes.
+  constexpr std::string_view kPaddedNote =
+      "\x03\x00\x00\x00\x02\x00\x00\x00\x04\x00\x00\x00Go\x00\x00"
+      "ab"sv;
+  EXPECT_EQ(ELFNoteDesc(kPaddedNote), "ab");
+
+  EXPECT_EQ(ELFNoteDesc(kNote.substr(0, kNote.size() - 1)), "");
+  EXPECT_EQ(ELFNoteDesc(kNote.substr(0, 8)), "");
+}
+
 }  // namespace obj_tools
 }  // namespace stirling
 }  // namespace px
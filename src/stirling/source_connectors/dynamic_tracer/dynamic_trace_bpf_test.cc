@@ -173,6 +173,42 @@ tracepoints {
 }
 )";
 
+// Aggregates the calls of kGRPCTraceProgram in a BPF map, instead of sending each one.
+constexpr char kGRPCAggregateTraceProgram[] = R"(
+tracepoints {
+  program {
+    language: GOLANG
+    outputs {
+      name: "probe_WriteDataPadded_agg_table"
+      fields: "end_stream"
+      fields: "count"
+      fields: "latency"
+      group_by_fields: "end_stream"
+      count_fields: "count"
+      sum_fields: "latency"
+    }
+    probes: {
+      name: "probe_WriteDataPadded"
+      tracepoint: {
+        symbol: "golang.org/x/net/http2.(*Framer).WriteDataPadded"
+        type: LOGICAL
+      }
+      args {
+        id: "end_stream"
+        expr: "endStream"
+      }
+      function_latency { id: "latency" }
+      output_actions {
+        output_name: "probe_WriteDataPadded_agg_table"
+        variable_names: "end_stream"
+        variable_names: "end_stream"
+        variable_names: "latency"
+      }
+    }
+  }
+}
+)";
+
 TEST_F(GoHTTPDynamicTraceTest, TraceGolangHTTPClientAndServer) {
   ASSERT_NO_FATAL_FAILURE(InitTestFixturesAndRunTestProgram(kGRPCTraceProgram));
   std::vector<TaggedRecordBatch> tablets = GetRecords();
@@ -215,6 +251,59 @@ TEST_F(GoHTTPDynamicTraceTest, TraceReturnValue) {
   }
 }
 
+// Tests that the aggregation map is drained into one row per group, and emptied.
+TEST_F(GoHTTPDynamicTraceTest, TraceAggregatedOutput) {
+  ASSERT_NO_FATAL_FAILURE(InitTestFixturesAndRunTestProgram(kGRPCAggregateTraceProgram));
+  std::vector<TaggedRecordBatch> tablets = GetRecords();
+
+  ASSERT_FALSE(tablets.empty());
+
+  const auto& elements = connector_->table_schemas()[0].elements();
+  auto col_index = [&elements](std::string_view name) {
+    size_t idx = 0;
+    while (idx < elements.size() && elements[idx].name() != name) {
+      ++idx;
+    }
+    return idx;
+  };
+  const size_t end_stream_idx = col_index("end_stream");
+  const size_t count_idx = col_index("count");
+  const size_t latency_idx = col_index("latency");
+  ASSERT_LT(end_stream_idx, elements.size());
+  ASSERT_LT(count_idx, elements.size());
+  ASSERT_LT(latency_idx, elements.size());
+
+  {
+    types::ColumnWrapperRecordBatch records =
+        FindRecordsMatchingPID(tablets[0].records, /*index*/ 0, s_.child_pid());
+
+    // One row per value of end_stream, which together count the 10 calls traced without
+    // aggregation.
+    const size_t num_rows = records[count_idx]->Size();
+    ASSERT_GE(num_rows, 1U);
+    ASSERT_LE(num_rows, 2U);
+    if (num_rows == 2) {
+      EXPECT_NE(records[end_stream_idx]->Get<types::BoolValue>(0).val,
+                records[end_stream_idx]->Get<types::BoolValue>(1).val);
+    }
+    int64_t count = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+      count += records[count_idx]->Get<types::Int64Value>(i).val;
+      // Each call took more than 1000ns, as in TraceGolangHTTPClientAndServer.
+      EXPECT_THAT(records[latency_idx]->Get<types::Int64Value>(i).val,
+                  Gt(1000 * records[count_idx]->Get<types::Int64Value>(i).val));
+    }
+    EXPECT_EQ(count, 10);
+  }
+
+  // The entries were removed from the map when they were drained.
+  for (const auto& tablet : GetRecords()) {
+    types::ColumnWrapperRecordBatch records =
+        FindRecordsMatchingPID(tablet.records, /*index*/ 0, s_.child_pid());
+    EXPECT_EQ(records[count_idx]->Size(), 0U);
+  }
+}
+
 class CPPDynamicTraceTest : public ::testing::Test {
  protected:
   void InitTestFixturesAndRunTestProgram(const std::string& text_pb) {
@@ -18,7 +18,6 @@
 
 #pragma once
 
-#include <deque>
 #include <memory>
 #include <string>
 #include <utility>
@@ -28,6 +27,7 @@
 #include "src/stirling/bpf_tools/bcc_wrapper.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/dynamic_tracer.h"
+#include "src/stirling/source_connectors/dynamic_tracer/struct_record_decoder.h"
 
 namespace px {
 namespace stirling {
@@ -35,6 +35,8 @@ namespace stirling {
 class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapper {
  public:
   static constexpr auto kSamplingPeriod = std::chrono::milliseconds{100};
+  // Outputs aggregated in BPF produce a row per group each time they are drained.
+  static constexpr auto kAggregationSamplingPeriod = std::chrono::milliseconds{1000};
   static constexpr auto kPushPeriod = std::chrono::milliseconds{1000};
 
   ~DynamicTraceConnector() override = default;
@@ -42,8 +44,9 @@ class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapp
   static StatusOr<std::unique_ptr<SourceConnector>> Create(
       std::string_view name, dynamic_tracing::ir::logical::TracepointDeployment* program);
 
-  // Accepts a piece of data from the perf buffer.
-  void AcceptDataEvents(std::string data) { data_items_.push_back(std::move(data)); }
+  // Accepts a piece of data from the perf buffer, and decodes it straight into the data table
+  // being transferred to.
+  void AcceptDataEvent(std::string_view data);
 
  protected:
   // TODO(oazizi): This constructor only works with a single table,
@@ -62,8 +65,8 @@ class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapp
   Status StopImpl() override { return Status::OK(); }
 
  private:
-  Status AppendRecord(const ::px::stirling::dynamic_tracing::ir::physical::Struct& st,
-                      uint32_t asid, std::string_view buf, DataTable* data_table);
+  // Moves the entries of the BPF map of an aggregated output into the data table.
+  void DrainAggregationMap(uint32_t asid, DataTable* data_table);
 
   // Describes the output table column types.
   std::unique_ptr<DynamicDataTableSchema> table_schema_;
@@ -71,8 +74,13 @@ class DynamicTraceConnector : public SourceConnector, public bpf_tools::BCCWrapp
   // The actual dynamic trace program.
   dynamic_tracing::BCCProgram bcc_program_;
 
-  // A buffer to hold raw data items from the perf buffer.
-  std::deque<std::string> data_items_;
+  // Decodes the output struct of the program into records, compiled once at deployment.
+  std::unique_ptr<StructRecordDecoder> record_decoder_;
+
+  // The data table and ASID of the ongoing TransferDataImpl(), which the perf buffer events are
+  // decoded into as they are polled.
+  DataTable* data_table_ = nullptr;
+  uint32_t asid_ = 0;
 };
 
 // Converts proto specification of columns into the form that is used by TableSchema.
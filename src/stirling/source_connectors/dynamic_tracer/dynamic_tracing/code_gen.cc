@@ -39,6 +39,7 @@ using ::px::stirling::bpf_tools::BPFProbeAttachType;
 using ::px::stirling::bpf_tools::UProbeSpec;
 using ::px::stirling::dynamic_tracing::ir::physical::BinaryExpression;
 using ::px::stirling::dynamic_tracing::ir::physical::Field;
+using ::px::stirling::dynamic_tracing::ir::physical::MapAggregateAction;
 using ::px::stirling::dynamic_tracing::ir::physical::MapDeleteAction;
 using ::px::stirling::dynamic_tracing::ir::physical::MapStashAction;
 using ::px::stirling::dynamic_tracing::ir::physical::PerCPUArray;
@@ -610,6 +611,76 @@ StatusOr<std::vector<std::string>> GenPerfBufferOutputAction(
   return code_lines;
 }
 
+StatusOr<std::vector<std::string>> GenMapAggregateAction(const ir::physical::Struct& key_struct,
+                                                         const ir::physical::Struct& value_struct,
+                                                         const MapAggregateAction& action) {
+  if (key_struct.fields_size() != action.key_variable_names_size()) {
+    return error::InvalidArgument("Key struct '$0' has $1 fields, but got $2 key variables",
+                                  key_struct.name(), key_struct.fields_size(),
+                                  action.key_variable_names_size());
+  }
+  if (action.sum_fields_size() != action.sum_variable_names_size()) {
+    return error::InvalidArgument("Map '$0' has $1 sum fields, but got $2 sum variables",
+                                  action.map_name(), action.sum_fields_size(),
+                                  action.sum_variable_names_size());
+  }
+  if (value_struct.fields().empty()) {
+    return error::InvalidArgument("Value struct '$0' is missing the time field",
+                                  value_struct.name());
+  }
+
+  std::string key_var_name = absl::StrCat(action.map_name(), "_key");
+  std::string value_var_name = absl::StrCat(action.map_name(), "_value");
+  std::string init_value_var_name = absl::StrCat(action.map_name(), "_init_value");
+
+  const absl::flat_hash_set<std::string_view> log2_bucket_fields(
+      action.log2_bucket_fields().begin(), action.log2_bucket_fields().end());
+
+  std::vector<std::string> code_lines;
+
+  code_lines.push_back(
+      absl::Substitute("struct $0 $1 = {};", action.key_struct_name(), key_var_name));
+  for (int i = 0; i < key_struct.fields_size(); ++i) {
+    const std::string& field_name = key_struct.fields(i).name();
+    const std::string& var_name = action.key_variable_names(i);
+    if (log2_bucket_fields.contains(field_name)) {
+      // Negative values of signed variables go to bucket 0, rather than converting to huge
+      // unsigned values.
+      code_lines.push_back(absl::Substitute("$0.$1 = pl_log2_bucket($2 > 0 ? $2 : 0);",
+                                            key_var_name, field_name, var_name));
+    } else {
+      code_lines.push_back(absl::Substitute("$0.$1 = $2;", key_var_name, field_name, var_name));
+    }
+  }
+
+  // The value is looked up again after the insertion, as another CPU might have inserted it first.
+  code_lines.push_back(absl::Substitute("struct $0* $1 = $2.lookup(&$3);",
+                                        action.value_struct_name(), value_var_name,
+                                        action.map_name(), key_var_name));
+  code_lines.push_back(absl::Substitute("if ($0 == NULL) {", value_var_name));
+  code_lines.push_back(
+      absl::Substitute("struct $0 $1 = {};", action.value_struct_name(), init_value_var_name));
+  code_lines.push_back(absl::Substitute("$0.insert(&$1, &$2);", action.map_name(), key_var_name,
+                                        init_value_var_name));
+  code_lines.push_back(
+      absl::Substitute("$0 = $1.lookup(&$2);", value_var_name, action.map_name(), key_var_name));
+  code_lines.push_back(absl::Substitute("if ($0 == NULL) { return 0; }", value_var_name));
+  code_lines.push_back("}");
+
+  code_lines.push_back(absl::Substitute("$0->$1 = $2;", value_var_name,
+                                        value_struct.fields(0).name(),
+                                        action.time_variable_name()));
+  for (const auto& f : action.count_fields()) {
+    code_lines.push_back(absl::Substitute("__sync_fetch_and_add(&$0->$1, 1);", value_var_name, f));
+  }
+  for (int i = 0; i < action.sum_fields_size(); ++i) {
+    code_lines.push_back(absl::Substitute("__sync_fetch_and_add(&$0->$1, $2);", value_var_name,
+                                          action.sum_fields(i), action.sum_variable_names(i)));
+  }
+
+  return code_lines;
+}
+
 ScalarType GetScalarVariableType(const Variable& var) {
   if (var.var_oneof_case() == Variable::VarOneofCase::kScalarVar) {
     return var.scalar_var().type();
@@ -860,6 +931,19 @@ StatusOr<std::vector<std::string>> BCCCodeGenerator::GenerateProbe(const Probe&
     MOVE_BACK_STR_VEC(GenPerfBufferOutputAction(*iter->second, action), &code_lines);
   }
 
+  for (const auto& action : probe.map_aggregate_actions()) {
+    auto key_iter = structs_.find(action.key_struct_name());
+    if (key_iter == structs_.end()) {
+      return error::InvalidArgument("Key struct '$0' is undefined", action.key_struct_name());
+    }
+    auto value_iter = structs_.find(action.value_struct_name());
+    if (value_iter == structs_.end()) {
+      return error::InvalidArgument("Value struct '$0' is undefined", action.value_struct_name());
+    }
+    MOVE_BACK_STR_VEC(GenMapAggregateAction(*key_iter->second, *value_iter->second, action),
+                      &code_lines);
+  }
+
   for (const auto& printk : probe.printks()) {
     PL_ASSIGN_OR_RETURN(std::string code_line, GenPrintk(vars, printk));
     code_lines.push_back(std::move(code_line));
@@ -941,6 +1025,35 @@ std::vector<std::string> GenGOID() {
   };
 }
 
+// Returns the lower bound of the power-of-2 bucket of x, or 0 if x is 0.
+std::vector<std::string> GenLog2Bucket() {
+  return {
+      "static __inline uint64_t pl_log2_bucket(uint64_t x) {",
+      "if (x == 0) { return 0; }",
+      "uint64_t log2 = 0;",
+      "uint64_t shift;",
+      "shift = (x > 0xFFFFFFFF) << 5; x >>= shift; log2 |= shift;",
+      "shift = (x > 0xFFFF) << 4; x >>= shift; log2 |= shift;",
+      "shift = (x > 0xFF) << 3; x >>= shift; log2 |= shift;",
+      "shift = (x > 0xF) << 2; x >>= shift; log2 |= shift;",
+      "shift = (x > 0x3) << 1; x >>= shift; log2 |= shift;",
+      "log2 |= (x >> 1);",
+      "return 1ULL << log2;",
+      "}",
+  };
+}
+
+bool HasLog2Buckets(const Program& program) {
+  for (const auto& probe : program.probes()) {
+    for (const auto& action : probe.map_aggregate_actions()) {
+      if (!action.log2_bucket_fields().empty()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 std::vector<std::string> GenUtilFNs() {
   std::vector<std::string> code_lines;
   MoveBackStrVec(GenNsecToClock(), &code_lines);
@@ -998,6 +1111,10 @@ StatusOr<std::vector<std::string>> BCCCodeGenerator::GenerateCodeLines() {
   MoveBackStrVec(GenUtilFNs(), &code_lines);
   MoveBackStrVec(GenTypes(), &code_lines);
 
+  if (HasLog2Buckets(program_)) {
+    MoveBackStrVec(GenLog2Bucket(), &code_lines);
+  }
+
   for (const auto& st : program_.structs()) {
     MOVE_BACK_STR_VEC(GenStruct(st), &code_lines);
     structs_[st.name()] = &st;
@@ -1027,6 +1144,10 @@ StatusOr<std::vector<std::string>> BCCCodeGenerator::GenerateCodeLines() {
   }
 
   for (const auto& output : program_.outputs()) {
+    // The outputs aggregated in BPF are written to their maps, which are generated above.
+    if (!output.aggregation_map_name().empty()) {
+      continue;
+    }
     code_lines.push_back(GenPerfBufferOutput(output));
   }
 
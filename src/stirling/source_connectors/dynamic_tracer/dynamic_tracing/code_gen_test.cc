@@ -475,6 +475,137 @@ TEST(GenProgramTest, SpecsAndCode) {
   EXPECT_THAT(bcc_code_lines, ElementsAreArray(expected_code_lines));
 }
 
+TEST(GenProgramTest, MapAggregateAction) {
+  const std::string program_protobuf = R"proto(
+                                       structs {
+                                         name: "out_agg_key_t"
+                                         fields { name: "tgid_" type: INT32 }
+                                         fields { name: "latency_bucket" type: UINT64 }
+                                       }
+                                       structs {
+                                         name: "out_agg_value_t"
+                                         fields { name: "time_" type: UINT64 }
+                                         fields { name: "count" type: INT64 }
+                                         fields { name: "bytes" type: INT64 }
+                                       }
+                                       maps {
+                                         name: "out"
+                                         key_type { struct_type: "out_agg_key_t" }
+                                         value_type { struct_type: "out_agg_value_t" }
+                                       }
+                                       outputs {
+                                         name: "out"
+                                         struct_type: "out_value_t"
+                                         aggregation_map_name: "out"
+                                       }
+                                       probes {
+                                         name: "probe_return"
+                                         vars {
+                                           scalar_var { name: "tgid_" type: INT32 builtin: TGID }
+                                         }
+                                         vars {
+                                           scalar_var { name: "time_" type: UINT64 builtin: KTIME }
+                                         }
+                                         vars {
+                                           scalar_var { name: "latency" type: UINT64 reg: RC }
+                                         }
+                                         map_aggregate_actions {
+                                           map_name: "out"
+                                           key_struct_name: "out_agg_key_t"
+                                           value_struct_name: "out_agg_value_t"
+                                           key_variable_names: "tgid_"
+                                           key_variable_names: "latency"
+                                           log2_bucket_fields: "latency_bucket"
+                                           time_variable_name: "time_"
+                                           count_fields: "count"
+                                           sum_fields: "bytes"
+                                           sum_variable_names: "latency"
+                                         }
+                                       }
+                                       )proto";
+
+  ir::physical::Program program;
+  ASSERT_TRUE(TextFormat::ParseFromString(program_protobuf, &program));
+
+  ASSERT_OK_AND_ASSIGN(const std::string bcc_code, GenBCCProgram(program));
+
+  const std::vector<std::string> expected_code_lines = {
+      "#include <linux/sched.h>",
+      "#define __inline inline __attribute__((__always_inline__))",
+      "static __inline uint64_t pl_nsec_to_clock_t(uint64_t x) {",
+      "return div_u64(x, NSEC_PER_SEC / USER_HZ);",
+      "}",
+      "static __inline uint64_t pl_tgid_start_time() {",
+      "struct task_struct* task_group_leader = ((struct "
+      "task_struct*)bpf_get_current_task())->group_leader;",
+      "#if LINUX_VERSION_CODE >= 328960",
+      "return pl_nsec_to_clock_t(task_group_leader->start_boottime);",
+      "#else",
+      "return pl_nsec_to_clock_t(task_group_leader->real_start_time);",
+      "#endif",
+      "}",
+      "struct blob32 {",
+      "  uint64_t len;",
+      "  uint8_t buf[32-9];",
+      "  uint8_t truncated;",
+      "};",
+      "struct blob64 {",
+      "  uint64_t len;",
+      "  uint8_t buf[64-9];",
+      "  uint8_t truncated;",
+      "};",
+      "struct struct_blob64 {",
+      "  uint64_t len;",
+      "  int8_t decoder_idx;",
+      "  uint8_t buf[64-10];",
+      "  uint8_t truncated;",
+      "};",
+      "static __inline uint64_t pl_log2_bucket(uint64_t x) {",
+      "if (x == 0) { return 0; }",
+      "uint64_t log2 = 0;",
+      "uint64_t shift;",
+      "shift = (x > 0xFFFFFFFF) << 5; x >>= shift; log2 |= shift;",
+      "shift = (x > 0xFFFF) << 4; x >>= shift; log2 |= shift;",
+      "shift = (x > 0xFF) << 3; x >>= shift; log2 |= shift;",
+      "shift = (x > 0xF) << 2; x >>= shift; log2 |= shift;",
+      "shift = (x > 0x3) << 1; x >>= shift; log2 |= shift;",
+      "log2 |= (x >> 1);",
+      "return 1ULL << log2;",
+      "}",
+      "struct out_agg_key_t {",
+      "  int32_t tgid_;",
+      "  uint64_t latency_bucket;",
+      "} __attribute__((packed, aligned(1)));",
+      "struct out_agg_value_t {",
+      "  uint64_t time_;",
+      "  int64_t count;",
+      "  int64_t bytes;",
+      "} __attribute__((packed, aligned(1)));",
+      "BPF_HASH(out, struct out_agg_key_t, struct out_agg_value_t);",
+      "int probe_return(struct pt_regs* ctx) {",
+      "int32_t tgid_ = bpf_get_current_pid_tgid() >> 32;",
+      "uint64_t time_ = bpf_ktime_get_ns();",
+      "uint64_t latency = (uint64_t)PT_REGS_RC(ctx);",
+      "struct out_agg_key_t out_key = {};",
+      "out_key.tgid_ = tgid_;",
+      "out_key.latency_bucket = pl_log2_bucket(latency > 0 ? latency : 0);",
+      "struct out_agg_value_t* out_value = out.lookup(&out_key);",
+      "if (out_value == NULL) {",
+      "struct out_agg_value_t out_init_value = {};",
+      "out.insert(&out_key, &out_init_value);",
+      "out_value = out.lookup(&out_key);",
+      "if (out_value == NULL) { return 0; }",
+      "}",
+      "out_value->time_ = time_;",
+      "__sync_fetch_and_add(&out_value->count, 1);",
+      "__sync_fetch_and_add(&out_value->bytes, latency);",
+      "return 0;",
+      "}"};
+
+  std::vector<std::string> bcc_code_lines = absl::StrSplit(bcc_code, "\n");
+  EXPECT_THAT(bcc_code_lines, ElementsAreArray(expected_code_lines));
+}
+
 }  // namespace dynamic_tracing
 }  // namespace stirling
 }  // namespace px
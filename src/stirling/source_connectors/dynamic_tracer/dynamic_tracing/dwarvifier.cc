@@ -122,6 +122,10 @@ class Dwarvifier {
   Status ProcessOutputAction(const ir::logical::OutputAction& output_action,
                              ir::physical::Probe* output_probe,
                              ir::physical::Program* output_program);
+  Status ProcessMapAggregateAction(const ir::logical::OutputAction& output_action,
+                                   const ir::logical::Output& output,
+                                   ir::physical::Probe* output_probe,
+                                   ir::physical::Program* output_program);
 
   // TVarType can be ScalarVariable, StructVariable, etc.
   template <typename TVarType>
@@ -142,6 +146,8 @@ class Dwarvifier {
 
   std::map<std::string, ir::shared::Map*> maps_;
   std::map<std::string, ir::physical::PerfBufferOutput*> outputs_;
+  // The outputs that are aggregated in BPF.
+  std::map<std::string, const ir::logical::Output*> aggregated_outputs_;
   std::map<std::string, ir::physical::Struct*> structs_;
 
   obj_tools::DwarfReader* dwarf_reader_ = nullptr;
@@ -223,6 +229,19 @@ std::string StructTypeName(const std::string& obj_name) {
   return absl::StrCat(obj_name, "_value_t");
 }
 
+// Returns the names of the key and value structs of the map of an Output aggregated in BPF.
+std::string AggregateKeyStructTypeName(const std::string& output_name) {
+  return absl::StrCat(output_name, "_agg_key_t");
+}
+std::string AggregateValueStructTypeName(const std::string& output_name) {
+  return absl::StrCat(output_name, "_agg_value_t");
+}
+
+bool IsAggregated(const ir::logical::Output& output) {
+  return !output.group_by_fields().empty() || !output.log2_bucket_fields().empty() ||
+         !output.count_fields().empty() || !output.sum_fields().empty();
+}
+
 // Map to convert Go Base types to ScalarType.
 // clang-format off
 const absl::flat_hash_map<std::string_view, ir::shared::ScalarType> kGoTypesMap = {
@@ -437,6 +456,12 @@ void Dwarvifier::GenerateOutput(const ir::logical::Output& output,
   // Also insert the name of the struct that holds the output variables.
   o->set_struct_type(StructTypeName(output.name()));
 
+  if (IsAggregated(output)) {
+    // The map replaces the perf buffer, so it takes the name of the output.
+    o->set_aggregation_map_name(output.name());
+    aggregated_outputs_[o->name()] = &output;
+  }
+
   // Record this output (for quick lookup by GenerateProbe).
   outputs_[o->name()] = o;
 }
@@ -1316,6 +1341,12 @@ std::string DataBufferArrayName(std::string_view output_name) {
 Status Dwarvifier::ProcessOutputAction(const ir::logical::OutputAction& output_action_in,
                                        ir::physical::Probe* output_probe,
                                        ir::physical::Program* output_program) {
+  auto aggregated_iter = aggregated_outputs_.find(output_action_in.output_name());
+  if (aggregated_iter != aggregated_outputs_.end()) {
+    return ProcessMapAggregateAction(output_action_in, *aggregated_iter->second, output_probe,
+                                     output_program);
+  }
+
   std::string struct_type_name = StructTypeName(output_action_in.output_name());
   std::string data_buffer_array_name = DataBufferArrayName(output_action_in.output_name());
 
@@ -1353,6 +1384,184 @@ Status Dwarvifier::ProcessOutputAction(const ir::logical::OutputAction& output_a
   return Status::OK();
 }
 
+namespace {
+
+enum class AggregateKind { kGroupBy, kLog2Bucket, kCount, kSum };
+
+bool IsIntegerType(ir::shared::ScalarType type) {
+  switch (type) {
+    case ir::shared::ScalarType::BOOL:
+    case ir::shared::ScalarType::SHORT:
+    case ir::shared::ScalarType::USHORT:
+    case ir::shared::ScalarType::INT:
+    case ir::shared::ScalarType::UINT:
+    case ir::shared::ScalarType::LONG:
+    case ir::shared::ScalarType::ULONG:
+    case ir::shared::ScalarType::LONGLONG:
+    case ir::shared::ScalarType::ULONGLONG:
+    case ir::shared::ScalarType::INT8:
+    case ir::shared::ScalarType::INT16:
+    case ir::shared::ScalarType::INT32:
+    case ir::shared::ScalarType::INT64:
+    case ir::shared::ScalarType::UINT8:
+    case ir::shared::ScalarType::UINT16:
+    case ir::shared::ScalarType::UINT32:
+    case ir::shared::ScalarType::UINT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns how each field of an aggregated Output is aggregated, in the order of the fields.
+StatusOr<std::vector<AggregateKind>> GetAggregateKinds(const ir::logical::Output& output) {
+  absl::flat_hash_map<std::string_view, AggregateKind> field_kinds;
+  auto add_fields = [&output, &field_kinds](const RepeatedPtrField<std::string>& fields,
+                                            AggregateKind kind) -> Status {
+    for (const auto& f : fields) {
+      if (!field_kinds.try_emplace(f, kind).second) {
+        return error::InvalidArgument("Field '$0' of Output '$1' is aggregated more than once", f,
+                                      output.name());
+      }
+    }
+    return Status::OK();
+  };
+  PL_RETURN_IF_ERROR(add_fields(output.group_by_fields(), AggregateKind::kGroupBy));
+  PL_RETURN_IF_ERROR(add_fields(output.log2_bucket_fields(), AggregateKind::kLog2Bucket));
+  PL_RETURN_IF_ERROR(add_fields(output.count_fields(), AggregateKind::kCount));
+  PL_RETURN_IF_ERROR(add_fields(output.sum_fields(), AggregateKind::kSum));
+
+  std::vector<AggregateKind> kinds;
+  for (const auto& f : output.fields()) {
+    auto iter = field_kinds.find(f);
+    if (iter == field_kinds.end()) {
+      return error::InvalidArgument("Field '$0' of aggregated Output '$1' is not aggregated", f,
+                                    output.name());
+    }
+    kinds.push_back(iter->second);
+  }
+  if (field_kinds.size() != kinds.size()) {
+    return error::InvalidArgument("Output '$0' aggregates fields that it does not have",
+                                  output.name());
+  }
+  return kinds;
+}
+
+}  // namespace
+
+Status Dwarvifier::ProcessMapAggregateAction(const ir::logical::OutputAction& output_action_in,
+                                             const ir::logical::Output& output,
+                                             ir::physical::Probe* output_probe,
+                                             ir::physical::Program* output_program) {
+  if (output.fields_size() != output_action_in.variable_names_size()) {
+    return error::InvalidArgument(
+        "OutputAction to '$0' writes $1 variables, but the Output has $2 fields", output.name(),
+        output_action_in.variable_names_size(), output.fields_size());
+  }
+
+  PL_ASSIGN_OR_RETURN(std::vector<AggregateKind> kinds, GetAggregateKinds(output));
+
+  auto* action = output_probe->add_map_aggregate_actions();
+  action->set_map_name(output.name());
+  action->set_key_struct_name(AggregateKeyStructTypeName(output.name()));
+  action->set_value_struct_name(AggregateValueStructTypeName(output.name()));
+  action->set_time_variable_name(kKTimeVarName);
+
+  // The records are aggregated per process; the goid is not kept.
+  ir::physical::Struct key_struct;
+  key_struct.set_name(action->key_struct_name());
+  for (std::string_view f : {kTGIDVarName, kTGIDStartTimeVarName}) {
+    auto iter = variables_.find(f);
+    if (iter == variables_.end()) {
+      return error::Internal("ProcessMapAggregateAction [output=$0]: Reference to unknown $1",
+                             output.name(), f);
+    }
+    key_struct.add_fields()->CopyFrom(iter->second);
+    action->add_key_variable_names(std::string(f));
+  }
+
+  ir::physical::Struct value_struct;
+  value_struct.set_name(action->value_struct_name());
+  auto* time_field = value_struct.add_fields();
+  time_field->set_name(kKTimeVarName);
+  time_field->set_type(ir::shared::ScalarType::UINT64);
+
+  for (int i = 0; i < output.fields_size(); ++i) {
+    const std::string& field_name = output.fields(i);
+    const std::string& var_name = output_action_in.variable_names(i);
+
+    auto iter = variables_.find(var_name);
+    if (iter == variables_.end()) {
+      return error::Internal("ProcessMapAggregateAction [output=$0]: Reference to unknown $1",
+                             output.name(), var_name);
+    }
+    const ir::shared::ScalarType var_type = iter->second.type();
+
+    if (kinds[i] != AggregateKind::kCount && !IsIntegerType(var_type)) {
+      return error::InvalidArgument(
+          "Field '$0' of Output '$1' has type $2, which cannot be aggregated", field_name,
+          output.name(), magic_enum::enum_name(var_type));
+    }
+
+    ir::physical::Field* field = nullptr;
+    switch (kinds[i]) {
+      case AggregateKind::kGroupBy:
+        field = key_struct.add_fields();
+        field->set_type(var_type);
+        action->add_key_variable_names(var_name);
+        break;
+      case AggregateKind::kLog2Bucket:
+        field = key_struct.add_fields();
+        field->set_type(ir::shared::ScalarType::UINT64);
+        action->add_key_variable_names(var_name);
+        action->add_log2_bucket_fields(field_name);
+        break;
+      case AggregateKind::kCount:
+        field = value_struct.add_fields();
+        field->set_type(ir::shared::ScalarType::INT64);
+        action->add_count_fields(field_name);
+        break;
+      case AggregateKind::kSum:
+        field = value_struct.add_fields();
+        field->set_type(ir::shared::ScalarType::INT64);
+        action->add_sum_fields(field_name);
+        action->add_sum_variable_names(var_name);
+        break;
+    }
+    field->set_name(field_name);
+  }
+
+  // The rows drained from the map are its keys followed by their values.
+  ir::physical::Struct record_struct;
+  record_struct.set_name(StructTypeName(output.name()));
+  record_struct.mutable_fields()->CopyFrom(key_struct.fields());
+  record_struct.mutable_fields()->MergeFrom(value_struct.fields());
+
+  // Other probes may aggregate into the same output.
+  auto struct_iter = structs_.find(record_struct.name());
+  if (struct_iter != structs_.end()) {
+    if (struct_iter->second->SerializeAsString() != record_struct.SerializeAsString()) {
+      return error::InvalidArgument("Output '$0' is aggregated differently by different probes",
+                                    output.name());
+    }
+    return Status::OK();
+  }
+
+  for (auto* st : {&key_struct, &value_struct, &record_struct}) {
+    auto* struct_decl = output_program->add_structs();
+    *struct_decl = std::move(*st);
+    structs_[struct_decl->name()] = struct_decl;
+  }
+
+  ir::shared::Map map;
+  map.set_name(action->map_name());
+  map.mutable_key_type()->set_struct_type(action->key_struct_name());
+  map.mutable_value_type()->set_struct_type(action->value_struct_name());
+  GenerateMap(map, output_program);
+
+  return PopulateOutputTypes(outputs_, output.name(), StructTypeName(output.name()));
+}
+
 }  // namespace dynamic_tracing
 }  // namespace stirling
 }  // namespace px
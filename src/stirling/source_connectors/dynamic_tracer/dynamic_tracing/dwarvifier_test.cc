@@ -287,6 +287,221 @@ probes {
 }
 )";
 
+constexpr std::string_view kAggregateProbeIn = R"(
+deployment_spec {
+  path: "$0"
+}
+tracepoints {
+  program {
+    language: GOLANG
+    outputs {
+      name: "out_table"
+      fields: "retval0_bucket"
+      fields: "retval1"
+      fields: "count"
+      fields: "retval0_sum"
+      group_by_fields: "retval1"
+      log2_bucket_fields: "retval0_bucket"
+      count_fields: "count"
+      sum_fields: "retval0_sum"
+    }
+    probes {
+      tracepoint: {
+        symbol: "main.MixedArgTypes"
+        type: RETURN
+      }
+      ret_vals {
+        id: "retval0"
+        expr: "$$0"
+      }
+      ret_vals {
+        id: "retval1"
+        expr: "$$1.B1"
+      }
+      output_actions {
+        output_name: "out_table"
+        variable_names: "retval0"
+        variable_names: "retval1"
+        variable_names: "retval0"
+        variable_names: "retval0"
+      }
+    }
+  }
+}
+)";
+
+constexpr std::string_view kAggregateProbeOut = R"(
+deployment_spec {
+  path: "$0"
+}
+language: GOLANG
+structs {
+  name: "out_table_agg_key_t"
+  fields {
+    name: "tgid_"
+    type: INT32
+  }
+  fields {
+    name: "tgid_start_time_"
+    type: UINT64
+  }
+  fields {
+    name: "retval0_bucket"
+    type: UINT64
+  }
+  fields {
+    name: "retval1"
+    type: BOOL
+  }
+}
+structs {
+  name: "out_table_agg_value_t"
+  fields {
+    name: "time_"
+    type: UINT64
+  }
+  fields {
+    name: "count"
+    type: INT64
+  }
+  fields {
+    name: "retval0_sum"
+    type: INT64
+  }
+}
+structs {
+  name: "out_table_value_t"
+  fields {
+    name: "tgid_"
+    type: INT32
+  }
+  fields {
+    name: "tgid_start_time_"
+    type: UINT64
+  }
+  fields {
+    name: "retval0_bucket"
+    type: UINT64
+  }
+  fields {
+    name: "retval1"
+    type: BOOL
+  }
+  fields {
+    name: "time_"
+    type: UINT64
+  }
+  fields {
+    name: "count"
+    type: INT64
+  }
+  fields {
+    name: "retval0_sum"
+    type: INT64
+  }
+}
+maps {
+  name: "out_table"
+  key_type {
+    struct_type: "out_table_agg_key_t"
+  }
+  value_type {
+    struct_type: "out_table_agg_value_t"
+  }
+}
+outputs {
+  name: "out_table"
+  fields: "retval0_bucket"
+  fields: "retval1"
+  fields: "count"
+  fields: "retval0_sum"
+  struct_type: "out_table_value_t"
+  aggregation_map_name: "out_table"
+}
+probes {
+  tracepoint {
+    symbol: "main.MixedArgTypes"
+    type: RETURN
+  }
+  vars {
+    scalar_var {
+      name: "sp_"
+      type: VOID_POINTER
+      reg: SP
+    }
+  }
+  vars {
+    scalar_var {
+      name: "tgid_"
+      type: INT32
+      builtin: TGID
+    }
+  }
+  vars {
+    scalar_var {
+      name: "tgid_pid_"
+      type: UINT64
+      builtin: TGID_PID
+    }
+  }
+  vars {
+    scalar_var {
+      name: "tgid_start_time_"
+      type: UINT64
+      builtin: TGID_START_TIME
+    }
+  }
+  vars {
+    scalar_var {
+      name: "time_"
+      type: UINT64
+      builtin: KTIME
+    }
+  }
+  vars {
+    scalar_var {
+      name: "goid_"
+      type: INT64
+      builtin: GOID
+    }
+  }
+  vars {
+    scalar_var {
+      name: "retval0"
+      type: INT
+      memory {
+        base: "sp_"
+        offset: 48
+      }
+    }
+  }
+  vars {
+    scalar_var {
+      name: "retval1"
+      type: BOOL
+      memory {
+        base: "sp_"
+        offset: 57
+      }
+    }
+  }
+  map_aggregate_actions {
+    map_name: "out_table"
+    key_struct_name: "out_table_agg_key_t"
+    value_struct_name: "out_table_agg_value_t"
+    key_variable_names: "tgid_"
+    key_variable_names: "tgid_start_time_"
+    key_variable_names: "retval0"
+    key_variable_names: "retval1"
+    log2_bucket_fields: "retval0_bucket"
+    time_variable_name: "time_"
+    count_fields: "count"
+    sum_fields: "retval0_sum"
+    sum_variable_names: "retval0"
+  }
+}
+)";
+
 constexpr std::string_view kImplicitNamedRetvalsIn = R"(
 deployment_spec {
   path: "$0"
@@ -1497,6 +1712,7 @@ INSTANTIATE_TEST_SUITE_P(
     DwarfInfoTestSuite, DwarfInfoTest,
     ::testing::Values(DwarfInfoTestParam{kEntryProbeIn, kEntryProbeOut},
                       DwarfInfoTestParam{kReturnProbeIn, kReturnProbeOut},
+                      DwarfInfoTestParam{kAggregateProbeIn, kAggregateProbeOut},
                       DwarfInfoTestParam{kImplicitNamedRetvalsIn, kImplicitNamedRetvalsOut},
                       DwarfInfoTestParam{kNamedRetvalsIn, kNamedRetvalsOut},
                       DwarfInfoTestParam{kNestedArgProbeIn, kNestedArgProbeOut},
@@ -91,6 +91,7 @@ StatusOr<BCCProgram::PerfBufferSpec> GetPerfBufferSpec(
 
   pf_spec.name = output.name();
   pf_spec.output = *iter->second;
+  pf_spec.aggregation_map_name = output.aggregation_map_name();
 
   return pf_spec;
 }
@@ -115,7 +116,8 @@ StatusOr<ObjInfo> Prepare(const ir::logical::TracepointDeployment& input_program
   const auto& debug_symbols_path = obj_info.elf_reader->debug_symbols_path().string();
 
   obj_info.dwarf_reader =
-      DwarfReader::CreateIndexingAll(debug_symbols_path).ConsumeValueOr(nullptr);
+      DwarfReader::CreateWithLazyIndexing(debug_symbols_path, FLAGS_stirling_dwarf_index_cache_dir)
+          .ConsumeValueOr(nullptr);
 
   return obj_info;
 }
@@ -58,8 +58,13 @@ struct BCCProgram {
     std::string name;
     ir::physical::Struct output;
 
+    // If set, the output is aggregated in this BPF hash map instead of the perf buffer.
+    // The output struct then describes the map entries: the key followed by the value.
+    std::string aggregation_map_name;
+
     std::string ToString() const {
-      return absl::Substitute("[name=$0 Output struct=$1]", name, output.DebugString());
+      return absl::Substitute("[name=$0 Output struct=$1 aggregation_map=$2]", name,
+                              output.DebugString(), aggregation_map_name);
     }
   };
 
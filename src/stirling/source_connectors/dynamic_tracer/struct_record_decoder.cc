@@ -0,0 +1,346 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "src/stirling/source_connectors/dynamic_tracer/struct_record_decoder.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/pointer.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <string>
+
+#include "src/shared/upid/upid.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/types.h"
+
+namespace px {
+namespace stirling {
+
+using ::google::protobuf::RepeatedPtrField;
+
+using ::px::stirling::dynamic_tracing::ir::physical::Struct;
+using ::px::stirling::dynamic_tracing::ir::physical::StructSpec;
+using ::px::stirling::dynamic_tracing::ir::shared::ScalarType;
+using ::px::utils::MemCpy;
+
+namespace {
+
+// Parses the content of the input bytes based on the schema in the StructSpec,
+// and returns the content as JSON string.
+std::string ParseStructBlobToJSON(const StructSpec& struct_spec, std::string_view bytes) {
+  rapidjson::Document d;
+  d.SetObject();
+  for (const auto& entry : struct_spec.entries()) {
+    const void* ptr = bytes.data() + entry.offset();
+
+#define CASE(type)                                        \
+  {                                                       \
+    type tmp = MemCpy<type>(ptr);                         \
+    rapidjson::Pointer(entry.path().c_str()).Set(d, tmp); \
+    break;                                                \
+  }
+    switch (entry.type()) {
+      case ScalarType::BOOL:
+        CASE(bool);
+      case ScalarType::INT:
+        CASE(int);
+      case ScalarType::INT8:
+        CASE(int8_t);
+      case ScalarType::INT16:
+        CASE(int16_t);
+      case ScalarType::INT32:
+        CASE(int32_t);
+      case ScalarType::INT64:
+        CASE(int64_t);
+      case ScalarType::UINT:
+        CASE(unsigned int);
+      case ScalarType::UINT8:
+        CASE(uint8_t);
+      case ScalarType::UINT16:
+        CASE(uint16_t);
+      case ScalarType::UINT32:
+        CASE(uint32_t);
+      case ScalarType::UINT64:
+        CASE(uint64_t);
+      case ScalarType::SHORT:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(short);
+      case ScalarType::USHORT:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(unsigned short);
+      case ScalarType::LONG:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(long);
+      case ScalarType::ULONG:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(unsigned long);
+      case ScalarType::LONGLONG:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(int64_t);  // NOTE: had to change from "long long" for rapidjson
+      case ScalarType::ULONGLONG:
+        // NOLINTNEXTLINE(runtime/int)
+        CASE(uint64_t);  // NOTE: had to change from "unsigned long long" for rapidjson
+      case ScalarType::CHAR:
+        CASE(char);
+      case ScalarType::UCHAR:
+        CASE(unsigned char);
+      case ScalarType::FLOAT:
+        CASE(float);
+      case ScalarType::DOUBLE:
+        CASE(double);
+      case ScalarType::VOID_POINTER:
+        CASE(uint64_t);
+      default:
+        LOG(DFATAL) << absl::Substitute("Unhandled type=$0", entry.type());
+    }
+  }
+#undef CASE
+
+  rapidjson::StringBuffer sb;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+  d.Accept(writer);
+  return std::string(sb.GetString());
+}
+
+// The layout of the variable-length fields. These must match "struct string", "struct byte_array"
+// and "struct struct_blob" defined in code_gen.cc. For reference:
+//
+// struct string {
+//   uint64_t len;
+//   char buf[kStructStringSize-sizeof(int64_t)-1];
+//   uint8_t truncated;
+// };
+//
+// TODO(oazizi): Find a better way to keep these in sync.
+
+// Returns the bytes held by a string or byte_array field of the given total size, and whether
+// they were truncated.
+std::string_view LengthPrefixedBytes(const char* field, size_t field_size, bool* truncated) {
+  const size_t kMaxLen = field_size - sizeof(uint64_t) - 1;
+  size_t len = std::min<size_t>(MemCpy<uint64_t>(field), kMaxLen);
+  *truncated = MemCpy<uint8_t>(field + field_size - 1) != 0;
+  return std::string_view(field + sizeof(uint64_t), len);
+}
+
+std::string DecodeString(const char* field) {
+  bool truncated;
+  std::string s(LengthPrefixedBytes(field, dynamic_tracing::kStructStringSize, &truncated));
+  if (truncated) {
+    absl::StrAppend(&s, "<truncated>");
+  }
+  return s;
+}
+
+std::string DecodeByteArrayAsHex(const char* field) {
+  bool truncated;
+  std::string s = BytesToString<bytes_format::HexCompact>(
+      LengthPrefixedBytes(field, dynamic_tracing::kStructByteArraySize, &truncated));
+  if (truncated) {
+    absl::StrAppend(&s, "<truncated>");
+  }
+  return s;
+}
+
+std::string DecodeStructBlobAsJSON(const char* field,
+                                   const RepeatedPtrField<StructSpec>& struct_specs) {
+  constexpr size_t kHeaderSize = sizeof(uint64_t) + sizeof(int8_t);
+  size_t len =
+      std::min<size_t>(MemCpy<uint64_t>(field), dynamic_tracing::kStructBlobSize - kHeaderSize);
+  int8_t idx = MemCpy<int8_t>(field + sizeof(uint64_t));
+  std::string_view bytes(field + kHeaderSize, len);
+
+  if (idx < 0) {
+    // BPF could not figure out the correct index to the implementation type of an interface.
+    // This can happen if the implementation type was not support yet. Examples include pointer
+    // types, and base/native types.
+    //
+    // TODO(yzhao): Change to output the literal interface struct in this case. Such that we could
+    // remove this special case.
+    return absl::Substitute(R"({"bytes": "$0"})", BytesToString<bytes_format::Hex>(bytes));
+  }
+
+  // This tells which StructSpec actually describes the data.
+  ECHECK_LT(idx, struct_specs.size());
+  return ParseStructBlobToJSON(struct_specs.Get(idx), bytes);
+}
+
+template <typename TNativeType, typename TColumnType>
+void WriteScalar(const char* field, size_t col_idx, DataTable::DynamicRecordBuilder* r) {
+  r->Append(col_idx, TColumnType(MemCpy<TNativeType>(field)));
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<StructRecordDecoder>> StructRecordDecoder::Create(const Struct& st) {
+#define SCALAR_OP(native_type, column_type)             \
+  {                                                     \
+    op.writer = &WriteScalar<native_type, column_type>; \
+    size = sizeof(native_type);                         \
+    break;                                              \
+  }
+
+  std::unique_ptr<StructRecordDecoder> decoder(new StructRecordDecoder());
+
+  size_t offset = 0;
+  size_t col_idx = 0;
+  for (int i = 0; i < st.fields_size(); ++i) {
+    const auto& field = st.fields(i);
+
+    Op op = {OpCode::kScalar, offset, col_idx++};
+    size_t size = 0;
+
+    if (field.name() == "time_") {
+      op.code = OpCode::kTime;
+      size = sizeof(uint64_t);
+    } else if ((field.name() == "tgid_") && (i + 1 < st.fields_size()) &&
+               (st.fields(i + 1).name() == "tgid_start_time_")) {
+      // If we see "tgid_" and "tgid_start_time_" back-to-back, then we automatically create UPID.
+      op.code = OpCode::kUPID;
+      size = sizeof(uint32_t) + sizeof(uint64_t);
+
+      // Consume the extra tgid_start_time_ field.
+      ++i;
+    } else {
+      switch (field.type()) {
+        case ScalarType::BOOL:
+          SCALAR_OP(bool, types::BoolValue);
+        case ScalarType::INT:
+          SCALAR_OP(int, types::Int64Value);
+        case ScalarType::INT8:
+          SCALAR_OP(int8_t, types::Int64Value);
+        case ScalarType::INT16:
+          SCALAR_OP(int16_t, types::Int64Value);
+        case ScalarType::INT32:
+          SCALAR_OP(int32_t, types::Int64Value);
+        case ScalarType::INT64:
+          SCALAR_OP(int64_t, types::Int64Value);
+        case ScalarType::UINT:
+          SCALAR_OP(unsigned int, types::Int64Value);
+        case ScalarType::UINT8:
+          SCALAR_OP(uint8_t, types::Int64Value);
+        case ScalarType::UINT16:
+          SCALAR_OP(uint16_t, types::Int64Value);
+        case ScalarType::UINT32:
+          SCALAR_OP(uint32_t, types::Int64Value);
+        case ScalarType::UINT64:
+          SCALAR_OP(uint64_t, types::Int64Value);
+
+        case ScalarType::SHORT:
+          // NOLINTNEXTLINE(runtime/int)
+          SCALAR_OP(short, types::Int64Value);
+        case ScalarType::USHORT:
+          // NOLINTNEXTLINE(runtime/int)
+          SCALAR_OP(unsigned short, types::Int64Value);
+        case ScalarType::LONG:
+          // NOLINTNEXTLINE(runtime/int)
+          SCALAR_OP(long, types::Int64Value);
+        case ScalarType::ULONG:
+          // NOLINTNEXTLINE(runtime/int)
+          SCALAR_OP(unsigned long, types::Int64Value);
+        case ScalarType::LONGLONG:
+          // NOLINTNEXTLINE(runtime/int)
+          SCALAR_OP(long long, types::Int64Value);
+        case ScalarType::ULONGLONG:
+          // NOLINTNEXTLINE(runtime/int)
+          SCALAR_OP(unsigned long long, types::Int64Value);
+        case ScalarType::CHAR:
+          SCALAR_OP(char, types::Int64Value);
+        case ScalarType::UCHAR:
+          SCALAR_OP(unsigned char, types::Int64Value);
+
+        case ScalarType::FLOAT:
+          SCALAR_OP(float, types::Float64Value);
+        case ScalarType::DOUBLE:
+          SCALAR_OP(double, types::Float64Value);
+        case ScalarType::VOID_POINTER:
+          SCALAR_OP(uint64_t, types::Int64Value);
+
+        case ScalarType::STRING:
+          op.code = OpCode::kString;
+          size = dynamic_tracing::kStructStringSize;
+          break;
+        case ScalarType::BYTE_ARRAY:
+          op.code = OpCode::kByteArray;
+          size = dynamic_tracing::kStructByteArraySize;
+          break;
+        case ScalarType::STRUCT_BLOB:
+          op.code = OpCode::kStructBlob;
+          op.blob_decoders = &field.blob_decoders();
+          size = dynamic_tracing::kStructBlobSize;
+          break;
+
+        case ScalarType::UNKNOWN:
+          return error::Internal("Unknown scalar type should not be used.");
+        case ScalarType::ScalarType_INT_MIN_SENTINEL_DO_NOT_USE_:
+        case ScalarType::ScalarType_INT_MAX_SENTINEL_DO_NOT_USE_:
+          return error::Internal("Impossible enum value");
+      }
+    }
+
+    decoder->ops_.push_back(op);
+    offset += size;
+  }
+#undef SCALAR_OP
+
+  decoder->record_size_ = offset;
+  return decoder;
+}
+
+Status StructRecordDecoder::AppendRecord(uint32_t asid, std::string_view buf,
+                                         DataTable* data_table) const {
+  // Checking the size once up front makes every field read below in bounds.
+  if (buf.size() < record_size_) {
+    return error::ResourceUnavailable("Insufficient number of bytes. Expected $0, got $1.",
+                                      record_size_, buf.size());
+  }
+
+  DataTable::DynamicRecordBuilder r(data_table);
+
+  for (const Op& op : ops_) {
+    const char* field = buf.data() + op.offset;
+    switch (op.code) {
+      case OpCode::kScalar:
+        op.writer(field, op.col_idx, &r);
+        break;
+      case OpCode::kTime: {
+        int64_t time = sysconfig_->ConvertToRealTime(MemCpy<uint64_t>(field));
+        r.Append(op.col_idx, types::Time64NSValue(time));
+        break;
+      }
+      case OpCode::kUPID: {
+        md::UPID upid(asid, MemCpy<uint32_t>(field), MemCpy<uint64_t>(field + sizeof(uint32_t)));
+        r.Append(op.col_idx, types::UInt128Value(upid.value()));
+        break;
+      }
+      case OpCode::kString:
+        r.Append(op.col_idx, types::StringValue(DecodeString(field)));
+        break;
+      case OpCode::kByteArray:
+        r.Append(op.col_idx, types::StringValue(DecodeByteArrayAsHex(field)));
+        break;
+      case OpCode::kStructBlob:
+        r.Append(op.col_idx, types::StringValue(DecodeStructBlobAsJSON(field, *op.blob_decoders)));
+        break;
+    }
+  }
+
+  return Status::OK();
+}
+
+}  // namespace stirling
+}  // namespace px
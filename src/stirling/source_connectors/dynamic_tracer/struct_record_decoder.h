@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/common/system/config.h"
+#include "src/stirling/core/data_table.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_tracing/ir/physicalpb/physical.pb.h"
+
+namespace px {
+namespace stirling {
+
+/**
+ * Decodes the records of a dynamic trace output struct into a DataTable.
+ *
+ * The struct layout is compiled once, when the trace is deployed, into a flat list of ops with
+ * precomputed offsets and column writers. Decoding a record then reads the fields straight out
+ * of the perf buffer memory, without walking the struct description or copying the record.
+ */
+class StructRecordDecoder {
+ public:
+  /**
+   * Compiles the layout of the output struct. The struct must outlive the decoder, since the
+   * decoders of STRUCT_BLOB fields are referenced from it.
+   */
+  static StatusOr<std::unique_ptr<StructRecordDecoder>> Create(
+      const dynamic_tracing::ir::physical::Struct& st);
+
+  /**
+   * The number of bytes of a record, which the fields are packed into.
+   */
+  size_t record_size() const { return record_size_; }
+
+  /**
+   * Appends the record in buf to the data table.
+   */
+  Status AppendRecord(uint32_t asid, std::string_view buf, DataTable* data_table) const;
+
+ private:
+  using ColumnWriter = void (*)(const char* field, size_t col_idx,
+                                DataTable::DynamicRecordBuilder* r);
+
+  enum class OpCode {
+    // Writes a fixed-size field through the op's writer.
+    kScalar,
+    // Converts a BPF timestamp to real time.
+    kTime,
+    // Synthesizes the UPID from the tgid_ and tgid_start_time_ fields.
+    kUPID,
+    kString,
+    kByteArray,
+    kStructBlob,
+  };
+
+  struct Op {
+    OpCode code;
+    size_t offset;
+    size_t col_idx;
+    ColumnWriter writer = nullptr;
+    const google::protobuf::RepeatedPtrField<dynamic_tracing::ir::physical::StructSpec>*
+        blob_decoders = nullptr;
+  };
+
+  StructRecordDecoder() = default;
+
+  std::vector<Op> ops_;
+  size_t record_size_ = 0;
+  const system::Config* sysconfig_ = &system::Config::GetInstance();
+};
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+
+#include "src/common/base/base.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_trace_connector.h"
+#include "src/stirling/source_connectors/dynamic_tracer/struct_record_decoder.h"
+
+using ::px::stirling::ConvertFields;
+using ::px::stirling::DataTable;
+using ::px::stirling::DynamicDataTableSchema;
+using ::px::stirling::StructRecordDecoder;
+using ::px::stirling::dynamic_tracing::ir::physical::Struct;
+using ::px::stirling::dynamic_tracing::ir::shared::ScalarType;
+
+constexpr int kRecordsPerTransfer = 1024;
+
+// An output struct like those of function tracepoints: the UPID, the time, and the given number
+// of integer arguments.
+Struct OutputStruct(int num_args) {
+  Struct st;
+  st.set_name("out_table_value_t");
+
+  auto* field = st.add_fields();
+  field->set_name("tgid_");
+  field->set_type(ScalarType::INT32);
+  field = st.add_fields();
+  field->set_name("tgid_start_time_");
+  field->set_type(ScalarType::UINT64);
+  field = st.add_fields();
+  field->set_name("time_");
+  field->set_type(ScalarType::UINT64);
+
+  for (int i = 0; i < num_args; ++i) {
+    field = st.add_fields();
+    field->set_name(absl::StrCat("arg", i));
+    field->set_type(ScalarType::INT64);
+  }
+  return st;
+}
+
+// NOLINTNEXTLINE(runtime/references)
+static void BM_AppendRecord(benchmark::State& state) {
+  Struct st = OutputStruct(state.range(0));
+  auto schema = DynamicDataTableSchema::Create("out_table", "", ConvertFields(st.fields()));
+  DataTable data_table(/*id*/ 0, schema->Get());
+  auto decoder = StructRecordDecoder::Create(st).ConsumeValueOrDie();
+
+  std::string record(decoder->record_size(), '\1');
+
+  for (auto _ : state) {
+    for (int i = 0; i < kRecordsPerTransfer; ++i) {
+      PL_CHECK_OK(decoder->AppendRecord(/*asid*/ 0, record, &data_table));
+    }
+    benchmark::DoNotOptimize(data_table.ConsumeRecords());
+  }
+
+  state.SetItemsProcessed(state.iterations() * kRecordsPerTransfer);
+  state.SetBytesProcessed(state.iterations() * kRecordsPerTransfer * record.size());
+}
+
+BENCHMARK(BM_AppendRecord)->Arg(1)->Arg(4)->Arg(16);
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+
+#include "src/common/testing/testing.h"
+#include "src/shared/upid/upid.h"
+#include "src/stirling/source_connectors/dynamic_tracer/dynamic_trace_connector.h"
+#include "src/stirling/source_connectors/dynamic_tracer/struct_record_decoder.h"
+
+namespace px {
+namespace stirling {
+
+using ::px::stirling::dynamic_tracing::ir::physical::Struct;
+
+constexpr std::string_view kOutputStruct = R"(
+    name: "out_table_value_t"
+    fields {
+      name: "tgid_"
+      type: INT32
+    }
+    fields {
+      name: "tgid_start_time_"
+      type: UINT64
+    }
+    fields {
+      name: "arg0"
+      type: INT
+    }
+    fields {
+      name: "arg1"
+      type: BOOL
+    }
+    fields {
+      name: "arg2"
+      type: STRING
+    }
+    fields {
+      name: "arg3"
+      type: DOUBLE
+    }
+)";
+
+template <typename T>
+void AppendField(std::string* buf, T val) {
+  buf->append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+// Lays out a record the way the BPF code packs the output struct.
+std::string MakeRecord(uint32_t tgid, uint64_t tgid_start_time, int arg0, bool arg1,
+                       std::string_view arg2, double arg3) {
+  std::string buf;
+  AppendField(&buf, tgid);
+  AppendField(&buf, tgid_start_time);
+  AppendField(&buf, arg0);
+  AppendField(&buf, arg1);
+
+  std::string str(dynamic_tracing::kStructStringSize, '\0');
+  uint64_t len = arg2.size();
+  memcpy(str.data(), &len, sizeof(len));
+  memcpy(str.data() + sizeof(len), arg2.data(), arg2.size());
+  buf.append(str);
+
+  AppendField(&buf, arg3);
+  return buf;
+}
+
+class StructRecordDecoderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(
+        google::protobuf::TextFormat::ParseFromString(std::string(kOutputStruct), &output_struct_));
+    schema_ =
+        DynamicDataTableSchema::Create("out_table", "", ConvertFields(output_struct_.fields()));
+    data_table_ = std::make_unique<DataTable>(/*id*/ 0, schema_->Get());
+  }
+
+  Struct output_struct_;
+  std::unique_ptr<DynamicDataTableSchema> schema_;
+  std::unique_ptr<DataTable> data_table_;
+};
+
+TEST_F(StructRecordDecoderTest, AppendRecords) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<StructRecordDecoder> decoder,
+                       StructRecordDecoder::Create(output_struct_));
+  EXPECT_EQ(decoder->record_size(), 4 + 8 + 4 + 1 + dynamic_tracing::kStructStringSize + 8);
+
+  constexpr uint32_t kASID = 3;
+  ASSERT_OK(decoder->AppendRecord(kASID, MakeRecord(123, 456, -7, true, "foo", 1.5),
+                                  data_table_.get()));
+  ASSERT_OK(decoder->AppendRecord(kASID, MakeRecord(123, 456, 8, false, "bar", -2.0),
+                                  data_table_.get()));
+
+  std::vector<TaggedRecordBatch> tablets = data_table_->ConsumeRecords();
+  ASSERT_EQ(tablets.size(), 1);
+  const types::ColumnWrapperRecordBatch& records = tablets[0].records;
+  ASSERT_EQ(records.size(), 5);
+  ASSERT_EQ(records[0]->Size(), 2);
+
+  EXPECT_EQ(records[0]->Get<types::UInt128Value>(0), md::UPID(kASID, 123, 456).value());
+  EXPECT_EQ(records[1]->Get<types::Int64Value>(0), -7);
+  EXPECT_EQ(records[1]->Get<types::Int64Value>(1), 8);
+  EXPECT_EQ(records[2]->Get<types::BoolValue>(0), true);
+  EXPECT_EQ(records[2]->Get<types::BoolValue>(1), false);
+  EXPECT_EQ(records[3]->Get<types::StringValue>(0), "foo");
+  EXPECT_EQ(records[3]->Get<types::StringValue>(1), "bar");
+  EXPECT_EQ(records[4]->Get<types::Float64Value>(0), 1.5);
+  EXPECT_EQ(records[4]->Get<types::Float64Value>(1), -2.0);
+}
+
+TEST_F(StructRecordDecoderTest, ShortRecord) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<StructRecordDecoder> decoder,
+                       StructRecordDecoder::Create(output_struct_));
+
+  std::string record = MakeRecord(123, 456, -7, true, "foo", 1.5);
+  record.pop_back();
+  EXPECT_NOT_OK(decoder->AppendRecord(/*asid*/ 0, record, data_table_.get()));
+}
+
+}  // namespace stirling
+}  // namespace px
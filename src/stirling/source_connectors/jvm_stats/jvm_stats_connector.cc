@@ -18,6 +18,7 @@
 
 #include "src/stirling/source_connectors/jvm_stats/jvm_stats_connector.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -61,26 +62,23 @@ void JVMStatsConnector::FindJavaUPIDs(const ConnectorContext& ctx) {
       continue;
     }
     PL_ASSIGN_OR(auto hsperf_data_path, java::HsperfdataPath(pid), continue);
-    java_procs_[upid].hsperf_data_path = hsperf_data_path;
+    java_procs_[upid].hsperf_data_reader =
+        std::make_unique<java::HsperfdataReader>(std::move(hsperf_data_path));
   }
 }
 
 Status JVMStatsConnector::ExportStats(const md::UPID& upid,
-                                      const std::filesystem::path& hsperf_data_path,
+                                      java::HsperfdataReader* hsperf_data_reader,
                                       DataTable* data_table) const {
-  PL_ASSIGN_OR_RETURN(std::string hsperf_data_str, ReadFileToString(hsperf_data_path));
+  PL_RETURN_IF_ERROR(hsperf_data_reader->Refresh());
 
-  if (hsperf_data_str.empty()) {
-    // Assume this is a transient failure.
-    return Status::OK();
-  }
-
-  java::Stats stats(std::move(hsperf_data_str));
-  if (!stats.Parse().ok()) {
+  if (!hsperf_data_reader->valid()) {
     // Assumes this is a transient failure.
     return Status::OK();
   }
 
+  java::Stats stats = hsperf_data_reader->ReadStats();
+
   uint64_t time = AdjustedSteadyClockNowNS();
 
   DataTable::RecordBuilder<&kJVMStatsTable> r(data_table, time);
@@ -111,7 +109,7 @@ void JVMStatsConnector::TransferDataImpl(ConnectorContext* ctx,
     JavaProcInfo& java_proc = iter->second;
 
     md::UPID upid_with_asid(ctx->GetASID(), upid.pid(), upid.start_ts());
-    auto status = ExportStats(upid_with_asid, java_proc.hsperf_data_path, data_table);
+    auto status = ExportStats(upid_with_asid, java_proc.hsperf_data_reader.get(), data_table);
     if (!status.ok()) {
       ++java_proc.export_failure_count;
     }
@@ -65,7 +65,7 @@ class JVMStatsConnector : public SourceConnector {
   void FindJavaUPIDs(const ConnectorContext& ctx);
 
   // Exports JVM performance metrics to data table.
-  Status ExportStats(const md::UPID& upid, const std::filesystem::path& hsperf_data_path,
+  Status ExportStats(const md::UPID& upid, java::HsperfdataReader* hsperf_data_reader,
                      DataTable* data_table) const;
 
   // Keeps track of the currently-running processes. Used to find the newly-created processes.
@@ -76,7 +76,8 @@ class JVMStatsConnector : public SourceConnector {
     // How many times we have failed to export stats for this process. Once this reaches a limit,
     // the process will no longer be monitored.
     int export_failure_count = 0;
-    std::filesystem::path hsperf_data_path;
+    // Keeps the hsperfdata file mapped across sampling iterations.
+    std::unique_ptr<java::HsperfdataReader> hsperf_data_reader;
   };
   absl::flat_hash_map<md::UPID, JavaProcInfo> java_procs_;
 };
@@ -18,8 +18,15 @@
 
 #include "src/stirling/source_connectors/jvm_stats/utils/java.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <absl/strings/match.h>
 
+#include <cstring>
+
 #include <map>
 #include <memory>
 #include <string>
@@ -41,6 +48,29 @@ using ::px::stirling::java::hsperf::ParseHsperfData;
 using ::px::system::ProcParser;
 using ::px::utils::LEndianBytesToInt;
 
+namespace {
+
+constexpr std::string_view kYoungGCTimeSuffix = "gc.collector.0.time";
+constexpr std::string_view kFullGCTimeSuffix = "gc.collector.1.time";
+constexpr std::string_view kUsedHeapSizeSuffixes[] = {
+    "gc.generation.0.space.0.used",
+    "gc.generation.0.space.1.used",
+    "gc.generation.0.space.2.used",
+    "gc.generation.1.space.0.used",
+};
+constexpr std::string_view kTotalHeapSizeSuffixes[] = {
+    "gc.generation.0.space.0.capacity",
+    "gc.generation.0.space.1.capacity",
+    "gc.generation.0.space.2.capacity",
+    "gc.generation.1.space.0.capacity",
+};
+constexpr std::string_view kMaxHeapSizeSuffixes[] = {
+    "gc.generation.0.maxCapacity",
+    "gc.generation.1.maxCapacity",
+};
+
+}  // namespace
+
 Stats::Stats(std::vector<Stat> stats) : stats_(std::move(stats)) {}
 
 Stats::Stats(std::string hsperf_data_str) : hsperf_data_(std::move(hsperf_data_str)) {}
@@ -58,33 +88,35 @@ Status Stats::Parse() {
   return Status::OK();
 }
 
-uint64_t Stats::YoungGCTimeNanos() const { return StatForSuffix("gc.collector.0.time"); }
+uint64_t Stats::YoungGCTimeNanos() const { return StatForSuffix(kYoungGCTimeSuffix); }
 
-uint64_t Stats::FullGCTimeNanos() const { return StatForSuffix("gc.collector.1.time"); }
+uint64_t Stats::FullGCTimeNanos() const { return StatForSuffix(kFullGCTimeSuffix); }
 
 uint64_t Stats::UsedHeapSizeBytes() const {
-  return SumStatsForSuffixes({
-      "gc.generation.0.space.0.used",
-      "gc.generation.0.space.1.used",
-      "gc.generation.0.space.2.used",
-      "gc.generation.1.space.0.used",
-  });
+  return SumStatsForSuffixes({std::begin(kUsedHeapSizeSuffixes), std::end(kUsedHeapSizeSuffixes)});
 }
 
 uint64_t Stats::TotalHeapSizeBytes() const {
-  return SumStatsForSuffixes({
-      "gc.generation.0.space.0.capacity",
-      "gc.generation.0.space.1.capacity",
-      "gc.generation.0.space.2.capacity",
-      "gc.generation.1.space.0.capacity",
-  });
+  return SumStatsForSuffixes(
+      {std::begin(kTotalHeapSizeSuffixes), std::end(kTotalHeapSizeSuffixes)});
 }
 
 uint64_t Stats::MaxHeapSizeBytes() const {
-  return SumStatsForSuffixes({
-      "gc.generation.0.maxCapacity",
-      "gc.generation.1.maxCapacity",
-  });
+  return SumStatsForSuffixes({std::begin(kMaxHeapSizeSuffixes), std::end(kMaxHeapSizeSuffixes)});
+}
+
+bool Stats::IsExportedStat(std::string_view name) {
+  auto ends_with_any = [name](const auto& suffixes) {
+    for (std::string_view suffix : suffixes) {
+      if (absl::EndsWith(name, suffix)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  return absl::EndsWith(name, kYoungGCTimeSuffix) || absl::EndsWith(name, kFullGCTimeSuffix) ||
+         ends_with_any(kUsedHeapSizeSuffixes) || ends_with_any(kTotalHeapSizeSuffixes) ||
+         ends_with_any(kMaxHeapSizeSuffixes);
 }
 
 uint64_t Stats::StatForSuffix(std::string_view suffix) const {
@@ -104,6 +136,109 @@ uint64_t Stats::SumStatsForSuffixes(const std::vector<std::string_view>& suffixe
   return sum;
 }
 
+HsperfdataReader::HsperfdataReader(std::filesystem::path hsperf_data_path)
+    : hsperf_data_path_(std::move(hsperf_data_path)) {}
+
+HsperfdataReader::~HsperfdataReader() { Unmap(); }
+
+Status HsperfdataReader::Refresh() {
+  struct stat st;
+  if (stat(hsperf_data_path_.c_str(), &st) != 0) {
+    return error::Internal("Could not stat $0: $1", hsperf_data_path_.string(),
+                           std::strerror(errno));
+  }
+  if (data_ == nullptr || st.st_dev != dev_ || st.st_ino != inode_ ||
+      static_cast<size_t>(st.st_size) != size_) {
+    Unmap();
+    PL_RETURN_IF_ERROR(Map());
+  }
+  if (size_ < sizeof(hsperf::Prologue)) {
+    // The JVM has not populated the file yet.
+    valid_ = false;
+    return Status::OK();
+  }
+  const auto* prologue = reinterpret_cast<const hsperf::Prologue*>(data_);
+  if (!valid_ || prologue->num_entries != num_entries_ ||
+      prologue->mod_timestamp != mod_timestamp_) {
+    Index();
+  }
+  return Status::OK();
+}
+
+Status HsperfdataReader::Map() {
+  int fd = open(hsperf_data_path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return error::Internal("Could not open $0: $1", hsperf_data_path_.string(),
+                           std::strerror(errno));
+  }
+  DEFER(close(fd));
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    return error::Internal("Could not stat $0: $1", hsperf_data_path_.string(),
+                           std::strerror(errno));
+  }
+  dev_ = st.st_dev;
+  inode_ = st.st_ino;
+  size_ = st.st_size;
+  valid_ = false;
+  if (size_ == 0) {
+    // Nothing to map yet; remapped once the JVM sizes the file.
+    return Status::OK();
+  }
+
+  void* addr = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    size_ = 0;
+    return error::Internal("Could not mmap $0: $1", hsperf_data_path_.string(),
+                           std::strerror(errno));
+  }
+  data_ = static_cast<const char*>(addr);
+  return Status::OK();
+}
+
+void HsperfdataReader::Unmap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  valid_ = false;
+  counters_.clear();
+}
+
+void HsperfdataReader::Index() {
+  counters_.clear();
+
+  hsperf::HsperfData hsperf_data = {};
+  valid_ = ParseHsperfData(std::string_view(data_, size_), &hsperf_data).ok();
+  if (!valid_) {
+    // Assumes this is a transient failure, and retries on the next Refresh().
+    return;
+  }
+  num_entries_ = hsperf_data.prologue->num_entries;
+  mod_timestamp_ = hsperf_data.prologue->mod_timestamp;
+
+  for (const auto& entry : hsperf_data.data_entries) {
+    if (entry.header->data_type != static_cast<uint8_t>(hsperf::DataType::kLong) ||
+        entry.data.size() != sizeof(uint64_t) || !Stats::IsExportedStat(entry.name)) {
+      continue;
+    }
+    counters_.push_back({entry.name, static_cast<size_t>(entry.data.data() - data_)});
+  }
+}
+
+Stats HsperfdataReader::ReadStats() const {
+  DCHECK(valid_);
+  std::vector<Stats::Stat> stats;
+  stats.reserve(counters_.size());
+  for (const auto& counter : counters_) {
+    std::string_view buf(data_ + counter.offset, sizeof(uint64_t));
+    stats.push_back({counter.name, LEndianBytesToInt<uint64_t>(buf)});
+  }
+  return Stats(std::move(stats));
+}
+
 StatusOr<std::filesystem::path> HsperfdataPath(pid_t pid) {
   const system::Config& sysconfig = system::Config::GetInstance();
   const std::filesystem::path& host_path = sysconfig.host_path();
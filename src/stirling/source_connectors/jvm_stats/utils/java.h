@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "src/common/base/mixins.h"
 #include "src/common/base/statusor.h"
 
 namespace px {
@@ -56,6 +57,11 @@ class Stats {
   uint64_t TotalHeapSizeBytes() const;
   uint64_t MaxHeapSizeBytes() const;
 
+  /**
+   * Returns true if the stat of the given name contributes to any of the computed stats above.
+   */
+  static bool IsExportedStat(std::string_view name);
+
  private:
   uint64_t StatForSuffix(std::string_view suffix) const;
   uint64_t SumStatsForSuffixes(const std::vector<std::string_view>& suffixes) const;
@@ -64,6 +70,61 @@ class Stats {
   std::vector<Stat> stats_;
 };
 
+/**
+ * Keeps a read-only memory mapping of the hsperfdata file of a JVM, and reads the exported stats
+ * directly from the mapped counters. The entry directory is parsed only when the file is mapped,
+ * or when the JVM has added new entries since; the rest of the time a read only touches the
+ * handful of counters used by Stats.
+ */
+class HsperfdataReader : public NotCopyable {
+ public:
+  explicit HsperfdataReader(std::filesystem::path hsperf_data_path);
+  ~HsperfdataReader();
+
+  /**
+   * Re-validates the mapping against the file on disk. Re-maps the file if it was recreated or
+   * resized, and re-indexes the counters if the JVM has added entries. Returns an error if the
+   * file cannot be accessed.
+   */
+  Status Refresh();
+
+  /**
+   * Returns true if the mapped file holds parsable hsperfdata. This is false for a JVM that has
+   * not yet populated its hsperfdata file.
+   */
+  bool valid() const { return valid_; }
+
+  /**
+   * Reads the current values of the exported counters. The names in the returned Stats point
+   * into the mapping, and are only valid until the next call to Refresh().
+   */
+  Stats ReadStats() const;
+
+ private:
+  Status Map();
+  void Unmap();
+  void Index();
+
+  struct Counter {
+    std::string_view name;
+    size_t offset;
+  };
+
+  std::filesystem::path hsperf_data_path_;
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  dev_t dev_ = 0;
+  ino_t inode_ = 0;
+
+  // The prologue fields at the time of the last indexing. The JVM bumps these when adding entries.
+  uint32_t num_entries_ = 0;
+  uint64_t mod_timestamp_ = 0;
+
+  bool valid_ = false;
+  std::vector<Counter> counters_;
+};
+
 /**
  * Returns the path of the hsperfdata for a JVM process.
  */
@@ -22,6 +22,7 @@
 #include <gtest/gtest.h>
 
 #include <filesystem>
+#include <fstream>
 #include <string>
 #include <string_view>
 
@@ -29,7 +30,9 @@
 
 #include "src/common/base/test_utils.h"
 #include "src/common/exec/subprocess.h"
+#include "src/common/testing/temp_dir.h"
 #include "src/common/testing/test_environment.h"
+#include "src/stirling/source_connectors/jvm_stats/utils/hsperfdata.h"
 
 namespace px {
 namespace stirling {
@@ -59,6 +62,81 @@ TEST(StatsTest, CommonValues) {
   EXPECT_EQ(2, stats.MaxHeapSizeBytes());
 }
 
+constexpr char kTestHsperfdataPath[] =
+    "src/stirling/source_connectors/jvm_stats/utils/test_hsperfdata";
+
+void ExpectSameStats(const Stats& expected, const Stats& actual) {
+  EXPECT_EQ(expected.YoungGCTimeNanos(), actual.YoungGCTimeNanos());
+  EXPECT_EQ(expected.FullGCTimeNanos(), actual.FullGCTimeNanos());
+  EXPECT_EQ(expected.UsedHeapSizeBytes(), actual.UsedHeapSizeBytes());
+  EXPECT_EQ(expected.TotalHeapSizeBytes(), actual.TotalHeapSizeBytes());
+  EXPECT_EQ(expected.MaxHeapSizeBytes(), actual.MaxHeapSizeBytes());
+}
+
+// Tests that the mmap-based reader produces the same stats as parsing the whole file.
+TEST(HsperfdataReaderTest, MatchesFullParse) {
+  ASSERT_OK_AND_ASSIGN(const std::string content,
+                       ReadFileToString(testing::TestFilePath(kTestHsperfdataPath)));
+  Stats expected(content);
+  ASSERT_OK(expected.Parse());
+
+  testing::TempDir temp_dir;
+  const std::filesystem::path path = temp_dir.path() / "hsperfdata";
+  ASSERT_OK(WriteFileFromString(path, content));
+
+  HsperfdataReader reader(path);
+  ASSERT_OK(reader.Refresh());
+  ASSERT_TRUE(reader.valid());
+  ExpectSameStats(expected, reader.ReadStats());
+}
+
+// Tests that counter updates written in place by the JVM are picked up without re-reading the
+// file, and that a recreated file is re-mapped.
+TEST(HsperfdataReaderTest, ReadsUpdatedCounters) {
+  ASSERT_OK_AND_ASSIGN(std::string content,
+                       ReadFileToString(testing::TestFilePath(kTestHsperfdataPath)));
+
+  hsperf::HsperfData hsperf_data = {};
+  ASSERT_OK(hsperf::ParseHsperfData(content, &hsperf_data));
+  size_t young_gc_time_offset = 0;
+  for (const auto& entry : hsperf_data.data_entries) {
+    if (absl::EndsWith(entry.name, "gc.collector.0.time")) {
+      young_gc_time_offset = entry.data.data() - content.data();
+    }
+  }
+  ASSERT_NE(young_gc_time_offset, 0);
+
+  testing::TempDir temp_dir;
+  const std::filesystem::path path = temp_dir.path() / "hsperfdata";
+  ASSERT_OK(WriteFileFromString(path, content));
+
+  HsperfdataReader reader(path);
+  ASSERT_OK(reader.Refresh());
+  ASSERT_TRUE(reader.valid());
+
+  const uint64_t kYoungGCTime = 123456789;
+  {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(young_gc_time_offset);
+    f.write(reinterpret_cast<const char*>(&kYoungGCTime), sizeof(kYoungGCTime));
+  }
+  ASSERT_OK(reader.Refresh());
+  EXPECT_EQ(reader.ReadStats().YoungGCTimeNanos(), kYoungGCTime);
+
+  // Recreate the file with a different value; the reader should follow the new file.
+  const uint64_t kNewYoungGCTime = 987654321;
+  content.replace(young_gc_time_offset, sizeof(kNewYoungGCTime),
+                  reinterpret_cast<const char*>(&kNewYoungGCTime), sizeof(kNewYoungGCTime));
+  std::filesystem::remove(path);
+  ASSERT_OK(WriteFileFromString(path, content));
+  ASSERT_OK(reader.Refresh());
+  ASSERT_TRUE(reader.valid());
+  EXPECT_EQ(reader.ReadStats().YoungGCTimeNanos(), kNewYoungGCTime);
+
+  std::filesystem::remove(path);
+  EXPECT_NOT_OK(reader.Refresh());
+}
+
 TEST(HsperfdataPathTest, ResultIsAsExpected) {
   const char kClassPath[] = "src/stirling/source_connectors/jvm_stats/testing/HelloWorld.jar";
   const std::string class_path = testing::TestFilePath(kClassPath);
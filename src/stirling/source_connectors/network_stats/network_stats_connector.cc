@@ -27,6 +27,13 @@
 #include "src/common/system/proc_parser.h"
 #include "src/shared/metadata/metadata.h"
 
+DEFINE_bool(stirling_network_stats_suppress_unchanged, false,
+            "If true, a network_stats row is only recorded for a pod when its stats changed since "
+            "the last recorded row, or when a keyframe is due.");
+DEFINE_uint32(stirling_network_stats_keyframe_period, 60,
+              "When suppressing unchanged network_stats rows, the maximum number of sampling "
+              "periods between two rows of the same pod.");
+
 namespace px {
 namespace stirling {
 
@@ -35,6 +42,11 @@ using system::ProcParser;
 Status NetworkStatsConnector::InitImpl() {
   sampling_freq_mgr_.set_period(kSamplingPeriod);
   push_freq_mgr_.set_period(kPushPeriod);
+  if (FLAGS_stirling_network_stats_suppress_unchanged) {
+    change_suppressor_ =
+        std::make_unique<utils::ChangeSuppressor<std::string, ProcParser::NetworkStats>>(
+            FLAGS_stirling_network_stats_keyframe_period);
+  }
   return Status::OK();
 }
 
@@ -55,6 +67,10 @@ void NetworkStatsConnector::TransferNetworkStatsTable(ConnectorContext* ctx,
 
   int64_t timestamp = AdjustedSteadyClockNowNS();
 
+  if (change_suppressor_ != nullptr) {
+    change_suppressor_->BeginIteration();
+  }
+
   for (const auto& [pod_name, pod_id] : k8s_md.pods_by_name()) {
     PL_UNUSED(pod_name);
 
@@ -72,6 +88,11 @@ void NetworkStatsConnector::TransferNetworkStatsTable(ConnectorContext* ctx,
       continue;
     }
 
+    if (change_suppressor_ != nullptr &&
+        !change_suppressor_->ShouldRecord(std::string(pod_id), stats)) {
+      continue;
+    }
+
     DataTable::RecordBuilder<&kNetworkStatsTable> r(data_table, timestamp);
 
     r.Append<r.ColIndex("time_")>(timestamp);
@@ -85,6 +106,10 @@ void NetworkStatsConnector::TransferNetworkStatsTable(ConnectorContext* ctx,
     r.Append<r.ColIndex("tx_errors")>(stats.tx_errs);
     r.Append<r.ColIndex("tx_drops")>(stats.tx_drops);
   }
+
+  if (change_suppressor_ != nullptr) {
+    change_suppressor_->EndIteration();
+  }
 }
 
 Status NetworkStatsConnector::GetNetworkStatsForPod(const system::ProcParser& proc_parser,
@@ -30,6 +30,10 @@
 #include "src/stirling/core/canonical_types.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/source_connectors/network_stats/network_stats_table.h"
+#include "src/stirling/utils/change_suppressor.h"
+
+DECLARE_bool(stirling_network_stats_suppress_unchanged);
+DECLARE_uint32(stirling_network_stats_keyframe_period);
 
 namespace px {
 namespace stirling {
@@ -70,6 +74,10 @@ class NetworkStatsConnector : public SourceConnector {
                                       system::ProcParser::NetworkStats* stats);
 
   std::unique_ptr<system::ProcParser> proc_parser_;
+
+  // Only set when unchanged rows are suppressed. Keyed by pod ID.
+  std::unique_ptr<utils::ChangeSuppressor<std::string, system::ProcParser::NetworkStats>>
+      change_suppressor_;
 };
 
 }  // namespace stirling
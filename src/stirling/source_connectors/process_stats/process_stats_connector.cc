@@ -27,6 +27,13 @@
 #include "src/common/system/proc_parser.h"
 #include "src/shared/metadata/metadata.h"
 
+DEFINE_bool(stirling_process_stats_suppress_unchanged, false,
+            "If true, a process_stats row is only recorded for a UPID when its stats changed since "
+            "the last recorded row, or when a keyframe is due.");
+DEFINE_uint32(stirling_process_stats_keyframe_period, 60,
+              "When suppressing unchanged process_stats rows, the maximum number of sampling "
+              "periods between two rows of the same UPID.");
+
 namespace px {
 namespace stirling {
 
@@ -35,6 +42,12 @@ using system::ProcParser;
 Status ProcessStatsConnector::InitImpl() {
   sampling_freq_mgr_.set_period(kSamplingPeriod);
   push_freq_mgr_.set_period(kPushPeriod);
+  PL_ASSIGN_OR_RETURN(proc_parser_, system::BatchProcParser::Create(sysconfig_));
+  if (FLAGS_stirling_process_stats_suppress_unchanged) {
+    change_suppressor_ =
+        std::make_unique<utils::ChangeSuppressor<md::UPID, ProcParser::ProcessStats>>(
+            FLAGS_stirling_process_stats_keyframe_period);
+  }
   return Status::OK();
 }
 
@@ -46,29 +59,29 @@ void ProcessStatsConnector::TransferProcessStatsTable(ConnectorContext* ctx,
 
   int64_t timestamp = AdjustedSteadyClockNowNS();
 
+  upids_.clear();
+  pids_.clear();
   for (const auto& [upid, pid_info] : pid_info_by_upid) {
     // TODO(zasgar): Fix condition for dead pids after helper function is added.
     if (pid_info == nullptr || pid_info->stop_time_ns() > 0) {
       // PID has been stopped.
       continue;
     }
+    upids_.push_back(upid);
+    pids_.push_back(upid.pid());
+  }
 
-    ProcParser::ProcessStats stats;
-    int32_t pid = upid.pid();
-    // TODO(zasgar): We should double check the process start time to make sure it still the same
-    // PID.
-    auto s1 = proc_parser_->ParseProcPIDStat(pid, &stats);
-    if (!s1.ok()) {
-      VLOG(1) << absl::Substitute(
-          "Failed to fetch cpu stat info for PID ($0). Error=\"$1\" skipping.", pid, s1.msg());
-      continue;
-    }
+  if (change_suppressor_ != nullptr) {
+    change_suppressor_->BeginIteration();
+  }
 
-    auto s2 = proc_parser_->ParseProcPIDStatIO(pid, &stats);
-    if (!s2.ok()) {
-      VLOG(1) << absl::Substitute(
-          "Failed to fetch IO stat info for PID ($0). Error=\"$1\" skipping.", pid, s2.msg());
-      continue;
+  // TODO(zasgar): We should double check the process start time to make sure it still the same
+  // PID.
+  proc_parser_->ParseProcPIDStats(pids_, [&](size_t idx, const ProcParser::ProcessStats& stats) {
+    const md::UPID& upid = upids_[idx];
+
+    if (change_suppressor_ != nullptr && !change_suppressor_->ShouldRecord(upid, stats)) {
+      return;
     }
 
     DataTable::RecordBuilder<&kProcessStatsTable> r(data_table, timestamp);
@@ -89,6 +102,10 @@ void ProcessStatsConnector::TransferProcessStatsTable(ConnectorContext* ctx,
     r.Append<r.ColIndex("wchar_bytes")>(stats.wchar_bytes);
     r.Append<r.ColIndex("read_bytes")>(stats.read_bytes);
     r.Append<r.ColIndex("write_bytes")>(stats.write_bytes);
+  });
+
+  if (change_suppressor_ != nullptr) {
+    change_suppressor_->EndIteration();
   }
 }
 
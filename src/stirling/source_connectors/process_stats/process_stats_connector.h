@@ -25,11 +25,16 @@
 #include <vector>
 
 #include "src/common/base/base.h"
+#include "src/common/system/proc_parser.h"
 #include "src/common/system/system.h"
 #include "src/shared/metadata/metadata.h"
 #include "src/stirling/core/canonical_types.h"
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/source_connectors/process_stats/process_stats_table.h"
+#include "src/stirling/utils/change_suppressor.h"
+
+DECLARE_bool(stirling_process_stats_suppress_unchanged);
+DECLARE_uint32(stirling_process_stats_keyframe_period);
 
 namespace px {
 namespace stirling {
@@ -57,14 +62,21 @@ class ProcessStatsConnector : public SourceConnector {
 
  protected:
   explicit ProcessStatsConnector(std::string_view source_name)
-      : SourceConnector(source_name, kTables) {
-    proc_parser_ = std::make_unique<system::ProcParser>(sysconfig_);
-  }
+      : SourceConnector(source_name, kTables) {}
 
  private:
   void TransferProcessStatsTable(ConnectorContext* ctx, DataTable* data_table);
 
-  std::unique_ptr<system::ProcParser> proc_parser_;
+  std::unique_ptr<system::BatchProcParser> proc_parser_;
+
+  // Only set when unchanged rows are suppressed.
+  std::unique_ptr<utils::ChangeSuppressor<md::UPID, system::ProcParser::ProcessStats>>
+      change_suppressor_;
+
+  // Scratch space for the UPIDs and PIDs sampled in an iteration. Kept as members to avoid
+  // reallocating them on every sampling period.
+  std::vector<md::UPID> upids_;
+  std::vector<int32_t> pids_;
 };
 
 }  // namespace stirling
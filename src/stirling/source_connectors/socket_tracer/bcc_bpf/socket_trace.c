@@ -70,6 +70,11 @@ BPF_HASH(conn_info_map, uint64_t, struct conn_info_t, 131072);
 // Key is {tgid, fd}; Value is TSID.
 BPF_HASH(conn_disabled_map, uint64_t, uint64_t);
 
+// Map of the data ranges that user-space has asked not to receive the bytes of, because it only
+// needs to know their size to keep parsing the connection (e.g. large HTTP bodies).
+// Key is {tgid, fd}.
+BPF_HASH(conn_data_skip_map, uint64_t, struct conn_data_skip_t);
+
 // Map from thread to its ongoing accept() syscall's input argument.
 // Tracks accept() call from entry -> exit.
 // Key is {tgid, pid}.
@@ -376,6 +381,7 @@ static __inline void submit_close_event(struct pt_regs* ctx, struct conn_info_t*
 static __inline void perf_submit_buf(struct pt_regs* ctx, const enum traffic_direction_t direction,
                                      const char* buf, size_t buf_size,
                                      struct conn_info_t* conn_info,
+                                     const struct data_skip_range_t* skip,
                                      struct socket_data_event_t* event) {
   // Record original size of packet. This may get truncated below before submit.
   event->attr.msg_size = buf_size;
@@ -412,6 +418,18 @@ static __inline void perf_submit_buf(struct pt_regs* ctx, const enum traffic_dir
     return;
   }
 
+  // Leave out the tail of the message when it ends within the skip range, so no bytes after the
+  // range are lost. User space fills in the missing bytes from msg_size.
+  uint64_t end_pos = event->attr.pos + buf_size;
+  if (end_pos > skip->start && end_pos <= skip->end) {
+    buf_size = (skip->start > event->attr.pos) ? skip->start - event->attr.pos : 0;
+    if (buf_size == 0) {
+      event->attr.msg_buf_size = 0;
+      socket_data_events.perf_submit(ctx, event, sizeof(event->attr));
+      return;
+    }
+  }
+
   // Note that buf_size_minus_1 will be positive due to the if-statement above.
   size_t buf_size_minus_1 = buf_size - 1;
 
@@ -447,6 +465,7 @@ static __inline void perf_submit_buf(struct pt_regs* ctx, const enum traffic_dir
 static __inline void perf_submit_wrapper(struct pt_regs* ctx,
                                          const enum traffic_direction_t direction, const char* buf,
                                          const size_t buf_size, struct conn_info_t* conn_info,
+                                         const struct data_skip_range_t* skip,
                                          struct socket_data_event_t* event) {
   int bytes_sent = 0;
   unsigned int i;
@@ -456,7 +475,7 @@ static __inline void perf_submit_wrapper(struct pt_regs* ctx,
     const int bytes_remaining = buf_size - bytes_sent;
     const size_t current_size =
         (bytes_remaining > MAX_MSG_SIZE && (i != CHUNK_LIMIT - 1)) ? MAX_MSG_SIZE : bytes_remaining;
-    perf_submit_buf(ctx, direction, buf + bytes_sent, current_size, conn_info, event);
+    perf_submit_buf(ctx, direction, buf + bytes_sent, current_size, conn_info, skip, event);
     bytes_sent += current_size;
 
     // Move the position for the next event.
@@ -468,6 +487,7 @@ static __inline void perf_submit_iovecs(struct pt_regs* ctx,
                                         const enum traffic_direction_t direction,
                                         const struct iovec* iov, const size_t iovlen,
                                         const size_t total_size, struct conn_info_t* conn_info,
+                                        const struct data_skip_range_t* skip,
                                         struct socket_data_event_t* event) {
   // NOTE: The syscalls for scatter buffers, {send,recv}msg()/{write,read}v(), access buffers in
   // array order. That means they read or fill iov[0], then iov[1], and so on. They return the total
@@ -484,7 +504,7 @@ static __inline void perf_submit_iovecs(struct pt_regs* ctx,
 
     // TODO(oazizi/yzhao): Should switch this to go through perf_submit_wrapper.
     //                     We don't have the BPF instruction count to do so right now.
-    perf_submit_buf(ctx, direction, iov_cpy.iov_base, iov_size, conn_info, event);
+    perf_submit_buf(ctx, direction, iov_cpy.iov_base, iov_size, conn_info, skip, event);
     bytes_sent += iov_size;
 
     // Move the position for the next event.
@@ -527,6 +547,11 @@ int conn_cleanup_uprobe(struct pt_regs* ctx) {
     if (tsid != NULL && *tsid == conn_id.tsid) {
       conn_disabled_map.delete(&tgid_fd);
     }
+
+    struct conn_data_skip_t* data_skip = conn_data_skip_map.lookup(&tgid_fd);
+    if (data_skip != NULL && data_skip->tsid == conn_id.tsid) {
+      conn_data_skip_map.delete(&tgid_fd);
+    }
   }
 
   return 0;
@@ -640,6 +665,57 @@ static __inline void process_implicit_conn(struct pt_regs* ctx, uint64_t id,
   submit_new_conn(ctx, tgid, args->fd, args->addr, /*socket*/ NULL, kRoleUnknown, source_fn);
 }
 
+static __inline bool is_conn_sampled(const struct conn_id_t* conn_id) {
+  int idx = kConnSampleRateIndex;
+  int64_t* sample_rate = control_values.lookup(&idx);
+  if (sample_rate == NULL || *sample_rate <= 1) {
+    return true;
+  }
+
+  // A multiplicative hash of the connection ID, so every event of a connection gets the same
+  // decision without keeping any state.
+  uint64_t hash = ((uint64_t)conn_id->upid.tgid << 32) ^ (uint32_t)conn_id->fd ^ conn_id->tsid;
+  hash *= 0x9E3779B97F4A7C15ULL;
+  return (hash >> 32) % (uint64_t)*sample_rate == 0;
+}
+
+// Returns whether the connection has enough tokens left to trace bytes_count bytes of data,
+// and takes them if so.
+static __inline bool take_conn_rate_limit_tokens(struct conn_info_t* conn_info,
+                                                 size_t bytes_count) {
+  int idx = kConnRateLimitBytesIndex;
+  int64_t* rate_bytes = control_values.lookup(&idx);
+  if (rate_bytes == NULL || *rate_bytes <= 0) {
+    return true;
+  }
+  uint64_t rate = *rate_bytes;
+
+  idx = kConnRateLimitBurstBytesIndex;
+  int64_t* burst_bytes = control_values.lookup(&idx);
+  uint64_t burst = (burst_bytes != NULL && *burst_bytes > 0) ? *burst_bytes : rate;
+
+  // Refill the bucket for the time since the last refill. A full second refills any bucket, so
+  // capping the elapsed time there keeps the multiplication from overflowing.
+  const uint64_t kNanosPerSecond = 1000000000ULL;
+  uint64_t now = bpf_ktime_get_ns();
+  uint64_t elapsed_ns = now - conn_info->rate_limit_refill_ns;
+  if (elapsed_ns > kNanosPerSecond) {
+    elapsed_ns = kNanosPerSecond;
+  }
+  uint64_t tokens = conn_info->rate_limit_tokens + elapsed_ns * rate / kNanosPerSecond;
+  if (tokens > burst) {
+    tokens = burst;
+  }
+  conn_info->rate_limit_refill_ns = now;
+
+  if (tokens < bytes_count) {
+    conn_info->rate_limit_tokens = tokens;
+    return false;
+  }
+  conn_info->rate_limit_tokens = tokens - bytes_count;
+  return true;
+}
+
 static __inline bool should_send_data(uint32_t tgid, uint64_t conn_disabled_tsid,
                                       bool force_trace_tgid, struct conn_info_t* conn_info) {
   // Never trace stirling.
@@ -652,6 +728,12 @@ static __inline bool should_send_data(uint32_t tgid, uint64_t conn_disabled_tsid
     return false;
   }
 
+  // Only trace the sampled connections. The records carry the sample rate, so counts can be
+  // scaled back up.
+  if (!is_conn_sampled(&conn_info->conn_id)) {
+    return false;
+  }
+
   // Only trace data for protocols of interest, or if forced on.
   return (force_trace_tgid || should_trace_protocol_data(conn_info));
 }
@@ -739,7 +821,10 @@ static __inline void process_data(const bool vecs, struct pt_regs* ctx, uint64_t
       update_traffic_class(conn_info, direction, iov_cpy.iov_base, buf_size);
     }
 
-    if (should_send_data(tgid, conn_disabled_tsid, force_trace_tgid, conn_info)) {
+    // Data over the rate limit of the connection is dropped. User-space sees it as a gap in the
+    // stream, like any lost data.
+    if (should_send_data(tgid, conn_disabled_tsid, force_trace_tgid, conn_info) &&
+        take_conn_rate_limit_tokens(conn_info, bytes_count)) {
       struct socket_data_event_t* event =
           fill_socket_data_event(args->source_fn, direction, conn_info);
       if (event == NULL) {
@@ -747,14 +832,22 @@ static __inline void process_data(const bool vecs, struct pt_regs* ctx, uint64_t
         return;
       }
 
+      // An empty range never matches, since the events have a size.
+      struct data_skip_range_t skip = {};
+      struct conn_data_skip_t* data_skip = conn_data_skip_map.lookup(&tgid_fd);
+      if (data_skip != NULL && data_skip->tsid == conn_info->conn_id.tsid) {
+        skip = (direction == kEgress) ? data_skip->send : data_skip->recv;
+      }
+
       // TODO(yzhao): Same TODO for split the interface.
       if (!vecs) {
-        perf_submit_wrapper(ctx, direction, args->buf, bytes_count, conn_info, event);
+        perf_submit_wrapper(ctx, direction, args->buf, bytes_count, conn_info, &skip, event);
       } else {
         // TODO(yzhao): iov[0] is copied twice, once in calling update_traffic_class(), and here.
         // This happens to the write probes as well, but the calls are placed in the entry and
         // return probes respectively. Consider remove one copy.
-        perf_submit_iovecs(ctx, direction, args->iov, args->iovlen, bytes_count, conn_info, event);
+        perf_submit_iovecs(ctx, direction, args->iov, args->iovlen, bytes_count, conn_info, &skip,
+                           event);
       }
     }
   }
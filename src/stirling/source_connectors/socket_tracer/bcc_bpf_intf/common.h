@@ -89,5 +89,12 @@ enum control_value_index_t {
   // * Support efficient lookup inside bpf to minimize overhead.
   kTargetTGIDIndex = 0,
   kStirlingTGIDIndex,
+  // Only the data of 1 in N connections is traced, chosen by a hash of the connection ID.
+  // Values <= 1 trace all connections.
+  kConnSampleRateIndex,
+  // Token bucket limit on the data traced per connection, in bytes/sec and burst bytes.
+  // A rate <= 0 means no limit.
+  kConnRateLimitBytesIndex,
+  kConnRateLimitBurstBytesIndex,
   kNumControlValues,
 };
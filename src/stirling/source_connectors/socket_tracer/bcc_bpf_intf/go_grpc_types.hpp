@@ -63,7 +63,10 @@ inline std::string ToString(const struct go_grpc_event_attr_t& attr) {
 
 struct HTTP2DataEvent {
   HTTP2DataEvent() : attr{}, payload{} {}
-  explicit HTTP2DataEvent(const void* data) {
+  explicit HTTP2DataEvent(const void* data) { Assign(data); }
+
+  // Sets the event from the perf buffer data, reusing the memory of payload.
+  void Assign(const void* data) {
     auto data_ptr = static_cast<const char*>(data);
 
     memcpy(&attr, data_ptr + offsetof(go_grpc_data_event_t, attr), sizeof(go_grpc_event_attr_t));
@@ -86,7 +89,10 @@ struct HTTP2DataEvent {
 
 struct HTTP2HeaderEvent {
   HTTP2HeaderEvent() : attr{} {}
-  explicit HTTP2HeaderEvent(const void* data) {
+  explicit HTTP2HeaderEvent(const void* data) { Assign(data); }
+
+  // Sets the event from the perf buffer data, reusing the memory of name and value.
+  void Assign(const void* data) {
     auto data_ptr = static_cast<const char*>(data);
 
     // Pointers into relevant sub-fields within the go_grpc_http2_header_event_t struct.
@@ -85,6 +85,11 @@ struct conn_info_t {
   size_t prev_count;
   char prev_buf[4];
   bool prepend_length_header;
+
+  // Token bucket state for the per-connection rate limit on traced data.
+  // The number of bytes that can be traced, as of the last refill time.
+  uint64_t rate_limit_tokens;
+  uint64_t rate_limit_refill_ns;
 };
 
 // This struct is a subset of conn_info_t. It is used to communicate connect/accept events.
@@ -209,6 +214,22 @@ struct socket_data_event_t {
   char msg[MAX_MSG_SIZE];
 };
 
+// A range [start, end) of positions in a data stream whose bytes user space does not need, such as
+// the part of a large HTTP body past what gets recorded.
+struct data_skip_range_t {
+  uint64_t start;
+  uint64_t end;
+};
+
+// The ranges of the data of a connection that BPF only sends the size of, set by user space once
+// it knows the framing of the messages in flight.
+struct conn_data_skip_t {
+  // The TSID of the connection the ranges belong to.
+  uint64_t tsid;
+  struct data_skip_range_t send;
+  struct data_skip_range_t recv;
+};
+
 #define CONN_OPEN (1 << 0)
 #define CONN_CLOSE (1 << 1)
 
@@ -71,7 +71,11 @@ namespace stirling {
  */
 struct SocketDataEvent {
   SocketDataEvent() : attr{}, msg{} {}
-  explicit SocketDataEvent(const void* data) {
+  explicit SocketDataEvent(const void* data) { Assign(data); }
+
+  // Sets the event from the perf buffer data. Reuses the memory of msg, so that recycled events
+  // don't reallocate it.
+  void Assign(const void* data) {
     // Work around the memory alignment issue by using memcopy, instead of structure assignment.
     //
     // A known fact is that perf buffer's memory region is 8 bytes aligned. But each submission
@@ -86,6 +90,7 @@ struct SocketDataEvent {
     // The length header of the first Kafka packet on the server side will be dropped in bpf
     // due to protocol inference. We send the length header in attributes instead, and adjust pos
     // forward by 4 bytes.
+    msg.clear();
     if (attr.prepend_length_header) {
       char buf[4];
       px::utils::IntToLEndianBytes(attr.length_header, buf);
@@ -62,6 +62,14 @@ constexpr DataElement kLatencyNS = {
     types::PatternType::METRIC_GAUGE,
 };
 
+constexpr DataElement kConnSampleRate = {
+    "conn_sample_rate",
+    "The record comes from 1 in this many connections, which were sampled. Scale counts by it.",
+    types::DataType::INT64,
+    types::SemanticType::ST_NONE,
+    types::PatternType::GENERAL,
+};
+
 constexpr DataElement kPXInfo = {
     "px_info_",
     "Pixie messages regarding the record (e.g. warnings)",
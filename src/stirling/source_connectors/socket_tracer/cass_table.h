@@ -58,6 +58,7 @@ static constexpr DataElement kCQLElements[] = {
          types::SemanticType::ST_NONE,
          types::PatternType::GENERAL},
         canonical_data_elements::kLatencyNS,
+        canonical_data_elements::kConnSampleRate,
 #ifndef NDEBUG
         canonical_data_elements::kPXInfo,
 #endif
@@ -39,6 +39,7 @@
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/go_grpc_types.hpp"
 #include "src/stirling/source_connectors/socket_tracer/conn_stats.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_trackers_manager.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/parse.h"
 #include "src/stirling/utils/enum_map.h"
 
 DEFINE_bool(treat_loopback_as_in_cluster, true,
@@ -51,6 +52,9 @@ DEFINE_int64(stirling_conn_trace_fd, kUnsetPIDFD, "Trace activity on this fd.");
 DEFINE_bool(
     stirling_conn_disable_to_bpf, true,
     "Send information about connection tracking disablement to BPF, so it can stop sending data.");
+DEFINE_bool(stirling_conn_skip_data_to_bpf, true,
+            "Send the ranges of large HTTP bodies past what gets recorded to BPF, so it only sends "
+            "their size.");
 DEFINE_int64(
     stirling_check_proc_for_conn_close, true,
     "If enabled, Stirling will check Linux /proc on idle connections to see if they are closed.");
@@ -139,24 +143,24 @@ void ConnTracker::AddConnCloseEvent(const close_event_t& close_event, uint64_t t
   MarkForDeath();
 }
 
-void ConnTracker::AddDataEvent(std::unique_ptr<SocketDataEvent> event) {
-  SetRole(event->attr.role, "inferred from data_event");
-  SetProtocol(event->attr.protocol, "inferred from data_event");
-  SetSSL(event->attr.ssl, "inferred from data_event");
+void ConnTracker::AddDataEvent(const SocketDataEvent& event) {
+  SetRole(event.attr.role, "inferred from data_event");
+  SetProtocol(event.attr.protocol, "inferred from data_event");
+  SetSSL(event.attr.ssl, "inferred from data_event");
 
   CheckTracker();
-  UpdateTimestamps(event->attr.timestamp_ns);
-  UpdateDataStats(*event);
+  UpdateTimestamps(event.attr.timestamp_ns);
+  UpdateDataStats(event);
 
-  CONN_TRACE(1) << absl::Substitute("Data event received: $0", event->ToString());
+  CONN_TRACE(1) << absl::Substitute("Data event received: $0", event.ToString());
 
   // TODO(yzhao): Change to let userspace resolve the connection type and signal back to BPF.
   // Then we need at least one data event to let ConnTracker know the field descriptor.
-  if (event->attr.protocol == kProtocolUnknown) {
+  if (event.attr.protocol == kProtocolUnknown) {
     return;
   }
 
-  if (event->attr.protocol != protocol_) {
+  if (event.attr.protocol != protocol_) {
     return;
   }
 
@@ -165,12 +169,12 @@ void ConnTracker::AddDataEvent(std::unique_ptr<SocketDataEvent> event) {
     return;
   }
 
-  switch (event->attr.direction) {
+  switch (event.attr.direction) {
     case traffic_direction_t::kEgress: {
-      send_data_.AddData(std::move(event));
+      send_data_.AddData(event);
     } break;
     case traffic_direction_t::kIngress: {
-      recv_data_.AddData(std::move(event));
+      recv_data_.AddData(event);
     } break;
   }
 }
@@ -211,21 +215,21 @@ protocols::http2::HalfStream* ConnTracker::HalfStreamPtr(uint32_t stream_id, boo
   return streams.HalfStreamPtr(stream_id, write_event);
 }
 
-endpoint_role_t InferHTTP2Role(bool write_event, const std::unique_ptr<HTTP2HeaderEvent>& hdr) {
+endpoint_role_t InferHTTP2Role(bool write_event, const HTTP2HeaderEvent& hdr) {
   // Look for standard headers to infer role.
   // Could look at others (:scheme, :path, :authority), but this seems sufficient.
 
-  if (hdr->name == ":method") {
+  if (hdr.name == ":method") {
     return (write_event) ? kRoleClient : kRoleServer;
   }
-  if (hdr->name == ":status") {
+  if (hdr.name == ":status") {
     return (write_event) ? kRoleServer : kRoleClient;
   }
 
   return kRoleUnknown;
 }
 
-void ConnTracker::AddHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> hdr) {
+void ConnTracker::AddHTTP2Header(HTTP2HeaderEvent* hdr) {
   SetProtocol(kProtocolHTTP2, "inferred from http2 headers");
 
   if (protocol_ != kProtocolHTTP2) {
@@ -269,7 +273,7 @@ void ConnTracker::AddHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> hdr) {
   }
 
   if (role_ == kRoleUnknown) {
-    endpoint_role_t role = InferHTTP2Role(write_event, hdr);
+    endpoint_role_t role = InferHTTP2Role(write_event, *hdr);
     SetRole(role, "Inferred from http2 header");
   }
 
@@ -302,14 +306,14 @@ void ConnTracker::AddHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> hdr) {
   half_stream_ptr->UpdateTimestamp(hdr->attr.timestamp_ns);
 }
 
-void ConnTracker::AddHTTP2Data(std::unique_ptr<HTTP2DataEvent> data) {
+void ConnTracker::AddHTTP2Data(const HTTP2DataEvent& data) {
   SetProtocol(kProtocolHTTP2, "inferred from http2 data");
 
   if (protocol_ != kProtocolHTTP2) {
     return;
   }
 
-  CONN_TRACE(1) << absl::Substitute("HTTP2 data event received: $0", data->ToString());
+  CONN_TRACE(1) << absl::Substitute("HTTP2 data event received: $0", data.ToString());
 
   if (conn_id_.fd == 0) {
     Disable(
@@ -326,14 +330,14 @@ void ConnTracker::AddHTTP2Data(std::unique_ptr<HTTP2DataEvent> data) {
   CheckTracker();
 
   // Don't trace any control messages.
-  if (data->attr.stream_id == 0) {
+  if (data.attr.stream_id == 0) {
     return;
   }
 
-  UpdateTimestamps(data->attr.timestamp_ns);
+  UpdateTimestamps(data.attr.timestamp_ns);
 
   bool write_event = false;
-  switch (data->attr.event_type) {
+  switch (data.attr.event_type) {
     case grpc_event_type_t::kDataFrameEventWrite:
       write_event = true;
       break;
@@ -345,23 +349,23 @@ void ConnTracker::AddHTTP2Data(std::unique_ptr<HTTP2DataEvent> data) {
       return;
   }
 
-  protocols::http2::HalfStream* half_stream_ptr = HalfStreamPtr(data->attr.stream_id, write_event);
+  protocols::http2::HalfStream* half_stream_ptr = HalfStreamPtr(data.attr.stream_id, write_event);
 
   // Note: Duplicate calls to the writeHeaders have been observed (though they are rare).
   // It is not yet known if duplicate data also occurs. This log will help us figure out if such
   // cases exist. Note that the duplicates are not related to the end_stream flag being set;
   // the end_stream cases are just the easiest to detect.
-  if (half_stream_ptr->end_stream() && data->attr.end_stream) {
+  if (half_stream_ptr->end_stream() && data.attr.end_stream) {
     CONN_TRACE(1) << absl::Substitute(
-        "Duplicate end_stream flag in data. stream_id: $0, conn_id: $1", data->attr.stream_id,
-        ::ToString(data->attr.conn_id));
+        "Duplicate end_stream flag in data. stream_id: $0, conn_id: $1", data.attr.stream_id,
+        ::ToString(data.attr.conn_id));
   }
 
-  half_stream_ptr->AddData(data->payload);
-  if (data->attr.end_stream) {
+  half_stream_ptr->AddData(data.payload);
+  if (data.attr.end_stream) {
     half_stream_ptr->AddEndStream();
   }
-  half_stream_ptr->UpdateTimestamp(data->attr.timestamp_ns);
+  half_stream_ptr->UpdateTimestamp(data.attr.timestamp_ns);
 }
 
 template <>
@@ -382,6 +386,61 @@ ConnTracker::ProcessToRecords<protocols::http2::ProtocolTraits>() {
   return std::move(result.records);
 }
 
+namespace {
+// Ranges shorter than this aren't worth a BPF map update.
+constexpr size_t kMinDataSkipBytes = 4096;
+}  // namespace
+
+void ConnTracker::UpdateDataSkipRanges() {
+  if (conn_info_map_mgr_ == nullptr || !FLAGS_stirling_conn_skip_data_to_bpf ||
+      role_ == kRoleUnknown) {
+    return;
+  }
+
+  message_type_t send_type =
+      (role_ == kRoleClient) ? message_type_t::kRequest : message_type_t::kResponse;
+  message_type_t recv_type =
+      (role_ == kRoleClient) ? message_type_t::kResponse : message_type_t::kRequest;
+
+  bool updated = UpdateDataSkipRange(&send_data_, send_type, &send_skip_);
+  updated |= UpdateDataSkipRange(&recv_data_, recv_type, &recv_skip_);
+  if (updated) {
+    conn_info_map_mgr_->SkipData(conn_id_, send_skip_, recv_skip_);
+  }
+}
+
+bool ConnTracker::UpdateDataSkipRange(DataStream* data_stream, message_type_t type,
+                                      struct data_skip_range_t* skip) {
+  protocols::DataStreamBuffer& data_buffer = data_stream->data_buffer();
+
+  // What is left after parsing is the start of the next message. Only a message that already has
+  // more bytes than gets recorded of its body can have a range worth skipping.
+  std::string_view head = data_buffer.Head();
+  if (head.size() <= protocols::kMaxBodyBytes) {
+    return false;
+  }
+
+  auto body = protocols::http::FindContentLengthBody(type, head);
+  if (!body.has_value()) {
+    return false;
+  }
+
+  const auto& [body_offset, body_size] = body.value();
+  if (body_size < protocols::kMaxBodyBytes + kMinDataSkipBytes) {
+    return false;
+  }
+
+  const uint64_t body_pos = data_buffer.position() + body_offset;
+  struct data_skip_range_t range = {body_pos + protocols::kMaxBodyBytes, body_pos + body_size};
+  if (range.start == skip->start && range.end == skip->end) {
+    return false;
+  }
+
+  CONN_TRACE(2) << absl::Substitute("Skipping data range [$0, $1)", range.start, range.end);
+  *skip = range;
+  return true;
+}
+
 void ConnTracker::Reset() {
   send_data_.Reset();
   recv_data_.Reset();
@@ -47,6 +47,7 @@ DECLARE_bool(treat_loopback_as_in_cluster);
 DECLARE_int64(stirling_conn_trace_pid);
 DECLARE_int64(stirling_conn_trace_fd);
 DECLARE_bool(stirling_conn_disable_to_bpf);
+DECLARE_bool(stirling_conn_skip_data_to_bpf);
 DECLARE_int64(stirling_check_proc_for_conn_close);
 
 #define CONN_TRACE(level) LOG_IF(INFO, level <= debug_trace_level_) << ToString() << " "
@@ -206,9 +207,10 @@ class ConnTracker : NotCopyMoveable {
   /**
    * Registers a BPF data event into the tracker.
    *
-   * @param event The data event from BPF.
+   * @param event The data event from BPF. Its msg is copied, so the event can be reused.
    */
-  void AddDataEvent(std::unique_ptr<SocketDataEvent> event);
+  void AddDataEvent(std::unique_ptr<SocketDataEvent> event) { AddDataEvent(*event); }
+  void AddDataEvent(const SocketDataEvent& event);
 
   /**
    * Registers a BPF connection stats event into the tracker.
@@ -222,9 +224,10 @@ class ConnTracker : NotCopyMoveable {
    * The struct should contain stream ID and other meta-data so it can matched with other HTTP2
    * header events and data frames.
    *
-   * @param data The event from BPF uprobe.
+   * @param data The event from BPF uprobe. Its name and value are moved out.
    */
-  void AddHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> data);
+  void AddHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> data) { AddHTTP2Header(data.get()); }
+  void AddHTTP2Header(HTTP2HeaderEvent* data);
 
   /**
    * Add a recorded HTTP2 data frame.
@@ -233,7 +236,8 @@ class ConnTracker : NotCopyMoveable {
    *
    * @param data The event from BPF uprobe.
    */
-  void AddHTTP2Data(std::unique_ptr<HTTP2DataEvent> data);
+  void AddHTTP2Data(std::unique_ptr<HTTP2DataEvent> data) { AddHTTP2Data(*data); }
+  void AddHTTP2Data(const HTTP2DataEvent& data);
 
   /**
    * Attempts to infer the remote endpoint of a connection.
@@ -262,6 +266,10 @@ class ConnTracker : NotCopyMoveable {
 
     DataStreamsToFrames<TFrameType, TStateType>();
 
+    if constexpr (std::is_same_v<TFrameType, protocols::http::Message>) {
+      UpdateDataSkipRanges();
+    }
+
     auto& req_frames = req_data()->Frames<TFrameType>();
     auto& resp_frames = resp_data()->Frames<TFrameType>();
     auto state_ptr = protocol_state<TStateType>();
@@ -663,6 +671,13 @@ class ConnTracker : NotCopyMoveable {
                                                                          state_ptr);
   }
 
+  // Tells BPF which bytes of the messages in flight are not needed, namely the part of large HTTP
+  // bodies past what gets recorded. BPF then only sends their size, which keeps the streams
+  // position-correct for the parsers.
+  void UpdateDataSkipRanges();
+  bool UpdateDataSkipRange(DataStream* data_stream, message_type_t type,
+                           struct data_skip_range_t* skip);
+
   template <typename TRecordType>
   void UpdateResultStats(const protocols::RecordsWithErrorCount<TRecordType>& result) {
     stats_.Increment(StatKey::kInvalidRecords, result.error_count);
@@ -690,6 +705,10 @@ class ConnTracker : NotCopyMoveable {
   DataStream send_data_;
   DataStream recv_data_;
 
+  // The ranges of the streams that BPF was last told to skip.
+  struct data_skip_range_t send_skip_ = {};
+  struct data_skip_range_t recv_skip_ = {};
+
   // Uprobe-based HTTP2 uses a different scheme, where it holds client and server-initiated streams,
   // instead of send and recv messages. As such, we create aliases for HTTP2.
   HTTP2StreamsContainer http2_client_streams_;
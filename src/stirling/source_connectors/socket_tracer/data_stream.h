@@ -58,7 +58,8 @@ class DataStream : NotCopyMoveable {
   /**
    * Adds a raw (unparsed) chunk of data into the stream.
    */
-  void AddData(std::unique_ptr<SocketDataEvent> event);
+  void AddData(std::unique_ptr<SocketDataEvent> event) { AddData(*event); }
+  void AddData(const SocketDataEvent& event);
 
   /**
    * Parses as many messages as it can from the raw events into the messages container.
@@ -169,6 +169,32 @@ TEST_F(DataStreamTest, PartialMessageRecovery) {
   EXPECT_EQ(requests[1].req_path, "/bar.html");
 }
 
+// Checks that DataStream passes the stream position to the parser, so that a message whose body
+// has not fully arrived is resumed rather than reparsed once the rest of it arrives.
+TEST_F(DataStreamTest, ResumesPartialMessage) {
+  constexpr size_t kSplit = kHTTPResp0.length() - 3;
+  std::unique_ptr<SocketDataEvent> resp0a =
+      event_gen_.InitRecvEvent<kProtocolHTTP>(kHTTPResp0.substr(0, kSplit));
+  std::unique_ptr<SocketDataEvent> resp0b =
+      event_gen_.InitRecvEvent<kProtocolHTTP>(kHTTPResp0.substr(kSplit));
+  protocols::http::StateWrapper state{};
+
+  DataStream stream;
+  stream.AddData(std::move(resp0a));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kResponse, &state);
+  EXPECT_THAT(stream.Frames<http::Message>(), IsEmpty());
+  ASSERT_TRUE(state.global.resp_stream.pos.has_value());
+  ASSERT_TRUE(state.global.resp_stream.partial_msg.has_value());
+  EXPECT_EQ(state.global.resp_stream.partial_msg->pos, 0U);
+
+  stream.AddData(std::move(resp0b));
+  stream.ProcessBytesToFrames<http::Message>(message_type_t::kResponse, &state);
+  const auto& responses = stream.Frames<http::Message>();
+  ASSERT_THAT(responses, SizeIs(1));
+  EXPECT_EQ(responses[0].body, "pixie");
+  EXPECT_FALSE(state.global.resp_stream.partial_msg.has_value());
+}
+
 TEST_F(DataStreamTest, HeadAndMiddleMissing) {
   std::unique_ptr<SocketDataEvent> req0b = event_gen_.InitSendEvent<kProtocolHTTP>(
       kHTTPReq0.substr(kHTTPReq0.length() / 2, kHTTPReq0.length()));
@@ -20,6 +20,7 @@
 
 #include <deque>
 #include <map>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -122,7 +123,8 @@ ParseResult ParseFrames(message_type_t type, DataStreamBuffer* data_stream_buffe
   const size_t prev_size = frames->size();
 
   // Parse and append new frames to the frames vector.
-  ParseResult result = ParseFramesLoop(type, buf, frames, state);
+  ParseResult result =
+      ParseFramesLoop(type, buf, frames, state, data_stream_buffer->position() + start_pos);
 
   VLOG(1) << absl::Substitute("Parsed $0 new frames", frames->size() - prev_size);
 
@@ -152,13 +154,16 @@ ParseResult ParseFrames(message_type_t type, DataStreamBuffer* data_stream_buffe
  * @param type The Type of frames to parse.
  * @param buf The raw bytes to parse
  * @param frames The output where the parsed frames will be placed.
+ * @param stream_pos The position of buf in the stream, if it is part of one. Lets the protocol
+ * resume parsing a partial frame that it had started parsing in an earlier call.
  *
  * @return ParseResult with locations where parseable frames were found in the source buffer.
  */
 // TODO(oazizi): Convert tests to use ParseFrames() instead of ParseFramesLoop().
 template <typename TFrameType, typename TStateType = NoState>
 ParseResult ParseFramesLoop(message_type_t type, std::string_view buf,
-                            std::deque<TFrameType>* frames, TStateType* state = nullptr) {
+                            std::deque<TFrameType>* frames, TStateType* state = nullptr,
+                            std::optional<size_t> stream_pos = std::nullopt) {
   std::vector<StartEndPos> frame_positions;
   const size_t buf_size = buf.size();
   ParseState s = ParseState::kSuccess;
@@ -168,6 +173,12 @@ ParseResult ParseFramesLoop(message_type_t type, std::string_view buf,
   while (!buf.empty() && s != ParseState::kEOS) {
     TFrameType frame;
 
+    std::optional<size_t> frame_pos;
+    if (stream_pos.has_value()) {
+      frame_pos = stream_pos.value() + (buf_size - buf.size());
+    }
+    SetStreamPosition(type, frame_pos, state);
+
     s = ParseFrame(type, &buf, &frame, state);
 
     bool stop = false;
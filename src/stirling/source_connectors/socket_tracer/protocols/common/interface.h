@@ -19,6 +19,7 @@
 #pragma once
 
 #include <deque>
+#include <optional>
 #include <variant>
 #include <vector>
 
@@ -106,6 +107,24 @@ template <typename TFrameType, typename TStateType = NoState>
 ParseState ParseFrame(message_type_t type, std::string_view* buf, TFrameType* frame,
                       TStateType* state = nullptr);
 
+/**
+ * Tells the protocol state where, in the stream of the given type, the buffer passed to the next
+ * ParseFrame() call starts; or std::nullopt if the buffer is not part of a stream, e.g. in tests.
+ *
+ * Protocols that remember how far they got into a frame that has not fully arrived use this to
+ * check that the next buffer still starts at that frame. They can then resume parsing where they
+ * left off, instead of reparsing the frame from its first byte every time more of it arrives.
+ *
+ * Like ParseFrame(), this must be specialized for every state type, so that the stream code never
+ * silently instantiates a default. Protocols that don't resume implement it as a no-op.
+ */
+template <typename TStateType>
+void SetStreamPosition(message_type_t type, std::optional<size_t> pos, TStateType* state);
+
+template <>
+inline void SetStreamPosition(message_type_t /*type*/, std::optional<size_t> /*pos*/,
+                              NoState* /*state*/) {}
+
 /**
  * StitchFrames is the entry point of stitcher for all protocols. It loops through the responses,
  * matches them with the corresponding requests, and returns stitched request & response pairs.
@@ -23,6 +23,8 @@
 #include <utility>
 #include <vector>
 
+#include "src/common/base/string_search.h"
+
 DEFINE_bool(use_pico_chunked_decoder, false,
             "If true, uses picohttpparser's chunked decoder; otherwise uses our custom decoder.");
 
@@ -61,7 +63,7 @@ ParseState ExtractChunkLength(std::string_view* data, size_t* out) {
   // (e.g. Apache sets an 8K limit for headers).
   constexpr int kSearchWindow = 2048;
 
-  size_t delimiter_pos = data->substr(0, kSearchWindow).find("\r\n");
+  size_t delimiter_pos = FindPattern(data->substr(0, kSearchWindow), "\r\n");
   if (delimiter_pos == data->npos) {
     return data->length() > kSearchWindow ? ParseState::kInvalid : ParseState::kNeedsMoreData;
   }
@@ -119,15 +121,29 @@ ParseState ExtractChunkData(std::string_view* data, size_t chunk_len, std::strin
 }
 }  // namespace
 
+// Appends the chunks to the decoded data with a single allocation.
+void AppendChunks(const std::vector<std::string_view>& chunks, std::string* decoded) {
+  size_t size = decoded->size();
+  for (std::string_view chunk : chunks) {
+    size += chunk.size();
+  }
+  decoded->reserve(size);
+  for (std::string_view chunk : chunks) {
+    decoded->append(chunk);
+  }
+}
+
 // This is an alternative to the picohttpparser implementation,
 // because that one is destructive on incomplete data.
 // We may attempt parsing in the middle of a stream and cannot
 // have both the result fail and the input buffer be modified.
 // Reference: https://www.w3.org/Protocols/rfc2616/rfc2616-sec3.html#sec3.6.1
-ParseState CustomParseChunked(std::string_view* buf, std::string* result) {
+ParseState CustomParseChunked(std::string_view* buf, std::string* result,
+                              ChunkedDecoderState* state) {
   std::vector<std::string_view> chunks;
 
-  std::string_view data = *buf;
+  // Skip the chunks that were decoded by previous calls.
+  std::string_view data = buf->substr(state->encoded_bytes);
 
   ParseState s;
 
@@ -136,7 +152,7 @@ ParseState CustomParseChunked(std::string_view* buf, std::string* result) {
     size_t chunk_len = 0;
     s = ExtractChunkLength(&data, &chunk_len);
     if (s != ParseState::kSuccess) {
-      return s;
+      break;
     }
 
     // A length of zero marks the end of data.
@@ -148,10 +164,20 @@ ParseState CustomParseChunked(std::string_view* buf, std::string* result) {
     std::string_view chunk_data;
     s = ExtractChunkData(&data, chunk_len, &chunk_data);
     if (s != ParseState::kSuccess) {
-      return s;
+      break;
     }
 
     chunks.push_back(chunk_data);
+    state->encoded_bytes = buf->size() - data.size();
+  }
+
+  if (s == ParseState::kNeedsMoreData) {
+    // Keep the complete chunks, so the next call resumes after them.
+    AppendChunks(chunks, &state->decoded);
+    return s;
+  }
+  if (s != ParseState::kSuccess) {
+    return s;
   }
 
   // Two scenarios to wrap up:
@@ -165,15 +191,21 @@ ParseState CustomParseChunked(std::string_view* buf, std::string* result) {
     // so use that as a proxy of the maximum trailer size we can expect.
     constexpr int kSearchWindow = 8192;
 
-    size_t pos = data.substr(0, kSearchWindow).find("\r\n\r\n");
+    size_t pos = FindPattern(data.substr(0, kSearchWindow), "\r\n\r\n");
     if (pos == data.npos) {
-      return data.length() > kSearchWindow ? ParseState::kInvalid : ParseState::kNeedsMoreData;
+      if (data.length() > kSearchWindow) {
+        return ParseState::kInvalid;
+      }
+      AppendChunks(chunks, &state->decoded);
+      return ParseState::kNeedsMoreData;
     }
 
     data.remove_prefix(pos + 4);
   }
 
-  *result = absl::StrJoin(chunks, "");
+  AppendChunks(chunks, &state->decoded);
+  *result = std::move(state->decoded);
+  *state = {};
 
   // Update the input buffer only if the data was parsed properly, because
   // we don't want to be destructive on failure.
@@ -224,8 +256,13 @@ ParseState PicoParseChunked(std::string_view* data, std::string* result) {
 // Parse an HTTP message body in the chunked transfer-encoding.
 // Reference: https://www.w3.org/Protocols/rfc2616/rfc2616-sec3.html#sec3.6.1
 ParseState ParseChunked(std::string_view* data, std::string* result) {
+  ChunkedDecoderState state;
+  return ParseChunked(data, result, &state);
+}
+
+ParseState ParseChunked(std::string_view* data, std::string* result, ChunkedDecoderState* state) {
   return (FLAGS_use_pico_chunked_decoder) ? PicoParseChunked(data, result)
-                                          : CustomParseChunked(data, result);
+                                          : CustomParseChunked(data, result, state);
 }
 
 }  // namespace http
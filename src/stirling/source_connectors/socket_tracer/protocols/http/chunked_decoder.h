@@ -42,6 +42,25 @@ namespace http {
  */
 ParseState ParseChunked(std::string_view* buf, std::string* result);
 
+/**
+ * How far the decoding of a chunked body that has not fully arrived got, so that it can resume
+ * after the last complete chunk once more of the body arrives.
+ */
+struct ChunkedDecoderState {
+  // The number of bytes of the body that were decoded, up to the end of the last complete chunk.
+  size_t encoded_bytes = 0;
+  // The data of the complete chunks.
+  std::string decoded;
+};
+
+/**
+ * Same as above, but resumes from the progress recorded in state, and records the progress made
+ * if the body is incomplete. The state must start default-initialized, and then be passed along
+ * with the same body each time more of it arrived. The pico decoder can't resume, so it always
+ * decodes the body from its start and ignores the state.
+ */
+ParseState ParseChunked(std::string_view* buf, std::string* result, ChunkedDecoderState* state);
+
 }  // namespace http
 }  // namespace protocols
 }  // namespace stirling
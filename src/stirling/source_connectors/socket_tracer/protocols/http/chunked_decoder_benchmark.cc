@@ -19,12 +19,17 @@
 #include <picohttpparser.h>
 
 #include <random>
+#include <string>
+
+#include <magic_enum.hpp>
 
 #include <benchmark/benchmark.h>
 
 #include "src/common/base/base.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/chunked_decoder.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/parse.h"
 
+using px::SIMDLevel;
 using px::stirling::protocols::http::ParseChunked;
 
 std::string CreateData(size_t chunks) {
@@ -56,9 +61,44 @@ std::string CreateData(size_t chunks) {
 // NOLINTNEXTLINE: runtime/string
 const std::string data = CreateData(1000);
 
+// Returns an HTTP response, preceded by the tail of a previous response's body that was
+// partially lost, as seen by FindFrameBoundary() when resyncing a stream after data loss.
+std::string CreateResyncData(size_t body_size) {
+  std::string s(body_size, 'x');
+  // Sprinkle in the bytes that the searches look for, so the candidates are not all rejected
+  // for free.
+  for (size_t i = 0; i < body_size; i += 97) {
+    s[i] = (i % 2 == 0) ? '\r' : 'H';
+  }
+  s += "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+  return s;
+}
+
+// NOLINTNEXTLINE: runtime/string
+const std::string resync_data = CreateResyncData(64 * 1024);
+
+// The benchmarks below take the SIMD level of the string search functions as an argument.
+void SetSIMDLevelArg(benchmark::State& state) {
+  auto level = magic_enum::enum_cast<SIMDLevel>(state.range(0));
+  CHECK(level.has_value());
+  if (level.value() > px::MaxSupportedSIMDLevel()) {
+    state.SkipWithError("SIMD level not supported by the CPU");
+  }
+  px::SetSIMDLevel(level.value());
+  state.SetLabel(std::string(magic_enum::enum_name(level.value())));
+}
+
+void SIMDLevelArgs(benchmark::internal::Benchmark* b) {
+  b->ArgName("simd_level");
+  for (SIMDLevel level : magic_enum::enum_values<SIMDLevel>()) {
+    b->Arg(static_cast<int>(level));
+  }
+}
+
 // NOLINTNEXTLINE(runtime/references)
 static void BM_custom_body_parser(benchmark::State& state) {
   FLAGS_use_pico_chunked_decoder = false;
+  SetSIMDLevelArg(state);
 
   for (auto _ : state) {
     std::string result;
@@ -86,5 +126,51 @@ static void BM_pico_body_parser(benchmark::State& state) {
   }
 }
 
-BENCHMARK(BM_custom_body_parser);
+// Decodes the body as it arrives in 30KiB pieces, as when a large body is sent over many
+// iterations. Each piece is decoded from the start of the body, unless resume is set, in which case
+// the decoding resumes where the previous piece left off.
+// NOLINTNEXTLINE(runtime/references)
+static void BM_incremental_body_parser(benchmark::State& state) {
+  FLAGS_use_pico_chunked_decoder = false;
+  const bool resume = state.range(0);
+  constexpr size_t kPieceSize = 30 * 1024;
+
+  for (auto _ : state) {
+    std::string result;
+    px::stirling::protocols::http::ChunkedDecoderState decoder_state;
+    px::stirling::ParseState parse_state = px::stirling::ParseState::kNeedsMoreData;
+    for (size_t size = kPieceSize; parse_state == px::stirling::ParseState::kNeedsMoreData;
+         size += kPieceSize) {
+      std::string_view data_view = std::string_view(data).substr(0, size);
+      if (!resume) {
+        decoder_state = {};
+      }
+      parse_state = ParseChunked(&data_view, &result, &decoder_state);
+    }
+    CHECK(parse_state == px::stirling::ParseState::kSuccess);
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+
+// NOLINTNEXTLINE(runtime/references)
+static void BM_find_frame_boundary(benchmark::State& state) {
+  using px::stirling::protocols::http::Message;
+  using px::stirling::protocols::http::StateWrapper;
+
+  SetSIMDLevelArg(state);
+
+  StateWrapper http_state;
+  for (auto _ : state) {
+    size_t pos = px::stirling::protocols::FindFrameBoundary<Message>(message_type_t::kResponse,
+                                                                     resync_data, 0, &http_state);
+    CHECK_NE(pos, std::string_view::npos);
+    benchmark::DoNotOptimize(pos);
+  }
+  state.SetBytesProcessed(state.iterations() * resync_data.size());
+}
+
+BENCHMARK(BM_custom_body_parser)->Apply(SIMDLevelArgs);
 BENCHMARK(BM_pico_body_parser);
+BENCHMARK(BM_incremental_body_parser)->ArgName("resume")->Arg(0)->Arg(1);
+BENCHMARK(BM_find_frame_boundary)->Apply(SIMDLevelArgs);
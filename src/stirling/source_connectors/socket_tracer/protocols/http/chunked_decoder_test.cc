@@ -112,6 +112,35 @@ TEST_P(ChunkedDecoderTest, Incomplete) {
   }
 }
 
+// Feeds the body one byte more at a time, resuming the decoding each time.
+TEST_P(ChunkedDecoderTest, Resume) {
+  const std::string_view body =
+      "9\r\n"
+      "pixielabs\r\n"
+      "C\r\n"
+      " is awesome!\r\n"
+      "0\r\n"
+      "\r\n";
+
+  ChunkedDecoderState state;
+  std::string out;
+  for (size_t i = 0; i < body.size(); ++i) {
+    std::string_view body_substr = body.substr(0, i);
+    EXPECT_EQ(ParseChunked(&body_substr, &out, &state), ParseState::kNeedsMoreData);
+    EXPECT_EQ(out, "");
+  }
+
+  if (!GetParam().use_pico_chunked_decoder) {
+    // The data chunks were decoded, but are only output once the body is complete.
+    EXPECT_EQ(state.decoded, "pixielabs is awesome!");
+  }
+
+  std::string_view body_substr = body;
+  EXPECT_EQ(ParseChunked(&body_substr, &out, &state), ParseState::kSuccess);
+  EXPECT_EQ(out, "pixielabs is awesome!");
+  EXPECT_TRUE(body_substr.empty());
+}
+
 TEST_P(ChunkedDecoderTest, InconsistentLength) {
   std::string_view body =
       "B\r\n"
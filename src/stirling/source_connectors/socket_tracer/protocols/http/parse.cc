@@ -22,8 +22,12 @@
 #include <picohttpparser.h>
 
 #include <algorithm>
+#include <iterator>
 #include <string>
 #include <utility>
+#include <vector>
+
+#include "src/common/base/string_search.h"
 
 namespace px {
 namespace stirling {
@@ -83,23 +87,56 @@ HeadersMap GetHTTPHeadersMap(const phr_header* headers, size_t num_headers) {
 
 }  // namespace pico_wrapper
 
-ParseState ParseContent(std::string_view content_len_str, std::string_view* data, Message* result) {
+ParseState ParseContent(size_t len, std::string_view* data, Message* result) {
+  if (data->size() < len) {
+    return ParseState::kNeedsMoreData;
+  }
+
+  result->body = data->substr(0, len);
+  data->remove_prefix(std::min(len, data->size()));
+  return ParseState::kSuccess;
+}
+
+ParseState ParseContent(std::string_view content_len_str, std::string_view* data, Message* result,
+                        PartialMessage* partial) {
   size_t len;
   if (!absl::SimpleAtoi(content_len_str, &len)) {
     LOG(ERROR) << absl::Substitute("Unable to parse Content-Length: $0", content_len_str);
     return ParseState::kInvalid;
   }
 
-  if (data->size() < len) {
-    return ParseState::kNeedsMoreData;
+  partial->body_framing = BodyFraming::kContentLength;
+  partial->content_length = len;
+  return ParseContent(len, data, result);
+}
+
+ParseState ParseChunkedBody(std::string_view* data, Message* result, PartialMessage* partial) {
+  partial->body_framing = BodyFraming::kChunked;
+  return ParseChunked(data, &result->body, &partial->chunked_decoder_state);
+}
+
+ParseState ParseBodyUntilClose(std::string_view* buf, Message* result, State* state,
+                               PartialMessage* partial) {
+  // TODO(yzhao): For now we just accumulate messages, let probe_close() submit a message to
+  // perf buffer, so that we can terminate such messages.
+  partial->body_framing = BodyFraming::kUntilClose;
+  if (state->conn_closed) {
+    result->body = *buf;
+    buf->remove_prefix(buf->size());
+
+    LOG_FIRST_N(WARNING, 10)
+        << "HTTP message with no Content-Length or Transfer-Encoding may produce "
+           "incomplete message bodies.";
+    return ParseState::kSuccess;
   }
 
-  result->body = data->substr(0, len);
-  data->remove_prefix(std::min(len, data->size()));
-  return ParseState::kSuccess;
+  return ParseState::kNeedsMoreData;
 }
 
-ParseState ParseRequestBody(std::string_view* buf, Message* result) {
+// The body parsing functions below record how the end of the body is found in partial, so that
+// the parsing of the body can resume if it has not fully arrived.
+
+ParseState ParseRequestBody(std::string_view* buf, Message* result, PartialMessage* partial) {
   // From https://tools.ietf.org/html/rfc7230:
   //  A sender MUST NOT send a Content-Length header field in any message
   //  that contains a Transfer-Encoding header field.
@@ -117,14 +154,14 @@ ParseState ParseRequestBody(std::string_view* buf, Message* result) {
   const auto content_length_iter = result->headers.find(kContentLength);
   if (content_length_iter != result->headers.end()) {
     std::string_view content_len_str = content_length_iter->second;
-    return ParseContent(content_len_str, buf, result);
+    return ParseContent(content_len_str, buf, result, partial);
   }
 
   // Case 2: Chunked transfer.
   const auto transfer_encoding_iter = result->headers.find(kTransferEncoding);
   if (transfer_encoding_iter != result->headers.end() &&
       transfer_encoding_iter->second == "chunked") {
-    return ParseChunked(buf, &result->body);
+    return ParseChunkedBody(buf, result, partial);
   }
 
   // Case 3: Message has no Content-Length or Transfer-Encoding.
@@ -138,7 +175,8 @@ ParseState ParseRequestBody(std::string_view* buf, Message* result) {
   return ParseState::kSuccess;
 }
 
-ParseState ParseResponseBody(std::string_view* buf, Message* result, State* state) {
+ParseState ParseResponseBody(std::string_view* buf, Message* result, State* state,
+                             PartialMessage* partial) {
   // Case 0: Check for a HEAD response with no body.
   // Responses to HEAD requests are special, because they may include Content-Length
   // or Transfer-Encoding, but the body will still be empty.
@@ -162,14 +200,14 @@ ParseState ParseResponseBody(std::string_view* buf, Message* result, State* stat
   const auto content_length_iter = result->headers.find(kContentLength);
   if (content_length_iter != result->headers.end()) {
     std::string_view content_len_str = content_length_iter->second;
-    return ParseContent(content_len_str, buf, result);
+    return ParseContent(content_len_str, buf, result, partial);
   }
 
   // Case 2: Chunked transfer.
   const auto transfer_encoding_iter = result->headers.find(kTransferEncoding);
   if (transfer_encoding_iter != result->headers.end() &&
       transfer_encoding_iter->second == "chunked") {
-    return ParseChunked(buf, &result->body);
+    return ParseChunkedBody(buf, result, partial);
   }
 
   // Case 3: Responses where we can assume no body.
@@ -198,22 +236,10 @@ ParseState ParseResponseBody(std::string_view* buf, Message* result, State* stat
   // According to HTTP/1.1 standard:
   // https://www.w3.org/Protocols/HTTP/1.0/draft-ietf-http-spec.html#BodyLength
   // such messages are terminated by the close of the connection.
-  // TODO(yzhao): For now we just accumulate messages, let probe_close() submit a message to
-  // perf buffer, so that we can terminate such messages.
-  if (state->conn_closed) {
-    result->body = *buf;
-    buf->remove_prefix(buf->size());
-
-    LOG_FIRST_N(WARNING, 10)
-        << "HTTP message with no Content-Length or Transfer-Encoding may produce "
-           "incomplete message bodies.";
-    return ParseState::kSuccess;
-  }
-
-  return ParseState::kNeedsMoreData;
+  return ParseBodyUntilClose(buf, result, state, partial);
 }
 
-ParseState ParseRequest(std::string_view* buf, Message* result) {
+ParseState ParseRequest(std::string_view* buf, Message* result, PartialMessage* partial) {
   pico_wrapper::HTTPRequest req;
   int retval = pico_wrapper::ParseRequest(*buf, &req);
 
@@ -227,7 +253,7 @@ ParseState ParseRequest(std::string_view* buf, Message* result) {
     result->req_path = std::string(req.path, req.path_len);
     result->headers_byte_size = retval;
 
-    return ParseRequestBody(buf, result);
+    return ParseRequestBody(buf, result, partial);
   }
   if (retval == -2) {
     return ParseState::kNeedsMoreData;
@@ -235,7 +261,8 @@ ParseState ParseRequest(std::string_view* buf, Message* result) {
   return ParseState::kInvalid;
 }
 
-ParseState ParseResponse(std::string_view* buf, Message* result, State* state) {
+ParseState ParseResponse(std::string_view* buf, Message* result, State* state,
+                         PartialMessage* partial) {
   pico_wrapper::HTTPResponse resp;
   int retval = pico_wrapper::ParseResponse(*buf, &resp);
 
@@ -249,7 +276,7 @@ ParseState ParseResponse(std::string_view* buf, Message* result, State* state) {
     result->resp_message = std::string(resp.msg, resp.msg_len);
     result->headers_byte_size = retval;
 
-    return ParseResponseBody(buf, result, state);
+    return ParseResponseBody(buf, result, state, partial);
   }
   if (retval == -2) {
     return ParseState::kNeedsMoreData;
@@ -257,6 +284,70 @@ ParseState ParseResponse(std::string_view* buf, Message* result, State* state) {
   return ParseState::kInvalid;
 }
 
+StreamState* GetStreamState(message_type_t type, State* state) {
+  if (state == nullptr) {
+    return nullptr;
+  }
+  switch (type) {
+    case message_type_t::kRequest:
+      return &state->req_stream;
+    case message_type_t::kResponse:
+      return &state->resp_stream;
+    default:
+      return nullptr;
+  }
+}
+
+// Returns true if the partial message of the stream is at the start of buf. Streams only grow,
+// so buf must also hold at least as many bytes of the message as when it was last parsed.
+bool CanResume(const StreamState& stream, std::string_view buf) {
+  return stream.pos.has_value() && stream.pos.value() == stream.partial_msg->pos &&
+         buf.size() >= stream.partial_msg->buffered_bytes;
+}
+
+// Returns true if more bytes of the body can't change how the message is parsed, short of its
+// body being complete. This is not the case for responses whose body could still turn out to be
+// the next response, when ParseResponseBody() checks for responses to HEAD requests.
+bool IsBodyStartSettled(message_type_t type, std::string_view body) {
+  constexpr std::string_view kRespStart = "HTTP";
+  return type == message_type_t::kRequest ||
+         (body.size() >= kRespStart.size() && !absl::StartsWith(body, kRespStart));
+}
+
+// Continues parsing the partial message of the stream, at the start of buf, from where parsing
+// left off.
+ParseState ResumePartialMessage(std::string_view* buf, Message* result, State* state,
+                                StreamState* stream) {
+  PartialMessage* partial = &stream->partial_msg.value();
+  partial->buffered_bytes = buf->size();
+  buf->remove_prefix(partial->msg.headers_byte_size);
+
+  ParseState parse_state = ParseState::kInvalid;
+  switch (partial->body_framing) {
+    case BodyFraming::kContentLength:
+      parse_state = ParseContent(partial->content_length, buf, &partial->msg);
+      break;
+    case BodyFraming::kChunked:
+      parse_state = ParseChunkedBody(buf, &partial->msg, partial);
+      break;
+    case BodyFraming::kUntilClose:
+      parse_state = ParseBodyUntilClose(buf, &partial->msg, state, partial);
+      break;
+    case BodyFraming::kUnknown:
+      LOG(DFATAL) << "Partial HTTP message with unknown body framing.";
+      break;
+  }
+
+  if (parse_state == ParseState::kNeedsMoreData) {
+    return parse_state;
+  }
+  if (parse_state == ParseState::kSuccess) {
+    *result = std::move(partial->msg);
+  }
+  stream->partial_msg.reset();
+  return parse_state;
+}
+
 /**
  * Parses a raw input buffer for HTTP messages.
  * HTTP headers are parsed by pico. Body is extracted separately.
@@ -268,14 +359,92 @@ ParseState ParseResponse(std::string_view* buf, Message* result, State* state) {
  * @return parse state indicating how the parse progressed.
  */
 ParseState ParseFrame(message_type_t type, std::string_view* buf, Message* result, State* state) {
+  StreamState* stream = GetStreamState(type, state);
+  if (stream != nullptr && stream->partial_msg.has_value()) {
+    if (CanResume(*stream, *buf)) {
+      return ResumePartialMessage(buf, result, state, stream);
+    }
+    stream->partial_msg.reset();
+  }
+
+  const std::string_view orig_buf = *buf;
+  PartialMessage partial;
+  ParseState parse_state = ParseState::kInvalid;
   switch (type) {
     case message_type_t::kRequest:
-      return ParseRequest(buf, result);
+      parse_state = ParseRequest(buf, result, &partial);
+      break;
     case message_type_t::kResponse:
-      return ParseResponse(buf, result, state);
+      parse_state = ParseResponse(buf, result, state, &partial);
+      break;
     default:
       return ParseState::kInvalid;
   }
+
+  if (parse_state == ParseState::kNeedsMoreData && stream != nullptr && stream->pos.has_value() &&
+      partial.body_framing != BodyFraming::kUnknown &&
+      IsBodyStartSettled(type, orig_buf.substr(result->headers_byte_size))) {
+    partial.pos = stream->pos.value();
+    partial.buffered_bytes = orig_buf.size();
+    partial.msg = std::move(*result);
+    stream->partial_msg = std::move(partial);
+  }
+
+  return parse_state;
+}
+
+std::optional<std::pair<size_t, size_t>> FindContentLengthBody(message_type_t type,
+                                                               std::string_view buf) {
+  int retval = -1;
+  HeadersMap headers;
+  switch (type) {
+    case message_type_t::kRequest: {
+      pico_wrapper::HTTPRequest req;
+      retval = pico_wrapper::ParseRequest(buf, &req);
+      if (retval >= 0) {
+        headers = pico_wrapper::GetHTTPHeadersMap(req.headers, req.num_headers);
+      }
+      break;
+    }
+    case message_type_t::kResponse: {
+      pico_wrapper::HTTPResponse resp;
+      retval = pico_wrapper::ParseResponse(buf, &resp);
+      if (retval >= 0) {
+        headers = pico_wrapper::GetHTTPHeadersMap(resp.headers, resp.num_headers);
+      }
+      break;
+    }
+    case message_type_t::kUnknown:
+      break;
+  }
+
+  if (retval < 0) {
+    return std::nullopt;
+  }
+
+  // Chunked bodies carry their framing throughout, and encoded bodies are decoded as a whole,
+  // so all of their bytes are needed.
+  if (headers.find(kTransferEncoding) != headers.end() ||
+      headers.find(kContentEncoding) != headers.end()) {
+    return std::nullopt;
+  }
+
+  const auto content_length_iter = headers.find(kContentLength);
+  size_t len;
+  if (content_length_iter == headers.end() ||
+      !absl::SimpleAtoi(content_length_iter->second, &len)) {
+    return std::nullopt;
+  }
+
+  // Some responses, like those to HEAD requests, have a Content-Length but no body. Wait for the
+  // first body bytes, which can't be the start of the next response.
+  const size_t body_offset = retval;
+  std::string_view body = buf.substr(body_offset);
+  if (body.empty() || absl::StartsWith(body, "HTTP")) {
+    return std::nullopt;
+  }
+
+  return std::make_pair(body_offset, len);
 }
 
 // TODO(oazizi/yzhao): This function should use is_http_{response,request} inside
@@ -294,21 +463,22 @@ size_t FindFrameBoundary(message_type_t type, std::string_view buf, size_t start
   // https://developer.mozilla.org/en-US/docs/Web/HTTP/Messages
   static constexpr std::string_view kHTTPRespStartPatternArray[] = {"HTTP/1.1 ", "HTTP/1.0 "};
 
-  static constexpr ArrayView<std::string_view> kHTTPReqStartPatterns =
-      ArrayView<std::string_view>(kHTTPReqStartPatternArray);
-  static constexpr ArrayView<std::string_view> kHTTPRespStartPatterns =
-      ArrayView<std::string_view>(kHTTPRespStartPatternArray);
+  // Each searcher finds the last occurrence of any of its patterns in one backwards pass.
+  static const MultiPatternSearcher kHTTPReqStartSearcher(std::vector<std::string_view>(
+      std::begin(kHTTPReqStartPatternArray), std::end(kHTTPReqStartPatternArray)));
+  static const MultiPatternSearcher kHTTPRespStartSearcher(std::vector<std::string_view>(
+      std::begin(kHTTPRespStartPatternArray), std::end(kHTTPRespStartPatternArray)));
 
   static constexpr std::string_view kBoundaryMarker = "\r\n\r\n";
 
   // Choose the right set of patterns for request vs response.
-  const ArrayView<std::string_view>* start_patterns = nullptr;
+  const MultiPatternSearcher* start_searcher = nullptr;
   switch (type) {
     case message_type_t::kRequest:
-      start_patterns = &kHTTPReqStartPatterns;
+      start_searcher = &kHTTPReqStartSearcher;
       break;
     case message_type_t::kResponse:
-      start_patterns = &kHTTPRespStartPatterns;
+      start_searcher = &kHTTPRespStartSearcher;
       break;
     case message_type_t::kUnknown:
       return std::string::npos;
@@ -326,7 +496,7 @@ size_t FindFrameBoundary(message_type_t type, std::string_view buf, size_t start
   // Note that we don't search forwards for HTTP/1.1 directly, because it could result in matches
   // inside the request/response body.
   while (true) {
-    size_t marker_pos = buf.find(kBoundaryMarker, start_pos);
+    size_t marker_pos = FindPattern(buf, kBoundaryMarker, start_pos);
 
     if (marker_pos == std::string::npos) {
       return std::string::npos;
@@ -334,17 +504,9 @@ size_t FindFrameBoundary(message_type_t type, std::string_view buf, size_t start
 
     std::string_view buf_substr = buf.substr(start_pos, marker_pos - start_pos);
 
-    size_t substr_pos = std::string::npos;
-    for (auto& start_pattern : *start_patterns) {
-      size_t current_substr_pos = buf_substr.rfind(start_pattern);
-      if (current_substr_pos != std::string::npos) {
-        // Found a match. Check if it is closer to the marker than our previous match.
-        // We want to return the match that is closest to the marker, so we aren't
-        // matching to something in a previous message's body.
-        substr_pos = (substr_pos == std::string::npos) ? current_substr_pos
-                                                       : std::max(substr_pos, current_substr_pos);
-      }
-    }
+    // We want the match that is closest to the marker, so we aren't matching to something in a
+    // previous message's body.
+    size_t substr_pos = start_searcher->RFind(buf_substr);
 
     if (substr_pos != std::string::npos) {
       return start_pos + substr_pos;
@@ -363,6 +525,18 @@ ParseState ParseFrame(message_type_t type, std::string_view* buf, http::Message*
   return http::ParseFrame(type, buf, result, &state->global);
 }
 
+template <>
+void SetStreamPosition(message_type_t type, std::optional<size_t> pos,
+                       http::StateWrapper* state) {
+  if (state == nullptr) {
+    return;
+  }
+  http::StreamState* stream = http::GetStreamState(type, &state->global);
+  if (stream != nullptr) {
+    stream->pos = pos;
+  }
+}
+
 template <>
 size_t FindFrameBoundary<http::Message>(message_type_t type, std::string_view buf, size_t start_pos,
                                         http::StateWrapper* /*state*/) {
@@ -19,7 +19,9 @@
 #pragma once
 
 #include <deque>
+#include <optional>
 #include <string>
+#include <utility>
 
 #include "src/stirling/source_connectors/socket_tracer/protocols/common/interface.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/http/types.h"
@@ -28,6 +30,20 @@ namespace px {
 namespace stirling {
 namespace protocols {
 
+namespace http {
+
+/**
+ * Locates the body of the HTTP message at the start of buf, once its headers are complete, if the
+ * body is sized by Content-Length and left as sent (i.e. not chunked or content-encoded). Then the
+ * position of every body byte is known before the body arrives.
+ *
+ * @return The offset of the body in buf and the size of the body, or std::nullopt.
+ */
+std::optional<std::pair<size_t, size_t>> FindContentLengthBody(message_type_t type,
+                                                               std::string_view buf);
+
+}  // namespace http
+
 /**
  * Parses a single HTTP message from the input string.
  */
@@ -39,6 +55,9 @@ template <>
 size_t FindFrameBoundary<http::Message>(message_type_t type, std::string_view buf, size_t start_pos,
                                         http::StateWrapper* state);
 
+template <>
+void SetStreamPosition(message_type_t type, std::optional<size_t> pos, http::StateWrapper* state);
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <optional>
 #include <random>
 #include <utility>
 #include <vector>
@@ -651,6 +652,60 @@ TEST_F(HTTPParserTest, PartialMessageInTheMiddleOfStream) {
   EXPECT_THAT(parsed_messages, ElementsAre(HasBody("foobar"), HasBody("pixielabs rocks!")));
 }
 
+// Tests that ParseFrames() resumes parsing a message whose body arrives over multiple calls,
+// instead of parsing it from its start again.
+TEST_F(HTTPParserTest, ResumePartialChunkedMessage) {
+  StateWrapper state{};
+  const std::string msg = absl::StrCat(HTTPRespWithChunkedBody({"pixielabs ", "is ", "awesome!"}),
+                                       HTTPRespWithSizedBody("foobar"));
+  // The first split ends before the last data chunk of the first message.
+  std::vector<std::string_view> msg_splits = MessageSplit(msg, {msg.find(HTTPChunk("awesome!"))});
+  std::vector<SocketDataEvent> events = CreateEvents<std::string_view>(msg_splits);
+
+  std::deque<Message> parsed_messages;
+  AddEvent(events[0]);
+  ParseResult result = ParseFrames(message_type_t::kResponse, &data_buffer_, &parsed_messages,
+                                   /* resync */ false, &state);
+  data_buffer_.RemovePrefix(result.end_position);
+
+  EXPECT_EQ(ParseState::kNeedsMoreData, result.state);
+  EXPECT_THAT(parsed_messages, IsEmpty());
+  ASSERT_TRUE(state.global.resp_stream.partial_msg.has_value());
+  EXPECT_EQ(state.global.resp_stream.partial_msg->chunked_decoder_state.decoded, "pixielabs is ");
+
+  AddEvent(events[1]);
+  result = ParseFrames(message_type_t::kResponse, &data_buffer_, &parsed_messages,
+                       /* resync */ false, &state);
+
+  EXPECT_EQ(ParseState::kSuccess, result.state);
+  EXPECT_THAT(parsed_messages, ElementsAre(HasBody("pixielabs is awesome!"), HasBody("foobar")));
+  EXPECT_FALSE(state.global.resp_stream.partial_msg.has_value());
+}
+
+// Feeds messages one byte at a time, so that parsing resumes at every possible point.
+TEST_F(HTTPParserTest, ResumePartialMessagesByteByByte) {
+  StateWrapper state{};
+  const std::string msg =
+      absl::StrCat(HTTPRespWithChunkedBody({"pixielabs ", "is ", "awesome!"}),
+                   HTTPRespWithSizedBody("foobar"), HTTPRespWithChunkedBody({"rocks!"}));
+
+  std::vector<std::string_view> splits;
+  for (size_t i = 0; i < msg.size(); ++i) {
+    splits.push_back(std::string_view(msg).substr(i, 1));
+  }
+
+  std::deque<Message> parsed_messages;
+  for (const SocketDataEvent& event : CreateEvents<std::string_view>(splits)) {
+    AddEvent(event);
+    ParseResult result = ParseFrames(message_type_t::kResponse, &data_buffer_, &parsed_messages,
+                                     /* resync */ false, &state);
+    data_buffer_.RemovePrefix(result.end_position);
+  }
+
+  EXPECT_THAT(parsed_messages, ElementsAre(HasBody("pixielabs is awesome!"), HasBody("foobar"),
+                                           HasBody("rocks!")));
+}
+
 //=============================================================================
 // HTTP Parsing Stress Tests
 //=============================================================================
@@ -1090,6 +1145,72 @@ TEST_F(HTTPParserTest, ParseRespWithPartialFirstMessageWithSync) {
   EXPECT_THAT(parsed_messages, ElementsAre(HTTPResp1ExpectedMessage(), HTTPResp2ExpectedMessage()));
 }
 
+//=============================================================================
+// FindContentLengthBody
+//=============================================================================
+
+TEST(FindContentLengthBodyTest, ContentLengthBody) {
+  const std::string_view kResp =
+      "HTTP/1.1 200 OK\r\n"
+      "Content-Length: 1000\r\n"
+      "\r\n"
+      "abcdef";
+  std::optional<std::pair<size_t, size_t>> body =
+      FindContentLengthBody(message_type_t::kResponse, kResp);
+  ASSERT_TRUE(body.has_value());
+  EXPECT_EQ(body->first, kResp.find("abcdef"));
+  EXPECT_EQ(body->second, 1000);
+
+  const std::string_view kReq =
+      "POST /upload HTTP/1.1\r\n"
+      "Content-Length: 2000\r\n"
+      "\r\n"
+      "abc";
+  body = FindContentLengthBody(message_type_t::kRequest, kReq);
+  ASSERT_TRUE(body.has_value());
+  EXPECT_EQ(body->first, kReq.find("abc"));
+  EXPECT_EQ(body->second, 2000);
+}
+
+TEST(FindContentLengthBodyTest, NoKnownBody) {
+  // Incomplete headers.
+  EXPECT_EQ(FindContentLengthBody(message_type_t::kResponse,
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Length: 1000\r\n"),
+            std::nullopt);
+
+  // No body bytes yet, and a HEAD response followed by the next response.
+  EXPECT_EQ(FindContentLengthBody(message_type_t::kResponse,
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Length: 1000\r\n"
+                                  "\r\n"),
+            std::nullopt);
+  EXPECT_EQ(FindContentLengthBody(message_type_t::kResponse,
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Length: 1000\r\n"
+                                  "\r\n"
+                                  "HTTP/1.1 200 OK\r\n"),
+            std::nullopt);
+
+  // Bodies that are needed whole.
+  EXPECT_EQ(FindContentLengthBody(message_type_t::kResponse,
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Transfer-Encoding: chunked\r\n"
+                                  "\r\n"
+                                  "9\r\n"),
+            std::nullopt);
+  EXPECT_EQ(FindContentLengthBody(message_type_t::kResponse,
+                                  "HTTP/1.1 200 OK\r\n"
+                                  "Content-Length: 1000\r\n"
+                                  "Content-Encoding: gzip\r\n"
+                                  "\r\n"
+                                  "abc"),
+            std::nullopt);
+
+  // No Content-Length.
+  EXPECT_EQ(FindContentLengthBody(message_type_t::kRequest, kHTTPGetReq0), std::nullopt);
+}
+
 }  // namespace http
 }  // namespace protocols
 }  // namespace stirling
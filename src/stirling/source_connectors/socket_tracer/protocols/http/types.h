@@ -19,10 +19,12 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
 #include <string>
 
 #include "src/common/base/utils.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/common/event_parser.h"  // For FrameBase
+#include "src/stirling/source_connectors/socket_tracer/protocols/http/chunked_decoder.h"
 
 namespace px {
 namespace stirling {
@@ -99,8 +101,44 @@ struct Record {
   }
 };
 
+// How the end of a message body is found.
+enum class BodyFraming {
+  kUnknown,
+  kContentLength,
+  kChunked,
+  // The body lasts until the connection is closed.
+  kUntilClose,
+};
+
+// A message whose headers were parsed, but whose body has not fully arrived. Parsing resumes in the
+// body once more of it arrives, so that a large body that arrives over many iterations is not
+// reparsed from the start of the message each time.
+struct PartialMessage {
+  // The position of the message in the stream.
+  size_t pos = 0;
+  // The number of bytes of the message that had arrived when it was last parsed.
+  size_t buffered_bytes = 0;
+  // The message, without its body.
+  Message msg;
+
+  BodyFraming body_framing = BodyFraming::kUnknown;
+  // Only for BodyFraming::kContentLength.
+  size_t content_length = 0;
+  // Only for BodyFraming::kChunked.
+  ChunkedDecoderState chunked_decoder_state;
+};
+
+// The parsing state of the request or the response stream of a connection.
+struct StreamState {
+  // The position in the stream of the buffer passed to the next ParseFrame() call, if known.
+  std::optional<size_t> pos;
+  std::optional<PartialMessage> partial_msg;
+};
+
 struct State {
   bool conn_closed = false;
+  StreamState req_stream;
+  StreamState resp_stream;
 };
 
 struct StateWrapper {
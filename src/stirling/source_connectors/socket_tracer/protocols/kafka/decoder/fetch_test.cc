@@ -347,6 +347,7 @@ TEST(KafkaPacketDecoder, TestExtractFetchRespV11) {
 
   PacketDecoder decoder(input);
   decoder.SetAPIInfo(APIKey::kFetch, 11);
+  decoder.set_extract_record_batches(true);
   EXPECT_OK_AND_EQ(decoder.ExtractFetchResp(), expected_result);
 }
 
@@ -403,6 +404,7 @@ TEST(KafkaPacketDecoder, TestExtractFetchRespV12) {
 
   PacketDecoder decoder(input);
   decoder.SetAPIInfo(APIKey::kFetch, 12);
+  decoder.set_extract_record_batches(true);
   EXPECT_OK_AND_EQ(decoder.ExtractFetchResp(), expected_result);
 }
 
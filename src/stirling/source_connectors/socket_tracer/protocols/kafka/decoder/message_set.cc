@@ -45,10 +45,7 @@ StatusOr<RecordMessage> PacketDecoder::ExtractRecordMessage() {
 }
 
 // Only supports Kafka version >= 0.11.0
-StatusOr<RecordBatch> PacketDecoder::ExtractRecordBatch(int32_t* offset) {
-  constexpr int32_t kBaseOffsetLength = 8;
-  constexpr int32_t kLengthLength = 4;
-
+StatusOr<RecordBatch> PacketDecoder::ExtractRecordBatch() {
   RecordBatch r;
   PL_ASSIGN_OR_RETURN(int64_t base_offset, ExtractInt64());
 
@@ -87,16 +84,12 @@ StatusOr<RecordBatch> PacketDecoder::ExtractRecordBatch(int32_t* offset) {
 
   PL_ASSIGN_OR_RETURN(r.records, ExtractRegularArray(&PacketDecoder::ExtractRecordMessage));
   PL_RETURN_IF_ERROR(JumpToOffset());
-
-  *offset += length + kBaseOffsetLength + kLengthLength;
   return r;
 }
 
 StatusOr<MessageSet> PacketDecoder::ExtractMessageSet() {
   MessageSet message_set;
 
-  int32_t offset = 0;
-
   if (is_flexible_) {
     PL_ASSIGN_OR_RETURN(message_set.size, ExtractUnsignedVarint());
   } else {
@@ -104,6 +97,13 @@ StatusOr<MessageSet> PacketDecoder::ExtractMessageSet() {
   }
   PL_RETURN_IF_ERROR(MarkOffset(message_set.size));
 
+  // The record batches make up most of a produce request or fetch response, so unless they were
+  // asked for, jump over them (and the tagged section) without decoding them.
+  if (!extract_record_batches_) {
+    PL_RETURN_IF_ERROR(JumpToOffset());
+    return message_set;
+  }
+
   // The message set in a fetch response is sent with the sendfile syscall:
   // sendfile(int out_fd, int in_fd, off_t *offset, size_t count). We can only get the length of
   // the payload, not the content. To make sure ParseFrame functions correctly, a temporary fix
@@ -118,8 +118,9 @@ StatusOr<MessageSet> PacketDecoder::ExtractMessageSet() {
   // record batches as possible. If an error occurs due to tagged section, we just jump to the
   // correct offset and continue parsing.
 
-  while (offset < message_set.size) {
-    auto record_batch_result = ExtractRecordBatch(&offset);
+  const size_t end_size = binary_decoder_.BufSize() - message_set.size;
+  while (binary_decoder_.BufSize() > end_size) {
+    auto record_batch_result = ExtractRecordBatch();
     if (record_batch_result.ok()) {
       message_set.record_batches.push_back(record_batch_result.ValueOrDie());
     } else {
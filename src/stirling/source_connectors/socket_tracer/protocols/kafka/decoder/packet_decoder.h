@@ -65,6 +65,8 @@ std::string ToString(T obj) {
   return json_object_builder.GetString();
 }
 
+// Decodes Kafka packets. The strings and bytes it extracts are views into the packet, so they must
+// not outlive it.
 class PacketDecoder {
  public:
   explicit PacketDecoder(std::string_view buf) : marked_bufs_(), binary_decoder_(buf) {}
@@ -90,14 +92,14 @@ class PacketDecoder {
   // https://developers.google.com/protocol-buffers/docs/encoding#varints
   StatusOr<int64_t> ExtractVarlong();
 
-  StatusOr<std::string> ExtractString();
-  StatusOr<std::string> ExtractNullableString();
+  StatusOr<std::string_view> ExtractString();
+  StatusOr<std::string_view> ExtractNullableString();
 
-  StatusOr<std::string> ExtractBytes();
-  StatusOr<std::string> ExtractNullableBytes();
+  StatusOr<std::string_view> ExtractBytes();
+  StatusOr<std::string_view> ExtractNullableBytes();
 
   // Represents bytes whose length is encoded with zigzag varint.
-  StatusOr<std::string> ExtractBytesZigZag();
+  StatusOr<std::string_view> ExtractBytesZigZag();
 
   // TODO(chengruizhe): Use std::function in ExtractArray and ExtractCompactArray.
   // Represents a sequence of objects of a given type T. Type T can be either a primitive
@@ -171,9 +173,10 @@ class PacketDecoder {
   // Messages (aka Records) are always written in batches. The technical term for a batch of
   // messages is a record batch, and a record batch contains one or more records.
   // https://kafka.apache.org/documentation/#recordbatch
-  StatusOr<RecordBatch> ExtractRecordBatch(int32_t* offset);
+  StatusOr<RecordBatch> ExtractRecordBatch();
 
-  // A MessageSet contains multiple record batches.
+  // A MessageSet contains multiple record batches. They are only decoded if
+  // set_extract_record_batches(true) was called; otherwise they are skipped over by length.
   StatusOr<MessageSet> ExtractMessageSet();
 
   // Partition Data in Produce Request.
@@ -238,45 +241,48 @@ class PacketDecoder {
     is_flexible_ = IsFlexible(api_key, api_version);
   }
 
+  // The record batches carry the keys and values of the produced and fetched messages, which
+  // make up most of the bytes of those packets, but are not traced.
+  void set_extract_record_batches(bool extract) { extract_record_batches_ = extract; }
+
  private:
   // Represents a sequence of characters. First the length N is given as an INT16. Then N
   // bytes follow which are the UTF-8 encoding of the character sequence.
-  StatusOr<std::string> ExtractRegularString();
+  StatusOr<std::string_view> ExtractRegularString();
 
   // Represents a sequence of characters or null. For non-null strings, first the
   // length N is given as an INT16. Then N bytes follow which are the UTF-8 encoding of the
   // character sequence. A null value is encoded with length of -1 and there are no following
   // bytes.
-  StatusOr<std::string> ExtractRegularNullableString();
+  StatusOr<std::string_view> ExtractRegularNullableString();
 
   // Represents a sequence of characters. First the length N + 1 is given as an
   // UNSIGNED_VARINT . Then N bytes follow which are the UTF-8 encoding of the character sequence.
-  StatusOr<std::string> ExtractCompactString();
+  StatusOr<std::string_view> ExtractCompactString();
 
   // Represents a sequence of characters. First the length N + 1 is given
   // as an UNSIGNED_VARINT . Then N bytes follow which are the UTF-8 encoding of the character
   // sequence. A null string is represented with a length of 0.
-  StatusOr<std::string> ExtractCompactNullableString();
+  StatusOr<std::string_view> ExtractCompactNullableString();
 
   // Represents a raw sequence of bytes. First the length N is given as an INT32. Then N bytes
   // follow.
-  StatusOr<std::string> ExtractRegularBytes();
+  StatusOr<std::string_view> ExtractRegularBytes();
 
   // Represents a raw sequence of bytes or null. For non-null values, first the length N is given
   // as an INT32. Then N bytes follow. A null value is encoded with length of -1 and there are no
   // following bytes.
-  StatusOr<std::string> ExtractRegularNullableBytes();
+  StatusOr<std::string_view> ExtractRegularNullableBytes();
 
   // Represents a raw sequence of bytes. First the length N+1 is given as an UNSIGNED_VARINT.Then
   // N bytes follow.
-  StatusOr<std::string> ExtractCompactBytes();
+  StatusOr<std::string_view> ExtractCompactBytes();
 
   // Represents a raw sequence of bytes. First the length N+1 is given as an UNSIGNED_VARINT.Then
   // N bytes follow. A null object is represented with a length of 0.
-  StatusOr<std::string> ExtractCompactNullableBytes();
+  StatusOr<std::string_view> ExtractCompactNullableBytes();
 
-  template <typename TCharType>
-  StatusOr<std::basic_string<TCharType>> ExtractBytesCore(int32_t len);
+  StatusOr<std::string_view> ExtractBytesCore(int32_t len);
 
   template <uint8_t TMaxLength>
   StatusOr<int64_t> ExtractUnsignedVarintCore();
@@ -308,6 +314,7 @@ class PacketDecoder {
   APIKey api_key_;
   int16_t api_version_ = 0;
   bool is_flexible_ = false;
+  bool extract_record_batches_ = false;
 };
 
 }  // namespace kafka
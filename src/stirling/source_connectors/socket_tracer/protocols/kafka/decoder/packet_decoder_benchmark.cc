@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "src/common/base/base.h"
+#include "src/stirling/source_connectors/socket_tracer/protocols/kafka/decoder/packet_decoder.h"
+
+using px::stirling::protocols::kafka::APIKey;
+using px::stirling::protocols::kafka::PacketDecoder;
+using px::stirling::protocols::kafka::ProduceReq;
+
+namespace {
+
+template <typename TIntType>
+void AppendBigEndian(TIntType val, std::string* out) {
+  for (int i = sizeof(TIntType) - 1; i >= 0; --i) {
+    out->push_back(static_cast<char>((static_cast<uint64_t>(val) >> (8 * i)) & 0xff));
+  }
+}
+
+void AppendVarint(int64_t val, std::string* out) {
+  uint64_t zigzag = (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63);
+  while (zigzag >= 0x80) {
+    out->push_back(static_cast<char>((zigzag & 0x7f) | 0x80));
+    zigzag >>= 7;
+  }
+  out->push_back(static_cast<char>(zigzag));
+}
+
+// A v2 record batch with num_records records, without keys, of value_size bytes each.
+std::string CreateRecordBatch(int num_records, int value_size) {
+  std::string records;
+  AppendBigEndian<int32_t>(num_records, &records);
+  for (int i = 0; i < num_records; ++i) {
+    std::string record;
+    record.push_back(/* attributes */ 0);
+    AppendVarint(/* timestamp_delta */ 0, &record);
+    AppendVarint(/* offset_delta */ i, &record);
+    AppendVarint(/* key_length */ -1, &record);
+    AppendVarint(value_size, &record);
+    record.append(value_size, 'x');
+    AppendVarint(/* num_headers */ 0, &record);
+
+    AppendVarint(record.size(), &records);
+    records += record;
+  }
+
+  std::string batch_body;
+  AppendBigEndian<int32_t>(/* partition_leader_epoch */ -1, &batch_body);
+  batch_body.push_back(/* magic */ 2);
+  AppendBigEndian<int32_t>(/* crc */ 0, &batch_body);
+  AppendBigEndian<int16_t>(/* attributes */ 0, &batch_body);
+  AppendBigEndian<int32_t>(/* last_offset_delta */ num_records - 1, &batch_body);
+  AppendBigEndian<int64_t>(/* first_timestamp */ 0, &batch_body);
+  AppendBigEndian<int64_t>(/* max_timestamp */ 0, &batch_body);
+  AppendBigEndian<int64_t>(/* producer_id */ -1, &batch_body);
+  AppendBigEndian<int16_t>(/* producer_epoch */ -1, &batch_body);
+  AppendBigEndian<int32_t>(/* base_sequence */ -1, &batch_body);
+  batch_body += records;
+
+  std::string batch;
+  AppendBigEndian<int64_t>(/* base_offset */ 0, &batch);
+  AppendBigEndian<int32_t>(batch_body.size(), &batch);
+  batch += batch_body;
+  return batch;
+}
+
+// A v8 produce request (without the request header) with one topic and partition.
+std::string CreateProduceReq(int num_records, int value_size) {
+  const std::string_view kTopic = "benchmark-topic";
+  const std::string record_batch = CreateRecordBatch(num_records, value_size);
+
+  std::string req;
+  AppendBigEndian<int16_t>(/* transactional_id */ -1, &req);
+  AppendBigEndian<int16_t>(/* acks */ 1, &req);
+  AppendBigEndian<int32_t>(/* timeout_ms */ 1500, &req);
+  AppendBigEndian<int32_t>(/* num_topics */ 1, &req);
+  AppendBigEndian<int16_t>(kTopic.size(), &req);
+  req += kTopic;
+  AppendBigEndian<int32_t>(/* num_partitions */ 1, &req);
+  AppendBigEndian<int32_t>(/* index */ 0, &req);
+  AppendBigEndian<int32_t>(record_batch.size(), &req);
+  req += record_batch;
+  return req;
+}
+
+void ExtractProduceReq(benchmark::State& state, bool extract_record_batches) {
+  const std::string req = CreateProduceReq(state.range(0), state.range(1));
+
+  for (auto _ : state) {
+    PacketDecoder decoder(req);
+    decoder.SetAPIInfo(APIKey::kProduce, 8);
+    decoder.set_extract_record_batches(extract_record_batches);
+    px::StatusOr<ProduceReq> result = decoder.ExtractProduceReq();
+    CHECK(result.ok());
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(state.iterations() * req.size());
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE(runtime/references)
+static void BM_ExtractProduceReq(benchmark::State& state) {
+  ExtractProduceReq(state, /* extract_record_batches */ false);
+}
+
+// NOLINTNEXTLINE(runtime/references)
+static void BM_ExtractProduceReqRecordBatches(benchmark::State& state) {
+  ExtractProduceReq(state, /* extract_record_batches */ true);
+}
+
+// Args are the number of records in the batch, and the size of their values.
+BENCHMARK(BM_ExtractProduceReq)->Args({1, 100})->Args({1000, 100})->Args({100, 10000});
+BENCHMARK(BM_ExtractProduceReqRecordBatches)
+    ->Args({1, 100})
+    ->Args({1000, 100})
+    ->Args({100, 10000});
@@ -22,8 +22,10 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "src/common/json/json.h"
 #include "src/stirling/source_connectors/socket_tracer/protocols/kafka/common/types.h"
 
 namespace px {
@@ -31,9 +33,10 @@ namespace stirling {
 namespace protocols {
 namespace kafka {
 
+// The key and value are views into the decoded packet.
 struct RecordMessage {
-  std::string key;
-  std::string value;
+  std::string_view key;
+  std::string_view value;
 
   void ToJSON(utils::JSONObjectBuilder* builder) const {
     builder->WriteKV("key", key);
@@ -172,6 +172,10 @@ size_t FindFrameBoundary<kafka::Packet, kafka::StateWrapper>(message_type_t type
   return kafka::FindFrameBoundary(type, buf, start_pos, &state->global);
 }
 
+template <>
+void SetStreamPosition(message_type_t /*type*/, std::optional<size_t> /*pos*/,
+                       kafka::StateWrapper* /*state*/) {}
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <deque>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,9 @@ template <>
 size_t FindFrameBoundary<kafka::Packet>(message_type_t type, std::string_view buf, size_t start_pos,
                                         kafka::StateWrapper* state);
 
+template <>
+void SetStreamPosition(message_type_t type, std::optional<size_t> pos, kafka::StateWrapper* state);
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -128,6 +128,10 @@ size_t FindFrameBoundary<mysql::Packet>(message_type_t type, std::string_view bu
   return mysql::FindFrameBoundary(type, buf, start_pos);
 }
 
+template <>
+void SetStreamPosition(message_type_t /*type*/, std::optional<size_t> /*pos*/,
+                       mysql::StateWrapper* /*state*/) {}
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <deque>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -40,6 +41,9 @@ template <>
 size_t FindFrameBoundary<mysql::Packet>(message_type_t type, std::string_view buf, size_t start_pos,
                                         mysql::StateWrapper* state);
 
+template <>
+void SetStreamPosition(message_type_t type, std::optional<size_t> pos, mysql::StateWrapper* state);
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -97,13 +97,36 @@ Status ParseStartupMessage(std::string_view* buf, StartupMessage* msg) {
   return Status::OK();
 }
 
-size_t FindFrameBoundary(std::string_view buf, size_t start) {
-  for (size_t i = start; i < buf.size(); ++i) {
-    if (magic_enum::enum_cast<Tag>(buf[i]).has_value()) {
-      return i;
-    }
+StreamState* GetStreamState(message_type_t type, StateWrapper* state) {
+  if (state == nullptr) {
+    return nullptr;
+  }
+  switch (type) {
+    case message_type_t::kRequest:
+      return &state->global.req_stream;
+    case message_type_t::kResponse:
+      return &state->global.resp_stream;
+    default:
+      return nullptr;
+  }
+}
+
+namespace {
+
+// The bytes that are valid message tags, i.e. that magic_enum::enum_cast<Tag>() accepts.
+ByteSet TagBytes() {
+  std::string tags;
+  for (Tag tag : magic_enum::enum_values<Tag>()) {
+    tags.push_back(static_cast<char>(tag));
   }
-  return std::string_view::npos;
+  return ByteSet(tags);
+}
+
+}  // namespace
+
+size_t FindFrameBoundary(std::string_view buf, size_t start) {
+  static const ByteSet kTagBytes = TagBytes();
+  return FindFirstOf(buf, kTagBytes, start);
 }
 
 Status ParseCmdCmpl(const RegularMessage& msg, CmdCmpl* cmd_cmpl) {
@@ -311,16 +334,46 @@ Status ParseDesc(const RegularMessage& msg, Desc* desc) {
 
 template <>
 ParseState ParseFrame(message_type_t type, std::string_view* buf, pgsql::RegularMessage* frame,
-                      pgsql::StateWrapper* /*state*/) {
-  PL_UNUSED(type);
+                      pgsql::StateWrapper* state) {
+  pgsql::StreamState* stream = pgsql::GetStreamState(type, state);
+
+  // Skip parsing the partial message at the start of buf again until all of it has arrived.
+  if (stream != nullptr && stream->partial_msg.has_value()) {
+    if (stream->pos == stream->partial_msg->pos && buf->size() < stream->partial_msg->size) {
+      return ParseState::kNeedsMoreData;
+    }
+    stream->partial_msg.reset();
+  }
 
   std::string_view buf_copy = *buf;
   pgsql::StartupMessage startup_msg = {};
+  bool skipped_startup_msg = false;
   if (pgsql::ParseStartupMessage(&buf_copy, &startup_msg).ok() && !startup_msg.nvs.empty()) {
     // Ignore startup message, but remove it from the buffer.
     *buf = buf_copy;
+    skipped_startup_msg = true;
+  }
+  ParseState parse_state = pgsql::ParseRegularMessage(buf, frame);
+
+  // Remember the size of a message that has not fully arrived, once its length is known.
+  // Messages with the unknown tag are not remembered, because their first bytes could still parse
+  // as a startup message once more bytes arrive. With any other tag, the length that
+  // ParseStartupMessage() reads is over 800MB.
+  if (parse_state == ParseState::kNeedsMoreData && stream != nullptr && stream->pos.has_value() &&
+      !skipped_startup_msg && frame->len > 0 && frame->tag != pgsql::Tag::kUnknown) {
+    // The message size includes the tag, which is not counted in the length.
+    stream->partial_msg = pgsql::PartialMessage{stream->pos.value(), frame->len + 1UL};
+  }
+  return parse_state;
+}
+
+template <>
+void SetStreamPosition(message_type_t type, std::optional<size_t> pos,
+                       pgsql::StateWrapper* state) {
+  pgsql::StreamState* stream = pgsql::GetStreamState(type, state);
+  if (stream != nullptr) {
+    stream->pos = pos;
   }
-  return pgsql::ParseRegularMessage(buf, frame);
 }
 
 template <>
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <deque>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -49,6 +50,9 @@ Status ParseDesc(const RegularMessage& msg, Desc* desc);
 
 size_t FindFrameBoundary(std::string_view buf, size_t start);
 
+// Returns the parsing state of the stream of the given type, or nullptr if there is none.
+StreamState* GetStreamState(message_type_t type, StateWrapper* state);
+
 }  // namespace pgsql
 
 template <>
@@ -59,6 +63,10 @@ template <>
 size_t FindFrameBoundary<pgsql::RegularMessage>(message_type_t type, std::string_view buf,
                                                 size_t start, pgsql::StateWrapper* /*state*/);
 
+template <>
+void SetStreamPosition(message_type_t type, std::optional<size_t> pos,
+                       pgsql::StateWrapper* state);
+
 }  // namespace protocols
 }  // namespace stirling
 }  // namespace px
@@ -18,6 +18,7 @@
 
 #include "src/stirling/source_connectors/socket_tracer/protocols/pgsql/parse.h"
 
+#include <deque>
 #include <string>
 #include <utility>
 
@@ -59,6 +60,30 @@ TEST(PGSQLParseTest, BasicMessage) {
       msg, IsRegularMessage(Tag::kQuery, 27, CreateStringView<char>("select * from account;\0")));
 }
 
+TEST(PGSQLParseTest, ResumePartialMessage) {
+  StateWrapper state = {};
+  std::deque<RegularMessage> frames;
+  constexpr size_t kStreamPos = 100;
+
+  // The tag and the length have arrived, so the size of the message is remembered.
+  ParseResult result = ParseFramesLoop(message_type_t::kRequest, kQueryTestData.substr(0, 10),
+                                       &frames, &state, kStreamPos);
+  EXPECT_EQ(result.state, ParseState::kNeedsMoreData);
+  ASSERT_TRUE(state.global.req_stream.partial_msg.has_value());
+  EXPECT_EQ(state.global.req_stream.partial_msg->size, kQueryTestData.size());
+
+  result = ParseFramesLoop(message_type_t::kRequest, kQueryTestData.substr(0, 20), &frames,
+                           &state, kStreamPos);
+  EXPECT_EQ(result.state, ParseState::kNeedsMoreData);
+  EXPECT_THAT(frames, IsEmpty());
+
+  result = ParseFramesLoop(message_type_t::kRequest, kQueryTestData, &frames, &state, kStreamPos);
+  EXPECT_EQ(result.state, ParseState::kSuccess);
+  EXPECT_THAT(frames, ElementsAre(IsRegularMessage(
+                          Tag::kQuery, 27, CreateStringView<char>("select * from account;\0"))));
+  EXPECT_FALSE(state.global.req_stream.partial_msg.has_value());
+}
+
 auto IsNV(std::string_view name, std::string_view value) {
   return AllOf(Field(&NV::name, name), Field(&NV::value, value));
 }
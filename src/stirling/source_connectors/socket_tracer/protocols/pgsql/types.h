@@ -19,6 +19,7 @@
 #pragma once
 
 #include <deque>
+#include <optional>
 #include <set>
 #include <string>
 #include <utility>
@@ -536,6 +537,21 @@ struct Record {
   RegularMessage resp;
 };
 
+// A message whose tag and length were parsed, but whose payload has not fully arrived.
+struct PartialMessage {
+  // The position of the message in the stream.
+  size_t pos = 0;
+  // The size of the message, including the tag.
+  size_t size = 0;
+};
+
+// The parsing state of the request or the response stream of a connection.
+struct StreamState {
+  // The position in the stream of the buffer passed to the next ParseFrame() call, if known.
+  std::optional<size_t> pos;
+  std::optional<PartialMessage> partial_msg;
+};
+
 struct State {
   absl::flat_hash_map<std::string, std::string> prepared_statements;
 
@@ -549,6 +565,9 @@ struct State {
   // The last set of parameters bound to bound_statement. Everytime a BIND command happens these are
   // invalidated.
   std::vector<Param> bound_params;
+
+  StreamState req_stream;
+  StreamState resp_stream;
 };
 
 struct StateWrapper {
@@ -180,15 +180,9 @@ Status ParseArray(message_type_t type, BinaryDecoder* decoder, Message* msg) {
 }  // namespace
 
 size_t FindMessageBoundary(std::string_view buf, size_t start_pos) {
-  for (; start_pos < buf.size(); ++start_pos) {
-    const char type_marker = buf[start_pos];
-    if (type_marker == kSimpleStringMarker || type_marker == kErrorMarker ||
-        type_marker == kIntegerMarker || type_marker == kBulkStringsMarker ||
-        type_marker == kArrayMarker) {
-      return start_pos;
-    }
-  }
-  return std::string_view::npos;
+  static const ByteSet kTypeMarkers = {kSimpleStringMarker, kErrorMarker, kIntegerMarker,
+                                       kBulkStringsMarker, kArrayMarker};
+  return FindFirstOf(buf, kTypeMarkers, start_pos);
 }
 
 // Redis protocol specification: https://redis.io/topics/protocol
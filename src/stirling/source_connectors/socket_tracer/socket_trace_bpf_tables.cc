@@ -44,7 +44,9 @@ namespace stirling {
 
 ConnInfoMapManager::ConnInfoMapManager(bpf_tools::BCCWrapper* bcc)
     : conn_info_map_(bcc->GetHashTable<uint64_t, struct conn_info_t>("conn_info_map")),
-      conn_disabled_map_(bcc->GetHashTable<uint64_t, uint64_t>("conn_disabled_map")) {
+      conn_disabled_map_(bcc->GetHashTable<uint64_t, uint64_t>("conn_disabled_map")),
+      conn_data_skip_map_(
+          bcc->GetHashTable<uint64_t, struct conn_data_skip_t>("conn_data_skip_map")) {
   // Use address instead of symbol to specify this probe,
   // so that even if debug symbols are stripped, the uprobe can still attach.
   uint64_t symbol_addr = reinterpret_cast<uint64_t>(&ConnInfoMapCleanupTrigger);
@@ -77,6 +79,16 @@ void ConnInfoMapManager::Disable(struct conn_id_t conn_id) {
   }
 }
 
+void ConnInfoMapManager::SkipData(struct conn_id_t conn_id, const struct data_skip_range_t& send,
+                                  const struct data_skip_range_t& recv) {
+  uint64_t key = id(conn_id);
+  struct conn_data_skip_t data_skip = {conn_id.tsid, send, recv};
+
+  if (!conn_data_skip_map_.update_value(key, data_skip).ok()) {
+    VLOG(1) << absl::Substitute("$0 Updating conn_data_skip_map entry failed.", ToString(conn_id));
+  }
+}
+
 void ConnInfoMapManager::CleanupBPFMapLeaks(ConnTrackersManager* conn_trackers_mgr) {
   const auto& sysconfig = system::Config::GetInstance();
 
@@ -40,11 +40,16 @@ class ConnInfoMapManager {
 
   void Disable(struct conn_id_t conn_id);
 
+  // Tells BPF to only send the size of the data within the given ranges of the connection.
+  void SkipData(struct conn_id_t conn_id, const struct data_skip_range_t& send,
+                const struct data_skip_range_t& recv);
+
   void CleanupBPFMapLeaks(ConnTrackersManager* conn_trackers_mgr);
 
  private:
   ebpf::BPFHashTable<uint64_t, struct conn_info_t> conn_info_map_;
   ebpf::BPFHashTable<uint64_t, uint64_t> conn_disabled_map_;
+  ebpf::BPFHashTable<uint64_t, struct conn_data_skip_t> conn_data_skip_map_;
 
   std::vector<struct conn_id_t> pending_release_queue_;
 
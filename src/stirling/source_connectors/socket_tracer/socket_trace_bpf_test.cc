@@ -23,6 +23,7 @@
 #include <unistd.h>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 #include <magic_enum.hpp>
 
@@ -400,6 +401,130 @@ TEST_F(SocketTraceBPFTest, NoProtocolWritesNotCaptured) {
   EXPECT_TRUE(tracker->recv_data().data_buffer().empty());
 }
 
+// Tests that BPF drops the data of connections over their rate limit.
+TEST_F(SocketTraceBPFTest, ConnRateLimit) {
+  ConfigureBPFCapture(traffic_protocol_t::kProtocolHTTP, kRoleClient);
+  // Every message is larger than the burst size, so none get through.
+  ASSERT_OK(source_->SetConnSamplingAndRateLimit(/* sample_rate */ 1, /* rate_limit_bytes */ 1,
+                                                 /* rate_limit_burst_bytes */ 1));
+
+  testing::SendRecvScript script({
+      {{kHTTPReqMsg1}, {kHTTPRespMsg1}},
+  });
+
+  testing::ClientServerSystem system;
+  system.RunClientServer<&TCPSocket::Read, &TCPSocket::Write>(script);
+
+  source_->PollPerfBuffers();
+
+  ASSERT_OK_AND_ASSIGN(const auto* tracker, GetConnTracker(system.ClientPID(), system.ClientFD()));
+  EXPECT_TRUE(tracker->send_data().data_buffer().empty());
+  EXPECT_TRUE(tracker->recv_data().data_buffer().empty());
+}
+
+// Rate limits that do not fit the signed BPF control values would turn into "no limit".
+TEST_F(SocketTraceBPFTest, ConnRateLimitOutOfRange) {
+  constexpr uint64_t kTooLarge = uint64_t{1} << 63;
+  EXPECT_NOT_OK(source_->SetConnSamplingAndRateLimit(/* sample_rate */ 1, kTooLarge,
+                                                     /* rate_limit_burst_bytes */ 0));
+  EXPECT_NOT_OK(source_->SetConnSamplingAndRateLimit(/* sample_rate */ 1,
+                                                     /* rate_limit_bytes */ 1, kTooLarge));
+}
+
+// Mirrors is_conn_sampled() in socket_trace.c.
+bool IsConnSampled(const struct conn_id_t& conn_id, uint64_t sample_rate) {
+  uint64_t hash = (static_cast<uint64_t>(conn_id.upid.tgid) << 32) ^
+                  static_cast<uint32_t>(conn_id.fd) ^ conn_id.tsid;
+  hash *= 0x9E3779B97F4A7C15ULL;
+  return (hash >> 32) % sample_rate == 0;
+}
+
+// Tests that BPF only sends the data of the sampled connections.
+TEST_F(SocketTraceBPFTest, ConnSampling) {
+  constexpr uint32_t kSampleRate = 2;
+  ConfigureBPFCapture(traffic_protocol_t::kProtocolHTTP, kRoleClient);
+  ASSERT_OK(source_->SetConnSamplingAndRateLimit(kSampleRate, /* rate_limit_bytes */ 0,
+                                                 /* rate_limit_burst_bytes */ 0));
+
+  testing::SendRecvScript script({
+      {{kHTTPReqMsg1}, {kHTTPRespMsg1}},
+  });
+
+  // Which connections are sampled depends on their IDs, so keep making connections until both
+  // cases are seen.
+  bool saw_sampled = false;
+  bool saw_unsampled = false;
+  for (int i = 0; i < 32 && !(saw_sampled && saw_unsampled); ++i) {
+    testing::ClientServerSystem system;
+    system.RunClientServer<&TCPSocket::Read, &TCPSocket::Write>(script);
+
+    source_->PollPerfBuffers();
+
+    ASSERT_OK_AND_ASSIGN(const auto* tracker,
+                         GetConnTracker(system.ClientPID(), system.ClientFD()));
+    const bool sampled = IsConnSampled(tracker->conn_id(), kSampleRate);
+    EXPECT_EQ(tracker->send_data().data_buffer().empty(), !sampled);
+    EXPECT_EQ(tracker->recv_data().data_buffer().empty(), !sampled);
+    (sampled ? saw_sampled : saw_unsampled) = true;
+  }
+  EXPECT_TRUE(saw_sampled);
+  EXPECT_TRUE(saw_unsampled);
+}
+
+// Tests that every protocol table has the conn_sample_rate column, and that records carry the
+// sample rate in it.
+TEST_F(SocketTraceBPFTest, ConnSampleRateColumn) {
+  for (const auto& table : SocketTraceConnector::kTables) {
+    if (table.name() == kConnStatsTable.name()) {
+      continue;
+    }
+    SCOPED_TRACE(table.name());
+    int num_matches = 0;
+    for (const DataElement& element : table.elements()) {
+      if (element.name() == "conn_sample_rate") {
+        EXPECT_EQ(element.type(), types::DataType::INT64);
+        ++num_matches;
+      }
+    }
+    EXPECT_EQ(num_matches, 1);
+  }
+
+  constexpr uint32_t kSampleRate = 2;
+  constexpr int kHTTPConnSampleRateIdx = kHTTPTable.ColIndex("conn_sample_rate");
+  ConfigureBPFCapture(traffic_protocol_t::kProtocolHTTP, kRoleClient);
+  ASSERT_OK(source_->SetConnSamplingAndRateLimit(kSampleRate, /* rate_limit_bytes */ 0,
+                                                 /* rate_limit_burst_bytes */ 0));
+
+  StartTransferDataThread();
+
+  // Half of the connections are sampled, so some of them are all but certain to be.
+  testing::SendRecvScript script({
+      {{kHTTPReqMsg1}, {kHTTPRespMsg1}},
+  });
+  std::vector<uint32_t> client_pids;
+  for (int i = 0; i < 16; ++i) {
+    testing::ClientServerSystem system;
+    system.RunClientServer<&TCPSocket::Read, &TCPSocket::Write>(script);
+    client_pids.push_back(system.ClientPID());
+  }
+
+  StopTransferDataThread();
+
+  std::vector<TaggedRecordBatch> tablets = ConsumeRecords(kHTTPTableNum);
+  ASSERT_FALSE(tablets.empty());
+
+  int num_records = 0;
+  for (uint32_t pid : client_pids) {
+    ColumnWrapperRecordBatch records =
+        FindRecordsMatchingPID(tablets[0].records, kHTTPUPIDIdx, pid);
+    for (size_t i = 0; i < records[kHTTPConnSampleRateIdx]->Size(); ++i) {
+      EXPECT_EQ(records[kHTTPConnSampleRateIdx]->Get<types::Int64Value>(i).val, kSampleRate);
+      ++num_records;
+    }
+  }
+  EXPECT_GT(num_records, 0);
+}
+
 TEST_F(SocketTraceBPFTest, MultipleConnections) {
   ConfigureBPFCapture(traffic_protocol_t::kProtocolHTTP, kRoleClient);
 
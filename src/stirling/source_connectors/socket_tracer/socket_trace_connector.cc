@@ -22,7 +22,11 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <filesystem>
+#include <limits>
+#include <string>
+#include <tuple>
 #include <utility>
 
 #include <absl/container/flat_hash_map.h>
@@ -69,6 +73,10 @@ DEFINE_string(socket_trace_data_events_output_path, "",
               "writes data events. If the filename ends with '.bin', the events are serialized in "
               "binary format; otherwise, text format.");
 
+DEFINE_bool(stirling_socket_tracer_batch_events, true,
+            "If true, the data and HTTP2 events of a perf buffer poll cycle are grouped by "
+            "connection before they are handed to the connection trackers.");
+
 // PROTOCOL_LIST: Requires update on new protocols.
 DEFINE_bool(stirling_enable_http_tracing, true,
             "If true, stirling will trace and process HTTP messages");
@@ -95,6 +103,20 @@ DEFINE_bool(stirling_enable_mux_tracing,
 DEFINE_bool(stirling_disable_self_tracing, true,
             "If true, stirling will not trace and process syscalls made by itself.");
 
+DEFINE_uint32(stirling_conn_sample_rate,
+              gflags::Uint32FromEnv("PL_STIRLING_CONN_SAMPLE_RATE", 1),
+              "Trace the data of 1 in this many connections, picked by a hash of the connection. "
+              "Records carry the rate in their conn_sample_rate column, to scale counts back up. "
+              "Connection stats are not sampled.");
+DEFINE_uint64(stirling_conn_rate_limit_bytes,
+              gflags::Uint64FromEnv("PL_STIRLING_CONN_RATE_LIMIT_BYTES", 0),
+              "Limit on the bytes/sec of data traced per connection. Data over the limit is "
+              "dropped in BPF. 0 means no limit.");
+DEFINE_uint64(stirling_conn_rate_limit_burst_bytes,
+              gflags::Uint64FromEnv("PL_STIRLING_CONN_RATE_LIMIT_BURST_BYTES", 0),
+              "Burst size in bytes of the per connection rate limit. 0 means one second of data "
+              "at the rate limit.");
+
 // Assume a moderate default network bandwidth peak of 100MiB/s across socket connections for data.
 DEFINE_uint32(stirling_socket_tracer_target_data_bw_percpu, 100 * 1024 * 1024,
               "Target bytes/sec of data per CPU");
@@ -144,7 +166,12 @@ using ::px::stirling::protocols::kMaxBodyBytes;
 using ::px::utils::ToJSONString;
 
 SocketTraceConnector::SocketTraceConnector(std::string_view source_name)
-    : SourceConnector(source_name, kTables), conn_stats_(&conn_trackers_mgr_), uprobe_mgr_(this) {
+    : SourceConnector(source_name, kTables),
+      data_event_pool_(kMaxEventPoolSize),
+      http2_header_event_pool_(kMaxEventPoolSize),
+      http2_data_event_pool_(kMaxEventPoolSize),
+      conn_stats_(&conn_trackers_mgr_),
+      uprobe_mgr_(this) {
   proc_parser_ = std::make_unique<system::ProcParser>(system::Config::GetInstance());
   InitProtocolTransferSpecs();
 }
@@ -395,6 +422,9 @@ Status SocketTraceConnector::InitBPF() {
   if (FLAGS_stirling_disable_self_tracing) {
     PL_RETURN_IF_ERROR(DisableSelfTracing());
   }
+  PL_RETURN_IF_ERROR(SetConnSamplingAndRateLimit(FLAGS_stirling_conn_sample_rate,
+                                                 FLAGS_stirling_conn_rate_limit_bytes,
+                                                 FLAGS_stirling_conn_rate_limit_burst_bytes));
   if (!FLAGS_socket_trace_data_events_output_path.empty()) {
     SetupOutput(FLAGS_socket_trace_data_events_output_path);
   }
@@ -672,16 +702,50 @@ Status SocketTraceConnector::DisableSelfTracing() {
   return UpdatePerCPUArrayValue(kStirlingTGIDIndex, self_pid, &control_map_handle);
 }
 
+Status SocketTraceConnector::SetConnSamplingAndRateLimit(uint32_t sample_rate,
+                                                         uint64_t rate_limit_bytes,
+                                                         uint64_t rate_limit_burst_bytes) {
+  // Larger values would wrap around to negative control values, which BPF reads as no limit.
+  constexpr uint64_t kMaxRateLimitBytes = std::numeric_limits<int64_t>::max();
+  if (rate_limit_bytes > kMaxRateLimitBytes || rate_limit_burst_bytes > kMaxRateLimitBytes) {
+    return error::InvalidArgument(
+        "Connection rate limit of $0 bytes/sec with $1 burst bytes exceeds the maximum of $2.",
+        rate_limit_bytes, rate_limit_burst_bytes, kMaxRateLimitBytes);
+  }
+
+  auto control_map_handle = GetPerCPUArrayTable<int64_t>(kControlValuesArrayName);
+  PL_RETURN_IF_ERROR(UpdatePerCPUArrayValue(kConnSampleRateIndex,
+                                            static_cast<int64_t>(sample_rate),
+                                            &control_map_handle));
+  PL_RETURN_IF_ERROR(UpdatePerCPUArrayValue(
+      kConnRateLimitBytesIndex, static_cast<int64_t>(rate_limit_bytes), &control_map_handle));
+  PL_RETURN_IF_ERROR(UpdatePerCPUArrayValue(kConnRateLimitBurstBytesIndex,
+                                            static_cast<int64_t>(rate_limit_burst_bytes),
+                                            &control_map_handle));
+  conn_sample_rate_ = std::max<int64_t>(sample_rate, 1);
+  return Status::OK();
+}
+
 //-----------------------------------------------------------------------------
 // Perf Buffer Polling and Callback functions.
 //-----------------------------------------------------------------------------
 
+void SocketTraceConnector::PollPerfBuffers(int timeout_ms) {
+  BCCWrapper::PollPerfBuffers(timeout_ms);
+  DispatchEventBatch();
+}
+
 void SocketTraceConnector::HandleDataEvent(void* cb_cookie, void* data, int data_size) {
   DCHECK(cb_cookie != nullptr) << "Perf buffer callback not set-up properly. Missing cb_cookie.";
   auto* connector = static_cast<SocketTraceConnector*>(cb_cookie);
-  auto data_event_ptr = std::make_unique<SocketDataEvent>(data);
   connector->stats_.Increment(StatKey::kPollSocketDataEventSize, data_size);
-  connector->AcceptDataEvent(std::move(data_event_ptr));
+  if (!FLAGS_stirling_socket_tracer_batch_events) {
+    connector->AcceptDataEvent(std::make_unique<SocketDataEvent>(data));
+    return;
+  }
+  std::unique_ptr<SocketDataEvent> data_event_ptr = connector->data_event_pool_.Pop();
+  data_event_ptr->Assign(data);
+  connector->BatchDataEvent(std::move(data_event_ptr));
 }
 
 void SocketTraceConnector::HandleDataEventLoss(void* cb_cookie, uint64_t lost) {
@@ -738,7 +802,8 @@ void SocketTraceConnector::HandleHTTP2Event(void* cb_cookie, void* data, int /*d
   switch (event_type) {
     case kHeaderEventRead:
     case kHeaderEventWrite: {
-      auto event = std::make_unique<HTTP2HeaderEvent>(data);
+      std::unique_ptr<HTTP2HeaderEvent> event = connector->http2_header_event_pool_.Pop();
+      event->Assign(data);
 
       VLOG(3) << absl::Substitute(
           "t=$0 pid=$1 type=$2 fd=$3 tsid=$4 stream_id=$5 end_stream=$6 name=$7 value=$8",
@@ -746,18 +811,27 @@ void SocketTraceConnector::HandleHTTP2Event(void* cb_cookie, void* data, int /*d
           magic_enum::enum_name(event->attr.event_type), event->attr.conn_id.fd,
           event->attr.conn_id.tsid, event->attr.stream_id, event->attr.end_stream, event->name,
           event->value);
-      connector->AcceptHTTP2Header(std::move(event));
+      if (FLAGS_stirling_socket_tracer_batch_events) {
+        connector->BatchHTTP2Header(std::move(event));
+      } else {
+        connector->AcceptHTTP2Header(std::move(event));
+      }
     } break;
     case kDataFrameEventRead:
     case kDataFrameEventWrite: {
-      auto event = std::make_unique<HTTP2DataEvent>(data);
+      std::unique_ptr<HTTP2DataEvent> event = connector->http2_data_event_pool_.Pop();
+      event->Assign(data);
 
       VLOG(3) << absl::Substitute(
           "t=$0 pid=$1 type=$2 fd=$3 tsid=$4 stream_id=$5 end_stream=$6 data=$7",
           event->attr.timestamp_ns, event->attr.conn_id.upid.pid,
           magic_enum::enum_name(event->attr.event_type), event->attr.conn_id.fd,
           event->attr.conn_id.tsid, event->attr.stream_id, event->attr.end_stream, event->payload);
-      connector->AcceptHTTP2Data(std::move(event));
+      if (FLAGS_stirling_socket_tracer_batch_events) {
+        connector->BatchHTTP2Data(std::move(event));
+      } else {
+        connector->AcceptHTTP2Data(std::move(event));
+      }
     } break;
     default:
       LOG(DFATAL) << absl::Substitute("Unexpected event_type $0",
@@ -781,14 +855,18 @@ ConnTracker& SocketTraceConnector::GetOrCreateConnTracker(struct conn_id_t conn_
   return tracker;
 }
 
-void SocketTraceConnector::AcceptDataEvent(std::unique_ptr<SocketDataEvent> event) {
+void SocketTraceConnector::RecordDataEvent(const SocketDataEvent& event) {
   if (perf_buffer_events_output_stream_ != nullptr) {
-    WriteDataEvent(*event);
+    WriteDataEvent(event);
   }
 
   stats_.Increment(StatKey::kPollSocketDataEventCount);
-  stats_.Increment(StatKey::kPollSocketDataEventAttrSize, sizeof(event->attr));
-  stats_.Increment(StatKey::kPollSocketDataEventDataSize, event->msg.size());
+  stats_.Increment(StatKey::kPollSocketDataEventAttrSize, sizeof(event.attr));
+  stats_.Increment(StatKey::kPollSocketDataEventDataSize, event.msg.size());
+}
+
+void SocketTraceConnector::AcceptDataEvent(std::unique_ptr<SocketDataEvent> event) {
+  RecordDataEvent(*event);
 
   ConnTracker& tracker = GetOrCreateConnTracker(event->attr.conn_id);
   tracker.AddDataEvent(std::move(event));
@@ -814,6 +892,79 @@ void SocketTraceConnector::AcceptHTTP2Data(std::unique_ptr<HTTP2DataEvent> event
   tracker.AddHTTP2Data(std::move(event));
 }
 
+void SocketTraceConnector::BatchDataEvent(std::unique_ptr<SocketDataEvent> event) {
+  RecordDataEvent(*event);
+
+  BatchedEvent& batched = event_batch_.emplace_back();
+  batched.conn_id = event->attr.conn_id;
+  batched.data_event = std::move(event);
+}
+
+void SocketTraceConnector::BatchHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> event) {
+  BatchedEvent& batched = event_batch_.emplace_back();
+  batched.conn_id = event->attr.conn_id;
+  batched.http2_header = std::move(event);
+}
+
+void SocketTraceConnector::BatchHTTP2Data(std::unique_ptr<HTTP2DataEvent> event) {
+  BatchedEvent& batched = event_batch_.emplace_back();
+  batched.conn_id = event->attr.conn_id;
+  batched.http2_data = std::move(event);
+}
+
+namespace {
+
+bool ConnIDLess(const struct conn_id_t& a, const struct conn_id_t& b) {
+  return std::tie(a.upid.tgid, a.upid.start_time_ticks, a.fd, a.tsid) <
+         std::tie(b.upid.tgid, b.upid.start_time_ticks, b.fd, b.tsid);
+}
+
+// Frees the buffer of a string of a recycled event if it is larger than max_bytes, so that the
+// rare large events do not stay pinned in the event pools.
+void ReleaseLargeBuffer(size_t max_bytes, std::string* buf) {
+  if (buf->capacity() > max_bytes) {
+    std::string().swap(*buf);
+  }
+}
+
+}  // namespace
+
+void SocketTraceConnector::DispatchEventBatch() {
+  if (event_batch_.empty()) {
+    return;
+  }
+
+  // A stable sort keeps the events of each connection in the order they were polled.
+  std::stable_sort(event_batch_.begin(), event_batch_.end(),
+                   [](const BatchedEvent& a, const BatchedEvent& b) {
+                     return ConnIDLess(a.conn_id, b.conn_id);
+                   });
+
+  ConnTracker* tracker = nullptr;
+  for (size_t i = 0; i < event_batch_.size(); ++i) {
+    BatchedEvent& batched = event_batch_[i];
+    if (i == 0 || batched.conn_id != event_batch_[i - 1].conn_id) {
+      tracker = &GetOrCreateConnTracker(batched.conn_id);
+    }
+
+    if (batched.data_event != nullptr) {
+      tracker->AddDataEvent(*batched.data_event);
+      ReleaseLargeBuffer(kMaxPooledBufferBytes, &batched.data_event->msg);
+      data_event_pool_.Recycle(std::move(batched.data_event));
+    } else if (batched.http2_header != nullptr) {
+      tracker->AddHTTP2Header(batched.http2_header.get());
+      ReleaseLargeBuffer(kMaxPooledBufferBytes, &batched.http2_header->name);
+      ReleaseLargeBuffer(kMaxPooledBufferBytes, &batched.http2_header->value);
+      http2_header_event_pool_.Recycle(std::move(batched.http2_header));
+    } else if (batched.http2_data != nullptr) {
+      tracker->AddHTTP2Data(*batched.http2_data);
+      ReleaseLargeBuffer(kMaxPooledBufferBytes, &batched.http2_data->payload);
+      http2_data_event_pool_.Recycle(std::move(batched.http2_data));
+    }
+  }
+  event_batch_.clear();
+}
+
 //-----------------------------------------------------------------------------
 // Append-Related Functions
 //-----------------------------------------------------------------------------
@@ -874,6 +1025,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("resp_body"), kMaxBodyBytes>(std::move(resp_message.body));
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(req_message.timestamp_ns, resp_message.timestamp_ns));
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -945,6 +1097,8 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   // TODO(yzhao): Remove once http2::Record::bpf_timestamp_ns is removed.
   LOG_IF_EVERY_N(WARNING, latency_ns < 0, 100)
       << absl::Substitute("Negative latency found in HTTP2 records, record=$0", record.ToString());
+  // The HTTP2 uprobes trace all connections.
+  r.Append<r.ColIndex("conn_sample_rate")>(1);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -968,6 +1122,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("resp_body"), kMaxBodyBytes>(std::move(entry.resp.msg));
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(entry.req.timestamp_ns, entry.resp.timestamp_ns));
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -991,6 +1146,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("resp_body"), kMaxBodyBytes>(std::move(entry.resp.msg));
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(entry.req.timestamp_ns, entry.resp.timestamp_ns));
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -1014,6 +1170,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("resp_body")>(entry.resp.msg);
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(entry.req.timestamp_ns, entry.resp.timestamp_ns));
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -1036,6 +1193,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(entry.req.timestamp_ns, entry.resp.timestamp_ns));
   r.Append<r.ColIndex("req_cmd")>(ToString(entry.req.tag, /* is_req */ true));
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -1056,6 +1214,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("req_type")>(entry.req.type);
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(entry.req.timestamp_ns, entry.resp.timestamp_ns));
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -1100,6 +1259,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("resp")>(std::string(entry.resp.payload));
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(entry.req.timestamp_ns, entry.resp.timestamp_ns));
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -1121,6 +1281,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("cmd")>(record.req.command);
   r.Append<r.ColIndex("body")>(record.req.options);
   r.Append<r.ColIndex("resp")>(record.resp.command);
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -1147,6 +1308,7 @@ void SocketTraceConnector::AppendMessage(ConnectorContext* ctx, const ConnTracke
   r.Append<r.ColIndex("resp"), kMaxKafkaBodyBytes>(std::move(record.resp.msg));
   r.Append<r.ColIndex("latency")>(
       CalculateLatency(record.req.timestamp_ns, record.resp.timestamp_ns));
+  r.Append<r.ColIndex("conn_sample_rate")>(conn_sample_rate_);
 #ifndef NDEBUG
   r.Append<r.ColIndex("px_info_")>(ToString(conn_tracker.conn_id()));
 #endif
@@ -44,12 +44,14 @@
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_bpf_tables.h"
 #include "src/stirling/source_connectors/socket_tracer/socket_trace_tables.h"
 #include "src/stirling/source_connectors/socket_tracer/uprobe_manager.h"
+#include "src/stirling/utils/obj_pool.h"
 #include "src/stirling/utils/proc_path_tools.h"
 #include "src/stirling/utils/proc_tracker.h"
 
 DECLARE_uint32(stirling_conn_stats_sampling_ratio);
 DECLARE_bool(stirling_enable_periodic_bpf_map_cleanup);
 DECLARE_string(socket_trace_data_events_output_path);
+DECLARE_bool(stirling_socket_tracer_batch_events);
 DECLARE_bool(stirling_enable_http_tracing);
 DECLARE_bool(stirling_enable_http2_tracing);
 DECLARE_bool(stirling_enable_mysql_tracing);
@@ -60,6 +62,9 @@ DECLARE_bool(stirling_enable_nats_tracing);
 DECLARE_bool(stirling_enable_kafka_tracing);
 DECLARE_bool(stirling_enable_mux_tracing);
 DECLARE_bool(stirling_disable_self_tracing);
+DECLARE_uint32(stirling_conn_sample_rate);
+DECLARE_uint64(stirling_conn_rate_limit_bytes);
+DECLARE_uint64(stirling_conn_rate_limit_burst_bytes);
 DECLARE_string(stirling_role_to_trace);
 
 DECLARE_uint32(stirling_socket_tracer_target_data_bw_percpu);
@@ -111,6 +116,10 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // That would then cause performance overheads.
   void UpdateCommonState(ConnectorContext* ctx);
 
+  // Drains all perf buffers, like BCCWrapper::PollPerfBuffers(), and then hands the batch of
+  // data and HTTP2 events that were polled to their ConnTrackers.
+  void PollPerfBuffers(int timeout_ms = 0);
+
   // Updates control map value for protocol, which specifies which role(s) to trace for the given
   // protocol's traffic.
   //
@@ -119,6 +128,10 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   Status UpdateBPFProtocolTraceRole(traffic_protocol_t protocol, uint64_t role_mask);
   Status TestOnlySetTargetPID(int64_t pid);
   Status DisableSelfTracing();
+  // Sets the connection sampling rate and the per-connection rate limit on traced data in BPF.
+  // The BPF control values are signed, so rate limits above INT64_MAX are rejected.
+  Status SetConnSamplingAndRateLimit(uint32_t sample_rate, uint64_t rate_limit_bytes,
+                                     uint64_t rate_limit_burst_bytes);
 
   void DisablePIDTrace(int pid) override {
     SourceConnector::DisablePIDTrace(pid);
@@ -155,6 +168,12 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // Protobuf printer will limit strings to this length.
   inline static constexpr size_t kMaxPBStringLen = 64;
 
+  // The maximum number of recycled events held by each event pool.
+  inline static constexpr size_t kMaxEventPoolSize = 1024;
+  // Recycled events keep the buffers of their strings only up to this capacity, and larger
+  // buffers are freed. So each string field of a pool retains at most 4MB.
+  inline static constexpr size_t kMaxPooledBufferBytes = 4 * 1024;
+
   explicit SocketTraceConnector(std::string_view source_name);
 
   Status InitBPF();
@@ -170,6 +189,18 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   void AcceptHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> event);
   void AcceptHTTP2Data(std::unique_ptr<HTTP2DataEvent> event);
 
+  // Records a data event in the stats and in the output file, if any.
+  void RecordDataEvent(const SocketDataEvent& event);
+
+  // Batched dispatch of the events from the perf buffers: a poll cycle of events is grouped by
+  // connection, so that each ConnTracker is looked up once per poll cycle rather than once per
+  // event, and the events are recycled once their contents are handed to the ConnTracker.
+  // Events of a connection keep their order.
+  void BatchDataEvent(std::unique_ptr<SocketDataEvent> event);
+  void BatchHTTP2Header(std::unique_ptr<HTTP2HeaderEvent> event);
+  void BatchHTTP2Data(std::unique_ptr<HTTP2DataEvent> event);
+  void DispatchEventBatch();
+
   template <typename TProtocolTraits>
   void TransferStream(ConnectorContext* ctx, ConnTracker* tracker, DataTable* data_table);
   void TransferConnStats(ConnectorContext* ctx, DataTable* data_table);
@@ -183,8 +214,8 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   void UpdateTrackerTraceLevel(ConnTracker* tracker);
 
   template <typename TRecordType>
-  static void AppendMessage(ConnectorContext* ctx, const ConnTracker& conn_tracker,
-                            TRecordType record, DataTable* data_table);
+  void AppendMessage(ConnectorContext* ctx, const ConnTracker& conn_tracker, TRecordType record,
+                     DataTable* data_table);
 
   std::thread RunDeployUProbesThread(const absl::flat_hash_set<md::UPID>& pids);
 
@@ -196,10 +227,29 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   ConnTrackersManager conn_trackers_mgr_;
 
+  // Pools of events, which are recycled with their buffers after being dispatched.
+  ReusableObjPool<SocketDataEvent> data_event_pool_;
+  ReusableObjPool<HTTP2HeaderEvent> http2_header_event_pool_;
+  ReusableObjPool<HTTP2DataEvent> http2_data_event_pool_;
+
+  // An event polled from the perf buffers, waiting for DispatchEventBatch().
+  // Exactly one of the events is set.
+  struct BatchedEvent {
+    struct conn_id_t conn_id;
+    std::unique_ptr<SocketDataEvent> data_event;
+    std::unique_ptr<HTTP2HeaderEvent> http2_header;
+    std::unique_ptr<HTTP2DataEvent> http2_data;
+  };
+  std::vector<BatchedEvent> event_batch_;
+
   ConnStats conn_stats_;
 
   absl::flat_hash_set<int> pids_to_trace_disable_;
 
+  // BPF traces the data of 1 in this many connections. Recorded in the records, so that counts
+  // can be scaled back up.
+  int64_t conn_sample_rate_ = 1;
+
   struct TransferSpec {
     // TODO(yzhao): Enabling protocol is essentially equivalent to subscribing to DataTable. They
     // could be unified.
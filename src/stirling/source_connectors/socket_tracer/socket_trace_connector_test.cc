@@ -46,6 +46,7 @@ namespace cass = protocols::cass;
 
 using ::testing::Each;
 using ::testing::ElementsAre;
+using ::testing::UnorderedElementsAre;
 
 using ::px::stirling::testing::ColWrapperSizeIs;
 
@@ -271,6 +272,52 @@ TEST_F(SocketTraceConnectorTest, HTTPBasic) {
   EXPECT_THAT(ToStringVector(record_batch[kHTTPRespBodyIdx]), ElementsAre("foo"));
 }
 
+// Packs an event back into the layout that BPF submits to the perf buffer.
+socket_data_event_t ToPerfBufferEvent(const SocketDataEvent& event) {
+  socket_data_event_t raw_event = {};
+  raw_event.attr = event.attr;
+  event.msg.copy(raw_event.msg, event.msg.size());
+  return raw_event;
+}
+
+// Tests that the events of a perf buffer poll cycle are dispatched to their connections in order,
+// when they are batched and the events of different connections are interleaved.
+TEST_F(SocketTraceConnectorTest, HTTPBatchedEvents) {
+  PL_SET_FOR_SCOPE(FLAGS_stirling_socket_tracer_batch_events, true);
+
+  testing::EventGenerator event_gen0(&mock_clock_, kPID, kFD);
+  testing::EventGenerator event_gen1(&mock_clock_, kPID, kFD + 1);
+  struct socket_control_event_t conn0 = event_gen0.InitConn();
+  struct socket_control_event_t conn1 = event_gen1.InitConn();
+  source_->AcceptControlEvent(conn0);
+  source_->AcceptControlEvent(conn1);
+
+  // Events are recycled after each poll cycle, so the second round reuses the first's events.
+  for (int i = 0; i < 2; ++i) {
+    std::vector<socket_data_event_t> raw_events;
+    raw_events.push_back(ToPerfBufferEvent(*event_gen0.InitSendEvent<kProtocolHTTP>(kReq0)));
+    raw_events.push_back(ToPerfBufferEvent(*event_gen1.InitSendEvent<kProtocolHTTP>(kReq1)));
+    raw_events.push_back(ToPerfBufferEvent(*event_gen1.InitRecvEvent<kProtocolHTTP>(kResp1)));
+    raw_events.push_back(ToPerfBufferEvent(*event_gen0.InitRecvEvent<kProtocolHTTP>(kResp0)));
+    for (auto& raw_event : raw_events) {
+      source_->HandleDataEvent(&raw_event, sizeof(raw_event.attr) + raw_event.attr.msg_size);
+    }
+
+    // The batch is dispatched when the perf buffers are polled.
+    connector_->TransferData(ctx_.get(), data_tables_->tables());
+
+    std::vector<TaggedRecordBatch> tablets = http_table_->ConsumeRecords();
+    ASSERT_FALSE(tablets.empty());
+    RecordBatch record_batch = tablets[0].records;
+
+    EXPECT_THAT(record_batch, Each(ColWrapperSizeIs(2)));
+    EXPECT_THAT(ToStringVector(record_batch[kHTTPReqPathIdx]),
+                UnorderedElementsAre("/index.html", "/data.html"));
+    EXPECT_THAT(ToStringVector(record_batch[kHTTPRespBodyIdx]),
+                UnorderedElementsAre("foo", "bar"));
+  }
+}
+
 TEST_F(SocketTraceConnectorTest, HTTPDelayedRespBody) {
   testing::EventGenerator event_gen(&real_clock_);
   struct socket_control_event_t conn = event_gen.InitConn();
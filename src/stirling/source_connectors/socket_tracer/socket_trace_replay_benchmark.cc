@@ -0,0 +1,169 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/common/perf/memory_tracker.h"
+#include "src/common/perf/tcmalloc.h"
+#include "src/stirling/source_connectors/socket_tracer/socket_trace_connector.h"
+#include "src/stirling/source_connectors/socket_tracer/testing/benchmark_data_gen/data_gen.h"
+#include "src/stirling/source_connectors/socket_tracer/testing/benchmark_data_gen/generators.h"
+#include "src/stirling/source_connectors/socket_tracer/testing/capture_replay.h"
+#include "src/stirling/testing/common.h"
+
+DEFINE_string(capture, "",
+              "A binary capture of data events to replay, written by the socket tracer with "
+              "--socket_trace_data_events_output_path=<path>.bin. If empty, a generated capture "
+              "with HTTP, MySQL, PostgreSQL, CQL and NATS connections is replayed.");
+
+using ::benchmark::Counter;
+using ::px::MemoryStats;
+using ::px::MemoryTracker;
+using ::px::stirling::SocketTraceConnector;
+using ::px::stirling::testing::BenchmarkDataGenerationSpec;
+using ::px::stirling::testing::CaptureReplayer;
+using ::px::stirling::testing::CQLQueryReqRespGen;
+using ::px::stirling::testing::EventCapture;
+using ::px::stirling::testing::GenerateBenchmarkData;
+using ::px::stirling::testing::HTTP1SingleReqRespGen;
+using ::px::stirling::testing::MySQLExecuteReqRespGen;
+using ::px::stirling::testing::NATSMSGGen;
+using ::px::stirling::testing::NoGapsPosGenerator;
+using ::px::stirling::testing::PostgresSelectReqRespGen;
+using ::px::stirling::testing::ReadEventCapture;
+using ::px::stirling::testing::ReadEventCaptureFile;
+using ::px::stirling::testing::RecordGenFunc;
+using ::px::stirling::testing::ReplayStats;
+using ::px::stirling::testing::WriteCapturedEvent;
+
+namespace {
+
+constexpr uint64_t kRecordSize = 4 * 1024;
+constexpr size_t kNumPollIterations = 5;
+
+// Generates a capture in which each protocol has its own process, and the connections of all the
+// processes are interleaved in each poll iteration, as they would be in the perf buffers.
+std::string GenerateCapture() {
+  const std::vector<std::pair<traffic_protocol_t, RecordGenFunc>> protocols = {
+      {kProtocolHTTP, []() { return std::make_unique<HTTP1SingleReqRespGen>(kRecordSize); }},
+      {kProtocolMySQL, []() { return std::make_unique<MySQLExecuteReqRespGen>(kRecordSize); }},
+      {kProtocolPGSQL, []() { return std::make_unique<PostgresSelectReqRespGen>(kRecordSize); }},
+      {kProtocolCQL, []() { return std::make_unique<CQLQueryReqRespGen>(kRecordSize); }},
+      {kProtocolNATS, []() { return std::make_unique<NATSMSGGen>(kRecordSize); }},
+  };
+  constexpr uint64_t kIterNS =
+      std::chrono::nanoseconds(SocketTraceConnector::kSamplingPeriod).count();
+
+  std::vector<std::vector<socket_data_event_t>> per_iter_events(kNumPollIterations);
+  for (size_t i = 0; i < protocols.size(); ++i) {
+    auto generated_data = GenerateBenchmarkData(BenchmarkDataGenerationSpec{
+        .num_conns = 10,
+        .num_poll_iterations = kNumPollIterations,
+        .records_per_conn = 8,
+        .protocol = protocols[i].first,
+        .role = kRoleServer,
+        .rec_gen_func = protocols[i].second,
+        .pos_gen_func = []() { return std::make_unique<NoGapsPosGenerator>(); },
+    });
+    for (size_t iter = 0; iter < kNumPollIterations; ++iter) {
+      for (auto& event : generated_data.per_iter_data_events[iter]) {
+        event.attr.conn_id.upid.pid += i;
+        event.attr.timestamp_ns = iter * kIterNS;
+        per_iter_events[iter].push_back(event);
+      }
+    }
+  }
+
+  std::ostringstream out;
+  for (auto& iter_events : per_iter_events) {
+    std::stable_sort(iter_events.begin(), iter_events.end(),
+                     [](const auto& a, const auto& b) { return a.attr.pos < b.attr.pos; });
+    for (const auto& event : iter_events) {
+      WriteCapturedEvent(event, &out);
+    }
+  }
+  return out.str();
+}
+
+const EventCapture& GetCapture() {
+  static const EventCapture* capture = []() {
+    if (!FLAGS_capture.empty()) {
+      return new EventCapture(ReadEventCaptureFile(FLAGS_capture).ConsumeValueOrDie());
+    }
+    std::istringstream in(GenerateCapture());
+    return new EventCapture(ReadEventCapture(&in));
+  }();
+  return *capture;
+}
+
+}  // namespace
+
+// Replays a capture end-to-end: through the perf buffer callback, the ConnTrackers, the parsers
+// and the stitchers, into the DataTables. The events of a poll iteration are batched by connection
+// (arg 1) or handed to their ConnTrackers one by one (arg 0).
+// NOLINTNEXTLINE: runtime/references.
+static void BM_ReplayCapture(benchmark::State& state) {
+  PL_SET_FOR_SCOPE(FLAGS_stirling_socket_tracer_batch_events, state.range(0) != 0);
+
+  const EventCapture& capture = GetCapture();
+  ReplayStats stats;
+  MemoryStats mem_stats;
+  // Only measure memory on the first iteration, like BM_SocketTraceConnector.
+  bool is_first_iter = true;
+  for (auto _ : state) {
+    state.PauseTiming();
+    {
+      CaptureReplayer replayer;
+      MemoryTracker mem_tracker(is_first_iter);
+      if (is_first_iter) {
+        mem_tracker.Start();
+      }
+      state.ResumeTiming();
+
+      stats = replayer.Replay(capture);
+
+      state.PauseTiming();
+      if (is_first_iter) {
+        mem_stats = mem_tracker.End();
+      }
+    }
+    px::ReleaseFreeMemory();
+    is_first_iter = false;
+    state.ResumeTiming();
+  }
+
+  state.SetBytesProcessed(stats.data_size_bytes * state.iterations());
+  state.counters["Events"] = Counter(stats.num_events, Counter::kIsIterationInvariantRate);
+  for (const auto& [table_name, num_records] : stats.records_per_table) {
+    state.counters["Records:" + table_name] =
+        Counter(num_records, Counter::kIsIterationInvariantRate);
+  }
+  state.counters["AllocPeak"] = Counter(mem_stats.max.allocated - mem_stats.start.allocated,
+                                        Counter::kDefaults, Counter::OneK::kIs1024);
+}
+
+BENCHMARK(BM_ReplayCapture)->ArgName("batched")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/testing/capture_replay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/util/delimited_message_util.h>
+
+#include "src/stirling/source_connectors/socket_tracer/proto/sock_event.pb.h"
+#include "src/stirling/source_connectors/socket_tracer/socket_trace_connector.h"
+
+namespace px {
+namespace stirling {
+namespace testing {
+
+EventCapture ReadEventCapture(std::istream* in) {
+  constexpr uint64_t kIterNS =
+      std::chrono::nanoseconds(SocketTraceConnector::kSamplingPeriod).count();
+
+  EventCapture capture;
+  google::protobuf::io::IstreamInputStream input(in);
+  sockeventpb::SocketDataEvent pb;
+  uint64_t first_timestamp_ns = 0;
+  uint64_t iter_end_ns = 0;
+  while (google::protobuf::util::ParseDelimitedFromZeroCopyStream(&pb, &input, nullptr)) {
+    const auto& attr = pb.attr();
+    if (capture.num_events == 0) {
+      first_timestamp_ns = attr.timestamp_ns();
+    }
+    const uint64_t timestamp_ns = attr.timestamp_ns() - first_timestamp_ns + 1;
+    if (capture.per_iter_events.empty() || timestamp_ns >= iter_end_ns) {
+      capture.per_iter_events.emplace_back();
+      iter_end_ns = timestamp_ns + kIterNS;
+    }
+
+    CapturedEvent& event = capture.per_iter_events.back().emplace_back();
+    event.attr = {};
+    event.attr.timestamp_ns = timestamp_ns;
+    event.attr.conn_id.upid.pid = attr.conn_id().pid();
+    event.attr.conn_id.upid.start_time_ticks = attr.conn_id().start_time_ns();
+    event.attr.conn_id.fd = attr.conn_id().fd();
+    event.attr.conn_id.tsid = attr.conn_id().generation();
+    event.attr.protocol = static_cast<traffic_protocol_t>(attr.protocol());
+    event.attr.role = static_cast<endpoint_role_t>(attr.role());
+    event.attr.direction = static_cast<traffic_direction_t>(attr.direction());
+    event.attr.pos = attr.pos();
+    // BPF never submits more than the size of its message buffer.
+    event.msg = pb.msg().substr(0, MAX_MSG_SIZE);
+    event.attr.msg_buf_size = event.msg.size();
+    event.attr.msg_size = std::max<uint32_t>(attr.msg_size(), event.attr.msg_buf_size);
+
+    ++capture.num_events;
+    capture.data_size_bytes += event.attr.msg_buf_size;
+  }
+  return capture;
+}
+
+StatusOr<EventCapture> ReadEventCaptureFile(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in.good()) {
+    return error::NotFound("Could not open capture file $0.", path.string());
+  }
+  return ReadEventCapture(&in);
+}
+
+void WriteCapturedEvent(const socket_data_event_t& event, std::ostream* out) {
+  sockeventpb::SocketDataEvent pb;
+  pb.mutable_attr()->set_timestamp_ns(event.attr.timestamp_ns);
+  pb.mutable_attr()->mutable_conn_id()->set_pid(event.attr.conn_id.upid.pid);
+  pb.mutable_attr()->mutable_conn_id()->set_start_time_ns(event.attr.conn_id.upid.start_time_ticks);
+  pb.mutable_attr()->mutable_conn_id()->set_fd(event.attr.conn_id.fd);
+  pb.mutable_attr()->mutable_conn_id()->set_generation(event.attr.conn_id.tsid);
+  pb.mutable_attr()->set_protocol(event.attr.protocol);
+  pb.mutable_attr()->set_role(event.attr.role);
+  pb.mutable_attr()->set_direction(event.attr.direction);
+  pb.mutable_attr()->set_pos(event.attr.pos);
+  pb.mutable_attr()->set_msg_size(event.attr.msg_size);
+  pb.set_msg(event.msg, event.attr.msg_buf_size);
+  google::protobuf::util::SerializeDelimitedToOstream(pb, out);
+}
+
+CaptureReplayer::CaptureReplayer()
+    : connector_(SocketTraceConnectorFriend::Create("socket_trace_connector")),
+      source_(static_cast<SocketTraceConnectorFriend*>(connector_.get())),
+      data_tables_(std::make_unique<DataTables>(SocketTraceConnector::kTables)) {}
+
+ReplayStats CaptureReplayer::Replay(const EventCapture& capture) {
+  ReplayStats stats;
+  for (const auto& iter_events : capture.per_iter_events) {
+    for (const auto& event : iter_events) {
+      perf_buffer_data_.resize(sizeof(event.attr) + event.msg.size());
+      std::memcpy(perf_buffer_data_.data(), &event.attr, sizeof(event.attr));
+      std::memcpy(perf_buffer_data_.data() + sizeof(event.attr), event.msg.data(),
+                  event.msg.size());
+      source_->HandleDataEvent(reinterpret_cast<socket_data_event_t*>(perf_buffer_data_.data()),
+                               perf_buffer_data_.size());
+      stats.data_size_bytes += event.msg.size();
+    }
+    stats.num_events += iter_events.size();
+    connector_->TransferData(&ctx_, data_tables_->tables());
+
+    for (size_t i = 0; i < SocketTraceConnector::kTables.size(); ++i) {
+      for (const auto& tablet : (*data_tables_)[i]->ConsumeRecords()) {
+        if (!tablet.records.empty()) {
+          stats.records_per_table[std::string(SocketTraceConnector::kTables[i].name())] +=
+              tablet.records[0]->Size();
+        }
+      }
+    }
+  }
+  return stats;
+}
+
+}  // namespace testing
+}  // namespace stirling
+}  // namespace px
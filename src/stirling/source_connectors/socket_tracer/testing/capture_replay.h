@@ -0,0 +1,102 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/stirling/core/connector_context.h"
+#include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
+#include "src/stirling/source_connectors/socket_tracer/testing/socket_trace_connector_friend.h"
+#include "src/stirling/testing/common.h"
+
+namespace px {
+namespace stirling {
+namespace testing {
+
+/**
+ * The data events of a capture, written by the socket tracer with
+ * --socket_trace_data_events_output_path=<path>.bin, grouped into the poll iterations to replay.
+ */
+struct CapturedEvent {
+  socket_data_event_t::attr_t attr;
+  // Only the captured bytes, rather than the fixed-size buffer of socket_data_event_t.
+  std::string msg;
+};
+
+struct EventCapture {
+  std::vector<std::vector<CapturedEvent>> per_iter_events;
+  uint64_t num_events = 0;
+  // Total size of the messages of the events, not including their attributes.
+  uint64_t data_size_bytes = 0;
+};
+
+/**
+ * Reads a binary capture. The events are grouped into one poll iteration per sampling period of
+ * the socket tracer, by their timestamps. Timestamps are shifted to start at 1, so that the records
+ * are not held back by the cutoff time of DataTable, which follows the clock of the machine that
+ * replays the capture.
+ */
+EventCapture ReadEventCapture(std::istream* in);
+StatusOr<EventCapture> ReadEventCaptureFile(const std::filesystem::path& path);
+
+/**
+ * Appends the event to a binary capture, in the format of the socket tracer.
+ */
+void WriteCapturedEvent(const socket_data_event_t& event, std::ostream* out);
+
+struct ReplayStats {
+  uint64_t num_events = 0;
+  uint64_t data_size_bytes = 0;
+  // The number of records output to each table, by table name.
+  std::map<std::string, uint64_t> records_per_table;
+};
+
+/**
+ * CaptureReplayer pushes the events of a capture through a SocketTraceConnector, the way BPF
+ * does: each event goes through the perf buffer callback, and TransferData() is called after each
+ * poll iteration. The records then go through the parsers and stitchers into DataTables.
+ * Neither BPF nor root privileges are needed.
+ */
+class CaptureReplayer {
+ public:
+  CaptureReplayer();
+
+  /**
+   * Replays all the poll iterations of the capture.
+   */
+  ReplayStats Replay(const EventCapture& capture);
+
+ private:
+  std::unique_ptr<SourceConnector> connector_;
+  SocketTraceConnectorFriend* source_ = nullptr;
+  std::unique_ptr<DataTables> data_tables_;
+  SystemWideStandaloneContext ctx_;
+  // The event being replayed, laid out like in the perf buffer: the attributes, then the message.
+  std::string perf_buffer_data_;
+};
+
+}  // namespace testing
+}  // namespace stirling
+}  // namespace px
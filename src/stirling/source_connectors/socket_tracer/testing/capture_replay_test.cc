@@ -0,0 +1,111 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/testing/capture_replay.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "src/common/testing/testing.h"
+#include "src/stirling/source_connectors/socket_tracer/socket_trace_connector.h"
+
+namespace px {
+namespace stirling {
+namespace testing {
+
+using ::testing::Contains;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+using ::testing::SizeIs;
+
+constexpr std::string_view kReq = "GET /index.html HTTP/1.1\r\nHost: pixie.ai\r\n\r\n";
+constexpr std::string_view kResp = "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\npixie";
+
+constexpr uint64_t kIterNS =
+    std::chrono::nanoseconds(SocketTraceConnector::kSamplingPeriod).count();
+
+socket_data_event_t HTTPEvent(uint64_t timestamp_ns, traffic_direction_t direction, uint64_t pos,
+                              std::string_view msg) {
+  socket_data_event_t event = {};
+  event.attr.timestamp_ns = timestamp_ns;
+  event.attr.conn_id.upid.pid = 123;
+  event.attr.conn_id.upid.start_time_ticks = 456;
+  event.attr.conn_id.fd = 3;
+  event.attr.conn_id.tsid = 1;
+  event.attr.protocol = kProtocolHTTP;
+  event.attr.role = kRoleServer;
+  event.attr.direction = direction;
+  event.attr.pos = pos;
+  event.attr.msg_size = msg.size();
+  event.attr.msg_buf_size = msg.size();
+  msg.copy(event.msg, msg.size());
+  return event;
+}
+
+// Writes a capture with a request and its response in each of two poll iterations.
+std::string HTTPCapture() {
+  std::ostringstream out;
+  for (uint64_t i = 0; i < 2; ++i) {
+    uint64_t timestamp_ns = 1000 + i * kIterNS;
+    WriteCapturedEvent(HTTPEvent(timestamp_ns, kIngress, i * kReq.size(), kReq), &out);
+    WriteCapturedEvent(HTTPEvent(timestamp_ns + 10, kEgress, i * kResp.size(), kResp), &out);
+  }
+  return out.str();
+}
+
+TEST(CaptureReplayTest, write_and_read_capture) {
+  std::istringstream in(HTTPCapture());
+  EventCapture capture = ReadEventCapture(&in);
+
+  EXPECT_EQ(capture.num_events, 4);
+  EXPECT_EQ(capture.data_size_bytes, 2 * (kReq.size() + kResp.size()));
+  ASSERT_THAT(capture.per_iter_events, ElementsAre(SizeIs(2), SizeIs(2)));
+
+  const CapturedEvent& resp = capture.per_iter_events[1][1];
+  // Timestamps are shifted to start at 1.
+  EXPECT_EQ(resp.attr.timestamp_ns, 1 + kIterNS + 10);
+  EXPECT_EQ(resp.attr.conn_id.upid.pid, 123);
+  EXPECT_EQ(resp.attr.conn_id.upid.start_time_ticks, 456);
+  EXPECT_EQ(resp.attr.conn_id.fd, 3);
+  EXPECT_EQ(resp.attr.conn_id.tsid, 1);
+  EXPECT_EQ(resp.attr.protocol, kProtocolHTTP);
+  EXPECT_EQ(resp.attr.role, kRoleServer);
+  EXPECT_EQ(resp.attr.direction, kEgress);
+  EXPECT_EQ(resp.attr.pos, kResp.size());
+  EXPECT_EQ(resp.attr.msg_size, kResp.size());
+  EXPECT_EQ(resp.attr.msg_buf_size, kResp.size());
+  EXPECT_EQ(resp.msg, kResp);
+}
+
+TEST(CaptureReplayTest, replay_outputs_records) {
+  std::istringstream in(HTTPCapture());
+  EventCapture capture = ReadEventCapture(&in);
+
+  CaptureReplayer replayer;
+  ReplayStats stats = replayer.Replay(capture);
+
+  EXPECT_EQ(stats.num_events, 4);
+  EXPECT_EQ(stats.data_size_bytes, capture.data_size_bytes);
+  EXPECT_THAT(stats.records_per_table, Contains(Pair("http_events", 2)));
+}
+
+}  // namespace testing
+}  // namespace stirling
+}  // namespace px
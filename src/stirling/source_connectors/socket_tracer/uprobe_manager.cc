@@ -22,8 +22,10 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <map>
+#include <thread>
 
 #include "src/common/base/base.h"
 #include "src/common/base/utils.h"
@@ -42,6 +44,11 @@ DEFINE_bool(stirling_rescan_for_dlopen, false,
 DEFINE_double(stirling_rescan_exp_backoff_factor, 2.0,
               "Exponential backoff factor used in decided how often to rescan binaries for "
               "dynamically loaded libraries");
+DEFINE_string(stirling_uprobe_symaddrs_cache_path, "",
+              "If set, the symbol addresses resolved for Go binaries are persisted to this file, "
+              "keyed by build ID, so that binaries are not re-analyzed after a restart.");
+DEFINE_int32(stirling_uprobe_analysis_threads, 4,
+             "The maximum number of threads used to analyze new binaries for uprobe deployment.");
 
 namespace px {
 namespace stirling {
@@ -70,6 +77,12 @@ void UProbeManager::Init(bool enable_http2_tracing, bool disable_self_probing) {
           bcc_, "node_tlswrap_symaddrs_map");
   go_goid_map_ = UserSpaceManagedBPFMap<uint32_t, int, ebpf::BPFMapInMapTable<uint32_t>>::Create(
       bcc_, "tgid_goid_map");
+
+  symaddrs_cache_ = std::make_unique<SymAddrsCache>(FLAGS_stirling_uprobe_symaddrs_cache_path);
+  Status s = symaddrs_cache_->Load();
+  if (!s.ok()) {
+    LOG(WARNING) << absl::Substitute("Could not load symaddrs cache: $0", s.msg());
+  }
 }
 
 void UProbeManager::NotifyMMapEvent(upid_t upid) {
@@ -143,36 +156,40 @@ Status UProbeManager::UpdateOpenSSLSymAddrs(std::filesystem::path libcrypto_path
   return Status::OK();
 }
 
-Status UProbeManager::UpdateGoCommonSymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
-                                             const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_common_symaddrs_t symaddrs,
-                      GoCommonSymAddrs(elf_reader, dwarf_reader));
+Status UProbeManager::UpdateGoCommonSymAddrs(
+    const std::optional<struct go_common_symaddrs_t>& symaddrs, const std::vector<int32_t>& pids) {
+  if (!symaddrs.has_value()) {
+    return error::NotFound("Binary does not have the Go common symbols.");
+  }
 
   for (auto& pid : pids) {
-    go_common_symaddrs_map_->UpdateValue(pid, symaddrs);
+    go_common_symaddrs_map_->UpdateValue(pid, symaddrs.value());
   }
 
   return Status::OK();
 }
 
-Status UProbeManager::UpdateGoHTTP2SymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
-                                            const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_http2_symaddrs_t symaddrs,
-                      GoHTTP2SymAddrs(elf_reader, dwarf_reader));
+Status UProbeManager::UpdateGoHTTP2SymAddrs(
+    const std::optional<struct go_http2_symaddrs_t>& symaddrs, const std::vector<int32_t>& pids) {
+  if (!symaddrs.has_value()) {
+    return error::NotFound("Binary does not have the Go HTTP2 symbols.");
+  }
 
   for (auto& pid : pids) {
-    go_http2_symaddrs_map_->UpdateValue(pid, symaddrs);
+    go_http2_symaddrs_map_->UpdateValue(pid, symaddrs.value());
   }
 
   return Status::OK();
 }
 
-Status UProbeManager::UpdateGoTLSSymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
+Status UProbeManager::UpdateGoTLSSymAddrs(const std::optional<struct go_tls_symaddrs_t>& symaddrs,
                                           const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_tls_symaddrs_t symaddrs, GoTLSSymAddrs(elf_reader, dwarf_reader));
+  if (!symaddrs.has_value()) {
+    return error::NotFound("Binary does not have the Go TLS symbols.");
+  }
 
   for (auto& pid : pids) {
-    go_tls_symaddrs_map_->UpdateValue(pid, symaddrs);
+    go_tls_symaddrs_map_->UpdateValue(pid, symaddrs.value());
   }
 
   return Status::OK();
@@ -392,7 +409,6 @@ void UProbeManager::SetupGOIDMaps(const std::string& binary, const std::vector<i
 
 StatusOr<int> UProbeManager::AttachGoRuntimeUProbes(const std::string& binary,
                                                     obj_tools::ElfReader* elf_reader,
-                                                    obj_tools::DwarfReader* /* dwarf_reader */,
                                                     const std::vector<int32_t>& /* pids */) {
   // Step 1: Update BPF symbols_map on all new PIDs.
   // TODO(oazizi): Implement this piece.
@@ -406,12 +422,11 @@ StatusOr<int> UProbeManager::AttachGoRuntimeUProbes(const std::string& binary,
   return AttachUProbeTmpl(kGoRuntimeUProbeTmpls, binary, elf_reader);
 }
 
-StatusOr<int> UProbeManager::AttachGoTLSUProbes(const std::string& binary,
-                                                obj_tools::ElfReader* elf_reader,
-                                                obj_tools::DwarfReader* dwarf_reader,
-                                                const std::vector<int32_t>& pids) {
+StatusOr<int> UProbeManager::AttachGoTLSUProbes(
+    const std::string& binary, obj_tools::ElfReader* elf_reader,
+    const std::optional<struct go_tls_symaddrs_t>& symaddrs, const std::vector<int32_t>& pids) {
   // Step 1: Update BPF symbols_map on all new PIDs.
-  Status s = UpdateGoTLSSymAddrs(elf_reader, dwarf_reader, pids);
+  Status s = UpdateGoTLSSymAddrs(symaddrs, pids);
   if (!s.ok()) {
     // Doesn't appear to be a binary with the mandatory symbols.
     // Might not even be a golang binary.
@@ -432,12 +447,11 @@ StatusOr<int> UProbeManager::AttachGoTLSUProbes(const std::string& binary,
 // That allows the BPF code and companion user-space code for uprobe & kprobe be separated
 // cleanly. For example, right now, enabling uprobe & kprobe simultaneously can crash Stirling,
 // because of the mixed & duplicate data events from these 2 sources.
-StatusOr<int> UProbeManager::AttachGoHTTP2Probes(const std::string& binary,
-                                                 obj_tools::ElfReader* elf_reader,
-                                                 obj_tools::DwarfReader* dwarf_reader,
-                                                 const std::vector<int32_t>& pids) {
+StatusOr<int> UProbeManager::AttachGoHTTP2Probes(
+    const std::string& binary, obj_tools::ElfReader* elf_reader,
+    const std::optional<struct go_http2_symaddrs_t>& symaddrs, const std::vector<int32_t>& pids) {
   // Step 1: Update BPF symaddrs for this binary.
-  Status s = UpdateGoHTTP2SymAddrs(elf_reader, dwarf_reader, pids);
+  Status s = UpdateGoHTTP2SymAddrs(symaddrs, pids);
   if (!s.ok()) {
     return 0;
   }
@@ -486,6 +500,32 @@ std::map<std::string, std::vector<int32_t>> ConvertPIDsListToMap(
   return pids;
 }
 
+// Calls fn(i) for every i in [0, n), spread over up to num_threads threads.
+template <typename TFn>
+void ParallelFor(size_t n, int num_threads, const TFn& fn) {
+  size_t num_workers = std::min<size_t>(n, std::max(num_threads, 1));
+  if (num_workers <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next = 0;
+  std::vector<std::thread> workers;
+  workers.reserve(num_workers);
+  for (size_t w = 0; w < num_workers; ++w) {
+    workers.emplace_back([&]() {
+      for (size_t i = next++; i < n; i = next++) {
+        fn(i);
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
 }  // namespace
 
 std::thread UProbeManager::RunDeployUProbesThread(const absl::flat_hash_set<md::UPID>& pids) {
@@ -549,12 +589,123 @@ int UProbeManager::DeployOpenSSLUProbes(const absl::flat_hash_set<md::UPID>& pid
   return uprobe_count;
 }
 
+void UProbeManager::AnalyzeGoBinaries(std::vector<GoBinary>* go_binaries) {
+  const int num_threads = FLAGS_stirling_uprobe_analysis_threads;
+
+  // Step 1: Read the binaries' symbols, and weed out the ones that are not Go binaries.
+  ParallelFor(go_binaries->size(), num_threads, [go_binaries](size_t i) {
+    GoBinary& go_binary = (*go_binaries)[i];
+
+    StatusOr<std::unique_ptr<ElfReader>> elf_reader_status = ElfReader::Create(go_binary.binary);
+    if (!elf_reader_status.ok()) {
+      LOG(WARNING) << absl::Substitute(
+          "Cannot analyze binary $0 for uprobe deployment. "
+          "If file is under /var/lib, container may have terminated. "
+          "Message = $1",
+          go_binary.binary, elf_reader_status.msg());
+      return;
+    }
+    std::unique_ptr<ElfReader> elf_reader = elf_reader_status.ConsumeValueOrDie();
+
+    // Avoid going past this point if not a golang program.
+    // The DwarfReader is memory intensive, and the remaining probes are Golang specific.
+    if (!IsGoExecutable(elf_reader.get())) {
+      return;
+    }
+    go_binary.elf_reader = std::move(elf_reader);
+  });
+  go_binaries->erase(std::remove_if(go_binaries->begin(), go_binaries->end(),
+                                    [](const GoBinary& b) { return b.elf_reader == nullptr; }),
+                     go_binaries->end());
+
+  // Step 2: Serve symbol addresses from the cache, and group the remaining binaries by build ID.
+  // Binaries without a build ID are analyzed on their own.
+  absl::flat_hash_map<std::string, std::vector<size_t>> build_id_binaries;
+  std::vector<size_t> to_analyze;
+  for (size_t i = 0; i < go_binaries->size(); ++i) {
+    GoBinary& go_binary = (*go_binaries)[i];
+    const std::string& build_id = go_binary.elf_reader->build_id();
+    if (build_id.empty()) {
+      to_analyze.push_back(i);
+      continue;
+    }
+    go_binary.symaddrs = symaddrs_cache_->LookupGo(build_id);
+    if (!go_binary.symaddrs.has_value()) {
+      build_id_binaries[build_id].push_back(i);
+    }
+  }
+
+  // Step 3: Resolve the symbol addresses, which requires indexing the DWARF info.
+  // The name index keeps DIE offsets only, so concurrent analyses hold less memory than with a
+  // fully indexed reader.
+  // Only one binary per build ID is analyzed at a time. If its analysis fails (e.g. the file is
+  // gone because its container terminated), the next binary with the same build ID is tried.
+  absl::flat_hash_map<std::string, size_t> analyzed_build_ids;
+  for (size_t attempt = 0;; ++attempt) {
+    for (const auto& [build_id, indices] : build_id_binaries) {
+      if (attempt < indices.size() && !analyzed_build_ids.contains(build_id)) {
+        to_analyze.push_back(indices[attempt]);
+      }
+    }
+    if (to_analyze.empty()) {
+      break;
+    }
+
+    ParallelFor(to_analyze.size(), num_threads, [go_binaries, &to_analyze](size_t i) {
+      GoBinary& go_binary = (*go_binaries)[to_analyze[i]];
+
+      StatusOr<std::unique_ptr<DwarfReader>> dwarf_reader_status =
+          DwarfReader::CreateWithLazyIndexing(go_binary.binary,
+                                              FLAGS_stirling_dwarf_index_cache_dir);
+      if (!dwarf_reader_status.ok()) {
+        VLOG(1) << absl::Substitute(
+            "Failed to get binary $0 debug symbols. Cannot deploy uprobes. "
+            "Message = $1",
+            go_binary.binary, dwarf_reader_status.msg());
+        return;
+      }
+      std::unique_ptr<DwarfReader> dwarf_reader = dwarf_reader_status.ConsumeValueOrDie();
+
+      go_binary.symaddrs = ResolveGoSymAddrs(go_binary.elf_reader.get(), dwarf_reader.get());
+    });
+
+    for (size_t idx : to_analyze) {
+      const GoBinary& go_binary = (*go_binaries)[idx];
+      const std::string& build_id = go_binary.elf_reader->build_id();
+      if (!build_id.empty() && go_binary.symaddrs.has_value()) {
+        analyzed_build_ids.try_emplace(build_id, idx);
+      }
+    }
+    to_analyze.clear();
+  }
+
+  // Step 4: Share the results with the other binaries of the same build ID, and cache them.
+  for (auto& go_binary : *go_binaries) {
+    const std::string& build_id = go_binary.elf_reader->build_id();
+    if (build_id.empty() || go_binary.symaddrs.has_value()) {
+      continue;
+    }
+    auto iter = analyzed_build_ids.find(build_id);
+    if (iter != analyzed_build_ids.end()) {
+      go_binary.symaddrs = (*go_binaries)[iter->second].symaddrs;
+    }
+  }
+  for (const auto& [build_id, idx] : analyzed_build_ids) {
+    symaddrs_cache_->InsertGo(build_id, (*go_binaries)[idx].symaddrs.value());
+  }
+  Status s = symaddrs_cache_->Save();
+  if (!s.ok()) {
+    LOG(WARNING) << absl::Substitute("Could not save symaddrs cache: $0", s.msg());
+  }
+}
+
 int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
   int uprobe_count = 0;
 
   static int32_t kPID = getpid();
 
-  for (const auto& [binary, pid_vec] : ConvertPIDsListToMap(pids, &fp_resolver_)) {
+  std::vector<GoBinary> go_binaries;
+  for (auto& [binary, pid_vec] : ConvertPIDsListToMap(pids, &fp_resolver_)) {
     // Don't bother rescanning binaries that have been scanned before to avoid unnecessary work.
     if (!scanned_binaries_.insert(binary).second) {
       continue;
@@ -568,36 +719,20 @@ int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
       }
     }
 
-    // Read binary's symbols.
-    StatusOr<std::unique_ptr<ElfReader>> elf_reader_status = ElfReader::Create(binary);
-    if (!elf_reader_status.ok()) {
-      LOG(WARNING) << absl::Substitute(
-          "Cannot analyze binary $0 for uprobe deployment. "
-          "If file is under /var/lib, container may have terminated. "
-          "Message = $1",
-          binary, elf_reader_status.msg());
-      continue;
-    }
-    std::unique_ptr<ElfReader> elf_reader = elf_reader_status.ConsumeValueOrDie();
+    go_binaries.push_back({binary, std::move(pid_vec), nullptr, std::nullopt});
+  }
 
-    // Avoid going past this point if not a golang program.
-    // The DwarfReader is memory intensive, and the remaining probes are Golang specific.
-    if (!IsGoExecutable(elf_reader.get())) {
-      continue;
-    }
+  // Analysis is independent per binary, and runs in parallel. Attaching the probes below goes
+  // through BCC and the BPF maps, and stays on this thread.
+  AnalyzeGoBinaries(&go_binaries);
 
-    StatusOr<std::unique_ptr<DwarfReader>> dwarf_reader_status =
-        DwarfReader::CreateIndexingAll(binary);
-    if (!dwarf_reader_status.ok()) {
-      VLOG(1) << absl::Substitute(
-          "Failed to get binary $0 debug symbols. Cannot deploy uprobes. "
-          "Message = $1",
-          binary, dwarf_reader_status.msg());
+  for (const auto& [binary, pid_vec, elf_reader, symaddrs] : go_binaries) {
+    if (!symaddrs.has_value()) {
+      // Failed to analyze the binary; already logged.
       continue;
     }
-    std::unique_ptr<DwarfReader> dwarf_reader = dwarf_reader_status.ConsumeValueOrDie();
 
-    Status s = UpdateGoCommonSymAddrs(elf_reader.get(), dwarf_reader.get(), pid_vec);
+    Status s = UpdateGoCommonSymAddrs(symaddrs->common, pid_vec);
     if (!s.ok()) {
       VLOG(1) << absl::Substitute(
           "Golang binary $0 does not have the mandatory symbols (e.g. TCPConn).", binary);
@@ -609,8 +744,7 @@ int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
 
     // Go Runtime Probes.
     {
-      StatusOr<int> attach_status =
-          AttachGoRuntimeUProbes(binary, elf_reader.get(), dwarf_reader.get(), pid_vec);
+      StatusOr<int> attach_status = AttachGoRuntimeUProbes(binary, elf_reader.get(), pid_vec);
       if (!attach_status.ok()) {
         LOG_FIRST_N(WARNING, 10) << absl::Substitute(
             "Failed to attach Go Runtime Uprobes to $0: $1", binary, attach_status.ToString());
@@ -622,7 +756,7 @@ int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
     // GoTLS Probes.
     {
       StatusOr<int> attach_status =
-          AttachGoTLSUProbes(binary, elf_reader.get(), dwarf_reader.get(), pid_vec);
+          AttachGoTLSUProbes(binary, elf_reader.get(), symaddrs->tls, pid_vec);
       if (!attach_status.ok()) {
         LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach GoTLS Uprobes to $0: $1",
                                                      binary, attach_status.ToString());
@@ -634,7 +768,7 @@ int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
     // Go HTTP2 Probes.
     if (cfg_enable_http2_tracing_) {
       StatusOr<int> attach_status =
-          AttachGoHTTP2Probes(binary, elf_reader.get(), dwarf_reader.get(), pid_vec);
+          AttachGoHTTP2Probes(binary, elf_reader.get(), symaddrs->http2, pid_vec);
       if (!attach_status.ok()) {
         LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach HTTP2 Uprobes to $0: $1",
                                                      binary, attach_status.ToString());
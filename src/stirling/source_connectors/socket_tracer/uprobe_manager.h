@@ -20,6 +20,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -32,6 +33,8 @@
 
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/symaddrs.h"
+#include "src/stirling/source_connectors/socket_tracer/uprobe_symaddrs.h"
+#include "src/stirling/source_connectors/socket_tracer/uprobe_symaddrs_cache.h"
 
 #include "src/stirling/utils/detect_application.h"
 #include "src/stirling/utils/proc_path_tools.h"
@@ -39,6 +42,8 @@
 
 DECLARE_bool(stirling_rescan_for_dlopen);
 DECLARE_double(stirling_rescan_exp_backoff_factor);
+DECLARE_string(stirling_uprobe_symaddrs_cache_path);
+DECLARE_int32(stirling_uprobe_analysis_threads);
 
 namespace px {
 namespace stirling {
@@ -384,6 +389,23 @@ class UProbeManager {
    */
   int DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids);
 
+  // A Go binary to be analyzed for uprobe deployment, and the results of that analysis.
+  struct GoBinary {
+    std::string binary;
+    std::vector<int32_t> pids;
+    std::unique_ptr<obj_tools::ElfReader> elf_reader;
+    std::optional<GoSymAddrs> symaddrs;
+  };
+
+  /**
+   * Analyzes the binaries for Go uprobe deployment, on up to
+   * --stirling_uprobe_analysis_threads threads. Binaries that are not Go binaries are removed.
+   * Symbol addresses are resolved only once per build ID, and are served from symaddrs_cache_
+   * when possible. If the analysis of a binary fails, the next binary with the same build ID is
+   * analyzed instead. Binaries whose symbol addresses could not be resolved are left without them.
+   */
+  void AnalyzeGoBinaries(std::vector<GoBinary>* go_binaries);
+
   /**
    * Sets up the BPF maps used for GOID tracking. Required for general Go tracing.
    *
@@ -398,14 +420,11 @@ class UProbeManager {
    *
    * @param binary The path to the binary on which to deploy Go probes.
    * @param elf_reader ELF reader for the binary.
-   * @param dwarf_reader DWARF reader for the binary.
-   * @param pids The list of PIDs that are new instances of the binary. Used to populate symbol
-   *             addresses.
+   * @param pids The list of PIDs that are new instances of the binary.
    * @return The number of uprobes deployed, or error. It is not an error if the binary
    *         is not a Go binary; instead the return value will be zero.
    */
   StatusOr<int> AttachGoRuntimeUProbes(const std::string& binary, obj_tools::ElfReader* elf_reader,
-                                       obj_tools::DwarfReader* dwarf_reader,
                                        const std::vector<int32_t>& new_pids);
 
   /**
@@ -414,7 +433,7 @@ class UProbeManager {
    *
    * @param binary The path to the binary on which to deploy Go HTTP2 probes.
    * @param elf_reader ELF reader for the binary.
-   * @param dwarf_reader DWARF reader for the binary.
+   * @param symaddrs The resolved HTTP2 symbol addresses of the binary, if it has them.
    * @param pids The list of PIDs that are new instances of the binary. Used to populate symbol
    *             addresses.
    * @return The number of uprobes deployed, or error. It is not considered an error if the binary
@@ -422,7 +441,7 @@ class UProbeManager {
    *         zero.
    */
   StatusOr<int> AttachGoHTTP2Probes(const std::string& binary, obj_tools::ElfReader* elf_reader,
-                                    obj_tools::DwarfReader* dwarf_reader,
+                                    const std::optional<struct go_http2_symaddrs_t>& symaddrs,
                                     const std::vector<int32_t>& pids);
 
   /**
@@ -431,14 +450,14 @@ class UProbeManager {
    *
    * @param binary The path to the binary on which to deploy Go HTTP2 probes.
    * @param elf_reader ELF reader for the binary.
-   * @param dwarf_reader DWARF reader for the binary.
+   * @param symaddrs The resolved GoTLS symbol addresses of the binary, if it has them.
    * @param pids The list of PIDs that are new instances of the binary. Used to populate symbol
    *             addresses.
    * @return The number of uprobes deployed, or error. It is not an error if the binary
    *         is not a Go binary or doesn't use Go TLS; instead the return value will be zero.
    */
   StatusOr<int> AttachGoTLSUProbes(const std::string& binary, obj_tools::ElfReader* elf_reader,
-                                   obj_tools::DwarfReader* dwarf_reader,
+                                   const std::optional<struct go_tls_symaddrs_t>& symaddrs,
                                    const std::vector<int32_t>& new_pids);
 
   /**
@@ -479,13 +498,11 @@ class UProbeManager {
   absl::flat_hash_set<md::UPID> PIDsToRescanForUProbes();
 
   Status UpdateOpenSSLSymAddrs(std::filesystem::path container_lib, uint32_t pid);
-  Status UpdateGoCommonSymAddrs(obj_tools::ElfReader* elf_reader,
-                                obj_tools::DwarfReader* dwarf_reader,
+  Status UpdateGoCommonSymAddrs(const std::optional<struct go_common_symaddrs_t>& symaddrs,
                                 const std::vector<int32_t>& pids);
-  Status UpdateGoHTTP2SymAddrs(obj_tools::ElfReader* elf_reader,
-                               obj_tools::DwarfReader* dwarf_reader,
+  Status UpdateGoHTTP2SymAddrs(const std::optional<struct go_http2_symaddrs_t>& symaddrs,
                                const std::vector<int32_t>& pids);
-  Status UpdateGoTLSSymAddrs(obj_tools::ElfReader* elf_reader, obj_tools::DwarfReader* dwarf_reader,
+  Status UpdateGoTLSSymAddrs(const std::optional<struct go_tls_symaddrs_t>& symaddrs,
                              const std::vector<int32_t>& pids);
   Status UpdateNodeTLSWrapSymAddrs(int32_t pid, const std::filesystem::path& node_exe,
                                    const SemVer& ver);
@@ -531,6 +548,9 @@ class UProbeManager {
   absl::flat_hash_set<std::string> go_tls_probed_binaries_;
   absl::flat_hash_set<std::string> nodejs_binaries_;
 
+  // Symbol addresses of Go binaries, keyed by build ID, so identical binaries are analyzed once.
+  std::unique_ptr<SymAddrsCache> symaddrs_cache_;
+
   // BPF maps through which the addresses of symbols for a given pid are communicated to uprobes.
   std::unique_ptr<UserSpaceManagedBPFMap<uint32_t, struct openssl_symaddrs_t>>
       openssl_symaddrs_map_;
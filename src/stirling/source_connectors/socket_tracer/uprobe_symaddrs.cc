@@ -496,6 +496,29 @@ StatusOr<struct go_tls_symaddrs_t> GoTLSSymAddrs(ElfReader* elf_reader, DwarfRea
   return symaddrs;
 }
 
+GoSymAddrs ResolveGoSymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader) {
+  GoSymAddrs symaddrs;
+
+  StatusOr<struct go_common_symaddrs_t> common = GoCommonSymAddrs(elf_reader, dwarf_reader);
+  if (!common.ok()) {
+    // The remaining symbols are of no use without the common ones.
+    return symaddrs;
+  }
+  symaddrs.common = common.ConsumeValueOrDie();
+
+  StatusOr<struct go_http2_symaddrs_t> http2 = GoHTTP2SymAddrs(elf_reader, dwarf_reader);
+  if (http2.ok()) {
+    symaddrs.http2 = http2.ConsumeValueOrDie();
+  }
+
+  StatusOr<struct go_tls_symaddrs_t> tls = GoTLSSymAddrs(elf_reader, dwarf_reader);
+  if (tls.ok()) {
+    symaddrs.tls = tls.ConsumeValueOrDie();
+  }
+
+  return symaddrs;
+}
+
 namespace {
 
 // Returns a function pointer from a dlopen handle.
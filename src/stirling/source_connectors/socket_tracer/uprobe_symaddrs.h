@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "src/common/base/base.h"
 #include "src/stirling/obj_tools/dwarf_reader.h"
 #include "src/stirling/obj_tools/elf_reader.h"
@@ -48,6 +50,23 @@ StatusOr<struct go_http2_symaddrs_t> GoHTTP2SymAddrs(obj_tools::ElfReader* elf_r
 StatusOr<struct go_tls_symaddrs_t> GoTLSSymAddrs(obj_tools::ElfReader* elf_reader,
                                                  obj_tools::DwarfReader* dwarf_reader);
 
+/**
+ * The symbol addresses of a Go binary, for all Go uprobe types. A missing member means the
+ * binary does not have the symbols required by that uprobe type.
+ */
+struct GoSymAddrs {
+  std::optional<struct go_common_symaddrs_t> common;
+  std::optional<struct go_http2_symaddrs_t> http2;
+  std::optional<struct go_tls_symaddrs_t> tls;
+};
+
+/**
+ * Resolves the symbol addresses for all Go uprobe types. Only depends on the content of the
+ * binary, so the result can be shared by all binaries with the same build ID.
+ */
+GoSymAddrs ResolveGoSymAddrs(obj_tools::ElfReader* elf_reader,
+                             obj_tools::DwarfReader* dwarf_reader);
+
 /**
  * Detects the version of OpenSSL to return the locations of all relevant symbols for OpenSSL uprobe
  * deployment.
@@ -0,0 +1,191 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/uprobe_symaddrs_cache.h"
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "src/common/base/file.h"
+#include "src/common/fs/fs_wrapper.h"
+
+namespace px {
+namespace stirling {
+
+namespace {
+
+// The file starts with this header. The struct sizes guard against reading entries written by a
+// version with a different layout of the symaddrs structs.
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t common_size;
+  uint32_t http2_size;
+  uint32_t tls_size;
+};
+
+constexpr char kMagic[4] = {'P', 'X', 'S', 'A'};
+constexpr uint32_t kVersion = 1;
+
+// Bits of the presence mask that precedes the symaddrs of each entry.
+enum : uint8_t {
+  kHasCommon = 1 << 0,
+  kHasHTTP2 = 1 << 1,
+  kHasTLS = 1 << 2,
+};
+
+FileHeader ExpectedHeader() {
+  FileHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.common_size = sizeof(struct go_common_symaddrs_t);
+  header.http2_size = sizeof(struct go_http2_symaddrs_t);
+  header.tls_size = sizeof(struct go_tls_symaddrs_t);
+  return header;
+}
+
+template <typename T>
+void AppendRaw(const T& val, std::string* out) {
+  out->append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <typename T>
+bool ConsumeRaw(std::string_view* buf, T* val) {
+  if (buf->size() < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(val, buf->data(), sizeof(T));
+  buf->remove_prefix(sizeof(T));
+  return true;
+}
+
+template <typename T>
+bool ConsumeOptional(std::string_view* buf, bool present, std::optional<T>* val) {
+  if (!present) {
+    return true;
+  }
+  T tmp;
+  if (!ConsumeRaw(buf, &tmp)) {
+    return false;
+  }
+  *val = tmp;
+  return true;
+}
+
+}  // namespace
+
+std::optional<GoSymAddrs> SymAddrsCache::LookupGo(const std::string& build_id) const {
+  auto iter = go_symaddrs_.find(build_id);
+  if (iter == go_symaddrs_.end()) {
+    return std::nullopt;
+  }
+  return iter->second;
+}
+
+void SymAddrsCache::InsertGo(const std::string& build_id, const GoSymAddrs& symaddrs) {
+  if (build_id.empty() || go_symaddrs_.size() >= kMaxEntries) {
+    return;
+  }
+  if (go_symaddrs_.try_emplace(build_id, symaddrs).second) {
+    dirty_ = true;
+  }
+}
+
+Status SymAddrsCache::Load() {
+  if (file_path_.empty() || !fs::Exists(file_path_)) {
+    return Status::OK();
+  }
+
+  PL_ASSIGN_OR_RETURN(std::string contents, ReadFileToString(file_path_));
+  std::string_view buf = contents;
+
+  FileHeader header;
+  const FileHeader expected_header = ExpectedHeader();
+  if (!ConsumeRaw(&buf, &header) || std::memcmp(&header, &expected_header, sizeof(header)) != 0) {
+    LOG(INFO) << absl::Substitute("Ignoring symaddrs cache $0 with unexpected header.",
+                                  file_path_.string());
+    return Status::OK();
+  }
+
+  while (!buf.empty() && go_symaddrs_.size() < kMaxEntries) {
+    uint32_t build_id_size;
+    if (!ConsumeRaw(&buf, &build_id_size) || buf.size() < build_id_size) {
+      return error::Internal("Truncated symaddrs cache $0.", file_path_.string());
+    }
+    std::string build_id(buf.substr(0, build_id_size));
+    buf.remove_prefix(build_id_size);
+
+    uint8_t mask;
+    GoSymAddrs symaddrs;
+    if (!ConsumeRaw(&buf, &mask) || !ConsumeOptional(&buf, mask & kHasCommon, &symaddrs.common) ||
+        !ConsumeOptional(&buf, mask & kHasHTTP2, &symaddrs.http2) ||
+        !ConsumeOptional(&buf, mask & kHasTLS, &symaddrs.tls)) {
+      return error::Internal("Truncated symaddrs cache $0.", file_path_.string());
+    }
+    go_symaddrs_.try_emplace(std::move(build_id), symaddrs);
+  }
+
+  VLOG(1) << absl::Substitute("Loaded $0 entries from symaddrs cache $1.", go_symaddrs_.size(),
+                              file_path_.string());
+  return Status::OK();
+}
+
+Status SymAddrsCache::Save() {
+  if (file_path_.empty() || !dirty_) {
+    return Status::OK();
+  }
+
+  std::string contents;
+  AppendRaw(ExpectedHeader(), &contents);
+  for (const auto& [build_id, symaddrs] : go_symaddrs_) {
+    AppendRaw(static_cast<uint32_t>(build_id.size()), &contents);
+    contents.append(build_id);
+
+    uint8_t mask = (symaddrs.common.has_value() ? kHasCommon : 0) |
+                   (symaddrs.http2.has_value() ? kHasHTTP2 : 0) |
+                   (symaddrs.tls.has_value() ? kHasTLS : 0);
+    AppendRaw(mask, &contents);
+    if (symaddrs.common.has_value()) {
+      AppendRaw(symaddrs.common.value(), &contents);
+    }
+    if (symaddrs.http2.has_value()) {
+      AppendRaw(symaddrs.http2.value(), &contents);
+    }
+    if (symaddrs.tls.has_value()) {
+      AppendRaw(symaddrs.tls.value(), &contents);
+    }
+  }
+
+  // Write to a temporary file first, so a crash never leaves a partially written cache behind.
+  std::filesystem::path tmp_path = file_path_;
+  tmp_path += ".tmp";
+  PL_RETURN_IF_ERROR(WriteFileFromString(tmp_path, contents));
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, file_path_, ec);
+  if (ec) {
+    return error::Internal("Could not write symaddrs cache $0: $1", file_path_.string(),
+                           ec.message());
+  }
+
+  dirty_ = false;
+  return Status::OK();
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/common/base/base.h"
+#include "src/stirling/source_connectors/socket_tracer/uprobe_symaddrs.h"
+
+namespace px {
+namespace stirling {
+
+/**
+ * Caches the symbol addresses resolved for Go binaries, keyed by build ID.
+ *
+ * Resolving symbol addresses requires indexing the DWARF info of a binary, which is expensive.
+ * Many processes, often in different containers, tend to run the very same binary, so the result
+ * is shared by build ID rather than by path. The cache can optionally be persisted to a local
+ * file, so that the work is not repeated after a restart.
+ *
+ * Not thread-safe.
+ */
+class SymAddrsCache : public NotCopyMoveable {
+ public:
+  // Entries beyond this many are not cached, to bound the size of the cache and its file.
+  static constexpr size_t kMaxEntries = 4096;
+
+  /**
+   * @param file_path The file to which the cache is persisted. Empty to keep it in memory only.
+   */
+  explicit SymAddrsCache(std::filesystem::path file_path = {})
+      : file_path_(std::move(file_path)) {}
+
+  /**
+   * Returns the symbol addresses of the binary with the given build ID, if cached.
+   */
+  std::optional<GoSymAddrs> LookupGo(const std::string& build_id) const;
+
+  /**
+   * Caches the symbol addresses of the binary with the given build ID.
+   */
+  void InsertGo(const std::string& build_id, const GoSymAddrs& symaddrs);
+
+  /**
+   * Loads the entries persisted in the cache file. A missing file, or one written with a
+   * different layout of the symaddrs structs, is not an error; the cache just starts out empty.
+   */
+  Status Load();
+
+  /**
+   * Writes the cache to its file, if there are entries that have not been persisted yet.
+   */
+  Status Save();
+
+  size_t size() const { return go_symaddrs_.size(); }
+
+ private:
+  std::filesystem::path file_path_;
+  absl::flat_hash_map<std::string, GoSymAddrs> go_symaddrs_;
+  bool dirty_ = false;
+};
+
+}  // namespace stirling
+}  // namespace px
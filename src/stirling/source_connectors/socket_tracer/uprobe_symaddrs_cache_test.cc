@@ -0,0 +1,98 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/uprobe_symaddrs_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/common/base/test_utils.h"
+#include "src/common/testing/temp_dir.h"
+
+namespace px {
+namespace stirling {
+
+GoSymAddrs TestGoSymAddrs() {
+  GoSymAddrs symaddrs;
+  symaddrs.common = go_common_symaddrs_t{};
+  symaddrs.common->FD_Sysfd_offset = 16;
+  symaddrs.tls = go_tls_symaddrs_t{};
+  symaddrs.tls->Write_c_loc = {.type = kLocationTypeStack, .offset = 8};
+  return symaddrs;
+}
+
+TEST(SymAddrsCacheTest, LookupInsert) {
+  SymAddrsCache cache;
+  EXPECT_EQ(cache.LookupGo("abcd"), std::nullopt);
+
+  cache.InsertGo("abcd", TestGoSymAddrs());
+  std::optional<GoSymAddrs> symaddrs = cache.LookupGo("abcd");
+  ASSERT_TRUE(symaddrs.has_value());
+  ASSERT_TRUE(symaddrs->common.has_value());
+  EXPECT_EQ(symaddrs->common->FD_Sysfd_offset, 16);
+  EXPECT_FALSE(symaddrs->http2.has_value());
+
+  // Binaries without a build ID are never cached.
+  cache.InsertGo("", TestGoSymAddrs());
+  EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(SymAddrsCacheTest, SaveAndLoad) {
+  testing::TempDir temp_dir;
+  const std::filesystem::path path = temp_dir.path() / "symaddrs_cache";
+
+  {
+    SymAddrsCache cache(path);
+    ASSERT_OK(cache.Load());
+    EXPECT_EQ(cache.size(), 0);
+    cache.InsertGo("abcd", TestGoSymAddrs());
+    cache.InsertGo("efgh", GoSymAddrs{});
+    ASSERT_OK(cache.Save());
+  }
+
+  SymAddrsCache cache(path);
+  ASSERT_OK(cache.Load());
+  EXPECT_EQ(cache.size(), 2);
+
+  std::optional<GoSymAddrs> symaddrs = cache.LookupGo("abcd");
+  ASSERT_TRUE(symaddrs.has_value());
+  ASSERT_TRUE(symaddrs->common.has_value());
+  EXPECT_EQ(symaddrs->common->FD_Sysfd_offset, 16);
+  EXPECT_FALSE(symaddrs->http2.has_value());
+  ASSERT_TRUE(symaddrs->tls.has_value());
+  EXPECT_EQ(symaddrs->tls->Write_c_loc, (location_t{.type = kLocationTypeStack, .offset = 8}));
+
+  symaddrs = cache.LookupGo("efgh");
+  ASSERT_TRUE(symaddrs.has_value());
+  EXPECT_FALSE(symaddrs->common.has_value());
+}
+
+TEST(SymAddrsCacheTest, IgnoresIncompatibleFile) {
+  testing::TempDir temp_dir;
+  const std::filesystem::path path = temp_dir.path() / "symaddrs_cache";
+  ASSERT_OK(WriteFileFromString(path, "not a symaddrs cache"));
+
+  SymAddrsCache cache(path);
+  ASSERT_OK(cache.Load());
+  EXPECT_EQ(cache.size(), 0);
+}
+
+}  // namespace stirling
+}  // namespace px
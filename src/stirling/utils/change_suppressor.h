@@ -0,0 +1,103 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>
+
+#include <absl/container/flat_hash_map.h>
+
+namespace px {
+namespace stirling {
+namespace utils {
+
+/**
+ * ChangeSuppressor decides whether a periodically sampled value needs to be recorded,
+ * by comparing it against the last recorded value for the same key.
+ *
+ * A value is recorded if the key is new, if the value differs from the last recorded value,
+ * or if keyframe_period iterations have passed since the key was last recorded.
+ * The keyframes bound how far back a query has to look to find the current value of every key.
+ * A keyframe_period of 0 or 1 disables suppression.
+ *
+ * Usage:
+ *   suppressor.BeginIteration();
+ *   for (...) {
+ *     if (suppressor.ShouldRecord(key, value)) { ... }
+ *   }
+ *   suppressor.EndIteration();
+ */
+template <typename TKey, typename TValue>
+class ChangeSuppressor {
+ public:
+  explicit ChangeSuppressor(uint32_t keyframe_period) : keyframe_period_(keyframe_period) {}
+
+  /**
+   * Starts a new sampling iteration.
+   */
+  void BeginIteration() { ++iteration_; }
+
+  /**
+   * Returns true if the value should be recorded. If so, it becomes the reference value that
+   * future samples of the key are compared against.
+   */
+  bool ShouldRecord(const TKey& key, const TValue& value) {
+    auto [iter, inserted] = entries_.try_emplace(key);
+    Entry& entry = iter->second;
+    entry.last_seen_iteration = iteration_;
+
+    if (!inserted && entry.value == value &&
+        iteration_ - entry.last_recorded_iteration < keyframe_period_) {
+      return false;
+    }
+
+    entry.value = value;
+    entry.last_recorded_iteration = iteration_;
+    return true;
+  }
+
+  /**
+   * Ends the current sampling iteration, forgetting about the keys that were not sampled in it
+   * (e.g. processes that have exited). If such a key reappears, it is recorded immediately.
+   */
+  void EndIteration() {
+    for (auto iter = entries_.begin(); iter != entries_.end();) {
+      if (iter->second.last_seen_iteration != iteration_) {
+        entries_.erase(iter++);
+      } else {
+        ++iter;
+      }
+    }
+  }
+
+  size_t size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    TValue value = {};
+    uint64_t last_recorded_iteration = 0;
+    uint64_t last_seen_iteration = 0;
+  };
+
+  const uint32_t keyframe_period_;
+  uint64_t iteration_ = 0;
+  absl::flat_hash_map<TKey, Entry> entries_;
+};
+
+}  // namespace utils
+}  // namespace stirling
+}  // namespace px
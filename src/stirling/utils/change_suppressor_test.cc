@@ -0,0 +1,92 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "src/stirling/utils/change_suppressor.h"
+
+namespace px {
+namespace stirling {
+namespace utils {
+
+TEST(ChangeSuppressorTest, SuppressesUnchangedValues) {
+  ChangeSuppressor<std::string, int> suppressor(/*keyframe_period*/ 100);
+
+  suppressor.BeginIteration();
+  EXPECT_TRUE(suppressor.ShouldRecord("a", 1));
+  EXPECT_TRUE(suppressor.ShouldRecord("b", 1));
+  suppressor.EndIteration();
+
+  suppressor.BeginIteration();
+  EXPECT_FALSE(suppressor.ShouldRecord("a", 1));
+  EXPECT_TRUE(suppressor.ShouldRecord("b", 2));
+  suppressor.EndIteration();
+
+  suppressor.BeginIteration();
+  EXPECT_FALSE(suppressor.ShouldRecord("a", 1));
+  EXPECT_FALSE(suppressor.ShouldRecord("b", 2));
+  suppressor.EndIteration();
+}
+
+TEST(ChangeSuppressorTest, Keyframes) {
+  ChangeSuppressor<std::string, int> suppressor(/*keyframe_period*/ 3);
+
+  std::string recorded;
+  for (int i = 0; i < 7; ++i) {
+    suppressor.BeginIteration();
+    recorded += suppressor.ShouldRecord("a", 1) ? "x" : ".";
+    suppressor.EndIteration();
+  }
+  EXPECT_EQ(recorded, "x..x..x");
+}
+
+TEST(ChangeSuppressorTest, KeyframePeriodOfOneDisablesSuppression) {
+  ChangeSuppressor<std::string, int> suppressor(/*keyframe_period*/ 1);
+
+  for (int i = 0; i < 3; ++i) {
+    suppressor.BeginIteration();
+    EXPECT_TRUE(suppressor.ShouldRecord("a", 1));
+    suppressor.EndIteration();
+  }
+}
+
+TEST(ChangeSuppressorTest, ForgetsKeysNotSeen) {
+  ChangeSuppressor<std::string, int> suppressor(/*keyframe_period*/ 100);
+
+  suppressor.BeginIteration();
+  EXPECT_TRUE(suppressor.ShouldRecord("a", 1));
+  EXPECT_TRUE(suppressor.ShouldRecord("b", 1));
+  suppressor.EndIteration();
+  EXPECT_EQ(suppressor.size(), 2);
+
+  suppressor.BeginIteration();
+  EXPECT_FALSE(suppressor.ShouldRecord("a", 1));
+  suppressor.EndIteration();
+  EXPECT_EQ(suppressor.size(), 1);
+
+  // "b" is treated as new when it comes back.
+  suppressor.BeginIteration();
+  EXPECT_FALSE(suppressor.ShouldRecord("a", 1));
+  EXPECT_TRUE(suppressor.ShouldRecord("b", 1));
+  suppressor.EndIteration();
+}
+
+}  // namespace utils
+}  // namespace stirling
+}  // namespace px
@@ -85,5 +85,46 @@ class ObjPool {
   std::vector<T*> obj_pool_;
 };
 
+/**
+ * ReusableObjPool is like ObjPool, except that recycled objects are not destroyed.
+ * They keep the memory they own (e.g. the capacity of their strings), so that it can be reused,
+ * but the caller must reset a popped object before using it.
+ */
+template <typename T>
+class ReusableObjPool {
+ public:
+  explicit ReusableObjPool(size_t capacity) : capacity_(capacity) { obj_pool_.reserve(capacity_); }
+
+  /**
+   * Pop() returns either a new or a recycled object.
+   * If recycled, the object holds whatever state it had when it was recycled.
+   */
+  std::unique_ptr<T> Pop() {
+    if (obj_pool_.empty()) {
+      return std::make_unique<T>();
+    }
+    std::unique_ptr<T> obj = std::move(obj_pool_.back());
+    obj_pool_.pop_back();
+    return obj;
+  }
+
+  /**
+   * Recycle() submits an object for recycling.
+   * The object is deallocated if the pool is at capacity.
+   */
+  void Recycle(std::unique_ptr<T> obj) {
+    if (obj_pool_.size() >= capacity_) {
+      return;
+    }
+    obj_pool_.push_back(std::move(obj));
+  }
+
+  size_t size() const { return obj_pool_.size(); }
+
+ private:
+  size_t capacity_;
+  std::vector<std::unique_ptr<T>> obj_pool_;
+};
+
 }  // namespace stirling
 }  // namespace px
@@ -90,5 +90,32 @@ TEST_F(ObjPoolTest, Capacity) {
   EXPECT_NE(uptrs[4].get(), ptrs[3]);
 }
 
+TEST(ReusableObjPoolTest, ObjRecycledWithState) {
+  ReusableObjPool<TestObject> obj_pool(1);
+
+  std::unique_ptr<TestObject> obj = obj_pool.Pop();
+  EXPECT_EQ(obj->str, "uninitialized");
+  obj->str = std::string(1000, 'x');
+  TestObject* ptr1 = obj.get();
+  const char* buf1 = obj->str.data();
+  obj_pool.Recycle(std::move(obj));
+  EXPECT_EQ(obj_pool.size(), 1);
+
+  // The object is handed back as it was, so its string buffer is reused.
+  obj = obj_pool.Pop();
+  EXPECT_EQ(obj.get(), ptr1);
+  obj->str.assign(500, 'y');
+  EXPECT_EQ(obj->str.data(), buf1);
+  EXPECT_EQ(obj_pool.size(), 0);
+
+  // Objects beyond the capacity are deallocated.
+  std::unique_ptr<TestObject> obj2 = obj_pool.Pop();
+  EXPECT_NE(obj2.get(), ptr1);
+  obj_pool.Recycle(std::move(obj));
+  obj_pool.Recycle(std::move(obj2));
+  EXPECT_EQ(obj_pool.size(), 1);
+  EXPECT_EQ(obj_pool.Pop().get(), ptr1);
+}
+
 }  // namespace stirling
 }  // namespace px
@@ -19,6 +19,7 @@
 #include <arrow/array.h>
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -48,9 +49,60 @@ Status RowBatch::AddColumn(const std::shared_ptr<arrow::Array>& col) {
   }
 
   columns_.emplace_back(col);
+  if (!deferred_.empty()) {
+    deferred_.emplace_back();
+  }
+  return Status::OK();
+}
+
+Status RowBatch::AddDeferredColumn(std::shared_ptr<const ColumnFetcher> fetcher,
+                                   int64_t row_offset) {
+  if (columns_.size() >= desc_.size()) {
+    return error::InvalidArgument("Schema only allows $0 columns", desc_.size());
+  }
+  deferred_.resize(columns_.size());
+  deferred_.push_back(DeferredColumn{std::move(fetcher), row_offset});
+  columns_.emplace_back(nullptr);
   return Status::OK();
 }
 
+Status RowBatch::AddColumnFrom(const RowBatch& rb, int64_t col_idx) {
+  if (rb.num_rows() != num_rows_) {
+    return error::InvalidArgument("Schema only allows $0 rows, got $1", num_rows_, rb.num_rows());
+  }
+  if (!rb.IsDeferred(col_idx)) {
+    return AddColumn(rb.ColumnAt(col_idx));
+  }
+  if (rb.desc().type(col_idx) != desc_.type(columns_.size())) {
+    return error::InvalidArgument("Column[$0] was given incorrect type", columns_.size());
+  }
+  const auto& deferred = rb.deferred_[col_idx];
+  return AddDeferredColumn(deferred.fetcher, deferred.row_offset);
+}
+
+bool RowBatch::has_deferred_columns() const {
+  for (const auto& deferred : deferred_) {
+    if (deferred.fetcher != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+StatusOr<std::shared_ptr<arrow::Array>> RowBatch::FetchDeferredRows(
+    int64_t col_idx, const std::vector<int64_t>& rows, arrow::MemoryPool* mem_pool) const {
+  const auto& deferred = deferred_[col_idx];
+  if (deferred.row_offset == 0) {
+    return (*deferred.fetcher)(rows, mem_pool);
+  }
+  std::vector<int64_t> fetcher_rows;
+  fetcher_rows.reserve(rows.size());
+  for (int64_t i : rows) {
+    fetcher_rows.push_back(i + deferred.row_offset);
+  }
+  return (*deferred.fetcher)(fetcher_rows, mem_pool);
+}
+
 bool RowBatch::HasColumn(int64_t i) const { return columns_.size() > static_cast<size_t>(i); }
 
 std::string RowBatch::DebugString() const {
@@ -59,6 +111,10 @@ std::string RowBatch::DebugString() const {
   }
   std::string debug_string = absl::StrFormat("RowBatch(eow=%d, eos=%d):\n", eow_, eos_);
   for (const auto& col : columns_) {
+    if (col == nullptr) {
+      debug_string += "  <deferred>\n";
+      continue;
+    }
     debug_string += absl::StrFormat("  %s\n", col->ToString());
   }
   return debug_string;
@@ -71,6 +127,10 @@ int64_t RowBatch::NumBytes() const {
 
   int64_t total_bytes = 0;
   for (auto col : columns_) {
+    // Deferred columns hold no data in the batch.
+    if (col == nullptr) {
+      continue;
+    }
 #define TYPE_CASE(_dt_) total_bytes += types::GetArrowArrayBytes<_dt_>(col.get());
     PL_SWITCH_FOREACH_DATATYPE(types::ArrowToDataType(col->type_id()), TYPE_CASE);
 #undef TYPE_CASE
@@ -119,23 +179,60 @@ constexpr const auto& GetPBDataColumn(const table_store::schemapb::Column& data_
   }
 }
 
+template <DataType T, typename TOutputData>
+void CopyRowIntoOutputPB(TOutputData* output_data, arrow::Array* input_column, int64_t i) {
+  if constexpr (T == DataType::UINT128) {
+    auto out_datum = output_data->add_data();
+    auto val = types::GetValueFromArrowArray<DataType::UINT128>(input_column, i);
+    out_datum->set_high(absl::Uint128High64(val));
+    out_datum->set_low(absl::Uint128Low64(val));
+  } else {
+    output_data->add_data(types::GetValueFromArrowArray<T>(input_column, i));
+  }
+}
+
 template <DataType T>
-void CopyIntoOutputPB(table_store::schemapb::Column* output_column, arrow::Array* input_column) {
+void CopyIntoOutputPB(table_store::schemapb::Column* output_column, arrow::Array* input_column,
+                      const std::vector<int64_t>* selection) {
   CHECK_NOTNULL(input_column);
   CHECK_NOTNULL(output_column);
 
-  size_t col_length = input_column->length();
   auto casted_output_data = GetMutablePBDataColumn<T>(output_column);
+  if (selection != nullptr) {
+    for (int64_t i : *selection) {
+      CopyRowIntoOutputPB<T>(casted_output_data, input_column, i);
+    }
+    return;
+  }
+  size_t col_length = input_column->length();
   for (size_t i = 0; i < col_length; ++i) {
-    if constexpr (T == DataType::UINT128) {
-      auto out_datum = casted_output_data->add_data();
-      auto val = types::GetValueFromArrowArray<DataType::UINT128>(input_column, i);
-      out_datum->set_high(absl::Uint128High64(val));
-      out_datum->set_low(absl::Uint128Low64(val));
-    } else {
-      casted_output_data->add_data(types::GetValueFromArrowArray<T>(input_column, i));
+    CopyRowIntoOutputPB<T>(casted_output_data, input_column, i);
+  }
+}
+
+template <DataType T>
+Status GatherSelectedRows(const arrow::Array* input_column, const std::vector<int64_t>& selection,
+                          arrow::MemoryPool* mem_pool,
+                          std::shared_ptr<arrow::Array>* output_column) {
+  CHECK_NOTNULL(input_column);
+  auto builder = MakeArrowBuilder(T, mem_pool);
+  auto* typed_builder =
+      static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(builder.get());
+  PL_RETURN_IF_ERROR(typed_builder->Reserve(selection.size()));
+  if constexpr (T == DataType::STRING) {
+    // Size the value buffer up front so that the gather never reallocates.
+    const auto* strings = static_cast<const arrow::StringArray*>(input_column);
+    int64_t total_bytes = 0;
+    for (int64_t i : selection) {
+      total_bytes += strings->value_length(i);
     }
+    PL_RETURN_IF_ERROR(typed_builder->ReserveData(total_bytes));
+  }
+  for (int64_t i : selection) {
+    typed_builder->UnsafeAppend(types::GetValueFromArrowArray<T>(input_column, i));
   }
+  PL_RETURN_IF_ERROR(typed_builder->Finish(output_column));
+  return Status::OK();
 }
 
 template <DataType T>
@@ -159,7 +256,10 @@ Status CopyFromInputPB(std::shared_ptr<arrow::Array>* output_column,
 }
 
 Status RowBatch::ToProto(table_store::schemapb::RowBatchData* proto) const {
-  proto->set_num_rows(num_rows_);
+  if (has_deferred_columns()) {
+    return error::Internal("RowBatch with deferred columns must be compacted before serializing");
+  }
+  proto->set_num_rows(num_selected_rows());
   proto->set_eow(eow_);
   proto->set_eos(eos_);
 
@@ -168,7 +268,7 @@ Status RowBatch::ToProto(table_store::schemapb::RowBatchData* proto) const {
     auto output_col_data = proto->add_cols();
     auto dt = desc_.type(col_idx);
 
-#define TYPE_CASE(_dt_) CopyIntoOutputPB<_dt_>(output_col_data, input_col);
+#define TYPE_CASE(_dt_) CopyIntoOutputPB<_dt_>(output_col_data, input_col, selection_.get());
     PL_SWITCH_FOREACH_DATATYPE(dt, TYPE_CASE);
 #undef TYPE_CASE
   }
@@ -259,12 +359,72 @@ StatusOr<std::unique_ptr<RowBatch>> RowBatch::Slice(int64_t offset, int64_t leng
   }
   std::unique_ptr<RowBatch> output_rb = std::make_unique<RowBatch>(desc(), length);
   for (int64_t input_col_idx = 0; input_col_idx < num_columns(); ++input_col_idx) {
+    if (IsDeferred(input_col_idx)) {
+      const auto& deferred = deferred_[input_col_idx];
+      PL_RETURN_IF_ERROR(
+          output_rb->AddDeferredColumn(deferred.fetcher, deferred.row_offset + offset));
+      continue;
+    }
     auto col = ColumnAt(input_col_idx);
     PL_RETURN_IF_ERROR(output_rb->AddColumn(col->Slice(offset, length)));
   }
+  if (has_selection()) {
+    // Keep the selected rows that fall in the slice, relative to its start.
+    auto begin = std::lower_bound(selection_->begin(), selection_->end(), offset);
+    auto end = std::lower_bound(begin, selection_->end(), offset + length);
+    auto selection = std::make_shared<std::vector<int64_t>>();
+    selection->reserve(end - begin);
+    for (auto it = begin; it != end; ++it) {
+      selection->push_back(*it - offset);
+    }
+    output_rb->set_selection(std::move(selection));
+  }
   return output_rb;
 }
 
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::Compact(arrow::MemoryPool* mem_pool) const {
+  bool deferred = has_deferred_columns();
+  if (!has_selection() && !deferred) {
+    return std::make_unique<RowBatch>(*this);
+  }
+  // Deferred columns are fetched for the selected rows, or for every row without a selection.
+  std::vector<int64_t> all_rows;
+  if (deferred && !has_selection()) {
+    all_rows.resize(num_rows_);
+    std::iota(all_rows.begin(), all_rows.end(), 0);
+  }
+  const std::vector<int64_t>& rows = has_selection() ? *selection_ : all_rows;
+
+  auto output_rb = std::make_unique<RowBatch>(desc(), num_selected_rows());
+  for (int64_t col_idx = 0; col_idx < num_columns(); ++col_idx) {
+    std::shared_ptr<arrow::Array> output_col;
+    if (IsDeferred(col_idx)) {
+      PL_ASSIGN_OR_RETURN(output_col, FetchDeferredRows(col_idx, rows, mem_pool));
+    } else if (has_selection()) {
+      PL_ASSIGN_OR_RETURN(output_col,
+                          GatherRows(desc_.type(col_idx), ColumnAt(col_idx).get(), rows, mem_pool));
+    } else {
+      output_col = ColumnAt(col_idx);
+    }
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(output_col));
+  }
+  output_rb->set_eow(eow_);
+  output_rb->set_eos(eos_);
+  return output_rb;
+}
+
+StatusOr<std::shared_ptr<arrow::Array>> GatherRows(types::DataType data_type,
+                                                   const arrow::Array* input_column,
+                                                   const std::vector<int64_t>& rows,
+                                                   arrow::MemoryPool* mem_pool) {
+  std::shared_ptr<arrow::Array> output_column;
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(GatherSelectedRows<_dt_>(input_column, rows, mem_pool, &output_column));
+  PL_SWITCH_FOREACH_DATATYPE(data_type, TYPE_CASE);
+#undef TYPE_CASE
+  return output_column;
+}
+
 }  // namespace schema
 }  // namespace table_store
 }  // namespace px
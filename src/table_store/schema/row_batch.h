@@ -19,7 +19,9 @@
 #pragma once
 
 #include <arrow/array.h>
+#include <arrow/memory_pool.h>
 #include <arrow/type.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -39,6 +41,13 @@ namespace schema {
  */
 class RowBatch {
  public:
+  /**
+   * Fetches rows of a deferred column. The rows are sorted offsets from the first row the fetcher
+   * was created for, and the returned array holds exactly those rows, in order.
+   */
+  using ColumnFetcher = std::function<StatusOr<std::shared_ptr<arrow::Array>>(
+      const std::vector<int64_t>& rows, arrow::MemoryPool* mem_pool)>;
+
   /**
    * Creates a row batch.
    *
@@ -76,12 +85,45 @@ class RowBatch {
    */
   StatusOr<std::unique_ptr<RowBatch>> Slice(int64_t offset, int64_t length) const;
 
+  /**
+   * @brief Returns a RowBatch that only contains the selected rows, copied into dense columns.
+   *
+   * Deferred columns are fetched for just the selected rows. Batches without a selection vector
+   * or deferred columns are returned as a shallow copy. Keeps eow and eos.
+   *
+   * @param mem_pool The pool to allocate the copied columns from.
+   * @return StatusOr<std::unique_ptr<RowBatch>>
+   */
+  StatusOr<std::unique_ptr<RowBatch>> Compact(arrow::MemoryPool* mem_pool) const;
+
   /**
    * Adds the given column to the row batch, given that it correctly fits the schema.
    * param col ptr to the arrow array that should be added to the row batch.
    */
   Status AddColumn(const std::shared_ptr<arrow::Array>& col);
 
+  /**
+   * Adds a deferred column, whose values stay wherever the fetcher reads them from until the
+   * batch is compacted. This lets a source skip copying a large column for the rows that a filter
+   * drops. Only consumers that accept deferred columns get such batches, and ColumnAt() returns
+   * null for them.
+   *
+   * @param fetcher fetches the rows of the column.
+   * @param row_offset the offset of the first row of the batch in the fetcher's rows.
+   */
+  Status AddDeferredColumn(std::shared_ptr<const ColumnFetcher> fetcher, int64_t row_offset = 0);
+
+  /**
+   * Adds the column at the given index of another batch with the same number of rows. Deferred
+   * columns stay deferred.
+   */
+  Status AddColumnFrom(const RowBatch& rb, int64_t col_idx);
+
+  bool IsDeferred(int64_t i) const {
+    return static_cast<size_t>(i) < deferred_.size() && deferred_[i].fetcher != nullptr;
+  }
+  bool has_deferred_columns() const;
+
   /**
    * @ param i the index of the column to be accessed.
    * @ returns the Arrow array for the column at the given index.
@@ -110,6 +152,28 @@ class RowBatch {
 
   bool eos() const { return eos_; }
   void set_eos(bool val) { eos_ = val; }
+
+  /**
+   * A selection vector holds the sorted indices of the rows that are logically part of the batch,
+   * which lets operators drop rows without copying the columns. The columns still hold num_rows()
+   * physical rows. Consumers that need dense columns call Compact().
+   */
+  bool has_selection() const { return selection_ != nullptr; }
+  const std::vector<int64_t>& selection() const { return *selection_; }
+  // Lets a derived batch that keeps the same physical rows share the selection vector.
+  const std::shared_ptr<const std::vector<int64_t>>& shared_selection() const {
+    return selection_;
+  }
+  void set_selection(std::shared_ptr<const std::vector<int64_t>> selection) {
+    selection_ = std::move(selection);
+  }
+
+  /**
+   * @ return the number of rows that are logically part of the batch.
+   */
+  int64_t num_selected_rows() const {
+    return has_selection() ? static_cast<int64_t>(selection_->size()) : num_rows_;
+  }
   /**
    * @ return the row descriptor which describes the schema of the row batch.
    */
@@ -126,8 +190,28 @@ class RowBatch {
   bool eow_ = false;
   bool eos_ = false;
   std::vector<std::shared_ptr<arrow::Array>> columns_;
+  // Null when every row is selected.
+  std::shared_ptr<const std::vector<int64_t>> selection_;
+
+  struct DeferredColumn {
+    std::shared_ptr<const ColumnFetcher> fetcher;
+    int64_t row_offset = 0;
+  };
+  StatusOr<std::shared_ptr<arrow::Array>> FetchDeferredRows(int64_t col_idx,
+                                                            const std::vector<int64_t>& rows,
+                                                            arrow::MemoryPool* mem_pool) const;
+  // Empty unless the batch has deferred columns, in which case it is indexed like columns_.
+  std::vector<DeferredColumn> deferred_;
 };
 
+/**
+ * Copies the given rows of an arrow array into a new, dense array.
+ */
+StatusOr<std::shared_ptr<arrow::Array>> GatherRows(types::DataType data_type,
+                                                   const arrow::Array* input_column,
+                                                   const std::vector<int64_t>& rows,
+                                                   arrow::MemoryPool* mem_pool);
+
 // Append a scalar value to an arrow::Array.
 template <types::DataType T>
 Status CopyValue(arrow::ArrayBuilder* output_col_builder,
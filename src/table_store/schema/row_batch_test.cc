@@ -19,6 +19,7 @@
 #include <arrow/array.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
+#include <memory>
 #include <vector>
 
 #include "src/common/testing/testing.h"
@@ -231,6 +232,96 @@ TEST_F(RowBatchTest, slice) {
   ASSERT_EQ(status2.msg(), "Slice(offset=-1, length=3) on rowbatch of length 3 is invalid");
 }
 
+TEST_F(RowBatchTest, selection) {
+  EXPECT_FALSE(rb_->has_selection());
+  EXPECT_EQ(3, rb_->num_selected_rows());
+
+  rb_->set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{0, 2}));
+  rb_->set_eow(true);
+  EXPECT_TRUE(rb_->has_selection());
+  EXPECT_EQ(3, rb_->num_rows());
+  EXPECT_EQ(2, rb_->num_selected_rows());
+
+  ASSERT_OK_AND_ASSIGN(auto compacted, rb_->Compact(arrow::default_memory_pool()));
+  EXPECT_FALSE(compacted->has_selection());
+  EXPECT_EQ(2, compacted->num_rows());
+  EXPECT_TRUE(compacted->eow());
+  EXPECT_EQ("RowBatch(eow=1, eos=0):\n  [\n  true,\n  true\n]\n  [\n  3,\n  5\n]\n  [\n  "
+            "3.3,\n  5.6\n]\n",
+            compacted->DebugString());
+
+  // Slices keep the selected rows that fall in them, relative to the start of the slice.
+  ASSERT_OK_AND_ASSIGN(auto slice, rb_->Slice(1, 2));
+  ASSERT_TRUE(slice->has_selection());
+  EXPECT_THAT(slice->selection(), ::testing::ElementsAre(1));
+
+  // Only the selected rows are serialized.
+  table_store::schemapb::RowBatchData proto;
+  EXPECT_OK(rb_->ToProto(&proto));
+  EXPECT_EQ(2, proto.num_rows());
+  EXPECT_EQ(2, proto.cols(1).int64_data().data_size());
+  EXPECT_EQ(5, proto.cols(1).int64_data().data(1));
+}
+
+TEST_F(RowBatchTest, compact_strings) {
+  RowBatch rb(RowDescriptor({types::DataType::STRING}), 4);
+  std::vector<types::StringValue> in = {"a", "bcd", "", "efgh"};
+  EXPECT_OK(rb.AddColumn(types::ToArrow(in, arrow::default_memory_pool())));
+  rb.set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1, 2, 3}));
+
+  ASSERT_OK_AND_ASSIGN(auto compacted, rb.Compact(arrow::default_memory_pool()));
+  std::vector<types::StringValue> expected = {"bcd", "", "efgh"};
+  EXPECT_TRUE(
+      compacted->ColumnAt(0)->Equals(types::ToArrow(expected, arrow::default_memory_pool())));
+}
+
+TEST_F(RowBatchTest, deferred_columns) {
+  std::vector<types::StringValue> values = {"a", "bc", "def", "ghij", "k"};
+  auto backing = types::ToArrow(values, arrow::default_memory_pool());
+  std::vector<std::vector<int64_t>> fetched;
+  auto fetcher = std::make_shared<const RowBatch::ColumnFetcher>(
+      [&](const std::vector<int64_t>& rows,
+          arrow::MemoryPool* mem_pool) -> StatusOr<std::shared_ptr<arrow::Array>> {
+        fetched.push_back(rows);
+        return GatherRows(types::DataType::STRING, backing.get(), rows, mem_pool);
+      });
+
+  RowBatch rb(RowDescriptor({types::DataType::INT64, types::DataType::STRING}), 4);
+  std::vector<types::Int64Value> ints = {1, 2, 3, 4};
+  EXPECT_OK(rb.AddColumn(types::ToArrow(ints, arrow::default_memory_pool())));
+  // The batch starts at the second row of the fetcher.
+  EXPECT_OK(rb.AddDeferredColumn(fetcher, 1));
+  EXPECT_FALSE(rb.IsDeferred(0));
+  EXPECT_TRUE(rb.IsDeferred(1));
+  EXPECT_TRUE(rb.has_deferred_columns());
+  EXPECT_EQ(4 * sizeof(int64_t), rb.NumBytes());
+  table_store::schemapb::RowBatchData proto;
+  EXPECT_NOT_OK(rb.ToProto(&proto));
+
+  // Projections and slices keep the column deferred.
+  RowBatch projected(RowDescriptor({types::DataType::STRING}), 4);
+  EXPECT_OK(projected.AddColumnFrom(rb, 1));
+  EXPECT_TRUE(projected.IsDeferred(0));
+  ASSERT_OK_AND_ASSIGN(auto slice, projected.Slice(2, 2));
+  EXPECT_TRUE(slice->IsDeferred(0));
+
+  // Only the selected rows get fetched.
+  slice->set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1}));
+  ASSERT_OK_AND_ASSIGN(auto compacted, slice->Compact(arrow::default_memory_pool()));
+  EXPECT_FALSE(compacted->has_deferred_columns());
+  std::vector<types::StringValue> expected = {"k"};
+  EXPECT_TRUE(
+      compacted->ColumnAt(0)->Equals(types::ToArrow(expected, arrow::default_memory_pool())));
+  EXPECT_THAT(fetched, ::testing::ElementsAre(std::vector<int64_t>{4}));
+
+  // Without a selection, every row gets fetched.
+  ASSERT_OK_AND_ASSIGN(compacted, rb.Compact(arrow::default_memory_pool()));
+  EXPECT_EQ(4, compacted->num_rows());
+  expected = {"bc", "def", "ghij", "k"};
+  EXPECT_TRUE(
+      compacted->ColumnAt(1)->Equals(types::ToArrow(expected, arrow::default_memory_pool())));
+}
+
 }  // namespace schema
 }  // namespace table_store
 }  // namespace px
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/ndv_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace px {
+namespace table_store {
+
+int64_t NDVSketch::Estimate() const {
+  constexpr double kNumRegistersF = kNumRegisters;
+  constexpr double kAlpha = 0.7213 / (1 + 1.079 / kNumRegistersF);
+
+  double inverse_sum = 0;
+  int num_zero_registers = 0;
+  for (uint8_t reg : registers_) {
+    inverse_sum += std::ldexp(1.0, -reg);
+    num_zero_registers += reg == 0;
+  }
+  double estimate = kAlpha * kNumRegistersF * kNumRegistersF / inverse_sum;
+  // Use linear counting for small cardinalities, where the raw estimate is biased.
+  if (estimate <= 2.5 * kNumRegistersF && num_zero_registers > 0) {
+    estimate = kNumRegistersF * std::log(kNumRegistersF / num_zero_registers);
+  }
+  return std::llround(estimate);
+}
+
+void NDVSketch::Merge(const NDVSketch& other) {
+  for (int i = 0; i < kNumRegisters; ++i) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+}
+
+}  // namespace table_store
+}  // namespace px
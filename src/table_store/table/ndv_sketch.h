@@ -0,0 +1,67 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace px {
+namespace table_store {
+
+/**
+ * NDVSketch estimates the number of distinct values added to it, using a HyperLogLog sketch with
+ * 2^kPrecision one-byte registers. The standard error of the estimate is about 1.04/sqrt(2^p),
+ * i.e. ~3% for the default precision.
+ *
+ * Values are added by their 64-bit hash, which must be well mixed (e.g. farmhash).
+ */
+class NDVSketch {
+ public:
+  static constexpr int kPrecision = 10;
+  static constexpr int kNumRegisters = 1 << kPrecision;
+
+  void Add(uint64_t hash) {
+    uint64_t idx = hash >> (64 - kPrecision);
+    // The rank is the position of the first set bit in the remaining bits, starting at 1. The
+    // sentinel bit bounds it when all of the remaining bits are zero.
+    uint64_t rest = (hash << kPrecision) | (uint64_t{1} << (kPrecision - 1));
+    auto rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+    if (rank > registers_[idx]) {
+      registers_[idx] = rank;
+    }
+  }
+
+  /**
+   * @return the estimated number of distinct values added so far.
+   */
+  int64_t Estimate() const;
+
+  /**
+   * Adds all of the values of the other sketch to this one.
+   */
+  void Merge(const NDVSketch& other);
+
+  void Reset() { registers_.fill(0); }
+
+ private:
+  std::array<uint8_t, kNumRegisters> registers_{};
+};
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <farmhash.h>
+#include <gtest/gtest.h>
+
+#include "src/table_store/table/ndv_sketch.h"
+
+namespace px {
+namespace table_store {
+
+uint64_t HashInt(int64_t val) {
+  return ::util::Hash64(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+TEST(NDVSketchTest, Empty) {
+  NDVSketch sketch;
+  EXPECT_EQ(0, sketch.Estimate());
+}
+
+TEST(NDVSketchTest, SmallCardinality) {
+  NDVSketch sketch;
+  for (int i = 0; i < 1000; ++i) {
+    sketch.Add(HashInt(i % 10));
+  }
+  EXPECT_EQ(10, sketch.Estimate());
+}
+
+TEST(NDVSketchTest, LargeCardinality) {
+  NDVSketch sketch;
+  for (int i = 0; i < 100000; ++i) {
+    sketch.Add(HashInt(i));
+  }
+  EXPECT_NEAR(100000, sketch.Estimate(), 10000);
+}
+
+TEST(NDVSketchTest, Merge) {
+  NDVSketch sketch1;
+  NDVSketch sketch2;
+  for (int i = 0; i < 5000; ++i) {
+    sketch1.Add(HashInt(i));
+    sketch2.Add(HashInt(i + 2500));
+  }
+  sketch1.Merge(sketch2);
+  EXPECT_NEAR(7500, sketch1.Estimate(), 750);
+
+  sketch1.Reset();
+  EXPECT_EQ(0, sketch1.Estimate());
+}
+
+}  // namespace table_store
+}  // namespace px
@@ -26,17 +26,23 @@
 #include <vector>
 
 #include <absl/strings/str_format.h>
+#include <farmhash.h>
 #include "src/common/base/base.h"
 #include "src/common/base/status.h"
 #include "src/shared/types/arrow_adapter.h"
 #include "src/shared/types/type_utils.h"
 #include "src/table_store/schema/relation.h"
+#include "src/table_store/table/ndv_sketch.h"
 #include "src/table_store/table/table.h"
 
 DEFINE_int32(table_store_table_size_limit,
              gflags::Int32FromEnv("PL_TABLE_STORE_TABLE_SIZE_LIMIT", 1024 * 1024 * 64),
              "The maximal size a table allows. When the size grows beyond this limit, "
              "old data will be discarded.");
+DEFINE_bool(table_store_column_ndv_sketches,
+            gflags::BoolFromEnv("PL_TABLE_STORE_COLUMN_NDV_SKETCHES", false),
+            "Whether to estimate the number of distinct values of each table column for the "
+            "query planner's statistics. Each estimate hashes every row in the table.");
 
 namespace px {
 namespace table_store {
@@ -98,6 +104,54 @@ Table::Table(std::string_view table_name, const schema::Relation& relation, size
   }
 }
 
+namespace {
+
+template <typename TValueType>
+uint64_t HashForNDV(const TValueType& value) {
+  return ::util::Hash64(reinterpret_cast<const char*>(&value.val), sizeof(value.val));
+}
+
+template <>
+uint64_t HashForNDV<types::StringValue>(const types::StringValue& value) {
+  return ::util::Hash64(value);
+}
+
+template <types::DataType DT>
+void AddArrowArrayToSketch(const arrow::Array* arr, NDVSketch* sketch) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  for (int64_t i = 0; i < arr->length(); ++i) {
+    sketch->Add(HashForNDV(ValueType(types::GetValueFromArrowArray<DT>(arr, i))));
+  }
+}
+
+template <types::DataType DT>
+void AddColumnWrapperToSketch(const types::ColumnWrapper& col, NDVSketch* sketch) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  for (size_t i = 0; i < col.Size(); ++i) {
+    sketch->Add(HashForNDV(col.Get<ValueType>(i)));
+  }
+}
+
+// Returns a fetcher that copies rows of a hot column, starting at row_start, into an arrow array.
+// The fetcher holds a reference to the column, so it stays valid after the batch is expired or
+// compacted to cold storage.
+std::shared_ptr<const schema::RowBatch::ColumnFetcher> DeferredColumnFetcher(
+    types::SharedColumnWrapper col, int64_t row_start) {
+  return std::make_shared<const schema::RowBatch::ColumnFetcher>(
+      [col = std::move(col), row_start](const std::vector<int64_t>& rows,
+                                        arrow::MemoryPool* mem_pool)
+          -> StatusOr<std::shared_ptr<arrow::Array>> {
+        std::vector<size_t> indexes;
+        indexes.reserve(rows.size());
+        for (int64_t row : rows) {
+          indexes.push_back(row_start + row);
+        }
+        return col->CopyIndexes(indexes)->ConvertToArrow(mem_pool);
+      });
+}
+
+}  // namespace
+
 Status Table::ToProto(table_store::schemapb::Table* table_proto) const {
   CHECK(table_proto != nullptr);
   std::vector<int64_t> col_selector;
@@ -132,7 +186,25 @@ StatusOr<std::unique_ptr<schema::RowBatch>> Table::GetRowBatchSlice(
 
   auto batch_size = slice.Size();
   auto output_rb = std::make_unique<schema::RowBatch>(schema::RowDescriptor(rb_types), batch_size);
-  PL_RETURN_IF_ERROR(AddBatchSliceToRowBatch(slice, cols, output_rb.get(), mem_pool));
+  PL_RETURN_IF_ERROR(AddBatchSliceToRowBatch(slice, cols, {}, output_rb.get(), mem_pool));
+  return output_rb;
+}
+
+StatusOr<std::unique_ptr<schema::RowBatch>> Table::GetRowBatchSliceDeferred(
+    const BatchSlice& slice, const std::vector<int64_t>& cols,
+    const std::vector<int64_t>& deferred_cols, arrow::MemoryPool* mem_pool) const {
+  if (!slice.IsValid())
+    return error::InvalidArgument("GetRowBatchSliceDeferred called on invalid BatchSlice");
+  std::vector<types::DataType> rb_types;
+  for (int64_t col_idx : cols) {
+    DCHECK(static_cast<size_t>(col_idx) < rel_.NumColumns());
+    rb_types.push_back(rel_.col_types()[col_idx]);
+  }
+
+  auto output_rb =
+      std::make_unique<schema::RowBatch>(schema::RowDescriptor(rb_types), slice.Size());
+  PL_RETURN_IF_ERROR(
+      AddBatchSliceToRowBatch(slice, cols, deferred_cols, output_rb.get(), mem_pool));
   return output_rb;
 }
 
@@ -185,6 +257,7 @@ Status Table::WriteRowBatch(const schema::RowBatch& rb) {
   PL_RETURN_IF_ERROR(WriteHot(rb));
   absl::base_internal::SpinLockHolder lock(&stats_lock_);
   hot_bytes_ += rb_bytes;
+  num_rows_ += rb.num_rows();
   ++batches_added_;
   return Status::OK();
 }
@@ -196,6 +269,16 @@ Status Table::TransferRecordBatch(
     return Status::OK();
   }
 
+  // Columns that were built in arrow buffers are adopted as they are, and stored like a RowBatch.
+  if (std::all_of(record_batch->begin(), record_batch->end(),
+                  [](const auto& col) { return col->IsArrowBacked(); })) {
+    schema::RowBatch rb(schema::RowDescriptor(rel_.col_types()), record_batch->at(0)->Size());
+    for (const auto& col : *record_batch) {
+      PL_RETURN_IF_ERROR(rb.AddColumn(col->ConvertToArrow(arrow::default_memory_pool())));
+    }
+    return WriteRowBatch(rb);
+  }
+
   // Check for matching types
   auto received_num_columns = record_batch->size();
   auto expected_num_columns = rel_.NumColumns();
@@ -216,10 +299,12 @@ Status Table::TransferRecordBatch(
   }
 
   PL_RETURN_IF_ERROR(ExpireRowBatches(rb_bytes));
+  int64_t num_rows = record_batch->at(0)->Size();
   PL_RETURN_IF_ERROR(WriteHot(std::move(record_batch)));
 
   absl::base_internal::SpinLockHolder lock(&stats_lock_);
   hot_bytes_ += rb_bytes;
+  num_rows_ += num_rows;
   ++batches_added_;
 
   return Status::OK();
@@ -311,10 +396,69 @@ TableStats Table::GetTableStats() const {
   info.cold_bytes = cold_bytes_;
   info.compacted_batches = compacted_batches_;
   info.max_table_size = max_table_size_;
+  info.num_rows = num_rows_;
 
   return info;
 }
 
+std::vector<int64_t> Table::EstimateColumnNDVs() const {
+  std::vector<int64_t> ndvs(rel_.NumColumns(), -1);
+  if (!FLAGS_table_store_column_ndv_sketches) {
+    return ndvs;
+  }
+
+  // Copy out references to the batches so that the rows are hashed without holding the table
+  // locks. The hot batches are copied first: a batch compacted in between is then seen twice,
+  // which doesn't change the estimate, rather than not at all.
+  std::vector<schema::RowBatch> hot_row_batches;
+  std::vector<types::ColumnWrapperRecordBatch> hot_record_batches;
+  {
+    absl::MutexLock hot_lock(&hot_lock_);
+    for (const auto& batch : hot_batches_) {
+      if (std::holds_alternative<RecordBatchWithCache>(batch)) {
+        hot_record_batches.push_back(*std::get<RecordBatchWithCache>(batch).record_batch);
+      } else {
+        hot_row_batches.push_back(std::get<schema::RowBatch>(batch));
+      }
+    }
+  }
+  std::vector<ColumnBuffer> cold_columns(rel_.NumColumns());
+  {
+    absl::MutexLock cold_lock(&cold_lock_);
+    for (int64_t i = 0; i < RingSizeUnlocked(); ++i) {
+      auto ring_index = RingIndexUnlocked(i);
+      for (size_t col_idx = 0; col_idx < rel_.NumColumns(); ++col_idx) {
+        cold_columns[col_idx].push_back(cold_column_buffers_[col_idx][ring_index]);
+      }
+    }
+  }
+
+  for (size_t col_idx = 0; col_idx < rel_.NumColumns(); ++col_idx) {
+    auto col_type = rel_.GetColumnType(col_idx);
+    if (col_type == types::TIME64NS || col_type == types::FLOAT64) {
+      continue;
+    }
+    NDVSketch sketch;
+    for (const auto& arr : cold_columns[col_idx]) {
+#define TYPE_CASE(_dt_) AddArrowArrayToSketch<_dt_>(arr.get(), &sketch);
+      PL_SWITCH_FOREACH_DATATYPE(col_type, TYPE_CASE);
+#undef TYPE_CASE
+    }
+    for (const auto& rb : hot_row_batches) {
+#define TYPE_CASE(_dt_) AddArrowArrayToSketch<_dt_>(rb.ColumnAt(col_idx).get(), &sketch);
+      PL_SWITCH_FOREACH_DATATYPE(col_type, TYPE_CASE);
+#undef TYPE_CASE
+    }
+    for (const auto& record_batch : hot_record_batches) {
+#define TYPE_CASE(_dt_) AddColumnWrapperToSketch<_dt_>(*record_batch[col_idx], &sketch);
+      PL_SWITCH_FOREACH_DATATYPE(col_type, TYPE_CASE);
+#undef TYPE_CASE
+    }
+    ndvs[col_idx] = sketch.Estimate();
+  }
+  return ndvs;
+}
+
 Status Table::UpdateTimeRowIndices(types::ColumnWrapperRecordBatch* record_batch) {
   auto batch_length = record_batch->at(0)->Size();
   DCHECK_GT(batch_length, 0);
@@ -454,12 +598,14 @@ Status Table::CompactHotToCold(arrow::MemoryPool* mem_pool) {
 
 StatusOr<bool> Table::ExpireCold() {
   int64_t rb_bytes = 0;
+  int64_t rb_rows = 0;
   {
     absl::MutexLock gen_lock(&generation_lock_);
     absl::MutexLock cold_lock(&cold_lock_);
     if (RingSizeUnlocked() == 0) {
       return false;
     }
+    rb_rows = cold_row_ids_.front().second - cold_row_ids_.front().first + 1;
     cold_row_ids_.pop_front();
     if (time_col_idx_ != -1) cold_time_.pop_front();
 
@@ -481,11 +627,13 @@ StatusOr<bool> Table::ExpireCold() {
   }
   absl::base_internal::SpinLockHolder lock(&stats_lock_);
   cold_bytes_ -= rb_bytes;
+  num_rows_ -= rb_rows;
   return true;
 }
 
 Status Table::ExpireHot() {
   RecordOrRowBatch record_or_row_batch;
+  int64_t rb_rows = 0;
   {
     absl::MutexLock gen_lock(&generation_lock_);
     absl::MutexLock hot_lock(&hot_lock_);
@@ -493,6 +641,7 @@ Status Table::ExpireHot() {
       return error::InvalidArgument("Failed to expire row batch, no row batches in table");
     }
     if (time_col_idx_ != -1) hot_time_.pop_front();
+    rb_rows = hot_row_ids_.front().second - hot_row_ids_.front().first + 1;
     hot_row_ids_.pop_front();
     record_or_row_batch = std::move(hot_batches_.front());
     hot_batches_.pop_front();
@@ -517,6 +666,7 @@ Status Table::ExpireHot() {
   {
     absl::base_internal::SpinLockHolder lock(&stats_lock_);
     hot_bytes_ -= rb_bytes;
+    num_rows_ -= rb_rows;
   }
   return Status::OK();
 }
@@ -532,6 +682,7 @@ Status Table::ExpireBatch() {
 }
 
 Status Table::AddBatchSliceToRowBatch(const BatchSlice& slice, const std::vector<int64_t>& cols,
+                                      const std::vector<int64_t>& deferred_cols,
                                       schema::RowBatch* output_rb,
                                       arrow::MemoryPool* mem_pool) const {
   absl::MutexLock gen_lock(&generation_lock_);
@@ -558,6 +709,15 @@ Status Table::AddBatchSliceToRowBatch(const BatchSlice& slice, const std::vector
         PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
         continue;
       }
+      const auto& col = record_batch_ptr->record_batch->at(col_idx);
+      if (!col->IsArrowBacked() &&
+          std::find(deferred_cols.begin(), deferred_cols.end(), col_idx) != deferred_cols.end()) {
+        // Converting would copy the column for every row of the batch, so only the rows that a
+        // consumer needs get copied, once it asks for them.
+        PL_RETURN_IF_ERROR(
+            output_rb->AddDeferredColumn(DeferredColumnFetcher(col, slice.unsafe_row_start)));
+        continue;
+      }
       // Arrow array wasn't in cache, Convert to arrow and then add to cache.
       auto arr = record_batch_ptr->record_batch->at(col_idx)->ConvertToArrow(mem_pool);
       record_batch_ptr->arrow_cache[col_idx] = arr;
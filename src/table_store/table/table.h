@@ -43,6 +43,7 @@
 #include "src/table_store/table/table_metrics.h"
 
 DECLARE_int32(table_store_table_size_limit);
+DECLARE_bool(table_store_column_ndv_sketches);
 
 namespace px {
 namespace table_store {
@@ -57,6 +58,7 @@ struct TableStats {
   int64_t batches_expired;
   int64_t compacted_batches;
   int64_t max_table_size;
+  int64_t num_rows;
 };
 
 struct BatchSlice {
@@ -228,6 +230,22 @@ class Table : public NotCopyable {
                                                                const std::vector<int64_t>& cols,
                                                                arrow::MemoryPool* mem_pool) const;
 
+  /**
+   * Like GetRowBatchSlice, but the columns in `deferred_cols` are only copied out of the table for
+   * the rows that a consumer ends up needing. Columns that are already stored as arrow arrays are
+   * returned as zero-copy slices either way. The others become deferred columns of the RowBatch,
+   * which copy the rows out when it is compacted. Deferred columns keep the table's column data
+   * alive, so they can be read even if the batch has expired by then.
+   * @param slice the BatchSlice to get the data for.
+   * @param cols a vector of column indices to get data for.
+   * @param deferred_cols the column indices, out of cols, that may be deferred.
+   * @param mem_pool the arrow memory pool to use if the slice is in hot storage.
+   * @return a unique ptr to a RowBatch with the requested data.
+   */
+  StatusOr<std::unique_ptr<schema::RowBatch>> GetRowBatchSliceDeferred(
+      const BatchSlice& slice, const std::vector<int64_t>& cols,
+      const std::vector<int64_t>& deferred_cols, arrow::MemoryPool* mem_pool) const;
+
   /**
    * Writes a row batch to the table.
    * @param rb Rowbatch to write to the table.
@@ -235,7 +253,8 @@ class Table : public NotCopyable {
   Status WriteRowBatch(const schema::RowBatch& rb);
 
   /**
-   * Transfers the given record batch (from Stirling) into the Table.
+   * Transfers the given record batch (from Stirling) into the Table. If its columns are arrow
+   * backed (see types::ArrowColumnWrapper), their buffers are adopted without a conversion.
    *
    * @param record_batch the record batch to be appended to the Table.
    * @return status
@@ -271,6 +290,14 @@ class Table : public NotCopyable {
 
   TableStats GetTableStats() const;
 
+  /**
+   * Estimates the number of distinct values in each column from the rows currently in the table.
+   * Unlike GetTableStats, this hashes every row, so it should only be called occasionally.
+   * @return the estimate for each column, or -1 for time and float columns, and for every column
+   * when FLAGS_table_store_column_ndv_sketches is false.
+   */
+  std::vector<int64_t> EstimateColumnNDVs() const;
+
   /**
    * Gets the BatchSlice corresponding to the next batch after the given batch.
    * The BatchSlice will be cut short to ensure it doesn't extend past the given StopPosition.
@@ -325,6 +352,7 @@ class Table : public NotCopyable {
   int64_t hot_bytes_ ABSL_GUARDED_BY(stats_lock_) = 0;
   int64_t batches_added_ ABSL_GUARDED_BY(stats_lock_) = 0;
   int64_t compacted_batches_ ABSL_GUARDED_BY(stats_lock_) = 0;
+  int64_t num_rows_ ABSL_GUARDED_BY(stats_lock_) = 0;
   int64_t max_table_size_ = 0;
   int64_t min_cold_batch_size_;
 
@@ -368,6 +396,7 @@ class Table : public NotCopyable {
   Status CompactSingleBatch(arrow::MemoryPool* mem_pool);
 
   Status AddBatchSliceToRowBatch(const BatchSlice& slice, const std::vector<int64_t>& cols,
+                                 const std::vector<int64_t>& deferred_cols,
                                  schema::RowBatch* output_rb, arrow::MemoryPool* mem_pool) const;
   ArrowArrayPtr GetHotColumnUnlocked(const RecordBatchWithCache* record_batch_ptr, int64_t col_idx,
                                      arrow::MemoryPool* mem_pool) const
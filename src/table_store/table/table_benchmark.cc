@@ -166,6 +166,137 @@ static void BM_TableReadLastBatchAllCold(benchmark::State& state) {
   state.SetBytesProcessed(state.iterations() * batch_size);
 }
 
+static inline std::unique_ptr<Table> MakeStringTable(int64_t max_size, int64_t compaction_size) {
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS,
+                                                     types::DataType::INT64,
+                                                     types::DataType::STRING}),
+                       std::vector<std::string>({"time_", "resp_status", "resp_body"}));
+  return std::make_unique<Table>("test_table", rel, max_size, compaction_size);
+}
+
+// Fills the table with hot batches whose string column dominates the size of the rows, like the
+// bodies of http_events.
+static inline void FillStringTableHot(Table* table, int64_t num_batches, int64_t batch_length,
+                                      int64_t body_size) {
+  for (int64_t i = 0; i < num_batches; ++i) {
+    auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto time_col = std::make_shared<types::Time64NSValueColumnWrapper>(batch_length);
+    auto status_col = std::make_shared<types::Int64ValueColumnWrapper>(batch_length);
+    auto body_col = std::make_shared<types::StringValueColumnWrapper>(batch_length);
+    for (int64_t j = 0; j < batch_length; ++j) {
+      (*time_col)[j] = i * batch_length + j;
+      (*status_col)[j] = j % 1000 == 0 ? 500 : 200;
+      (*body_col)[j] = std::string(body_size, 'a' + j % 26);
+    }
+    wrapper_batch->push_back(time_col);
+    wrapper_batch->push_back(status_col);
+    wrapper_batch->push_back(body_col);
+    PL_CHECK_OK(table->TransferRecordBatch(std::move(wrapper_batch)));
+  }
+}
+
+// Reads every column of a hot table and keeps the 0.1% of rows that a filter on the status
+// would, with the string column deferred if state.range(0) is set.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableReadFilteredStringsHot(benchmark::State& state) {
+  bool deferred = state.range(0);
+  int64_t num_batches = 64;
+  int64_t batch_length = 4096;
+  int64_t body_size = 1024;
+  int64_t table_size = 2 * num_batches * batch_length * (body_size + 2 * sizeof(int64_t));
+  int64_t compaction_size = 64 * 1024;
+  std::vector<int64_t> deferred_cols;
+  if (deferred) {
+    deferred_cols.push_back(2);
+  }
+
+  auto table = MakeStringTable(table_size, compaction_size);
+  FillStringTableHot(table.get(), num_batches, batch_length, body_size);
+  for (auto _ : state) {
+    for (auto slice = table->FirstBatch(); slice.IsValid(); slice = table->NextBatch(slice)) {
+      auto rb = table->GetRowBatchSliceDeferred(slice, {0, 1, 2}, deferred_cols,
+                                                arrow::default_memory_pool())
+                    .ConsumeValueOrDie();
+      const auto* status = static_cast<const arrow::Int64Array*>(rb->ColumnAt(1).get());
+      auto selection = std::make_shared<std::vector<int64_t>>();
+      for (int64_t i = 0; i < rb->num_rows(); ++i) {
+        if (status->Value(i) == 500) {
+          selection->push_back(i);
+        }
+      }
+      rb->set_selection(std::move(selection));
+      benchmark::DoNotOptimize(rb->Compact(arrow::default_memory_pool()));
+    }
+    state.PauseTiming();
+    // Reading the whole string column caches its arrow conversion, so start from a fresh table.
+    table = MakeStringTable(table_size, compaction_size);
+    FillStringTableHot(table.get(), num_batches, batch_length, body_size);
+    state.ResumeTiming();
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_batches * batch_length);
+}
+
+// Builds a batch like FillStringTableHot, either in column wrappers of value types, or in arrow
+// backed column wrappers.
+static inline std::unique_ptr<types::ColumnWrapperRecordBatch> MakeStringBatch(
+    bool arrow_backed, int64_t batch_idx, int64_t batch_length, int64_t body_size) {
+  auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  std::vector<types::DataType> col_types = {types::DataType::TIME64NS, types::DataType::INT64,
+                                            types::DataType::STRING};
+  for (auto type : col_types) {
+    auto col = arrow_backed
+                   ? types::ColumnWrapper::MakeArrowBacked(type, arrow::default_memory_pool())
+                   : types::ColumnWrapper::Make(type, 0);
+    col->Reserve(batch_length);
+    wrapper_batch->push_back(col);
+  }
+
+  for (int64_t j = 0; j < batch_length; ++j) {
+    types::Time64NSValue time = batch_idx * batch_length + j;
+    types::Int64Value status = j % 1000 == 0 ? 500 : 200;
+    types::StringValue body(body_size, 'a' + j % 26);
+    if (arrow_backed) {
+      static_cast<types::ArrowColumnWrapper<types::Time64NSValue>*>((*wrapper_batch)[0].get())
+          ->Append(time);
+      static_cast<types::ArrowColumnWrapper<types::Int64Value>*>((*wrapper_batch)[1].get())
+          ->Append(status);
+      static_cast<types::ArrowColumnWrapper<types::StringValue>*>((*wrapper_batch)[2].get())
+          ->Append(body);
+    } else {
+      (*wrapper_batch)[0]->Append(time);
+      (*wrapper_batch)[1]->Append(status);
+      (*wrapper_batch)[2]->Append(std::move(body));
+    }
+  }
+  return wrapper_batch;
+}
+
+// Builds string batches, writes them to the table and compacts them to cold, which is the path of
+// every traced byte from Stirling. The batches are built in arrow buffers if state.range(0) is set,
+// in which case the table adopts them instead of converting them.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableWriteCompactStrings(benchmark::State& state) {
+  bool arrow_backed = state.range(0);
+  int64_t num_batches = 64;
+  int64_t batch_length = 1024;
+  int64_t body_size = 1024;
+  int64_t table_size = 2 * num_batches * batch_length * (body_size + 2 * sizeof(int64_t));
+  // One hot batch per cold batch, so that a single compaction call moves all of them.
+  int64_t compaction_size = batch_length * body_size;
+
+  for (auto _ : state) {
+    auto table = MakeStringTable(table_size, compaction_size);
+    for (int64_t i = 0; i < num_batches; ++i) {
+      PL_CHECK_OK(table->TransferRecordBatch(
+          MakeStringBatch(arrow_backed, i, batch_length, body_size)));
+    }
+    PL_CHECK_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+  }
+
+  state.SetBytesProcessed(state.iterations() * num_batches * batch_length * body_size);
+}
+
 // NOLINTNEXTLINE : runtime/references.
 static void BM_TableWriteEmpty(benchmark::State& state) {
   int64_t table_size = 4 * 1024 * 1024;
@@ -340,6 +471,8 @@ BENCHMARK(BM_TableReadAllHot);
 BENCHMARK(BM_TableReadAllCold);
 BENCHMARK(BM_TableReadLastBatchAllHot)->Iterations(1000);
 BENCHMARK(BM_TableReadLastBatchAllCold)->Iterations(1000);
+BENCHMARK(BM_TableReadFilteredStringsHot)->Arg(false)->Arg(true);
+BENCHMARK(BM_TableWriteCompactStrings)->Arg(false)->Arg(true);
 BENCHMARK(BM_TableWriteEmpty);
 BENCHMARK(BM_TableWriteFull);
 BENCHMARK(BM_TableCompaction);
@@ -238,6 +238,7 @@ TEST(TableTest, expiry_test) {
 
   EXPECT_OK(table.WriteRowBatch(rb1));
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 3);
 
   schema::RowBatch rb2(rd, 2);
   std::vector<types::Int64Value> col1_rb2 = {4, 5};
@@ -250,6 +251,7 @@ TEST(TableTest, expiry_test) {
 
   EXPECT_OK(table.WriteRowBatch(rb2));
   EXPECT_EQ(table.GetTableStats().bytes, rb1_size + rb2_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 5);
 
   schema::RowBatch rb3(rd, 2);
   std::vector<types::Int64Value> col1_rb3 = {4, 5};
@@ -262,6 +264,7 @@ TEST(TableTest, expiry_test) {
 
   EXPECT_OK(table.WriteRowBatch(rb3));
   EXPECT_EQ(table.GetTableStats().bytes, rb3_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 2);
 
   std::vector<types::Int64Value> time_hot_col1 = {1};
   std::vector<types::StringValue> time_hot_col2 = {"a"};
@@ -283,6 +286,7 @@ TEST(TableTest, expiry_test) {
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch_1)));
 
   EXPECT_EQ(table.GetTableStats().bytes, rb3_size + rb4_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 3);
 
   std::vector<types::Int64Value> time_hot_col1_2 = {1, 2, 3, 4, 5};
   std::vector<types::StringValue> time_hot_col2_2 = {"abcdef", "ghi", "jklmno", "pqr", "tu"};
@@ -304,6 +308,7 @@ TEST(TableTest, expiry_test) {
   EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch_1_2)));
 
   EXPECT_EQ(table.GetTableStats().bytes, rb5_size);
+  EXPECT_EQ(table.GetTableStats().num_rows, 5);
 }
 
 TEST(TableTest, expiry_test_w_compaction) {
@@ -431,6 +436,95 @@ TEST(TableTest, write_row_batch) {
   EXPECT_TRUE(actual_rb->ColumnAt(1)->Equals(col2_rb1_arrow));
 }
 
+TEST(TableTest, transfer_arrow_backed_record_batch) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::STRING}, {"time_", "body"});
+  std::shared_ptr<Table> table_ptr = Table::Create("test_table", rel);
+  Table& table = *table_ptr;
+
+  auto time_col = std::make_shared<types::ArrowColumnWrapper<types::Time64NSValue>>(
+      arrow::default_memory_pool());
+  auto body_col = std::make_shared<types::ArrowColumnWrapper<types::StringValue>>(
+      arrow::default_memory_pool());
+  time_col->Append(1);
+  time_col->Append(2);
+  body_col->Append("abc");
+  body_col->Append("defg");
+  auto body_arrow = body_col->ConvertToArrow(arrow::default_memory_pool());
+
+  auto record_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  record_batch->push_back(time_col);
+  record_batch->push_back(body_col);
+  EXPECT_OK(table.TransferRecordBatch(std::move(record_batch)));
+  EXPECT_EQ(table.GetTableStats().num_rows, 2);
+  EXPECT_EQ(table.GetTableStats().bytes, 2 * sizeof(int64_t) + 7);
+
+  auto rb_or_s = table.GetRowBatchSlice(table.FirstBatch(), {0, 1}, arrow::default_memory_pool());
+  ASSERT_OK(rb_or_s);
+  auto actual_rb = rb_or_s.ConsumeValueOrDie();
+  // The string column is the array that was built by the column wrapper.
+  EXPECT_EQ(actual_rb->ColumnAt(1)->data()->buffers[2], body_arrow->data()->buffers[2]);
+
+  ASSERT_OK_AND_ASSIGN(BatchSlice slice,
+                       table.FindBatchSliceGreaterThanOrEqual(2, arrow::default_memory_pool()));
+  EXPECT_EQ(slice.unsafe_row_start, 1);
+}
+
+TEST(TableTest, column_ndvs) {
+  gflags::FlagSaver flag_saver;
+  auto rd = schema::RowDescriptor(
+      {types::DataType::TIME64NS, types::DataType::INT64, types::DataType::STRING});
+  schema::Relation rel(rd.types(), {"time_", "col1", "col2"});
+
+  Table table("test_table", rel, 128, 60);
+
+  schema::RowBatch rb1(rd, 4);
+  std::vector<types::Time64NSValue> time_rb1 = {1, 2, 3, 4};
+  std::vector<types::Int64Value> col1_rb1 = {1, 2, 1, 2};
+  std::vector<types::StringValue> col2_rb1 = {"a", "b", "c", "d"};
+  EXPECT_OK(rb1.AddColumn(types::ToArrow(time_rb1, arrow::default_memory_pool())));
+  EXPECT_OK(rb1.AddColumn(types::ToArrow(col1_rb1, arrow::default_memory_pool())));
+  EXPECT_OK(rb1.AddColumn(types::ToArrow(col2_rb1, arrow::default_memory_pool())));
+  EXPECT_OK(table.WriteRowBatch(rb1));
+
+  auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  auto time_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+  auto col1_wrapper = std::make_shared<types::Int64ValueColumnWrapper>(0);
+  auto col2_wrapper = std::make_shared<types::StringValueColumnWrapper>(0);
+  for (int64_t i = 0; i < 3; ++i) {
+    time_wrapper->Append(5 + i);
+    col1_wrapper->Append(i);
+    col2_wrapper->Append("a");
+  }
+  wrapper_batch->push_back(time_wrapper);
+  wrapper_batch->push_back(col1_wrapper);
+  wrapper_batch->push_back(col2_wrapper);
+  EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch)));
+  EXPECT_EQ(7, table.GetTableStats().num_rows);
+
+  FLAGS_table_store_column_ndv_sketches = false;
+  EXPECT_THAT(table.EstimateColumnNDVs(), ::testing::ElementsAre(-1, -1, -1));
+
+  FLAGS_table_store_column_ndv_sketches = true;
+  // Time columns are not sketched.
+  EXPECT_THAT(table.EstimateColumnNDVs(), ::testing::ElementsAre(-1, 3, 4));
+
+  // Compacting the hot batches doesn't change the estimates.
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  EXPECT_THAT(table.EstimateColumnNDVs(), ::testing::ElementsAre(-1, 3, 4));
+
+  // The values of expired rows are no longer counted.
+  schema::RowBatch rb2(rd, 4);
+  std::vector<types::Time64NSValue> time_rb2 = {8, 9, 10, 11};
+  std::vector<types::Int64Value> col1_rb2 = {7, 7, 7, 7};
+  std::vector<types::StringValue> col2_rb2 = {"w", "x", "y", "z"};
+  EXPECT_OK(rb2.AddColumn(types::ToArrow(time_rb2, arrow::default_memory_pool())));
+  EXPECT_OK(rb2.AddColumn(types::ToArrow(col1_rb2, arrow::default_memory_pool())));
+  EXPECT_OK(rb2.AddColumn(types::ToArrow(col2_rb2, arrow::default_memory_pool())));
+  EXPECT_OK(table.WriteRowBatch(rb2));
+  EXPECT_EQ(7, table.GetTableStats().num_rows);
+  EXPECT_THAT(table.EstimateColumnNDVs(), ::testing::ElementsAre(-1, 4, 5));
+}
+
 TEST(TableTest, hot_batches_test) {
   schema::Relation rel({types::DataType::BOOLEAN, types::DataType::INT64}, {"col1", "col2"});
 
@@ -949,5 +1043,85 @@ TEST(TableTest, NextBatch_generation_bug) {
   EXPECT_NOT_OK(table.GetRowBatchSlice(slice, {0, 1}, arrow::default_memory_pool()));
 }
 
+TEST(TableTest, deferred_columns) {
+  auto rd = schema::RowDescriptor({types::DataType::INT64, types::DataType::STRING});
+  schema::Relation rel(rd.types(), {"col1", "col2"});
+  Table table("test_table", rel, 128 * 1024, 1);
+
+  auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  auto col_wrapper_1 = std::make_shared<types::Int64ValueColumnWrapper>(0);
+  auto col_wrapper_2 = std::make_shared<types::StringValueColumnWrapper>(0);
+  for (const auto& [num, str] : std::vector<std::pair<int64_t, std::string>>{
+           {1, "hello"}, {2, "abc"}, {3, "defg"}, {4, "hi"}}) {
+    col_wrapper_1->Append(num);
+    col_wrapper_2->Append(str);
+  }
+  wrapper_batch->push_back(col_wrapper_1);
+  wrapper_batch->push_back(col_wrapper_2);
+  EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch)));
+
+  auto slice = table.FirstBatch();
+  ASSERT_OK_AND_ASSIGN(auto rb, table.GetRowBatchSliceDeferred(slice, {0, 1}, {1},
+                                                               arrow::default_memory_pool()));
+  EXPECT_FALSE(rb->IsDeferred(0));
+  EXPECT_TRUE(rb->IsDeferred(1));
+  rb->set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{1, 3}));
+
+  std::vector<types::StringValue> expected = {"abc", "hi"};
+  ASSERT_OK_AND_ASSIGN(auto compacted, rb->Compact(arrow::default_memory_pool()));
+  EXPECT_TRUE(
+      compacted->ColumnAt(1)->Equals(types::ToArrow(expected, arrow::default_memory_pool())));
+
+  // The deferred column follows its rows into cold storage.
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  ASSERT_OK_AND_ASSIGN(compacted, rb->Compact(arrow::default_memory_pool()));
+  EXPECT_TRUE(
+      compacted->ColumnAt(1)->Equals(types::ToArrow(expected, arrow::default_memory_pool())));
+
+  // Columns that are already arrow arrays are never deferred.
+  ASSERT_OK_AND_ASSIGN(rb, table.GetRowBatchSliceDeferred(slice, {0, 1}, {1},
+                                                          arrow::default_memory_pool()));
+  EXPECT_FALSE(rb->has_deferred_columns());
+}
+
+TEST(TableTest, deferred_columns_outlive_expired_batch) {
+  auto rd = schema::RowDescriptor({types::DataType::INT64, types::DataType::STRING});
+  schema::Relation rel(rd.types(), {"col1", "col2"});
+
+  // The table only has room for one batch.
+  int64_t batch_size = 4 * sizeof(int64_t) + 14 * sizeof(char);
+  Table table("test_table", rel, batch_size, batch_size);
+
+  auto make_batch = []() {
+    auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto col_wrapper_1 = std::make_shared<types::Int64ValueColumnWrapper>(0);
+    auto col_wrapper_2 = std::make_shared<types::StringValueColumnWrapper>(0);
+    for (const auto& [num, str] : std::vector<std::pair<int64_t, std::string>>{
+             {1, "hello"}, {2, "abc"}, {3, "defg"}, {4, "hi"}}) {
+      col_wrapper_1->Append(num);
+      col_wrapper_2->Append(str);
+    }
+    wrapper_batch->push_back(col_wrapper_1);
+    wrapper_batch->push_back(col_wrapper_2);
+    return wrapper_batch;
+  };
+  EXPECT_OK(table.TransferRecordBatch(make_batch()));
+
+  auto slice = table.FirstBatch();
+  ASSERT_OK_AND_ASSIGN(auto rb, table.GetRowBatchSliceDeferred(slice, {0, 1}, {1},
+                                                               arrow::default_memory_pool()));
+  ASSERT_TRUE(rb->IsDeferred(1));
+  rb->set_selection(std::make_shared<std::vector<int64_t>>(std::vector<int64_t>{0, 2}));
+
+  // Writing another batch expires the one that the deferred column was read from.
+  EXPECT_OK(table.TransferRecordBatch(make_batch()));
+  EXPECT_NOT_OK(table.GetRowBatchSlice(slice, {0, 1}, arrow::default_memory_pool()));
+
+  std::vector<types::StringValue> expected = {"hello", "defg"};
+  ASSERT_OK_AND_ASSIGN(auto compacted, rb->Compact(arrow::default_memory_pool()));
+  EXPECT_TRUE(
+      compacted->ColumnAt(1)->Equals(types::ToArrow(expected, arrow::default_memory_pool())));
+}
+
 }  // namespace table_store
 }  // namespace px
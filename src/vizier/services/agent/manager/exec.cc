@@ -29,6 +29,14 @@
 #include "src/common/perf/perf.h"
 #include "src/vizier/services/agent/manager/manager.h"
 
+DEFINE_int32(max_concurrent_queries, gflags::Int32FromEnv("PL_MAX_CONCURRENT_QUERIES", 0),
+             "The maximum number of queries the agent runs at once. Further queries wait until a "
+             "running one completes. 0 disables the limit.");
+DEFINE_double(query_admission_memory_fraction,
+              gflags::DoubleFromEnv("PL_QUERY_ADMISSION_MEMORY_FRACTION", 0.8),
+              "Queries wait to be admitted while the memory used by the running queries is above "
+              "this fraction of --carnot_agent_memory_limit_bytes.");
+
 namespace px {
 namespace vizier {
 namespace agent {
@@ -81,18 +89,59 @@ ExecuteQueryMessageHandler::ExecuteQueryMessageHandler(px::event::Dispatcher* di
                                                        carnot::Carnot* carnot)
     : MessageHandler(dispatcher, agent_info, nats_conn), carnot_(carnot) {}
 
+// Defined here because ExecuteQueryTask is incomplete in the header.
+ExecuteQueryMessageHandler::~ExecuteQueryMessageHandler() = default;
+
 Status ExecuteQueryMessageHandler::HandleMessage(std::unique_ptr<messages::VizierMessage> msg) {
-  // Create a task and run it on the threadpool.
   auto task = std::make_unique<ExecuteQueryTask>(this, carnot_, std::move(msg));
 
+  // Queries are admitted in order, so a new one waits behind those already queued.
+  if (!queued_queries_.empty() || !CanAdmitQuery()) {
+    LOG(INFO) << absl::Substitute("Queueing query: id=$0, queries in flight: $1, queued: $2",
+                                  task->query_id().str(), running_queries_.size(),
+                                  queued_queries_.size());
+    queued_queries_.push_back(std::move(task));
+    return Status::OK();
+  }
+
+  RunQuery(std::move(task));
+  return Status::OK();
+}
+
+bool ExecuteQueryMessageHandler::CanAdmitQuery() const {
+  // Always admit a query when none is running, so that the queue cannot stall.
+  if (running_queries_.empty()) {
+    return true;
+  }
+  if (FLAGS_max_concurrent_queries > 0 &&
+      running_queries_.size() >= static_cast<size_t>(FLAGS_max_concurrent_queries)) {
+    return false;
+  }
+  const MemoryTracker& memory_tracker = carnot_->memory_tracker();
+  if (memory_tracker.limit_bytes() != MemoryTracker::kNoLimit &&
+      memory_tracker.consumed_bytes() >
+          FLAGS_query_admission_memory_fraction * memory_tracker.limit_bytes()) {
+    return false;
+  }
+  return true;
+}
+
+void ExecuteQueryMessageHandler::RunQuery(std::unique_ptr<ExecuteQueryTask> task) {
+  // Run the task on the threadpool.
   auto query_id = task->query_id();
   auto runnable = dispatcher()->CreateAsyncTask(std::move(task));
   auto runnable_ptr = runnable.get();
   LOG(INFO) << "Queries in flight: " << running_queries_.size();
   running_queries_[query_id] = std::move(runnable);
   runnable_ptr->Run();
+}
 
-  return Status::OK();
+void ExecuteQueryMessageHandler::AdmitQueuedQueries() {
+  while (!queued_queries_.empty() && CanAdmitQuery()) {
+    std::unique_ptr<ExecuteQueryTask> task = std::move(queued_queries_.front());
+    queued_queries_.pop_front();
+    RunQuery(std::move(task));
+  }
 }
 
 void ExecuteQueryMessageHandler::HandleQueryExecutionComplete(sole::uuid query_id) {
@@ -103,6 +152,8 @@ void ExecuteQueryMessageHandler::HandleQueryExecutionComplete(sole::uuid query_i
     return;
   }
   dispatcher()->DeferredDelete(std::move(node.mapped()));
+
+  AdmitQueuedQueries();
 }
 
 }  // namespace agent
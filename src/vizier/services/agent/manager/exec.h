@@ -18,12 +18,16 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include <absl/container/flat_hash_map.h>
 #include "src/carnot/plan/plan.h"
 #include "src/vizier/services/agent/manager/manager.h"
 
+DECLARE_int32(max_concurrent_queries);
+DECLARE_double(query_admission_memory_fraction);
+
 namespace px {
 namespace vizier {
 namespace agent {
@@ -34,13 +38,16 @@ namespace agent {
  * otherwise only query execution is performed.
  *
  * This class runs all of it's work on a thread pool and tracks pending queries internally.
+ * Queries are admitted in arrival order: a query waits in a queue while the maximum number of
+ * queries is running, or while the memory used by the running queries is close to the agent's
+ * memory limit.
  */
 class ExecuteQueryMessageHandler : public Manager::MessageHandler {
  public:
   ExecuteQueryMessageHandler() = delete;
   ExecuteQueryMessageHandler(px::event::Dispatcher* dispatcher, Info* agent_info,
                              Manager::VizierNATSConnector* nats_conn, carnot::Carnot* carnot);
-  ~ExecuteQueryMessageHandler() override = default;
+  ~ExecuteQueryMessageHandler() override;
 
   Status HandleMessage(std::unique_ptr<messages::VizierMessage> msg) override;
 
@@ -55,10 +62,19 @@ class ExecuteQueryMessageHandler : public Manager::MessageHandler {
   // Forward declare private task class.
   class ExecuteQueryTask;
 
+  // Returns true if another query can start running.
+  bool CanAdmitQuery() const;
+  void RunQuery(std::unique_ptr<ExecuteQueryTask> task);
+  // Runs queued queries for as long as they can be admitted.
+  void AdmitQueuedQueries();
+
   carnot::Carnot* carnot_;
 
   // Map from query_id -> Running query task.
   absl::flat_hash_map<sole::uuid, px::event::RunnableAsyncTaskUPtr> running_queries_;
+
+  // Queries waiting to be admitted, in arrival order.
+  std::deque<std::unique_ptr<ExecuteQueryTask>> queued_queries_;
 };
 
 }  // namespace agent
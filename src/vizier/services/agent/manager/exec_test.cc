@@ -0,0 +1,167 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "src/common/event/api_impl.h"
+#include "src/common/event/libuv.h"
+#include "src/common/event/real_time_system.h"
+#include "src/common/testing/testing.h"
+#include "src/common/uuid/uuid_utils.h"
+#include "src/vizier/messages/messagespb/messages.pb.h"
+#include "src/vizier/services/agent/manager/exec.h"
+#include "src/vizier/services/agent/manager/test_utils.h"
+
+namespace px {
+namespace vizier {
+namespace agent {
+
+constexpr int64_t kAgentMemoryLimitBytes = 1000;
+
+// A Carnot whose queries block until they are released.
+class FakeCarnot : public carnot::Carnot {
+ public:
+  FakeCarnot() : memory_tracker_("agent", kAgentMemoryLimitBytes) {}
+
+  Status ExecuteQuery(const std::string&, const sole::uuid&, types::Time64NSValue, bool) override {
+    return error::Unimplemented("Not used by the exec handler");
+  }
+
+  Status ExecutePlan(const carnot::planpb::Plan&, const sole::uuid&, bool) override {
+    std::unique_lock<std::mutex> lock(mu_);
+    ++num_started_;
+    cv_.notify_all();
+    cv_.wait(lock, [this] { return released_; });
+    return Status::OK();
+  }
+
+  void RegisterAgentMetadataCallback(AgentMetadataCallbackFunc) override {}
+  const carnot::udf::Registry* FuncRegistry() const override { return nullptr; }
+  const MemoryTracker& memory_tracker() const override { return memory_tracker_; }
+  MemoryTracker* mutable_memory_tracker() { return &memory_tracker_; }
+
+  // Lets the running queries, and any query started after this, complete.
+  void ReleaseQueries() {
+    std::lock_guard<std::mutex> lock(mu_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+  // Waits for up to a few seconds until n queries have started, and returns the number started.
+  int WaitForStartedQueries(int n) {
+    std::unique_lock<std::mutex> lock(mu_);
+    cv_.wait_for(lock, std::chrono::seconds(5), [this, n] { return num_started_ >= n; });
+    return num_started_;
+  }
+
+ private:
+  MemoryTracker memory_tracker_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  int num_started_ = 0;
+  bool released_ = false;
+};
+
+std::unique_ptr<messages::VizierMessage> ExecuteQueryMsg() {
+  auto msg = std::make_unique<messages::VizierMessage>();
+  ToProto(sole::uuid4(), msg->mutable_execute_query_request()->mutable_query_id());
+  return msg;
+}
+
+class ExecuteQueryMessageHandlerTest : public ::testing::Test {
+ protected:
+  ExecuteQueryMessageHandlerTest()
+      : api_(std::make_unique<px::event::APIImpl>(&time_system_)),
+        dispatcher_(api_->AllocateDispatcher("manager")),
+        nats_conn_(std::make_unique<FakeNATSConnector<px::vizier::messages::VizierMessage>>()) {
+    handler_ = std::make_unique<ExecuteQueryMessageHandler>(dispatcher_.get(), &agent_info_,
+                                                            nats_conn_.get(), &carnot_);
+  }
+
+  void TearDown() override {
+    // Let the blocked queries finish, and run the loop until every query has completed.
+    carnot_.ReleaseQueries();
+    dispatcher_->Run(event::Dispatcher::RunType::RunUntilExit);
+    handler_.reset();
+    dispatcher_->Exit();
+    FLAGS_max_concurrent_queries = 0;
+    FLAGS_query_admission_memory_fraction = 0.8;
+  }
+
+  event::RealTimeSystem time_system_;
+  std::unique_ptr<event::API> api_;
+  std::unique_ptr<event::Dispatcher> dispatcher_;
+  std::unique_ptr<FakeNATSConnector<px::vizier::messages::VizierMessage>> nats_conn_;
+  agent::Info agent_info_;
+  FakeCarnot carnot_;
+  std::unique_ptr<ExecuteQueryMessageHandler> handler_;
+};
+
+TEST_F(ExecuteQueryMessageHandlerTest, queues_at_concurrency_limit) {
+  FLAGS_max_concurrent_queries = 2;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(handler_->HandleMessage(ExecuteQueryMsg()));
+  }
+  EXPECT_EQ(2, carnot_.WaitForStartedQueries(2));
+  // The third query only starts once a running query completes, which needs the event loop.
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(2, carnot_.WaitForStartedQueries(2));
+}
+
+TEST_F(ExecuteQueryMessageHandlerTest, drains_queue_as_queries_complete) {
+  FLAGS_max_concurrent_queries = 1;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_OK(handler_->HandleMessage(ExecuteQueryMsg()));
+  }
+  EXPECT_EQ(1, carnot_.WaitForStartedQueries(1));
+
+  carnot_.ReleaseQueries();
+  dispatcher_->Run(event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(3, carnot_.WaitForStartedQueries(3));
+}
+
+TEST_F(ExecuteQueryMessageHandlerTest, waits_for_memory_below_admission_fraction) {
+  FLAGS_query_admission_memory_fraction = 0.5;
+  // The running queries use more than half of the agent's memory.
+  carnot_.mutable_memory_tracker()->Consume(kAgentMemoryLimitBytes * 3 / 4);
+
+  // A query is always admitted when none is running, but the next one has to wait.
+  ASSERT_OK(handler_->HandleMessage(ExecuteQueryMsg()));
+  ASSERT_OK(handler_->HandleMessage(ExecuteQueryMsg()));
+  EXPECT_EQ(1, carnot_.WaitForStartedQueries(1));
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(1, carnot_.WaitForStartedQueries(1));
+
+  // Once the first query completes and frees its memory, the queued one runs.
+  carnot_.mutable_memory_tracker()->Release(kAgentMemoryLimitBytes * 3 / 4);
+  carnot_.ReleaseQueries();
+  dispatcher_->Run(event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(2, carnot_.WaitForStartedQueries(2));
+}
+
+}  // namespace agent
+}  // namespace vizier
+}  // namespace px
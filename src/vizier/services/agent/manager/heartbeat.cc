@@ -34,12 +34,14 @@ using ::px::shared::k8s::metadatapb::ResourceUpdate;
 HeartbeatMessageHandler::HeartbeatMessageHandler(Dispatcher* d,
                                                  px::md::AgentMetadataStateManager* mds_manager,
                                                  RelationInfoManager* relation_info_manager,
+                                                 table_store::TableStore* table_store,
                                                  Info* agent_info,
                                                  Manager::VizierNATSConnector* nats_conn)
     : MessageHandler(d, agent_info, nats_conn),
       time_source_(dispatcher()->GetTimeSource()),
       mds_manager_(mds_manager),
       relation_info_manager_(relation_info_manager),
+      table_store_(table_store),
       heartbeat_send_timer_(
           dispatcher()->CreateTimer(std::bind(&HeartbeatMessageHandler::SendHeartbeat, this))),
       heartbeat_watchdog_timer_(
@@ -50,6 +52,7 @@ HeartbeatMessageHandler::HeartbeatMessageHandler(Dispatcher* d,
 void HeartbeatMessageHandler::DisableHeartbeats() {
   last_metadata_epoch_id_ = 0;
   sent_schema_ = false;
+  sent_table_stats_ = false;
   heartbeat_send_timer_->DisableTimer();
   heartbeat_watchdog_timer_->DisableTimer();
 }
@@ -103,12 +106,23 @@ Status HeartbeatMessageHandler::SendHeartbeatInternal() {
     relation_info_manager_->AddSchemaToUpdateInfo(update_info);
   }
 
-  // We skip sending the metadata update when there have been no changes.
+  // We skip sending the metadata update when there have been no changes, unless the table stats
+  // are due. The data info replaces the previous one as a whole, so both are always sent together.
   auto current_epoch = mds_manager_->metadata_filter()->epoch_id();
-  if (last_metadata_epoch_id_ == 0 || last_metadata_epoch_id_ != current_epoch) {
-    auto metadata_filter = update_info->mutable_data()->mutable_metadata_info();
-    *metadata_filter = mds_manager_->metadata_filter()->ToProto();
+  auto now = time_source_.MonotonicTime();
+  bool send_table_stats =
+      agent_info()->capabilities.collects_data() &&
+      (!sent_table_stats_ || now - last_table_stats_time_ >= kTableStatsInterval);
+  if (last_metadata_epoch_id_ == 0 || last_metadata_epoch_id_ != current_epoch ||
+      send_table_stats) {
+    auto data_info = update_info->mutable_data();
+    *data_info->mutable_metadata_info() = mds_manager_->metadata_filter()->ToProto();
     last_metadata_epoch_id_ = current_epoch;
+    if (agent_info()->capabilities.collects_data()) {
+      AddTableStatsToDataInfo(data_info);
+      last_table_stats_time_ = now;
+      sent_table_stats_ = true;
+    }
   }
 
   VLOG(1) << "Sending heartbeat message: " << req.DebugString();
@@ -117,6 +131,24 @@ Status HeartbeatMessageHandler::SendHeartbeatInternal() {
   return nats_conn()->Publish(req);
 }
 
+void HeartbeatMessageHandler::AddTableStatsToDataInfo(messages::AgentDataInfo* data_info) {
+  for (const auto& [table_name, relation] : *table_store_->GetRelationMap()) {
+    PL_UNUSED(relation);
+    auto table = table_store_->GetTable(table_name);
+    if (table == nullptr) {
+      continue;
+    }
+    auto stats = table->GetTableStats();
+    auto table_info = data_info->add_table_info();
+    table_info->set_table(table_name);
+    table_info->set_num_rows(stats.num_rows);
+    table_info->set_num_bytes(stats.bytes);
+    for (int64_t ndv : table->EstimateColumnNDVs()) {
+      table_info->add_column_ndvs(ndv);
+    }
+  }
+}
+
 void HeartbeatMessageHandler::HeartbeatWatchdog() {
   if (heartbeat_info_.last_ackd_seq_num < heartbeat_info_.last_sent_seq_num) {
     auto diff = time_source_.MonotonicTime() - heartbeat_info_.last_heartbeat_send_time_;
@@ -20,6 +20,7 @@
 
 #include <memory>
 
+#include "src/table_store/table_store.h"
 #include "src/vizier/services/agent/manager/manager.h"
 
 namespace px {
@@ -31,7 +32,8 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   HeartbeatMessageHandler() = delete;
   HeartbeatMessageHandler(px::event::Dispatcher* dispatcher,
                           px::md::AgentMetadataStateManager* mds_manager,
-                          RelationInfoManager* relation_info_manager, Info* agent_info,
+                          RelationInfoManager* relation_info_manager,
+                          table_store::TableStore* table_store, Info* agent_info,
                           Manager::VizierNATSConnector* nats_conn);
 
   ~HeartbeatMessageHandler() override = default;
@@ -48,6 +50,10 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   void ProcessPIDTerminatedEvent(const px::md::PIDTerminatedEvent& ev,
                                  messages::AgentUpdateInfo* update_info);
 
+  // Adds the row counts, sizes and column NDVs of the agent's tables, which the planner uses to
+  // estimate the cost of queries.
+  void AddTableStatsToDataInfo(messages::AgentDataInfo* data_info);
+
   void DoHeartbeats();
 
   void SendHeartbeat();
@@ -64,11 +70,14 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   std::unique_ptr<px::vizier::messages::VizierMessage> last_sent_hb_;
   int64_t last_metadata_epoch_id_ = 0;
   bool sent_schema_ = false;
+  bool sent_table_stats_ = false;
+  std::chrono::steady_clock::time_point last_table_stats_time_;
 
   HeartbeatInfo heartbeat_info_;
   const px::event::TimeSource& time_source_;
   px::md::AgentMetadataStateManager* mds_manager_;
   RelationInfoManager* relation_info_manager_;
+  table_store::TableStore* table_store_;
   std::chrono::duration<double> heartbeat_latency_moving_average_{0};
 
   px::event::TimerUPtr heartbeat_send_timer_;
@@ -77,6 +86,8 @@ class HeartbeatMessageHandler : public Manager::MessageHandler {
   static constexpr double kHbLatencyDecay = 0.25;
 
   static constexpr std::chrono::seconds kAgentHeartbeatInterval{5};
+  // The table stats are only sent this often, since they change slowly.
+  static constexpr std::chrono::seconds kTableStatsInterval{60};
   static constexpr int kHeartbeatRetryCount = 5;
   // The amount of time to wait for a heartbeat ack.
   static constexpr std::chrono::milliseconds kHeartbeatWaitMillis{5000};
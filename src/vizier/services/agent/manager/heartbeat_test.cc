@@ -29,6 +29,7 @@
 #include "src/common/testing/event/simulated_time_system.h"
 #include "src/common/testing/testing.h"
 #include "src/shared/metadatapb/metadata.pb.h"
+#include "src/table_store/table_store.h"
 #include "src/vizier/messages/messagespb/messages.pb.h"
 #include "src/vizier/services/agent/manager/heartbeat.h"
 #include "src/vizier/services/agent/manager/manager.h"
@@ -134,12 +135,26 @@ class HeartbeatMessageHandlerTest : public ::testing::Test {
       EXPECT_OK(relation_info_manager_->AddRelationInfo(relation_info));
     }
 
+    table_store_ = std::make_shared<table_store::TableStore>();
+    auto table = table_store::Table::Create("relation0", relation0);
+    auto rb = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto time_col = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    auto count_col = std::make_shared<types::Int64ValueColumnWrapper>(0);
+    for (int64_t i = 0; i < 3; ++i) {
+      time_col->Append(i);
+      count_col->Append(i == 0 ? 1 : 2);
+    }
+    rb->push_back(time_col);
+    rb->push_back(count_col);
+    EXPECT_OK(table->TransferRecordBatch(std::move(rb)));
+    table_store_->AddTable("relation0", table);
+
     agent_info_ = agent::Info{};
     agent_info_.capabilities.set_collects_data(true);
 
     heartbeat_handler_ = std::make_unique<HeartbeatMessageHandler>(
-        dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), &agent_info_,
-        nats_conn_.get());
+        dispatcher_.get(), mds_manager_.get(), relation_info_manager_.get(), table_store_.get(),
+        &agent_info_, nats_conn_.get());
   }
 
   void CheckFilterElements(const messages::AgentDataInfo& data_info,
@@ -161,6 +176,7 @@ class HeartbeatMessageHandlerTest : public ::testing::Test {
   std::unique_ptr<event::Dispatcher> dispatcher_;
   std::unique_ptr<FakeAgentMetadataStateManager> mds_manager_;
   std::unique_ptr<RelationInfoManager> relation_info_manager_;
+  std::shared_ptr<table_store::TableStore> table_store_;
   std::unique_ptr<HeartbeatMessageHandler> heartbeat_handler_;
   std::unique_ptr<FakeNATSConnector<px::vizier::messages::VizierMessage>> nats_conn_;
   agent::Info agent_info_;
@@ -217,6 +233,45 @@ TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeat) {
   EXPECT_FALSE(hb.update_info().data().has_metadata_info());
 }
 
+TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatTableStats) {
+  gflags::FlagSaver flag_saver;
+  FLAGS_table_store_column_ndv_sketches = true;
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(1, nats_conn_->published_msgs().size());
+  auto hb = nats_conn_->published_msgs()[0].heartbeat();
+  ASSERT_EQ(1, hb.update_info().data().table_info_size());
+  const auto& table_info = hb.update_info().data().table_info(0);
+  EXPECT_EQ("relation0", table_info.table());
+  EXPECT_EQ(3, table_info.num_rows());
+  EXPECT_GT(table_info.num_bytes(), 0);
+  EXPECT_THAT(table_info.column_ndvs(), ::testing::ElementsAre(-1, 2));
+
+  time_system_->SetMonotonicTime(start_monotonic_time_ + std::chrono::milliseconds(5 * 4000));
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+
+  auto hb_ack = std::make_unique<messages::VizierMessage>();
+  hb_ack->mutable_heartbeat_ack()->set_sequence_number(0);
+  auto s = heartbeat_handler_->HandleMessage(std::move(hb_ack));
+
+  // The stats aren't resent until the stats interval has passed.
+  time_system_->SetMonotonicTime(start_monotonic_time_ + std::chrono::milliseconds(5 * 5000 + 1));
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(3, nats_conn_->published_msgs().size());
+  hb = nats_conn_->published_msgs()[2].heartbeat();
+  EXPECT_EQ(0, hb.update_info().data().table_info_size());
+
+  hb_ack = std::make_unique<messages::VizierMessage>();
+  hb_ack->mutable_heartbeat_ack()->set_sequence_number(1);
+  s = heartbeat_handler_->HandleMessage(std::move(hb_ack));
+
+  time_system_->SetMonotonicTime(start_monotonic_time_ + std::chrono::seconds(61));
+  dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
+  hb = nats_conn_->published_msgs().back().heartbeat();
+  EXPECT_EQ(1, hb.update_info().data().table_info_size());
+  // The metadata info is always sent along with the stats.
+  EXPECT_TRUE(hb.update_info().data().has_metadata_info());
+}
+
 TEST_F(HeartbeatMessageHandlerTest, HandleHeartbeatMetadataChange) {
   // Tthe metadata info should be resent when it changes.
   dispatcher_->Run(event::Dispatcher::RunType::NonBlock);
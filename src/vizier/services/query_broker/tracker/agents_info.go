@@ -120,11 +120,13 @@ func (a *AgentsInfoImpl) UpdateAgentsInfo(update *metadatapb.AgentUpdatesRespons
 
 			if agent.Info.Capabilities == nil || agent.Info.Capabilities.CollectsData {
 				var metadataInfo *distributedpb.MetadataInfo
+				var tableInfo []*distributedpb.TableInfo
 				if carnotInfo, present := carnotInfoMap[agentUUID]; present {
 					metadataInfo = carnotInfo.MetadataInfo
+					tableInfo = carnotInfo.TableInfo
 				}
 				// this is a PEM
-				carnotInfoMap[agentUUID] = makeAgentCarnotInfo(agentUUID, agent.ASID, metadataInfo)
+				carnotInfoMap[agentUUID] = makeAgentCarnotInfo(agentUUID, agent.ASID, metadataInfo, tableInfo)
 			} else {
 				// this is a Kelvin
 				kelvinGRPCAddress := agent.Info.IPAddress
@@ -146,6 +148,10 @@ func (a *AgentsInfoImpl) UpdateAgentsInfo(update *metadatapb.AgentUpdatesRespons
 			if dataInfo.MetadataInfo != nil {
 				carnotInfo.MetadataInfo = dataInfo.MetadataInfo
 			}
+			// Agents that report table stats report them for all of their tables at once.
+			if dataInfo.TableInfo != nil {
+				carnotInfo.TableInfo = dataInfo.TableInfo
+			}
 		}
 		// case 3: agent deleted
 		if agentUpdate.GetDeleted() {
@@ -184,7 +190,8 @@ func (a *AgentsInfoImpl) DistributedState() distributedpb.DistributedState {
 	return a.ds
 }
 
-func makeAgentCarnotInfo(agentID uuid.UUID, asid uint32, agentMetadata *distributedpb.MetadataInfo) *distributedpb.CarnotInfo {
+func makeAgentCarnotInfo(agentID uuid.UUID, asid uint32, agentMetadata *distributedpb.MetadataInfo,
+	tableInfo []*distributedpb.TableInfo) *distributedpb.CarnotInfo {
 	return &distributedpb.CarnotInfo{
 		QueryBrokerAddress:   agentID.String(),
 		AgentID:              utils.ProtoFromUUID(agentID),
@@ -194,6 +201,7 @@ func makeAgentCarnotInfo(agentID uuid.UUID, asid uint32, agentMetadata *distribu
 		ProcessesData:        true,
 		AcceptsRemoteSources: false,
 		MetadataInfo:         agentMetadata,
+		TableInfo:            tableInfo,
 	}
 }
 
@@ -154,6 +154,14 @@ func makeTestAgentDataInfo() []*messagespb.AgentDataInfo {
 					},
 				},
 			},
+			TableInfo: []*distributedpb.TableInfo{
+				{
+					Table:      "table1",
+					NumRows:    100,
+					NumBytes:   4096,
+					ColumnNDVs: []int64{-1, 10, 3},
+				},
+			},
 		},
 		{
 			MetadataInfo: &distributedpb.MetadataInfo{
@@ -246,6 +254,7 @@ func TestAgentsInfo_UpdateAgentsInfo(t *testing.T) {
 		AcceptsRemoteSources: false,
 		ASID:                 123,
 		MetadataInfo:         agentDataInfos[0].MetadataInfo,
+		TableInfo:            agentDataInfos[0].TableInfo,
 	}
 
 	expectedKelvinInfo := &distributedpb.CarnotInfo{
@@ -279,6 +288,7 @@ func TestAgentsInfo_UpdateAgentsInfo(t *testing.T) {
 		Info:            agents[0].Info,
 		ASID:            agents[0].ASID,
 	}
+	// The second data info has no table stats, so the ones from the first are kept.
 	expectedPEM1Info.MetadataInfo = agentDataInfos[1].MetadataInfo
 
 	expectedPEM2Info := &distributedpb.CarnotInfo{